@@ -0,0 +1,35 @@
+#pragma once
+
+#include "synthetic_package.h"
+
+#include <benchmark/benchmark.h>
+
+namespace lgx {
+namespace bench {
+
+/**
+ * Run a benchmark once per standard spec; the spec index is range(0).
+ */
+inline void forEachSpec(benchmark::internal::Benchmark* b) {
+    b->ArgName("spec");
+    for (size_t i = 0; i < standardSpecs().size(); ++i) {
+        b->Arg(static_cast<int64_t>(i));
+    }
+}
+
+/**
+ * Fixture for the current run, labelled with its spec. Marks the run as
+ * failed and returns nullptr if the fixture could not be built.
+ */
+inline const Fixture* fixtureFor(benchmark::State& state) {
+    const Fixture* fx = fixture(static_cast<size_t>(state.range(0)));
+    if (!fx) {
+        state.SkipWithError("failed to build synthetic package");
+        return nullptr;
+    }
+    state.SetLabel(fx->spec.label());
+    return fx;
+}
+
+} // namespace bench
+} // namespace lgx
@@ -0,0 +1,201 @@
+#include "bench_common.h"
+#include "core/gzip_handler.h"
+#include "core/package.h"
+#include "core/path_normalizer.h"
+#include "core/tar_reader.h"
+#include "core/tar_writer.h"
+#include "crypto/signing.h"
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace lgx;
+
+// Scaling on worst-case untrusted input. Each benchmark runs the same
+// adversarial archive shape at N, 2N and 4N and fits the times to a
+// complexity class, reported as the `_BigO` row: anything above N means a
+// load path has turned superlinear. tests/test_complexity.cpp checks the
+// same corpus for correctness and memory bounds.
+
+namespace {
+
+// Tar entries of a package with the given files (variant -> paths),
+// including a manifest whose main and hashes match
+std::vector<TarEntry> adversarialPackage(
+    const std::vector<std::pair<std::string, std::vector<std::string>>>& variants) {
+    std::vector<TarEntry> entries;
+    entries.emplace_back("variants", true, 0755);
+    Manifest manifest;
+    manifest.name = "adversarial";
+    manifest.version = "1.0.0";
+    for (const auto& [variant, files] : variants) {
+        entries.emplace_back("variants/" + variant, true, 0755);
+        for (const auto& file : files) {
+            entries.emplace_back("variants/" + variant + "/" + file, std::string("x"), 0644);
+        }
+        manifest.main[variant] = files.front();
+    }
+    manifest.hashes = crypto::computeMerkleTree(entries);
+    entries.emplace_back("manifest.json", manifest.toJson(), 0644);
+    return entries;
+}
+
+// n variants of one file each, so n main entries
+std::vector<TarEntry> manyVariants(size_t n) {
+    std::vector<std::pair<std::string, std::vector<std::string>>> variants;
+    for (size_t i = 0; i < n; ++i) {
+        variants.push_back({"v" + std::to_string(i), {"lib.so"}});
+    }
+    return adversarialPackage(variants);
+}
+
+// One variant holding n files
+std::vector<TarEntry> manyEntries(size_t n) {
+    std::vector<std::string> files;
+    for (size_t i = 0; i < n; ++i) {
+        files.push_back("d" + std::to_string(i % 16) + "/f" + std::to_string(i));
+    }
+    return adversarialPackage({{"linux-amd64", files}});
+}
+
+// n files whose paths use the whole ustar name + prefix space
+std::vector<TarEntry> deepPaths(size_t n) {
+    std::string dirs;
+    while (dirs.size() < 200) {
+        dirs += "a/";
+    }
+    std::vector<std::string> files;
+    for (size_t i = 0; i < n; ++i) {
+        files.push_back(dirs + "f" + std::to_string(i));
+    }
+    return adversarialPackage({{"linux-amd64", files}});
+}
+
+std::vector<uint8_t> packageBytes(const std::vector<TarEntry>& entries) {
+    DeterministicTarWriter writer;
+    for (const auto& entry : entries) {
+        writer.addEntry(entry);
+    }
+    return GzipHandler::compress(writer.finalize());
+}
+
+std::optional<Package> loadPackage(benchmark::State& state, const std::vector<TarEntry>& entries) {
+    auto gz = packageBytes(entries);
+    auto pkg = Package::loadFromMemory(gz.data(), gz.size());
+    if (!pkg) {
+        state.SkipWithError("load failed");
+    }
+    return pkg;
+}
+
+// Raw tar of n empty files, each header followed by a single zero block
+// (which read() tolerates), then a long zero tail
+std::vector<uint8_t> zeroInterleaved(size_t n) {
+    std::vector<uint8_t> out;
+    for (size_t i = 0; i < n; ++i) {
+        DeterministicTarWriter writer;
+        writer.addFile("f" + std::to_string(i), std::string());
+        auto single = writer.finalize();
+        out.insert(out.end(), single.begin(), single.begin() + 512);  // header only
+        out.insert(out.end(), 512, 0);
+    }
+    out.insert(out.end(), 1024 * 1024, 0);
+    return out;
+}
+
+} // anonymous namespace
+
+static void BM_AdversarialMerkleTree(benchmark::State& state) {
+    crypto::init();
+    auto entries = manyVariants(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto tree = crypto::computeMerkleTree(entries);
+        benchmark::DoNotOptimize(tree);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_AdversarialMerkleTree)
+    ->ArgName("variants")->RangeMultiplier(2)->Range(1000, 4000)
+    ->Unit(benchmark::kMillisecond)->Complexity();
+
+static void BM_AdversarialValidateMainEntries(benchmark::State& state) {
+    auto pkg = loadPackage(state, manyVariants(static_cast<size_t>(state.range(0))));
+    if (!pkg) return;
+    for (auto _ : state) {
+        auto result = pkg->validatePackage();
+        benchmark::DoNotOptimize(result.valid);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_AdversarialValidateMainEntries)
+    ->ArgName("variants")->RangeMultiplier(2)->Range(1000, 4000)
+    ->Unit(benchmark::kMillisecond)->Complexity();
+
+static void BM_AdversarialVariantQueries(benchmark::State& state) {
+    auto pkg = loadPackage(state, manyEntries(static_cast<size_t>(state.range(0))));
+    if (!pkg) return;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pkg->getVariants());
+        benchmark::DoNotOptimize(pkg->hasVariant("missing"));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_AdversarialVariantQueries)
+    ->ArgName("entries")->RangeMultiplier(2)->Range(10000, 40000)
+    ->Unit(benchmark::kMillisecond)->Complexity();
+
+static void BM_AdversarialLoadEntries(benchmark::State& state) {
+    auto gz = packageBytes(manyEntries(static_cast<size_t>(state.range(0))));
+    for (auto _ : state) {
+        auto pkg = Package::loadFromMemory(gz.data(), gz.size());
+        if (!pkg) {
+            state.SkipWithError("load failed");
+            break;
+        }
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_AdversarialLoadEntries)
+    ->ArgName("entries")->RangeMultiplier(2)->Range(10000, 40000)
+    ->Unit(benchmark::kMillisecond)->Complexity();
+
+static void BM_AdversarialSplitPathDepth(benchmark::State& state) {
+    std::string path;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        path += "a/";
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PathNormalizer::splitPath(path));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_AdversarialSplitPathDepth)
+    ->ArgName("depth")->RangeMultiplier(2)->Range(10000, 40000)
+    ->Unit(benchmark::kMicrosecond)->Complexity();
+
+static void BM_AdversarialValidateDeepPaths(benchmark::State& state) {
+    auto pkg = loadPackage(state, deepPaths(static_cast<size_t>(state.range(0))));
+    if (!pkg) return;
+    for (auto _ : state) {
+        auto result = pkg->validatePackage();
+        benchmark::DoNotOptimize(result.valid);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_AdversarialValidateDeepPaths)
+    ->ArgName("files")->RangeMultiplier(2)->Range(1500, 6000)
+    ->Unit(benchmark::kMillisecond)->Complexity();
+
+static void BM_AdversarialTarZeroBlocks(benchmark::State& state) {
+    auto tar = zeroInterleaved(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto result = TarReader::read(tar);
+        benchmark::DoNotOptimize(result.entries.data());
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_AdversarialTarZeroBlocks)
+    ->ArgName("files")->RangeMultiplier(2)->Range(2500, 10000)
+    ->Unit(benchmark::kMillisecond)->Complexity();
@@ -0,0 +1,29 @@
+#include "bench_common.h"
+#include "core/gzip_handler.h"
+
+using namespace lgx;
+using namespace lgx::bench;
+
+static void BM_GzipCompress(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    for (auto _ : state) {
+        auto compressed = GzipHandler::compress(fx->tar);
+        benchmark::DoNotOptimize(compressed.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * fx->tar.size()));
+}
+BENCHMARK(BM_GzipCompress)->Apply(forEachSpec)->Unit(benchmark::kMillisecond);
+
+static void BM_GzipDecompress(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    for (auto _ : state) {
+        auto data = GzipHandler::decompress(fx->gzip);
+        benchmark::DoNotOptimize(data.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * fx->tar.size()));
+}
+BENCHMARK(BM_GzipDecompress)->Apply(forEachSpec)->Unit(benchmark::kMillisecond);
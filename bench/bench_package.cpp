@@ -0,0 +1,396 @@
+#include "bench_common.h"
+#include "core/incremental_build.h"
+#include "core/package.h"
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace lgx;
+using namespace lgx::bench;
+namespace fs = std::filesystem;
+
+static void BM_PackageLoad(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    for (auto _ : state) {
+        auto pkg = Package::load(fx->lgxPath);
+        if (!pkg) {
+            state.SkipWithError("load failed");
+            break;
+        }
+        benchmark::DoNotOptimize(pkg->getEntries().data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * fx->fileBytes));
+}
+BENCHMARK(BM_PackageLoad)->Apply(forEachSpec)->Unit(benchmark::kMillisecond);
+
+#ifndef _WIN32
+// Memory footprint of repeated loads: range(1) 1 = every load on one thread,
+// reusing its scratch buffers; 0 = each load on a fresh thread, so the
+// scratch buffers start empty and are freed when it exits, as if they were
+// allocated per load. The loads run in a forked child so each case gets its
+// own peak RSS high-water mark; peak_rss_growth_kb is how far that rose above
+// the RSS inherited from the benchmark process
+static void BM_PackageLoadPeakRss(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    constexpr int LOADS = 1000;
+    const bool reuse = state.range(1) != 0;
+    struct Usage {
+        long startMaxRss;  // KiB
+        long endMaxRss;    // KiB
+        long minorFaults;
+        bool ok;
+    } usage{};
+
+    for (auto _ : state) {
+        int fds[2];
+        if (::pipe(fds) != 0) {
+            state.SkipWithError("pipe failed");
+            break;
+        }
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            ::close(fds[0]);
+            ::close(fds[1]);
+            state.SkipWithError("fork failed");
+            break;
+        }
+        if (pid == 0) {
+            ::close(fds[0]);
+            auto loadOnce = [&fx] {
+                auto pkg = Package::load(fx->lgxPath);
+                benchmark::DoNotOptimize(pkg);
+                return pkg.has_value();
+            };
+            Usage result{};
+            struct rusage ru;
+            ::getrusage(RUSAGE_SELF, &ru);
+            result.startMaxRss = ru.ru_maxrss;
+            long startFaults = ru.ru_minflt;
+            result.ok = true;
+            for (int i = 0; i < LOADS && result.ok; ++i) {
+                if (reuse) {
+                    result.ok = loadOnce();
+                } else {
+                    std::thread([&] { result.ok = loadOnce(); }).join();
+                }
+            }
+            ::getrusage(RUSAGE_SELF, &ru);
+            result.endMaxRss = ru.ru_maxrss;
+            result.minorFaults = ru.ru_minflt - startFaults;
+            bool written = ::write(fds[1], &result, sizeof(result)) == sizeof(result);
+            ::_exit(written ? 0 : 1);
+        }
+        ::close(fds[1]);
+        bool received = ::read(fds[0], &usage, sizeof(usage)) == sizeof(usage);
+        ::close(fds[0]);
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        if (!received || !usage.ok) {
+            state.SkipWithError("load failed");
+            break;
+        }
+    }
+    state.counters["peak_rss_kb"] = static_cast<double>(usage.endMaxRss);
+    state.counters["peak_rss_growth_kb"] = static_cast<double>(usage.endMaxRss - usage.startMaxRss);
+    state.counters["minor_faults_per_load"] = static_cast<double>(usage.minorFaults) / LOADS;
+    state.SetItemsProcessed(state.iterations() * LOADS);
+    state.SetLabel(fx->spec.label() + (reuse ? ", scratch reuse" : ", no scratch reuse"));
+}
+BENCHMARK(BM_PackageLoadPeakRss)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+        b->ArgNames({"spec", "reuse"});
+        for (size_t i = 0; i < standardSpecs().size(); ++i) {
+            b->Args({static_cast<int64_t>(i), 0});
+            b->Args({static_cast<int64_t>(i), 1});
+        }
+    })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->Iterations(1);
+#endif
+
+static void BM_PackageSave(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    auto pkg = Package::load(fx->lgxPath);
+    if (!pkg) {
+        state.SkipWithError("load failed");
+        return;
+    }
+    fs::path out = fx->workDir / "save.lgx";
+
+    for (auto _ : state) {
+        if (!pkg->save(out).success) {
+            state.SkipWithError("save failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * fx->fileBytes));
+}
+BENCHMARK(BM_PackageSave)->Apply(forEachSpec)->Unit(benchmark::kMillisecond);
+
+// Replaces the first variant with its own tree: read files, rebuild, rehash
+static void BM_PackageAddVariant(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    auto pkg = Package::load(fx->lgxPath);
+    if (!pkg) {
+        state.SkipWithError("load failed");
+        return;
+    }
+    fs::path tree = fx->workDir / "tree-0";
+    std::string variant = SyntheticPackage::variantName(0);
+    std::string main = SyntheticPackage::filePath(0);
+
+    for (auto _ : state) {
+        if (!pkg->addVariant(variant, tree, main).success) {
+            state.SkipWithError("addVariant failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(
+        state.iterations() * fx->fileBytes / fx->spec.variantCount));
+}
+BENCHMARK(BM_PackageAddVariant)->Apply(forEachSpec)->Unit(benchmark::kMillisecond);
+
+static void BM_PackageExtractVariant(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    auto pkg = Package::load(fx->lgxPath);
+    if (!pkg) {
+        state.SkipWithError("load failed");
+        return;
+    }
+    fs::path out = fx->workDir / "extract";
+    std::string variant = SyntheticPackage::variantName(0);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::error_code ec;
+        fs::remove_all(out, ec);
+        state.ResumeTiming();
+
+        if (!pkg->extractVariant(variant, out).success) {
+            state.SkipWithError("extractVariant failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(
+        state.iterations() * fx->fileBytes / fx->spec.variantCount));
+}
+BENCHMARK(BM_PackageExtractVariant)->Apply(forEachSpec)->Unit(benchmark::kMillisecond);
+
+#ifndef _WIN32
+// The naive durable extraction the batched mode is measured against: each
+// file is fsync()ed as soon as it is written, and each new directory (and
+// the one holding it) right after it is created
+static bool extractSyncingEachFile(const Package& pkg, const std::string& variant,
+                                   const fs::path& outputDir) {
+    auto fsyncPath = [](const fs::path& path, int flags) {
+        int fd = ::open(path.c_str(), flags);
+        bool ok = fd >= 0 && ::fsync(fd) == 0;
+        if (fd >= 0) ::close(fd);
+        return ok;
+    };
+    std::string prefix = "variants/" + variant + "/";
+    fs::path root = outputDir / variant;
+    std::error_code ec;
+    fs::create_directories(root, ec);
+    if (ec || !fsyncPath(root, O_RDONLY | O_DIRECTORY) || !fsyncPath(outputDir, O_RDONLY | O_DIRECTORY)) {
+        return false;
+    }
+    for (const auto& entry : pkg.getEntries()) {
+        if (entry.path.compare(0, prefix.size(), prefix) != 0 || entry.path.size() == prefix.size()) {
+            continue;
+        }
+        fs::path target = root / entry.path.substr(prefix.size());
+        if (entry.isDirectory) {
+            if (fs::create_directory(target, ec) &&
+                (!fsyncPath(target, O_RDONLY | O_DIRECTORY) ||
+                 !fsyncPath(target.parent_path(), O_RDONLY | O_DIRECTORY))) {
+                return false;
+            }
+            continue;
+        }
+        int fd = ::open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = ::write(fd, entry.data.data(), entry.data.size()) ==
+                      static_cast<ssize_t>(entry.data.size()) &&
+                  ::fsync(fd) == 0;
+        ::close(fd);
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Extraction of one variant of many small files: range(0) files, range(1)
+// 0 = Durability::Default, 1 = Durability::Durable (batched flush and one
+// swap), 2 = fsync after every file
+static void BM_PackageExtractDurability(benchmark::State& state) {
+    SyntheticSpec spec;
+    spec.fileCount = static_cast<size_t>(state.range(0));
+    spec.variantCount = 1;
+    spec.distribution = SizeDistribution::Fixed;
+    spec.maxFileSize = 4096;
+    SyntheticPackage synthetic(spec);
+
+    ScratchDir dir;
+    fs::path tree = dir.path() / "tree";
+    std::string variant = SyntheticPackage::variantName(0);
+    Package pkg = Package::skeleton("bench");
+    if (!synthetic.writeVariantTree(0, tree) ||
+        !pkg.addVariant(variant, tree, SyntheticPackage::filePath(0)).success) {
+        state.SkipWithError("cannot build package");
+        return;
+    }
+
+    const int64_t mode = state.range(1);
+    size_t run = 0;
+    for (auto _ : state) {
+        // A fresh directory per run: deleting flushed trees in between can
+        // keep the device busy (e.g. discards) into the next timed run
+        state.PauseTiming();
+        fs::path out = dir.path() / ("out" + std::to_string(run++));
+        std::error_code ec;
+        fs::create_directories(out, ec);
+        ::sync();  // start each run with nothing else waiting for writeback
+        state.ResumeTiming();
+
+        bool ok = mode == 2 ? extractSyncingEachFile(pkg, variant, out)
+                            : pkg.extractVariant(variant, out, PathFilter(),
+                                                 mode == 1 ? Package::Durability::Durable
+                                                           : Package::Durability::Default).success;
+        if (!ok) {
+            state.SkipWithError("extraction failed");
+            break;
+        }
+    }
+    static const char* const MODES[] = {"default", "durable", "fsync per file"};
+    state.SetLabel(std::to_string(spec.fileCount) + " files, " + MODES[mode]);
+}
+BENCHMARK(BM_PackageExtractDurability)
+    ->ArgsProduct({{2048, 20000}, {0, 1, 2}})
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(3);
+#endif
+
+static void BM_PackageSaveDurable(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    auto pkg = Package::load(fx->lgxPath);
+    if (!pkg) {
+        state.SkipWithError("load failed");
+        return;
+    }
+    fs::path out = fx->workDir / "save.lgx";
+
+    for (auto _ : state) {
+        if (!pkg->save(out, Package::Durability::Durable).success) {
+            state.SkipWithError("save failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * fx->fileBytes));
+}
+BENCHMARK(BM_PackageSaveDurable)->Apply(forEachSpec)->Unit(benchmark::kMillisecond);
+
+static void BM_PackageValidate(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    auto pkg = Package::load(fx->lgxPath);
+    if (!pkg) {
+        state.SkipWithError("load failed");
+        return;
+    }
+
+    for (auto _ : state) {
+        auto result = pkg->validatePackage();
+        if (!result.valid) {
+            state.SkipWithError("package did not validate");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * fx->fileBytes));
+}
+BENCHMARK(BM_PackageValidate)->Apply(forEachSpec)->Unit(benchmark::kMillisecond);
+
+static void BM_PackageVerifySignature(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    auto pkg = Package::load(fx->signedPath);
+    if (!pkg) {
+        state.SkipWithError("load failed");
+        return;
+    }
+
+    for (auto _ : state) {
+        auto info = pkg->verifySignature();
+        if (!info.signature_valid) {
+            state.SkipWithError("signature did not verify");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * fx->fileBytes));
+}
+BENCHMARK(BM_PackageVerifySignature)->Apply(forEachSpec)->Unit(benchmark::kMillisecond);
+
+// `--watch` rebuild after one file of a large variant changed: re-read,
+// rehash and recompress that file, then rewrite the package
+static void BM_IncrementalRebuild(benchmark::State& state) {
+    SyntheticSpec spec;
+    spec.fileCount = static_cast<size_t>(state.range(0));
+    spec.variantCount = 1;
+    spec.distribution = SizeDistribution::Fixed;
+    spec.maxFileSize = 512;
+    SyntheticPackage synthetic(spec);
+
+    ScratchDir dir;
+    fs::path tree = dir.path() / "tree";
+    if (!synthetic.writeVariantTree(0, tree)) {
+        state.SkipWithError("cannot write variant tree");
+        return;
+    }
+    Package base;
+    base.getManifest().name = "bench";
+    Package::Inputs inputs;
+    inputs.variants.push_back({SyntheticPackage::variantName(0), tree, SyntheticPackage::filePath(0)});
+    IncrementalBuild build(std::move(base), std::move(inputs), dir.path() / "watch.lgx");
+    if (!build.build().success) {
+        state.SkipWithError("initial build failed");
+        return;
+    }
+
+    fs::path changed = tree / SyntheticPackage::filePath(spec.fileCount / 2);
+    size_t round = 0;
+    for (auto _ : state) {
+        std::ofstream(changed, std::ios::binary) << "edit " << round++;
+        if (!build.update({changed}).success) {
+            state.SkipWithError("update failed");
+            break;
+        }
+    }
+    state.SetLabel(std::to_string(spec.fileCount) + " files");
+}
+BENCHMARK(BM_IncrementalRebuild)->Arg(2048)->Arg(20000)->Unit(benchmark::kMillisecond);
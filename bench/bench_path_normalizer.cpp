@@ -0,0 +1,41 @@
+#include "bench_common.h"
+#include "core/path_normalizer.h"
+
+using namespace lgx;
+using namespace lgx::bench;
+
+// Archive paths of the synthetic package (already NFC: the common case)
+static void BM_ToNFC_Ascii(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    for (auto _ : state) {
+        for (const auto& entry : fx->entries) {
+            auto nfc = PathNormalizer::toNFC(entry.path);
+            benchmark::DoNotOptimize(nfc);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * fx->entries.size()));
+}
+BENCHMARK(BM_ToNFC_Ascii)->Apply(forEachSpec)->Unit(benchmark::kMicrosecond);
+
+// The same paths with decomposed (NFD) accents that must be composed
+static void BM_ToNFC_Decomposed(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    std::vector<std::string> paths;
+    paths.reserve(fx->entries.size());
+    for (const auto& entry : fx->entries) {
+        paths.push_back(entry.path + "/re\x43\xCC\xA7u\x65\xCC\x81/cafe\xCC\x81");
+    }
+
+    for (auto _ : state) {
+        for (const auto& path : paths) {
+            auto nfc = PathNormalizer::toNFC(path);
+            benchmark::DoNotOptimize(nfc);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * paths.size()));
+}
+BENCHMARK(BM_ToNFC_Decomposed)->Apply(forEachSpec)->Unit(benchmark::kMicrosecond);
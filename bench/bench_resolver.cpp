@@ -0,0 +1,66 @@
+#include "bench_common.h"
+#include "core/resolver.h"
+
+using namespace lgx;
+using namespace lgx::bench;
+
+namespace {
+
+// 10k candidates: 2000 packages with 5 versions each
+const GraphSpec GRAPH;
+
+const std::vector<Resolver::Candidate>& graph() {
+    static const std::vector<Resolver::Candidate> candidates = syntheticGraph(GRAPH);
+    return candidates;
+}
+
+// The first `count` packages, any 1.x
+std::vector<Dependency> roots(size_t count) {
+    std::vector<Dependency> out;
+    for (size_t i = 0; i < count; ++i) {
+        Dependency dep("pkg" + std::to_string(i));
+        dep.version = "^1";
+        out.push_back(std::move(dep));
+    }
+    return out;
+}
+
+} // namespace
+
+// Indexing by name and compiling every dependency range
+static void BM_ResolverAddCandidates(benchmark::State& state) {
+    const auto& candidates = graph();
+    for (auto _ : state) {
+        Resolver resolver;
+        for (const auto& candidate : candidates) {
+            resolver.addCandidate(candidate);
+        }
+        benchmark::DoNotOptimize(resolver.candidateCount());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * candidates.size()));
+    state.SetLabel(GRAPH.label());
+}
+BENCHMARK(BM_ResolverAddCandidates)->Unit(benchmark::kMillisecond);
+
+// Transitive closure of range(0) root packages
+static void BM_ResolverResolve(benchmark::State& state) {
+    Resolver resolver;
+    for (const auto& candidate : graph()) {
+        resolver.addCandidate(candidate);
+    }
+    auto requirements = roots(static_cast<size_t>(state.range(0)));
+
+    Resolver::Result result;
+    for (auto _ : state) {
+        result = resolver.resolve(requirements);
+        if (!result.success) {
+            state.SkipWithError(result.error.c_str());
+            break;
+        }
+    }
+    state.counters["packages"] = static_cast<double>(result.packages.size());
+    state.counters["steps"] = static_cast<double>(result.steps);
+    state.SetLabel(GRAPH.label());
+}
+BENCHMARK(BM_ResolverResolve)->ArgName("roots")->Arg(1)->Arg(100)->Arg(2000)
+    ->Unit(benchmark::kMillisecond);
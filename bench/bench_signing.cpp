@@ -0,0 +1,58 @@
+#include "bench_common.h"
+#include "crypto/signing.h"
+
+using namespace lgx;
+using namespace lgx::bench;
+
+static void BM_ComputeMerkleTree(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    for (auto _ : state) {
+        auto tree = crypto::computeMerkleTree(fx->entries);
+        benchmark::DoNotOptimize(tree);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * fx->fileBytes));
+}
+BENCHMARK(BM_ComputeMerkleTree)->Apply(forEachSpec)->Unit(benchmark::kMillisecond);
+
+// Checking a catalog's worth of manifest signatures: 0 = verify() one at a
+// time, 1 = verifyBatch()
+static void BM_VerifySignatures(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    const bool batch = state.range(1) == 1;
+
+    crypto::init();
+    auto kp = crypto::generateKeypair();
+    std::vector<std::vector<uint8_t>> messages(count);
+    std::vector<crypto::VerifyItem> items(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string text = "{\"name\":\"pkg" + std::to_string(i) + "\"," +
+                           std::string(2048, 'x') + "}";  // manifest-sized
+        messages[i].assign(text.begin(), text.end());
+        items[i].message = messages[i].data();
+        items[i].messageLen = messages[i].size();
+        items[i].publicKey = kp.publicKey;
+        items[i].signature = crypto::sign(messages[i], kp.secretKey);
+    }
+
+    for (auto _ : state) {
+        size_t valid = 0;
+        if (batch) {
+            for (bool ok : crypto::verifyBatch(items)) valid += ok;
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                valid += crypto::verify(messages[i], items[i].publicKey, items[i].signature);
+            }
+        }
+        if (valid != count) {
+            state.SkipWithError("signature did not verify");
+            break;
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+    state.SetLabel(batch ? "verifyBatch" : "verify each");
+}
+BENCHMARK(BM_VerifySignatures)
+    ->ArgsProduct({{1024}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,68 @@
+#include "bench_common.h"
+#include "core/tar_reader.h"
+#include "core/tar_writer.h"
+
+using namespace lgx;
+using namespace lgx::bench;
+
+static void BM_TarRead(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    for (auto _ : state) {
+        auto result = TarReader::read(fx->tar);
+        benchmark::DoNotOptimize(result.entries.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * fx->tar.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * fx->entries.size()));
+}
+BENCHMARK(BM_TarRead)->Apply(forEachSpec)->Unit(benchmark::kMicrosecond);
+
+static void BM_TarReadInfo(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    for (auto _ : state) {
+        auto infos = TarReader::readInfo(fx->tar);
+        benchmark::DoNotOptimize(infos.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * fx->entries.size()));
+}
+BENCHMARK(BM_TarReadInfo)->Apply(forEachSpec)->Unit(benchmark::kMicrosecond);
+
+// Looks up the last file in archive order, the worst case for a linear scan
+static void BM_TarReadFile(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    auto infos = TarReader::readInfo(fx->tar);
+    std::string target;
+    for (const auto& info : infos) {
+        if (!info.isDirectory) {
+            target = info.path;
+        }
+    }
+
+    for (auto _ : state) {
+        auto data = TarReader::readFile(fx->tar, target);
+        benchmark::DoNotOptimize(data);
+    }
+}
+BENCHMARK(BM_TarReadFile)->Apply(forEachSpec)->Unit(benchmark::kMicrosecond);
+
+static void BM_TarWriterFinalize(benchmark::State& state) {
+    const Fixture* fx = fixtureFor(state);
+    if (!fx) return;
+
+    DeterministicTarWriter writer;
+    for (const auto& entry : fx->entries) {
+        writer.addEntry(entry);
+    }
+
+    for (auto _ : state) {
+        auto tar = writer.finalize();
+        benchmark::DoNotOptimize(tar.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * fx->tar.size()));
+}
+BENCHMARK(BM_TarWriterFinalize)->Apply(forEachSpec)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""
+Compare two lgx_bench JSON result files (--benchmark_out_format=json).
+
+Prints the change in time per benchmark and exits with status 1 if any
+benchmark got slower than the threshold, so it can gate a CI job:
+
+    bench/compare.py bench/baselines/ci-linux.json build/bench/lgx_bench.json
+
+When results contain repetitions, the median aggregate is compared.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+
+    results = {}
+    medians = {}
+    for bench in data.get("benchmarks", []):
+        if bench.get("error_occurred"):
+            continue
+        name = bench.get("run_name", bench["name"])
+        if bench.get("run_type") == "aggregate":
+            if bench.get("aggregate_name") == "median":
+                medians[name] = bench
+        else:
+            results.setdefault(name, bench)
+    results.update(medians)
+    return {name: b["real_time"] * scale(b["time_unit"]) for name, b in results.items()}
+
+
+def scale(unit):
+    return {"ns": 1e-9, "us": 1e-6, "ms": 1e-3, "s": 1.0}[unit]
+
+
+def fmt(seconds):
+    for unit, factor in (("s", 1.0), ("ms", 1e-3), ("us", 1e-6)):
+        if seconds >= factor:
+            return "%.3f %s" % (seconds / factor, unit)
+    return "%.1f ns" % (seconds / 1e-9)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="percent slowdown that counts as a regression (default 10)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+    width = max((len(n) for n in current), default=10)
+    for name in sorted(set(baseline) | set(current)):
+        if name not in current:
+            print("%-*s  missing from current results" % (width, name))
+            continue
+        if name not in baseline:
+            print("%-*s  %12s  (new)" % (width, name, fmt(current[name])))
+            continue
+        change = (current[name] - baseline[name]) / baseline[name] * 100.0
+        marker = ""
+        if change > args.threshold:
+            marker = "  REGRESSION"
+            regressions += 1
+        print("%-*s  %12s -> %12s  %+7.1f%%%s" % (
+            width, name, fmt(baseline[name]), fmt(current[name]), change, marker))
+
+    if regressions:
+        print("\n%d benchmark(s) slower than %.0f%%" % (regressions, args.threshold))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,344 @@
+#include "synthetic_package.h"
+#include "core/gzip_handler.h"
+#include "crypto/signing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+
+namespace lgx {
+namespace bench {
+
+namespace {
+
+/**
+ * splitmix64: tiny, fast and identical on every platform, unlike the
+ * distributions in <random> whose output is implementation-defined.
+ */
+class Rng {
+public:
+    explicit Rng(uint64_t seed) : state_(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state_ += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, 1)
+    double unit() {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    uint64_t state_;
+};
+
+uint64_t mix(uint64_t seed, size_t a, size_t b) {
+    Rng rng(seed ^ (static_cast<uint64_t>(a) << 32) ^ static_cast<uint64_t>(b));
+    return rng.next();
+}
+
+const char* const WORDS[] = {
+    "logos", "package", "variant", "module", "import", "export", "signal",
+    "property", "const", "return", "struct", "void", "string", "vector",
+    "manifest", "plugin", "library", "function", "value", "index",
+};
+constexpr size_t WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+const char* const VARIANT_NAMES[] = {
+    "linux-x86_64", "linux-aarch64", "darwin-arm64", "darwin-x86_64",
+    "windows-x86_64", "linux-x86_64-dev", "darwin-arm64-dev", "web",
+};
+constexpr size_t VARIANT_NAME_COUNT = sizeof(VARIANT_NAMES) / sizeof(VARIANT_NAMES[0]);
+
+const char* distributionName(SizeDistribution distribution) {
+    switch (distribution) {
+        case SizeDistribution::Fixed: return "fixed";
+        case SizeDistribution::Uniform: return "uniform";
+        case SizeDistribution::Skewed: return "skewed";
+    }
+    return "unknown";
+}
+
+} // anonymous namespace
+
+std::string SyntheticSpec::label() const {
+    return "f" + std::to_string(fileCount) + "/v" + std::to_string(variantCount) +
+           "/" + distributionName(distribution);
+}
+
+SyntheticPackage::SyntheticPackage(const SyntheticSpec& spec) : spec_(spec) {}
+
+std::string SyntheticPackage::variantName(size_t index) {
+    if (index < VARIANT_NAME_COUNT) {
+        return VARIANT_NAMES[index];
+    }
+    return "variant-" + std::to_string(index);
+}
+
+std::string SyntheticPackage::filePath(size_t fileIndex) {
+    if (fileIndex == 0) {
+        return "main.so";
+    }
+    return "dir" + std::to_string(fileIndex % 8) + "/sub" +
+           std::to_string((fileIndex / 8) % 4) + "/file" + std::to_string(fileIndex) + ".bin";
+}
+
+size_t SyntheticPackage::fileSize(size_t variantIndex, size_t fileIndex) const {
+    size_t lo = std::min(spec_.minFileSize, spec_.maxFileSize);
+    size_t hi = spec_.maxFileSize;
+    Rng rng(mix(spec_.seed, variantIndex, fileIndex) ^ 0x5153);
+
+    switch (spec_.distribution) {
+        case SizeDistribution::Fixed:
+            return hi;
+        case SizeDistribution::Uniform:
+            return lo + static_cast<size_t>(rng.unit() * static_cast<double>(hi - lo + 1));
+        case SizeDistribution::Skewed: {
+            double logLo = std::log(static_cast<double>(std::max<size_t>(lo, 1)));
+            double logHi = std::log(static_cast<double>(std::max<size_t>(hi, 1)));
+            double size = std::exp(logLo + rng.unit() * (logHi - logLo));
+            return std::min(hi, std::max(lo, static_cast<size_t>(size)));
+        }
+    }
+    return hi;
+}
+
+std::vector<uint8_t> SyntheticPackage::fileContents(size_t variantIndex, size_t fileIndex) const {
+    size_t size = fileSize(variantIndex, fileIndex);
+    size_t textSize = static_cast<size_t>(static_cast<double>(size) * spec_.compressibleFraction);
+    Rng rng(mix(spec_.seed, variantIndex, fileIndex));
+
+    std::vector<uint8_t> data;
+    data.reserve(size);
+
+    // Text-like prefix: words from a small vocabulary, compresses well
+    while (data.size() < textSize) {
+        const char* word = WORDS[rng.next() % WORD_COUNT];
+        for (const char* c = word; *c && data.size() < textSize; ++c) {
+            data.push_back(static_cast<uint8_t>(*c));
+        }
+        if (data.size() < textSize) {
+            data.push_back((rng.next() % 8 == 0) ? '\n' : ' ');
+        }
+    }
+
+    // Random suffix: incompressible, like object code or images
+    while (data.size() < size) {
+        uint64_t bits = rng.next();
+        for (int i = 0; i < 8 && data.size() < size; ++i) {
+            data.push_back(static_cast<uint8_t>(bits >> (i * 8)));
+        }
+    }
+    return data;
+}
+
+std::vector<TarEntry> SyntheticPackage::tarEntries() const {
+    std::vector<TarEntry> entries;
+    std::set<std::string> dirs;
+    dirs.insert("variants");
+
+    for (size_t v = 0; v < spec_.variantCount; ++v) {
+        std::string base = "variants/" + variantName(v);
+        dirs.insert(base);
+        for (size_t f = 0; f < spec_.fileCount; ++f) {
+            std::string path = base + "/" + filePath(f);
+            for (size_t pos = path.find('/', base.size() + 1); pos != std::string::npos;
+                 pos = path.find('/', pos + 1)) {
+                dirs.insert(path.substr(0, pos));
+            }
+            entries.emplace_back(path, fileContents(v, f), 0644);
+        }
+    }
+
+    for (const auto& dir : dirs) {
+        entries.emplace_back(dir, true, 0755);
+    }
+    return entries;
+}
+
+size_t SyntheticPackage::totalBytes() const {
+    size_t total = 0;
+    for (size_t v = 0; v < spec_.variantCount; ++v) {
+        for (size_t f = 0; f < spec_.fileCount; ++f) {
+            total += fileSize(v, f);
+        }
+    }
+    return total;
+}
+
+bool SyntheticPackage::writeVariantTree(size_t variantIndex, const std::filesystem::path& dir) const {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    for (size_t f = 0; f < spec_.fileCount; ++f) {
+        fs::path path = dir / filePath(f);
+        fs::create_directories(path.parent_path(), ec);
+        if (ec) {
+            return false;
+        }
+        std::vector<uint8_t> data = fileContents(variantIndex, f);
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!out) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::optional<Package> SyntheticPackage::build(
+    const std::filesystem::path& workDir,
+    const std::filesystem::path& lgxPath) const {
+    if (!Package::create(lgxPath, "synthetic").success) {
+        return std::nullopt;
+    }
+    auto pkg = Package::load(lgxPath);
+    if (!pkg) {
+        return std::nullopt;
+    }
+
+    for (size_t v = 0; v < spec_.variantCount; ++v) {
+        std::filesystem::path tree = workDir / ("tree-" + std::to_string(v));
+        if (!writeVariantTree(v, tree)) {
+            return std::nullopt;
+        }
+        if (!pkg->addVariant(variantName(v), tree, filePath(0)).success) {
+            return std::nullopt;
+        }
+    }
+
+    if (!pkg->save(lgxPath).success) {
+        return std::nullopt;
+    }
+    return pkg;
+}
+
+ScratchDir::ScratchDir() {
+    std::random_device rd;
+    path_ = std::filesystem::temp_directory_path() /
+            ("lgx_bench_" + std::to_string(rd()) + std::to_string(rd()));
+    std::filesystem::create_directories(path_);
+}
+
+ScratchDir::~ScratchDir() {
+    std::error_code ec;
+    std::filesystem::remove_all(path_, ec);
+}
+
+const std::vector<SyntheticSpec>& standardSpecs() {
+    static const std::vector<SyntheticSpec> specs = [] {
+        SyntheticSpec small;
+        small.fileCount = 16;
+        small.variantCount = 1;
+        small.distribution = SizeDistribution::Uniform;
+        small.minFileSize = 1024;
+        small.maxFileSize = 16 * 1024;
+
+        SyntheticSpec typical;  // defaults: 64 files x 2 variants, skewed
+
+        SyntheticSpec manySmall;
+        manySmall.fileCount = 2048;
+        manySmall.variantCount = 1;
+        manySmall.distribution = SizeDistribution::Fixed;
+        manySmall.maxFileSize = 512;
+
+        return std::vector<SyntheticSpec>{small, typical, manySmall};
+    }();
+    return specs;
+}
+
+const Fixture* fixture(size_t index) {
+    static ScratchDir root;
+    static std::map<size_t, std::unique_ptr<Fixture>> fixtures;
+
+    const auto& specs = standardSpecs();
+    if (index >= specs.size()) {
+        return nullptr;
+    }
+    auto it = fixtures.find(index);
+    if (it != fixtures.end()) {
+        return it->second.get();
+    }
+
+    auto fx = std::make_unique<Fixture>();
+    fx->spec = specs[index];
+    SyntheticPackage generator(fx->spec);
+    fx->entries = generator.tarEntries();
+    fx->fileBytes = generator.totalBytes();
+
+    DeterministicTarWriter writer;
+    for (const auto& entry : fx->entries) {
+        writer.addEntry(entry);
+    }
+    fx->tar = writer.finalize();
+    fx->gzip = GzipHandler::compress(fx->tar);
+
+    fx->workDir = root.path() / ("spec-" + std::to_string(index));
+    fx->lgxPath = fx->workDir / "synthetic.lgx";
+    fx->signedPath = fx->workDir / "synthetic-signed.lgx";
+    std::error_code ec;
+    std::filesystem::create_directories(fx->workDir, ec);
+
+    auto pkg = generator.build(fx->workDir, fx->lgxPath);
+    if (fx->gzip.empty() || !pkg || !crypto::init()) {
+        fixtures[index] = nullptr;
+        return nullptr;
+    }
+    auto keys = crypto::generateKeypair();
+    if (!pkg->signPackage(keys.secretKey, "Benchmark").success ||
+        !pkg->save(fx->signedPath).success) {
+        fixtures[index] = nullptr;
+        return nullptr;
+    }
+
+    return (fixtures[index] = std::move(fx)).get();
+}
+
+std::string GraphSpec::label() const {
+    return "p" + std::to_string(packageCount) + "/v" + std::to_string(versionsPerPackage) +
+           "/d" + std::to_string(maxDependencies);
+}
+
+std::vector<Resolver::Candidate> syntheticGraph(const GraphSpec& spec) {
+    std::vector<Resolver::Candidate> candidates;
+    candidates.reserve(spec.packageCount * spec.versionsPerPackage);
+    for (size_t i = 0; i < spec.packageCount; ++i) {
+        for (size_t v = 0; v < spec.versionsPerPackage; ++v) {
+            Rng rng(mix(spec.seed, i, v));
+            Resolver::Candidate candidate;
+            candidate.name = "pkg" + std::to_string(i);
+            candidate.version = "1." + std::to_string(v) + ".0";
+            candidate.source = candidate.name + "-" + candidate.version + ".lgx";
+
+            size_t ahead = std::min(spec.window, spec.packageCount - i - 1);
+            size_t count = ahead == 0 ? 0 : 1 + rng.next() % spec.maxDependencies;
+            std::set<size_t> targets;
+            for (size_t d = 0; d < count; ++d) {
+                targets.insert(i + 1 + rng.next() % ahead);
+            }
+            for (size_t target : targets) {
+                Dependency dep("pkg" + std::to_string(target));
+                size_t minor = rng.next() % spec.versionsPerPackage;
+                if (v == 0) {
+                    dep.version = "^1";
+                } else if (rng.unit() < spec.pinFraction) {
+                    dep.version = "~1." + std::to_string(minor);
+                } else {
+                    dep.version = ">=1." + std::to_string(minor / 2);
+                }
+                candidate.dependencies.push_back(std::move(dep));
+            }
+            candidates.push_back(std::move(candidate));
+        }
+    }
+    return candidates;
+}
+
+} // namespace bench
+} // namespace lgx
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "core/package.h"
+#include "core/resolver.h"
+#include "core/tar_writer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace lgx {
+namespace bench {
+
+/**
+ * How file sizes are spread between minFileSize and maxFileSize.
+ */
+enum class SizeDistribution {
+    Fixed,    // every file is maxFileSize
+    Uniform,  // uniform between min and max
+    Skewed    // log-uniform: mostly small files with a few large ones
+};
+
+/**
+ * Parameters of a synthetic package. The same spec always produces the same
+ * bytes, so benchmark runs on different commits operate on identical input.
+ */
+struct SyntheticSpec {
+    size_t fileCount = 64;        // files per variant
+    size_t variantCount = 2;
+    SizeDistribution distribution = SizeDistribution::Skewed;
+    size_t minFileSize = 256;
+    size_t maxFileSize = 256 * 1024;
+    double compressibleFraction = 0.5;  // share of each file that is text-like
+    uint64_t seed = 0x6c6778;
+
+    /**
+     * Short label for benchmark output, e.g. "f64/v2/skewed".
+     */
+    std::string label() const;
+};
+
+/**
+ * Deterministic generator of package contents.
+ */
+class SyntheticPackage {
+public:
+    explicit SyntheticPackage(const SyntheticSpec& spec);
+
+    const SyntheticSpec& spec() const { return spec_; }
+
+    /**
+     * Name of the variant at the given index (platform-like names first).
+     */
+    static std::string variantName(size_t index);
+
+    /**
+     * Archive path (relative to the variant directory) of a file.
+     * Files are spread over a few levels of subdirectories.
+     */
+    static std::string filePath(size_t fileIndex);
+
+    /**
+     * Contents of one file of one variant.
+     */
+    std::vector<uint8_t> fileContents(size_t variantIndex, size_t fileIndex) const;
+
+    /**
+     * Every file of every variant as tar entries (directories included),
+     * laid out as in a package: variants/<variant>/<path>.
+     */
+    std::vector<TarEntry> tarEntries() const;
+
+    /**
+     * Total number of file bytes across all variants.
+     */
+    size_t totalBytes() const;
+
+    /**
+     * Write one variant's files under dir.
+     *
+     * @return false if any file could not be written
+     */
+    bool writeVariantTree(size_t variantIndex, const std::filesystem::path& dir) const;
+
+    /**
+     * Build the package on disk: write every variant's tree under workDir,
+     * add them to a fresh package and save it to lgxPath.
+     *
+     * @return The package as built, or nullopt on error
+     */
+    std::optional<Package> build(
+        const std::filesystem::path& workDir,
+        const std::filesystem::path& lgxPath) const;
+
+private:
+    size_t fileSize(size_t variantIndex, size_t fileIndex) const;
+
+    SyntheticSpec spec_;
+};
+
+/**
+ * Temporary directory removed on destruction.
+ */
+class ScratchDir {
+public:
+    ScratchDir();
+    ~ScratchDir();
+
+    ScratchDir(const ScratchDir&) = delete;
+    ScratchDir& operator=(const ScratchDir&) = delete;
+
+    const std::filesystem::path& path() const { return path_; }
+
+private:
+    std::filesystem::path path_;
+};
+
+/**
+ * Shapes shared by every benchmark, selected by index (the benchmark's
+ * first argument): a few mid-sized files, a typical multi-variant package,
+ * and many small files.
+ */
+const std::vector<SyntheticSpec>& standardSpecs();
+
+/**
+ * Lazily generated, process-wide fixtures for standardSpecs()[index], so
+ * generation cost is paid once per run and never inside a timed loop.
+ */
+struct Fixture {
+    SyntheticSpec spec;
+    std::vector<TarEntry> entries;     // as from SyntheticPackage::tarEntries()
+    std::vector<uint8_t> tar;          // entries written by DeterministicTarWriter
+    std::vector<uint8_t> gzip;         // tar compressed by GzipHandler
+    std::filesystem::path workDir;     // variant trees (tree-<n>) and package files
+    std::filesystem::path lgxPath;     // unsigned package built from the spec
+    std::filesystem::path signedPath;  // same package, signed
+    size_t fileBytes = 0;              // total file bytes across variants
+};
+
+/**
+ * @return The fixture, or nullptr if it could not be built
+ */
+const Fixture* fixture(size_t index);
+
+/**
+ * Parameters of a synthetic dependency graph for the resolver. Package i
+ * ("pkg<i>") has versions 1.0.0 .. 1.<versions-1>.0, each depending on a
+ * few packages shortly after it. Version 1.0.0 only asks for "^1"; newer
+ * versions sometimes pin a minor ("~1.2"), so requirements collide and the
+ * resolver has to fall back to older versions.
+ */
+struct GraphSpec {
+    size_t packageCount = 2000;
+    size_t versionsPerPackage = 5;
+    size_t maxDependencies = 4;
+    size_t window = 50;          // dependencies point at most this far ahead
+    double pinFraction = 0.2;    // share of dependencies of newer versions that pin a minor
+    uint64_t seed = 0x6c6778;
+
+    /**
+     * Short label for benchmark output, e.g. "p2000/v5/d4".
+     */
+    std::string label() const;
+};
+
+/**
+ * Every candidate of the graph (packageCount * versionsPerPackage).
+ */
+std::vector<Resolver::Candidate> syntheticGraph(const GraphSpec& spec);
+
+} // namespace bench
+} // namespace lgx
@@ -65,6 +65,7 @@
             pkgs.icu
             pkgs.nlohmann_json
             pkgs.libsodium
+            pkgs.gbenchmark
           ];
           
           shellHook = ''
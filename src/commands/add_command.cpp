@@ -1,4 +1,6 @@
 #include "add_command.h"
+#include "core/digest_cache.h"
+#include "core/incremental_build.h"
 #include "core/package.h"
 #include "core/path_normalizer.h"
 
@@ -35,6 +37,7 @@ int AddCommand::execute(const std::vector<std::string>& args) {
     std::string mainPath = getOption(opts, "main", "m");
     std::string viewPath = getOption(opts, "view");
     bool autoYes = hasFlag(opts, "yes", "y");
+    bool watch = hasFlag(opts, "watch");
     
     // Check if package exists
     if (!std::filesystem::exists(pkgPath)) {
@@ -59,6 +62,7 @@ int AddCommand::execute(const std::vector<std::string>& args) {
     std::string variantLc = PathNormalizer::toLowercase(variant);
 
     // Apply --view to the manifest if provided
+    bool viewChanged = !viewPath.empty() && pkg.getManifest().view != viewPath;
     if (!viewPath.empty()) {
         auto viewValidation = PathNormalizer::validateArchivePath(viewPath);
         if (!viewValidation.valid) {
@@ -67,6 +71,11 @@ int AddCommand::execute(const std::vector<std::string>& args) {
         }
         pkg.getManifest().view = viewPath;
     }
+    if (viewChanged) {
+        // The signature covers the manifest, even if the inputs turn out
+        // to be identical below
+        pkg.clearSignature();
+    }
     
     // Check if variant exists (replacement warning)
     bool variantExists = pkg.hasVariant(variantLc);
@@ -96,6 +105,30 @@ int AddCommand::execute(const std::vector<std::string>& args) {
     
     // Check if main would change
     bool mainWouldChange = pkg.wouldMainChange(variantLc, effectiveMain);
+
+    std::optional<std::string> mainOpt = mainPath.empty() ? std::nullopt : std::make_optional(mainPath);
+    auto digestCache = openDigestCache(opts);
+    Package::Inputs inputs;
+    inputs.variants.push_back({variantLc, filesPath, mainOpt});
+    inputs.digestCache = digestCache.get();
+
+    // Add the variant in memory first, so an identical re-add needs no
+    // confirmation (watch mode builds later, from the unmodified package)
+    Package::Result result = Package::Result::ok();
+    if (!watch) {
+        result = pkg.addInputs(inputs);
+        if (!result.success) {
+            printError(result.error);
+            return 1;
+        }
+
+        // Identical inputs: leave the file (and its signature and mtime) alone
+        if (result.unchanged && !viewChanged) {
+            finishDigestCache(digestCache.get());
+            printSuccess("Variant '" + variantLc + "' in " + pkgPath + " is unchanged");
+            return 0;
+        }
+    }
     
     // Prompt for confirmation if needed
     if (!autoYes) {
@@ -121,21 +154,25 @@ int AddCommand::execute(const std::vector<std::string>& args) {
         }
     }
     
-    // Add the variant
-    std::optional<std::string> mainOpt = mainPath.empty() ? std::nullopt : std::make_optional(mainPath);
-    auto result = pkg.addVariant(variantLc, filesPath, mainOpt);
-    
-    if (!result.success) {
-        printError(result.error);
-        return 1;
+    if (watch) {
+        IncrementalBuild build(std::move(pkg), std::move(inputs), pkgPath);
+        auto result = build.build();
+        if (!result.success) {
+            printError(result.error);
+            return 1;
+        }
+        finishDigestCache(digestCache.get());
+        printSuccess("Added variant '" + variantLc + "' to " + pkgPath);
+        return watchAndRebuild(build);
     }
-    
+
     // Save the package
     result = pkg.save(pkgPath);
     if (!result.success) {
         printError("Failed to save package: " + result.error);
         return 1;
     }
+    finishDigestCache(digestCache.get());
     
     if (variantExists) {
         printSuccess("Replaced variant '" + variantLc + "' in " + pkgPath);
@@ -5,7 +5,7 @@
 namespace lgx {
 
 /**
- * Add command: lgx add <pkg.lgx> --variant <v> --files <path> [--main <relpath>] [--view <relpath>] [-y/--yes]
+ * Add command: lgx add <pkg.lgx> --variant <v> --files <path> [--main <relpath>] [--view <relpath>] [-y/--yes] [--watch] [--digest-cache <dir>]
  * 
  * Adds files to a variant. If the variant exists, it is completely replaced.
  */
@@ -17,7 +17,8 @@ public:
         return "Add files to a package variant"; 
     }
     std::string usage() const override {
-        return "lgx add <pkg.lgx> --variant <v> --files <path> [--main <relpath>] [--view <relpath>] [-y/--yes]\n"
+        return "lgx add <pkg.lgx> --variant <v> --files <path> [--main <relpath>] [--view <relpath>] [-y/--yes] [--watch]\n"
+               "        [--digest-cache <dir>]\n"
                "\n"
                "Adds files to a variant in the package.\n"
                "If the variant already exists, it is COMPLETELY REPLACED (no merge).\n"
@@ -33,12 +34,22 @@ public:
                "                         (required for `ui_qml` packages; sets the\n"
                "                          manifest-level `view` field)\n"
                "  --yes, -y              Skip confirmation prompts\n"
+               "  --watch                Keep running and re-add the variant whenever\n"
+               "                         its files change, re-reading and recompressing\n"
+               "                         only what changed (fast per-entry compression;\n"
+               "                         the package is valid but not byte-identical\n"
+               "                         to a normal add)\n"
+               "  --digest-cache <dir>   Reuse SHA-256 digests of files unchanged since an\n"
+               "                         earlier run (by device, inode, size, mtime and\n"
+               "                         ctime) and record new ones. Defaults to\n"
+               "                         $LGX_DIGEST_CACHE if set\n"
                "\n"
                "Examples:\n"
                "  lgx add mymodule.lgx --variant linux-amd64 --files ./libfoo.so\n"
                "  lgx add mymodule.lgx -v web -f ./dist --main dist/index.js\n"
                "  lgx add mymodule.lgx -v darwin-arm64 -f ./build --view qml/Main.qml\n"
-               "  lgx add mymodule.lgx -v darwin-arm64 -f ./build -m lib.dylib --view qml/Main.qml -y";
+               "  lgx add mymodule.lgx -v darwin-arm64 -f ./build -m lib.dylib --view qml/Main.qml -y\n"
+               "  lgx add mymodule.lgx -v linux-amd64 -f ./build -m lib.so -y --watch";
     }
 };
 
@@ -0,0 +1,480 @@
+#include "bench_command.h"
+#include "core/package.h"
+#include "core/path_normalizer.h"
+#include "core/stats.h"
+#include "../crypto/signing.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/vfs.h>
+#endif
+
+namespace lgx {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+/**
+ * Timings of one reported stage across all iterations.
+ */
+struct Step {
+    std::string name;
+    int depth;                  // 1 for sub-stages measured by phase timers
+    uint64_t bytes;             // bytes processed per iteration (for MB/s)
+    uint64_t files;             // files processed per iteration (0 = not reported)
+    std::vector<uint64_t> ns;   // one sample per iteration
+
+    uint64_t median() const {
+        std::vector<uint64_t> sorted = ns;
+        std::sort(sorted.begin(), sorted.end());
+        size_t mid = sorted.size() / 2;
+        return sorted.size() % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+    }
+
+    uint64_t min() const {
+        return *std::min_element(ns.begin(), ns.end());
+    }
+
+    uint64_t mean() const {
+        uint64_t total = 0;
+        for (uint64_t sample : ns) {
+            total += sample;
+        }
+        return total / ns.size();
+    }
+};
+
+struct SystemInfo {
+    std::string os;
+    std::string arch;
+    std::string hostname;
+    std::string cpuModel;
+    unsigned cpus = 0;
+    uint64_t memoryBytes = 0;
+};
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t phaseWallNs(const Stats::Snapshot& before, const Stats::Snapshot& after, Stats::Phase phase) {
+    return after[phase].wallNs - before[phase].wallNs;
+}
+
+bool parseCount(const std::string& value, size_t& out) {
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    try {
+        out = static_cast<size_t>(std::stoull(value));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+uint64_t peakRssBytes() {
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return static_cast<uint64_t>(usage.ru_maxrss);          // bytes
+#else
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;   // KiB
+#endif
+    }
+#endif
+    return 0;
+}
+
+SystemInfo systemInfo() {
+    SystemInfo info;
+    info.cpus = std::thread::hardware_concurrency();
+#ifndef _WIN32
+    struct utsname uts;
+    if (uname(&uts) == 0) {
+        info.os = std::string(uts.sysname) + " " + uts.release;
+        info.arch = uts.machine;
+        info.hostname = uts.nodename;
+    }
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && pageSize > 0) {
+        info.memoryBytes = static_cast<uint64_t>(pages) * static_cast<uint64_t>(pageSize);
+    }
+#else
+    info.os = "Windows";
+#endif
+#ifdef __linux__
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                info.cpuModel = line.substr(line.find_first_not_of(" \t", colon + 1));
+            }
+            break;
+        }
+    }
+#endif
+    return info;
+}
+
+/**
+ * File system type of a directory, which usually explains extract times
+ * better than anything else (tmpfs vs. local disk vs. network mount).
+ */
+std::string filesystemType(const fs::path& dir) {
+#ifdef __linux__
+    struct statfs st;
+    if (statfs(dir.c_str(), &st) != 0) {
+        return "unknown";
+    }
+    switch (static_cast<unsigned long>(st.f_type)) {
+        case 0x01021994: return "tmpfs";
+        case 0xEF53: return "ext4";
+        case 0x58465342: return "xfs";
+        case 0x9123683E: return "btrfs";
+        case 0x794C7630: return "overlay";
+        case 0x6969: return "nfs";
+        case 0xFF534D42: return "cifs";
+        case 0x65735546: return "fuse";
+        case 0x5346544E: return "ntfs";
+        case 0x4D44: return "vfat";
+        case 0x2FC12FC1: return "zfs";
+    }
+    char hex[32];
+    std::snprintf(hex, sizeof(hex), "0x%lx", static_cast<unsigned long>(st.f_type));
+    return hex;
+#else
+    (void)dir;
+    return "unknown";
+#endif
+}
+
+fs::path defaultTargetBase() {
+    std::error_code ec;
+#ifdef __linux__
+    if (fs::is_directory("/dev/shm", ec) && access("/dev/shm", W_OK) == 0) {
+        return "/dev/shm";
+    }
+#endif
+    return fs::temp_directory_path(ec);
+}
+
+std::string formatDuration(uint64_t ns) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    if (ns >= 1000000000ull) {
+        out << ns / 1e9 << " s";
+    } else if (ns >= 1000000ull) {
+        out << ns / 1e6 << " ms";
+    } else {
+        out << ns / 1e3 << " us";
+    }
+    return out.str();
+}
+
+std::string formatBytes(uint64_t bytes) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (bytes >= 1024ull * 1024 * 1024) {
+        out << bytes / (1024.0 * 1024 * 1024) << " GiB";
+    } else if (bytes >= 1024ull * 1024) {
+        out << bytes / (1024.0 * 1024) << " MiB";
+    } else if (bytes >= 1024) {
+        out << bytes / 1024.0 << " KiB";
+    } else {
+        out << bytes << " B";
+    }
+    return out.str();
+}
+
+double perSecond(uint64_t amount, uint64_t ns) {
+    return ns == 0 ? 0.0 : static_cast<double>(amount) * 1e9 / static_cast<double>(ns);
+}
+
+} // anonymous namespace
+
+int BenchCommand::execute(const std::vector<std::string>& args) {
+    std::vector<std::string> positional;
+    auto opts = parseArgs(args, positional);
+
+    if (positional.empty()) {
+        printError("Missing package path");
+        std::cerr << "\nUsage: " << usage() << std::endl;
+        return 1;
+    }
+
+    std::string pkgPath = positional[0];
+    if (!fs::exists(pkgPath)) {
+        printError("Package not found: " + pkgPath);
+        return 1;
+    }
+
+    size_t iterations = 5;
+    std::string iterationsOpt = getOption(opts, "iterations", "n");
+    if (!iterationsOpt.empty() && (!parseCount(iterationsOpt, iterations) || iterations == 0)) {
+        printError("Invalid --iterations value: " + iterationsOpt);
+        return 1;
+    }
+
+    std::string variant = PathNormalizer::toLowercase(getOption(opts, "variant", "v"));
+    std::string outputOpt = getOption(opts, "output", "o");
+    const bool jsonMode = hasFlag(opts, "json");
+
+    if (!crypto::init()) {
+        printError("Failed to initialize crypto library");
+        return 1;
+    }
+
+    // Sub-stage times are read from the library's phase timers as the
+    // difference between snapshots, so counters are never reset and a
+    // global --stats still reports the whole run
+    const bool statsWereEnabled = Stats::isEnabled();
+    Stats::setEnabled(true);
+    struct RestoreStats {
+        bool enabled;
+        ~RestoreStats() { Stats::setEnabled(enabled); }
+    } restoreStats{statsWereEnabled};
+
+    std::error_code ec;
+    uint64_t compressedBytes = fs::file_size(pkgPath, ec);
+
+    Step load{"load", 0, 0, 0, {}};
+    Step read{"read", 1, compressedBytes, 0, {}};
+    Step decompress{"decompress", 1, 0, 0, {}};
+    Step tarParse{"tar_parse", 1, 0, 0, {}};
+
+    std::optional<Package> pkg;
+    for (size_t i = 0; i < iterations; ++i) {
+        pkg.reset();
+        auto before = Stats::snapshot();
+        uint64_t start = nowNs();
+        pkg = Package::load(pkgPath);
+        uint64_t elapsed = nowNs() - start;
+        auto after = Stats::snapshot();
+        if (!pkg) {
+            printError("Failed to load package: " + Package::getLastError());
+            return 1;
+        }
+        load.ns.push_back(elapsed);
+        read.ns.push_back(phaseWallNs(before, after, Stats::Phase::FileRead));
+        decompress.ns.push_back(phaseWallNs(before, after, Stats::Phase::Inflate));
+        tarParse.ns.push_back(phaseWallNs(before, after, Stats::Phase::TarParse));
+    }
+
+    if (!variant.empty() && !pkg->hasVariant(variant)) {
+        printError("Variant not found: " + variant);
+        return 1;
+    }
+
+    // Content totals, for throughput
+    uint64_t contentBytes = 0;
+    uint64_t fileCount = 0;
+    uint64_t extractBytes = 0;
+    uint64_t extractFiles = 0;
+    const std::string extractPrefix = variant.empty() ? "variants/" : "variants/" + variant + "/";
+    for (const auto& entry : pkg->getEntries()) {
+        if (entry.isDirectory) {
+            continue;
+        }
+        contentBytes += entry.data.size();
+        ++fileCount;
+        if (entry.path.rfind(extractPrefix, 0) == 0) {
+            extractBytes += entry.data.size();
+            ++extractFiles;
+        }
+    }
+    for (Step* step : {&load, &decompress, &tarParse}) {
+        step->bytes = contentBytes;
+    }
+    load.files = fileCount;
+    tarParse.files = fileCount;
+
+    Step validate{"validate", 0, contentBytes, fileCount, {}};
+    Step merkle{"merkle", 1, contentBytes, fileCount, {}};
+    bool valid = true;
+    for (size_t i = 0; i < iterations; ++i) {
+        auto before = Stats::snapshot();
+        uint64_t start = nowNs();
+        auto result = pkg->validatePackage();
+        uint64_t elapsed = nowNs() - start;
+        auto after = Stats::snapshot();
+        valid = valid && result.valid;
+        validate.ns.push_back(elapsed);
+        merkle.ns.push_back(phaseWallNs(before, after, Stats::Phase::Hash));
+    }
+
+    Step verify{"verify_signature", 0, contentBytes, fileCount, {}};
+    bool signatureValid = false;
+    if (pkg->isSigned()) {
+        signatureValid = true;
+        for (size_t i = 0; i < iterations; ++i) {
+            uint64_t start = nowNs();
+            auto info = pkg->verifySignature();
+            verify.ns.push_back(nowNs() - start);
+            signatureValid = signatureValid && info.signature_valid;
+        }
+    }
+
+    // Extract into a private scratch directory so nothing of the user's is
+    // ever removed
+    fs::path targetBase = outputOpt.empty() ? defaultTargetBase() : fs::path(outputOpt);
+    fs::create_directories(targetBase, ec);
+    fs::path target = targetBase / ("lgx-bench-" + std::to_string(
+#ifndef _WIN32
+        static_cast<long>(getpid())
+#else
+        0L
+#endif
+    ));
+    std::string targetFs = filesystemType(targetBase);
+
+    Step extract{"extract", 0, extractBytes, extractFiles, {}};
+    for (size_t i = 0; i < iterations; ++i) {
+        fs::remove_all(target, ec);
+        fs::create_directories(target, ec);
+        if (ec) {
+            printError("Cannot create extract directory: " + target.string());
+            return 1;
+        }
+        uint64_t start = nowNs();
+        auto result = variant.empty() ? pkg->extractAll(target) : pkg->extractVariant(variant, target);
+        uint64_t elapsed = nowNs() - start;
+        if (!result.success) {
+            fs::remove_all(target, ec);
+            printError("Extract failed: " + result.error);
+            return 1;
+        }
+        extract.ns.push_back(elapsed);
+    }
+    fs::remove_all(target, ec);
+
+    std::vector<const Step*> steps = {&load, &read, &decompress, &tarParse, &validate, &merkle};
+    if (!verify.ns.empty()) {
+        steps.push_back(&verify);
+    }
+    steps.push_back(&extract);
+
+    uint64_t peakRss = peakRssBytes();
+    SystemInfo sys = systemInfo();
+
+    if (jsonMode) {
+        nlohmann::ordered_json stepsJson = nlohmann::ordered_json::array();
+        for (const Step* step : steps) {
+            uint64_t median = step->median();
+            nlohmann::ordered_json s = {
+                {"name", step->name},
+                {"median_ns", median},
+                {"min_ns", step->min()},
+                {"mean_ns", step->mean()},
+                {"bytes", step->bytes},
+                {"mb_per_s", perSecond(step->bytes, median) / 1e6}
+            };
+            if (step->files > 0) {
+                s["files"] = step->files;
+                s["files_per_s"] = perSecond(step->files, median);
+            }
+            stepsJson.push_back(s);
+        }
+
+        nlohmann::ordered_json report = {
+            {"package", {
+                {"path", pkgPath},
+                {"compressed_bytes", compressedBytes},
+                {"content_bytes", contentBytes},
+                {"files", fileCount},
+                {"variants", pkg->getVariants().size()},
+                {"valid", valid},
+                {"signed", pkg->isSigned()},
+                {"signature_valid", signatureValid}
+            }},
+            {"iterations", iterations},
+            {"extract", {
+                {"variant", variant.empty() ? "all" : variant},
+                {"directory", targetBase.string()},
+                {"filesystem", targetFs}
+            }},
+            {"steps", stepsJson},
+            {"peak_rss_bytes", peakRss},
+            {"system", {
+                {"os", sys.os},
+                {"arch", sys.arch},
+                {"hostname", sys.hostname},
+                {"cpu_model", sys.cpuModel},
+                {"cpus", sys.cpus},
+                {"memory_bytes", sys.memoryBytes}
+            }}
+        };
+        std::cout << report.dump(2) << std::endl;
+        return 0;
+    }
+
+    std::cout << "Package:    " << pkgPath << "\n"
+              << "            " << formatBytes(compressedBytes) << " compressed, "
+              << formatBytes(contentBytes) << " in " << fileCount << " files, "
+              << pkg->getVariants().size() << " variant(s), "
+              << (pkg->isSigned() ? "signed" : "unsigned")
+              << (valid ? "" : ", INVALID") << "\n"
+              << "Extract to: " << targetBase.string() << " (" << targetFs << ")"
+              << (variant.empty() ? "" : ", variant " + variant) << "\n"
+              << "Iterations: " << iterations << "\n\n";
+
+    std::cout << std::left << std::setw(20) << "Stage"
+              << std::right << std::setw(12) << "median"
+              << std::setw(12) << "min"
+              << std::setw(12) << "mean"
+              << std::setw(12) << "MB/s"
+              << std::setw(12) << "files/s" << "\n";
+    for (const Step* step : steps) {
+        uint64_t median = step->median();
+        std::ostringstream mbps;
+        std::ostringstream fps;
+        mbps << std::fixed << std::setprecision(1) << perSecond(step->bytes, median) / 1e6;
+        if (step->files > 0) {
+            fps << std::fixed << std::setprecision(0) << perSecond(step->files, median);
+        } else {
+            fps << "-";
+        }
+        std::cout << std::left << std::setw(20) << std::string(step->depth * 2, ' ') + step->name
+                  << std::right << std::setw(12) << formatDuration(median)
+                  << std::setw(12) << formatDuration(step->min())
+                  << std::setw(12) << formatDuration(step->mean())
+                  << std::setw(12) << mbps.str()
+                  << std::setw(12) << fps.str() << "\n";
+    }
+
+    std::cout << "\nPeak RSS:   " << formatBytes(peakRss) << "\n"
+              << "System:     " << sys.os << " " << sys.arch << ", " << sys.cpus << " CPUs";
+    if (!sys.cpuModel.empty()) {
+        std::cout << " (" << sys.cpuModel << ")";
+    }
+    if (sys.memoryBytes > 0) {
+        std::cout << ", " << formatBytes(sys.memoryBytes) << " RAM";
+    }
+    std::cout << "\n"
+              << "Host:       " << sys.hostname << std::endl;
+    return 0;
+}
+
+} // namespace lgx
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "command.h"
+
+namespace lgx {
+
+/**
+ * Bench command: lgx bench <pkg.lgx>
+ *
+ * Times each stage of loading, validating, verifying and extracting a real
+ * package on the current host, so slow installs can be diagnosed with
+ * numbers from the affected machine.
+ */
+class BenchCommand : public Command {
+public:
+    int execute(const std::vector<std::string>& args) override;
+    std::string name() const override { return "bench"; }
+    std::string description() const override {
+        return "Measure package performance on this host";
+    }
+    std::string usage() const override {
+        return "lgx bench <pkg.lgx> [--iterations <n>] [--variant <v>] [--output <dir>] [--json]\n"
+               "\n"
+               "Runs each stage of the install path on the package, N times, and\n"
+               "reports the median, minimum and mean time of each:\n"
+               "  load              read + decompress + tar parse (Package::load)\n"
+               "    read            reading the .lgx file\n"
+               "    decompress      gzip inflate\n"
+               "    tar_parse       tar stream -> entries\n"
+               "  validate          structure and content hash checks\n"
+               "    merkle          Merkle tree over all files\n"
+               "  verify_signature  validation + Ed25519 check (signed packages only)\n"
+               "  extract           writing files to the target directory\n"
+               "\n"
+               "Also reports throughput (MB/s, files/s), peak RSS and system details.\n"
+               "Sub-stage times come from the library's own phase timers (see --stats).\n"
+               "\n"
+               "Options:\n"
+               "  --iterations, -n <n>  Repetitions per stage (default: 5)\n"
+               "  --variant, -v <name>  Extract only this variant (default: all)\n"
+               "  --output, -o <dir>    Extract under <dir> (default: /dev/shm if\n"
+               "                        available, else the system temp directory).\n"
+               "                        A scratch subdirectory is created and removed.\n"
+               "  --json                Print the report as JSON\n"
+               "\n"
+               "Examples:\n"
+               "  lgx bench mymodule.lgx\n"
+               "  lgx bench mymodule.lgx -n 20 --output /opt/logos/modules --json";
+    }
+};
+
+} // namespace lgx
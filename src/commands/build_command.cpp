@@ -0,0 +1,63 @@
+#include "build_command.h"
+#include "core/build_spec.h"
+#include "core/digest_cache.h"
+#include "core/incremental_build.h"
+
+#include <filesystem>
+#include <iostream>
+
+namespace lgx {
+
+int BuildCommand::execute(const std::vector<std::string>& args) {
+    std::vector<std::string> positional;
+    auto opts = parseArgs(args, positional);
+
+    if (positional.empty()) {
+        printError("Missing build spec");
+        std::cerr << "\nUsage: " << usage() << std::endl;
+        return 1;
+    }
+
+    auto spec = BuildSpec::load(positional[0]);
+    if (!spec) {
+        printError(BuildSpec::getLastError());
+        return 1;
+    }
+
+    std::string outputOpt = getOption(opts, "output", "o");
+    std::filesystem::path outputPath = outputOpt.empty() ? spec->outputPath()
+                                                         : std::filesystem::path(outputOpt);
+
+    auto digestCache = openDigestCache(opts);
+    spec->inputs.digestCache = digestCache.get();
+
+    if (hasFlag(opts, "watch")) {
+        auto base = spec->basePackage();
+        if (!base) {
+            printError(BuildSpec::getLastError());
+            return 1;
+        }
+        IncrementalBuild build(std::move(*base), spec->inputs, outputPath);
+        auto result = build.build();
+        if (!result.success) {
+            printError(result.error);
+            return 1;
+        }
+        finishDigestCache(digestCache.get());
+        printSuccess("Built package: " + outputPath.string());
+        return watchAndRebuild(build);
+    }
+
+    auto result = spec->build(outputPath);
+    if (!result.success) {
+        printError(result.error);
+        return 1;
+    }
+    finishDigestCache(digestCache.get());
+
+    printSuccess("Built package: " + outputPath.string() + " (" +
+                 std::to_string(spec->inputs.variants.size()) + " variant(s))");
+    return 0;
+}
+
+} // namespace lgx
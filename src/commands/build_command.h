@@ -0,0 +1,61 @@
+#pragma once
+
+#include "command.h"
+
+namespace lgx {
+
+/**
+ * Build command: lgx build <spec.json> [--output <file>] [--watch] [--digest-cache <dir>]
+ *
+ * Builds a complete package from a declarative spec in one pass, instead
+ * of `lgx create` followed by one `lgx add` per variant.
+ */
+class BuildCommand : public Command {
+public:
+    int execute(const std::vector<std::string>& args) override;
+    std::string name() const override { return "build"; }
+    std::string description() const override {
+        return "Build a package from a JSON spec";
+    }
+    std::string usage() const override {
+        return "lgx build <spec.json> [--output <file>] [--watch] [--digest-cache <dir>]\n"
+               "\n"
+               "Reads every variant, doc and license named in the spec in parallel\n"
+               "and writes the package once. The result is byte-identical to\n"
+               "`lgx create` followed by one `lgx add` per variant.\n"
+               "\n"
+               "Spec format (paths are relative to the spec file):\n"
+               "  {\n"
+               "    \"name\": \"waku_module\",\n"
+               "    \"version\": \"1.2.0\",\n"
+               "    \"variants\": {\n"
+               "      \"linux-amd64\": { \"files\": \"build/linux\", \"main\": \"waku.so\" },\n"
+               "      \"darwin-arm64\": \"build/darwin/waku.dylib\"\n"
+               "    },\n"
+               "    \"docs\": [\"README.md\"],\n"
+               "    \"licenses\": [\"LICENSE\"],\n"
+               "    \"output\": \"dist/waku_module.lgx\"\n"
+               "  }\n"
+               "Any other manifest.json field (description, author, type, category,\n"
+               "icon, display_name, view, dependencies) may be set as well.\n"
+               "\n"
+               "Options:\n"
+               "  --output, -o <file>   Package to write (default: the spec's \"output\",\n"
+               "                        else <name>.lgx). An existing file is replaced\n"
+               "  --watch               Keep running and rebuild whenever an input\n"
+               "                        changes, re-reading and recompressing only\n"
+               "                        what changed. Watch-mode output is a valid\n"
+               "                        package but not byte-identical to a normal\n"
+               "                        build (fast per-entry compression)\n"
+               "  --digest-cache <dir>  Reuse SHA-256 digests of input files unchanged\n"
+               "                        since an earlier run and record new ones.\n"
+               "                        Defaults to $LGX_DIGEST_CACHE if set\n"
+               "\n"
+               "Examples:\n"
+               "  lgx build build.json\n"
+               "  lgx build ci/build.json -o dist/waku_module.lgx\n"
+               "  lgx build build.json --watch";
+    }
+};
+
+} // namespace lgx
@@ -0,0 +1,129 @@
+#include "catalog_command.h"
+#include "core/catalog.h"
+
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <iostream>
+
+namespace lgx {
+
+namespace {
+
+nlohmann::ordered_json entryToJson(const Catalog& catalog, const Catalog::Entry& entry) {
+    nlohmann::ordered_json deps = nlohmann::ordered_json::array();
+    for (const auto& dep : entry.dependencies) {
+        deps.push_back(dep.toString());
+    }
+    return {
+        {"name", entry.name},
+        {"version", entry.version},
+        {"path", catalog.packagePath(entry).string()},
+        {"type", entry.type},
+        {"signer", entry.signer.empty() ? nlohmann::ordered_json() : nlohmann::ordered_json(entry.signer)},
+        {"root", entry.rootHash},
+        {"dependencies", deps},
+    };
+}
+
+} // namespace
+
+int CatalogCommand::execute(const std::vector<std::string>& args) {
+    std::vector<std::string> positional;
+    auto opts = parseArgs(args, positional);
+
+    if (positional.size() < 2) {
+        printError("Usage: lgx catalog build|update|query <dir> [options]");
+        return 1;
+    }
+    const std::string& subcommand = positional[0];
+    std::filesystem::path dir = positional[1];
+    std::filesystem::path indexPath = getOption(opts, "index");
+    const bool jsonMode = hasFlag(opts, "json");
+
+    if (subcommand == "build" || subcommand == "update") {
+        auto result = Catalog::update(dir, indexPath, subcommand == "build");
+        if (!result.success) {
+            printError(result.error);
+            return 1;
+        }
+
+        if (jsonMode) {
+            nlohmann::ordered_json report = {
+                {"scanned", result.scanned},
+                {"parsed", result.parsed},
+                {"unchanged", result.unchanged},
+                {"removed", result.removed},
+                {"failed", result.failed},
+            };
+            std::cout << report.dump(2) << std::endl;
+        } else {
+            printSuccess("Indexed " + std::to_string(result.scanned) + " package(s) in " +
+                         dir.string());
+            std::cout << "  read:      " << result.parsed << "\n"
+                      << "  unchanged: " << result.unchanged << "\n"
+                      << "  removed:   " << result.removed << "\n";
+            if (result.failed > 0) {
+                std::cout << "  failed:    " << result.failed << "\n";
+            }
+        }
+
+        // Failures are recorded in the index; name them so they can be fixed
+        if (result.failed > 0 && !jsonMode) {
+            auto catalog = Catalog::open(dir, indexPath);
+            if (catalog) {
+                for (const auto& entry : catalog->entries()) {
+                    if (!entry.isValid()) {
+                        std::cerr << "  " << entry.path << ": " << entry.error << "\n";
+                    }
+                }
+            }
+        }
+        return 0;
+    }
+
+    if (subcommand == "query") {
+        auto catalog = Catalog::open(dir, indexPath);
+        if (!catalog) {
+            printError(Catalog::getLastError() + " (run 'lgx catalog update " + dir.string() + "')");
+            return 1;
+        }
+
+        Catalog::Query query;
+        query.name = getOption(opts, "name");
+        query.versionRange = getOption(opts, "version");
+        query.signer = getOption(opts, "signer");
+
+        auto matches = catalog->find(query);
+        if (!matches) {
+            printError("Invalid version range: " + Catalog::getLastError());
+            return 1;
+        }
+
+        if (jsonMode) {
+            nlohmann::ordered_json list = nlohmann::ordered_json::array();
+            for (const auto* entry : *matches) {
+                list.push_back(entryToJson(*catalog, *entry));
+            }
+            std::cout << list.dump(2) << std::endl;
+            return 0;
+        }
+
+        for (const auto* entry : *matches) {
+            std::cout << entry->name << " " << entry->version << "  "
+                      << catalog->packagePath(*entry).string();
+            if (!entry->signer.empty()) {
+                std::cout << "  [signer=" << entry->signer << "]";
+            }
+            std::cout << "\n";
+        }
+        if (matches->empty()) {
+            printInfo("No matching packages");
+        }
+        return 0;
+    }
+
+    printError("Unknown subcommand: " + subcommand + ". Use: lgx catalog build|update|query <dir>");
+    return 1;
+}
+
+} // namespace lgx
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "command.h"
+
+namespace lgx {
+
+/**
+ * Catalog command: lgx catalog build|update|query <dir>
+ *
+ * Maintains an index of the packages in a directory so lookups by name,
+ * version range and signer do not open every package.
+ */
+class CatalogCommand : public Command {
+public:
+    int execute(const std::vector<std::string>& args) override;
+    std::string name() const override { return "catalog"; }
+    std::string description() const override {
+        return "Index a directory of packages for fast lookup";
+    }
+    std::string usage() const override {
+        return "lgx catalog <subcommand> <dir> [options]\n"
+               "\n"
+               "Subcommands:\n"
+               "  build <dir>    Index every .lgx under <dir> from scratch\n"
+               "  update <dir>   Re-read only packages added or changed since the\n"
+               "                 last build/update and drop removed ones (builds the\n"
+               "                 index if there is none yet)\n"
+               "  query <dir>    List indexed packages matching the filters below\n"
+               "\n"
+               "The index is stored as <dir>/.lgx-catalog.jsonl unless --index is\n"
+               "given. Only manifest.json and manifest.sig of each package are read;\n"
+               "the signer is recorded only if the signature verifies over the\n"
+               "manifest. Content hashes are not checked.\n"
+               "\n"
+               "Options:\n"
+               "  --index <file>        Index file location\n"
+               "  --name <name>         (query) Exact package name\n"
+               "  --version <range>     (query) Semver range, e.g. \"^1.2\" or \">=1 <2\"\n"
+               "  --signer <did>        (query) Signer DID (did:jwk:...)\n"
+               "  --json                Print results as JSON\n"
+               "\n"
+               "Examples:\n"
+               "  lgx catalog update ./repo\n"
+               "  lgx catalog query ./repo --name waku_module --version \"^1.2\"";
+    }
+};
+
+} // namespace lgx
@@ -0,0 +1,135 @@
+#include "check_installed_command.h"
+#include "core/installed_check.h"
+#include "core/package.h"
+#include "core/path_normalizer.h"
+#include "../crypto/keyring.h"
+#include "../crypto/manifest_sig.h"
+#include "../crypto/signing.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace lgx {
+
+namespace {
+
+std::optional<std::string> readText(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return std::nullopt;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+} // anonymous namespace
+
+int CheckInstalledCommand::execute(const std::vector<std::string>& args) {
+    std::vector<std::string> positional;
+    auto opts = parseArgs(args, positional);
+
+    if (positional.empty()) {
+        printError("Missing installed variant directory");
+        std::cerr << "\nUsage: " << usage() << std::endl;
+        return 1;
+    }
+    std::string manifestPath = getOption(opts, "manifest");
+    if (manifestPath.empty()) {
+        printError("Missing required option: --manifest <manifest.json>");
+        return 1;
+    }
+    std::string signaturePath = getOption(opts, "signature");
+
+    std::filesystem::path dir = std::filesystem::path(positional[0]).lexically_normal();
+    if (!dir.has_filename()) {
+        dir = dir.parent_path();  // trailing '/'
+    }
+    std::string variant = getOption(opts, "variant", "v", dir.filename().string());
+
+    auto manifestText = readText(manifestPath);
+    if (!manifestText) {
+        printError("Cannot read manifest: " + manifestPath);
+        return 1;
+    }
+    auto manifest = Manifest::fromJson(*manifestText);
+    if (!manifest) {
+        printError("Invalid manifest " + manifestPath + ": " + Manifest::getLastError());
+        return 1;
+    }
+
+    if (!crypto::init()) {
+        printError("Failed to initialize crypto library");
+        return 1;
+    }
+
+    // A signed manifest is only trusted once its signature checks out
+    if (!signaturePath.empty()) {
+        auto sigText = readText(signaturePath);
+        if (!sigText) {
+            printError("Cannot read signature: " + signaturePath);
+            return 1;
+        }
+        auto signature = crypto::ManifestSig::fromJson(*sigText);
+        if (!signature) {
+            printError("Invalid signature " + signaturePath + ": " + crypto::ManifestSig::getLastError());
+            return 1;
+        }
+        auto sigCheck = Package::verifyManifestSignature(*manifest, *signature);
+        if (!sigCheck.success) {
+            printError("Signature verification FAILED: " + sigCheck.error);
+            return 1;
+        }
+        printSuccess("Manifest signature is valid");
+        printInfo("Signer DID: " + signature->did);
+
+        std::string keyringDirOpt = getOption(opts, "keyring-dir");
+        std::filesystem::path keyringDir = keyringDirOpt.empty()
+            ? crypto::Keyring::defaultDirectory() : std::filesystem::path(keyringDirOpt);
+        if (!keyringDir.empty() && std::filesystem::exists(keyringDir)) {
+            crypto::Keyring keyring(keyringDir);
+            if (auto trusted = keyring.findByDid(signature->did)) {
+                printSuccess("Signer is trusted: " + trusted->name);
+            } else {
+                printInfo("Signer DID is NOT in trusted keyring");
+            }
+        }
+    }
+
+    auto report = InstalledCheck::check(dir, *manifest, variant);
+    if (!report) {
+        printError(InstalledCheck::getLastError());
+        return 1;
+    }
+
+    std::string what = "variant '" + PathNormalizer::toLowercase(variant) + "' of " +
+                       manifest->name + " " + manifest->version;
+    std::string counted = std::to_string(report->files) + " files, " +
+                          std::to_string(report->bytes) + " bytes";
+    if (report->match) {
+        printSuccess(dir.string() + " matches " + what + " (" + counted + ")");
+        return 0;
+    }
+
+    printError(dir.string() + " does NOT match " + what + " (" + counted + ")");
+    printInfo("Expected hash: " + report->expectedHash);
+    printInfo("Actual hash:   " + report->actualHash);
+    for (const auto& path : report->modified) {
+        std::cout << "  modified:   " << path << std::endl;
+    }
+    for (const auto& path : report->missing) {
+        std::cout << "  missing:    " << path << std::endl;
+    }
+    for (const auto& path : report->unexpected) {
+        std::cout << "  unexpected: " << path << std::endl;
+    }
+    if (!report->localized) {
+        printInfo("No per-file record of this version (written by `lgx extract --update`); "
+                  "cannot tell which files differ");
+    }
+    return 1;
+}
+
+} // namespace lgx
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "command.h"
+
+namespace lgx {
+
+/**
+ * Check-installed command: lgx check-installed <dir> --manifest <manifest.json>
+ *                          [--signature <manifest.sig>] [--variant <v>]
+ *
+ * Checks an extracted variant directory against the manifest of the
+ * package it came from, without the .lgx file.
+ */
+class CheckInstalledCommand : public Command {
+public:
+    int execute(const std::vector<std::string>& args) override;
+    std::string name() const override { return "check-installed"; }
+    std::string description() const override {
+        return "Check an extracted variant against its manifest";
+    }
+    std::string usage() const override {
+        return "lgx check-installed <dir> --manifest <manifest.json> [--signature <manifest.sig>]\n"
+               "                    [--variant <v>] [--keyring-dir <dir>]\n"
+               "\n"
+               "Hashes every file under <dir>, an extracted variant directory, and\n"
+               "compares the result with the variant's hash in the manifest. Like\n"
+               "that hash, the check covers file paths and contents, not modes or\n"
+               "empty directories.\n"
+               "\n"
+               "The manifest stores one hash per variant. Which files differ can be\n"
+               "reported only if the tree was installed with `lgx extract --update`,\n"
+               "which records per-file digests beside it.\n"
+               "\n"
+               "Options:\n"
+               "  --manifest <file>      The package's manifest.json (from `lgx manifest --json`)\n"
+               "  --signature <file>     Its manifest.sig (from `lgx signature`); the\n"
+               "                         signature must be valid\n"
+               "  --variant, -v <name>   Variant name (default: the name of <dir>)\n"
+               "  --keyring-dir <dir>    Keyring to look the signer up in\n"
+               "\n"
+               "Returns 0 if the tree matches, 1 if it does not or on error.\n"
+               "\n"
+               "Examples:\n"
+               "  lgx manifest mymodule.lgx --json > manifest.json\n"
+               "  lgx signature mymodule.lgx > manifest.sig\n"
+               "  lgx check-installed /opt/modules/linux-amd64 --manifest manifest.json \\\n"
+               "      --signature manifest.sig";
+    }
+};
+
+} // namespace lgx
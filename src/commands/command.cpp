@@ -1,10 +1,26 @@
 #include "command.h"
+#include "core/digest_cache.h"
+#include "core/incremental_build.h"
 
 #include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
 #include <sstream>
 
 namespace lgx {
 
+namespace {
+
+std::atomic<bool> g_watchStop{false};
+
+void handleWatchSignal(int) {
+    g_watchStop = true;
+}
+
+} // namespace
+
 std::map<std::string, std::string> Command::parseArgs(
     const std::vector<std::string>& args,
     std::vector<std::string>& positional
@@ -119,4 +135,56 @@ void Command::printInfo(const std::string& message) {
     std::cout << message << std::endl;
 }
 
+int Command::watchAndRebuild(IncrementalBuild& build) {
+    g_watchStop = false;
+    std::signal(SIGINT, handleWatchSignal);
+    std::signal(SIGTERM, handleWatchSignal);
+    printInfo("Watching for changes (Ctrl-C to stop)...");
+
+    auto result = build.watch(g_watchStop,
+        [&build](const Package::Result& update, size_t changedPaths, double seconds) {
+            char elapsed[32];
+            std::snprintf(elapsed, sizeof(elapsed), "%.0f ms", seconds * 1000);
+            if (update.success) {
+                printInfo("Rebuilt in " + std::string(elapsed) + " (" + std::to_string(changedPaths) +
+                          " changed path(s), " + std::to_string(build.lastCompressed()) +
+                          " record(s) recompressed)");
+            } else {
+                printError(update.error + " (waiting for the next change)");
+            }
+        });
+
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    if (!result.success) {
+        printError(result.error);
+        return 1;
+    }
+    return 0;
+}
+
+std::unique_ptr<DigestCache> Command::openDigestCache(
+    const std::map<std::string, std::string>& opts
+) {
+    std::string dir = getOption(opts, "digest-cache");
+    if (dir.empty()) {
+        const char* env = std::getenv(DigestCache::ENV_VAR);
+        dir = env ? env : "";
+    }
+    if (dir.empty()) {
+        return nullptr;
+    }
+    return std::make_unique<DigestCache>(dir);
+}
+
+void Command::finishDigestCache(DigestCache* cache) {
+    if (!cache) {
+        return;
+    }
+    if (!cache->save()) {
+        std::cerr << "Warning: " << DigestCache::getLastError() << std::endl;
+    }
+    printInfo("Digest cache: " + cache->summary());
+}
+
 } // namespace lgx
@@ -3,10 +3,14 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 #include <iostream>
 
 namespace lgx {
 
+class DigestCache;
+class IncrementalBuild;
+
 /**
  * Base class for CLI commands.
  */
@@ -88,6 +92,29 @@ protected:
      * Print info message to stdout.
      */
     static void printInfo(const std::string& message);
+
+    /**
+     * Rebuild on every input change until SIGINT or SIGTERM (`--watch`),
+     * printing one line per rebuild. The initial build must already be done.
+     *
+     * @return Exit code
+     */
+    static int watchAndRebuild(IncrementalBuild& build);
+
+    /**
+     * Open the digest cache named by --digest-cache <dir>, else by the
+     * LGX_DIGEST_CACHE environment variable.
+     *
+     * @return The cache, or nullptr if neither is set
+     */
+    static std::unique_ptr<DigestCache> openDigestCache(
+        const std::map<std::string, std::string>& opts);
+
+    /**
+     * Save a digest cache and print its hit rate. A cache that cannot be
+     * saved is only warned about.
+     */
+    static void finishDigestCache(DigestCache* cache);
 };
 
 } // namespace lgx
@@ -1,11 +1,39 @@
 #include "extract_command.h"
 #include "core/package.h"
 #include "core/path_normalizer.h"
+#include "../server/client.h"
 
 #include <filesystem>
 
 namespace lgx {
 
+namespace {
+
+// Split a comma-separated option value, dropping empty items
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= value.size()) {
+        size_t end = value.find(',', start);
+        if (end == std::string::npos) {
+            end = value.size();
+        }
+        if (end > start) {
+            items.push_back(value.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return items;
+}
+
+// "3 written, 1204 unchanged, 1 removed"
+std::string updateSummary(size_t written, size_t kept, size_t removed) {
+    return std::to_string(written) + " written, " + std::to_string(kept) + " unchanged, " +
+           std::to_string(removed) + " removed";
+}
+
+} // anonymous namespace
+
 int ExtractCommand::execute(const std::vector<std::string>& args) {
     std::vector<std::string> positional;
     auto opts = parseArgs(args, positional);
@@ -21,6 +49,20 @@ int ExtractCommand::execute(const std::vector<std::string>& args) {
     
     std::string variant = getOption(opts, "variant", "v");
     std::string outputDir = getOption(opts, "output", "o", ".");
+    std::vector<std::string> include = splitList(getOption(opts, "include"));
+    std::vector<std::string> exclude = splitList(getOption(opts, "exclude"));
+    PathFilter filter(include, exclude);
+    bool update = hasFlag(opts, "update");
+    auto durability = hasFlag(opts, "durable") ? Package::Durability::Durable
+                                               : Package::Durability::Default;
+    if (update && !filter.empty()) {
+        printError("--update cannot be combined with --include/--exclude");
+        return 1;
+    }
+    if (durability == Package::Durability::Durable && !update && !filter.empty()) {
+        printError("--durable cannot be combined with --include/--exclude");
+        return 1;
+    }
     
     // Check if package exists
     if (!std::filesystem::exists(pkgPath)) {
@@ -28,38 +70,126 @@ int ExtractCommand::execute(const std::vector<std::string>& args) {
         return 1;
     }
     
-    // Load the package
-    auto pkgOpt = Package::load(pkgPath);
+    // Forward to a running daemon if one is configured
+    if (auto client = server::Client::fromEnvironment()) {
+        nlohmann::json request = {
+            {"op", "extract"},
+            {"path", std::filesystem::absolute(pkgPath).string()},
+            {"output", std::filesystem::absolute(outputDir).string()}
+        };
+        if (!variant.empty()) {
+            request["variant"] = variant;
+        }
+        if (!include.empty()) {
+            request["include"] = include;
+        }
+        if (!exclude.empty()) {
+            request["exclude"] = exclude;
+        }
+        if (update) {
+            request["update"] = true;
+        }
+        if (durability == Package::Durability::Durable) {
+            request["durable"] = true;
+        }
+        auto response = client->request(request);
+        if (response) {
+            if (!response->value("ok", false)) {
+                printError(response->value("error", "Daemon request failed"));
+                return 1;
+            }
+            size_t count = response->value("variants", size_t{0});
+            std::string what = variant.empty() ? std::to_string(count) + " variant(s)"
+                                               : "variant '" + response->value("variant", variant) + "'";
+            if (update && response->value("unchanged", false)) {
+                printInfo("Installed " + what + " in " + outputDir + " already up to date");
+            } else if (update) {
+                printSuccess("Updated " + what + " in " + outputDir + ": " +
+                             updateSummary(response->value("written", size_t{0}),
+                                           response->value("kept", size_t{0}),
+                                           response->value("removed", size_t{0})));
+            } else if (!variant.empty()) {
+                printSuccess("Extracted variant '" + response->value("variant", variant) +
+                             "' to " + outputDir);
+            } else if (count == 0) {
+                printInfo("No variants to extract");
+            } else {
+                printSuccess("Extracted " + std::to_string(count) + " variant(s) to " + outputDir);
+            }
+            return 0;
+        }
+    }
+
+    // Load only the files that will be written: those of the requested
+    // variant (or all) that pass the filter. Directories carry no data and
+    // are all kept; extraction creates only the ones the filter selects.
+    std::string variantLc = PathNormalizer::toLowercase(variant);
+    std::string prefix = variant.empty() ? "variants/" : "variants/" + variantLc + "/";
+    size_t totalFiles = 0;
+    size_t matchedFiles = 0;
+    auto keep = [&](const std::string& path, bool isDirectory) {
+        if (isDirectory) {
+            return true;
+        }
+        if (path.compare(0, prefix.size(), prefix) != 0) {
+            return false;
+        }
+        size_t rootEnd = variant.empty() ? path.find('/', prefix.size()) : prefix.size() - 1;
+        if (rootEnd == std::string::npos) {
+            return false;
+        }
+        ++totalFiles;
+        bool selected = filter.matches(path.substr(rootEnd + 1));
+        matchedFiles += selected ? 1 : 0;
+        return selected;
+    };
+    auto pkgOpt = Package::load(pkgPath, keep);
     if (!pkgOpt) {
         printError("Failed to load package: " + Package::getLastError());
         return 1;
     }
     
     Package& pkg = *pkgOpt;
+    std::string matched = filter.empty() ? "" :
+        " (" + std::to_string(matchedFiles) + " of " + std::to_string(totalFiles) + " files matched)";
     
     Package::Result result;
-    if (variant.empty()) {
-        result = pkg.extractAll(outputDir);
+    if (update) {
+        if (!variant.empty() && !pkg.hasVariant(variantLc)) {
+            printError("Variant not found: " + variant);
+            return 1;
+        }
+        Package::UpdateCounts counts;
+        result = variant.empty() ? pkg.updateAll(outputDir, &counts, durability)
+                                 : pkg.updateVariant(variantLc, outputDir, &counts, durability);
+        std::string what = variant.empty() ? std::to_string(pkg.getVariants().size()) + " variant(s)"
+                                           : "variant '" + variantLc + "'";
+        if (result.unchanged) {
+            printInfo("Installed " + what + " in " + outputDir + " already up to date");
+        } else if (result.success) {
+            printSuccess("Updated " + what + " in " + outputDir + ": " +
+                         updateSummary(counts.written, counts.kept, counts.removed));
+        }
+    } else if (variant.empty()) {
+        result = pkg.extractAll(outputDir, filter, durability);
         if (result.success) {
             auto variants = pkg.getVariants();
             if (variants.empty()) {
                 printInfo("No variants to extract");
             } else {
                 printSuccess("Extracted " + std::to_string(variants.size()) + 
-                           " variant(s) to " + outputDir);
+                           " variant(s) to " + outputDir + matched);
             }
         }
     } else {
-        std::string variantLc = PathNormalizer::toLowercase(variant);
-        
         if (!pkg.hasVariant(variantLc)) {
             printError("Variant not found: " + variant);
             return 1;
         }
         
-        result = pkg.extractVariant(variantLc, outputDir);
+        result = pkg.extractVariant(variantLc, outputDir, filter, durability);
         if (result.success) {
-            printSuccess("Extracted variant '" + variantLc + "' to " + outputDir);
+            printSuccess("Extracted variant '" + variantLc + "' to " + outputDir + matched);
         }
     }
     
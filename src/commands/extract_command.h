@@ -6,9 +6,12 @@ namespace lgx {
 
 /**
  * Extract command: lgx extract <pkg.lgx> [--variant <v>] [--output <dir>]
+ *                   [--include <globs>] [--exclude <globs>] [--update]
  * 
  * Extracts variant contents from a package to a directory.
- * If no variant is specified, extracts all variants.
+ * If no variant is specified, extracts all variants. Files left out by
+ * the filters are never loaded into memory. With --update, an earlier
+ * extraction is brought up to date by writing only what changed.
  */
 class ExtractCommand : public Command {
 public:
@@ -19,6 +22,7 @@ public:
     }
     std::string usage() const override {
         return "lgx extract <pkg.lgx> [--variant <v>] [--output <dir>]\n"
+               "            [--include <globs>] [--exclude <globs>] [--update] [--durable]\n"
                "\n"
                "Extracts variant contents from a package to a directory.\n"
                "If no variant is specified, all variants are extracted.\n"
@@ -26,6 +30,22 @@ public:
                "Options:\n"
                "  --variant, -v <name>   Variant to extract (extracts all if omitted)\n"
                "  --output, -o <dir>     Output directory (defaults to current directory)\n"
+               "  --include <globs>      Only extract paths matching one of these\n"
+               "                         comma-separated patterns (relative to the variant)\n"
+               "  --exclude <globs>      Skip paths matching any of these patterns\n"
+               "  --update               Update an earlier extraction in place: write only\n"
+               "                         changed files and remove files no longer in the\n"
+               "                         package (state is kept in <output>/.<variant>.lgx-installed)\n"
+               "  --durable              Flush files to disk before they go into place, so\n"
+               "                         a crash leaves the old tree or the new one. Without\n"
+               "                         --update each variant is written beside its\n"
+               "                         directory and swapped in whole, replacing it\n"
+               "\n"
+               "Patterns:\n"
+               "  *, ? and [a-z] match within a path component, ** across components.\n"
+               "  A pattern without '/' matches a file or directory name at any depth;\n"
+               "  one with '/' matches from the variant root. A matching directory\n"
+               "  includes everything under it.\n"
                "\n"
                "Output Structure:\n"
                "  <output>/<variant-name>/   Contents of each variant\n"
@@ -34,7 +54,9 @@ public:
                "  lgx extract mymodule.lgx\n"
                "  lgx extract mymodule.lgx --variant linux-amd64\n"
                "  lgx extract mymodule.lgx -v web -o ./extracted\n"
-               "  lgx extract mymodule.lgx --output /tmp/pkg";
+               "  lgx extract mymodule.lgx -v linux-amd64 --include 'lib/*.so' --exclude '*.debug'\n"
+               "  lgx extract mymodule.lgx --output /tmp/pkg\n"
+               "  lgx extract mymodule-1.1.lgx -v linux-amd64 -o /opt/modules --update";
     }
 };
 
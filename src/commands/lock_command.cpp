@@ -0,0 +1,59 @@
+#include "lock_command.h"
+#include "core/lockfile.h"
+#include "crypto/signing.h"
+
+#include <filesystem>
+#include <iostream>
+
+namespace lgx {
+
+int LockCommand::execute(const std::vector<std::string>& args) {
+    std::vector<std::string> positional;
+    auto opts = parseArgs(args, positional);
+
+    if (positional.empty()) {
+        printError("Usage: lgx lock <pkg.lgx>... [--lockfile <file>]");
+        return 1;
+    }
+    if (!crypto::init()) {
+        printError("Failed to initialize crypto library");
+        return 1;
+    }
+
+    std::filesystem::path lockPath = getOption(opts, "lockfile", Lockfile::DEFAULT_FILENAME);
+    std::filesystem::path lockDir = lockPath.parent_path();
+
+    Lockfile lock;
+    if (std::filesystem::exists(lockPath)) {
+        auto existing = Lockfile::load(lockPath);
+        if (!existing) {
+            printError(Lockfile::getLastError());
+            return 1;
+        }
+        lock = std::move(*existing);
+    }
+
+    for (const auto& pkgPath : positional) {
+        auto entry = Lockfile::describe(pkgPath, lockDir);
+        if (!entry) {
+            printError(pkgPath + ": " + Lockfile::getLastError());
+            return 1;
+        }
+        std::cout << "  " << entry->name << " " << entry->version;
+        if (!entry->signer.empty()) {
+            std::cout << "  [signer=" << entry->signer << "]";
+        }
+        std::cout << "\n";
+        lock.set(std::move(*entry));
+    }
+
+    if (!lock.save(lockPath)) {
+        printError(Lockfile::getLastError());
+        return 1;
+    }
+    printSuccess("Locked " + std::to_string(positional.size()) + " package(s) in " +
+                 lockPath.string());
+    return 0;
+}
+
+} // namespace lgx
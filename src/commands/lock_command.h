@@ -0,0 +1,41 @@
+#pragma once
+
+#include "command.h"
+
+namespace lgx {
+
+/**
+ * Lock command: lgx lock <pkg.lgx>... [--lockfile <file>]
+ *
+ * Fully verifies packages and pins them in a lockfile, so later installs
+ * can check them with `lgx verify --lock` in a single hash pass.
+ */
+class LockCommand : public Command {
+public:
+    int execute(const std::vector<std::string>& args) override;
+    std::string name() const override { return "lock"; }
+    std::string description() const override {
+        return "Pin verified packages in a lockfile";
+    }
+    std::string usage() const override {
+        return "lgx lock <pkg.lgx>... [--lockfile <file>]\n"
+               "\n"
+               "Verifies each package in full (structure, content hashes and, if\n"
+               "signed, the signature) and records its name, version, Merkle root,\n"
+               "signer DID, file size and file SHA-256 in the lockfile. An existing\n"
+               "entry for the same package name is replaced. Nothing is written if\n"
+               "any package fails verification.\n"
+               "\n"
+               "Check a package against the lock with:\n"
+               "  lgx verify <pkg.lgx> --lock <file>\n"
+               "\n"
+               "Options:\n"
+               "  --lockfile <file>     Lockfile to create or update (default: lgx.lock)\n"
+               "\n"
+               "Examples:\n"
+               "  lgx lock waku_module.lgx chat_ui.lgx\n"
+               "  lgx lock dist/*.lgx --lockfile deploy/lgx.lock";
+    }
+};
+
+} // namespace lgx
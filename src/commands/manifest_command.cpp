@@ -1,5 +1,6 @@
 #include "manifest_command.h"
 #include "core/package.h"
+#include "../server/client.h"
 
 #include <nlohmann/json.hpp>
 
@@ -49,8 +50,7 @@ std::string joinKeys(const std::map<std::string, std::string>& m) {
     return out.str();
 }
 
-void printHumanReadable(const Package& pkg) {
-    const Manifest& m = pkg.getManifest();
+void printHumanReadable(const Manifest& m, const std::optional<std::string>& sigBytes) {
 
     std::cout << "Name:           " << m.name << "\n"
               << "Display name:   "
@@ -95,7 +95,6 @@ void printHumanReadable(const Package& pkg) {
     }
 
     // Signature info (read directly from the package, do not verify)
-    auto sigBytes = findRawSignatureBytes(pkg);
     if (sigBytes.has_value()) {
         try {
             auto j = nlohmann::json::parse(*sigBytes);
@@ -140,16 +139,39 @@ int ManifestCommand::execute(const std::vector<std::string>& args) {
         return 1;
     }
 
-    auto pkg = Package::load(pkgPath);
-    if (!pkg) {
-        printError("Failed to load package: " + Package::getLastError());
-        return 1;
+    std::optional<std::string> rawManifest;
+    std::optional<std::string> rawSignature;
+
+    // Ask a running daemon for the embedded bytes if one is configured
+    if (auto client = server::Client::fromEnvironment()) {
+        auto response = client->request({
+            {"op", "manifest"},
+            {"path", std::filesystem::absolute(pkgPath).string()}
+        });
+        if (response && response->value("ok", false)) {
+            rawManifest = (*response)["manifest"].get<std::string>();
+            if ((*response)["signature"].is_string()) {
+                rawSignature = (*response)["signature"].get<std::string>();
+            }
+        } else if (response) {
+            printError(response->value("error", "Daemon request failed"));
+            return 1;
+        }
     }
 
-    auto rawManifest = findRawManifestBytes(*pkg);
     if (!rawManifest.has_value()) {
-        printError("Package does not contain a manifest.json entry");
-        return 1;
+        auto pkg = Package::load(pkgPath);
+        if (!pkg) {
+            printError("Failed to load package: " + Package::getLastError());
+            return 1;
+        }
+
+        rawManifest = findRawManifestBytes(*pkg);
+        if (!rawManifest.has_value()) {
+            printError("Package does not contain a manifest.json entry");
+            return 1;
+        }
+        rawSignature = findRawSignatureBytes(*pkg);
     }
 
     const bool jsonMode = hasFlag(opts, "json");
@@ -163,7 +185,12 @@ int ManifestCommand::execute(const std::vector<std::string>& args) {
         return 0;
     }
 
-    printHumanReadable(*pkg);
+    auto manifest = Manifest::fromJson(*rawManifest);
+    if (!manifest) {
+        printError("Failed to parse manifest: " + Manifest::getLastError());
+        return 1;
+    }
+    printHumanReadable(*manifest, rawSignature);
     return 0;
 }
 
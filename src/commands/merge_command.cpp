@@ -115,19 +115,8 @@ int MergeCommand::execute(const std::vector<std::string>& args) {
         }
     }
 
-    // Create a fresh output package
-    auto createResult = Package::create(outputPath, refManifest.name);
-    if (!createResult.success) {
-        printError("Failed to create output package: " + createResult.error);
-        return 1;
-    }
-
-    auto mergedOpt = Package::load(outputPath);
-    if (!mergedOpt) {
-        printError("Failed to load created package: " + Package::getLastError());
-        return 1;
-    }
-    Package& merged = *mergedOpt;
+    // Build the output in memory; the file is only written once it is done
+    Package merged = Package::skeleton(refManifest.name);
 
     // Copy metadata from the reference manifest
     Manifest& mergedManifest = merged.getManifest();
@@ -192,6 +181,23 @@ int MergeCommand::execute(const std::vector<std::string>& args) {
         }
     }
 
+    // Variant list for the summary
+    std::string variants;
+    for (const auto& [variant, source] : variantSource) {
+        if (!variants.empty()) variants += ", ";
+        variants += variant;
+    }
+
+    // An existing output with the same content is kept, with its signature
+    // and mtime
+    if (std::filesystem::exists(outputPath)) {
+        auto existing = Package::load(outputPath);
+        if (existing && existing->sameContent(merged)) {
+            printSuccess(outputPath + " is unchanged (" + variants + ")");
+            return 0;
+        }
+    }
+
     // Save the merged package
     auto saveResult = merged.save(outputPath);
     if (!saveResult.success) {
@@ -199,13 +205,6 @@ int MergeCommand::execute(const std::vector<std::string>& args) {
         return 1;
     }
 
-    // Summary
-    std::string variants;
-    for (const auto& [variant, source] : variantSource) {
-        if (!variants.empty()) variants += ", ";
-        variants += variant;
-    }
-
     printSuccess("Merged " + std::to_string(positional.size()) + " packages into " +
                  outputPath + " (" + variants + ")");
     return 0;
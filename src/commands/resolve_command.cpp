@@ -0,0 +1,86 @@
+#include "resolve_command.h"
+#include "core/catalog.h"
+#include "core/package.h"
+#include "core/resolver.h"
+
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <iostream>
+
+namespace lgx {
+
+int ResolveCommand::execute(const std::vector<std::string>& args) {
+    std::vector<std::string> positional;
+    auto opts = parseArgs(args, positional);
+
+    if (positional.empty()) {
+        printError("Usage: lgx resolve <dir> [<name[@range]>...] [--from <pkg.lgx>]");
+        return 1;
+    }
+    std::filesystem::path dir = positional[0];
+    std::string from = getOption(opts, "from");
+    const bool jsonMode = hasFlag(opts, "json");
+
+    std::vector<Dependency> requirements;
+    for (size_t i = 1; i < positional.size(); ++i) {
+        auto dep = Resolver::parseRequirement(positional[i]);
+        if (!dep) {
+            printError("Invalid requirement '" + positional[i] + "': " + Resolver::getLastError());
+            return 1;
+        }
+        requirements.push_back(std::move(*dep));
+    }
+    if (!from.empty()) {
+        auto metadata = Package::readMetadata(from);
+        if (!metadata) {
+            printError("Failed to read package: " + Package::getLastError());
+            return 1;
+        }
+        const auto& deps = metadata->manifest.dependencies;
+        requirements.insert(requirements.end(), deps.begin(), deps.end());
+    }
+    if (requirements.empty()) {
+        printError("Nothing to resolve: give requirements or --from <pkg.lgx>");
+        return 1;
+    }
+
+    auto catalog = Catalog::open(dir, getOption(opts, "index"));
+    if (!catalog) {
+        printError(Catalog::getLastError() + " (run 'lgx catalog update " + dir.string() + "')");
+        return 1;
+    }
+    Resolver resolver;
+    resolver.addCatalog(*catalog);
+
+    auto result = resolver.resolve(requirements);
+    if (!result.success) {
+        printError(result.error);
+        return 1;
+    }
+
+    if (jsonMode) {
+        nlohmann::ordered_json list = nlohmann::ordered_json::array();
+        for (const auto& selection : result.packages) {
+            list.push_back({
+                {"name", selection.name},
+                {"version", selection.version},
+                {"path", selection.source},
+                {"signer", selection.signer.empty() ? nlohmann::ordered_json()
+                                                    : nlohmann::ordered_json(selection.signer)},
+            });
+        }
+        std::cout << list.dump(2) << std::endl;
+        return 0;
+    }
+
+    for (const auto& selection : result.packages) {
+        std::cout << selection.name << " " << selection.version << "  " << selection.source;
+        if (!selection.signer.empty()) {
+            std::cout << "  [signer=" << selection.signer << "]";
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
+
+} // namespace lgx
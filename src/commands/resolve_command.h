@@ -0,0 +1,39 @@
+#pragma once
+
+#include "command.h"
+
+namespace lgx {
+
+/**
+ * Resolve command: lgx resolve <dir> <name[@range]>...
+ *
+ * Picks one version of every package needed to satisfy the requirements
+ * from the packages indexed in a catalog directory.
+ */
+class ResolveCommand : public Command {
+public:
+    int execute(const std::vector<std::string>& args) override;
+    std::string name() const override { return "resolve"; }
+    std::string description() const override {
+        return "Resolve dependencies against a catalog directory";
+    }
+    std::string usage() const override {
+        return "lgx resolve <dir> [<name[@range]>...] [options]\n"
+               "\n"
+               "Chooses the newest version of each required package whose range,\n"
+               "and the ranges and signer pins of everything that depends on it,\n"
+               "are satisfied, backtracking on conflicts. Candidates are the\n"
+               "packages indexed in <dir> (see 'lgx catalog update').\n"
+               "\n"
+               "Options:\n"
+               "  --from <pkg.lgx>      Also require the dependencies of this package\n"
+               "  --index <file>        Index file location\n"
+               "  --json                Print the result as JSON\n"
+               "\n"
+               "Examples:\n"
+               "  lgx resolve ./repo waku_module@^1.2 chat_ui\n"
+               "  lgx resolve ./repo --from my_app.lgx";
+    }
+};
+
+} // namespace lgx
@@ -0,0 +1,105 @@
+#include "serve_command.h"
+#include "../server/client.h"
+#include "../server/server.h"
+
+#include <csignal>
+#include <iostream>
+
+namespace lgx {
+
+namespace {
+
+server::Server* g_server = nullptr;
+
+void handleStopSignal(int) {
+    if (g_server) {
+        g_server->requestStop();
+    }
+}
+
+bool parseCount(const std::string& value, size_t& out) {
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    try {
+        out = static_cast<size_t>(std::stoull(value));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+int ServeCommand::execute(const std::vector<std::string>& args) {
+    std::vector<std::string> positional;
+    auto opts = parseArgs(args, positional);
+
+    std::string socketPath = getOption(opts, "socket", "s");
+    if (socketPath.empty()) {
+        printError("Missing required option: --socket <path>");
+        std::cerr << "\nUsage: " << usage() << std::endl;
+        return 1;
+    }
+
+    if (hasFlag(opts, "stop")) {
+        auto client = server::Client::connect(socketPath);
+        if (!client) {
+            printError(server::Client::getLastError());
+            return 1;
+        }
+        auto response = client->request({{"op", "shutdown"}});
+        if (!response || !response->value("ok", false)) {
+            printError("Daemon did not acknowledge shutdown");
+            return 1;
+        }
+        printSuccess("Daemon stopped: " + socketPath);
+        return 0;
+    }
+
+    server::Server::Options options;
+    options.socketPath = socketPath;
+
+    std::string workers = getOption(opts, "workers", "");
+    if (!workers.empty() && !parseCount(workers, options.workers)) {
+        printError("Invalid --workers value: " + workers);
+        return 1;
+    }
+    std::string cacheMb = getOption(opts, "cache-mb", "");
+    size_t cacheMbValue = 0;
+    if (!cacheMb.empty()) {
+        if (!parseCount(cacheMb, cacheMbValue)) {
+            printError("Invalid --cache-mb value: " + cacheMb);
+            return 1;
+        }
+        options.cacheBudget = cacheMbValue * 1024 * 1024;
+    }
+    std::string idleTimeout = getOption(opts, "idle-timeout", "");
+    if (!idleTimeout.empty() && !parseCount(idleTimeout, options.idleTimeout)) {
+        printError("Invalid --idle-timeout value: " + idleTimeout);
+        return 1;
+    }
+
+    server::Server service(options);
+    if (!service.start()) {
+        printError(server::Server::getLastError());
+        return 1;
+    }
+
+    g_server = &service;
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+#ifdef SIGPIPE
+    std::signal(SIGPIPE, SIG_IGN);  // a client hanging up must not kill the daemon
+#endif
+
+    printInfo("Listening on " + socketPath);
+    service.run();
+
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    g_server = nullptr;
+    return 0;
+}
+
+} // namespace lgx
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "command.h"
+
+namespace lgx {
+
+/**
+ * Serve command: lgx serve --socket <path>
+ *
+ * Runs a long-lived daemon that answers requests over a Unix socket with
+ * warm caches, so tools that invoke lgx repeatedly skip process start-up
+ * and package decoding.
+ */
+class ServeCommand : public Command {
+public:
+    int execute(const std::vector<std::string>& args) override;
+    std::string name() const override { return "serve"; }
+    std::string description() const override {
+        return "Run a daemon that serves requests over a Unix socket";
+    }
+    std::string usage() const override {
+        return "lgx serve --socket <path> [--workers <n>] [--cache-mb <n>] [--idle-timeout <s>]\n"
+               "lgx serve --socket <path> --stop\n"
+               "\n"
+               "Runs a local daemon that answers verify, manifest, extract, sign and\n"
+               "entry-listing requests (newline-delimited JSON) on a Unix socket.\n"
+               "Decoded packages, verification results and keyring indexes stay\n"
+               "cached between requests and are refreshed when the files change.\n"
+               "\n"
+               "Options:\n"
+               "  --socket, -s <path>  Socket to listen on (created with mode 0600)\n"
+               "  --workers <n>        Worker threads (default: one per CPU, 2-8)\n"
+               "  --cache-mb <n>       Decoded-package cache budget in MiB (default: 256)\n"
+               "  --idle-timeout <s>   Close connections idle for <s> seconds (default: 60,\n"
+               "                       0 = never)\n"
+               "  --stop               Ask the daemon on <path> to shut down\n"
+               "\n"
+               "Client mode:\n"
+               "  With LGX_DAEMON_SOCKET=<path> set, 'lgx verify', 'manifest', 'extract'\n"
+               "  and 'sign' forward to the daemon, and run locally when none is listening.\n"
+               "\n"
+               "Examples:\n"
+               "  lgx serve --socket /run/user/1000/lgx.sock &\n"
+               "  LGX_DAEMON_SOCKET=/run/user/1000/lgx.sock lgx verify mymodule.lgx";
+    }
+};
+
+} // namespace lgx
@@ -2,6 +2,7 @@
 #include "../core/package.h"
 #include "../crypto/signing.h"
 #include "../crypto/keyring.h"
+#include "../server/client.h"
 
 #include <iostream>
 
@@ -33,12 +34,6 @@ int SignCommand::execute(const std::vector<std::string>& args) {
         return 1;
     }
 
-    if (!crypto::init()) {
-        printError("Failed to initialize crypto library");
-        return 1;
-    }
-
-    // Load secret key
     std::string keysDirOpt = getOption(opts, "keys-dir", "d");
     std::filesystem::path keysDir;
     if (!keysDirOpt.empty()) {
@@ -51,6 +46,35 @@ int SignCommand::execute(const std::vector<std::string>& args) {
         return 1;
     }
 
+    // Forward to a running daemon if one is configured. The keys directory
+    // is always sent, so the daemon's own HOME never picks the key.
+    if (auto client = server::Client::fromEnvironment()) {
+        nlohmann::json request = {
+            {"op", "sign"},
+            {"path", std::filesystem::absolute(pkgPath).string()},
+            {"key", keyName},
+            {"keys_dir", std::filesystem::absolute(keysDir).string()},
+            {"name", signerName},
+            {"url", signerUrl}
+        };
+        auto response = client->request(request);
+        if (response) {
+            if (!response->value("ok", false)) {
+                printError(response->value("error", "Daemon request failed"));
+                return 1;
+            }
+            printSuccess("Package signed: " + pkgPath);
+            printInfo("Signer DID: " + response->value("did", ""));
+            return 0;
+        }
+    }
+
+    if (!crypto::init()) {
+        printError("Failed to initialize crypto library");
+        return 1;
+    }
+
+    // Load secret key
     auto sk = crypto::Keyring::loadSecretKey(keysDir, keyName);
     if (!sk) {
         printError("Failed to load secret key '" + keyName + "': " +
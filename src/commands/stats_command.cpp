@@ -0,0 +1,62 @@
+#include "stats_command.h"
+#include "core/composition.h"
+
+#include <filesystem>
+#include <iostream>
+
+namespace lgx {
+
+namespace {
+
+bool parseCount(const std::string& value, size_t& out) {
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    try {
+        out = static_cast<size_t>(std::stoull(value));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+int StatsCommand::execute(const std::vector<std::string>& args) {
+    std::vector<std::string> positional;
+    auto opts = parseArgs(args, positional);
+
+    if (positional.empty()) {
+        printError("Missing package path");
+        std::cerr << "\nUsage: " << usage() << std::endl;
+        return 1;
+    }
+    const std::string& pkgPath = positional[0];
+    if (!std::filesystem::exists(pkgPath)) {
+        printError("Package not found: " + pkgPath);
+        return 1;
+    }
+
+    Composition::Options options;
+    options.probe = hasFlag(opts, "probe");
+    std::string top = getOption(opts, "top");
+    if (!top.empty() && !parseCount(top, options.top)) {
+        printError("Invalid --top value: " + top);
+        return 1;
+    }
+
+    auto report = Composition::analyze(pkgPath, options);
+    if (!report) {
+        printError("Failed to read package: " + Composition::getLastError());
+        return 1;
+    }
+
+    if (hasFlag(opts, "json")) {
+        std::cout << Composition::toJson(*report) << std::endl;
+    } else {
+        std::cout << Composition::toText(*report);
+    }
+    return 0;
+}
+
+} // namespace lgx
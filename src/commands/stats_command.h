@@ -0,0 +1,42 @@
+#pragma once
+
+#include "command.h"
+
+namespace lgx {
+
+/**
+ * Stats command: lgx stats <pkg.lgx> [--probe] [--top <n>] [--json]
+ *
+ * Reports what a package is made of, to find what makes it large.
+ */
+class StatsCommand : public Command {
+public:
+    int execute(const std::vector<std::string>& args) override;
+    std::string name() const override { return "stats"; }
+    std::string description() const override {
+        return "Show what a package is made of";
+    }
+    std::string usage() const override {
+        return "lgx stats <pkg.lgx> [--probe] [--top <n>] [--json]\n"
+               "\n"
+               "Reports files and bytes per root and per variant, a file size\n"
+               "histogram, the largest files and the longest and deepest paths.\n"
+               "Only tar headers are read; compressed sizes are estimated by sharing\n"
+               "out the .lgx size in proportion to uncompressed bytes.\n"
+               "\n"
+               "With --probe each file is also deflated on its own and hashed, which\n"
+               "gives per-file compressed sizes, the files deflate cannot shrink, and\n"
+               "payloads repeated across variants.\n"
+               "\n"
+               "Options:\n"
+               "  --probe       Deflate and hash each file\n"
+               "  --top <n>     Length of the file lists (default: 10)\n"
+               "  --json        Print the report as JSON\n"
+               "\n"
+               "Examples:\n"
+               "  lgx stats mymodule.lgx\n"
+               "  lgx stats mymodule.lgx --probe --json > stats.json";
+    }
+};
+
+} // namespace lgx
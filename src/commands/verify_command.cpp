@@ -1,13 +1,100 @@
 #include "verify_command.h"
+#include "core/lockfile.h"
 #include "core/package.h"
 #include "../crypto/signing.h"
 #include "../crypto/keyring.h"
+#include "../server/client.h"
 
 #include <filesystem>
 #include <iostream>
 
 namespace lgx {
 
+namespace {
+
+/**
+ * Everything `lgx verify` prints, gathered either locally or from a daemon.
+ */
+struct VerifyReport {
+    Package::VerifyResult structure;
+    Package::SignatureInfo signature{};
+    bool keyringChecked = false;     // a keyring directory existed to look in
+};
+
+std::filesystem::path keyringDirectory(const std::string& option) {
+    if (!option.empty()) {
+        return option;
+    }
+    return crypto::Keyring::defaultDirectory();
+}
+
+std::optional<Package::VerifyLevel> parseLevel(const std::string& level) {
+    if (level == "structure") return Package::VerifyLevel::Structure;
+    if (level == "hashes") return Package::VerifyLevel::Hashes;
+    if (level == "full") return Package::VerifyLevel::Full;
+    return std::nullopt;
+}
+
+VerifyReport verifyLocally(const std::string& pkgPath, const std::string& keyringDirOpt,
+                           Package::VerifyLevel level) {
+    VerifyReport report;
+
+    // One load for every level; the signature check reuses the validated
+    // package instead of loading and hashing it again
+    report.structure = Package::verify(pkgPath, level, &report.signature);
+    if (!report.structure.valid || level != Package::VerifyLevel::Full) {
+        return report;
+    }
+
+    if (!report.signature.is_signed || !report.signature.signature_valid ||
+        !report.signature.package_valid) {
+        return report;
+    }
+
+    // Check keyring
+    std::filesystem::path keyringDir = keyringDirectory(keyringDirOpt);
+    if (!keyringDir.empty() && std::filesystem::exists(keyringDir)) {
+        report.keyringChecked = true;
+        crypto::Keyring keyring(keyringDir);
+        auto trusted = keyring.findByDid(report.signature.signer_did);
+        if (trusted) {
+            report.signature.trusted_as = trusted->name;
+        }
+    }
+    return report;
+}
+
+std::optional<VerifyReport> verifyRemotely(server::Client& client,
+                                           const std::string& pkgPath,
+                                           const std::string& keyringDirOpt) {
+    // Always name the keyring this process would use: the daemon's own
+    // default comes from its environment, which may differ from ours
+    std::filesystem::path keyringDir = keyringDirectory(keyringDirOpt);
+    if (keyringDir.empty()) {
+        return std::nullopt;  // no keyring to name; verify locally
+    }
+    nlohmann::json request = {
+        {"op", "verify"},
+        {"path", std::filesystem::absolute(pkgPath).string()},
+        {"keyring_dir", std::filesystem::absolute(keyringDir).string()}
+    };
+
+    auto response = client.request(request);
+    if (!response || !response->value("ok", false) || !response->contains("structure")) {
+        return std::nullopt;
+    }
+
+    VerifyReport report;
+    report.structure = server::verifyResultFromJson((*response)["structure"]);
+    if (response->contains("signature")) {
+        report.signature = server::signatureInfoFromJson((*response)["signature"]);
+        report.keyringChecked = response->value("keyring_checked", false);
+    }
+    return report;
+}
+
+} // anonymous namespace
+
 int VerifyCommand::execute(const std::vector<std::string>& args) {
     std::vector<std::string> positional;
     auto opts = parseArgs(args, positional);
@@ -27,40 +114,82 @@ int VerifyCommand::execute(const std::vector<std::string>& args) {
         return 1;
     }
 
-    // Structural verification
-    auto result = Package::verify(pkgPath);
+    std::string keyringDirOpt = getOption(opts, "keyring-dir", "");
+    std::string levelName = getOption(opts, "level", "", "full");
+    auto level = parseLevel(levelName);
+    if (!level) {
+        printError("Unknown verification level: " + levelName + " (expected structure, hashes or full)");
+        return 1;
+    }
+
+    // A locked package only needs its bytes compared with the lock entry
+    std::string lockPath = getOption(opts, "lock", "");
+    if (!lockPath.empty()) {
+        auto lock = Lockfile::load(lockPath);
+        if (!lock) {
+            printError(Lockfile::getLastError());
+            return 1;
+        }
+        auto check = lock->check(pkgPath, std::filesystem::path(lockPath).parent_path());
+        switch (check.status) {
+            case Lockfile::Status::Match:
+                printSuccess("Package matches lock entry: " + check.entry->name + " " +
+                             check.entry->version);
+                printInfo("Root hash: " + check.entry->rootHash);
+                if (!check.entry->signer.empty()) {
+                    printInfo("Signer DID: " + check.entry->signer);
+                }
+                return 0;
+            case Lockfile::Status::Mismatch:
+                printError("Package does not match lock entry for '" + check.entry->name +
+                           "': " + check.error);
+                return 1;
+            case Lockfile::Status::Error:
+                printError(check.error);
+                return 1;
+            case Lockfile::Status::NotLocked:
+                printInfo("No lock entry for this package; running full verification");
+                break;
+        }
+    }
+
+    // Forward to a running daemon if one is configured; fall back to local
+    // verification if it cannot answer. The daemon always verifies in full,
+    // so lower levels run locally.
+    std::optional<VerifyReport> remote;
+    if (*level == Package::VerifyLevel::Full) {
+        if (auto client = server::Client::fromEnvironment()) {
+            remote = verifyRemotely(*client, pkgPath, keyringDirOpt);
+        }
+    }
+    VerifyReport report = remote ? std::move(*remote) : verifyLocally(pkgPath, keyringDirOpt, *level);
 
     // Print structural warnings
-    if (!result.warnings.empty()) {
-        for (const auto& warning : result.warnings) {
+    if (!report.structure.warnings.empty()) {
+        for (const auto& warning : report.structure.warnings) {
             std::cout << "Warning: " << warning << std::endl;
         }
     }
 
-    if (!result.valid) {
+    if (!report.structure.valid) {
         printError("Package validation failed:");
-        for (const auto& error : result.errors) {
+        for (const auto& error : report.structure.errors) {
             std::cerr << "  - " << error << std::endl;
         }
         return 1;
     }
 
     printSuccess("Package structure is valid: " + pkgPath);
-
-    // Signature verification
-    if (!crypto::init()) {
-        printError("Failed to initialize crypto library");
-        return 1;
+    if (*level == Package::VerifyLevel::Structure) {
+        printInfo("Content hashes and signature not checked (--level structure)");
+        return 0;
     }
-
-    auto pkg = Package::load(pkgPath);
-    if (!pkg) {
-        printError("Failed to load package for signature verification");
-        return 1;
+    if (*level == Package::VerifyLevel::Hashes) {
+        printInfo("Content hashes match; signature not checked (--level hashes)");
+        return 0;
     }
 
-    auto sigInfo = pkg->verifySignature();
-
+    const auto& sigInfo = report.signature;
     if (!sigInfo.is_signed) {
         printInfo("Package is unsigned");
         return 0;
@@ -86,19 +215,9 @@ int VerifyCommand::execute(const std::vector<std::string>& args) {
         printInfo("Signer URL (self-asserted): " + sigInfo.signer_url);
     }
 
-    // Check keyring
-    std::string keyringDirOpt = getOption(opts, "keyring-dir", "");
-    std::filesystem::path keyringDir;
-    if (!keyringDirOpt.empty()) {
-        keyringDir = keyringDirOpt;
-    } else {
-        keyringDir = crypto::Keyring::defaultDirectory();
-    }
-    if (!keyringDir.empty() && std::filesystem::exists(keyringDir)) {
-        crypto::Keyring keyring(keyringDir);
-        auto trusted = keyring.findByDid(sigInfo.signer_did);
-        if (trusted) {
-            printSuccess("Signer is trusted: " + trusted->name);
+    if (report.keyringChecked) {
+        if (!sigInfo.trusted_as.empty()) {
+            printSuccess("Signer is trusted: " + sigInfo.trusted_as);
         } else {
             printInfo("Signer DID is NOT in trusted keyring");
         }
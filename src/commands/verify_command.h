@@ -5,10 +5,11 @@
 namespace lgx {
 
 /**
- * Verify command: lgx verify <pkg.lgx>
+ * Verify command: lgx verify <pkg.lgx> [--level structure|hashes|full]
  *
  * Validates a package against the LGX specification and
- * verifies cryptographic signatures if present.
+ * verifies cryptographic signatures if present. Lower levels stop
+ * after the structure or the content hashes.
  */
 class VerifyCommand : public Command {
 public:
@@ -18,7 +19,8 @@ public:
         return "Verify a package is valid";
     }
     std::string usage() const override {
-        return "lgx verify <pkg.lgx> [--keyring-dir <dir>]\n"
+        return "lgx verify <pkg.lgx> [--level structure|hashes|full] [--keyring-dir <dir>]\n"
+               "           [--lock <file>]\n"
                "\n"
                "Validates a package against the LGX specification:\n"
                "  - tar.gz readable\n"
@@ -35,13 +37,25 @@ public:
                "  - Signer key against trusted keyring\n"
                "\n"
                "Options:\n"
+               "  --level <level>      How much to check (default: full):\n"
+               "                         structure  layout, paths and manifest; file\n"
+               "                                    contents are not hashed or kept\n"
+               "                         hashes     also the content hashes\n"
+               "                         full       also the signature and keyring\n"
+               "                       Each level reads and inflates the file once\n"
                "  --keyring-dir <dir>  Keyring directory for trust lookup (default: ~/.config/logos/trusted-keys/)\n"
+               "  --lock <file>        Check the package against its entry in a lockfile\n"
+               "                       (see 'lgx lock'): one hash pass over the file, no\n"
+               "                       Merkle, signature or keyring checks. Any difference\n"
+               "                       fails; packages without an entry are verified in full\n"
                "\n"
                "Returns 0 on success, non-zero on validation failure.\n"
                "\n"
                "Examples:\n"
                "  lgx verify mymodule.lgx\n"
-               "  lgx verify mymodule.lgx --keyring-dir /path/to/keyring";
+               "  lgx verify mymodule.lgx --keyring-dir /path/to/keyring\n"
+               "  lgx verify mymodule.lgx --level structure\n"
+               "  lgx verify mymodule.lgx --lock lgx.lock";
     }
 };
 
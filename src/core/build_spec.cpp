@@ -0,0 +1,211 @@
+#include "build_spec.h"
+#include "path_normalizer.h"
+#include "trace.h"
+
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+using json = nlohmann::json;
+
+namespace lgx {
+
+thread_local std::string BuildSpec::lastError_;
+
+namespace {
+
+// manifest.json keys a spec may set
+const std::set<std::string> METADATA_KEYS = {
+    "manifestVersion", "name", "version", "description", "author", "type",
+    "category", "icon", "dependencies", "display_name", "view"
+};
+
+// Keys that describe the build rather than the manifest
+const std::set<std::string> BUILD_KEYS = {"variants", "docs", "licenses", "output"};
+
+std::filesystem::path resolvePath(const std::filesystem::path& baseDir, const std::string& path) {
+    std::filesystem::path p(path);
+    return p.is_absolute() || baseDir.empty() ? p : baseDir / p;
+}
+
+// "docs": "README.md" or ["README.md", "docs/"]
+bool parsePathList(const json& j, const std::string& key, const std::filesystem::path& baseDir,
+                   std::vector<std::filesystem::path>& out, std::string& error) {
+    if (!j.contains(key)) {
+        return true;
+    }
+    const json& value = j[key];
+    if (value.is_string()) {
+        out.push_back(resolvePath(baseDir, value.get<std::string>()));
+        return true;
+    }
+    if (!value.is_array()) {
+        error = "'" + key + "' must be a path or a list of paths";
+        return false;
+    }
+    for (const auto& item : value) {
+        if (!item.is_string() || item.get<std::string>().empty()) {
+            error = "'" + key + "' must be a path or a list of paths";
+            return false;
+        }
+        out.push_back(resolvePath(baseDir, item.get<std::string>()));
+    }
+    return true;
+}
+
+} // namespace
+
+std::optional<BuildSpec> BuildSpec::load(const std::filesystem::path& specPath) {
+    std::ifstream file(specPath);
+    if (!file) {
+        lastError_ = "Cannot open build spec: " + specPath.string();
+        return std::nullopt;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    auto spec = parse(buffer.str(), specPath.parent_path());
+    if (!spec) {
+        lastError_ = specPath.string() + ": " + lastError_;
+    }
+    return spec;
+}
+
+std::optional<BuildSpec> BuildSpec::parse(const std::string& text,
+                                          const std::filesystem::path& baseDir) {
+    json j = json::parse(text, nullptr, false);
+    if (j.is_discarded() || !j.is_object()) {
+        lastError_ = "Build spec is not a JSON object";
+        return std::nullopt;
+    }
+    for (const auto& [key, value] : j.items()) {
+        if (!METADATA_KEYS.count(key) && !BUILD_KEYS.count(key)) {
+            lastError_ = "Unknown key '" + key + "'";
+            return std::nullopt;
+        }
+    }
+    if (!j.contains("name") || !j["name"].is_string() || j["name"].get<std::string>().empty()) {
+        lastError_ = "Missing or invalid 'name' field";
+        return std::nullopt;
+    }
+
+    // Metadata goes through the manifest parser, with the defaults of `lgx create`
+    json metadata = {
+        {"manifestVersion", Manifest::CURRENT_VERSION},
+        {"version", "0.0.1"},
+        {"description", ""},
+        {"author", ""},
+        {"type", ""},
+        {"category", ""},
+        {"icon", ""},
+        {"dependencies", json::array()},
+    };
+    for (const auto& key : METADATA_KEYS) {
+        if (j.contains(key)) {
+            metadata[key] = j[key];
+        }
+    }
+    auto manifest = Manifest::fromJson(metadata.dump());
+    if (!manifest) {
+        lastError_ = Manifest::getLastError();
+        return std::nullopt;
+    }
+
+    BuildSpec spec;
+    spec.manifest = std::move(*manifest);
+    spec.manifest.name = PathNormalizer::toLowercase(spec.manifest.name);
+
+    if (!spec.manifest.view.empty()) {
+        auto viewValidation = PathNormalizer::validateArchivePath(spec.manifest.view);
+        if (!viewValidation.valid) {
+            lastError_ = "Invalid view path: " + viewValidation.error;
+            return std::nullopt;
+        }
+    }
+
+    if (j.contains("variants")) {
+        if (!j["variants"].is_object()) {
+            lastError_ = "'variants' must be an object of variant name to files";
+            return std::nullopt;
+        }
+        std::set<std::string> seen;
+        for (const auto& [name, value] : j["variants"].items()) {
+            Package::VariantInput variant;
+            variant.variant = PathNormalizer::toLowercase(name);
+            if (variant.variant.empty() || !seen.insert(variant.variant).second) {
+                lastError_ = "Empty or duplicate variant name '" + name + "'";
+                return std::nullopt;
+            }
+            if (value.is_string()) {
+                variant.filesPath = resolvePath(baseDir, value.get<std::string>());
+            } else if (value.is_object() && value.contains("files") && value["files"].is_string()) {
+                variant.filesPath = resolvePath(baseDir, value["files"].get<std::string>());
+                if (value.contains("main")) {
+                    if (!value["main"].is_string()) {
+                        lastError_ = "Variant '" + name + "' has non-string 'main'";
+                        return std::nullopt;
+                    }
+                    variant.mainPath = value["main"].get<std::string>();
+                }
+            } else {
+                lastError_ = "Variant '" + name + "' must be a path or {\"files\", \"main\"}";
+                return std::nullopt;
+            }
+            spec.inputs.variants.push_back(std::move(variant));
+        }
+    }
+
+    std::string error;
+    if (!parsePathList(j, "docs", baseDir, spec.inputs.docs, error) ||
+        !parsePathList(j, "licenses", baseDir, spec.inputs.licenses, error)) {
+        lastError_ = error;
+        return std::nullopt;
+    }
+
+    if (j.contains("output")) {
+        if (!j["output"].is_string() || j["output"].get<std::string>().empty()) {
+            lastError_ = "'output' must be a path";
+            return std::nullopt;
+        }
+        spec.output = resolvePath(baseDir, j["output"].get<std::string>());
+    }
+    return spec;
+}
+
+std::filesystem::path BuildSpec::outputPath() const {
+    return output.empty() ? std::filesystem::path(manifest.name + ".lgx") : output;
+}
+
+std::optional<Package> BuildSpec::basePackage() const {
+    if (manifest.type == "ui_qml" && manifest.view.empty()) {
+        lastError_ = "ui_qml package is missing required 'view' field";
+        return std::nullopt;
+    }
+
+    Package pkg;
+    pkg.getManifest() = manifest;
+    pkg.getManifest().main.clear();
+    pkg.getManifest().hashes.clear();
+    return pkg;
+}
+
+Package::Result BuildSpec::build(const std::filesystem::path& outputPath) const {
+    Trace::Span span("build_spec.build", outputPath.string());
+
+    auto pkg = basePackage();
+    if (!pkg) {
+        return Package::Result::fail(lastError_);
+    }
+    auto result = pkg->addInputs(inputs);
+    if (!result.success) {
+        return result;
+    }
+    return pkg->save(outputPath);
+}
+
+std::string BuildSpec::getLastError() {
+    return lastError_;
+}
+
+} // namespace lgx
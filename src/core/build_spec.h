@@ -0,0 +1,93 @@
+#pragma once
+
+#include "manifest.h"
+#include "package.h"
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace lgx {
+
+/**
+ * BuildSpec declares a whole package in one JSON file: its metadata,
+ * variants, docs and licenses.
+ *
+ *   {
+ *     "name": "waku_module",
+ *     "version": "1.2.0",
+ *     "type": "core",
+ *     "dependencies": ["logos_core"],
+ *     "variants": {
+ *       "linux-amd64": { "files": "build/linux-amd64", "main": "waku.so" },
+ *       "darwin-arm64": "build/darwin-arm64/waku.dylib"
+ *     },
+ *     "docs": ["README.md"],
+ *     "licenses": ["LICENSE"],
+ *     "output": "dist/waku_module.lgx"
+ *   }
+ *
+ * Metadata keys are those of manifest.json; "main" and "hashes" are derived
+ * from the inputs. A variant is either {"files", "main"?} or just the files
+ * path. Relative paths are resolved against the spec's directory.
+ *
+ * build() reads every input in parallel and writes the package once. The
+ * result is byte-identical to `lgx create` followed by one `lgx add` per
+ * variant, without re-reading, re-hashing and re-compressing the growing
+ * package after each variant.
+ */
+class BuildSpec {
+public:
+    Manifest manifest;              // metadata; main and hashes are set by build()
+    Package::Inputs inputs;         // variants (by name), docs and licenses
+    std::filesystem::path output;   // from "output", empty if not given
+
+    /**
+     * Load a spec file.
+     *
+     * @return BuildSpec, or nullopt if it cannot be read or is invalid
+     */
+    static std::optional<BuildSpec> load(const std::filesystem::path& specPath);
+
+    /**
+     * Parse a spec from JSON text.
+     *
+     * @param json Spec contents
+     * @param baseDir Directory relative paths are resolved against
+     * @return BuildSpec, or nullopt if it is invalid (see getLastError())
+     */
+    static std::optional<BuildSpec> parse(const std::string& json,
+                                          const std::filesystem::path& baseDir);
+
+    /**
+     * Default output path: `output` if set, else <name>.lgx in the current
+     * directory, as `lgx create` names it.
+     */
+    std::filesystem::path outputPath() const;
+
+    /**
+     * The package build() adds the inputs to: the spec's metadata and no
+     * files.
+     *
+     * @return Package, or nullopt if the metadata is incomplete (see
+     *         getLastError())
+     */
+    std::optional<Package> basePackage() const;
+
+    /**
+     * Build the package and write it to outputPath.
+     *
+     * @return Result indicating success or failure
+     */
+    Package::Result build(const std::filesystem::path& outputPath) const;
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    static thread_local std::string lastError_;
+};
+
+} // namespace lgx
@@ -0,0 +1,114 @@
+#include "byte_io.h"
+#include "memory.h"
+#include "stats.h"
+#include "trace.h"
+
+#include <chrono>
+#include <sys/stat.h>
+
+namespace lgx {
+
+FileByteSource::FileByteSource(const std::filesystem::path& path)
+    : lease_(std::make_unique<ScratchLease>()) {
+    Stats::Timer timer(Stats::Phase::FileRead);
+    Trace::Span span("file.read", path.string());
+    timer.addSyscalls();  // open
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return;
+    }
+    timer.addSyscalls(3);  // seek to end, seek back, close
+
+    // Size the buffer up front so large packages are read with a single
+    // allocation instead of growing chunk by chunk.
+    std::streamoff end = file.tellg();
+    if (end < 0) {
+        return;
+    }
+    file.seekg(0, std::ios::beg);
+
+    ScratchBuffer& buffer = lease_->buffer();
+    uint8_t* dest = buffer.append(static_cast<size_t>(end));
+    if (!dest) {
+        return;
+    }
+
+    if (end > 0) {
+        file.read(reinterpret_cast<char*>(dest), static_cast<std::streamsize>(end));
+        timer.addSyscalls();
+        if (file.gcount() != static_cast<std::streamsize>(end)) {
+            buffer.clear();
+            return;
+        }
+        timer.addBytesIn(static_cast<uint64_t>(end));
+    }
+    ok_ = true;
+}
+
+FileByteSource::~FileByteSource() = default;
+
+const uint8_t* FileByteSource::data() const {
+    return lease_->buffer().data();
+}
+
+size_t FileByteSource::size() const {
+    return lease_->buffer().size();
+}
+
+bool FileByteSink::write(const uint8_t* data, size_t size) {
+    Stats::Timer timer(Stats::Phase::FileWrite);
+    if (!file_.is_open()) {
+        timer.addSyscalls();  // open
+        file_.open(path_, std::ios::binary | std::ios::trunc);
+        if (!file_) {
+            openFailed_ = true;
+            return false;
+        }
+    }
+    file_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    // Chunks from the compressor are larger than the stream buffer, so each
+    // write reaches the OS directly
+    timer.addSyscalls();
+    timer.addBytesOut(size);
+    return static_cast<bool>(file_);
+}
+
+bool FileByteSink::finish() {
+    if (!file_.is_open()) {
+        // Nothing was written yet; still create the (empty) file.
+        return write(nullptr, 0);
+    }
+    file_.flush();
+    return static_cast<bool>(file_);
+}
+
+bool FileIdentity::of(const std::filesystem::path& path, FileIdentity& identity) {
+#ifdef _WIN32
+    // No inode or nanosecond mtime here; size + write time still catch edits
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    identity.size = size;
+    identity.mtimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        mtime.time_since_epoch()).count();
+    return true;
+#else
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    identity.device = static_cast<uint64_t>(st.st_dev);
+    identity.inode = static_cast<uint64_t>(st.st_ino);
+    identity.size = static_cast<uint64_t>(st.st_size);
+#ifdef __APPLE__
+    identity.mtimeNs = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    identity.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    return true;
+#endif
+}
+
+} // namespace lgx
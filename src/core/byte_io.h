@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include <filesystem>
+#include <utility>
+#include <memory>
+
+namespace lgx {
+
+class ScratchLease;
+
+/**
+ * ByteSource exposes a complete input (e.g. a compressed .lgx) as one
+ * contiguous, read-only byte range.
+ *
+ * Implementations either borrow caller-owned memory (zero-copy) or own a
+ * buffer they filled themselves (e.g. by reading a file).
+ */
+class ByteSource {
+public:
+    virtual ~ByteSource() = default;
+
+    /**
+     * Pointer to the first byte (may be nullptr when size() == 0).
+     */
+    virtual const uint8_t* data() const = 0;
+
+    /**
+     * Number of bytes available.
+     */
+    virtual size_t size() const = 0;
+};
+
+/**
+ * ByteSource over caller-owned memory. No copy is made; the memory must stay
+ * valid for as long as the source is in use.
+ */
+class MemoryByteSource : public ByteSource {
+public:
+    MemoryByteSource(const void* data, size_t size)
+        : data_(static_cast<const uint8_t*>(data)), size_(size) {}
+    explicit MemoryByteSource(const std::vector<uint8_t>& buffer)
+        : data_(buffer.data()), size_(buffer.size()) {}
+
+    const uint8_t* data() const override { return data_; }
+    size_t size() const override { return size_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+/**
+ * ByteSource that reads a whole file into a buffer.
+ *
+ * The buffer is one of the calling thread's scratch buffers (see
+ * ScratchBuffer), so the source must be destroyed on the thread that
+ * created it.
+ */
+class FileByteSource : public ByteSource {
+public:
+    explicit FileByteSource(const std::filesystem::path& path);
+    ~FileByteSource() override;
+
+    /**
+     * True if the file was opened and read completely.
+     */
+    bool isOpen() const { return ok_; }
+
+    const uint8_t* data() const override;
+    size_t size() const override;
+
+private:
+    std::unique_ptr<ScratchLease> lease_;
+    bool ok_ = false;
+};
+
+/**
+ * Identity of a file on disk: device, inode, size and modification time
+ * (nanoseconds). If two reads of a path give equal identities, the file was
+ * neither replaced nor rewritten in between (up to mtime resolution).
+ */
+struct FileIdentity {
+    uint64_t device = 0;
+    uint64_t inode = 0;
+    uint64_t size = 0;
+    int64_t mtimeNs = 0;
+
+    /**
+     * Stat a file (following symlinks).
+     *
+     * @return false if the file cannot be stat'ed
+     */
+    static bool of(const std::filesystem::path& path, FileIdentity& identity);
+
+    bool operator==(const FileIdentity& other) const {
+        return device == other.device && inode == other.inode &&
+               size == other.size && mtimeNs == other.mtimeNs;
+    }
+    bool operator!=(const FileIdentity& other) const { return !(*this == other); }
+};
+
+/**
+ * ByteSink receives output bytes in order, in one or more chunks.
+ */
+class ByteSink {
+public:
+    virtual ~ByteSink() = default;
+
+    /**
+     * Append a chunk. Returns false to abort the write.
+     */
+    virtual bool write(const uint8_t* data, size_t size) = 0;
+
+    /**
+     * Hint that about `size` more bytes are about to be written, so the sink
+     * can pre-allocate. Optional; the default ignores it.
+     */
+    virtual void sizeHint(size_t size) { (void)size; }
+
+    /**
+     * Called once after the final chunk. Returns false if the written data
+     * could not be committed (e.g. a failed flush).
+     */
+    virtual bool finish() { return true; }
+};
+
+/**
+ * ByteSink that appends to a caller-owned vector.
+ */
+class VectorByteSink : public ByteSink {
+public:
+    explicit VectorByteSink(std::vector<uint8_t>& out) : out_(out) {}
+
+    bool write(const uint8_t* data, size_t size) override {
+        out_.insert(out_.end(), data, data + size);
+        return true;
+    }
+
+    void sizeHint(size_t size) override {
+        out_.reserve(out_.size() + size);
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+};
+
+/**
+ * ByteSink that forwards each chunk to a callback.
+ */
+class CallbackByteSink : public ByteSink {
+public:
+    explicit CallbackByteSink(std::function<bool(const uint8_t* data, size_t size)> callback)
+        : callback_(std::move(callback)) {}
+
+    bool write(const uint8_t* data, size_t size) override {
+        return callback_(data, size);
+    }
+
+private:
+    std::function<bool(const uint8_t* data, size_t size)> callback_;
+};
+
+/**
+ * ByteSink that writes to a file, truncating any existing content.
+ *
+ * The file is opened on the first write, so an operation that fails before
+ * producing output leaves an existing file untouched.
+ */
+class FileByteSink : public ByteSink {
+public:
+    explicit FileByteSink(std::filesystem::path path) : path_(std::move(path)) {}
+
+    /**
+     * True if a write failed because the file could not be opened.
+     */
+    bool openFailed() const { return openFailed_; }
+
+    bool write(const uint8_t* data, size_t size) override;
+    bool finish() override;
+
+private:
+    std::filesystem::path path_;
+    std::ofstream file_;
+    bool openFailed_ = false;
+};
+
+} // namespace lgx
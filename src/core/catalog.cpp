@@ -0,0 +1,428 @@
+#include "catalog.h"
+#include "package.h"
+#include "path_normalizer.h"
+#include "semver.h"
+#include "trace.h"
+#include "worker_pool.h"
+#include "../crypto/signing.h"
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+using json = nlohmann::json;
+
+namespace lgx {
+
+thread_local std::string Catalog::lastError_;
+
+namespace {
+
+constexpr const char* FORMAT_NAME = "lgx-catalog";
+
+// Packages are read in parallel; inflating the first blocks of each file is
+// the main cost, so a handful of threads saturates a typical disk
+constexpr size_t MAX_READ_THREADS = 8;
+
+json dependencyToJson(const Dependency& dep) {
+    if (dep.isSimple()) {
+        return dep.name;
+    }
+    json j = {{"name", dep.name}};
+    if (dep.version) j["version"] = *dep.version;
+    if (dep.signer) j["signer"] = *dep.signer;
+    return j;
+}
+
+Dependency dependencyFromJson(const json& j) {
+    if (j.is_string()) {
+        return Dependency(j.get<std::string>());
+    }
+    Dependency dep(j.at("name").get<std::string>());
+    if (j.contains("version")) dep.version = j["version"].get<std::string>();
+    if (j.contains("signer")) dep.signer = j["signer"].get<std::string>();
+    return dep;
+}
+
+json entryToJson(const Catalog::Entry& entry) {
+    json j = {
+        {"path", entry.path},
+        {"dev", entry.identity.device},
+        {"ino", entry.identity.inode},
+        {"size", entry.identity.size},
+        {"mtime", entry.identity.mtimeNs},
+    };
+    if (!entry.isValid()) {
+        j["error"] = entry.error;
+        return j;
+    }
+    j["name"] = entry.name;
+    j["version"] = entry.version;
+    if (!entry.type.empty()) j["type"] = entry.type;
+    if (!entry.dependencies.empty()) {
+        json deps = json::array();
+        for (const auto& dep : entry.dependencies) {
+            deps.push_back(dependencyToJson(dep));
+        }
+        j["dependencies"] = std::move(deps);
+    }
+    if (!entry.signer.empty()) j["signer"] = entry.signer;
+    if (!entry.rootHash.empty()) j["root"] = entry.rootHash;
+    return j;
+}
+
+Catalog::Entry entryFromJson(const json& j) {
+    Catalog::Entry entry;
+    entry.path = j.at("path").get<std::string>();
+    entry.identity.device = j.at("dev").get<uint64_t>();
+    entry.identity.inode = j.at("ino").get<uint64_t>();
+    entry.identity.size = j.at("size").get<uint64_t>();
+    entry.identity.mtimeNs = j.at("mtime").get<int64_t>();
+    if (j.contains("error")) {
+        entry.error = j["error"].get<std::string>();
+        return entry;
+    }
+    entry.name = j.at("name").get<std::string>();
+    entry.version = j.at("version").get<std::string>();
+    entry.type = j.value("type", "");
+    if (j.contains("dependencies")) {
+        for (const auto& dep : j["dependencies"]) {
+            entry.dependencies.push_back(dependencyFromJson(dep));
+        }
+    }
+    entry.signer = j.value("signer", "");
+    entry.rootHash = j.value("root", "");
+    return entry;
+}
+
+} // namespace
+
+std::filesystem::path Catalog::defaultIndexPath(const std::filesystem::path& directory) {
+    return directory / INDEX_FILENAME;
+}
+
+std::filesystem::path Catalog::packagePath(const Entry& entry) const {
+    return directory_ / std::filesystem::path(entry.path);
+}
+
+Catalog::UpdateResult Catalog::update(
+    const std::filesystem::path& directory,
+    const std::filesystem::path& indexPath,
+    bool rebuild
+) {
+    Trace::Span span("catalog.update", directory.string());
+    UpdateResult result;
+    namespace fs = std::filesystem;
+
+    std::error_code ec;
+    if (!fs::is_directory(directory, ec)) {
+        result.error = "Not a directory: " + directory.string();
+        return result;
+    }
+    fs::path index = indexPath.empty() ? defaultIndexPath(directory) : indexPath;
+
+    // Previous records by path; an unreadable index is simply rebuilt
+    std::unordered_map<std::string, Entry> previous;
+    if (!rebuild) {
+        if (auto old = readIndex(index)) {
+            for (auto& entry : *old) {
+                std::string path = entry.path;
+                previous.emplace(std::move(path), std::move(entry));
+            }
+        }
+    }
+
+    std::vector<Entry> entries;
+    std::vector<std::pair<fs::path, size_t>> toRead;  // file, slot in entries
+
+    fs::recursive_directory_iterator it(directory, fs::directory_options::skip_permission_denied, ec);
+    if (ec) {
+        result.error = "Cannot scan directory: " + directory.string() + ": " + ec.message();
+        return result;
+    }
+    for (; it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec) break;
+        const auto& file = it->path();
+        if (PathNormalizer::toLowercase(file.extension().string()) != ".lgx" ||
+            !it->is_regular_file(ec)) {
+            continue;
+        }
+        ++result.scanned;
+
+        std::string relPath = file.lexically_relative(directory).generic_string();
+        FileIdentity identity;
+        if (!FileIdentity::of(file, identity)) {
+            Entry entry;
+            entry.path = relPath;
+            entry.error = "Cannot stat file";
+            entries.push_back(std::move(entry));
+            continue;
+        }
+
+        auto old = previous.find(relPath);
+        if (old != previous.end() && old->second.identity == identity) {
+            entries.push_back(std::move(old->second));
+            previous.erase(old);
+            ++result.unchanged;
+            continue;
+        }
+        if (old != previous.end()) {
+            previous.erase(old);
+        }
+
+        Entry pending;
+        pending.path = relPath;
+        pending.identity = identity;
+        entries.push_back(std::move(pending));
+        toRead.emplace_back(file, entries.size() - 1);
+    }
+    if (ec) {
+        result.error = "Cannot scan directory: " + directory.string() + ": " + ec.message();
+        return result;
+    }
+    result.removed = previous.size();
+    result.parsed = toRead.size();
+
+    if (!toRead.empty() && !crypto::init()) {
+        result.error = "Failed to initialize crypto library";
+        return result;
+    }
+
+    std::vector<std::optional<PendingSignature>> pending(toRead.size());
+    auto readOne = [&entries, &toRead, &pending](size_t i) {
+        Entry& slot = entries[toRead[i].second];
+        slot = readEntry(toRead[i].first, slot.path, slot.identity, pending[i]);
+    };
+    size_t threads = std::min({static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())),
+                               MAX_READ_THREADS, toRead.size()});
+    if (threads <= 1) {
+        for (size_t i = 0; i < toRead.size(); ++i) {
+            readOne(i);
+        }
+    } else {
+        // Each task owns its slot; the pool's destructor waits for all of them
+        WorkerPool pool(threads);
+        for (size_t i = 0; i < toRead.size(); ++i) {
+            pool.submit([&readOne, i] { readOne(i); });
+        }
+    }
+
+    // Check the signatures together; a package whose signature fails is
+    // recorded as an error, like one that cannot be read
+    std::vector<std::pair<const Manifest*, const crypto::ManifestSig*>> toVerify;
+    std::vector<size_t> verifyOwner;
+    for (size_t i = 0; i < pending.size(); ++i) {
+        if (pending[i]) {
+            toVerify.emplace_back(&pending[i]->manifest, &pending[i]->signature);
+            verifyOwner.push_back(i);
+        }
+    }
+    auto checks = Package::verifyManifestSignatures(toVerify);
+    for (size_t k = 0; k < checks.size(); ++k) {
+        size_t i = verifyOwner[k];
+        Entry& slot = entries[toRead[i].second];
+        if (checks[k].success) {
+            slot.signer = pending[i]->signature.did;
+            continue;
+        }
+        Entry failed;
+        failed.path = slot.path;
+        failed.identity = slot.identity;
+        failed.error = checks[k].error;
+        slot = std::move(failed);
+    }
+
+    for (const auto& entry : entries) {
+        if (!entry.isValid()) ++result.failed;
+    }
+    std::sort(entries.begin(), entries.end(),
+        [](const Entry& a, const Entry& b) { return a.path < b.path; });
+
+    if (!writeIndex(index, entries)) {
+        result.error = lastError_;
+        return result;
+    }
+    result.success = true;
+    return result;
+}
+
+std::optional<Catalog> Catalog::open(
+    const std::filesystem::path& directory,
+    const std::filesystem::path& indexPath
+) {
+    std::filesystem::path index = indexPath.empty() ? defaultIndexPath(directory) : indexPath;
+    auto entries = readIndex(index);
+    if (!entries) {
+        return std::nullopt;
+    }
+
+    Catalog catalog;
+    catalog.directory_ = directory;
+    catalog.entries_ = std::move(*entries);
+    catalog.buildNameIndex();
+    return catalog;
+}
+
+void Catalog::buildNameIndex() {
+    byName_.clear();
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (entries_[i].isValid()) {
+            byName_[PathNormalizer::toLowercase(entries_[i].name)].push_back(i);
+        }
+    }
+}
+
+std::optional<std::vector<const Catalog::Entry*>> Catalog::find(const Query& query) const {
+    std::optional<SemverRange> range;
+    if (!query.versionRange.empty()) {
+        range = SemverRange::parse(query.versionRange);
+        if (!range) {
+            lastError_ = SemverRange::getLastError();
+            return std::nullopt;
+        }
+    }
+
+    // Candidates: one name's records, or everything
+    std::vector<size_t> all;
+    const std::vector<size_t>* candidates = &all;
+    if (!query.name.empty()) {
+        auto it = byName_.find(PathNormalizer::toLowercase(query.name));
+        if (it == byName_.end()) {
+            return std::vector<const Entry*>{};
+        }
+        candidates = &it->second;
+    } else {
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            if (entries_[i].isValid()) all.push_back(i);
+        }
+    }
+
+    std::vector<std::pair<const Entry*, std::optional<SemVersion>>> matches;
+    for (size_t i : *candidates) {
+        const Entry& entry = entries_[i];
+        if (!query.signer.empty() && entry.signer != query.signer) {
+            continue;
+        }
+        auto version = SemVersion::parse(entry.version);
+        if (range && (!version || !range->satisfies(*version))) {
+            continue;
+        }
+        matches.emplace_back(&entry, std::move(version));
+    }
+
+    // Name ascending, newest version first; unparseable versions last
+    std::sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) {
+        if (a.first->name != b.first->name) return a.first->name < b.first->name;
+        if (a.second.has_value() != b.second.has_value()) return a.second.has_value();
+        if (a.second && *a.second != *b.second) return *a.second > *b.second;
+        return a.first->path < b.first->path;
+    });
+
+    std::vector<const Entry*> out;
+    out.reserve(matches.size());
+    for (const auto& match : matches) {
+        out.push_back(match.first);
+    }
+    return out;
+}
+
+std::optional<std::vector<Catalog::Entry>> Catalog::readIndex(const std::filesystem::path& indexPath) {
+    std::ifstream file(indexPath);
+    if (!file) {
+        lastError_ = "Cannot open catalog index: " + indexPath.string();
+        return std::nullopt;
+    }
+
+    std::vector<Entry> entries;
+    std::string line;
+    try {
+        if (!std::getline(file, line)) {
+            lastError_ = "Empty catalog index: " + indexPath.string();
+            return std::nullopt;
+        }
+        json header = json::parse(line);
+        if (header.value("format", "") != FORMAT_NAME ||
+            header.value("version", 0) != FORMAT_VERSION) {
+            lastError_ = "Unsupported catalog index format: " + indexPath.string();
+            return std::nullopt;
+        }
+        while (std::getline(file, line)) {
+            if (line.empty()) continue;
+            entries.push_back(entryFromJson(json::parse(line)));
+        }
+    } catch (const std::exception& e) {
+        lastError_ = "Malformed catalog index " + indexPath.string() + ": " + e.what();
+        return std::nullopt;
+    }
+    return entries;
+}
+
+bool Catalog::writeIndex(const std::filesystem::path& indexPath,
+                         const std::vector<Entry>& entries) {
+    std::filesystem::path tmpPath = indexPath;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::trunc);
+        if (!file) {
+            lastError_ = "Cannot write catalog index: " + tmpPath.string();
+            return false;
+        }
+        json header = {{"format", FORMAT_NAME}, {"version", FORMAT_VERSION},
+                       {"count", entries.size()}};
+        file << header.dump() << '\n';
+        for (const auto& entry : entries) {
+            file << entryToJson(entry).dump() << '\n';
+        }
+        file.close();
+        if (!file) {
+            lastError_ = "Cannot write catalog index: " + tmpPath.string();
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, indexPath, ec);
+    if (ec) {
+        lastError_ = "Cannot replace catalog index " + indexPath.string() + ": " + ec.message();
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+Catalog::Entry Catalog::readEntry(const std::filesystem::path& file, const std::string& relPath,
+                                  const FileIdentity& identity,
+                                  std::optional<PendingSignature>& pending) {
+    Entry entry;
+    entry.path = relPath;
+    entry.identity = identity;
+
+    auto metadata = Package::readMetadata(file);
+    if (!metadata) {
+        entry.error = Package::getLastError();
+        return entry;
+    }
+
+    const Manifest& manifest = metadata->manifest;
+    entry.name = manifest.name;
+    entry.version = manifest.version;
+    entry.type = manifest.type;
+    entry.dependencies = manifest.dependencies;
+    auto root = manifest.hashes.find("root");
+    if (root != manifest.hashes.end()) {
+        entry.rootHash = root->second;
+    }
+    if (metadata->signature) {
+        pending = PendingSignature{std::move(metadata->manifest), std::move(*metadata->signature)};
+    }
+    return entry;
+}
+
+std::string Catalog::getLastError() {
+    return lastError_;
+}
+
+} // namespace lgx
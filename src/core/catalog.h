@@ -0,0 +1,181 @@
+#pragma once
+
+#include "byte_io.h"
+#include "manifest.h"
+#include "../crypto/manifest_sig.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lgx {
+
+/**
+ * Catalog is an on-disk index of the packages in a directory tree: name,
+ * version, dependencies and signer of every .lgx, so that lookups do not
+ * have to open each package.
+ *
+ * The index is a JSON-lines file (one header line, then one line per
+ * package) stored in the directory itself by default. Each record carries
+ * the file's device, inode, size and modification time; update() reparses
+ * only files whose fingerprint changed and reads just the manifest and
+ * signature of each (see Package::readMetadata()).
+ *
+ * The signer of a package is recorded only if manifest.sig verifies over
+ * the manifest. Content hashes are not checked: the catalog says what a
+ * package claims to be, and installing it must still verify it.
+ */
+class Catalog {
+public:
+    /**
+     * File name of the index inside the catalog directory.
+     */
+    static constexpr const char* INDEX_FILENAME = ".lgx-catalog.jsonl";
+
+    /**
+     * Index format version (header line); other versions are rebuilt.
+     */
+    static constexpr int FORMAT_VERSION = 1;
+
+    /**
+     * One indexed package.
+     */
+    struct Entry {
+        std::string path;          // relative to the catalog directory, '/'-separated
+        FileIdentity identity;     // fingerprint when the package was read
+        std::string name;
+        std::string version;
+        std::string type;
+        std::vector<Dependency> dependencies;
+        std::string signer;        // did:jwk:... if manifest.sig verifies, else empty
+        std::string rootHash;      // manifest hashes["root"]
+        std::string error;         // set if the package could not be indexed
+
+        bool isValid() const { return error.empty(); }
+    };
+
+    /**
+     * Lookup criteria; empty fields match everything.
+     */
+    struct Query {
+        std::string name;          // exact package name (case-insensitive)
+        std::string versionRange;  // semver range, e.g. "^1.2"
+        std::string signer;        // did:jwk:... of the signer
+    };
+
+    /**
+     * Outcome of update().
+     */
+    struct UpdateResult {
+        bool success = false;
+        std::string error;
+        size_t scanned = 0;    // .lgx files found
+        size_t parsed = 0;     // files (re)read because they were new or changed
+        size_t unchanged = 0;  // records reused as-is
+        size_t removed = 0;    // records dropped for files that are gone
+        size_t failed = 0;     // files that could not be indexed
+    };
+
+    /**
+     * Default index location for a directory.
+     */
+    static std::filesystem::path defaultIndexPath(const std::filesystem::path& directory);
+
+    /**
+     * Scan directory for .lgx files and bring the index up to date.
+     *
+     * Records of unchanged files are kept; new and changed files are read
+     * in parallel. The index is replaced atomically.
+     *
+     * @param directory Directory to scan (recursively)
+     * @param indexPath Index file (default: defaultIndexPath(directory))
+     * @param rebuild Ignore any existing index and read every file
+     * @return Counts, or an error if the directory or index is unusable
+     */
+    static UpdateResult update(
+        const std::filesystem::path& directory,
+        const std::filesystem::path& indexPath = {},
+        bool rebuild = false
+    );
+
+    /**
+     * Open an existing index.
+     *
+     * @param directory Catalog directory (entry paths are relative to it)
+     * @param indexPath Index file (default: defaultIndexPath(directory))
+     * @return Catalog, or nullopt if the index is missing or unreadable
+     */
+    static std::optional<Catalog> open(
+        const std::filesystem::path& directory,
+        const std::filesystem::path& indexPath = {}
+    );
+
+    /**
+     * Find packages matching a query, ordered by name, then newest version
+     * first. Entries that failed to index never match.
+     *
+     * @return Matches, or nullopt if the version range is invalid
+     */
+    std::optional<std::vector<const Entry*>> find(const Query& query) const;
+
+    /**
+     * All records, sorted by path (including failed ones).
+     */
+    const std::vector<Entry>& entries() const { return entries_; }
+
+    /**
+     * Catalog directory.
+     */
+    const std::filesystem::path& directory() const { return directory_; }
+
+    /**
+     * Absolute-or-directory-relative path of an entry's package file.
+     */
+    std::filesystem::path packagePath(const Entry& entry) const;
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    std::filesystem::path directory_;
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string, std::vector<size_t>> byName_;  // name -> entries_ indices
+
+    static thread_local std::string lastError_;
+
+    void buildNameIndex();
+
+    /**
+     * Read the index file; nullopt if missing, malformed or another format.
+     */
+    static std::optional<std::vector<Entry>> readIndex(const std::filesystem::path& indexPath);
+
+    /**
+     * Write the index to a temporary file and rename it over indexPath.
+     */
+    static bool writeIndex(const std::filesystem::path& indexPath,
+                           const std::vector<Entry>& entries);
+
+    /**
+     * A signed manifest whose signature update() has yet to check.
+     */
+    struct PendingSignature {
+        Manifest manifest;
+        crypto::ManifestSig signature;
+    };
+
+    /**
+     * Read one package's metadata into a record. A signed package gets no
+     * signer yet: its manifest and signature are left in `pending`, and
+     * update() checks all of them in one batch.
+     */
+    static Entry readEntry(const std::filesystem::path& file, const std::string& relPath,
+                           const FileIdentity& identity, std::optional<PendingSignature>& pending);
+};
+
+} // namespace lgx
@@ -0,0 +1,433 @@
+#include "composition.h"
+#include "gzip_handler.h"
+#include "manifest.h"
+#include "progress.h"
+#include "tar_reader.h"
+#include "trace.h"
+#include "../crypto/signing.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace lgx {
+
+thread_local std::string Composition::lastError_;
+
+namespace {
+
+// Header and trailer compressTo() wraps around the deflate stream
+constexpr uint64_t GZIP_FRAMING_BYTES = 18;
+
+size_t bucketOf(uint64_t size) {
+    size_t i = 0;
+    while (i < Composition::HISTOGRAM_BOUNDS.size() && size >= Composition::HISTOGRAM_BOUNDS[i]) {
+        ++i;
+    }
+    return i;
+}
+
+void addFile(Composition::Group& group, uint64_t size, uint64_t compressed) {
+    ++group.files;
+    group.bytes += size;
+    group.compressed += compressed;
+    ++group.histogram[bucketOf(size)];
+}
+
+std::vector<Composition::Group> groupList(std::map<std::string, Composition::Group>& groups) {
+    std::vector<Composition::Group> list;
+    for (auto& [name, group] : groups) {
+        group.name = name;
+        list.push_back(std::move(group));
+    }
+    return list;
+}
+
+template <typename T, typename Less>
+void keepTop(std::vector<T>& items, size_t top, Less less) {
+    size_t n = std::min(top, items.size());
+    std::partial_sort(items.begin(), items.begin() + static_cast<std::ptrdiff_t>(n), items.end(), less);
+    items.resize(n);
+}
+
+std::string formatBytes(uint64_t bytes) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (bytes >= 1024ull * 1024 * 1024) {
+        out << bytes / (1024.0 * 1024 * 1024) << " GiB";
+    } else if (bytes >= 1024ull * 1024) {
+        out << bytes / (1024.0 * 1024) << " MiB";
+    } else if (bytes >= 1024) {
+        out << bytes / 1024.0 << " KiB";
+    } else {
+        out << bytes << " B";
+    }
+    return out.str();
+}
+
+std::string formatBound(uint64_t bytes) {
+    if (bytes >= 1024ull * 1024 && bytes % (1024ull * 1024) == 0) {
+        return std::to_string(bytes / (1024ull * 1024)) + " MiB";
+    }
+    if (bytes >= 1024 && bytes % 1024 == 0) {
+        return std::to_string(bytes / 1024) + " KiB";
+    }
+    return std::to_string(bytes) + " B";
+}
+
+void printGroups(std::ostringstream& out, const char* title,
+                 const std::vector<Composition::Group>& groups, bool probed) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-24s %8s %12s %12s\n", title, "files", "bytes",
+                  probed ? "deflated" : "compressed~");
+    out << line;
+    for (const auto& group : groups) {
+        std::snprintf(line, sizeof(line), "  %-22s %8zu %12s %12s\n", group.name.c_str(),
+                      group.files, formatBytes(group.bytes).c_str(),
+                      formatBytes(group.compressed).c_str());
+        out << line;
+    }
+}
+
+nlohmann::ordered_json groupToJson(const Composition::Group& group) {
+    return {
+        {"name", group.name},
+        {"files", group.files},
+        {"bytes", group.bytes},
+        {"compressed_bytes", group.compressed},
+        {"histogram", group.histogram},
+    };
+}
+
+nlohmann::ordered_json fileToJson(const Composition::File& file, bool probed) {
+    nlohmann::ordered_json j = {{"path", file.path}, {"bytes", file.size}};
+    if (probed) {
+        j["compressed_bytes"] = file.compressed;
+    }
+    return j;
+}
+
+} // namespace
+
+std::optional<Composition::Report> Composition::analyze(const std::filesystem::path& lgxPath,
+                                                        const Options& options) {
+    Trace::Span span("composition.analyze", lgxPath.string());
+
+    std::error_code ec;
+    Report report;
+    report.packageBytes = std::filesystem::file_size(lgxPath, ec);
+    std::ifstream input(lgxPath, std::ios::binary);
+    if (ec || !input) {
+        lastError_ = "Cannot open file: " + lgxPath.string();
+        return std::nullopt;
+    }
+    report.probed = options.probe;
+
+    struct Payload {
+        uint64_t size = 0;
+        std::vector<std::string> paths;
+        std::set<std::string> variants;
+    };
+    std::map<std::string, Group> roots;
+    std::map<std::string, Group> variants;
+    std::map<std::string, Payload> payloads;   // by SHA-256 (probe only)
+    std::vector<File> files;
+    std::vector<File> incompressible;
+    std::optional<std::string> manifestJson;
+    std::string probeError;
+
+    TarReader::StreamParser parser(
+        [&](const TarReader::EntryInfo& info) {
+            return options.probe || info.path == "manifest.json";
+        },
+        [&](const TarReader::EntryInfo& info, std::vector<uint8_t>& data) {
+            if (info.isDirectory) {
+                ++report.directories;
+                return true;
+            }
+            if (!info.isRegularFile) {
+                return true;
+            }
+            if (info.path == "manifest.json") {
+                manifestJson.emplace(data.begin(), data.end());
+            }
+
+            File file{info.path, info.size, 0};
+            std::string sha256;
+            if (options.probe) {
+                uint64_t out = 0;
+                if (!GzipHandler::compressTo(data.data(), data.size(),
+                        [&out](const uint8_t*, size_t size) { out += size; return true; })) {
+                    probeError = "Failed to compress " + info.path + ": " + GzipHandler::getLastError();
+                    return false;
+                }
+                file.compressed = out > GZIP_FRAMING_BYTES ? out - GZIP_FRAMING_BYTES : 0;
+                crypto::Sha256 hasher;
+                hasher.update(data.data(), data.size());
+                sha256 = hasher.finalHex();
+            }
+
+            size_t slash = info.path.find('/');
+            std::string root = info.path.substr(0, slash);
+            addFile(report.total, file.size, file.compressed);
+            addFile(roots[root], file.size, file.compressed);
+            if (root == "variants" && slash != std::string::npos) {
+                size_t second = info.path.find('/', slash + 1);
+                if (second != std::string::npos) {
+                    std::string variant = info.path.substr(slash + 1, second - slash - 1);
+                    addFile(variants[variant], file.size, file.compressed);
+                    if (options.probe && file.size > 0) {
+                        Payload& payload = payloads[sha256];
+                        payload.size = file.size;
+                        payload.paths.push_back(info.path);
+                        payload.variants.insert(variant);
+                    }
+                }
+            }
+
+            if (info.path.size() > report.longestPath.value) {
+                report.longestPath = {info.path, info.path.size()};
+            }
+            size_t depth = static_cast<size_t>(std::count(info.path.begin(), info.path.end(), '/')) + 1;
+            if (depth > report.deepestPath.value) {
+                report.deepestPath = {info.path, depth};
+            }
+            if (options.probe && file.size >= INCOMPRESSIBLE_MIN_SIZE &&
+                file.compressed >= file.size - static_cast<uint64_t>(file.size * INCOMPRESSIBLE_SAVING)) {
+                ++report.incompressibleCount;
+                report.incompressibleBytes += file.size;
+                incompressible.push_back(file);
+            }
+            files.push_back(std::move(file));
+            Progress::addEntries();
+            return !Progress::isCancelled();
+        });
+
+    bool inflated = GzipHandler::decompressStream(
+        [&input](uint8_t* buffer, size_t maxSize) -> size_t {
+            input.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(maxSize));
+            return static_cast<size_t>(input.gcount());
+        },
+        [&](const uint8_t* buffer, size_t size) {
+            report.tarBytes += size;
+            return parser.feed(buffer, size) || parser.ended();
+        });
+
+    if (Progress::isCancelled()) {
+        lastError_ = Progress::CANCELLED_ERROR;
+        return std::nullopt;
+    }
+    if (!probeError.empty()) {
+        lastError_ = probeError;
+        return std::nullopt;
+    }
+    if (!parser.error().empty()) {
+        lastError_ = "Failed to read tar: " + parser.error();
+        return std::nullopt;
+    }
+    if (!inflated) {
+        lastError_ = "Failed to decompress: " + GzipHandler::getLastError();
+        return std::nullopt;
+    }
+    if (manifestJson) {
+        if (auto manifest = Manifest::fromJson(*manifestJson)) {
+            report.name = manifest->name;
+            report.version = manifest->version;
+        }
+    }
+
+    report.roots = groupList(roots);
+    report.variants = groupList(variants);
+
+    // Without a probe, share the .lgx size out by uncompressed bytes
+    if (!options.probe && report.tarBytes > 0) {
+        double ratio = static_cast<double>(report.packageBytes) / static_cast<double>(report.tarBytes);
+        auto estimate = [ratio](Group& group) {
+            group.compressed = static_cast<uint64_t>(std::llround(group.bytes * ratio));
+        };
+        estimate(report.total);
+        std::for_each(report.roots.begin(), report.roots.end(), estimate);
+        std::for_each(report.variants.begin(), report.variants.end(), estimate);
+    }
+
+    for (auto& [sha256, payload] : payloads) {
+        if (payload.variants.size() < 2) {
+            continue;
+        }
+        Duplicate duplicate{sha256, payload.size, std::move(payload.paths)};
+        ++report.duplicateCount;
+        report.duplicateBytes += duplicate.wasted();
+        report.duplicates.push_back(std::move(duplicate));
+    }
+
+    auto bySize = [](const File& a, const File& b) {
+        return a.size != b.size ? a.size > b.size : a.path < b.path;
+    };
+    keepTop(files, options.top, bySize);
+    report.largest = std::move(files);
+    keepTop(incompressible, options.top, bySize);
+    report.incompressible = std::move(incompressible);
+    keepTop(report.duplicates, options.top, [](const Duplicate& a, const Duplicate& b) {
+        return a.wasted() != b.wasted() ? a.wasted() > b.wasted() : a.sha256 < b.sha256;
+    });
+    return report;
+}
+
+std::optional<Composition::Report> Composition::analyze(const std::filesystem::path& lgxPath) {
+    return analyze(lgxPath, Options());
+}
+
+std::string Composition::bucketLabel(size_t i) {
+    if (i == 0) {
+        return "0 B";
+    }
+    if (i >= HISTOGRAM_BOUNDS.size()) {
+        return ">= " + formatBound(HISTOGRAM_BOUNDS.back());
+    }
+    return formatBound(HISTOGRAM_BOUNDS[i - 1]) + " - " + formatBound(HISTOGRAM_BOUNDS[i]);
+}
+
+std::string Composition::toText(const Report& report) {
+    std::ostringstream out;
+    char line[256];
+
+    out << "Package: " << (report.name.empty() ? "(no manifest)" : report.name);
+    if (!report.version.empty()) {
+        out << " " << report.version;
+    }
+    out << "\n"
+        << "Size:    " << formatBytes(report.packageBytes) << " compressed, "
+        << formatBytes(report.total.bytes) << " in " << report.total.files << " files, "
+        << report.directories << " directories\n";
+    if (!report.probed) {
+        out << "Compressed sizes are shares of the .lgx size; use --probe to deflate each file\n";
+    }
+
+    out << "\n";
+    printGroups(out, "Roots", report.roots, report.probed);
+    if (!report.variants.empty()) {
+        out << "\n";
+        printGroups(out, "Variants", report.variants, report.probed);
+    }
+
+    out << "\nFile sizes\n";
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+        std::snprintf(line, sizeof(line), "  %-22s %8zu\n", bucketLabel(i).c_str(),
+                      report.total.histogram[i]);
+        out << line;
+    }
+
+    out << "\nLargest files\n";
+    for (const auto& file : report.largest) {
+        std::snprintf(line, sizeof(line), "  %12s  ", formatBytes(file.size).c_str());
+        out << line << file.path << "\n";
+    }
+
+    if (report.probed) {
+        out << "\nDuplicated across variants: " << report.duplicateCount << " payload(s), "
+            << formatBytes(report.duplicateBytes) << " repeated\n";
+        for (const auto& duplicate : report.duplicates) {
+            out << "  " << duplicate.paths.size() << " copies of " << formatBytes(duplicate.size)
+                << " (" << formatBytes(duplicate.wasted()) << " repeated):\n";
+            for (const auto& path : duplicate.paths) {
+                out << "    " << path << "\n";
+            }
+        }
+
+        out << "\nIncompressible: " << report.incompressibleCount << " file(s), "
+            << formatBytes(report.incompressibleBytes) << "\n";
+        for (const auto& file : report.incompressible) {
+            std::snprintf(line, sizeof(line), "  %12s  ", formatBytes(file.size).c_str());
+            out << line << file.path << "\n";
+        }
+    }
+
+    out << "\nPaths\n";
+    if (!report.longestPath.path.empty()) {
+        out << "  longest: " << report.longestPath.value << " bytes  " << report.longestPath.path << "\n"
+            << "  deepest: " << report.deepestPath.value << " levels  " << report.deepestPath.path << "\n";
+    }
+    return out.str();
+}
+
+std::string Composition::toJson(const Report& report) {
+    nlohmann::ordered_json roots = nlohmann::ordered_json::array();
+    for (const auto& group : report.roots) {
+        roots.push_back(groupToJson(group));
+    }
+    nlohmann::ordered_json variants = nlohmann::ordered_json::array();
+    for (const auto& group : report.variants) {
+        variants.push_back(groupToJson(group));
+    }
+    nlohmann::ordered_json buckets = nlohmann::ordered_json::array();
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+        buckets.push_back(bucketLabel(i));
+    }
+    nlohmann::ordered_json largest = nlohmann::ordered_json::array();
+    for (const auto& file : report.largest) {
+        largest.push_back(fileToJson(file, report.probed));
+    }
+
+    nlohmann::ordered_json result = {
+        {"name", report.name},
+        {"version", report.version},
+        {"package_bytes", report.packageBytes},
+        {"tar_bytes", report.tarBytes},
+        {"probed", report.probed},
+        {"files", report.total.files},
+        {"directories", report.directories},
+        {"bytes", report.total.bytes},
+        {"compressed_bytes", report.total.compressed},
+        {"histogram_buckets", buckets},
+        {"histogram", report.total.histogram},
+        {"roots", roots},
+        {"variants", variants},
+        {"largest", largest},
+    };
+
+    if (report.probed) {
+        nlohmann::ordered_json duplicates = nlohmann::ordered_json::array();
+        for (const auto& duplicate : report.duplicates) {
+            duplicates.push_back({
+                {"sha256", duplicate.sha256},
+                {"bytes", duplicate.size},
+                {"wasted_bytes", duplicate.wasted()},
+                {"paths", duplicate.paths},
+            });
+        }
+        nlohmann::ordered_json incompressible = nlohmann::ordered_json::array();
+        for (const auto& file : report.incompressible) {
+            incompressible.push_back(fileToJson(file, true));
+        }
+        result["duplicates"] = {
+            {"count", report.duplicateCount},
+            {"wasted_bytes", report.duplicateBytes},
+            {"top", duplicates},
+        };
+        result["incompressible"] = {
+            {"count", report.incompressibleCount},
+            {"bytes", report.incompressibleBytes},
+            {"top", incompressible},
+        };
+    } else {
+        result["duplicates"] = nullptr;
+        result["incompressible"] = nullptr;
+    }
+
+    result["longest_path"] = {{"path", report.longestPath.path}, {"bytes", report.longestPath.value}};
+    result["deepest_path"] = {{"path", report.deepestPath.path}, {"depth", report.deepestPath.value}};
+    return result.dump(2);
+}
+
+std::string Composition::getLastError() {
+    return lastError_;
+}
+
+} // namespace lgx
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace lgx {
+
+/**
+ * Composition describes what a package is made of (`lgx stats`): sizes per
+ * root and per variant, a file size histogram, the largest files and the
+ * longest and deepest paths.
+ *
+ * The default pass reads only tar headers. File data streams past without
+ * being kept, though the gzip stream is still inflated to reach the
+ * headers. Compressed sizes are then estimated by sharing out the .lgx
+ * size in proportion to uncompressed bytes.
+ *
+ * The probe pass (Options::probe) also receives each file's data, one file
+ * at a time. It deflates the file on its own at the level save() uses and
+ * hashes it. That gives a per-file compressed cost, the incompressible
+ * files, and payloads repeated across variants.
+ */
+class Composition {
+public:
+    /**
+     * Upper bounds (exclusive) of the histogram buckets, in bytes; the
+     * last bucket holds everything from the last bound up.
+     */
+    static constexpr std::array<uint64_t, 6> HISTOGRAM_BOUNDS = {
+        1, 1024, 16 * 1024, 256 * 1024, 4 * 1024 * 1024, 64 * 1024 * 1024};
+    static constexpr size_t HISTOGRAM_BUCKETS = HISTOGRAM_BOUNDS.size() + 1;
+
+    /**
+     * A file is incompressible if deflate saves less than this fraction of it.
+     */
+    static constexpr double INCOMPRESSIBLE_SAVING = 0.05;
+
+    /**
+     * Smaller files are never reported as incompressible.
+     */
+    static constexpr uint64_t INCOMPRESSIBLE_MIN_SIZE = 1024;
+
+    struct Options {
+        bool probe = false;
+        size_t top = 10;   // length of the largest/duplicate/incompressible lists
+    };
+
+    /**
+     * Files and bytes under one root ("variants", "docs", ...) or variant.
+     */
+    struct Group {
+        std::string name;
+        size_t files = 0;
+        uint64_t bytes = 0;        // uncompressed
+        uint64_t compressed = 0;   // estimated, or deflated per file if probed
+        std::array<size_t, HISTOGRAM_BUCKETS> histogram{};
+    };
+
+    struct File {
+        std::string path;
+        uint64_t size = 0;
+        uint64_t compressed = 0;   // deflated size (probe only)
+    };
+
+    /**
+     * One payload found in more than one variant.
+     */
+    struct Duplicate {
+        std::string sha256;
+        uint64_t size = 0;
+        std::vector<std::string> paths;
+        uint64_t wasted() const { return size * (paths.size() - 1); }
+    };
+
+    struct PathExtreme {
+        std::string path;
+        size_t value = 0;          // bytes, or path components
+    };
+
+    struct Report {
+        std::string name;
+        std::string version;
+        uint64_t packageBytes = 0; // size of the .lgx file
+        uint64_t tarBytes = 0;     // inflated archive, headers and padding included
+        bool probed = false;
+        size_t directories = 0;
+        Group total;
+        std::vector<Group> roots;
+        std::vector<Group> variants;
+        std::vector<File> largest;               // by size, at most Options::top
+        std::vector<Duplicate> duplicates;       // by wasted bytes, at most Options::top
+        size_t duplicateCount = 0;               // all duplicate payloads
+        uint64_t duplicateBytes = 0;             // bytes they waste
+        std::vector<File> incompressible;        // by size, at most Options::top
+        size_t incompressibleCount = 0;
+        uint64_t incompressibleBytes = 0;
+        PathExtreme longestPath;
+        PathExtreme deepestPath;
+    };
+
+    /**
+     * Analyze a package file.
+     *
+     * @return Report, or nullopt if the package cannot be read (see getLastError())
+     */
+    static std::optional<Report> analyze(const std::filesystem::path& lgxPath,
+                                         const Options& options);
+    static std::optional<Report> analyze(const std::filesystem::path& lgxPath);
+
+    /**
+     * Label of histogram bucket i, e.g. "1 KiB - 16 KiB".
+     */
+    static std::string bucketLabel(size_t i);
+
+    static std::string toText(const Report& report);
+    static std::string toJson(const Report& report);
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    static thread_local std::string lastError_;
+};
+
+} // namespace lgx
@@ -0,0 +1,167 @@
+#include "digest_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace lgx {
+
+thread_local std::string DigestCache::lastError_;
+
+namespace {
+
+const char* const HEADER = "lgx-digest-cache 1";
+
+bool isHexDigest(const std::string& s) {
+    return s.size() == 64 && s.find_first_not_of("0123456789abcdef") == std::string::npos;
+}
+
+} // namespace
+
+bool DigestCache::Key::of(const std::filesystem::path& path, Key& key) {
+#ifdef _WIN32
+    (void)path;
+    (void)key;
+    return false;
+#else
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    key.device = static_cast<uint64_t>(st.st_dev);
+    key.inode = static_cast<uint64_t>(st.st_ino);
+    key.size = static_cast<uint64_t>(st.st_size);
+#ifdef __APPLE__
+    key.mtimeNs = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+    key.ctimeNs = static_cast<int64_t>(st.st_ctimespec.tv_sec) * 1000000000 + st.st_ctimespec.tv_nsec;
+#else
+    key.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    key.ctimeNs = static_cast<int64_t>(st.st_ctim.tv_sec) * 1000000000 + st.st_ctim.tv_nsec;
+#endif
+    return true;
+#endif
+}
+
+DigestCache::DigestCache(std::filesystem::path dir)
+    : dir_(std::move(dir)), entries_(read(dir_ / FILENAME)) {}
+
+std::string DigestCache::fileId(const Key& key) {
+    return std::to_string(key.device) + ":" + std::to_string(key.inode);
+}
+
+DigestCache::Map DigestCache::read(const std::filesystem::path& path) {
+    Map result;
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line) || line != HEADER) {
+        return result;
+    }
+    while (std::getline(file, line)) {
+        // device inode size mtime_ns ctime_ns sha256
+        std::istringstream fields(line);
+        uint64_t device = 0;
+        uint64_t inode = 0;
+        Record record;
+        if (!(fields >> device >> inode >> record.size >> record.mtimeNs >> record.ctimeNs >>
+              record.sha256) || !isHexDigest(record.sha256)) {
+            continue;  // a damaged line only costs a rehash
+        }
+        result[std::to_string(device) + ":" + std::to_string(inode)] = std::move(record);
+    }
+    return result;
+}
+
+std::optional<std::string> DigestCache::lookup(const Key& key) {
+    std::string id = fileId(key);
+    auto it = entries_.find(id);
+    if (it == entries_.end() || it->second.size != key.size ||
+        it->second.mtimeNs != key.mtimeNs || it->second.ctimeNs != key.ctimeNs) {
+        ++counters_.misses;
+        return std::nullopt;
+    }
+    ++counters_.hits;
+    used_.insert(std::move(id));
+    return it->second.sha256;
+}
+
+void DigestCache::record(const Key& key, const std::string& sha256Hex) {
+    int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (nowNs - std::max(key.mtimeNs, key.ctimeNs) < RACY_WINDOW_NS || !isHexDigest(sha256Hex)) {
+        return;
+    }
+    Record record{key.size, key.mtimeNs, key.ctimeNs, sha256Hex};
+    std::string id = fileId(key);
+    entries_[id] = record;
+    added_[id] = std::move(record);
+    used_.insert(std::move(id));
+    ++counters_.recorded;
+}
+
+bool DigestCache::save() {
+    if (added_.empty()) {
+        return true;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(dir_, ec);
+
+    // Merge into what is on disk now, which other processes may have updated
+    std::filesystem::path path = dir_ / FILENAME;
+    Map merged = read(path);
+    for (const auto& [id, record] : added_) {
+        merged[id] = record;
+    }
+    if (merged.size() > MAX_ENTRIES) {
+        for (auto it = merged.begin(); it != merged.end();) {
+            it = used_.count(it->first) ? std::next(it) : merged.erase(it);
+        }
+    }
+
+    // A private temporary name, so concurrent saves do not write into each other
+    std::filesystem::path tmpPath = path;
+    tmpPath += ".tmp." + std::to_string(std::random_device{}());
+    {
+        std::ofstream file(tmpPath, std::ios::trunc);
+        if (!file) {
+            lastError_ = "Cannot write digest cache: " + tmpPath.string();
+            return false;
+        }
+        file << HEADER << '\n';
+        for (const auto& [id, record] : merged) {
+            size_t colon = id.find(':');
+            file << id.substr(0, colon) << ' ' << id.substr(colon + 1) << ' ' << record.size << ' '
+                 << record.mtimeNs << ' ' << record.ctimeNs << ' ' << record.sha256 << '\n';
+        }
+        file.close();
+        if (!file) {
+            lastError_ = "Cannot write digest cache: " + tmpPath.string();
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        lastError_ = "Cannot replace digest cache " + path.string() + ": " + ec.message();
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    added_.clear();
+    return true;
+}
+
+std::string DigestCache::summary() const {
+    size_t lookups = counters_.hits + counters_.misses;
+    char percent[16];
+    std::snprintf(percent, sizeof(percent), "%.1f%%", lookups ? 100.0 * counters_.hits / lookups : 0.0);
+    return std::to_string(counters_.hits) + "/" + std::to_string(lookups) + " hits (" + percent + ")";
+}
+
+std::string DigestCache::getLastError() {
+    return lastError_;
+}
+
+} // namespace lgx
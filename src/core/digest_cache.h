@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace lgx {
+
+/**
+ * DigestCache remembers the SHA-256 of input files across runs, keyed by
+ * what stat() says about them, so unchanged files need not be hashed again
+ * (`lgx add` / `lgx build` with --digest-cache or LGX_DIGEST_CACHE).
+ *
+ * A digest is reused only if device, inode, size, modification time and
+ * change time all match what was recorded, and only for a read during
+ * which the file's stat did not change. Any doubt means the file is
+ * rehashed:
+ * - files changed within RACY_WINDOW_NS of being recorded are not recorded,
+ *   since a later write in the same timestamp tick would go unnoticed;
+ * - an unreadable or malformed cache file is treated as empty.
+ *
+ * The cache is one text file in the cache directory, replaced atomically
+ * on save(). Processes sharing the directory each merge their entries
+ * into what is on disk; if two save at once, one's new entries are lost,
+ * which only costs a rehash.
+ */
+class DigestCache {
+public:
+    /**
+     * File name of the cache inside the cache directory.
+     */
+    static constexpr const char* FILENAME = "digests-v1";
+
+    /**
+     * Environment variable naming a cache directory for commands not given
+     * --digest-cache.
+     */
+    static constexpr const char* ENV_VAR = "LGX_DIGEST_CACHE";
+
+    /**
+     * Files whose mtime or ctime is this close to the time they are
+     * recorded are not recorded (2 s).
+     */
+    static constexpr int64_t RACY_WINDOW_NS = 2'000'000'000;
+
+    /**
+     * Entries kept on save(). Beyond this, only the entries used or
+     * recorded by this process are kept.
+     */
+    static constexpr size_t MAX_ENTRIES = 1 << 20;
+
+    /**
+     * What the cache knows about a file.
+     */
+    struct Key {
+        uint64_t device = 0;
+        uint64_t inode = 0;
+        uint64_t size = 0;
+        int64_t mtimeNs = 0;
+        int64_t ctimeNs = 0;
+
+        /**
+         * Stat a file (following symlinks).
+         *
+         * @return false if the file cannot be stat'ed, or on platforms
+         *         without inode numbers and change times (Windows), where
+         *         nothing is cached
+         */
+        static bool of(const std::filesystem::path& path, Key& key);
+
+        bool operator==(const Key& other) const {
+            return device == other.device && inode == other.inode && size == other.size &&
+                   mtimeNs == other.mtimeNs && ctimeNs == other.ctimeNs;
+        }
+        bool operator!=(const Key& other) const { return !(*this == other); }
+    };
+
+    /**
+     * Lookup counts since the cache was opened.
+     */
+    struct Counters {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t recorded = 0;
+    };
+
+    /**
+     * Open the cache in `dir` (created on save() if missing).
+     */
+    explicit DigestCache(std::filesystem::path dir);
+
+    /**
+     * Hex SHA-256 recorded for a file with exactly this key, if any.
+     */
+    std::optional<std::string> lookup(const Key& key);
+
+    /**
+     * Record a file's digest, unless the file changed too recently to be
+     * trusted (see RACY_WINDOW_NS).
+     */
+    void record(const Key& key, const std::string& sha256Hex);
+
+    /**
+     * Merge the new entries into the cache file.
+     *
+     * @return false if it cannot be written (see getLastError())
+     */
+    bool save();
+
+    const Counters& counters() const { return counters_; }
+
+    /**
+     * "1980/2000 hits (99.0%)", for command output.
+     */
+    std::string summary() const;
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    struct Record {
+        uint64_t size = 0;
+        int64_t mtimeNs = 0;
+        int64_t ctimeNs = 0;
+        std::string sha256;
+    };
+    using Map = std::unordered_map<std::string, Record>;  // by "device:inode"
+
+    std::filesystem::path dir_;
+    Map entries_;
+    Map added_;                           // recorded since opening, merged on save()
+    std::unordered_set<std::string> used_;  // hit or recorded since opening
+    Counters counters_;
+
+    static Map read(const std::filesystem::path& path);
+    static std::string fileId(const Key& key);
+
+    static thread_local std::string lastError_;
+};
+
+} // namespace lgx
@@ -0,0 +1,188 @@
+#include "durable_io.h"
+#include "trace.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace lgx {
+
+thread_local std::string DurableIo::lastError_;
+
+namespace {
+
+std::string errnoText() {
+    return std::strerror(errno);
+}
+
+#ifndef _WIN32
+// open() that retries when interrupted by a signal
+int openForSync(const std::filesystem::path& path, int flags) {
+    int fd;
+    do {
+        fd = ::open(path.c_str(), flags | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+    return fd;
+}
+#endif
+
+} // namespace
+
+bool DurableIo::syncFile(const std::filesystem::path& path) {
+#ifdef _WIN32
+    int fd = ::_wopen(path.c_str(), _O_RDWR | _O_BINARY);
+    if (fd < 0) {
+        lastError_ = "Cannot open " + path.string() + " to sync: " + errnoText();
+        return false;
+    }
+    bool ok = ::_commit(fd) == 0;
+    if (!ok) {
+        lastError_ = "Cannot sync " + path.string() + ": " + errnoText();
+    }
+    ::_close(fd);
+    return ok;
+#else
+    int fd = openForSync(path, O_RDONLY);
+    if (fd < 0) {
+        lastError_ = "Cannot open " + path.string() + " to sync: " + errnoText();
+        return false;
+    }
+#ifdef __linux__
+    bool ok = ::fdatasync(fd) == 0;
+#else
+    bool ok = ::fsync(fd) == 0;
+#endif
+    if (!ok) {
+        lastError_ = "Cannot sync " + path.string() + ": " + errnoText();
+    }
+    ::close(fd);
+    return ok;
+#endif
+}
+
+bool DurableIo::syncFiles(const std::vector<std::filesystem::path>& paths) {
+    Trace::Span span("durable.sync_files", std::to_string(paths.size()));
+#ifdef __linux__
+    // Start writeback of everything, so the device works through the whole
+    // batch while the second pass waits on one file at a time
+    for (const auto& path : paths) {
+        int fd = openForSync(path, O_RDONLY);
+        if (fd < 0) {
+            continue;  // reported by the second pass
+        }
+        ::sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WRITE);
+        ::close(fd);
+    }
+#endif
+    for (const auto& path : paths) {
+        if (!syncFile(path)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DurableIo::syncDirectory(const std::filesystem::path& dir) {
+#ifdef _WIN32
+    (void)dir;
+    return true;
+#else
+    std::filesystem::path target = dir.empty() ? std::filesystem::path(".") : dir;
+    int fd = openForSync(target, O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        lastError_ = "Cannot open directory " + target.string() + " to sync: " + errnoText();
+        return false;
+    }
+    bool ok = ::fsync(fd) == 0;
+    if (!ok) {
+        lastError_ = "Cannot sync directory " + target.string() + ": " + errnoText();
+    }
+    ::close(fd);
+    return ok;
+#endif
+}
+
+bool DurableIo::syncTree(const std::filesystem::path& root) {
+    namespace fs = std::filesystem;
+    Trace::Span span("durable.sync_tree", root.string());
+
+    std::vector<fs::path> files;
+    std::vector<fs::path> dirs{root};
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(root, ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        fs::file_status status = it->symlink_status(ec);
+        if (ec) {
+            break;
+        }
+        if (fs::is_regular_file(status)) {
+            files.push_back(it->path());
+        } else if (fs::is_directory(status)) {
+            dirs.push_back(it->path());
+        }
+    }
+    if (ec) {
+        lastError_ = "Cannot read " + root.string() + ": " + ec.message();
+        return false;
+    }
+
+    if (!syncFiles(files)) {
+        return false;
+    }
+    for (const auto& dir : dirs) {
+        if (!syncDirectory(dir)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DurableIo::exchange(const std::filesystem::path& a, const std::filesystem::path& b) {
+    namespace fs = std::filesystem;
+#if defined(__linux__) && defined(RENAME_EXCHANGE)
+    if (::renameat2(AT_FDCWD, a.c_str(), AT_FDCWD, b.c_str(), RENAME_EXCHANGE) == 0) {
+        return true;
+    }
+    if (errno != EINVAL && errno != ENOSYS && errno != ENOTSUP) {
+        lastError_ = "Cannot exchange " + a.string() + " and " + b.string() + ": " + errnoText();
+        return false;
+    }
+#endif
+    // Not supported here (or by this filesystem): swap through a third name
+    fs::path aside = b;
+    aside += ".lgx-old";
+    std::error_code ec;
+    fs::remove_all(aside, ec);
+    fs::rename(b, aside, ec);
+    if (ec) {
+        lastError_ = "Cannot move " + b.string() + " aside: " + ec.message();
+        return false;
+    }
+    fs::rename(a, b, ec);
+    if (ec) {
+        lastError_ = "Cannot rename " + a.string() + " to " + b.string() + ": " + ec.message();
+        std::error_code ignored;
+        fs::rename(aside, b, ignored);
+        return false;
+    }
+    fs::rename(aside, a, ec);
+    if (ec) {
+        lastError_ = "Cannot rename " + aside.string() + " to " + a.string() + ": " + ec.message();
+        return false;
+    }
+    return true;
+}
+
+std::string DurableIo::getLastError() {
+    return lastError_;
+}
+
+} // namespace lgx
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace lgx {
+
+/**
+ * DurableIo flushes written files and directory entries to stable storage,
+ * for the durable modes of Package::save() and extraction.
+ *
+ * Syncing each file as it is written costs one full device round trip per
+ * file, which dominates installs of many small files. syncFiles() instead
+ * starts writeback of every file first and only then waits for each one,
+ * so the device sees the whole batch at once. Renames and new directory
+ * entries are made durable by syncing the directories that hold them.
+ *
+ * On Linux writeback is started with sync_file_range() and awaited with
+ * fdatasync(); elsewhere each file gets fsync(). Windows has no directory
+ * sync, so syncDirectory() succeeds there without doing anything.
+ */
+class DurableIo {
+public:
+    /**
+     * Flush one file's data (and the metadata needed to read it back).
+     */
+    static bool syncFile(const std::filesystem::path& path);
+
+    /**
+     * Flush many files in two passes: start writeback of all, then wait
+     * for each.
+     */
+    static bool syncFiles(const std::vector<std::filesystem::path>& paths);
+
+    /**
+     * Flush a directory, making the entries created, renamed or removed
+     * in it durable.
+     */
+    static bool syncDirectory(const std::filesystem::path& dir);
+
+    /**
+     * syncFiles() for every regular file under root, then syncDirectory()
+     * for every directory, root included. For a freshly written tree
+     * (e.g. a staging directory) before it is renamed into place.
+     */
+    static bool syncTree(const std::filesystem::path& root);
+
+    /**
+     * Atomically swap two paths (renameat2 RENAME_EXCHANGE). Where that
+     * is unavailable, falls back to three renames, which leave a moment
+     * when `b` does not exist.
+     */
+    static bool exchange(const std::filesystem::path& a, const std::filesystem::path& b);
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    static thread_local std::string lastError_;
+};
+
+} // namespace lgx
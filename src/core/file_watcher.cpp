@@ -0,0 +1,256 @@
+#include "file_watcher.h"
+
+#include <chrono>
+#include <set>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <unordered_map>
+#else
+#include <algorithm>
+#include <map>
+#include <thread>
+#endif
+
+namespace lgx {
+
+namespace fs = std::filesystem;
+
+thread_local std::string FileWatcher::lastError_;
+
+#ifdef __linux__
+
+namespace {
+
+constexpr uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE |
+                                IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB |
+                                IN_DELETE_SELF | IN_MOVE_SELF;
+
+} // namespace
+
+struct FileWatcher::State {
+    struct Watch {
+        fs::path dir;
+        bool tree = false;  // inside a directory root: every event counts
+    };
+
+    int fd = -1;
+    std::unordered_map<int, Watch> watches;
+    std::set<fs::path> fileRoots;
+
+    ~State() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    bool addWatch(const fs::path& dir, bool tree) {
+        int wd = inotify_add_watch(fd, dir.c_str(), WATCH_MASK);
+        if (wd < 0) {
+            return false;
+        }
+        Watch& watch = watches[wd];
+        watch.dir = dir;
+        watch.tree = watch.tree || tree;
+        return true;
+    }
+
+    // Watch a directory and everything below it; directories that vanish
+    // meanwhile are skipped
+    bool addTree(const fs::path& dir) {
+        if (!addWatch(dir, true)) {
+            return false;
+        }
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it(dir, fs::directory_options::skip_permission_denied, ec), end;
+             !ec && it != end; it.increment(ec)) {
+            std::error_code statusEc;
+            if (it->is_directory(statusEc) && !it->is_symlink(statusEc)) {
+                addWatch(it->path(), true);
+            }
+        }
+        return true;
+    }
+
+    // Read every queued event into `changed`
+    void drain(const std::vector<fs::path>& roots, std::set<fs::path>& changed) {
+        alignas(struct inotify_event) char buffer[64 * 1024];
+        for (;;) {
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n <= 0) {
+                return;
+            }
+            for (char* p = buffer; p < buffer + n;) {
+                auto* event = reinterpret_cast<struct inotify_event*>(p);
+                p += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    changed.insert(roots.begin(), roots.end());
+                    continue;
+                }
+                auto it = watches.find(event->wd);
+                if (it == watches.end()) {
+                    continue;
+                }
+                if (event->mask & IN_IGNORED) {
+                    watches.erase(it);
+                    continue;
+                }
+                const Watch watch = it->second;
+                fs::path path = event->len ? watch.dir / event->name : watch.dir;
+                if (!watch.tree && !fileRoots.count(path)) {
+                    continue;
+                }
+                if (watch.tree && (event->mask & IN_ISDIR) &&
+                    (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+                    addTree(path);
+                }
+                changed.insert(std::move(path));
+            }
+        }
+    }
+};
+
+FileWatcher::FileWatcher(std::vector<fs::path> roots) : roots_(std::move(roots)) {}
+
+FileWatcher::~FileWatcher() = default;
+
+bool FileWatcher::start() {
+    auto state = std::make_unique<State>();
+    state->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (state->fd < 0) {
+        lastError_ = "Cannot initialize inotify";
+        return false;
+    }
+    for (auto& root : roots_) {
+        root = fs::absolute(root).lexically_normal();
+        std::error_code ec;
+        bool ok = fs::is_directory(root, ec)
+            ? state->addTree(root)
+            : state->addWatch(root.parent_path(), false);
+        if (!ok) {
+            lastError_ = "Cannot watch: " + root.string();
+            return false;
+        }
+        if (!fs::is_directory(root, ec)) {
+            state->fileRoots.insert(root);
+        }
+    }
+    state_ = std::move(state);
+    return true;
+}
+
+std::vector<fs::path> FileWatcher::wait(int timeoutMs, int quietMs) {
+    std::set<fs::path> changed;
+    if (!state_) {
+        return {};
+    }
+    struct pollfd pfd = {state_->fd, POLLIN, 0};
+    int timeout = timeoutMs;
+    // The first poll waits for any change, the rest for a quiet period;
+    // a signal ends the wait with whatever was collected
+    while (poll(&pfd, 1, timeout) > 0) {
+        state_->drain(roots_, changed);
+        timeout = quietMs;
+    }
+    return std::vector<fs::path>(changed.begin(), changed.end());
+}
+
+#else
+
+struct FileWatcher::State {
+    struct Stamp {
+        fs::file_time_type mtime;
+        uintmax_t size = 0;
+        bool operator!=(const Stamp& other) const {
+            return mtime != other.mtime || size != other.size;
+        }
+    };
+
+    std::map<fs::path, Stamp> snapshot;
+
+    static std::map<fs::path, Stamp> scan(const std::vector<fs::path>& roots) {
+        std::map<fs::path, Stamp> result;
+        auto add = [&result](const fs::path& path) {
+            std::error_code ec;
+            Stamp stamp;
+            stamp.mtime = fs::last_write_time(path, ec);
+            if (ec) {
+                return;
+            }
+            stamp.size = fs::is_regular_file(path, ec) ? fs::file_size(path, ec) : 0;
+            result[path] = stamp;
+        };
+        for (const auto& root : roots) {
+            add(root);
+            std::error_code ec;
+            for (fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec), end;
+                 !ec && it != end; it.increment(ec)) {
+                add(it->path());
+            }
+        }
+        return result;
+    }
+
+    // Paths added, removed or changed since the last scan
+    void diff(const std::vector<fs::path>& roots, std::set<fs::path>& changed) {
+        auto current = scan(roots);
+        for (const auto& [path, stamp] : current) {
+            auto it = snapshot.find(path);
+            if (it == snapshot.end() || it->second != stamp) {
+                changed.insert(path);
+            }
+        }
+        for (const auto& [path, stamp] : snapshot) {
+            if (!current.count(path)) {
+                changed.insert(path);
+            }
+        }
+        snapshot = std::move(current);
+    }
+};
+
+FileWatcher::FileWatcher(std::vector<fs::path> roots) : roots_(std::move(roots)) {}
+
+FileWatcher::~FileWatcher() = default;
+
+bool FileWatcher::start() {
+    for (auto& root : roots_) {
+        root = fs::absolute(root).lexically_normal();
+    }
+    state_ = std::make_unique<State>();
+    state_->snapshot = State::scan(roots_);
+    return true;
+}
+
+std::vector<fs::path> FileWatcher::wait(int timeoutMs, int quietMs) {
+    using Clock = std::chrono::steady_clock;
+    constexpr auto POLL_INTERVAL = std::chrono::milliseconds(250);
+
+    std::set<fs::path> changed;
+    if (!state_) {
+        return {};
+    }
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (changed.empty() && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::min<Clock::duration>(POLL_INTERVAL, deadline - Clock::now()));
+        state_->diff(roots_, changed);
+    }
+    // Keep collecting until a scan finds nothing new
+    for (size_t before = 0; !changed.empty() && before != changed.size();) {
+        before = changed.size();
+        std::this_thread::sleep_for(std::chrono::milliseconds(quietMs));
+        state_->diff(roots_, changed);
+    }
+    return std::vector<fs::path>(changed.begin(), changed.end());
+}
+
+#endif
+
+std::string FileWatcher::getLastError() {
+    return lastError_;
+}
+
+} // namespace lgx
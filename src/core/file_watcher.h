@@ -0,0 +1,61 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lgx {
+
+/**
+ * FileWatcher reports which files and directories under a set of roots
+ * changed, for `--watch` rebuilds.
+ *
+ * On Linux it uses inotify: every directory under a directory root is
+ * watched (directories created later are picked up as they appear), and a
+ * file root is watched through its parent. Elsewhere it falls back to
+ * polling a size/mtime snapshot of the roots.
+ *
+ * Reported paths are a superset of what changed: a new directory is
+ * reported as a whole, and if the kernel's event queue overflows every
+ * root is reported.
+ */
+class FileWatcher {
+public:
+    explicit FileWatcher(std::vector<std::filesystem::path> roots);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * Start watching.
+     *
+     * @return false if watches could not be set up (see getLastError())
+     */
+    bool start();
+
+    /**
+     * Wait up to timeoutMs for a change, then keep collecting until nothing
+     * has changed for quietMs, so a burst of writes (a compiler emitting
+     * several files, an editor's save) becomes one batch.
+     *
+     * @return Changed paths, sorted and unique; empty on timeout
+     */
+    std::vector<std::filesystem::path> wait(int timeoutMs, int quietMs = 100);
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    struct State;
+
+    std::vector<std::filesystem::path> roots_;
+    std::unique_ptr<State> state_;
+
+    static thread_local std::string lastError_;
+};
+
+} // namespace lgx
@@ -1,8 +1,13 @@
 #include "gzip_handler.h"
+#include "progress.h"
+#include "stats.h"
+#include "trace.h"
 
 #include <zlib.h>
 #include <cstring>
 #include <array>
+#include <algorithm>
+#include <cstdint>
 
 namespace lgx {
 
@@ -27,119 +32,217 @@ size_t GzipHandler::getDefaultMaxDecompressedSize() {
 }
 
 std::vector<uint8_t> GzipHandler::compress(const std::vector<uint8_t>& data) {
-    if (data.empty()) {
-        // Return valid empty gzip for empty input
-        std::vector<uint8_t> result;
-        
-        // Manual gzip header for determinism
-        result.push_back(GZIP_MAGIC1);  // Magic number
-        result.push_back(GZIP_MAGIC2);
-        result.push_back(COMPRESSION_DEFLATE);  // Compression method
-        result.push_back(FLAGS_NONE);   // Flags
-        result.push_back(0); result.push_back(0); result.push_back(0); result.push_back(0);  // mtime = 0
-        result.push_back(0);  // Extra flags
-        result.push_back(OS_UNKNOWN);   // OS
-        
-        // Compress empty data
-        z_stream strm;
-        std::memset(&strm, 0, sizeof(strm));
-        
-        if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
-            lastError_ = "Failed to initialize deflate";
-            return {};
-        }
-        
-        std::array<uint8_t, 32> outBuf;
-        strm.next_in = nullptr;
-        strm.avail_in = 0;
-        strm.next_out = outBuf.data();
-        strm.avail_out = outBuf.size();
-        
-        deflate(&strm, Z_FINISH);
-        result.insert(result.end(), outBuf.begin(), outBuf.begin() + (outBuf.size() - strm.avail_out));
-        
-        deflateEnd(&strm);
-        
-        // CRC32 and size (both 0 for empty input)
-        uint32_t crc = crc32(0L, Z_NULL, 0);
-        result.push_back(crc & 0xFF);
-        result.push_back((crc >> 8) & 0xFF);
-        result.push_back((crc >> 16) & 0xFF);
-        result.push_back((crc >> 24) & 0xFF);
-        result.push_back(0); result.push_back(0); result.push_back(0); result.push_back(0);
-        
-        return result;
-    }
-    
     std::vector<uint8_t> result;
     result.reserve(data.size() + 128);  // Reserve some extra space
-    
+
+    bool ok = compressTo(data.data(), data.size(),
+        [&result](const uint8_t* buffer, size_t size) {
+            result.insert(result.end(), buffer, buffer + size);
+            return true;
+        });
+    if (!ok) {
+        return {};
+    }
+    return result;
+}
+
+bool GzipHandler::compressTo(
+    const uint8_t* data,
+    size_t size,
+    std::function<bool(const uint8_t* buffer, size_t size)> writeCallback
+) {
+    Stats::Timer timer(Stats::Phase::Deflate);
+    Trace::Span span("gzip.deflate");
+    timer.addBytesIn(size);
+
     // Write deterministic gzip header
-    result.push_back(GZIP_MAGIC1);  // Magic number
-    result.push_back(GZIP_MAGIC2);
-    result.push_back(COMPRESSION_DEFLATE);  // Compression method (deflate)
-    result.push_back(FLAGS_NONE);   // Flags (none)
-    // Modification time = 0 (4 bytes, little-endian)
-    result.push_back(0);
-    result.push_back(0);
-    result.push_back(0);
-    result.push_back(0);
-    result.push_back(0);  // Extra flags
-    result.push_back(OS_UNKNOWN);   // OS (unknown for determinism)
-    
+    const uint8_t header[10] = {
+        GZIP_MAGIC1, GZIP_MAGIC2,   // Magic number
+        COMPRESSION_DEFLATE,        // Compression method (deflate)
+        FLAGS_NONE,                 // Flags (none)
+        0, 0, 0, 0,                 // Modification time = 0 (little-endian)
+        0,                          // Extra flags
+        OS_UNKNOWN                  // OS (unknown for determinism)
+    };
+    if (!writeCallback(header, sizeof(header))) {
+        lastError_ = "Write callback failed";
+        return false;
+    }
+
     // Initialize deflate with raw deflate (no zlib header)
     z_stream strm;
     std::memset(&strm, 0, sizeof(strm));
-    
-    int ret = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 
+
+    int ret = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
                           -MAX_WBITS,  // Negative for raw deflate
                           8, Z_DEFAULT_STRATEGY);
     if (ret != Z_OK) {
         lastError_ = "Failed to initialize deflate: " + std::to_string(ret);
-        return {};
+        return false;
     }
-    
-    // Compress data
-    strm.next_in = const_cast<Bytef*>(data.data());
-    strm.avail_in = static_cast<uInt>(data.size());
-    
+
+    // Compress data. The deflate bitstream does not depend on how the output
+    // is chunked, so streaming the output keeps compress() byte-identical.
+    strm.next_in = const_cast<Bytef*>(data);
+    strm.avail_in = static_cast<uInt>(size);
+
     std::array<uint8_t, 32768> outBuf;
-    
+
     do {
         strm.next_out = outBuf.data();
         strm.avail_out = outBuf.size();
-        
+
         ret = deflate(&strm, Z_FINISH);
         if (ret == Z_STREAM_ERROR) {
             deflateEnd(&strm);
             lastError_ = "Deflate stream error";
-            return {};
+            return false;
         }
-        
+
         size_t have = outBuf.size() - strm.avail_out;
-        result.insert(result.end(), outBuf.begin(), outBuf.begin() + have);
+        if (have > 0 && !writeCallback(outBuf.data(), have)) {
+            deflateEnd(&strm);
+            lastError_ = "Write callback failed";
+            return false;
+        }
+        timer.addBytesOut(have);
+
+        if (Progress::isCancelled()) {
+            deflateEnd(&strm);
+            lastError_ = Progress::CANCELLED_ERROR;
+            return false;
+        }
     } while (strm.avail_out == 0);
-    
+
     deflateEnd(&strm);
-    
+
     // Calculate CRC32
     uint32_t crc = crc32(0L, Z_NULL, 0);
-    crc = crc32(crc, data.data(), static_cast<uInt>(data.size()));
-    
-    // Append CRC32 (little-endian)
-    result.push_back(crc & 0xFF);
-    result.push_back((crc >> 8) & 0xFF);
-    result.push_back((crc >> 16) & 0xFF);
-    result.push_back((crc >> 24) & 0xFF);
-    
-    // Append original size (little-endian, mod 2^32)
-    uint32_t size = static_cast<uint32_t>(data.size());
-    result.push_back(size & 0xFF);
-    result.push_back((size >> 8) & 0xFF);
-    result.push_back((size >> 16) & 0xFF);
-    result.push_back((size >> 24) & 0xFF);
-    
-    return result;
+    if (size > 0) {
+        crc = crc32(crc, data, static_cast<uInt>(size));
+    }
+
+    // Append CRC32 and original size (mod 2^32), both little-endian
+    uint32_t isize = static_cast<uint32_t>(size);
+    const uint8_t trailer[8] = {
+        static_cast<uint8_t>(crc & 0xFF),
+        static_cast<uint8_t>((crc >> 8) & 0xFF),
+        static_cast<uint8_t>((crc >> 16) & 0xFF),
+        static_cast<uint8_t>((crc >> 24) & 0xFF),
+        static_cast<uint8_t>(isize & 0xFF),
+        static_cast<uint8_t>((isize >> 8) & 0xFF),
+        static_cast<uint8_t>((isize >> 16) & 0xFF),
+        static_cast<uint8_t>((isize >> 24) & 0xFF)
+    };
+    if (!writeCallback(trailer, sizeof(trailer))) {
+        lastError_ = "Write callback failed";
+        return false;
+    }
+    timer.addBytesOut(sizeof(header) + sizeof(trailer));
+
+    return true;
+}
+
+struct GzipHandler::SegmentCompressor::State {
+    z_stream strm;
+    bool initialized = false;
+};
+
+GzipHandler::SegmentCompressor::SegmentCompressor() : state_(std::make_unique<State>()) {
+    std::memset(&state_->strm, 0, sizeof(state_->strm));
+    state_->initialized = deflateInit2(&state_->strm, SEGMENT_LEVEL, Z_DEFLATED,
+                                       -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+}
+
+GzipHandler::SegmentCompressor::~SegmentCompressor() {
+    if (state_->initialized) {
+        deflateEnd(&state_->strm);
+    }
+}
+
+bool GzipHandler::SegmentCompressor::compress(const uint8_t* data, size_t size, Segment& out) {
+    Stats::Timer timer(Stats::Phase::Deflate);
+    timer.addBytesIn(size);
+
+    if (!state_->initialized) {
+        lastError_ = "Failed to initialize deflate";
+        return false;
+    }
+    z_stream& strm = state_->strm;
+    if (deflateReset(&strm) != Z_OK) {
+        lastError_ = "Failed to reset deflate";
+        return false;
+    }
+
+    out.deflated.clear();
+    out.crc = static_cast<uint32_t>(crc32(crc32(0L, Z_NULL, 0), data, static_cast<uInt>(size)));
+    out.size = size;
+
+    // A sync flush ends the segment on a byte boundary without a final
+    // block, so the next segment can follow it directly
+    strm.next_in = const_cast<Bytef*>(data);
+    strm.avail_in = static_cast<uInt>(size);
+    std::array<uint8_t, 32768> outBuf;
+    do {
+        strm.next_out = outBuf.data();
+        strm.avail_out = outBuf.size();
+        if (deflate(&strm, Z_SYNC_FLUSH) == Z_STREAM_ERROR) {
+            lastError_ = "Deflate stream error";
+            return false;
+        }
+        out.deflated.insert(out.deflated.end(), outBuf.data(),
+                            outBuf.data() + (outBuf.size() - strm.avail_out));
+    } while (strm.avail_out == 0);
+
+    timer.addBytesOut(out.deflated.size());
+    return true;
+}
+
+bool GzipHandler::writeSegments(
+    const std::vector<const Segment*>& segments,
+    std::function<bool(const uint8_t* buffer, size_t size)> writeCallback
+) {
+    Trace::Span span("gzip.write_segments");
+
+    const uint8_t header[10] = {
+        GZIP_MAGIC1, GZIP_MAGIC2, COMPRESSION_DEFLATE, FLAGS_NONE,
+        0, 0, 0, 0, 0, OS_UNKNOWN
+    };
+    if (!writeCallback(header, sizeof(header))) {
+        lastError_ = "Write callback failed";
+        return false;
+    }
+
+    uLong crc = crc32(0L, Z_NULL, 0);
+    uint64_t total = 0;
+    for (const Segment* segment : segments) {
+        if (!segment->deflated.empty() &&
+            !writeCallback(segment->deflated.data(), segment->deflated.size())) {
+            lastError_ = "Write callback failed";
+            return false;
+        }
+        crc = crc32_combine(crc, segment->crc, static_cast<z_off_t>(segment->size));
+        total += segment->size;
+    }
+
+    // Empty final block (fixed Huffman, end-of-block only), then the trailer
+    uint32_t isize = static_cast<uint32_t>(total);
+    const uint8_t trailer[10] = {
+        0x03, 0x00,
+        static_cast<uint8_t>(crc & 0xFF),
+        static_cast<uint8_t>((crc >> 8) & 0xFF),
+        static_cast<uint8_t>((crc >> 16) & 0xFF),
+        static_cast<uint8_t>((crc >> 24) & 0xFF),
+        static_cast<uint8_t>(isize & 0xFF),
+        static_cast<uint8_t>((isize >> 8) & 0xFF),
+        static_cast<uint8_t>((isize >> 16) & 0xFF),
+        static_cast<uint8_t>((isize >> 24) & 0xFF)
+    };
+    if (!writeCallback(trailer, sizeof(trailer))) {
+        lastError_ = "Write callback failed";
+        return false;
+    }
+    return true;
 }
 
 std::vector<uint8_t> GzipHandler::compressStream(
@@ -163,17 +266,33 @@ std::vector<uint8_t> GzipHandler::compressStream(
 std::vector<uint8_t> GzipHandler::decompress(
     const std::vector<uint8_t>& data,
     size_t maxOutputSize
+) {
+    return decompress(data.data(), data.size(), maxOutputSize);
+}
+
+std::vector<uint8_t> GzipHandler::decompress(
+    const uint8_t* data,
+    size_t size,
+    size_t maxOutputSize
 ) {
     if (maxOutputSize == USE_DEFAULT_MAX) {
         maxOutputSize = getDefaultMaxDecompressedSize();
     }
 
-    if (!isGzipData(data)) {
+    if (!isGzipData(data, size)) {
         lastError_ = "Not valid gzip data";
         return {};
     }
 
+    Stats::Timer timer(Stats::Phase::Inflate);
+    Trace::Span span("gzip.inflate");
+    timer.addBytesIn(size);
+
+    // Pre-size the output so a typical package inflates with one allocation
     std::vector<uint8_t> result;
+    size_t hint = decompressedSizeHint(data, size, maxOutputSize);
+    result.reserve(hint);
+    Progress::setBytesTotal(hint);
 
     // Initialize inflate with gzip detection
     z_stream strm;
@@ -185,8 +304,8 @@ std::vector<uint8_t> GzipHandler::decompress(
         return {};
     }
 
-    strm.next_in = const_cast<Bytef*>(data.data());
-    strm.avail_in = static_cast<uInt>(data.size());
+    strm.next_in = const_cast<Bytef*>(data);
+    strm.avail_in = static_cast<uInt>(size);
 
     std::array<uint8_t, 32768> outBuf;
 
@@ -216,6 +335,13 @@ std::vector<uint8_t> GzipHandler::decompress(
         }
 
         result.insert(result.end(), outBuf.begin(), outBuf.begin() + have);
+        Progress::addBytes(have);
+
+        if (Progress::isCancelled()) {
+            inflateEnd(&strm);
+            lastError_ = Progress::CANCELLED_ERROR;
+            return {};
+        }
 
         // Check for truncated data: input exhausted but stream not ended
         if (strm.avail_in == 0 && ret != Z_STREAM_END) {
@@ -226,6 +352,8 @@ std::vector<uint8_t> GzipHandler::decompress(
     } while (ret != Z_STREAM_END);
 
     inflateEnd(&strm);
+    timer.addBytesOut(result.size());
+    Stats::noteBuffer(result.capacity());
     return result;
 }
 
@@ -233,15 +361,29 @@ bool GzipHandler::decompressStream(
     const std::vector<uint8_t>& data,
     std::function<bool(const uint8_t* buffer, size_t size)> writeCallback,
     size_t maxOutputSize
+) {
+    return decompressStream(data.data(), data.size(), std::move(writeCallback), maxOutputSize);
+}
+
+bool GzipHandler::decompressStream(
+    const uint8_t* data,
+    size_t size,
+    std::function<bool(const uint8_t* buffer, size_t size)> writeCallback,
+    size_t maxOutputSize
 ) {
     if (maxOutputSize == USE_DEFAULT_MAX) {
         maxOutputSize = getDefaultMaxDecompressedSize();
     }
 
-    if (!isGzipData(data)) {
+    if (!isGzipData(data, size)) {
         lastError_ = "Not valid gzip data";
         return false;
     }
+    Progress::setBytesTotal(decompressedSizeHint(data, size, maxOutputSize));
+
+    Stats::Timer timer(Stats::Phase::Inflate);
+    Trace::Span span("gzip.inflate");
+    timer.addBytesIn(size);
 
     z_stream strm;
     std::memset(&strm, 0, sizeof(strm));
@@ -252,8 +394,8 @@ bool GzipHandler::decompressStream(
         return false;
     }
 
-    strm.next_in = const_cast<Bytef*>(data.data());
-    strm.avail_in = static_cast<uInt>(data.size());
+    strm.next_in = const_cast<Bytef*>(data);
+    strm.avail_in = static_cast<uInt>(size);
 
     std::array<uint8_t, 32768> outBuf;
     size_t totalOut = 0;
@@ -289,6 +431,13 @@ bool GzipHandler::decompressStream(
                 lastError_ = "Write callback failed";
                 return false;
             }
+            Progress::addBytes(have);
+        }
+
+        if (Progress::isCancelled()) {
+            inflateEnd(&strm);
+            lastError_ = Progress::CANCELLED_ERROR;
+            return false;
         }
 
         // Check for truncated data: input exhausted but stream not ended
@@ -300,12 +449,134 @@ bool GzipHandler::decompressStream(
     } while (ret != Z_STREAM_END);
 
     inflateEnd(&strm);
+    timer.addBytesOut(totalOut);
+    return true;
+}
+
+bool GzipHandler::decompressStream(
+    std::function<size_t(uint8_t* buffer, size_t maxSize)> readCallback,
+    std::function<bool(const uint8_t* buffer, size_t size)> writeCallback,
+    size_t maxOutputSize
+) {
+    if (maxOutputSize == USE_DEFAULT_MAX) {
+        maxOutputSize = getDefaultMaxDecompressedSize();
+    }
+
+    Stats::Timer timer(Stats::Phase::Inflate);
+    Trace::Span span("gzip.inflate");
+
+    z_stream strm;
+    std::memset(&strm, 0, sizeof(strm));
+
+    int ret = inflateInit2(&strm, 16 + MAX_WBITS);
+    if (ret != Z_OK) {
+        lastError_ = "Failed to initialize inflate: " + std::to_string(ret);
+        return false;
+    }
+
+    std::array<uint8_t, 32768> inBuf;
+    std::array<uint8_t, 32768> outBuf;
+    size_t totalIn = 0;
+    size_t totalOut = 0;
+    bool headerChecked = false;
+
+    do {
+        if (strm.avail_in == 0) {
+            size_t got = readCallback(inBuf.data(), inBuf.size());
+            if (got == 0) {
+                inflateEnd(&strm);
+                lastError_ = totalIn == 0 ? "Not valid gzip data" : "Truncated gzip data";
+                return false;
+            }
+            if (!headerChecked) {
+                // Magic bytes arrive in the first read unless the source
+                // hands out single bytes, which no caller does
+                if (!isGzipData(inBuf.data(), got)) {
+                    inflateEnd(&strm);
+                    lastError_ = "Not valid gzip data";
+                    return false;
+                }
+                headerChecked = true;
+            }
+            totalIn += got;
+            strm.next_in = inBuf.data();
+            strm.avail_in = static_cast<uInt>(got);
+        }
+
+        strm.next_out = outBuf.data();
+        strm.avail_out = outBuf.size();
+
+        ret = inflate(&strm, Z_NO_FLUSH);
+
+        if (ret == Z_STREAM_ERROR || ret == Z_NEED_DICT ||
+            ret == Z_DATA_ERROR || ret == Z_MEM_ERROR) {
+            inflateEnd(&strm);
+            lastError_ = "Inflate error: " + std::to_string(ret);
+            return false;
+        }
+
+        size_t have = outBuf.size() - strm.avail_out;
+        if (have > maxOutputSize - totalOut) {
+            inflateEnd(&strm);
+            lastError_ = "Decompressed size exceeds limit of " +
+                         std::to_string(maxOutputSize) + " bytes";
+            return false;
+        }
+        totalOut += have;
+
+        if (have > 0) {
+            if (!writeCallback(outBuf.data(), have)) {
+                inflateEnd(&strm);
+                timer.addBytesIn(totalIn);
+                timer.addBytesOut(totalOut);
+                lastError_ = "Write callback failed";
+                return false;
+            }
+            Progress::addBytes(have);
+        }
+
+        if (Progress::isCancelled()) {
+            inflateEnd(&strm);
+            lastError_ = Progress::CANCELLED_ERROR;
+            return false;
+        }
+    } while (ret != Z_STREAM_END);
+
+    inflateEnd(&strm);
+    timer.addBytesIn(totalIn);
+    timer.addBytesOut(totalOut);
     return true;
 }
 
+size_t GzipHandler::decompressedSizeHint(
+    const uint8_t* data,
+    size_t size,
+    size_t maxOutputSize
+) {
+    if (maxOutputSize == USE_DEFAULT_MAX) {
+        maxOutputSize = getDefaultMaxDecompressedSize();
+    }
+    if (!isGzipData(data, size) || size < 18) {
+        return 0;
+    }
+
+    const uint8_t* t = data + size - 4;
+    size_t isize = static_cast<size_t>(t[0]) |
+                   (static_cast<size_t>(t[1]) << 8) |
+                   (static_cast<size_t>(t[2]) << 16) |
+                   (static_cast<size_t>(t[3]) << 24);
+    // DEFLATE cannot expand input by more than ~1032:1
+    size_t ratioCap = size <= SIZE_MAX / 1032 ? size * 1032 : SIZE_MAX;
+    return std::min({isize, maxOutputSize, ratioCap});
+}
+
 bool GzipHandler::isGzipData(const std::vector<uint8_t>& data) {
-    return data.size() >= 2 && 
-           data[0] == GZIP_MAGIC1 && 
+    return isGzipData(data.data(), data.size());
+}
+
+bool GzipHandler::isGzipData(const uint8_t* data, size_t size) {
+    return size >= 2 &&
+           data[0] == GZIP_MAGIC1 &&
            data[1] == GZIP_MAGIC2;
 }
 
@@ -7,6 +7,7 @@
 #include <optional>
 #include <functional>
 #include <atomic>
+#include <memory>
 
 namespace lgx {
 
@@ -69,6 +70,22 @@ public:
      * @return Compressed data in gzip format, or empty vector on failure
      */
     static std::vector<uint8_t> compress(const std::vector<uint8_t>& data);
+
+    /**
+     * Compress a raw byte range, handing the gzip output to writeCallback in
+     * chunks as it is produced instead of building one output buffer.
+     * Produces exactly the same bytes as compress().
+     *
+     * @param data Input data (may be nullptr when size == 0)
+     * @param size Input size in bytes
+     * @param writeCallback Receives compressed chunks; return false to abort
+     * @return true on success, false on failure or if the callback aborted
+     */
+    static bool compressTo(
+        const uint8_t* data,
+        size_t size,
+        std::function<bool(const uint8_t* buffer, size_t size)> writeCallback
+    );
     
     /**
      * Compress data using deterministic gzip settings with streaming input.
@@ -100,6 +117,16 @@ public:
         size_t maxOutputSize = USE_DEFAULT_MAX
     );
 
+    /**
+     * Decompress gzip data from a raw byte range without copying the input.
+     * Same semantics and output cap as the vector overload.
+     */
+    static std::vector<uint8_t> decompress(
+        const uint8_t* data,
+        size_t size,
+        size_t maxOutputSize = USE_DEFAULT_MAX
+    );
+
     /**
      * Decompress gzip data with streaming output.
      *
@@ -120,11 +147,111 @@ public:
         std::function<bool(const uint8_t* buffer, size_t size)> writeCallback,
         size_t maxOutputSize = USE_DEFAULT_MAX
     );
+
+    /**
+     * Streaming decompression from a raw byte range without copying the
+     * input. Same semantics and output cap as the vector overload.
+     */
+    static bool decompressStream(
+        const uint8_t* data,
+        size_t size,
+        std::function<bool(const uint8_t* buffer, size_t size)> writeCallback,
+        size_t maxOutputSize = USE_DEFAULT_MAX
+    );
+
+    /**
+     * Streaming decompression with streaming input as well, e.g. straight
+     * from a file, so neither side is held in memory. Same output cap as
+     * the other overloads.
+     *
+     * A caller that only needs the start of the stream may return false
+     * from writeCallback to stop early; the rest of the input is then never
+     * read (and its CRC never checked).
+     *
+     * @param readCallback Fills buffer and returns bytes read (0 = EOF)
+     * @param writeCallback Receives decompressed chunks; return false to stop
+     * @return true once the whole stream was inflated, false on failure,
+     *         cap exceeded or when writeCallback stopped
+     */
+    static bool decompressStream(
+        std::function<size_t(uint8_t* buffer, size_t maxSize)> readCallback,
+        std::function<bool(const uint8_t* buffer, size_t size)> writeCallback,
+        size_t maxOutputSize = USE_DEFAULT_MAX
+    );
+
+    /**
+     * Estimate the decompressed size of a gzip stream for pre-sizing output
+     * buffers, from the trailer's ISIZE field (original size mod 2^32).
+     *
+     * ISIZE is attacker-controlled, so the estimate is clamped to
+     * maxOutputSize and to DEFLATE's maximum expansion ratio of the input.
+     *
+     * @return Estimated size in bytes, or 0 if unknown
+     */
+    static size_t decompressedSizeHint(
+        const uint8_t* data,
+        size_t size,
+        size_t maxOutputSize = USE_DEFAULT_MAX
+    );
     
+    /**
+     * One independently compressed piece of a segmented gzip stream: raw
+     * deflate blocks ending on a byte boundary, without a final block.
+     * Segments do not refer back into each other, so any sequence of them
+     * can be joined into a valid stream with writeSegments().
+     */
+    struct Segment {
+        std::vector<uint8_t> deflated;
+        uint32_t crc = 0;    // CRC-32 of the uncompressed bytes
+        uint64_t size = 0;   // uncompressed bytes
+    };
+
+    /**
+     * Compression level for segments: the fastest zlib level.
+     */
+    static constexpr int SEGMENT_LEVEL = 1;
+
+    /**
+     * Compresses segments, reusing one deflate state between them. Use one
+     * per thread.
+     */
+    class SegmentCompressor {
+    public:
+        SegmentCompressor();
+        ~SegmentCompressor();
+        SegmentCompressor(const SegmentCompressor&) = delete;
+        SegmentCompressor& operator=(const SegmentCompressor&) = delete;
+
+        /**
+         * Compress a byte range into `out`.
+         *
+         * @return false if zlib fails (see getLastError())
+         */
+        bool compress(const uint8_t* data, size_t size, Segment& out);
+
+    private:
+        struct State;
+        std::unique_ptr<State> state_;
+    };
+
+    /**
+     * Write segments as one gzip stream: the deterministic header, each
+     * segment's deflate bytes, a final empty block and a trailer whose CRC
+     * is combined from the segments' CRCs. Decompresses to the segments'
+     * inputs concatenated; the compressed bytes differ from compress().
+     *
+     * @return false if writeCallback aborted
+     */
+    static bool writeSegments(
+        const std::vector<const Segment*>& segments,
+        std::function<bool(const uint8_t* buffer, size_t size)> writeCallback
+    );
+
     /**
      * Check if data appears to be gzip compressed (magic bytes check).
      */
     static bool isGzipData(const std::vector<uint8_t>& data);
+    static bool isGzipData(const uint8_t* data, size_t size);
     
     /**
      * Get the last error message (if any operation failed).
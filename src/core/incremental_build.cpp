@@ -0,0 +1,283 @@
+#include "incremental_build.h"
+#include "byte_io.h"
+#include "file_watcher.h"
+#include "path_normalizer.h"
+#include "tar_writer.h"
+#include "trace.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <set>
+#include <thread>
+
+namespace lgx {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Threads compressing tar records; only a full build has many to do
+constexpr size_t MAX_COMPRESS_THREADS = 8;
+
+// Longest FileWatcher::wait(), so `stop` is checked regularly
+constexpr int WATCH_POLL_MS = 500;
+
+fs::path normalizePath(const fs::path& path) {
+    std::error_code ec;
+    fs::path absolute = fs::absolute(path, ec);
+    return (ec ? path : absolute).lexically_normal();
+}
+
+// True if `path` is `prefix` or lies below it
+bool isUnder(const std::string& path, const std::string& prefix) {
+    return path.compare(0, prefix.size(), prefix) == 0 &&
+           (path.size() == prefix.size() || path[prefix.size()] == '/');
+}
+
+} // namespace
+
+IncrementalBuild::IncrementalBuild(Package base, Package::Inputs inputs, fs::path output,
+                                   Package::Durability durability)
+    : base_(std::move(base)), inputs_(std::move(inputs)), output_(normalizePath(output)),
+      durability_(durability) {
+    // Where each input lands in the archive, as Package::addInputs() places
+    // it; a variant given twice is only read from its last input
+    auto addRoot = [this](const fs::path& fsPath, std::string archivePath) {
+        std::error_code ec;
+        if (!fs::is_directory(fsPath, ec)) {
+            archivePath += "/" + fsPath.filename().string();
+        }
+        roots_.push_back({normalizePath(fsPath), std::move(archivePath)});
+    };
+    std::set<std::string> seenVariants;
+    for (auto it = inputs_.variants.rbegin(); it != inputs_.variants.rend(); ++it) {
+        std::string variantLc = PathNormalizer::toLowercase(it->variant);
+        if (seenVariants.insert(variantLc).second) {
+            addRoot(it->filesPath, "variants/" + variantLc);
+        }
+    }
+    for (const auto& path : inputs_.docs) {
+        addRoot(path, "docs");
+    }
+    for (const auto& path : inputs_.licenses) {
+        addRoot(path, "licenses");
+    }
+}
+
+std::vector<fs::path> IncrementalBuild::watchRoots() const {
+    std::vector<fs::path> result;
+    for (const auto& root : roots_) {
+        result.push_back(root.fsPath);
+    }
+    return result;
+}
+
+Package::Result IncrementalBuild::build() {
+    Trace::Span span("incremental_build.build", output_.string());
+    needsFullBuild_ = true;
+    package_ = base_;
+    hashCache_.clear();
+    segments_.clear();
+
+    auto result = package_.addInputs(inputs_, &hashCache_);
+    if (!result.success) {
+        return result;
+    }
+    result = write();
+    if (result.success) {
+        needsFullBuild_ = false;
+    }
+    return result;
+}
+
+Package::Result IncrementalBuild::update(const std::vector<fs::path>& changed) {
+    if (needsFullBuild_) {
+        return build();
+    }
+    Trace::Span span("incremental_build.update", output_.string());
+
+    std::vector<Package::PathChange> changes;
+    for (const auto& path : changed) {
+        fs::path fsPath = normalizePath(path);
+        if (Package::isSaveOutput(fsPath, output_)) {
+            continue;
+        }
+        for (const auto& root : roots_) {
+            fs::path rel = fsPath.lexically_relative(root.fsPath);
+            if (rel.empty() || *rel.begin() == "..") {
+                continue;
+            }
+            if (rel == ".") {
+                std::error_code ec;
+                if (fs::is_directory(root.fsPath, ec) || !fs::exists(root.fsPath, ec)) {
+                    // A directory root as a whole may overlap other inputs
+                    // (docs/, licenses/), and a missing root is an error
+                    return build();
+                }
+                changes.push_back({root.archivePath, fsPath});
+            } else {
+                changes.push_back({root.archivePath + "/" + rel.generic_string(), fsPath});
+            }
+        }
+    }
+    if (changes.empty()) {
+        lastCompressed_ = 0;
+        return Package::Result::ok();
+    }
+
+    // A change inside a changed directory is already covered by it
+    std::sort(changes.begin(), changes.end(),
+        [](const Package::PathChange& a, const Package::PathChange& b) {
+            return a.archivePath < b.archivePath;
+        });
+    std::vector<Package::PathChange> covering;
+    for (auto& change : changes) {
+        if (covering.empty() || !isUnder(change.archivePath, covering.back().archivePath)) {
+            covering.push_back(std::move(change));
+        }
+    }
+
+    auto result = package_.updatePaths(covering, &hashCache_);
+    if (!result.success) {
+        needsFullBuild_ = true;
+        return result;
+    }
+    for (const auto& change : covering) {
+        invalidateSegments(change.archivePath);
+    }
+    return write();
+}
+
+void IncrementalBuild::invalidateSegments(const std::string& archivePath) {
+    auto normalized = PathNormalizer::toNFC(archivePath);
+    const std::string& path = normalized ? *normalized : archivePath;
+    for (auto it = segments_.lower_bound(path);
+         it != segments_.end() && it->first.compare(0, path.size(), path) == 0;) {
+        // Also matches directory records, stored as "dir/"
+        it = isUnder(it->first, path) ? segments_.erase(it) : std::next(it);
+    }
+}
+
+Package::Result IncrementalBuild::write() {
+    Trace::Span span("incremental_build.write", output_.string());
+
+    // Every record of the archive, in tar order
+    std::deque<TarEntry> generated;
+    std::vector<std::pair<std::string, const TarEntry*>> records;
+    for (const TarEntry* entry : package_.archiveEntries(generated)) {
+        records.emplace_back(DeterministicTarWriter::archivePath(*entry), entry);
+    }
+    std::sort(records.begin(), records.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    // The manifest changes with every update; drop segments of records that
+    // are gone, then compress whatever is missing
+    segments_.erase("manifest.json");
+    segments_.erase("manifest.sig");
+    auto record = records.begin();
+    for (auto it = segments_.begin(); it != segments_.end();) {
+        while (record != records.end() && record->first < it->first) {
+            ++record;
+        }
+        bool present = record != records.end() && record->first == it->first;
+        it = present ? std::next(it) : segments_.erase(it);
+    }
+    std::vector<size_t> missing;
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (!segments_.count(records[i].first)) {
+            missing.push_back(i);
+        }
+    }
+
+    std::vector<GzipHandler::Segment> fresh(missing.size());
+    size_t threads = std::min({static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())),
+                               MAX_COMPRESS_THREADS, std::max<size_t>(missing.size(), 1)});
+    std::vector<std::string> errors(threads);
+    auto compressShare = [&](size_t t) {
+        GzipHandler::SegmentCompressor compressor;
+        std::vector<uint8_t> tarRecord;
+        for (size_t k = t; k < missing.size(); k += threads) {
+            tarRecord.clear();
+            try {
+                DeterministicTarWriter::encodeEntry(*records[missing[k]].second, tarRecord);
+            } catch (const std::exception& e) {
+                errors[t] = e.what();
+                return;
+            }
+            if (!compressor.compress(tarRecord.data(), tarRecord.size(), fresh[k])) {
+                errors[t] = "Failed to compress: " + GzipHandler::getLastError();
+                return;
+            }
+        }
+    };
+    if (threads <= 1) {
+        compressShare(0);
+    } else {
+        WorkerPool pool(threads);
+        for (size_t t = 0; t < threads; ++t) {
+            pool.submit([&compressShare, t] { compressShare(t); });
+        }
+    }
+    for (const auto& error : errors) {
+        if (!error.empty()) {
+            return Package::Result::fail(error);
+        }
+    }
+    for (size_t k = 0; k < missing.size(); ++k) {
+        segments_[records[missing[k]].first] = std::move(fresh[k]);
+    }
+    lastCompressed_ = missing.size();
+
+    GzipHandler::Segment endOfArchive;
+    {
+        std::vector<uint8_t> zeros(DeterministicTarWriter::END_OF_ARCHIVE_SIZE, 0);
+        GzipHandler::SegmentCompressor compressor;
+        if (!compressor.compress(zeros.data(), zeros.size(), endOfArchive)) {
+            return Package::Result::fail("Failed to compress: " + GzipHandler::getLastError());
+        }
+    }
+    std::vector<const GzipHandler::Segment*> ordered;
+    ordered.reserve(records.size() + 1);
+    for (const auto& [path, entry] : records) {
+        ordered.push_back(&segments_.at(path));
+    }
+    ordered.push_back(&endOfArchive);
+
+    // Replace the output as Package::save() does, so a reader never sees a
+    // half-written package
+    return Package::replaceFile(output_, [&](ByteSink& sink) {
+        bool written = GzipHandler::writeSegments(ordered,
+            [&sink](const uint8_t* buffer, size_t size) { return sink.write(buffer, size); });
+        return written && sink.finish()
+            ? Package::Result::ok()
+            : Package::Result::fail("Failed to write file: " + output_.string());
+    }, durability_);
+}
+
+Package::Result IncrementalBuild::watch(
+    const std::atomic<bool>& stop,
+    const std::function<void(const Package::Result&, size_t, double)>& onUpdate) {
+    FileWatcher watcher(watchRoots());
+    if (!watcher.start()) {
+        return Package::Result::fail(FileWatcher::getLastError());
+    }
+    while (!stop) {
+        auto changed = watcher.wait(WATCH_POLL_MS);
+        // Our own writes show up when the output is inside an input
+        changed.erase(std::remove_if(changed.begin(), changed.end(),
+            [&](const fs::path& path) { return Package::isSaveOutput(normalizePath(path), output_); }),
+            changed.end());
+        if (changed.empty() || stop) {
+            continue;
+        }
+        auto start = std::chrono::steady_clock::now();
+        auto result = update(changed);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        onUpdate(result, changed.size(), elapsed.count());
+    }
+    return Package::Result::ok();
+}
+
+} // namespace lgx
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "gzip_handler.h"
+#include "package.h"
+#include "crypto/signing.h"
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lgx {
+
+/**
+ * IncrementalBuild keeps a package built from a set of inputs in memory and
+ * rewrites it as the inputs change, for `lgx add --watch` and
+ * `lgx build --watch`.
+ *
+ * After a change only the affected entries are re-read, only their file
+ * digests are recomputed (the Merkle tree is rebuilt from cached leaf
+ * digests), and only their tar records are recompressed. Every record is
+ * compressed on its own as a gzip segment at the fastest level (see
+ * GzipHandler::Segment), so the output file is the cached segments joined
+ * together.
+ *
+ * The result is a valid, deterministic package with the same entries,
+ * manifest and hashes as a full build, but its compressed bytes differ from
+ * `lgx add` / `lgx build` and it is somewhat larger. Run a normal build for
+ * release artifacts.
+ */
+class IncrementalBuild {
+public:
+    /**
+     * @param base Package the inputs are added to (e.g. the loaded package
+     *        for `lgx add`, or a spec's empty package)
+     * @param inputs Variants, docs and licenses, as for Package::addInputs()
+     * @param output Package file to write, replaced as Package::save() does
+     *        (see Package::replaceFile())
+     * @param durability Durable to flush each write before and after the
+     *        rename
+     */
+    IncrementalBuild(Package base, Package::Inputs inputs, std::filesystem::path output,
+                     Package::Durability durability = Package::Durability::Default);
+
+    /**
+     * Read every input and write the package.
+     *
+     * @return Result indicating success or failure
+     */
+    Package::Result build();
+
+    /**
+     * Apply changed filesystem paths and rewrite the package. Paths outside
+     * the inputs are ignored. If the changes cannot be applied (say an input
+     * root was deleted), the next call retries with a full build().
+     *
+     * @param changed Files or directories that were created, modified or
+     *        removed, as reported by FileWatcher
+     * @return Result indicating success or failure
+     */
+    Package::Result update(const std::vector<std::filesystem::path>& changed);
+
+    /**
+     * The filesystem roots of the inputs, for FileWatcher.
+     */
+    std::vector<std::filesystem::path> watchRoots() const;
+
+    /**
+     * The package as last written.
+     */
+    const Package& package() const { return package_; }
+
+    /**
+     * Tar records compressed by the last write (the rest were reused).
+     */
+    size_t lastCompressed() const { return lastCompressed_; }
+
+    /**
+     * Watch the inputs and update() on every change until `stop` is set.
+     * Each update's outcome is passed to onUpdate together with the number
+     * of changed paths and how long the update took.
+     *
+     * @return Result indicating why watching stopped: failure if the
+     *         watcher could not start, otherwise success
+     */
+    Package::Result watch(const std::atomic<bool>& stop,
+                          const std::function<void(const Package::Result&, size_t changedPaths,
+                                                   double seconds)>& onUpdate);
+
+private:
+    // One input root and where it goes in the archive
+    struct Root {
+        std::filesystem::path fsPath;
+        std::string archivePath;
+    };
+
+    Package base_;
+    Package::Inputs inputs_;
+    std::filesystem::path output_;
+    Package::Durability durability_;
+    std::vector<Root> roots_;
+
+    Package package_;
+    bool needsFullBuild_ = true;
+    crypto::FileHashCache hashCache_;
+    std::map<std::string, GzipHandler::Segment> segments_;  // by tar archive path
+    size_t lastCompressed_ = 0;
+
+    Package::Result write();
+    void invalidateSegments(const std::string& archivePath);
+};
+
+} // namespace lgx
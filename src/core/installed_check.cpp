@@ -0,0 +1,158 @@
+#include "installed_check.h"
+#include "installed_state.h"
+#include "path_normalizer.h"
+#include "progress.h"
+#include "trace.h"
+#include "worker_pool.h"
+#include "../crypto/signing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace lgx {
+
+thread_local std::string InstalledCheck::lastError_;
+
+std::optional<std::map<std::string, std::string>> InstalledCheck::hashTree(
+    const std::filesystem::path& root, std::vector<std::string>& others, size_t threads,
+    uint64_t* bytes) {
+    namespace fs = std::filesystem;
+    Trace::Span span("installed.hash_tree", root.string());
+
+    std::error_code ec;
+    if (!fs::is_directory(root, ec)) {
+        lastError_ = "Not a directory: " + root.string();
+        return std::nullopt;
+    }
+
+    std::vector<std::string> paths;
+    for (auto it = fs::recursive_directory_iterator(root, ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        fs::file_status status = it->symlink_status(ec);
+        if (ec) {
+            break;
+        }
+        std::string rel = it->path().lexically_relative(root).generic_string();
+        if (fs::is_regular_file(status)) {
+            paths.push_back(std::move(rel));
+        } else if (!fs::is_directory(status)) {
+            others.push_back(std::move(rel));
+        }
+    }
+    if (ec) {
+        lastError_ = "Cannot read " + root.string() + ": " + ec.message();
+        return std::nullopt;
+    }
+
+    // Each worker streams one file at a time, so memory stays at one read
+    // buffer per thread whatever the size of the tree
+    std::vector<std::string> digests(paths.size());
+    std::vector<std::string> errors(paths.size());
+    std::atomic<size_t> next{0};
+    std::atomic<uint64_t> total{0};
+    auto work = [&]() {
+        for (size_t i = next++; i < paths.size(); i = next++) {
+            if (Progress::isCancelled()) {
+                errors[i] = Progress::CANCELLED_ERROR;
+                continue;
+            }
+            fs::path file = root / paths[i];
+            if (!InstalledState::hashFile(file, digests[i])) {
+                errors[i] = InstalledState::getLastError();
+                continue;
+            }
+            std::error_code sizeEc;
+            total += fs::file_size(file, sizeEc);
+            Progress::addEntries();
+        }
+    };
+    if (threads == 0) {
+        threads = std::min(static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())),
+                           MAX_THREADS);
+    }
+    threads = std::min(threads, paths.size());
+    if (threads <= 1) {
+        work();
+    } else {
+        WorkerPool pool(threads);
+        for (size_t t = 0; t < threads; ++t) {
+            pool.submit(work);
+        }
+    }
+
+    std::map<std::string, std::string> result;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (!errors[i].empty()) {
+            lastError_ = errors[i];
+            return std::nullopt;
+        }
+        result.emplace(std::move(paths[i]), std::move(digests[i]));
+    }
+    if (bytes) {
+        *bytes = total;
+    }
+    return result;
+}
+
+std::optional<InstalledCheck::Report> InstalledCheck::check(
+    const std::filesystem::path& variantDir, const Manifest& manifest, const std::string& variant,
+    size_t threads) {
+    Trace::Span span("installed.check", variant);
+
+    std::string variantLc = PathNormalizer::toLowercase(variant);
+    auto hashIt = manifest.hashes.find("variants/" + variantLc);
+    if (hashIt == manifest.hashes.end() && manifest.main.count(variantLc) == 0) {
+        lastError_ = "Manifest has no variant '" + variantLc + "'";
+        return std::nullopt;
+    }
+
+    Report report;
+    report.expectedHash = hashIt == manifest.hashes.end() ? "" : hashIt->second;
+
+    std::vector<std::string> others;
+    auto digests = hashTree(variantDir, others, threads, &report.bytes);
+    if (!digests) {
+        return std::nullopt;
+    }
+    report.files = digests->size();
+    report.actualHash = crypto::computeLeafHashFromDigests(*digests);
+    report.match = others.empty() && report.actualHash == report.expectedHash;
+    report.unexpected = others;
+    if (report.match) {
+        return report;
+    }
+
+    // Name the files that differ, if an update recorded this exact variant
+    std::filesystem::path dir = variantDir.lexically_normal();
+    if (!dir.has_filename()) {
+        dir = dir.parent_path();  // trailing '/'
+    }
+    auto installed = InstalledState::load(InstalledState::pathFor(dir.parent_path(), variantLc));
+    if (installed && installed->hash == report.expectedHash) {
+        report.localized = true;
+        for (const auto& [path, file] : installed->files) {
+            auto it = digests->find(path);
+            if (it == digests->end()) {
+                if (std::find(others.begin(), others.end(), path) == others.end()) {
+                    report.missing.push_back(path);
+                }
+            } else if (it->second != file.sha256) {
+                report.modified.push_back(path);
+            }
+        }
+        for (const auto& [path, digest] : *digests) {
+            if (installed->files.count(path) == 0) {
+                report.unexpected.push_back(path);
+            }
+        }
+        std::sort(report.unexpected.begin(), report.unexpected.end());
+    }
+    return report;
+}
+
+std::string InstalledCheck::getLastError() {
+    return lastError_;
+}
+
+} // namespace lgx
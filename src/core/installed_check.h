@@ -0,0 +1,83 @@
+#pragma once
+
+#include "manifest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace lgx {
+
+/**
+ * InstalledCheck checks an extracted variant directory against the
+ * manifest it came from, without the .lgx file (`lgx check-installed`).
+ *
+ * The tree's files are hashed in parallel, each streamed in fixed-size
+ * chunks, and the leaf hash is rebuilt with the computeLeafDirectoryHash()
+ * rules for comparison with `manifest.hashes["variants/<variant>"]`. Like
+ * that hash, the check covers file paths and contents, not modes or empty
+ * directories. Anything other than regular files and directories (e.g. a
+ * symlink) fails the check.
+ *
+ * The manifest holds one hash per variant, so it cannot tell which file
+ * differs. If the InstalledState sidecar of an `lgx extract --update`
+ * records the same variant hash, its per-file digests are used to name
+ * the modified, missing and unexpected files.
+ */
+class InstalledCheck {
+public:
+    /**
+     * Threads hashing files; reads are I/O-bound.
+     */
+    static constexpr size_t MAX_THREADS = 8;
+
+    struct Report {
+        bool match = false;
+        std::string expectedHash;  // manifest hashes["variants/<variant>"]
+        std::string actualHash;    // leaf hash of the installed tree
+        size_t files = 0;
+        uint64_t bytes = 0;
+        bool localized = false;    // per-file lists are from the sidecar
+        std::vector<std::string> modified;
+        std::vector<std::string> missing;
+        std::vector<std::string> unexpected;  // extra files, or not regular files
+    };
+
+    /**
+     * Check a variant directory.
+     *
+     * @param variantDir The extracted variant (e.g. <output>/linux-amd64)
+     * @param manifest Manifest of the package it was extracted from
+     * @param variant Variant name (case-insensitive)
+     * @param threads Hashing threads (0: up to MAX_THREADS)
+     * @return Report, or nullopt if the check could not be made (see getLastError())
+     */
+    static std::optional<Report> check(const std::filesystem::path& variantDir,
+                                       const Manifest& manifest, const std::string& variant,
+                                       size_t threads = 0);
+
+    /**
+     * Hash every regular file under `root`: path relative to root -> hex
+     * SHA-256. Paths of entries that are neither regular files nor
+     * directories go to `others`.
+     *
+     * @return Digests, or nullopt if the tree cannot be read
+     */
+    static std::optional<std::map<std::string, std::string>> hashTree(
+        const std::filesystem::path& root, std::vector<std::string>& others, size_t threads = 0,
+        uint64_t* bytes = nullptr);
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    static thread_local std::string lastError_;
+};
+
+} // namespace lgx
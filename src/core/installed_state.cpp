@@ -0,0 +1,163 @@
+#include "installed_state.h"
+#include "stats.h"
+#include "../crypto/signing.h"
+
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace lgx {
+
+thread_local std::string InstalledState::lastError_;
+
+namespace {
+
+// Read size for hashing installed files
+constexpr size_t HASH_CHUNK_SIZE = 256 * 1024;
+
+json fileToJson(const InstalledState::File& file) {
+    json j = {
+        {"size", file.size},
+        {"mode", file.mode},
+        {"sha256", file.sha256},
+    };
+    if (file.stat) {
+        j["stat"] = {file.stat->device, file.stat->inode, file.stat->mtimeNs, file.stat->ctimeNs};
+    }
+    return j;
+}
+
+bool fileFromJson(const json& j, InstalledState::File& file) {
+    if (!j.is_object() || !j.contains("size") || !j["size"].is_number_unsigned() ||
+        !j.contains("sha256") || !j["sha256"].is_string()) {
+        return false;
+    }
+    file.size = j["size"].get<uint64_t>();
+    file.sha256 = j["sha256"].get<std::string>();
+    file.mode = j.value("mode", uint32_t{0});
+    if (j.contains("stat")) {
+        const json& s = j["stat"];
+        if (!s.is_array() || s.size() != 4 || !s[0].is_number_unsigned() ||
+            !s[1].is_number_unsigned() || !s[2].is_number_integer() || !s[3].is_number_integer()) {
+            return false;
+        }
+        DigestCache::Key key;
+        key.device = s[0].get<uint64_t>();
+        key.inode = s[1].get<uint64_t>();
+        key.size = file.size;
+        key.mtimeNs = s[2].get<int64_t>();
+        key.ctimeNs = s[3].get<int64_t>();
+        file.stat = key;
+    }
+    return true;
+}
+
+} // namespace
+
+std::filesystem::path InstalledState::pathFor(const std::filesystem::path& outputDir,
+                                              const std::string& variant) {
+    return outputDir / ("." + variant + ".lgx-installed");
+}
+
+std::optional<InstalledState> InstalledState::load(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    if (!file) {
+        lastError_ = "Cannot open installed state: " + path.string();
+        return std::nullopt;
+    }
+
+    json j = json::parse(file, nullptr, false);
+    if (j.is_discarded() || !j.is_object() || j.value("installedVersion", 0) != FORMAT_VERSION ||
+        !j.contains("files") || !j["files"].is_object()) {
+        lastError_ = "Not a valid installed state file: " + path.string();
+        return std::nullopt;
+    }
+
+    InstalledState state;
+    state.variant = j.value("variant", "");
+    state.hash = j.value("hash", "");
+    for (const auto& [relPath, item] : j["files"].items()) {
+        File entry;
+        if (!fileFromJson(item, entry)) {
+            lastError_ = "Malformed file entry in installed state " + path.string();
+            return std::nullopt;
+        }
+        state.files.emplace(relPath, std::move(entry));
+    }
+    return state;
+}
+
+bool InstalledState::save(const std::filesystem::path& path) const {
+    json fileMap = json::object();
+    for (const auto& [relPath, entry] : files) {
+        fileMap[relPath] = fileToJson(entry);
+    }
+    json j = {
+        {"installedVersion", FORMAT_VERSION},
+        {"variant", variant},
+        {"hash", hash},
+        {"files", fileMap},
+    };
+
+    std::filesystem::path tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::trunc);
+        if (!file) {
+            lastError_ = "Cannot write installed state: " + tmpPath.string();
+            return false;
+        }
+        file << j.dump() << '\n';
+        file.close();
+        if (!file) {
+            lastError_ = "Cannot write installed state: " + tmpPath.string();
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        lastError_ = "Cannot replace installed state " + path.string() + ": " + ec.message();
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool InstalledState::hashFile(const std::filesystem::path& path, std::string& sha256Hex) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        lastError_ = "Cannot open file: " + path.string();
+        return false;
+    }
+
+    Stats::Timer timer(Stats::Phase::Hash);
+    crypto::Sha256 hasher;
+    std::vector<uint8_t> buffer(HASH_CHUNK_SIZE);
+    uint64_t total = 0;
+    while (file) {
+        file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        size_t got = static_cast<size_t>(file.gcount());
+        hasher.update(buffer.data(), got);
+        total += got;
+        timer.addSyscalls();
+    }
+    timer.addBytesIn(total);
+    if (file.bad()) {
+        lastError_ = "Cannot read file: " + path.string();
+        return false;
+    }
+    sha256Hex = hasher.finalHex();
+    return true;
+}
+
+std::string InstalledState::getLastError() {
+    return lastError_;
+}
+
+} // namespace lgx
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "digest_cache.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace lgx {
+
+/**
+ * InstalledState records what `lgx extract --update` last installed for a
+ * variant: the variant's Merkle hash from the manifest and, per file, its
+ * size, mode, SHA-256 and the stat() of the installed copy.
+ *
+ * It is kept in a sidecar file next to the variant directory
+ * (`<output>/.<variant>.lgx-installed`), so it never appears in the
+ * installed tree. A later update trusts a recorded digest only while the
+ * file's stat is unchanged, so files edited since are rehashed. A missing
+ * or damaged sidecar only means every installed file is hashed again.
+ */
+class InstalledState {
+public:
+    /**
+     * Format version written to and required in "installedVersion".
+     */
+    static constexpr int FORMAT_VERSION = 1;
+
+    /**
+     * One installed file.
+     */
+    struct File {
+        uint64_t size = 0;
+        uint32_t mode = 0;        // mode from the package (0: not set)
+        std::string sha256;       // hex SHA-256 of the contents
+        std::optional<DigestCache::Key> stat;  // of the installed copy, if known
+    };
+
+    std::string variant;
+    std::string hash;                    // manifest hashes["variants/<variant>"]
+    std::map<std::string, File> files;   // by path relative to the variant root
+
+    /**
+     * Sidecar path for a variant extracted to outputDir/<variant>/.
+     */
+    static std::filesystem::path pathFor(const std::filesystem::path& outputDir,
+                                         const std::string& variant);
+
+    /**
+     * Read a sidecar.
+     *
+     * @return State, or nullopt if missing, unreadable or malformed
+     */
+    static std::optional<InstalledState> load(const std::filesystem::path& path);
+
+    /**
+     * Write the sidecar (to a temporary file renamed into place).
+     */
+    bool save(const std::filesystem::path& path) const;
+
+    /**
+     * Stream a file through SHA-256.
+     *
+     * @return false if it cannot be read (see getLastError())
+     */
+    static bool hashFile(const std::filesystem::path& path, std::string& sha256Hex);
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    static thread_local std::string lastError_;
+};
+
+} // namespace lgx
@@ -0,0 +1,292 @@
+#include "lockfile.h"
+#include "package.h"
+#include "path_normalizer.h"
+#include "stats.h"
+#include "trace.h"
+#include "../crypto/signing.h"
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <fstream>
+
+using json = nlohmann::json;
+
+namespace lgx {
+
+thread_local std::string Lockfile::lastError_;
+
+namespace {
+
+// Read size for the streaming hash pass
+constexpr size_t HASH_CHUNK_SIZE = 256 * 1024;
+
+// Path of a package relative to the lockfile's directory, '/'-separated
+std::string relativePath(const std::filesystem::path& lgxPath,
+                         const std::filesystem::path& lockDir) {
+    std::error_code ec;
+    auto file = std::filesystem::weakly_canonical(lgxPath, ec);
+    if (ec) file = std::filesystem::absolute(lgxPath);
+    auto dir = std::filesystem::weakly_canonical(lockDir.empty() ? "." : lockDir, ec);
+    if (ec) dir = std::filesystem::absolute(lockDir);
+    auto rel = file.lexically_relative(dir);
+    return (rel.empty() ? file : rel).generic_string();
+}
+
+json entryToJson(const Lockfile::Entry& entry) {
+    return {
+        {"name", entry.name},
+        {"version", entry.version},
+        {"root", entry.rootHash},
+        {"signer", entry.signer.empty() ? json() : json(entry.signer)},
+        {"size", entry.size},
+        {"sha256", entry.sha256},
+        {"path", entry.path},
+    };
+}
+
+bool entryFromJson(const json& j, Lockfile::Entry& entry) {
+    if (!j.is_object() || !j.contains("name") || !j["name"].is_string() ||
+        !j.contains("version") || !j["version"].is_string() ||
+        !j.contains("size") || !j["size"].is_number_unsigned() ||
+        !j.contains("sha256") || !j["sha256"].is_string()) {
+        return false;
+    }
+    entry.name = j["name"].get<std::string>();
+    entry.version = j["version"].get<std::string>();
+    entry.size = j["size"].get<uint64_t>();
+    entry.sha256 = j["sha256"].get<std::string>();
+    entry.rootHash = j.value("root", "");
+    if (j.contains("signer") && j["signer"].is_string()) {
+        entry.signer = j["signer"].get<std::string>();
+    }
+    entry.path = j.value("path", "");
+    return true;
+}
+
+} // namespace
+
+std::optional<Lockfile> Lockfile::load(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    if (!file) {
+        lastError_ = "Cannot open lockfile: " + path.string();
+        return std::nullopt;
+    }
+
+    json j = json::parse(file, nullptr, false);
+    if (j.is_discarded() || !j.is_object()) {
+        lastError_ = "Lockfile is not valid JSON: " + path.string();
+        return std::nullopt;
+    }
+    if (j.value("lockfileVersion", 0) != FORMAT_VERSION) {
+        lastError_ = "Unsupported lockfile version in " + path.string();
+        return std::nullopt;
+    }
+    if (!j.contains("packages") || !j["packages"].is_array()) {
+        lastError_ = "Lockfile has no 'packages' array: " + path.string();
+        return std::nullopt;
+    }
+
+    Lockfile lock;
+    for (const auto& item : j["packages"]) {
+        Entry entry;
+        if (!entryFromJson(item, entry)) {
+            lastError_ = "Malformed package entry in lockfile " + path.string();
+            return std::nullopt;
+        }
+        lock.set(std::move(entry));
+    }
+    return lock;
+}
+
+bool Lockfile::save(const std::filesystem::path& path) const {
+    json packages = json::array();
+    for (const auto& entry : entries_) {
+        packages.push_back(entryToJson(entry));
+    }
+    json j = {{"lockfileVersion", FORMAT_VERSION}, {"packages", packages}};
+
+    std::filesystem::path tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::trunc);
+        if (!file) {
+            lastError_ = "Cannot write lockfile: " + tmpPath.string();
+            return false;
+        }
+        file << j.dump(2) << '\n';
+        file.close();
+        if (!file) {
+            lastError_ = "Cannot write lockfile: " + tmpPath.string();
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        lastError_ = "Cannot replace lockfile " + path.string() + ": " + ec.message();
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+std::optional<Lockfile::Entry> Lockfile::describe(const std::filesystem::path& lgxPath,
+                                                  const std::filesystem::path& lockDir) {
+    Trace::Span span("lockfile.describe", lgxPath.string());
+
+    // Verify and hash the same bytes, so the entry describes exactly what was checked
+    std::ifstream file(lgxPath, std::ios::binary);
+    if (!file) {
+        lastError_ = "Cannot open file: " + lgxPath.string();
+        return std::nullopt;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+
+    auto pkg = Package::loadFromMemory(data.data(), data.size());
+    if (!pkg) {
+        lastError_ = Package::getLastError();
+        return std::nullopt;
+    }
+
+    Entry entry;
+    auto sigInfo = pkg->verifySignature();
+    if (sigInfo.is_signed) {
+        if (!sigInfo.signature_valid || !sigInfo.package_valid) {
+            lastError_ = "Signature verification failed: " + sigInfo.error;
+            return std::nullopt;
+        }
+        entry.signer = sigInfo.signer_did;
+    } else {
+        auto validation = pkg->validatePackage();
+        if (!validation.valid) {
+            lastError_ = "Package validation failed: " +
+                         (validation.errors.empty() ? std::string() : validation.errors.front());
+            return std::nullopt;
+        }
+    }
+
+    const auto& manifest = pkg->getManifest();
+    entry.name = manifest.name;
+    entry.version = manifest.version;
+    auto root = manifest.hashes.find("root");
+    entry.rootHash = root == manifest.hashes.end() ? "" : root->second;
+    entry.size = data.size();
+    entry.sha256 = crypto::sha256Hex(data);
+    entry.path = relativePath(lgxPath, lockDir);
+    return entry;
+}
+
+void Lockfile::set(Entry entry) {
+    std::string key = PathNormalizer::toLowercase(entry.name);
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), key,
+        [](const Entry& e, const std::string& k) { return PathNormalizer::toLowercase(e.name) < k; });
+    if (it != entries_.end() && PathNormalizer::toLowercase(it->name) == key) {
+        *it = std::move(entry);
+    } else {
+        entries_.insert(it, std::move(entry));
+    }
+}
+
+const Lockfile::Entry* Lockfile::find(const std::string& name) const {
+    std::string key = PathNormalizer::toLowercase(name);
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), key,
+        [](const Entry& e, const std::string& k) { return PathNormalizer::toLowercase(e.name) < k; });
+    if (it != entries_.end() && PathNormalizer::toLowercase(it->name) == key) {
+        return &*it;
+    }
+    return nullptr;
+}
+
+const Lockfile::Entry* Lockfile::findByPath(const std::filesystem::path& lgxPath,
+                                            const std::filesystem::path& lockDir) const {
+    std::string rel = relativePath(lgxPath, lockDir);
+    for (const auto& entry : entries_) {
+        if (entry.path == rel) return &entry;
+    }
+    return nullptr;
+}
+
+Lockfile::CheckResult Lockfile::check(const std::filesystem::path& lgxPath,
+                                      const std::filesystem::path& lockDir) const {
+    Trace::Span span("lockfile.check", lgxPath.string());
+    CheckResult result;
+
+    result.entry = findByPath(lgxPath, lockDir);
+    if (!result.entry) {
+        // Not locked from this path: identify it by name (reads only the manifest)
+        auto metadata = Package::readMetadata(lgxPath);
+        if (!metadata) {
+            result.status = Status::Error;
+            result.error = Package::getLastError();
+            return result;
+        }
+        result.entry = find(metadata->manifest.name);
+        if (!result.entry) {
+            result.status = Status::NotLocked;
+            return result;
+        }
+        if (metadata->manifest.version != result.entry->version) {
+            result.status = Status::Mismatch;
+            result.error = "version " + metadata->manifest.version + " is not the locked " +
+                           result.entry->version;
+            return result;
+        }
+    }
+
+    result.status = compareFile(lgxPath, *result.entry, result.error);
+    return result;
+}
+
+Lockfile::Status Lockfile::compareFile(const std::filesystem::path& lgxPath, const Entry& entry,
+                                       std::string& error) {
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(lgxPath, ec);
+    if (ec) {
+        error = "Cannot read " + lgxPath.string() + ": " + ec.message();
+        return Status::Error;
+    }
+    if (size != entry.size) {
+        error = "file size " + std::to_string(size) + " differs from the locked " +
+                std::to_string(entry.size);
+        return Status::Mismatch;
+    }
+
+    std::ifstream file(lgxPath, std::ios::binary);
+    if (!file) {
+        error = "Cannot open file: " + lgxPath.string();
+        return Status::Error;
+    }
+
+    Stats::Timer timer(Stats::Phase::Hash);
+    crypto::Sha256 hasher;
+    std::vector<uint8_t> buffer(HASH_CHUNK_SIZE);
+    uint64_t total = 0;
+    while (file) {
+        file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        size_t got = static_cast<size_t>(file.gcount());
+        hasher.update(buffer.data(), got);
+        total += got;
+        timer.addSyscalls();
+    }
+    timer.addBytesIn(total);
+    if (file.bad() || total != entry.size) {
+        error = "Cannot read " + lgxPath.string() + " (file changed while reading?)";
+        return Status::Error;
+    }
+
+    if (hasher.finalHex() != entry.sha256) {
+        error = "SHA-256 differs from the locked " + entry.sha256;
+        return Status::Mismatch;
+    }
+    return Status::Match;
+}
+
+std::string Lockfile::getLastError() {
+    return lastError_;
+}
+
+} // namespace lgx
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace lgx {
+
+/**
+ * Lockfile pins the exact packages of a deployment: for each package name
+ * the version, Merkle root, signer DID, file size and SHA-256 of the .lgx
+ * file as it was when it was locked.
+ *
+ * A package is locked only after full verification (structure, content
+ * hashes and, if signed, the signature). Checking a package against its
+ * entry afterwards needs one streaming SHA-256 pass over the file: a file
+ * with the same size and digest is byte-for-byte the package that was
+ * verified, so the Merkle tree, signature and manifest need not be checked
+ * again. The file size is compared first, so most mismatches are rejected
+ * without reading the file.
+ *
+ * The file is JSON, sorted by name, so it diffs well under version control.
+ */
+class Lockfile {
+public:
+    /**
+     * Default file name.
+     */
+    static constexpr const char* DEFAULT_FILENAME = "lgx.lock";
+
+    /**
+     * Format version written to and required in "lockfileVersion".
+     */
+    static constexpr int FORMAT_VERSION = 1;
+
+    /**
+     * One pinned package.
+     */
+    struct Entry {
+        std::string name;
+        std::string version;
+        std::string rootHash;   // manifest hashes["root"]
+        std::string signer;     // did:jwk:... of the verified signer, empty if unsigned
+        uint64_t size = 0;      // .lgx file size in bytes
+        std::string sha256;     // hex SHA-256 of the .lgx file
+        std::string path;       // where it was locked from, relative to the lockfile
+    };
+
+    /**
+     * Outcome of check().
+     */
+    enum class Status {
+        Match,      // the file is the locked package
+        Mismatch,   // a lock entry exists but the file differs
+        NotLocked,  // no entry for this package; verify it in full
+        Error       // the file could not be read
+    };
+
+    struct CheckResult {
+        Status status = Status::Error;
+        const Entry* entry = nullptr;  // the entry checked against (Match/Mismatch)
+        std::string error;             // what did not match, or the read error
+    };
+
+    /**
+     * Load a lockfile.
+     *
+     * @return Lockfile, or nullopt if it cannot be read or parsed
+     */
+    static std::optional<Lockfile> load(const std::filesystem::path& path);
+
+    /**
+     * Write the lockfile (to a temporary file renamed into place).
+     */
+    bool save(const std::filesystem::path& path) const;
+
+    /**
+     * Fully verify a package and describe it as a lock entry. Signed
+     * packages must have a valid signature; the keyring is not consulted.
+     *
+     * @param lgxPath Package file
+     * @param lockDir Directory of the lockfile (for the relative path)
+     * @return Entry, or nullopt if the package fails verification
+     */
+    static std::optional<Entry> describe(const std::filesystem::path& lgxPath,
+                                         const std::filesystem::path& lockDir);
+
+    /**
+     * Add an entry, replacing any entry with the same name.
+     */
+    void set(Entry entry);
+
+    /**
+     * Entry for a package name (case-insensitive), or nullptr.
+     */
+    const Entry* find(const std::string& name) const;
+
+    /**
+     * Entry locked from a path (relative to lockDir), or nullptr.
+     */
+    const Entry* findByPath(const std::filesystem::path& lgxPath,
+                            const std::filesystem::path& lockDir) const;
+
+    /**
+     * Check a package file against the lock.
+     *
+     * The entry is found by the path the package was locked from, else by
+     * the package name read from its manifest. Never validates the package
+     * itself: NotLocked means the caller must.
+     */
+    CheckResult check(const std::filesystem::path& lgxPath,
+                      const std::filesystem::path& lockDir) const;
+
+    /**
+     * Compare a file's size and SHA-256 with an entry in one streaming pass.
+     *
+     * @return Match, Mismatch or Error; error says what differs or failed
+     */
+    static Status compareFile(const std::filesystem::path& lgxPath, const Entry& entry,
+                              std::string& error);
+
+    const std::vector<Entry>& entries() const { return entries_; }
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    std::vector<Entry> entries_;  // sorted by name
+
+    static thread_local std::string lastError_;
+};
+
+} // namespace lgx
@@ -0,0 +1,148 @@
+#include "memory.h"
+#include "stats.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace lgx {
+
+namespace {
+
+void* defaultAllocate(size_t size, void*) {
+    return std::malloc(size);
+}
+
+void* defaultReallocate(void* ptr, size_t size, void*) {
+    return std::realloc(ptr, size);
+}
+
+void defaultRelease(void* ptr, void*) {
+    std::free(ptr);
+}
+
+} // anonymous namespace
+
+Memory::Hooks Memory::hooks_ = {defaultAllocate, defaultReallocate, defaultRelease, nullptr};
+
+bool Memory::setHooks(const Hooks* hooks) {
+    if (!hooks) {
+        hooks_ = {defaultAllocate, defaultReallocate, defaultRelease, nullptr};
+        return true;
+    }
+    if (!hooks->allocate || !hooks->reallocate || !hooks->release) {
+        return false;
+    }
+    hooks_ = *hooks;
+    return true;
+}
+
+Memory::Hooks Memory::getHooks() {
+    return hooks_;
+}
+
+void* Memory::allocate(size_t size) {
+    return hooks_.allocate(size, hooks_.userData);
+}
+
+void* Memory::reallocate(void* ptr, size_t size) {
+    return hooks_.reallocate(ptr, size, hooks_.userData);
+}
+
+void Memory::release(void* ptr) {
+    if (ptr) {
+        hooks_.release(ptr, hooks_.userData);
+    }
+}
+
+ScratchBuffer::~ScratchBuffer() {
+    freeStorage();
+}
+
+bool ScratchBuffer::reserve(size_t capacity) {
+    if (capacity <= capacity_) {
+        return true;
+    }
+
+    if (!data_) {
+        hooks_ = Memory::getHooks();
+    }
+    // Grow through the hooks that own the current block, even if new hooks
+    // were installed since
+    void* grown = hooks_.reallocate(data_, capacity, hooks_.userData);
+    if (!grown) {
+        return false;
+    }
+    data_ = static_cast<uint8_t*>(grown);
+    capacity_ = capacity;
+    return true;
+}
+
+bool ScratchBuffer::write(const uint8_t* data, size_t size) {
+    uint8_t* dest = append(size);
+    if (!dest) {
+        return false;
+    }
+    if (size > 0) {
+        std::memcpy(dest, data, size);
+    }
+    return true;
+}
+
+uint8_t* ScratchBuffer::append(size_t size) {
+    if (size > capacity_ - size_) {
+        size_t needed = size_ + size;
+        if (needed < size_ || !reserve(std::max(needed, capacity_ * 2))) {
+            return nullptr;
+        }
+    }
+    if (!data_ && !reserve(1)) {
+        return nullptr;
+    }
+    uint8_t* dest = data_ + size_;
+    size_ += size;
+    Stats::noteBuffer(size_);
+    return dest;
+}
+
+void ScratchBuffer::trim(size_t maxRetained) {
+    if (capacity_ > maxRetained) {
+        freeStorage();
+    }
+}
+
+void ScratchBuffer::freeStorage() {
+    if (data_) {
+        hooks_.release(data_, hooks_.userData);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
+}
+
+thread_local ScratchBuffer ScratchLease::threadBuffers_[ScratchLease::THREAD_BUFFERS];
+thread_local bool ScratchLease::threadBuffersLeased_[ScratchLease::THREAD_BUFFERS] = {};
+
+ScratchLease::ScratchLease() : buffer_(nullptr), slot_(-1) {
+    for (size_t i = 0; i < THREAD_BUFFERS; ++i) {
+        if (!threadBuffersLeased_[i]) {
+            threadBuffersLeased_[i] = true;
+            buffer_ = &threadBuffers_[i];
+            slot_ = static_cast<int>(i);
+            return;
+        }
+    }
+    buffer_ = new ScratchBuffer();
+}
+
+ScratchLease::~ScratchLease() {
+    if (slot_ < 0) {
+        delete buffer_;
+        return;
+    }
+    buffer_->clear();
+    buffer_->trim(ScratchBuffer::RETAIN_LIMIT);
+    threadBuffersLeased_[slot_] = false;
+}
+
+} // namespace lgx
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "byte_io.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lgx {
+
+/**
+ * Memory routes the library's raw allocations (buffers handed to C API
+ * callers and the large per-operation scratch buffers) through replaceable
+ * hooks, so an embedding host can account for them or serve them from its
+ * own heap.
+ *
+ * Hooks must be installed before the library is used, or while none of the
+ * memory it handed out is still live: memory must be freed by the same hooks
+ * that allocated it.
+ */
+class Memory {
+public:
+    /**
+     * Allocation hooks. All three functions are required.
+     */
+    struct Hooks {
+        void* (*allocate)(size_t size, void* userData);
+        void* (*reallocate)(void* ptr, size_t size, void* userData);
+        void (*release)(void* ptr, void* userData);
+        void* userData;
+    };
+
+    /**
+     * Install hooks, or restore malloc/realloc/free with nullptr.
+     *
+     * @return false (leaving the current hooks in place) if any function is missing
+     */
+    static bool setHooks(const Hooks* hooks);
+
+    /**
+     * The hooks currently in use.
+     */
+    static Hooks getHooks();
+
+    static void* allocate(size_t size);
+    static void* reallocate(void* ptr, size_t size);
+    static void release(void* ptr);
+
+private:
+    static Hooks hooks_;
+};
+
+/**
+ * ScratchBuffer is a growable byte buffer allocated through Memory hooks,
+ * used for large transient data such as a package's uncompressed tar stream.
+ *
+ * Each thread owns a few buffers that operations lease with ScratchLease.
+ * A buffer is cleared when its lease ends, and its storage is kept for the
+ * next operation on that thread. Storage above RETAIN_LIMIT is freed
+ * instead, so one huge package does not pin its peak size. Repeated loads
+ * and saves therefore reuse the same blocks instead of churning large
+ * allocations through the heap.
+ */
+class ScratchBuffer : public ByteSink {
+public:
+    /**
+     * Largest capacity kept between operations.
+     */
+    static constexpr size_t RETAIN_LIMIT = 64 * 1024 * 1024;
+
+    ScratchBuffer() = default;
+    ~ScratchBuffer() override;
+
+    ScratchBuffer(const ScratchBuffer&) = delete;
+    ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * Ensure room for at least `capacity` bytes in total.
+     */
+    bool reserve(size_t capacity);
+
+    bool write(const uint8_t* data, size_t size) override;
+
+    /**
+     * Extend the contents by `size` uninitialized bytes to be filled in
+     * place (e.g. by a file read).
+     *
+     * @return Pointer to the new bytes, or nullptr if allocation failed
+     */
+    uint8_t* append(size_t size);
+
+    void sizeHint(size_t size) override { reserve(size_ + size); }
+
+    /**
+     * Drop the contents, keeping the storage.
+     */
+    void clear() { size_ = 0; }
+
+    /**
+     * Free the storage if it is larger than maxRetained bytes.
+     */
+    void trim(size_t maxRetained);
+
+private:
+    void freeStorage();
+
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    Memory::Hooks hooks_{};  // hooks that allocated data_
+};
+
+/**
+ * Exclusive use of one of the current thread's scratch buffers for the
+ * duration of an operation (e.g. the compressed input and the tar stream of
+ * a load). If all of the thread's buffers are leased, a private buffer is
+ * used instead.
+ */
+class ScratchLease {
+public:
+    ScratchLease();
+    ~ScratchLease();
+
+    ScratchLease(const ScratchLease&) = delete;
+    ScratchLease& operator=(const ScratchLease&) = delete;
+
+    ScratchBuffer& buffer() { return *buffer_; }
+
+private:
+    static constexpr size_t THREAD_BUFFERS = 2;
+
+    ScratchBuffer* buffer_;
+    int slot_;  // index into the thread's buffers, or -1 for a private buffer
+
+    static thread_local ScratchBuffer threadBuffers_[THREAD_BUFFERS];
+    static thread_local bool threadBuffersLeased_[THREAD_BUFFERS];
+};
+
+} // namespace lgx
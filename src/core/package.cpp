@@ -1,15 +1,146 @@
 #include "package.h"
+#include "durable_io.h"
 #include "gzip_handler.h"
 #include "path_normalizer.h"
+#include "memory.h"
+#include "progress.h"
+#include "stats.h"
+#include "trace.h"
+#include "worker_pool.h"
 
 #include <fstream>
 #include <algorithm>
+#include <cerrno>
+#include <deque>
+#include <iterator>
+#include <map>
+#include <random>
+#include <thread>
 #include <unordered_set>
 
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace lgx {
 
 thread_local std::string Package::lastError_;
 
+namespace {
+const char* const WRITE_FAILED_ERROR = "Failed to write package data";
+
+// Upper bound on manifest.json / manifest.sig read by readMetadata()
+constexpr uint64_t MAX_METADATA_FILE_SIZE = 16 * 1024 * 1024;
+
+// manifest.json and manifest.sig may each appear once. A second copy is
+// rejected, so no reader can keep the first while another keeps the last
+struct MetadataEntries {
+    bool manifest = false;
+    bool signature = false;
+
+    // False if `path` (one of the two) was seen before
+    bool note(const std::string& path) {
+        bool& seen = path == "manifest.json" ? manifest : signature;
+        bool first = !seen;
+        seen = true;
+        return first;
+    }
+};
+
+// Threads reading addInputs() inputs; reads are I/O-bound
+constexpr size_t MAX_INPUT_READ_THREADS = 8;
+
+// Suffix of the staging directory updateVariant() writes changed files to
+const char* const UPDATE_STAGING_SUFFIX = ".lgx-staging";
+
+// The file save() should replace: `path` itself, or what its symlinks
+// lead to (a dangling link's target included), so the link survives
+std::filesystem::path resolveSaveTarget(const std::filesystem::path& path) {
+    namespace fs = std::filesystem;
+    fs::path target = path;
+    std::error_code ec;
+    for (int hops = 0; hops < 40 && fs::is_symlink(target, ec); ++hops) {
+        fs::path link = fs::read_symlink(target, ec);
+        if (ec) {
+            break;
+        }
+        target = link.is_absolute() ? link : target.parent_path() / link;
+    }
+    return target;
+}
+
+// Create an empty file next to `target` under a fresh name (exclusive
+// create, like mkstemp), for save() to fill and rename over target. The
+// mode is the usual default for new files.
+std::optional<std::filesystem::path> createTempBeside(const std::filesystem::path& target) {
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        std::filesystem::path tmpPath = target;
+        tmpPath += ".tmp." + std::to_string(std::random_device{}());
+#ifdef _WIN32
+        int fd = ::_wopen(tmpPath.c_str(), _O_CREAT | _O_EXCL | _O_WRONLY | _O_BINARY,
+                          _S_IREAD | _S_IWRITE);
+        if (fd >= 0) {
+            ::_close(fd);
+            return tmpPath;
+        }
+#else
+        int fd = ::open(tmpPath.c_str(), O_CREAT | O_EXCL | O_WRONLY | O_CLOEXEC, 0666);
+        if (fd >= 0) {
+            ::close(fd);
+            return tmpPath;
+        }
+#endif
+        if (errno != EEXIST) {
+            break;
+        }
+    }
+    return std::nullopt;
+}
+
+// Why `entry` must not be written to canonRoot/relativePath (fullPath being
+// the same target as the caller spells it), or "" if it is safe.
+std::string unsafeTargetError(const TarEntry& entry, const std::string& relativePath,
+                              const std::filesystem::path& canonRoot,
+                              const std::filesystem::path& fullPath) {
+    namespace fs = std::filesystem;
+
+    // Zip-slip defense. Package::load() stores tar entry paths verbatim and
+    // never runs validateArchivePath() on the load->extract path, so a
+    // crafted .lgx can carry a "variants/<v>/../../.." entry that satisfies
+    // the variant prefix test. Reject any entry the archive validator would
+    // reject (absolute paths, ".." segments, backslashes, non-NFC) before
+    // touching the filesystem.
+    auto pathValidation = PathNormalizer::validateArchivePath(entry.path);
+    if (!pathValidation.valid) {
+        return "Refusing to extract unsafe archive path '" + entry.path + "': " +
+               pathValidation.error;
+    }
+
+    // Defense in depth: the normalized target must stay under canonRoot.
+    // Guards against escapes that the per-entry check might miss (e.g. via
+    // already-resolved separators) without depending on the file existing.
+    //
+    // canonFull is built by joining relativePath onto canonRoot (not from
+    // fullPath directly) so both sides of the comparison always share the
+    // same base. canonRoot is absolute when weakly_canonical succeeds but
+    // fullPath stays relative when outputDir is relative (e.g. the CLI's
+    // default "."); comparing an absolute base against a relative target
+    // makes lexically_relative() return empty and false-rejects every
+    // benign entry. Anchoring to canonRoot keeps them consistent.
+    fs::path canonFull = (canonRoot / relativePath).lexically_normal();
+    fs::path rel = canonFull.lexically_relative(canonRoot);
+    if (rel.empty() || *rel.begin() == "..") {
+        return "Path escapes output directory: " + fullPath.string();
+    }
+    return "";
+}
+}
+
 const std::set<std::string> Package::ALLOWED_ROOT_ENTRIES = {
     "manifest.json",
     "manifest.sig",
@@ -22,6 +153,10 @@ Package::Result Package::create(
     const std::filesystem::path& outputPath,
     const std::string& name
 ) {
+    return skeleton(name).save(outputPath);
+}
+
+Package Package::skeleton(const std::string& name) {
     Package pkg;
     
     // Set up manifest with default values
@@ -43,32 +178,149 @@ Package::Result Package::create(
     variantsDir.isDirectory = true;
     pkg.entries_.push_back(variantsDir);
     
-    return pkg.save(outputPath);
+    return pkg;
 }
 
 std::optional<Package> Package::load(const std::filesystem::path& lgxPath) {
+    Trace::Span span("package.load", lgxPath.string());
+
     // Read file
+    FileByteSource source(lgxPath);
+    if (!source.isOpen()) {
+        lastError_ = "Cannot open file: " + lgxPath.string();
+        return std::nullopt;
+    }
+
+    return load(source);
+}
+
+std::optional<Package> Package::loadFromMemory(const void* data, size_t size) {
+    if (!data && size > 0) {
+        lastError_ = "Invalid buffer: data is NULL";
+        return std::nullopt;
+    }
+    return load(MemoryByteSource(data, size));
+}
+
+std::optional<Package> Package::load(const std::filesystem::path& lgxPath, const EntryFilter& keep) {
+    return loadStreamed(lgxPath, keep, false);
+}
+
+std::optional<Package> Package::loadStreamed(const std::filesystem::path& lgxPath,
+                                             const EntryFilter& keep, bool listSkipped) {
+    Trace::Span span("package.load_filtered", lgxPath.string());
+
     std::ifstream file(lgxPath, std::ios::binary);
     if (!file) {
         lastError_ = "Cannot open file: " + lgxPath.string();
         return std::nullopt;
     }
-    
-    std::vector<uint8_t> gzipData(
-        (std::istreambuf_iterator<char>(file)),
-        std::istreambuf_iterator<char>()
-    );
-    file.close();
-    
-    // Decompress
-    auto tarData = GzipHandler::decompress(gzipData);
-    if (tarData.empty() && !gzipData.empty()) {
+
+    Package pkg;
+    std::optional<std::string> manifestJson;
+    MetadataEntries metadataEntries;
+    std::string duplicate;
+    auto isMetadata = [](const std::string& path) {
+        return path == "manifest.json" || path == "manifest.sig";
+    };
+    TarReader::StreamParser parser(
+        [&](const TarReader::EntryInfo& info) {
+            return isMetadata(info.path) || keep(info.path, false);
+        },
+        [&](const TarReader::EntryInfo& info, std::vector<uint8_t>& data) {
+            if (isMetadata(info.path) && !info.isDirectory && !metadataEntries.note(info.path)) {
+                duplicate = info.path;
+                return false;
+            }
+            if (info.path == "manifest.json" && !info.isDirectory) {
+                manifestJson.emplace(data.begin(), data.end());
+            } else if (info.path == "manifest.sig" && !info.isDirectory) {
+                std::string sigStr(data.begin(), data.end());
+                pkg.manifestSig_ = crypto::ManifestSig::fromJson(sigStr);
+                pkg.manifestSigParseError_ = !pkg.manifestSig_;
+            } else {
+                // Files with data arrive with it only if selected; the
+                // filter is asked here about the rest
+                bool selected = info.isDirectory ? keep(info.path, true)
+                              : info.isRegularFile && info.size > 0 ? !data.empty()
+                              : keep(info.path, false);
+                if (!selected && !listSkipped) {
+                    return true;
+                }
+            }
+            TarEntry entry(info.path, info.isDirectory, info.mode);
+            entry.data = std::move(data);
+            pkg.entries_.push_back(std::move(entry));
+            Progress::addEntries();
+            return !Progress::isCancelled();
+        });
+
+    // Inflate to the end so the gzip trailer is still checked
+    bool inflated = GzipHandler::decompressStream(
+        [&file](uint8_t* buffer, size_t maxSize) -> size_t {
+            file.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(maxSize));
+            return static_cast<size_t>(file.gcount());
+        },
+        [&parser](const uint8_t* buffer, size_t size) {
+            return parser.feed(buffer, size) || parser.ended();
+        });
+
+    if (Progress::isCancelled()) {
+        lastError_ = Progress::CANCELLED_ERROR;
+        return std::nullopt;
+    }
+    if (!duplicate.empty()) {
+        lastError_ = "Duplicate " + duplicate + " in package";
+        return std::nullopt;
+    }
+    if (!parser.error().empty()) {
+        lastError_ = "Failed to read tar: " + parser.error();
+        return std::nullopt;
+    }
+    if (!inflated) {
+        lastError_ = "Failed to decompress: " + GzipHandler::getLastError();
+        return std::nullopt;
+    }
+    if (manifestJson) {
+        auto manifestOpt = Manifest::fromJson(*manifestJson);
+        if (!manifestOpt) {
+            lastError_ = "Failed to parse manifest: " + Manifest::getLastError();
+            return std::nullopt;
+        }
+        pkg.manifest_ = std::move(*manifestOpt);
+    }
+    return pkg;
+}
+
+std::optional<Package> Package::load(const ByteSource& source) {
+    Trace::Span span("package.decode");
+
+    // Decompress directly from the source's memory into a reusable scratch
+    // buffer; only the decoded entries outlive this call. Output past the
+    // tar end-of-archive marker is still inflated (so the gzip trailer is
+    // checked) but not kept, so padding cannot inflate memory use.
+    ScratchLease lease;
+    ScratchBuffer& tarData = lease.buffer();
+    tarData.sizeHint(GzipHandler::decompressedSizeHint(source.data(), source.size()));
+    TarReader::EndScanner endScanner;
+    bool decompressed = GzipHandler::decompressStream(source.data(), source.size(),
+        [&tarData, &endScanner](const uint8_t* buffer, size_t size) {
+            if (endScanner.ended()) {
+                return true;
+            }
+            if (!tarData.write(buffer, size)) {
+                return false;
+            }
+            endScanner.scan(tarData.data(), tarData.size());
+            return true;
+        });
+    if (!decompressed && source.size() != 0) {
         lastError_ = "Failed to decompress: " + GzipHandler::getLastError();
         return std::nullopt;
     }
     
     // Read tar
-    auto readResult = TarReader::read(tarData);
+    auto readResult = TarReader::read(tarData.data(), tarData.size());
     if (!readResult.success) {
         lastError_ = "Failed to read tar: " + readResult.error;
         return std::nullopt;
@@ -78,7 +330,13 @@ std::optional<Package> Package::load(const std::filesystem::path& lgxPath) {
     pkg.entries_ = std::move(readResult.entries);
     
     // Find and parse manifest and signature
+    MetadataEntries metadataEntries;
     for (const auto& entry : pkg.entries_) {
+        if ((entry.path == "manifest.json" || entry.path == "manifest.sig") && !entry.isDirectory &&
+            !metadataEntries.note(entry.path)) {
+            lastError_ = "Duplicate " + entry.path + " in package";
+            return std::nullopt;
+        }
         if (entry.path == "manifest.json" && !entry.isDirectory) {
             std::string jsonStr(entry.data.begin(), entry.data.end());
             auto manifestOpt = Manifest::fromJson(jsonStr);
@@ -103,17 +361,226 @@ std::optional<Package> Package::load(const std::filesystem::path& lgxPath) {
     return pkg;
 }
 
-Package::Result Package::save(const std::filesystem::path& lgxPath) const {
+std::optional<Package::Metadata> Package::readMetadata(const std::filesystem::path& lgxPath) {
+    Trace::Span span("package.read_metadata", lgxPath.string());
+
+    std::ifstream file(lgxPath, std::ios::binary);
+    if (!file) {
+        lastError_ = "Cannot open file: " + lgxPath.string();
+        return std::nullopt;
+    }
+
+    std::optional<std::string> manifestJson;
+    std::optional<std::string> sigJson;
+    bool passedMetadata = false;
+    MetadataEntries metadataEntries;
+    std::string duplicate;
+
+    // Archive order is sorted by path: docs/, licenses/, manifest.json,
+    // manifest.sig, variants/. Anything sorting after manifest.sig means
+    // both have gone by.
+    TarReader::StreamParser parser(
+        [](const TarReader::EntryInfo& info) {
+            return (info.path == "manifest.json" || info.path == "manifest.sig") &&
+                   info.size <= MAX_METADATA_FILE_SIZE;
+        },
+        [&](const TarReader::EntryInfo& info, std::vector<uint8_t>& data) {
+            if ((info.path == "manifest.json" || info.path == "manifest.sig") && !info.isDirectory &&
+                !metadataEntries.note(info.path)) {
+                duplicate = info.path;
+                return false;
+            }
+            if (info.path == "manifest.json" && info.isRegularFile) {
+                manifestJson.emplace(data.begin(), data.end());
+            } else if (info.path == "manifest.sig" && info.isRegularFile) {
+                sigJson.emplace(data.begin(), data.end());
+                passedMetadata = true;
+            } else if (info.path > "manifest.sig") {
+                passedMetadata = true;
+            }
+            return !passedMetadata;
+        });
+
+    bool inflated = GzipHandler::decompressStream(
+        [&file](uint8_t* buffer, size_t maxSize) -> size_t {
+            file.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(maxSize));
+            return static_cast<size_t>(file.gcount());
+        },
+        [&parser](const uint8_t* buffer, size_t size) {
+            return parser.feed(buffer, size);
+        });
+
+    if (!duplicate.empty()) {
+        lastError_ = "Duplicate " + duplicate + " in package";
+        return std::nullopt;
+    }
+    if (!parser.error().empty()) {
+        lastError_ = "Failed to read tar: " + parser.error();
+        return std::nullopt;
+    }
+    if (!inflated && !passedMetadata && !parser.ended()) {
+        lastError_ = "Failed to decompress: " + GzipHandler::getLastError();
+        return std::nullopt;
+    }
+
+    Metadata metadata;
+    if (!manifestJson || !(passedMetadata || parser.ended())) {
+        // Not in canonical order (or no manifest at all): take the slow path
+        auto pkgOpt = load(lgxPath);
+        if (!pkgOpt) {
+            return std::nullopt;
+        }
+        metadata.manifest = std::move(pkgOpt->manifest_);
+        metadata.signature = std::move(pkgOpt->manifestSig_);
+        return metadata;
+    }
+
+    auto manifestOpt = Manifest::fromJson(*manifestJson);
+    if (!manifestOpt) {
+        lastError_ = "Failed to parse manifest: " + Manifest::getLastError();
+        return std::nullopt;
+    }
+    metadata.manifest = std::move(*manifestOpt);
+    if (sigJson) {
+        metadata.signature = crypto::ManifestSig::fromJson(*sigJson);
+    }
+    return metadata;
+}
+
+Package::Result Package::save(const std::filesystem::path& lgxPath, Durability durability) const {
+    Trace::Span span("package.save", lgxPath.string());
+    return replaceFile(lgxPath, [this](ByteSink& sink) { return save(sink); }, durability);
+}
+
+Package::Result Package::replaceFile(const std::filesystem::path& path,
+                                     const std::function<Result(ByteSink&)>& write,
+                                     Durability durability) {
+    namespace fs = std::filesystem;
+
+    // Write a private temporary file beside the real target and rename it
+    // over the target, so a crash or failure never leaves a truncated
+    // file behind and concurrent writers do not share a temporary file
+    fs::path target = resolveSaveTarget(path);
+    auto tmp = createTempBeside(target);
+    if (!tmp) {
+        return Result::fail("Cannot write file: " + path.string());
+    }
+    const fs::path& tmpPath = *tmp;
+
+    std::error_code ec;
+    Result result = Result::ok();
+    {
+        FileByteSink sink(tmpPath);
+        result = write(sink);
+        if (!result.success && sink.openFailed()) {
+            result = Result::fail("Cannot write file: " + path.string());
+        } else if (!result.success && result.error == WRITE_FAILED_ERROR) {
+            result = Result::fail("Failed to write file: " + path.string());
+        }
+    }
+
+    // A replaced file keeps its permissions
+    fs::file_status existing = fs::status(target, ec);
+    if (result.success && !ec && fs::is_regular_file(existing)) {
+        fs::permissions(tmpPath, existing.permissions(), ec);
+        if (ec) {
+            result = Result::fail("Cannot set permissions of " + path.string() + ": " +
+                                  ec.message());
+        }
+    }
+    if (result.success && durability == Durability::Durable && !DurableIo::syncFile(tmpPath)) {
+        result = Result::fail("Failed to write file: " + path.string() + " - " +
+                              DurableIo::getLastError());
+    }
+    if (!result.success) {
+        fs::remove(tmpPath, ec);
+        return result;
+    }
+
+    fs::rename(tmpPath, target, ec);
+    if (ec) {
+        std::error_code ignored;
+        fs::remove(tmpPath, ignored);
+        return Result::fail("Cannot replace " + path.string() + ": " + ec.message());
+    }
+    if (durability == Durability::Durable && !DurableIo::syncDirectory(target.parent_path())) {
+        return Result::fail("Saved " + path.string() + " but could not flush its directory: " +
+                            DurableIo::getLastError());
+    }
+    return result;
+}
+
+bool Package::isSaveOutput(const std::filesystem::path& path, const std::filesystem::path& lgxPath) {
+    namespace fs = std::filesystem;
+    fs::path target = resolveSaveTarget(lgxPath).lexically_normal();
+    fs::path candidate = path.lexically_normal();
+    if (candidate == target || candidate == lgxPath.lexically_normal()) {
+        return true;
+    }
+    if (candidate.parent_path() != target.parent_path()) {
+        return false;
+    }
+    // createTempBeside() names: "<name>.tmp.<decimal>"
+    std::string prefix = target.filename().string() + ".tmp.";
+    std::string name = candidate.filename().string();
+    return name.size() > prefix.size() && name.compare(0, prefix.size(), prefix) == 0 &&
+           name.find_first_not_of("0123456789", prefix.size()) == std::string::npos;
+}
+
+Package::Result Package::save(ByteSink& sink) const {
+    Trace::Span span("package.encode");
     DeterministicTarWriter writer;
     
+    std::deque<TarEntry> generated;
+    for (const TarEntry* entry : archiveEntries(generated)) {
+        writer.addEntry(*entry);
+    }
+
+    // Finalize tar into a reusable scratch buffer
+    ScratchLease lease;
+    ScratchBuffer& tarData = lease.buffer();
+    if (!writer.finalizeTo(tarData)) {
+        return Result::fail("Failed to build tar: out of memory");
+    }
+    
+    // Compress, streaming gzip output straight into the sink
+    bool writeFailed = false;
+    bool ok = GzipHandler::compressTo(tarData.data(), tarData.size(),
+        [&sink, &writeFailed](const uint8_t* buffer, size_t size) {
+            if (!sink.write(buffer, size)) {
+                writeFailed = true;
+                return false;
+            }
+            return true;
+        });
+    if (!ok) {
+        if (writeFailed) {
+            return Result::fail(WRITE_FAILED_ERROR);
+        }
+        return Result::fail("Failed to compress: " + GzipHandler::getLastError());
+    }
+
+    if (!sink.finish()) {
+        return Result::fail(WRITE_FAILED_ERROR);
+    }
+    
+    return Result::ok();
+}
+
+std::vector<const TarEntry*> Package::archiveEntries(std::deque<TarEntry>& generated) const {
+    std::vector<const TarEntry*> result;
+    result.reserve(entries_.size() + 2);
+    auto generate = [&](TarEntry entry) {
+        generated.push_back(std::move(entry));
+        result.push_back(&generated.back());
+    };
+
     // Add manifest first
-    std::string manifestJson = manifest_.toJson();
-    writer.addFile("manifest.json", manifestJson);
+    generate(TarEntry("manifest.json", manifest_.toJson()));
 
     // Add manifest.sig if present
     if (manifestSig_.has_value()) {
-        std::string sigJson = manifestSig_->toJson();
-        writer.addFile("manifest.sig", sigJson);
+        generate(TarEntry("manifest.sig", manifestSig_->toJson()));
     }
 
     // Track which directories we've added
@@ -129,7 +596,7 @@ Package::Result Package::save(const std::filesystem::path& lgxPath) const {
         auto requiredDirs = getRequiredDirectories(entry.path);
         for (const auto& dir : requiredDirs) {
             if (addedDirs.find(dir) == addedDirs.end()) {
-                writer.addDirectory(dir);
+                generate(TarEntry(dir, true));
                 addedDirs.insert(dir);
             }
         }
@@ -141,43 +608,28 @@ Package::Result Package::save(const std::filesystem::path& lgxPath) const {
                 dirPath.pop_back();
             }
             if (addedDirs.find(dirPath) == addedDirs.end()) {
-                writer.addDirectory(dirPath);
+                generate(TarEntry(dirPath, true));
                 addedDirs.insert(dirPath);
             }
         } else {
-            writer.addEntry(entry);
+            result.push_back(&entry);
         }
     }
     
     // Ensure variants directory exists even if empty
     if (addedDirs.find("variants") == addedDirs.end()) {
-        writer.addDirectory("variants");
-    }
-    
-    // Finalize tar
-    auto tarData = writer.finalize();
-    
-    // Compress
-    auto gzipData = GzipHandler::compress(tarData);
-    if (gzipData.empty() && !tarData.empty()) {
-        return Result::fail("Failed to compress: " + GzipHandler::getLastError());
-    }
-    
-    // Write file
-    std::ofstream file(lgxPath, std::ios::binary);
-    if (!file) {
-        return Result::fail("Cannot write file: " + lgxPath.string());
-    }
-    
-    file.write(reinterpret_cast<const char*>(gzipData.data()), gzipData.size());
-    if (!file) {
-        return Result::fail("Failed to write file: " + lgxPath.string());
+        generate(TarEntry("variants", true));
     }
-    
-    return Result::ok();
+    return result;
 }
 
 Package::VerifyResult Package::validatePackage() const {
+    VerifyResult result = validateStructure();
+    checkContentHashes(result);
+    return result;
+}
+
+Package::VerifyResult Package::validateStructure() const {
     VerifyResult result = VerifyResult::ok();
 
     // Validate manifest
@@ -195,8 +647,11 @@ Package::VerifyResult Package::validatePackage() const {
     bool hasManifest = false;
     bool hasVariantsDir = false;
 
+    std::set<std::string> foundVariantDirs;  // as spelled in the archive
+
     for (const auto& entry : entries_) {
-        std::string rootComponent = PathNormalizer::getRootComponent(entry.path);
+        auto pathComponents = PathNormalizer::splitPath(entry.path);
+        std::string rootComponent = pathComponents.empty() ? "" : pathComponents[0];
 
         // Check if root entry is allowed
         if (ALLOWED_ROOT_ENTRIES.find(rootComponent) == ALLOWED_ROOT_ENTRIES.end()) {
@@ -212,10 +667,8 @@ Package::VerifyResult Package::validatePackage() const {
             hasVariantsDir = true;
 
             // Check variant structure
-            auto pathComponents = PathNormalizer::splitPath(entry.path);
             if (pathComponents.size() >= 2) {
-                std::string variantName = PathNormalizer::toLowercase(pathComponents[1]);
-                foundVariants.insert(variantName);
+                foundVariantDirs.insert(pathComponents[1]);
             }
 
             // Check that nothing is directly under variants/ (only directories)
@@ -236,6 +689,11 @@ Package::VerifyResult Package::validatePackage() const {
         // TarReader already filters these, but we verify the entries are regular files or dirs
     }
 
+    // Lowercase each distinct name once rather than once per entry
+    for (const auto& variantDir : foundVariantDirs) {
+        foundVariants.insert(PathNormalizer::toLowercase(variantDir));
+    }
+
     if (!hasManifest) {
         result.valid = false;
         result.errors.push_back("Missing manifest.json");
@@ -282,14 +740,23 @@ Package::VerifyResult Package::validatePackage() const {
         }
     }
 
+    return result;
+}
+
+void Package::checkContentHashes(VerifyResult& result) const {
     // Verify content hashes (mandatory when package has content)
     if (!crypto::init()) {
         result.valid = false;
         result.errors.push_back("Failed to initialize crypto library for hash verification");
-        return result;
+        return;
     }
     {
         auto recomputedHashes = crypto::computeMerkleTree(entries_);
+        if (Progress::isCancelled()) {
+            result.valid = false;
+            result.errors.push_back(Progress::CANCELLED_ERROR);
+            return;
+        }
         bool hasContent = !recomputedHashes.empty();
 
         if (hasContent && manifest_.hashes.empty()) {
@@ -311,13 +778,21 @@ Package::VerifyResult Package::validatePackage() const {
             }
         }
     }
-
-    return result;
 }
 
 Package::VerifyResult Package::verify(const std::filesystem::path& lgxPath) {
-    // Load package
-    auto pkgOpt = load(lgxPath);
+    return verify(lgxPath, VerifyLevel::Hashes);
+}
+
+Package::VerifyResult Package::verify(const std::filesystem::path& lgxPath, VerifyLevel level,
+                                      SignatureInfo* signature) {
+    Trace::Span span("package.verify", lgxPath.string());
+
+    // The structure level lists the entries as they stream past without
+    // keeping any file data; the others need the data once, for hashing
+    auto pkgOpt = level == VerifyLevel::Structure
+        ? loadStreamed(lgxPath, [](const std::string&, bool) { return false; }, true)
+        : load(lgxPath);
     if (!pkgOpt) {
         VerifyResult result;
         result.valid = false;
@@ -325,7 +800,14 @@ Package::VerifyResult Package::verify(const std::filesystem::path& lgxPath) {
         return result;
     }
 
-    return pkgOpt->validatePackage();
+    if (level == VerifyLevel::Structure) {
+        return pkgOpt->validateStructure();
+    }
+    VerifyResult result = pkgOpt->validatePackage();
+    if (level == VerifyLevel::Full && signature && result.valid) {
+        *signature = pkgOpt->checkSignature();
+    }
+    return result;
 }
 
 Package::Result Package::addVariant(
@@ -333,91 +815,307 @@ Package::Result Package::addVariant(
     const std::filesystem::path& filesPath,
     const std::optional<std::string>& mainPath
 ) {
+    Inputs inputs;
+    inputs.variants.push_back({variant, filesPath, mainPath});
+    return addInputs(inputs);
+}
+
+Package::Result Package::addInputs(const Inputs& inputs, crypto::FileHashCache* hashCache) {
     namespace fs = std::filesystem;
-    
-    std::string variantLc = PathNormalizer::toLowercase(variant);
-    
-    // Validate variant name
-    if (variantLc.empty()) {
-        return Result::fail("Variant name cannot be empty");
-    }
-    
-    // Check if path exists
-    std::error_code ec;
-    if (!fs::exists(filesPath, ec)) {
-        return Result::fail("Path does not exist: " + filesPath.string());
+    Trace::Span span("package.add_inputs");
+
+    if (inputs.variants.empty() && inputs.docs.empty() && inputs.licenses.empty()) {
+        return Result::noChange();
     }
-    
-    bool isDir = fs::is_directory(filesPath, ec);
+
+    // One read per input: the filesystem path, where it goes in the archive,
+    // and the entries read from it
+    struct Read {
+        fs::path fsPath;
+        std::string archiveBase;
+        std::vector<TarEntry> entries;
+        FileStamps stamps;
+        Result result = Result::ok();
+    };
+    std::vector<Read> reads;
+    std::vector<std::string> variantNames;  // lowercased, one per variant read
+    std::vector<std::string> variantMains;  // resolved main, empty if none
     const bool uiQmlPackage = manifest_.type == "ui_qml";
-    
-    // Determine main path
-    std::string resolvedMain;
-    if (isDir) {
-        if (!mainPath && !uiQmlPackage) {
-            return Result::fail("--main is required when --files is a directory");
+
+    for (const auto& input : inputs.variants) {
+        std::string variantLc = PathNormalizer::toLowercase(input.variant);
+
+        // Validate variant name
+        if (variantLc.empty()) {
+            return Result::fail("Variant name cannot be empty");
         }
-        if (mainPath) {
-            resolvedMain = *mainPath;
+
+        // Check if path exists
+        std::error_code ec;
+        if (!fs::exists(input.filesPath, ec)) {
+            return Result::fail("Path does not exist: " + input.filesPath.string());
         }
-    } else {
-        // Single file: main is the basename
-        resolvedMain = mainPath.value_or(filesPath.filename().string());
+
+        bool isDir = fs::is_directory(input.filesPath, ec);
+
+        // Determine main path
+        std::string resolvedMain;
+        if (isDir) {
+            if (!input.mainPath && !uiQmlPackage) {
+                return Result::fail("--main is required when --files is a directory");
+            }
+            if (input.mainPath) {
+                resolvedMain = *input.mainPath;
+            }
+        } else {
+            // Single file: main is the basename
+            resolvedMain = input.mainPath.value_or(input.filesPath.filename().string());
+        }
+
+        if (!resolvedMain.empty()) {
+            // Validate main path
+            auto mainValidation = PathNormalizer::validateArchivePath(resolvedMain);
+            if (!mainValidation.valid) {
+                return Result::fail("Invalid main path: " + mainValidation.error);
+            }
+        }
+
+        // Directory contents go directly under the variant root; a single
+        // file keeps its name
+        std::string archiveBase = "variants/" + variantLc;
+        if (!isDir) {
+            archiveBase += "/" + input.filesPath.filename().string();
+        }
+
+        reads.push_back({input.filesPath, archiveBase, {}, {}, Result::ok()});
+        variantNames.push_back(std::move(variantLc));
+        variantMains.push_back(std::move(resolvedMain));
     }
-    
-    if (!resolvedMain.empty()) {
-        // Validate main path
-        auto mainValidation = PathNormalizer::validateArchivePath(resolvedMain);
-        if (!mainValidation.valid) {
-            return Result::fail("Invalid main path: " + mainValidation.error);
+
+    auto addTopLevel = [&reads](const std::string& dir, const std::vector<fs::path>& paths) {
+        for (const auto& path : paths) {
+            std::error_code ec;
+            if (!fs::exists(path, ec)) {
+                return Result::fail("Path does not exist: " + path.string());
+            }
+            std::string archiveBase = dir;
+            if (!fs::is_directory(path, ec)) {
+                archiveBase += "/" + path.filename().string();
+            }
+            reads.push_back({path, archiveBase, {}, {}, Result::ok()});
         }
+        return Result::ok();
+    };
+    auto topLevelResult = addTopLevel("docs", inputs.docs);
+    if (topLevelResult.success) {
+        topLevelResult = addTopLevel("licenses", inputs.licenses);
     }
-    
-    // Remove existing variant entries
-    removeVariantEntries(variantLc);
-    
-    // Build archive base path
-    std::string archiveBase = "variants/" + variantLc;
-    
-    if (isDir) {
-        // Directory contents go directly under variant root
-        // archiveBase stays as "variants/<variant>"
+    if (!topLevelResult.success) {
+        return topLevelResult;
+    }
+
+    // Read every input; each task owns its slot and the pool's destructor
+    // waits for all of them
+    auto readOne = [&reads, &inputs](size_t i) {
+        Read& read = reads[i];
+        read.result = addFilesystemEntries(read.fsPath, read.archiveBase, read.entries,
+                                           inputs.digestCache ? &read.stamps : nullptr);
+    };
+    size_t threads = std::min({static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())),
+                               MAX_INPUT_READ_THREADS, reads.size()});
+    if (threads <= 1) {
+        for (size_t i = 0; i < reads.size(); ++i) {
+            readOne(i);
+        }
     } else {
-        // Single file: include filename in path
-        std::string fileName = filesPath.filename().string();
-        archiveBase = archiveBase + "/" + fileName;
+        WorkerPool pool(threads);
+        for (size_t i = 0; i < reads.size(); ++i) {
+            pool.submit([&readOne, i] { readOne(i); });
+        }
     }
-    
-    // Add variant directory entry
-    TarEntry variantDirEntry;
-    variantDirEntry.path = "variants/" + variantLc;
-    variantDirEntry.isDirectory = true;
-    entries_.push_back(variantDirEntry);
-    
-    // Add new entries
-    auto addResult = addFilesystemEntries(filesPath, archiveBase);
-    if (!addResult.success) {
-        return addResult;
+    for (const auto& read : reads) {
+        if (!read.result.success) {
+            return read.result;
+        }
     }
-    
-    // Update manifest main. ui_qml directory variants may legitimately omit
-    // backend metadata, so clear any stale entry when main is absent.
-    if (!resolvedMain.empty()) {
-        manifest_.setMain(variantLc, resolvedMain);
-    } else {
-        manifest_.removeMain(variantLc);
+
+    // Docs and licenses from different inputs must not collide
+    std::unordered_set<std::string> topLevelFiles;
+    for (size_t i = variantNames.size(); i < reads.size(); ++i) {
+        for (const auto& entry : reads[i].entries) {
+            if (!entry.isDirectory && !topLevelFiles.insert(entry.path).second) {
+                return Result::fail("Duplicate path: " + entry.path);
+            }
+        }
+    }
+
+    // Re-adding what the package already holds changes nothing: keep the
+    // signature and let the caller skip the save. The last input given for
+    // a variant is the one that counts.
+    auto holdsInputs = [&]() {
+        std::map<std::string, size_t> lastRead;
+        for (size_t i = 0; i < variantNames.size(); ++i) {
+            lastRead[variantNames[i]] = i;
+        }
+        for (const auto& [variantLc, i] : lastRead) {
+            if (manifest_.getMain(variantLc).value_or("") != variantMains[i]) {
+                return false;
+            }
+            TarEntry variantDirEntry("variants/" + variantLc, true);
+            std::vector<const TarEntry*> incoming{&variantDirEntry};
+            for (const auto& entry : reads[i].entries) {
+                incoming.push_back(&entry);
+            }
+            if (!sameEntries(entriesUnder(variantDirEntry.path), std::move(incoming))) {
+                return false;
+            }
+        }
+        for (const std::string dir : {"docs", "licenses"}) {
+            if ((dir == "docs" ? inputs.docs : inputs.licenses).empty()) {
+                continue;
+            }
+            std::vector<const TarEntry*> incoming;
+            for (size_t i = variantNames.size(); i < reads.size(); ++i) {
+                const std::string& base = reads[i].archiveBase;
+                if (base != dir && base.compare(0, dir.size() + 1, dir + "/") != 0) {
+                    continue;
+                }
+                for (const auto& entry : reads[i].entries) {
+                    incoming.push_back(&entry);
+                }
+            }
+            if (!sameEntries(entriesUnder(dir), std::move(incoming))) {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (holdsInputs()) {
+        return Result::noChange();
+    }
+
+    // Files just read must be rehashed unless the digest cache vouches for
+    // them; a caller's hash cache may hold digests of earlier contents
+    crypto::FileHashCache localCache;
+    crypto::FileHashCache* cache = hashCache ? hashCache
+                                 : inputs.digestCache ? &localCache : nullptr;
+    std::vector<const std::pair<std::string, DigestCache::Key>*> uncached;
+    for (const auto& read : reads) {
+        if (hashCache) {
+            for (const auto& entry : read.entries) {
+                hashCache->erase(entry.path);
+            }
+        }
+        for (const auto& stamp : read.stamps) {
+            if (auto digest = inputs.digestCache->lookup(stamp.second)) {
+                (*cache)[stamp.first] = std::move(*digest);
+            } else {
+                uncached.push_back(&stamp);
+            }
+        }
+    }
+
+    // Apply in order, as separate addVariant() calls would
+    for (size_t i = 0; i < variantNames.size(); ++i) {
+        const std::string& variantLc = variantNames[i];
+        removeVariantEntries(variantLc);
+
+        TarEntry variantDirEntry;
+        variantDirEntry.path = "variants/" + variantLc;
+        variantDirEntry.isDirectory = true;
+        entries_.push_back(variantDirEntry);
+        std::move(reads[i].entries.begin(), reads[i].entries.end(), std::back_inserter(entries_));
+
+        // ui_qml directory variants may legitimately omit backend metadata,
+        // so clear any stale entry when main is absent.
+        if (!variantMains[i].empty()) {
+            manifest_.setMain(variantLc, variantMains[i]);
+        } else {
+            manifest_.removeMain(variantLc);
+        }
+    }
+
+    if (!inputs.docs.empty()) {
+        removeTopLevelEntries("docs");
+    }
+    if (!inputs.licenses.empty()) {
+        removeTopLevelEntries("licenses");
+    }
+    std::unordered_set<std::string> topLevelDirs;
+    for (size_t i = variantNames.size(); i < reads.size(); ++i) {
+        for (auto& entry : reads[i].entries) {
+            if (entry.isDirectory && !topLevelDirs.insert(entry.path).second) {
+                continue;
+            }
+            entries_.push_back(std::move(entry));
+        }
     }
 
     // Invalidate signature and recompute hashes (content changed)
     clearSignature();
-    auto hashResult = recomputeHashes();
+    auto hashResult = recomputeHashes(cache);
     if (!hashResult.success) {
         return hashResult;
     }
+    for (const auto* stamp : uncached) {
+        inputs.digestCache->record(stamp->second, (*cache)[stamp->first]);
+    }
 
     return Result::ok();
 }
 
+Package::Result Package::updatePaths(const std::vector<PathChange>& changes,
+                                     crypto::FileHashCache* hashCache) {
+    namespace fs = std::filesystem;
+    Trace::Span span("package.update_paths");
+
+    // Read everything first, so a failure leaves the package unchanged
+    std::vector<std::string> paths(changes.size());
+    std::vector<std::vector<TarEntry>> fresh(changes.size());
+    for (size_t i = 0; i < changes.size(); ++i) {
+        auto normalized = PathNormalizer::toNFC(changes[i].archivePath);
+        if (!normalized) {
+            return Result::fail("Failed to NFC-normalize path: " + changes[i].archivePath);
+        }
+        paths[i] = std::move(*normalized);
+
+        // Anything that is no longer a file or directory counts as removed
+        std::error_code ec;
+        auto status = fs::status(changes[i].fsPath, ec);
+        if (!fs::is_regular_file(status) && !fs::is_directory(status)) {
+            continue;
+        }
+        auto result = addFilesystemEntries(changes[i].fsPath, paths[i], fresh[i]);
+        if (!result.success) {
+            return result;
+        }
+    }
+
+    for (size_t i = 0; i < changes.size(); ++i) {
+        const std::string& path = paths[i];
+        std::string prefix = path + "/";
+        auto under = [&](const std::string& p) {
+            return p == path || p == prefix || p.compare(0, prefix.size(), prefix) == 0;
+        };
+
+        entries_.erase(
+            std::remove_if(entries_.begin(), entries_.end(),
+                [&](const TarEntry& entry) { return under(entry.path); }),
+            entries_.end()
+        );
+        if (hashCache) {
+            for (auto it = hashCache->begin(); it != hashCache->end();) {
+                it = under(it->first) ? hashCache->erase(it) : std::next(it);
+            }
+        }
+        std::move(fresh[i].begin(), fresh[i].end(), std::back_inserter(entries_));
+    }
+
+    // Invalidate signature and recompute hashes (content changed)
+    clearSignature();
+    return recomputeHashes(hashCache);
+}
+
 Package::Result Package::removeVariant(const std::string& variant) {
     std::string variantLc = PathNormalizer::toLowercase(variant);
 
@@ -440,17 +1138,15 @@ Package::Result Package::removeVariant(const std::string& variant) {
 
 bool Package::hasVariant(const std::string& variant) const {
     std::string variantLc = PathNormalizer::toLowercase(variant);
-    std::string prefix = "variants/" + variantLc + "/";
     std::string exactDir = "variants/" + variantLc;
     
     for (const auto& entry : entries_) {
-        std::string path = entry.path;
-        // Normalize trailing slash
-        if (!path.empty() && path.back() == '/') {
-            path.pop_back();
+        const std::string& path = entry.path;
+        if (path.compare(0, exactDir.size(), exactDir) != 0) {
+            continue;
         }
-        
-        if (path == exactDir || path.substr(0, prefix.length()) == prefix) {
+        // "variants/<v>", "variants/<v>/" or anything under it
+        if (path.size() == exactDir.size() || path[exactDir.size()] == '/') {
             return true;
         }
     }
@@ -459,15 +1155,22 @@ bool Package::hasVariant(const std::string& variant) const {
 }
 
 std::set<std::string> Package::getVariants() const {
-    std::set<std::string> variants;
+    // Collect names as spelled in the archive, then lowercase each distinct
+    // name once: a package may hold many thousands of entries per variant
+    static const std::string variantsDir = "variants";
+    std::set<std::string> names;
     
     for (const auto& entry : entries_) {
         auto components = PathNormalizer::splitPath(entry.path);
-        if (components.size() >= 2 && components[0] == "variants") {
-            variants.insert(PathNormalizer::toLowercase(components[1]));
+        if (components.size() >= 2 && components[0] == variantsDir) {
+            names.insert(std::move(components[1]));
         }
     }
     
+    std::set<std::string> variants;
+    for (const auto& name : names) {
+        variants.insert(PathNormalizer::toLowercase(name));
+    }
     return variants;
 }
 
@@ -501,9 +1204,88 @@ void Package::removeVariantEntries(const std::string& variant) {
     );
 }
 
+std::vector<const TarEntry*> Package::entriesUnder(const std::string& dir) const {
+    std::string prefix = dir + "/";
+    std::vector<const TarEntry*> result;
+    for (const auto& entry : entries_) {
+        if (entry.path == dir || entry.path.compare(0, prefix.size(), prefix) == 0) {
+            result.push_back(&entry);
+        }
+    }
+    return result;
+}
+
+bool Package::sameEntries(std::vector<const TarEntry*> a, std::vector<const TarEntry*> b) {
+    // Sort by archive path and drop directories with anything under them,
+    // which save() would write anyway
+    auto canonical = [](const std::vector<const TarEntry*>& entries) {
+        std::vector<std::pair<std::string, const TarEntry*>> sorted;
+        sorted.reserve(entries.size());
+        for (const TarEntry* entry : entries) {
+            sorted.emplace_back(DeterministicTarWriter::archivePath(*entry), entry);
+        }
+        std::sort(sorted.begin(), sorted.end(),
+            [](const auto& x, const auto& y) { return x.first < y.first; });
+        std::vector<std::pair<std::string, const TarEntry*>> result;
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            const std::string& path = sorted[i].first;
+            bool implied = sorted[i].second->isDirectory && i + 1 < sorted.size() &&
+                           sorted[i + 1].first.compare(0, path.size(), path) == 0;
+            if (!implied) {
+                result.push_back(std::move(sorted[i]));
+            }
+        }
+        return result;
+    };
+    auto left = canonical(a);
+    auto right = canonical(b);
+    if (left.size() != right.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < left.size(); ++i) {
+        const TarEntry& x = *left[i].second;
+        const TarEntry& y = *right[i].second;
+        if (left[i].first != right[i].first || x.isDirectory != y.isDirectory ||
+            DeterministicTarWriter::archiveMode(x) != DeterministicTarWriter::archiveMode(y) ||
+            (!x.isDirectory && x.data != y.data)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Package::sameContent(const Package& other) const {
+    if (manifest_.toJson() != other.manifest_.toJson()) {
+        return false;
+    }
+    auto contentEntries = [](const Package& pkg) {
+        std::vector<const TarEntry*> result;
+        for (const auto& entry : pkg.entries_) {
+            if (entry.path != "manifest.json" && entry.path != "manifest.sig") {
+                result.push_back(&entry);
+            }
+        }
+        return result;
+    };
+    return sameEntries(contentEntries(*this), contentEntries(other));
+}
+
+void Package::removeTopLevelEntries(const std::string& dir) {
+    std::string prefix = dir + "/";
+    entries_.erase(
+        std::remove_if(entries_.begin(), entries_.end(),
+            [&](const TarEntry& entry) {
+                return entry.path == dir || entry.path.compare(0, prefix.size(), prefix) == 0;
+            }),
+        entries_.end()
+    );
+}
+
 Package::Result Package::addFilesystemEntries(
     const std::filesystem::path& fsPath,
-    const std::string& archiveBasePath
+    const std::string& archiveBasePath,
+    std::vector<TarEntry>& out,
+    FileStamps* stamps
 ) {
     namespace fs = std::filesystem;
     std::error_code ec;
@@ -514,12 +1296,15 @@ Package::Result Package::addFilesystemEntries(
         return Result::fail("Failed to NFC-normalize path: " + archiveBasePath);
     }
     std::string normalizedBase = *normalizedBaseOpt;
-    
-    if (fs::is_regular_file(fsPath, ec)) {
-        // Single file
-        std::ifstream file(fsPath, std::ios::binary);
+
+    auto addFile = [&out, stamps](const fs::path& path, const std::string& archivePath) {
+        // A stamp is only taken if the file did not change while being read
+        DigestCache::Key before;
+        bool stamped = stamps && DigestCache::Key::of(path, before);
+
+        std::ifstream file(path, std::ios::binary);
         if (!file) {
-            return Result::fail("Cannot read file: " + fsPath.string());
+            return Result::fail("Cannot read file: " + path.string());
         }
         
         std::vector<uint8_t> data(
@@ -528,16 +1313,32 @@ Package::Result Package::addFilesystemEntries(
         );
         
         TarEntry entry;
-        entry.path = normalizedBase;
+        entry.path = archivePath;
         entry.data = std::move(data);
         entry.isDirectory = false;
         
-        auto status = fs::status(fsPath, ec);
-        if (!ec) {
+        std::error_code statusEc;
+        auto status = fs::status(path, statusEc);
+        if (!statusEc) {
             entry.mode = static_cast<uint32_t>(status.permissions() & fs::perms::mask);
         }
+
+        DigestCache::Key after;
+        if (stamped && DigestCache::Key::of(path, after) && after == before &&
+            after.size == entry.data.size()) {
+            stamps->emplace_back(archivePath, after);
+        }
         
-        entries_.push_back(std::move(entry));
+        out.push_back(std::move(entry));
+        return Result::ok();
+    };
+    
+    if (fs::is_regular_file(fsPath, ec)) {
+        // Single file
+        auto result = addFile(fsPath, normalizedBase);
+        if (!result.success) {
+            return result;
+        }
     } else if (fs::is_directory(fsPath, ec)) {
         // Directory - add entry for the directory itself
         TarEntry dirEntry;
@@ -549,7 +1350,7 @@ Package::Result Package::addFilesystemEntries(
             dirEntry.mode = static_cast<uint32_t>(status.permissions() & fs::perms::mask);
         }
         
-        entries_.push_back(dirEntry);
+        out.push_back(dirEntry);
         
         // Recursively add contents
         for (const auto& item : fs::recursive_directory_iterator(fsPath, ec)) {
@@ -578,29 +1379,12 @@ Package::Result Package::addFilesystemEntries(
                     entry.mode = static_cast<uint32_t>(status.permissions() & fs::perms::mask);
                 }
                 
-                entries_.push_back(std::move(entry));
+                out.push_back(std::move(entry));
             } else if (fs::is_regular_file(item.path(), ec)) {
-                std::ifstream file(item.path(), std::ios::binary);
-                if (!file) {
-                    return Result::fail("Cannot read file: " + item.path().string());
-                }
-                
-                std::vector<uint8_t> data(
-                    (std::istreambuf_iterator<char>(file)),
-                    std::istreambuf_iterator<char>()
-                );
-                
-                TarEntry entry;
-                entry.path = *normalizedPathOpt;
-                entry.data = std::move(data);
-                entry.isDirectory = false;
-                
-                auto status = fs::status(item.path(), ec);
-                if (!ec) {
-                    entry.mode = static_cast<uint32_t>(status.permissions() & fs::perms::mask);
+                auto result = addFile(item.path(), *normalizedPathOpt);
+                if (!result.success) {
+                    return result;
                 }
-                
-                entries_.push_back(std::move(entry));
             } else {
                 // Skip symlinks, special files, etc.
                 // Could add a warning here
@@ -632,7 +1416,9 @@ std::vector<std::string> Package::getRequiredDirectories(const std::string& path
 
 Package::Result Package::extractVariant(
     const std::string& variant,
-    const std::filesystem::path& outputDir
+    const std::filesystem::path& outputDir,
+    const PathFilter& filter,
+    Durability durability
 ) const {
     namespace fs = std::filesystem;
     std::error_code ec;
@@ -642,8 +1428,97 @@ Package::Result Package::extractVariant(
     if (!hasVariant(variantLc)) {
         return Result::fail("Variant does not exist: " + variant);
     }
-    
+
+    std::string prefix = "variants/" + variantLc + "/";
+    std::vector<const TarEntry*> variantEntries;
+    for (const auto& entry : entries_) {
+        if (entry.path.compare(0, prefix.size(), prefix) == 0) {
+            variantEntries.push_back(&entry);
+        }
+    }
+
+    return extractVariantEntries(variantLc, variantEntries, outputDir, filter, durability);
+}
+
+Package::Result Package::extractVariantEntries(
+    const std::string& variantLc,
+    const std::vector<const TarEntry*>& variantEntries,
+    const std::filesystem::path& outputDir,
+    const PathFilter& filter,
+    Durability durability
+) const {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+
     fs::path variantOutputDir = outputDir / variantLc;
+    if (durability != Durability::Durable) {
+        return writeVariantTree(variantLc, variantEntries, variantOutputDir, filter);
+    }
+    if (!filter.empty()) {
+        // The swap replaces the whole directory, which would drop files a
+        // filtered in-place extraction keeps
+        return Result::fail("Durable extraction cannot be filtered");
+    }
+
+    // Write the whole variant beside its final place, flush it, then swap
+    // it in with one rename. A crash leaves either the old tree or the new
+    // one, and only a staging directory to clean up.
+    Trace::Span span("package.extract_durable", variantLc);
+    const fs::path stagingDir = outputDir / ("." + variantLc + UPDATE_STAGING_SUFFIX);
+    auto discardStaging = [&stagingDir]() {
+        std::error_code ignored;
+        fs::remove_all(stagingDir, ignored);
+    };
+    discardStaging();  // left over from an interrupted extraction or update
+
+    bool createdOutputDir = fs::create_directories(outputDir, ec);
+    if (ec) {
+        return Result::fail("Failed to create directory: " + outputDir.string() + " - " + ec.message());
+    }
+    fs::create_directory(stagingDir, ec);
+    if (ec) {
+        return Result::fail("Failed to create directory: " + stagingDir.string() + " - " + ec.message());
+    }
+    auto result = writeVariantTree(variantLc, variantEntries, stagingDir, filter);
+    if (result.success && !DurableIo::syncTree(stagingDir)) {
+        result = Result::fail("Failed to flush " + stagingDir.string() + " - " + DurableIo::getLastError());
+    }
+    if (!result.success) {
+        discardStaging();
+        return result;
+    }
+
+    std::string moveError;
+    if (fs::exists(fs::symlink_status(variantOutputDir, ec))) {
+        if (!DurableIo::exchange(stagingDir, variantOutputDir)) {
+            moveError = DurableIo::getLastError();
+        }
+    } else {
+        fs::rename(stagingDir, variantOutputDir, ec);
+        moveError = ec ? ec.message() : "";
+    }
+    if (!moveError.empty()) {
+        discardStaging();
+        return Result::fail("Failed to move " + stagingDir.string() + " into place - " + moveError);
+    }
+    if (!DurableIo::syncDirectory(outputDir) ||
+        (createdOutputDir && !DurableIo::syncDirectory(outputDir.parent_path()))) {
+        discardStaging();
+        return Result::fail("Extracted " + variantOutputDir.string() + " but could not flush it: " +
+                            DurableIo::getLastError());
+    }
+    discardStaging();  // the replaced tree
+    return Result::ok();
+}
+
+Package::Result Package::writeVariantTree(
+    const std::string& variantLc,
+    const std::vector<const TarEntry*>& variantEntries,
+    const std::filesystem::path& variantOutputDir,
+    const PathFilter& filter
+) const {
+    namespace fs = std::filesystem;
+    std::error_code ec;
 
     // Resolve the containment root once. weakly_canonical works even if the
     // directory does not exist yet; fall back to lexical normalization if the
@@ -656,54 +1531,44 @@ Package::Result Package::extractVariant(
 
     std::string prefix = "variants/" + variantLc + "/";
 
-    for (const auto& entry : entries_) {
-        if (entry.path.substr(0, prefix.length()) != prefix) {
-            continue;
-        }
+    Stats::Timer timer(Stats::Phase::Extract);
+    Trace::Span span("package.extract", variantLc);
 
-        // Zip-slip defense. Package::load() stores tar entry paths verbatim and
-        // never runs validateArchivePath() on the load->extract path, so a
-        // crafted .lgx can carry a "variants/<v>/../../.." entry that satisfies
-        // the prefix test above. Reject any entry the archive validator would
-        // reject (absolute paths, ".." segments, backslashes, non-NFC) before
-        // touching the filesystem.
-        auto pathValidation = PathNormalizer::validateArchivePath(entry.path);
-        if (!pathValidation.valid) {
-            return Result::fail("Refusing to extract unsafe archive path '" +
-                                entry.path + "': " + pathValidation.error);
+    // Files are traced in batches so large variants stay readable in the viewer
+    constexpr size_t TRACE_BATCH_FILES = 64;
+    std::optional<Trace::Span> batchSpan;
+    size_t batchFiles = 0;
+
+    for (const TarEntry* entryPtr : variantEntries) {
+        const TarEntry& entry = *entryPtr;
+        if (Progress::isCancelled()) {
+            return Result::fail(Progress::CANCELLED_ERROR);
         }
 
         std::string relativePath = entry.path.substr(prefix.length());
-        if (relativePath.empty()) {
+        fs::path fullPath = variantOutputDir / relativePath;
+        std::string unsafe = unsafeTargetError(entry, relativePath, canonRoot, fullPath);
+        if (!unsafe.empty()) {
+            return Result::fail(unsafe);
+        }
+        if (relativePath.empty() || (!filter.empty() && !filter.matches(relativePath))) {
             continue;
         }
 
-        fs::path fullPath = variantOutputDir / relativePath;
-
-        // Defense in depth: the normalized target must stay under canonRoot.
-        // Guards against escapes that the per-entry check might miss (e.g. via
-        // already-resolved separators) without depending on the file existing.
-        //
-        // canonFull is built by joining relativePath onto canonRoot (not from
-        // fullPath directly) so both sides of the comparison always share the
-        // same base. canonRoot is absolute when weakly_canonical succeeds but
-        // fullPath stays relative when outputDir is relative (e.g. the CLI's
-        // default "."); comparing an absolute base against a relative target
-        // makes lexically_relative() return empty and false-rejects every
-        // benign entry. Anchoring to canonRoot keeps them consistent.
-        fs::path canonFull = (canonRoot / relativePath).lexically_normal();
-        fs::path rel = canonFull.lexically_relative(canonRoot);
-        if (rel.empty() || *rel.begin() == "..") {
-            return Result::fail("Path escapes output directory: " + fullPath.string());
+        if (!batchSpan) {
+            batchSpan.emplace("extract.batch", relativePath);
         }
 
         if (entry.isDirectory) {
+            timer.addSyscalls();  // mkdir
             if (!fs::create_directories(fullPath, ec) && ec) {
                 return Result::fail("Failed to create directory: " + fullPath.string() + " - " + ec.message());
             }
         } else {
             fs::path parentDir = fullPath.parent_path();
+            timer.addSyscalls();  // stat
             if (!parentDir.empty() && !fs::exists(parentDir)) {
+                timer.addSyscalls();  // mkdir
                 if (!fs::create_directories(parentDir, ec) && ec) {
                     return Result::fail("Failed to create directory: " + parentDir.string() + " - " + ec.message());
                 }
@@ -719,24 +1584,61 @@ Package::Result Package::extractVariant(
                 return Result::fail("Failed to write file: " + fullPath.string());
             }
             file.close();
+            timer.addSyscalls(3);  // open, write, close
+            timer.addBytesOut(entry.data.size());
+            Progress::addBytes(entry.data.size());
 
             if (entry.mode != 0) {
+                timer.addSyscalls();  // chmod
                 fs::permissions(fullPath, static_cast<fs::perms>(entry.mode & 0777), ec);
                 if (ec) {
                     return Result::fail("Failed to set permissions on: " + fullPath.string() + " - " + ec.message());
                 }
             }
         }
+        Progress::addEntries();
+        timer.addEntries();
+
+        if (++batchFiles == TRACE_BATCH_FILES) {
+            batchSpan.reset();
+            batchFiles = 0;
+        }
     }
     
     return Result::ok();
 }
 
-Package::Result Package::extractAll(const std::filesystem::path& outputDir) const {
+std::map<std::string, std::vector<const TarEntry*>> Package::variantBuckets() const {
+    // Bucket entries by variant in one pass instead of rescanning every
+    // entry once per variant
+    std::map<std::string, std::vector<const TarEntry*>> buckets;
+    const std::string variantsPrefix = "variants/";
+    for (const auto& entry : entries_) {
+        if (entry.path.compare(0, variantsPrefix.size(), variantsPrefix) != 0) {
+            continue;
+        }
+        size_t nameEnd = entry.path.find('/', variantsPrefix.size());
+        std::string name = entry.path.substr(variantsPrefix.size(),
+            nameEnd == std::string::npos ? std::string::npos : nameEnd - variantsPrefix.size());
+        auto& bucket = buckets[name];
+        if (nameEnd != std::string::npos) {
+            bucket.push_back(&entry);
+        }
+    }
+    return buckets;
+}
+
+Package::Result Package::extractAll(const std::filesystem::path& outputDir,
+                                    const PathFilter& filter, Durability durability) const {
     auto variants = getVariants();
+    auto buckets = variantBuckets();
     
     for (const auto& variant : variants) {
-        auto result = extractVariant(variant, outputDir);
+        auto it = buckets.find(variant);
+        if (it == buckets.end()) {
+            return Result::fail("Variant does not exist: " + variant);
+        }
+        auto result = extractVariantEntries(variant, it->second, outputDir, filter, durability);
         if (!result.success) {
             return result;
         }
@@ -745,6 +1647,331 @@ Package::Result Package::extractAll(const std::filesystem::path& outputDir) cons
     return Result::ok();
 }
 
+Package::Result Package::updateVariant(const std::string& variant,
+                                       const std::filesystem::path& outputDir,
+                                       UpdateCounts* counts, Durability durability) const {
+    std::string variantLc = PathNormalizer::toLowercase(variant);
+    if (!hasVariant(variantLc)) {
+        return Result::fail("Variant does not exist: " + variant);
+    }
+
+    std::string prefix = "variants/" + variantLc + "/";
+    std::vector<const TarEntry*> variantEntries;
+    for (const auto& entry : entries_) {
+        if (entry.path.compare(0, prefix.size(), prefix) == 0) {
+            variantEntries.push_back(&entry);
+        }
+    }
+
+    return updateVariantEntries(variantLc, variantEntries, outputDir, counts, durability);
+}
+
+Package::Result Package::updateAll(const std::filesystem::path& outputDir,
+                                   UpdateCounts* counts, Durability durability) const {
+    auto buckets = variantBuckets();
+    bool unchanged = true;
+    for (const auto& variant : getVariants()) {
+        auto it = buckets.find(variant);
+        if (it == buckets.end()) {
+            return Result::fail("Variant does not exist: " + variant);
+        }
+        auto result = updateVariantEntries(variant, it->second, outputDir, counts, durability);
+        if (!result.success) {
+            return result;
+        }
+        unchanged = unchanged && result.unchanged;
+    }
+    return unchanged ? Result::noChange() : Result::ok();
+}
+
+Package::Result Package::updateVariantEntries(
+    const std::string& variantLc,
+    const std::vector<const TarEntry*>& variantEntries,
+    const std::filesystem::path& outputDir,
+    UpdateCounts* counts,
+    Durability durability
+) const {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+
+    fs::path variantOutputDir = outputDir / variantLc;
+    fs::path canonRoot = fs::weakly_canonical(variantOutputDir, ec);
+    if (ec || canonRoot.empty()) {
+        canonRoot = variantOutputDir.lexically_normal();
+        ec.clear();
+    }
+
+    std::string prefix = "variants/" + variantLc + "/";
+    auto hashIt = manifest_.hashes.find("variants/" + variantLc);
+    const std::string variantHash = hashIt == manifest_.hashes.end() ? "" : hashIt->second;
+    const fs::path statePath = InstalledState::pathFor(outputDir, variantLc);
+
+    Stats::Timer timer(Stats::Phase::Extract);
+    Trace::Span span("package.update", variantLc);
+
+    // What the tree should hold: files by relative path, and every directory
+    std::map<std::string, const TarEntry*> files;
+    std::set<std::string> dirs;
+    for (const TarEntry* entryPtr : variantEntries) {
+        std::string relativePath = entryPtr->path.substr(prefix.length());
+        std::string unsafe = unsafeTargetError(*entryPtr, relativePath, canonRoot,
+                                               variantOutputDir / relativePath);
+        if (!unsafe.empty()) {
+            return Result::fail(unsafe);
+        }
+        while (!relativePath.empty() && relativePath.back() == '/') {
+            relativePath.pop_back();
+        }
+        if (relativePath.empty()) {
+            continue;
+        }
+        if (entryPtr->isDirectory) {
+            dirs.insert(relativePath);
+        } else {
+            files[relativePath] = entryPtr;
+        }
+        for (size_t slash = relativePath.rfind('/'); slash != std::string::npos && slash > 0;
+             slash = relativePath.rfind('/', slash - 1)) {
+            dirs.insert(relativePath.substr(0, slash));
+        }
+    }
+
+    // Fast path: the sidecar says this variant hash was installed, and no
+    // installed file has been touched since (by stat alone, nothing read)
+    auto installed = InstalledState::load(statePath);
+    if (installed && !variantHash.empty() && installed->variant == variantLc &&
+        installed->hash == variantHash && installed->files.size() == files.size()) {
+        bool current = true;
+        for (const auto& [relativePath, entry] : files) {
+            auto it = installed->files.find(relativePath);
+            DigestCache::Key key;
+            timer.addSyscalls();  // stat
+            if (it == installed->files.end() || !it->second.stat || it->second.mode != entry->mode ||
+                !DigestCache::Key::of(variantOutputDir / relativePath, key) || key != *it->second.stat) {
+                current = false;
+                break;
+            }
+        }
+        for (auto it = dirs.begin(); current && it != dirs.end(); ++it) {
+            timer.addSyscalls();  // stat
+            current = fs::is_directory(variantOutputDir / *it, ec);
+        }
+        if (current) {
+            if (counts) {
+                counts->kept += files.size();
+            }
+            return Result::noChange();
+        }
+    }
+
+    // Compare each file with the installed copy; write the ones that differ
+    // to a staging directory beside the variant, leaving the tree untouched
+    const fs::path stagingDir = outputDir / ("." + variantLc + UPDATE_STAGING_SUFFIX);
+    auto discardStaging = [&stagingDir]() {
+        std::error_code ignored;
+        fs::remove_all(stagingDir, ignored);
+    };
+    discardStaging();  // left over from an interrupted update
+
+    InstalledState next;
+    next.variant = variantLc;
+    next.hash = variantHash;
+    std::vector<std::string> staged;
+    std::vector<std::string> modeFixes;  // kept files whose mode differs
+    for (const auto& [relativePath, entry] : files) {
+        if (Progress::isCancelled()) {
+            discardStaging();
+            return Result::fail(Progress::CANCELLED_ERROR);
+        }
+
+        InstalledState::File record;
+        record.size = entry->data.size();
+        record.mode = entry->mode;
+        record.sha256 = crypto::sha256Hex(entry->data);
+
+        fs::path target = variantOutputDir / relativePath;
+        bool current = false;
+        timer.addSyscalls();  // lstat
+        fs::file_status status = fs::symlink_status(target, ec);
+        if (!ec && fs::is_regular_file(status)) {
+            const InstalledState::File* previous = nullptr;
+            if (installed) {
+                auto it = installed->files.find(relativePath);
+                previous = it == installed->files.end() ? nullptr : &it->second;
+            }
+            DigestCache::Key key;
+            bool haveKey = DigestCache::Key::of(target, key);
+            if (haveKey && key.size != record.size) {
+                current = false;
+            } else if (haveKey && previous && previous->stat && key == *previous->stat) {
+                current = previous->sha256 == record.sha256;
+            } else {
+                std::string digest;
+                current = fs::file_size(target, ec) == record.size && !ec &&
+                          InstalledState::hashFile(target, digest) && digest == record.sha256;
+            }
+            if (current && entry->mode != 0 &&
+                (static_cast<uint32_t>(status.permissions()) & 0777) != (entry->mode & 0777)) {
+                modeFixes.push_back(relativePath);
+            }
+        }
+        ec.clear();
+
+        if (!current) {
+            fs::path stagedPath = stagingDir / relativePath;
+            timer.addSyscalls();  // mkdir
+            if (!fs::create_directories(stagedPath.parent_path(), ec) && ec) {
+                discardStaging();
+                return Result::fail("Failed to create directory: " + stagedPath.parent_path().string() +
+                                    " - " + ec.message());
+            }
+            std::ofstream file(stagedPath, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(entry->data.data()), entry->data.size());
+            file.close();
+            if (!file) {
+                discardStaging();
+                return Result::fail("Failed to write file: " + stagedPath.string());
+            }
+            timer.addSyscalls(3);  // open, write, close
+            timer.addBytesOut(entry->data.size());
+            Progress::addBytes(entry->data.size());
+            if (entry->mode != 0) {
+                timer.addSyscalls();  // chmod
+                fs::permissions(stagedPath, static_cast<fs::perms>(entry->mode & 0777), ec);
+                if (ec) {
+                    discardStaging();
+                    return Result::fail("Failed to set permissions on: " + stagedPath.string() +
+                                        " - " + ec.message());
+                }
+            }
+            staged.push_back(relativePath);
+        }
+        next.files.emplace(relativePath, std::move(record));
+        Progress::addEntries();
+        timer.addEntries();
+    }
+
+    // Durable: staged files reach the disk before any of them replaces an
+    // installed file, and each directory the commit changes is flushed after
+    const bool durable = durability == Durability::Durable;
+    if (durable && !staged.empty() && !DurableIo::syncTree(stagingDir)) {
+        discardStaging();
+        return Result::fail("Failed to flush " + stagingDir.string() + " - " + DurableIo::getLastError());
+    }
+    std::set<fs::path> touchedDirs{outputDir};
+
+    // Commit. The sidecar is dropped first, so an interrupted commit leaves
+    // no record claiming the tree is current and the next update compares
+    // contents again. Stale paths go before files are renamed in, so a file
+    // can replace a directory and the other way round.
+    fs::remove(statePath, ec);
+    ec.clear();
+
+    size_t removed = 0;
+    timer.addSyscalls();  // lstat
+    fs::file_status rootStatus = fs::symlink_status(variantOutputDir, ec);
+    ec.clear();
+    if (fs::is_directory(rootStatus)) {
+        std::vector<fs::path> stale;
+        for (auto it = fs::recursive_directory_iterator(variantOutputDir, ec);
+             !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            std::string rel = it->path().lexically_relative(variantOutputDir).generic_string();
+            bool isDirectory = fs::is_directory(it->symlink_status());
+            if (isDirectory ? dirs.count(rel) > 0 : files.count(rel) > 0) {
+                continue;
+            }
+            stale.push_back(it->path());
+            if (isDirectory) {
+                it.disable_recursion_pending();
+            }
+        }
+        if (ec) {
+            discardStaging();
+            return Result::fail("Failed to scan " + variantOutputDir.string() + " - " + ec.message());
+        }
+        for (const auto& path : stale) {
+            timer.addSyscalls();  // unlink / rmdir
+            fs::remove_all(path, ec);
+            if (ec) {
+                discardStaging();
+                return Result::fail("Failed to remove: " + path.string() + " - " + ec.message());
+            }
+            touchedDirs.insert(path.parent_path());
+            ++removed;
+        }
+    } else if (fs::exists(rootStatus)) {
+        timer.addSyscalls();  // unlink
+        if (!fs::remove(variantOutputDir, ec)) {
+            discardStaging();
+            return Result::fail("Failed to remove: " + variantOutputDir.string() + " - " + ec.message());
+        }
+        ++removed;
+    }
+
+    bool createdDirectories = false;
+    std::vector<std::string> treeDirs(dirs.begin(), dirs.end());
+    treeDirs.insert(treeDirs.begin(), "");
+    for (const auto& dir : treeDirs) {
+        timer.addSyscalls();  // mkdir
+        if (fs::create_directories(variantOutputDir / dir, ec)) {
+            createdDirectories = true;
+            touchedDirs.insert((variantOutputDir / dir).lexically_normal().parent_path());
+        } else if (ec) {
+            discardStaging();
+            return Result::fail("Failed to create directory: " + (variantOutputDir / dir).string() +
+                                " - " + ec.message());
+        }
+    }
+
+    for (const auto& relativePath : staged) {
+        fs::path target = variantOutputDir / relativePath;
+        timer.addSyscalls();  // rename
+        fs::rename(stagingDir / relativePath, target, ec);
+        if (ec) {
+            discardStaging();
+            return Result::fail("Failed to replace " + target.string() + " - " + ec.message());
+        }
+        touchedDirs.insert(target.parent_path());
+    }
+    discardStaging();
+
+    for (const auto& relativePath : modeFixes) {
+        fs::path target = variantOutputDir / relativePath;
+        timer.addSyscalls();  // chmod
+        fs::permissions(target, static_cast<fs::perms>(files[relativePath]->mode & 0777), ec);
+        if (ec) {
+            return Result::fail("Failed to set permissions on: " + target.string() + " - " + ec.message());
+        }
+    }
+
+    // Record what is installed now, with stats taken after the renames
+    for (auto& [relativePath, record] : next.files) {
+        DigestCache::Key key;
+        timer.addSyscalls();  // stat
+        if (DigestCache::Key::of(variantOutputDir / relativePath, key)) {
+            record.stat = key;
+        }
+    }
+    if (!next.save(statePath)) {
+        return Result::fail("Updated " + variantOutputDir.string() + " but could not record it: " +
+                            InstalledState::getLastError());
+    }
+    for (auto it = touchedDirs.begin(); durable && it != touchedDirs.end(); ++it) {
+        if (!DurableIo::syncDirectory(*it)) {
+            return Result::fail("Updated " + variantOutputDir.string() + " but could not flush it: " +
+                                DurableIo::getLastError());
+        }
+    }
+
+    if (counts) {
+        counts->written += staged.size();
+        counts->kept += files.size() - staged.size();
+        counts->removed += removed;
+    }
+    bool unchanged = staged.empty() && modeFixes.empty() && removed == 0 && !createdDirectories;
+    return unchanged ? Result::noChange() : Result::ok();
+}
+
 Package::Result Package::signPackage(const crypto::SecretKey& sk,
                                       const std::string& signerName,
                                       const std::string& signerUrl) {
@@ -783,6 +2010,7 @@ Package::Result Package::signPackage(const crypto::SecretKey& sk,
 }
 
 Package::SignatureInfo Package::verifySignature() const {
+    Trace::Span span("package.verify_signature");
     SignatureInfo info{};
     info.is_signed = false;
     info.signature_valid = false;
@@ -796,6 +2024,13 @@ Package::SignatureInfo Package::verifySignature() const {
                      : pkgValidation.errors[0];
         return info;
     }
+    return checkSignature();
+}
+
+Package::SignatureInfo Package::checkSignature() const {
+    SignatureInfo info{};
+    info.is_signed = false;
+    info.signature_valid = false;
     info.package_valid = true;
 
     if (!manifestSig_.has_value()) {
@@ -817,45 +2052,74 @@ Package::SignatureInfo Package::verifySignature() const {
         return info;
     }
 
-    // Extract public key from DID
-    auto pkOpt = crypto::didToPublicKey(manifestSig_->did);
-    if (!pkOpt) {
-        info.error = "Invalid DID in manifest.sig: " + manifestSig_->did;
+    auto sigResult = verifyManifestSignature(manifest_, *manifestSig_);
+    if (!sigResult.success) {
+        info.error = sigResult.error;
         return info;
     }
-    crypto::PublicKey pk = *pkOpt;
 
-    // Decode signature
-    auto sigBytes = crypto::base64Decode(manifestSig_->signature);
-    if (!sigBytes || sigBytes->size() != crypto::SIGNATURE_SIZE) {
-        info.error = "Invalid signature in manifest.sig";
-        return info;
-    }
-    crypto::Signature sig;
-    std::copy(sigBytes->begin(), sigBytes->end(), sig.begin());
+    info.signature_valid = true;
+    return info;
+}
 
-    // Verify Ed25519 signature over manifest.toJson() bytes
-    std::string manifestJson = manifest_.toJson();
-    std::vector<uint8_t> manifestBytes(manifestJson.begin(), manifestJson.end());
+Package::Result Package::verifyManifestSignature(const Manifest& manifest,
+                                                 const crypto::ManifestSig& signature) {
+    return verifyManifestSignatures({{&manifest, &signature}})[0];
+}
 
-    if (!crypto::verify(manifestBytes, pk, sig)) {
-        info.error = "Ed25519 signature verification failed";
-        return info;
+std::vector<Package::Result> Package::verifyManifestSignatures(
+    const std::vector<std::pair<const Manifest*, const crypto::ManifestSig*>>& manifests) {
+    std::vector<Result> results(manifests.size(), Result::ok());
+
+    // Decode every key and signature first; the messages are the
+    // manifest.toJson() bytes each signature covers
+    std::vector<std::string> messages(manifests.size());
+    std::vector<crypto::VerifyItem> items;
+    std::vector<size_t> itemOwner;
+    for (size_t i = 0; i < manifests.size(); ++i) {
+        const crypto::ManifestSig& signature = *manifests[i].second;
+        auto pkOpt = crypto::didToPublicKey(signature.did);
+        if (!pkOpt) {
+            results[i] = Result::fail("Invalid DID in manifest.sig: " + signature.did);
+            continue;
+        }
+        auto sigBytes = crypto::base64Decode(signature.signature);
+        if (!sigBytes || sigBytes->size() != crypto::SIGNATURE_SIZE) {
+            results[i] = Result::fail("Invalid signature in manifest.sig");
+            continue;
+        }
+
+        messages[i] = manifests[i].first->toJson();
+        crypto::VerifyItem item;
+        item.message = reinterpret_cast<const uint8_t*>(messages[i].data());
+        item.messageLen = messages[i].size();
+        item.publicKey = *pkOpt;
+        std::copy(sigBytes->begin(), sigBytes->end(), item.signature.begin());
+        items.push_back(item);
+        itemOwner.push_back(i);
     }
 
-    info.signature_valid = true;
-    return info;
+    auto valid = crypto::verifyBatch(items);
+    for (size_t k = 0; k < items.size(); ++k) {
+        if (!valid[k]) {
+            results[itemOwner[k]] = Result::fail("Ed25519 signature verification failed");
+        }
+    }
+    return results;
 }
 
 void Package::clearSignature() {
     manifestSig_ = std::nullopt;
 }
 
-Package::Result Package::recomputeHashes() {
+Package::Result Package::recomputeHashes(crypto::FileHashCache* hashCache) {
     if (!crypto::init()) {
         return Result::fail("Failed to initialize crypto library — cannot compute content hashes");
     }
-    auto hashes = crypto::computeMerkleTree(entries_);
+    auto hashes = crypto::computeMerkleTree(entries_, hashCache);
+    if (Progress::isCancelled()) {
+        return Result::fail(Progress::CANCELLED_ERROR);
+    }
     manifest_.hashes = std::move(hashes);
     return Result::ok();
 }
@@ -3,15 +3,21 @@
 #include "manifest.h"
 #include "tar_writer.h"
 #include "tar_reader.h"
+#include "byte_io.h"
+#include "digest_cache.h"
+#include "path_filter.h"
+#include "installed_state.h"
 #include "../crypto/manifest_sig.h"
 #include "../crypto/signing.h"
 
 #include <string>
 #include <vector>
+#include <deque>
 #include <set>
 #include <map>
 #include <optional>
 #include <filesystem>
+#include <functional>
 
 namespace lgx {
 
@@ -26,8 +32,10 @@ public:
     struct Result {
         bool success;
         std::string error;
+        bool unchanged = false;  // succeeded without modifying the package
         
         static Result ok() { return {true, ""}; }
+        static Result noChange() { return {true, "", true}; }
         static Result fail(const std::string& msg) { return {false, msg}; }
     };
     
@@ -41,6 +49,25 @@ public:
         
         static VerifyResult ok() { return {true, {}, {}}; }
     };
+
+    /**
+     * What save() and extraction guarantee if the machine crashes part-way.
+     *
+     * Default: save() writes a temporary file and renames it over the
+     * target, so the package is never seen half-written, but nothing is
+     * flushed. Extraction writes files in place.
+     *
+     * Durable: output is flushed to stable storage before it replaces the
+     * target, and the directory holding the rename is flushed after (see
+     * DurableIo). extractVariant() / extractAll() write each variant to a
+     * staging directory and swap it in whole, replacing any existing tree,
+     * so they cannot be combined with a PathFilter. updateVariant() flushes
+     * its staged files before renaming them in.
+     */
+    enum class Durability {
+        Default,
+        Durable
+    };
     
     /**
      * Allowed root entries in an LGX package.
@@ -58,25 +85,135 @@ public:
         const std::filesystem::path& outputPath,
         const std::string& name
     );
+
+    /**
+     * The skeleton package create() writes, in memory.
+     *
+     * @param name Package name (will be lowercased)
+     */
+    static Package skeleton(const std::string& name);
     
     /**
-     * Load an existing package from file.
+     * Load an existing package from file. Fails if manifest.json or
+     * manifest.sig appears more than once in the archive.
      * 
      * @param lgxPath Path to the .lgx file
      * @return Package instance, or nullopt on error
      */
     static std::optional<Package> load(const std::filesystem::path& lgxPath);
+
+    /**
+     * Load a package from an arbitrary byte source.
+     *
+     * The source is only read during the call; the returned Package does not
+     * reference it afterwards.
+     *
+     * @param source Compressed .lgx bytes
+     * @return Package instance, or nullopt on error
+     */
+    static std::optional<Package> load(const ByteSource& source);
+
+    /**
+     * Load a package from caller-owned memory without copying the input.
+     *
+     * @param data Pointer to compressed .lgx bytes
+     * @param size Number of bytes
+     * @return Package instance, or nullopt on error
+     */
+    static std::optional<Package> loadFromMemory(const void* data, size_t size);
+
+    /**
+     * Selects entries for a partial load by archive path.
+     */
+    using EntryFilter = std::function<bool(const std::string& path, bool isDirectory)>;
+
+    /**
+     * Load part of a package: manifest.json, manifest.sig and the entries
+     * `keep` selects. The file is streamed, and the data of other files is
+     * skipped as it goes by, never held in memory.
+     *
+     * The result is for reading and extracting. Its manifest still
+     * describes the whole package, so it does not validate, and saving it
+     * would drop the files left out.
+     *
+     * @param lgxPath Path to the .lgx file
+     * @param keep Called once per entry other than the manifest and signature
+     * @return Package instance, or nullopt on error
+     */
+    static std::optional<Package> load(const std::filesystem::path& lgxPath, const EntryFilter& keep);
+
+    /**
+     * Package metadata: the manifest and, if present, the signature.
+     */
+    struct Metadata {
+        Manifest manifest;
+        std::optional<crypto::ManifestSig> signature;  // nullopt if unsigned or unparseable
+    };
+
+    /**
+     * Read only manifest.json and manifest.sig from a package file.
+     *
+     * Packages written by this library store both right after docs/ and
+     * licenses/, ahead of the variants, so the file is read and inflated
+     * only up to that point. Archives in another order fall back to a full
+     * load. Nothing beyond the manifest is validated, and the gzip CRC is
+     * not checked when reading stops early. Like load(), it fails on a
+     * second manifest.json or manifest.sig among the entries it reads; a
+     * copy after the point where it stops is only caught by load().
+     *
+     * @param lgxPath Path to the .lgx file
+     * @return Metadata, or nullopt on error
+     */
+    static std::optional<Metadata> readMetadata(const std::filesystem::path& lgxPath);
     
     /**
-     * Save the package to a file.
+     * Save the package to a file, through a new temporary file beside it
+     * (`<lgxPath>.tmp.<random>`) that is renamed into place. If lgxPath is
+     * a symlink, the file it points to is replaced and the link kept; an
+     * existing file keeps its permissions.
      * 
      * @param lgxPath Path to write the .lgx file
+     * @param durability Durable to flush before and after the rename
+     * @return Result indicating success or failure
+     */
+    Result save(const std::filesystem::path& lgxPath,
+                Durability durability = Durability::Default) const;
+
+    /**
+     * Save the package to a byte sink. Compressed output is streamed to the
+     * sink in chunks; the bytes are identical to what save(path) writes.
+     *
+     * @param sink Destination for the .lgx bytes
      * @return Result indicating success or failure
      */
-    Result save(const std::filesystem::path& lgxPath) const;
+    Result save(ByteSink& sink) const;
+
+    /**
+     * Replace a file the way save() does: `write` fills a new temporary
+     * file beside it (`<path>.tmp.<random>`, created exclusively), which is
+     * then renamed over it. Symlinks are followed, an existing file keeps
+     * its permissions, and on failure the temporary file is removed and
+     * the file left as it was.
+     *
+     * @param path File to replace
+     * @param write Writes the new contents to the sink and finishes it
+     * @param durability Durable to flush before and after the rename
+     * @return The failure of `write`, or why the file could not be replaced
+     */
+    static Result replaceFile(const std::filesystem::path& path,
+                              const std::function<Result(ByteSink&)>& write,
+                              Durability durability = Durability::Default);
+
+    /**
+     * True if `path` is written when saving to lgxPath: lgxPath, the file
+     * it resolves to, or one of replaceFile()'s temporary files. Lets file
+     * watchers ignore a package's own writes.
+     */
+    static bool isSaveOutput(const std::filesystem::path& path, const std::filesystem::path& lgxPath);
     
     /**
-     * Verify a package file.
+     * Verify a package file: structure and content hashes, as
+     * verify(lgxPath, VerifyLevel::Hashes).
      * 
      * @param lgxPath Path to the .lgx file
      * @return VerifyResult with all validation errors/warnings
@@ -92,13 +229,86 @@ public:
      * @param mainPath Relative path to main file. Optional for `ui_qml`
      * directory variants, where `view` is the required entry point and `main`
      * only describes an optional backend plugin.
-     * @return Result indicating success or failure
+     * @return Result indicating success or failure; `unchanged` if the
+     *         variant already holds exactly these files and main (see
+     *         addInputs())
      */
     Result addVariant(
         const std::string& variant,
         const std::filesystem::path& filesPath,
         const std::optional<std::string>& mainPath = std::nullopt
     );
+
+    /**
+     * One variant for addInputs(); same meaning as the addVariant() arguments.
+     */
+    struct VariantInput {
+        std::string variant;
+        std::filesystem::path filesPath;
+        std::optional<std::string> mainPath;
+    };
+
+    /**
+     * Everything addInputs() ingests.
+     */
+    struct Inputs {
+        std::vector<VariantInput> variants;
+        std::vector<std::filesystem::path> docs;      // files or directories, placed under docs/
+        std::vector<std::filesystem::path> licenses;  // files or directories, placed under licenses/
+        DigestCache* digestCache = nullptr;           // optional: reuse and record file digests
+    };
+
+    /**
+     * Add several variants, docs and licenses in one pass.
+     *
+     * All inputs are read in parallel, then applied in order, exactly as a
+     * sequence of addVariant() calls would apply them; the result is the
+     * same package. Hashes are recomputed once at the end. A file input
+     * keeps its name (docs/README.md); a directory's contents go directly
+     * under docs/ or licenses/, which are replaced if any docs or licenses
+     * are given. On failure the package is left unchanged.
+     *
+     * With a digestCache, files it has a digest for are not hashed, and the
+     * digests of the rest are recorded in it (the caller saves it).
+     *
+     * If the inputs match what the package already holds (same files,
+     * contents, modes, empty directories and main entries), nothing is
+     * replaced or rehashed, the signature is kept and the result is
+     * `unchanged`, so the caller can skip saving.
+     *
+     * @param hashCache File digests to reuse and extend when recomputing
+     *        hashes (see recomputeHashes()), or nullptr
+     * @return Result indicating success or failure
+     */
+    Result addInputs(const Inputs& inputs, crypto::FileHashCache* hashCache = nullptr);
+
+    /**
+     * A changed input path and where it lives in the archive.
+     */
+    struct PathChange {
+        std::string archivePath;         // e.g. "variants/linux-amd64/qml/Main.qml"
+        std::filesystem::path fsPath;
+    };
+
+    /**
+     * Bring changed paths up to date: a file is re-read, a directory is
+     * re-read with everything under it, and a path that no longer exists
+     * is removed with everything under it. Hashes are then recomputed with
+     * `hashCache` (see recomputeHashes()), after dropping the changed paths
+     * from it. Used by watch mode; manifest main entries are not touched.
+     *
+     * @return Result indicating success or failure
+     */
+    Result updatePaths(const std::vector<PathChange>& changes,
+                       crypto::FileHashCache* hashCache = nullptr);
+
+    /**
+     * The entries save() archives: manifest.json, manifest.sig, every
+     * directory (including implied parents) and the package's files, in no
+     * particular order. Files point into the package; the rest are created
+     * in `generated`, which must outlive the result.
+     */
+    std::vector<const TarEntry*> archiveEntries(std::deque<TarEntry>& generated) const;
     
     /**
      * Remove a variant.
@@ -134,17 +344,68 @@ public:
      * 
      * @param variant Variant name (case-insensitive)
      * @param outputDir Directory to extract to (variant contents go to outputDir/variant/)
+     * @param filter Paths, relative to the variant root, to extract; with a
+     *        filter, directories are only created for what it selects
+     * @param durability Durable to write a staging tree, flush it and swap
+     *        it in for outputDir/variant/ (see Durability); fails with a
+     *        non-empty filter
      * @return Result indicating success or failure
      */
-    Result extractVariant(const std::string& variant, const std::filesystem::path& outputDir) const;
+    Result extractVariant(const std::string& variant, const std::filesystem::path& outputDir,
+                          const PathFilter& filter = PathFilter(),
+                          Durability durability = Durability::Default) const;
     
     /**
      * Extract all variants to an output directory.
      * 
      * @param outputDir Directory to extract to (each variant goes to outputDir/variant/)
+     * @param filter Paths to extract, as for extractVariant()
+     * @param durability As for extractVariant()
      * @return Result indicating success or failure
      */
-    Result extractAll(const std::filesystem::path& outputDir) const;
+    Result extractAll(const std::filesystem::path& outputDir,
+                      const PathFilter& filter = PathFilter(),
+                      Durability durability = Durability::Default) const;
+
+    /**
+     * Files handled by updateVariant() / updateAll().
+     */
+    struct UpdateCounts {
+        size_t written = 0;  // new or changed files written
+        size_t kept = 0;     // files already installed with these contents
+        size_t removed = 0;  // files and directories no longer in the package
+    };
+
+    /**
+     * Bring a previously extracted variant up to date with this package,
+     * writing only what changed.
+     *
+     * If the variant's InstalledState sidecar records this package's
+     * variant hash and every installed file still has its recorded stat,
+     * nothing is read or written and the result is `unchanged`. Otherwise
+     * files whose size and SHA-256 already match are kept (modes are
+     * fixed up), changed files are written to a staging directory and
+     * renamed into place, and files and directories the package no longer
+     * has are removed. Until the commit starts the installed tree is not
+     * touched, so a failure leaves it as it was; the sidecar is written
+     * last.
+     *
+     * @param variant Variant name (case-insensitive)
+     * @param outputDir Directory the variant was extracted to (contents in outputDir/variant/)
+     * @param counts If non-null, incremented by what was done
+     * @param durability Durable to flush staged files before the commit and
+     *        the directories it changed after
+     * @return Result; `unchanged` if the installed variant was already current
+     */
+    Result updateVariant(const std::string& variant, const std::filesystem::path& outputDir,
+                         UpdateCounts* counts = nullptr,
+                         Durability durability = Durability::Default) const;
+
+    /**
+     * updateVariant() for every variant; `unchanged` if all were current.
+     */
+    Result updateAll(const std::filesystem::path& outputDir, UpdateCounts* counts = nullptr,
+                     Durability durability = Durability::Default) const;
     
     /**
      * Get entry info for verification.
@@ -188,6 +449,19 @@ public:
      */
     VerifyResult validatePackage() const;
 
+    /**
+     * validatePackage() without the content hashes: manifest, root layout,
+     * paths and main/view files. Needs only the entry list, not file data.
+     */
+    VerifyResult validateStructure() const;
+
+    /**
+     * Check whether save() would write the same manifest.json and the same
+     * entries (paths, contents and modes) for both packages. Signatures are
+     * not compared, so an unsigned rebuild of a signed package matches it.
+     */
+    bool sameContent(const Package& other) const;
+
     /**
      * Verify the package signature.
      * First validates the package (structure + hashes), then checks
@@ -199,6 +473,52 @@ public:
      */
     SignatureInfo verifySignature() const;
 
+    /**
+     * verifySignature() for a package validatePackage() has already
+     * accepted: checks the signature only, without hashing the content
+     * again. package_valid is set.
+     */
+    SignatureInfo checkSignature() const;
+
+    /**
+     * How much verify() checks. Each level includes the ones before it.
+     */
+    enum class VerifyLevel {
+        Structure,  // validateStructure(); file data is neither kept nor hashed
+        Hashes,     // validatePackage(): adds the content hashes
+        Full        // adds the signature, if the package is signed
+    };
+
+    /**
+     * Verify a package file at a given level. The file is read and
+     * inflated once, and each byte of content is hashed at most once.
+     *
+     * @param lgxPath Path to the .lgx file
+     * @param level What to check
+     * @param signature For VerifyLevel::Full: set to the signature check
+     *        (see checkSignature()) if the package validates
+     * @return VerifyResult with all validation errors/warnings
+     */
+    static VerifyResult verify(const std::filesystem::path& lgxPath, VerifyLevel level,
+                               SignatureInfo* signature = nullptr);
+
+    /**
+     * Check an Ed25519 signature over a manifest alone. Content hashes are
+     * not checked, so this only proves who published the manifest.
+     *
+     * @return Result with the reason on failure
+     */
+    static Result verifyManifestSignature(const Manifest& manifest,
+                                          const crypto::ManifestSig& signature);
+
+    /**
+     * verifyManifestSignature() for many manifests, with all the Ed25519
+     * checks made in one crypto::verifyBatch(). results[i] is what
+     * verifyManifestSignature() returns for manifests[i].
+     */
+    static std::vector<Result> verifyManifestSignatures(
+        const std::vector<std::pair<const Manifest*, const crypto::ManifestSig*>>& manifests);
+
     /**
      * Check if the package has a signature.
      */
@@ -216,8 +536,11 @@ public:
      * Called automatically when package content is modified.
      * Hashes are always kept up to date in manifest.json.
      * Returns failure if crypto initialization fails.
+     *
+     * @param hashCache File digests to reuse and extend (see
+     *        crypto::computeMerkleTree()), or nullptr to hash every file
      */
-    Result recomputeHashes();
+    Result recomputeHashes(crypto::FileHashCache* hashCache = nullptr);
 
     /**
      * Get last error message.
@@ -238,17 +561,98 @@ private:
     void rebuildTar();
     
     /**
-     * Add filesystem entries recursively.
+     * Archive path and DigestCache key of each file read whose stat did not
+     * change while it was read.
      */
-    Result addFilesystemEntries(
+    using FileStamps = std::vector<std::pair<std::string, DigestCache::Key>>;
+
+    /**
+     * Read filesystem entries recursively into `out`, stamping each file
+     * read if `stamps` is given.
+     */
+    static Result addFilesystemEntries(
         const std::filesystem::path& fsPath,
-        const std::string& archiveBasePath
+        const std::string& archiveBasePath,
+        std::vector<TarEntry>& out,
+        FileStamps* stamps = nullptr
     );
     
+    /**
+     * Write a variant's entries (all under variants/<variantLc>/) to
+     * outputDir/<variantLc>/, skipping those `filter` does not select.
+     */
+    Result extractVariantEntries(
+        const std::string& variantLc,
+        const std::vector<const TarEntry*>& variantEntries,
+        const std::filesystem::path& outputDir,
+        const PathFilter& filter,
+        Durability durability
+    ) const;
+
+    /**
+     * Write the selected entries of a variant under variantOutputDir
+     * (outputDir/<variantLc>/, or a staging directory standing in for it).
+     */
+    Result writeVariantTree(
+        const std::string& variantLc,
+        const std::vector<const TarEntry*>& variantEntries,
+        const std::filesystem::path& variantOutputDir,
+        const PathFilter& filter
+    ) const;
+
+    /**
+     * Update outputDir/<variantLc>/ from a variant's entries (see
+     * updateVariant()).
+     */
+    Result updateVariantEntries(
+        const std::string& variantLc,
+        const std::vector<const TarEntry*>& variantEntries,
+        const std::filesystem::path& outputDir,
+        UpdateCounts* counts,
+        Durability durability
+    ) const;
+
+    /**
+     * Entries of each variant, by variant name. A bucket exists for every
+     * variant hasVariant() would find, even one holding no entries.
+     */
+    std::map<std::string, std::vector<const TarEntry*>> variantBuckets() const;
+
+    /**
+     * Stream a package file (see load(path, keep)). With `listSkipped`,
+     * entries `keep` does not select are still listed, without data.
+     */
+    static std::optional<Package> loadStreamed(const std::filesystem::path& lgxPath,
+                                               const EntryFilter& keep, bool listSkipped);
+
+    /**
+     * Check the content hashes against the manifest, adding errors to
+     * `result`.
+     */
+    void checkContentHashes(VerifyResult& result) const;
+
     /**
      * Remove entries for a variant.
      */
     void removeVariantEntries(const std::string& variant);
+
+    /**
+     * Remove a top-level directory ("docs", "licenses") and everything in it.
+     */
+    void removeTopLevelEntries(const std::string& dir);
+
+    /**
+     * Entries at or below an archive directory ("variants/linux-amd64").
+     */
+    std::vector<const TarEntry*> entriesUnder(const std::string& dir) const;
+
+    /**
+     * Check whether two entry lists archive the same: the same files with
+     * the same contents and modes, and the same empty directories. Order,
+     * trailing slashes and directories implied by their contents do not
+     * matter.
+     */
+    static bool sameEntries(std::vector<const TarEntry*> a, std::vector<const TarEntry*> b);
     
     /**
      * Get directory entries that need to be created for a path.
@@ -0,0 +1,142 @@
+#include "package_cache.h"
+
+#include <iterator>
+
+namespace lgx {
+
+thread_local std::string PackageCache::lastError_;
+
+PackageCache& PackageCache::shared() {
+    static PackageCache cache;
+    return cache;
+}
+
+void PackageCache::setBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    budget_ = bytes;
+    evictToFit(budget_);
+}
+
+size_t PackageCache::getBudget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budget_;
+}
+
+std::shared_ptr<Package> PackageCache::load(const std::filesystem::path& path) {
+    if (getBudget() == 0) {
+        auto pkgOpt = Package::load(path);
+        if (!pkgOpt) {
+            lastError_ = Package::getLastError();
+            return nullptr;
+        }
+        return std::make_shared<Package>(std::move(*pkgOpt));
+    }
+
+    std::error_code ec;
+    std::string cacheKey = std::filesystem::absolute(path, ec).lexically_normal().string();
+    if (ec) {
+        cacheKey = path.lexically_normal().string();
+    }
+
+    FileIdentity before;
+    bool haveKey = FileIdentity::of(path, before);
+
+    if (haveKey) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(cacheKey);
+        if (it != index_.end()) {
+            if (it->second->key == before) {
+                ++stats_.hits;
+                lru_.splice(lru_.begin(), lru_, it->second);
+                return it->second->package;
+            }
+            // The file changed on disk since it was cached
+            erase(it->second);
+        }
+    }
+
+    // Decode outside the lock so other loads are not serialized behind us
+    auto pkgOpt = Package::load(path);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.misses;
+    }
+    if (!pkgOpt) {
+        lastError_ = Package::getLastError();
+        return nullptr;
+    }
+    auto package = std::make_shared<Package>(std::move(*pkgOpt));
+
+    // Only cache if the file did not change while it was being read, so an
+    // entry's contents always match its key
+    FileIdentity after;
+    if (!haveKey || !FileIdentity::of(path, after) || after != before) {
+        return package;
+    }
+
+    size_t bytes = decodedSize(*package);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (bytes > budget_) {
+        return package;
+    }
+
+    auto it = index_.find(cacheKey);
+    if (it != index_.end()) {
+        erase(it->second);  // a concurrent load got here first
+    }
+    lru_.push_front(Entry{cacheKey, before, package, bytes});
+    index_[cacheKey] = lru_.begin();
+    stats_.bytes += bytes;
+    evictToFit(budget_);
+
+    return package;
+}
+
+void PackageCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    stats_.bytes = 0;
+}
+
+PackageCache::Stats PackageCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.entries = lru_.size();
+    stats.budget = budget_;
+    return stats;
+}
+
+void PackageCache::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.hits = 0;
+    stats_.misses = 0;
+    stats_.evictions = 0;
+}
+
+size_t PackageCache::decodedSize(const Package& package) {
+    size_t bytes = sizeof(Package);
+    for (const auto& entry : package.getEntries()) {
+        bytes += sizeof(TarEntry) + entry.path.size() + entry.data.size();
+    }
+    return bytes;
+}
+
+std::string PackageCache::getLastError() {
+    return lastError_;
+}
+
+void PackageCache::evictToFit(size_t budget) {
+    while (!lru_.empty() && stats_.bytes > budget) {
+        erase(std::prev(lru_.end()));
+        ++stats_.evictions;
+    }
+}
+
+void PackageCache::erase(std::list<Entry>::iterator it) {
+    stats_.bytes -= it->bytes;
+    index_.erase(it->path);
+    lru_.erase(it);
+}
+
+} // namespace lgx
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "package.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace lgx {
+
+/**
+ * PackageCache keeps recently loaded packages in decoded form so repeated
+ * loads of the same .lgx skip inflating and parsing.
+ *
+ * Entries are keyed by absolute path and validated against the file's
+ * device, inode, size and modification time (nanoseconds), so a package
+ * that changes on disk is reloaded automatically. The cache is bounded by
+ * a byte budget over the decoded contents and evicts least recently used
+ * entries first. It is disabled (budget 0) until a budget is set.
+ *
+ * Cached packages are shared with callers and must be treated as
+ * immutable: copy before modifying. All methods are thread-safe.
+ */
+class PackageCache {
+public:
+    /**
+     * Counters and current usage.
+     */
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t budget = 0;
+    };
+
+    /**
+     * The process-wide cache used by the C API.
+     */
+    static PackageCache& shared();
+
+    /**
+     * Set the byte budget. Shrinking evicts entries until usage fits;
+     * 0 disables the cache and drops every entry.
+     */
+    void setBudget(size_t bytes);
+
+    /**
+     * Current byte budget (0 = disabled).
+     */
+    size_t getBudget() const;
+
+    /**
+     * Load a package through the cache.
+     *
+     * When the cache is disabled this is equivalent to Package::load().
+     *
+     * @param path Path to the .lgx file
+     * @return Shared decoded package, or nullptr on error (see getLastError())
+     */
+    std::shared_ptr<Package> load(const std::filesystem::path& path);
+
+    /**
+     * Drop every entry (counters are kept).
+     */
+    void clear();
+
+    /**
+     * Snapshot of the counters and current usage.
+     */
+    Stats getStats() const;
+
+    /**
+     * Reset hit, miss and eviction counters to zero.
+     */
+    void resetStats();
+
+    /**
+     * Approximate number of bytes held by a decoded package.
+     */
+    static size_t decodedSize(const Package& package);
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    struct Entry {
+        std::string path;
+        FileIdentity key;
+        std::shared_ptr<Package> package;
+        size_t bytes;
+    };
+
+    void evictToFit(size_t budget);
+    void erase(std::list<Entry>::iterator it);
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;  // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    size_t budget_ = 0;
+    Stats stats_;
+
+    static thread_local std::string lastError_;
+};
+
+} // namespace lgx
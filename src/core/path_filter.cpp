@@ -0,0 +1,163 @@
+#include "path_filter.h"
+
+namespace lgx {
+
+namespace {
+
+// Match one bracket expression at `p` against `c`. Sets `end` past the
+// closing ']'; returns false with `end` unset if the bracket is unclosed,
+// in which case '[' is an ordinary character.
+bool parseClass(const char* p, const char* pe, char c, bool& matched, const char*& end) {
+    const char* q = p + 1;
+    bool negated = q < pe && (*q == '!' || *q == '^');
+    if (negated) {
+        ++q;
+    }
+    bool found = false;
+    bool first = true;
+    for (; q < pe && (*q != ']' || first); first = false) {
+        char lo = *q++;
+        char hi = lo;
+        if (q + 1 < pe && *q == '-' && q[1] != ']') {
+            hi = q[1];
+            q += 2;
+        }
+        if (lo <= c && c <= hi) {
+            found = true;
+        }
+    }
+    if (q >= pe) {
+        return false;
+    }
+    matched = c != '/' && found != negated;
+    end = q + 1;
+    return true;
+}
+
+// `pb` is the start of the whole pattern, for telling where components begin
+bool matchRange(const char* pb, const char* p, const char* pe, const char* s, const char* se) {
+    while (p < pe) {
+        if (*p == '*') {
+            const char* stars = p;
+            while (p < pe && *p == '*') {
+                ++p;
+            }
+            // "**" as a whole component spans directories
+            bool wholeComponent = (stars == pb || stars[-1] == '/') && (p == pe || *p == '/');
+            if (p - stars >= 2 && wholeComponent) {
+                if (p == pe) {
+                    return true;
+                }
+                // "**/rest": rest at this component or any later one
+                ++p;
+                for (const char* t = s;; ++t) {
+                    if (matchRange(pb, p, pe, t, se)) {
+                        return true;
+                    }
+                    while (t < se && *t != '/') {
+                        ++t;
+                    }
+                    if (t == se) {
+                        return false;
+                    }
+                }
+            }
+            for (const char* t = s;; ++t) {
+                if (matchRange(pb, p, pe, t, se)) {
+                    return true;
+                }
+                if (t == se || *t == '/') {
+                    return false;
+                }
+            }
+        }
+        if (s == se) {
+            return false;
+        }
+        if (*p == '?') {
+            if (*s == '/') {
+                return false;
+            }
+            ++p;
+            ++s;
+            continue;
+        }
+        if (*p == '[') {
+            bool matched = false;
+            const char* end = nullptr;
+            if (parseClass(p, pe, *s, matched, end)) {
+                if (!matched) {
+                    return false;
+                }
+                p = end;
+                ++s;
+                continue;
+            }
+        }
+        if (*p == '\\' && p + 1 < pe) {
+            ++p;
+        }
+        if (*p != *s) {
+            return false;
+        }
+        ++p;
+        ++s;
+    }
+    return s == se;
+}
+
+} // namespace
+
+PathFilter::PathFilter(const std::vector<std::string>& include, const std::vector<std::string>& exclude)
+    : include_(compile(include)), exclude_(compile(exclude)) {}
+
+std::vector<PathFilter::Pattern> PathFilter::compile(const std::vector<std::string>& patterns) {
+    std::vector<Pattern> result;
+    for (std::string glob : patterns) {
+        while (!glob.empty() && glob.back() == '/') {
+            glob.pop_back();
+        }
+        size_t start = glob.find_first_not_of('/');
+        if (start == std::string::npos) {
+            continue;  // empty pattern: matches nothing
+        }
+        bool anchored = glob.find('/') != std::string::npos;
+        result.push_back({glob.substr(start), anchored});
+    }
+    return result;
+}
+
+bool PathFilter::matchGlob(const std::string& pattern, const std::string& text) {
+    return matchRange(pattern.data(), pattern.data(), pattern.data() + pattern.size(),
+                      text.data(), text.data() + text.size());
+}
+
+bool PathFilter::matchesAny(const std::vector<Pattern>& patterns, const std::string& path) {
+    for (const auto& pattern : patterns) {
+        // Try the path and each of its parent directories (anchored), or
+        // each component name (unanchored)
+        size_t start = 0;
+        while (start <= path.size()) {
+            size_t end = path.find('/', start);
+            if (end == std::string::npos) {
+                end = path.size();
+            }
+            std::string candidate = pattern.anchored ? path.substr(0, end)
+                                                     : path.substr(start, end - start);
+            if (matchGlob(pattern.glob, candidate)) {
+                return true;
+            }
+            start = end + 1;
+        }
+    }
+    return false;
+}
+
+bool PathFilter::matches(const std::string& path) const {
+    if (!include_.empty() && !matchesAny(include_, path)) {
+        return false;
+    }
+    return !matchesAny(exclude_, path);
+}
+
+} // namespace lgx
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace lgx {
+
+/**
+ * PathFilter selects archive paths by include and exclude glob patterns,
+ * for filtered extraction (`lgx extract --include/--exclude`).
+ *
+ * A path is selected if it matches any include pattern (or there are none)
+ * and no exclude pattern. Paths are '/'-separated and relative, e.g. to a
+ * variant root. Patterns work like .gitignore entries:
+ * - `*` matches any run of characters within one path component, `?` one
+ *   character, `[abc]` / `[a-z]` / `[!abc]` one character of a set, and
+ *   `**` any number of whole components;
+ * - a pattern without '/' is matched against each component name, so
+ *   `*.debug` matches at any depth; a pattern with '/' is matched from the
+ *   root (a leading or trailing '/' is ignored);
+ * - a pattern that matches a directory also matches everything under it.
+ */
+class PathFilter {
+public:
+    /**
+     * A filter that selects every path.
+     */
+    PathFilter() = default;
+
+    /**
+     * @param include Patterns a path must match one of (none: any path)
+     * @param exclude Patterns a path must match none of
+     */
+    PathFilter(const std::vector<std::string>& include, const std::vector<std::string>& exclude);
+
+    /**
+     * True if the filter selects every path.
+     */
+    bool empty() const { return include_.empty() && exclude_.empty(); }
+
+    /**
+     * Check whether a relative path is selected.
+     */
+    bool matches(const std::string& path) const;
+
+    /**
+     * Match a whole string against one glob pattern (no component or
+     * directory rules; `*` and `?` do not match '/').
+     */
+    static bool matchGlob(const std::string& pattern, const std::string& text);
+
+private:
+    struct Pattern {
+        std::string glob;
+        bool anchored;  // contains '/': matched from the root
+    };
+
+    std::vector<Pattern> include_;
+    std::vector<Pattern> exclude_;
+
+    static std::vector<Pattern> compile(const std::vector<std::string>& patterns);
+    static bool matchesAny(const std::vector<Pattern>& patterns, const std::string& path);
+};
+
+} // namespace lgx
@@ -1,4 +1,5 @@
 #include "path_normalizer.h"
+#include "stats.h"
 
 #include <unicode/normalizer2.h>
 #include <unicode/unistr.h>
@@ -6,11 +7,14 @@
 #include <unicode/utypes.h>
 
 #include <algorithm>
-#include <sstream>
 
 namespace lgx {
 
 std::optional<std::string> PathNormalizer::toNFC(const std::string& path) {
+    Stats::Timer timer(Stats::Phase::Normalize);
+    timer.addEntries();
+    timer.addBytesIn(path.size());
+
     UErrorCode status = U_ZERO_ERROR;
     const icu::Normalizer2* normalizer = icu::Normalizer2::getNFCInstance(status);
     
@@ -32,11 +36,16 @@ std::optional<std::string> PathNormalizer::toNFC(const std::string& path) {
     // Convert back to UTF-8
     std::string result;
     normalized.toUTF8String(result);
+    timer.addBytesOut(result.size());
     
     return result;
 }
 
 bool PathNormalizer::isNFC(const std::string& str) {
+    Stats::Timer timer(Stats::Phase::Normalize);
+    timer.addEntries();
+    timer.addBytesIn(str.size());
+
     UErrorCode status = U_ZERO_ERROR;
     const icu::Normalizer2* normalizer = icu::Normalizer2::getNFCInstance(status);
     
@@ -106,7 +115,6 @@ std::string PathNormalizer::normalizeSeparators(const std::string& path) {
 }
 
 std::string PathNormalizer::toLowercase(const std::string& str) {
-    UErrorCode status = U_ZERO_ERROR;
     icu::UnicodeString ustr = icu::UnicodeString::fromUTF8(str);
     ustr.toLower();
     
@@ -194,27 +202,39 @@ bool PathNormalizer::isAbsolute(const std::string& path) {
 }
 
 std::vector<std::string> PathNormalizer::splitPath(const std::string& path) {
+    // Single pass over the bytes: archive paths come from untrusted
+    // packages, so this stays linear with no per-component stream overhead
     std::vector<std::string> components;
-    auto normalized = normalizeSeparators(path);
-    
-    std::stringstream ss(normalized);
-    std::string component;
+    size_t start = 0;
     
-    while (std::getline(ss, component, '/')) {
-        if (!component.empty() && component != ".") {
-            components.push_back(component);
+    for (size_t i = 0; i <= path.size(); ++i) {
+        if (i < path.size() && path[i] != '/' && path[i] != '\\') {
+            continue;
+        }
+        size_t length = i - start;
+        if (length > 0 && !(length == 1 && path[start] == '.')) {
+            components.emplace_back(path, start, length);
         }
+        start = i + 1;
     }
     
     return components;
 }
 
 std::string PathNormalizer::getRootComponent(const std::string& archivePath) {
-    auto components = splitPath(archivePath);
-    if (components.empty()) {
-        return "";
+    // Only the first component is needed; don't split the whole path
+    size_t start = 0;
+    for (size_t i = 0; i <= archivePath.size(); ++i) {
+        if (i < archivePath.size() && archivePath[i] != '/' && archivePath[i] != '\\') {
+            continue;
+        }
+        size_t length = i - start;
+        if (length > 0 && !(length == 1 && archivePath[start] == '.')) {
+            return archivePath.substr(start, length);
+        }
+        start = i + 1;
     }
-    return components[0];
+    return "";
 }
 
 } // namespace lgx
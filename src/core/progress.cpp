@@ -0,0 +1,52 @@
+#include "progress.h"
+
+namespace lgx {
+
+thread_local Progress::Context* Progress::current_ = nullptr;
+
+Progress::Scope::Scope(Context* context) : previous_(current_) {
+    current_ = context;
+}
+
+Progress::Scope::~Scope() {
+    current_ = previous_;
+}
+
+void Progress::addBytes(uint64_t count) {
+    Context* context = current_;
+    if (!context || count == 0) {
+        return;
+    }
+    context->bytesProcessed.fetch_add(count, std::memory_order_relaxed);
+    notify(context);
+}
+
+void Progress::setBytesTotal(uint64_t total) {
+    Context* context = current_;
+    if (!context) {
+        return;
+    }
+    context->bytesTotal.store(total, std::memory_order_relaxed);
+}
+
+void Progress::addEntries(uint64_t count) {
+    Context* context = current_;
+    if (!context || count == 0) {
+        return;
+    }
+    context->entriesProcessed.fetch_add(count, std::memory_order_relaxed);
+    notify(context);
+}
+
+bool Progress::isCancelled() {
+    Context* context = current_;
+    return context && context->cancelled.load(std::memory_order_relaxed);
+}
+
+void Progress::notify(Context* context) {
+    if (context->onUpdate) {
+        context->onUpdate();
+    }
+}
+
+} // namespace lgx
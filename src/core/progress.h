@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+namespace lgx {
+
+/**
+ * Progress reporting and cooperative cancellation for long-running operations.
+ *
+ * A caller installs a Progress::Context on the current thread with a
+ * Progress::Scope. GzipHandler, TarReader, the Merkle code and Package report
+ * work to the installed context and poll it for cancellation at chunk and
+ * entry boundaries. Without an installed context every call is a no-op.
+ *
+ * The counters are atomics so another thread may poll them (and request
+ * cancellation) while the operation runs.
+ */
+class Progress {
+public:
+    /**
+     * Error message used by operations that stop because of cancellation.
+     */
+    static constexpr const char* CANCELLED_ERROR = "Operation cancelled";
+
+    /**
+     * Shared state for one operation.
+     */
+    struct Context {
+        std::atomic<uint64_t> bytesProcessed{0};  // bytes inflated / written
+        std::atomic<uint64_t> bytesTotal{0};      // expected bytes, 0 if unknown
+        std::atomic<uint64_t> entriesProcessed{0};
+        std::atomic<bool> cancelled{false};
+
+        /**
+         * Called on the working thread after each report (may be empty).
+         */
+        std::function<void()> onUpdate;
+    };
+
+    /**
+     * Installs a context on the current thread for the lifetime of the scope.
+     * Scopes nest; the previous context is restored on destruction.
+     */
+    class Scope {
+    public:
+        explicit Scope(Context* context);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Context* previous_;
+    };
+
+    /**
+     * Report processed bytes.
+     */
+    static void addBytes(uint64_t count);
+
+    /**
+     * Report the expected total number of bytes (0 = unknown).
+     */
+    static void setBytesTotal(uint64_t total);
+
+    /**
+     * Report processed entries (tar entries read, files extracted).
+     */
+    static void addEntries(uint64_t count = 1);
+
+    /**
+     * Check whether the current operation has been asked to stop.
+     */
+    static bool isCancelled();
+
+private:
+    static void notify(Context* context);
+
+    static thread_local Context* current_;
+};
+
+} // namespace lgx
@@ -0,0 +1,508 @@
+#include "resolver.h"
+#include "catalog.h"
+
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include <unordered_map>
+
+namespace lgx {
+
+thread_local std::string Resolver::lastError_;
+
+namespace {
+
+std::string toLower(const std::string& s) {
+    std::string out = s;
+    std::transform(out.begin(), out.end(), out.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return out;
+}
+
+} // namespace
+
+/**
+ * State of one resolve() call: the constraints collected on each package,
+ * the choices made so far and a trail to undo them when backtracking.
+ */
+class ResolverSearch {
+public:
+    ResolverSearch(const Resolver& resolver, size_t maxSteps)
+        : r_(resolver), maxSteps_(maxSteps), any_(SemverRange::any()),
+          state_(resolver.names_.size()) {}
+
+    Resolver::Result run(const std::vector<Dependency>& requirements);
+
+private:
+    static constexpr size_t NONE = static_cast<size_t>(-1);
+
+    struct Constraint {
+        size_t name;
+        const SemverRange* range;
+        const std::string* rangeText;  // as written, for messages
+        const std::string* signer;
+        size_t depth;                  // decision that added it, NONE for the request
+        size_t from;                   // candidate that added it, NONE for the request
+    };
+
+    struct NameState {
+        std::vector<Constraint> constraints;
+        size_t selected = NONE;
+        size_t selectedDepth = NONE;
+        size_t viable = 0;             // candidates accepted by every constraint
+        bool queued = false;
+    };
+
+    enum class Undo { Constraint, Select, Queue, Viable };
+
+    struct TrailEntry {
+        Undo kind;
+        size_t name;
+        size_t previous;               // Viable: the count before
+    };
+
+    // Candidates that cannot all be chosen together
+    struct Nogood {
+        std::vector<size_t> candidates;
+        std::string reason;
+    };
+
+    struct Frame {
+        size_t name;                   // package decided at this depth
+        size_t next = 0;               // next candidate to try
+        size_t trailMark = 0;
+        std::set<size_t> conflict;     // earlier decisions that caused failures here
+        std::string failure;           // latest reason a candidate failed
+    };
+
+    const Resolver& r_;
+    size_t maxSteps_;
+    SemverRange any_;
+    std::vector<NameState> state_;
+    std::vector<size_t> order_;        // names in the order they were first required
+    std::vector<TrailEntry> trail_;
+    std::vector<Nogood> nogoods_;
+    std::unordered_map<size_t, std::vector<size_t>> nogoodsOf_;  // candidate -> nogoods_ indices
+    std::vector<SemverRange> rootRanges_;
+    std::vector<std::string> rootRangeTexts_;
+    size_t steps_ = 0;
+
+    bool accepts(size_t name, size_t candidate) const {
+        const auto& node = r_.candidates_[candidate];
+        for (const auto& c : state_[name].constraints) {
+            if (!matches(c, node)) return false;
+        }
+        return true;
+    }
+
+    static bool matches(const Constraint& c, const Resolver::Node& node) {
+        if (!c.signer->empty() && node.candidate.signer != *c.signer) return false;
+        return c.range->satisfies(node.version);
+    }
+
+    void addConstraint(size_t name, const Constraint& c) {
+        state_[name].constraints.push_back(c);
+        trail_.push_back({Undo::Constraint, name, 0});
+        if (!state_[name].queued) {
+            state_[name].queued = true;
+            order_.push_back(name);
+            trail_.push_back({Undo::Queue, name, 0});
+        }
+    }
+
+    void select(size_t name, size_t candidate, size_t depth) {
+        state_[name].selected = candidate;
+        state_[name].selectedDepth = depth;
+        trail_.push_back({Undo::Select, name, 0});
+    }
+
+    void undoTo(size_t mark) {
+        while (trail_.size() > mark) {
+            TrailEntry entry = trail_.back();
+            trail_.pop_back();
+            auto& ns = state_[entry.name];
+            switch (entry.kind) {
+                case Undo::Constraint: ns.constraints.pop_back(); break;
+                case Undo::Select: ns.selected = NONE; break;
+                case Undo::Queue:
+                    ns.queued = false;
+                    order_.pop_back();
+                    break;
+                case Undo::Viable: ns.viable = entry.previous; break;
+            }
+        }
+    }
+
+    /**
+     * After a constraint was added to name at depth, check that name can
+     * still be satisfied and update its count of viable candidates. On
+     * failure, reasons receives the earlier decisions involved and message
+     * a description.
+     */
+    bool stillSatisfiable(size_t name, size_t depth, std::set<size_t>& reasons,
+                          std::string& message) {
+        auto& ns = state_[name];
+        if (ns.selected != NONE) {
+            if (matches(ns.constraints.back(), r_.candidates_[ns.selected])) return true;
+            reasons.insert(ns.selectedDepth);
+            message = describe(ns.constraints.back()) + " conflicts with " +
+                      label(ns.selected) + " chosen earlier";
+            return false;
+        }
+        size_t viable = 0;
+        for (size_t candidate : r_.byName_[name]) {
+            if (accepts(name, candidate)) ++viable;
+        }
+        if (viable != ns.viable) {
+            trail_.push_back({Undo::Viable, name, ns.viable});
+            ns.viable = viable;
+        }
+        if (viable > 0) return true;
+        for (const auto& c : ns.constraints) {
+            if (c.depth != NONE && c.depth != depth) reasons.insert(c.depth);
+        }
+        message = unsatisfiable(name);
+        return false;
+    }
+
+    /**
+     * The required, undecided package with the fewest viable candidates
+     * (the first required on ties), or NONE when every one is decided.
+     * Deciding the most constrained package first finds conflicts early.
+     */
+    size_t pickNext() const {
+        size_t best = NONE;
+        for (size_t name : order_) {
+            const auto& ns = state_[name];
+            if (ns.selected == NONE && (best == NONE || ns.viable < state_[best].viable)) {
+                best = name;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * A learned nogood that choosing candidate completes, or nullptr.
+     */
+    const Nogood* completedNogood(size_t candidate) const {
+        auto it = nogoodsOf_.find(candidate);
+        if (it == nogoodsOf_.end()) return nullptr;
+        for (size_t index : it->second) {
+            const auto& nogood = nogoods_[index];
+            bool complete = std::all_of(nogood.candidates.begin(), nogood.candidates.end(),
+                [this, candidate](size_t member) {
+                    return member == candidate ||
+                           state_[r_.candidates_[member].name].selected == member;
+                });
+            if (complete) return &nogood;
+        }
+        return nullptr;
+    }
+
+    void learn(std::vector<size_t> candidates, const std::string& reason) {
+        size_t index = nogoods_.size();
+        for (size_t candidate : candidates) {
+            nogoodsOf_[candidate].push_back(index);
+        }
+        nogoods_.push_back({std::move(candidates), reason});
+    }
+
+    std::string label(size_t candidate) const {
+        const auto& node = r_.candidates_[candidate];
+        return node.candidate.name + " " + node.candidate.version;
+    }
+
+    std::string describe(const Constraint& c) const {
+        std::string s = r_.names_[c.name] + " " +
+                        (c.rangeText->empty() ? std::string("*") : *c.rangeText);
+        if (!c.signer->empty()) s += " [signer=" + *c.signer + "]";
+        s += " (required by " + (c.from == NONE ? std::string("the request") : label(c.from)) + ")";
+        return s;
+    }
+
+    std::string unsatisfiable(size_t name) const {
+        const auto& ns = state_[name];
+        if (r_.byName_[name].empty()) {
+            std::string s = "No package named '" + r_.names_[name] + "'";
+            const auto& c = ns.constraints.front();
+            s += " (required by " + (c.from == NONE ? std::string("the request") : label(c.from)) + ")";
+            return s;
+        }
+        std::string s = "No version of '" + r_.names_[name] + "' satisfies ";
+        for (size_t i = 0; i < ns.constraints.size(); ++i) {
+            if (i > 0) s += ", ";
+            s += describe(ns.constraints[i]);
+        }
+        return s;
+    }
+
+    Resolver::Result fail(std::string error) {
+        Resolver::Result result;
+        result.error = std::move(error);
+        result.steps = steps_;
+        return result;
+    }
+};
+
+Resolver::Result ResolverSearch::run(const std::vector<Dependency>& requirements) {
+    // The request's ranges are compiled here; everything else was compiled by addCandidate
+    rootRanges_.reserve(requirements.size());
+    rootRangeTexts_.reserve(requirements.size());
+    std::vector<std::pair<size_t, size_t>> roots;  // name, index into rootRanges_
+    for (const auto& dep : requirements) {
+        std::string name = toLower(dep.name);
+        auto it = r_.nameIds_.find(name);
+        if (it == r_.nameIds_.end()) {
+            return fail("No package named '" + name + "' (required by the request)");
+        }
+        auto range = dep.version ? SemverRange::parse(*dep.version) : SemverRange::any();
+        if (!range) {
+            return fail("Invalid version range for '" + name + "': " + SemverRange::getLastError());
+        }
+        rootRanges_.push_back(std::move(*range));
+        rootRangeTexts_.push_back(dep.version.value_or(""));
+        roots.emplace_back(it->second, rootRanges_.size() - 1);
+    }
+
+    std::vector<std::string> rootSigners;
+    rootSigners.reserve(requirements.size());
+    for (const auto& dep : requirements) {
+        rootSigners.push_back(dep.signer.value_or(""));
+    }
+    for (size_t i = 0; i < roots.size(); ++i) {
+        size_t name = roots[i].first;
+        addConstraint(name, {name, &rootRanges_[roots[i].second], &rootRangeTexts_[roots[i].second],
+                             &rootSigners[i], NONE, NONE});
+        std::set<size_t> reasons;
+        std::string message;
+        if (!stillSatisfiable(name, NONE, reasons, message)) {
+            return fail(message);
+        }
+    }
+
+    std::vector<Frame> frames;
+    if (!order_.empty()) {
+        frames.push_back({pickNext(), 0, trail_.size(), {}, {}});
+    }
+
+    while (!frames.empty()) {
+        size_t depth = frames.size() - 1;
+        Frame& frame = frames.back();
+        undoTo(frame.trailMark);
+        size_t name = frame.name;
+        const auto& candidates = r_.byName_[name];
+
+        bool chosen = false;
+        while (!chosen && frame.next < candidates.size()) {
+            size_t candidate = candidates[frame.next++];
+            if (!accepts(name, candidate)) continue;
+            if (++steps_ > maxSteps_) {
+                return fail("Gave up after trying " + std::to_string(maxSteps_) +
+                            " candidate versions");
+            }
+
+            if (const Nogood* nogood = completedNogood(candidate)) {
+                for (size_t member : nogood->candidates) {
+                    if (member != candidate) {
+                        frame.conflict.insert(state_[r_.candidates_[member].name].selectedDepth);
+                    }
+                }
+                frame.failure = nogood->reason;
+                continue;
+            }
+
+            select(name, candidate, depth);
+            chosen = true;
+            const auto& node = r_.candidates_[candidate];
+            for (const auto& req : node.requirements) {
+                const SemverRange* range = req.range == Resolver::ANY_RANGE
+                    ? &any_ : &r_.ranges_[req.range];
+                addConstraint(req.name, {req.name, range, &req.rangeText, &req.signer, depth, candidate});
+
+                std::set<size_t> reasons;
+                std::string message;
+                if (!stillSatisfiable(req.name, depth, reasons, message)) {
+                    frame.conflict.insert(reasons.begin(), reasons.end());
+                    frame.failure = label(candidate) + ": " + message;
+                    undoTo(frame.trailMark);
+                    chosen = false;
+                    break;
+                }
+            }
+        }
+
+        if (chosen) {
+            size_t next = pickNext();
+            if (next == NONE) {
+                Resolver::Result result;
+                result.success = true;
+                result.steps = steps_;
+                for (size_t n : order_) {
+                    const auto& c = r_.candidates_[state_[n].selected].candidate;
+                    result.packages.push_back({c.name, c.version, c.signer, c.source});
+                }
+                std::sort(result.packages.begin(), result.packages.end(),
+                    [](const Resolver::Selection& a, const Resolver::Selection& b) {
+                        return a.name < b.name;
+                    });
+                return result;
+            }
+            frames.push_back({next, 0, trail_.size(), {}, {}});
+            continue;
+        }
+
+        // Dead end: no version of this package works with the choices so far.
+        // The culprits are the decisions that constrained it and those that
+        // made its candidates fail; jump back to the latest of them.
+        std::set<size_t> culprits = std::move(frame.conflict);
+        bool anyAccepted = false;
+        for (size_t candidate : candidates) {
+            anyAccepted = anyAccepted || accepts(name, candidate);
+        }
+        for (const auto& c : state_[name].constraints) {
+            if (c.depth != NONE) culprits.insert(c.depth);
+        }
+        culprits.erase(depth);
+        std::string failure = anyAccepted && !frame.failure.empty()
+            ? "Cannot resolve '" + r_.names_[name] + "': " + frame.failure
+            : unsatisfiable(name);
+
+        // The culprit choices can never all hold together
+        std::vector<size_t> culpritChoices;
+        for (size_t culprit : culprits) {
+            culpritChoices.push_back(state_[frames[culprit].name].selected);
+        }
+        if (!culpritChoices.empty()) {
+            learn(std::move(culpritChoices), failure);
+        }
+
+        frames.pop_back();
+        while (!frames.empty() && culprits.count(frames.size() - 1) == 0) {
+            frames.pop_back();
+        }
+        if (frames.empty()) {
+            return fail(failure);
+        }
+        culprits.erase(frames.size() - 1);
+        frames.back().conflict.insert(culprits.begin(), culprits.end());
+        frames.back().failure = failure;
+    }
+
+    Resolver::Result result;
+    result.success = true;
+    result.steps = steps_;
+    return result;
+}
+
+bool Resolver::addCandidate(const Candidate& candidate) {
+    auto version = SemVersion::parse(candidate.version);
+    if (!version) {
+        lastError_ = "Invalid version '" + candidate.version + "' for package '" +
+                     candidate.name + "'";
+        return false;
+    }
+
+    Node node;
+    node.candidate = candidate;
+    node.candidate.name = toLower(candidate.name);
+    node.version = std::move(*version);
+    for (const auto& dep : candidate.dependencies) {
+        auto req = compile(dep);
+        if (!req) {
+            lastError_ = "Package '" + candidate.name + "' " + candidate.version + ": " + lastError_;
+            return false;
+        }
+        node.requirements.push_back(std::move(*req));
+    }
+
+    size_t name = internName(node.candidate.name);
+    node.name = name;
+    size_t index = candidates_.size();
+    candidates_.push_back(std::move(node));
+
+    // Keep each name's list newest first
+    auto& list = byName_[name];
+    const SemVersion& v = candidates_[index].version;
+    auto pos = std::upper_bound(list.begin(), list.end(), index,
+        [this, &v](size_t, size_t other) { return v > candidates_[other].version; });
+    list.insert(pos, index);
+    return true;
+}
+
+size_t Resolver::addCatalog(const Catalog& catalog) {
+    size_t added = 0;
+    for (const auto& entry : catalog.entries()) {
+        if (!entry.isValid()) continue;
+        Candidate candidate;
+        candidate.name = entry.name;
+        candidate.version = entry.version;
+        candidate.signer = entry.signer;
+        candidate.dependencies = entry.dependencies;
+        candidate.source = catalog.packagePath(entry).string();
+        if (addCandidate(candidate)) ++added;
+    }
+    return added;
+}
+
+Resolver::Result Resolver::resolve(const std::vector<Dependency>& requirements,
+                                   size_t maxSteps) const {
+    ResolverSearch search(*this, maxSteps);
+    return search.run(requirements);
+}
+
+std::optional<Dependency> Resolver::parseRequirement(const std::string& text) {
+    size_t at = text.find('@');
+    Dependency dep(toLower(text.substr(0, at)));
+    if (dep.name.empty()) {
+        lastError_ = "Missing package name in requirement: '" + text + "'";
+        return std::nullopt;
+    }
+    if (at != std::string::npos) {
+        dep.version = text.substr(at + 1);
+        if (!SemverRange::parse(*dep.version)) {
+            lastError_ = SemverRange::getLastError();
+            return std::nullopt;
+        }
+    }
+    return dep;
+}
+
+std::string Resolver::getLastError() {
+    return lastError_;
+}
+
+size_t Resolver::internName(const std::string& name) {
+    auto [it, inserted] = nameIds_.emplace(name, names_.size());
+    if (inserted) {
+        names_.push_back(name);
+        byName_.emplace_back();
+    }
+    return it->second;
+}
+
+std::optional<Resolver::Requirement> Resolver::compile(const Dependency& dependency) {
+    Requirement req;
+    req.name = internName(toLower(dependency.name));
+    req.range = ANY_RANGE;
+    req.signer = dependency.signer.value_or("");
+    if (dependency.version) {
+        req.rangeText = *dependency.version;
+        auto it = rangeIds_.find(*dependency.version);
+        if (it != rangeIds_.end()) {
+            req.range = it->second;
+        } else {
+            auto range = SemverRange::parse(*dependency.version);
+            if (!range) {
+                lastError_ = "invalid range for '" + dependency.name + "': " +
+                             SemverRange::getLastError();
+                return std::nullopt;
+            }
+            req.range = ranges_.size();
+            ranges_.push_back(std::move(*range));
+            rangeIds_.emplace(*dependency.version, req.range);
+        }
+    }
+    return req;
+}
+
+} // namespace lgx
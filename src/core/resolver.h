@@ -0,0 +1,144 @@
+#pragma once
+
+#include "manifest.h"
+#include "semver.h"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lgx {
+
+class Catalog;
+
+/**
+ * Resolver picks one version of every package needed to satisfy a set of
+ * dependencies, following the dependencies of the chosen versions.
+ *
+ * Candidates are indexed by name and kept newest first; the version range
+ * of every dependency is compiled once, when its candidate is added. The
+ * search decides the most constrained package first, prefers its newest
+ * version and backtracks on conflict. When a package has no usable version
+ * it jumps straight back to the most recent choice that constrained it
+ * (conflict-directed backjumping), and remembers the combination of
+ * choices that failed so it is not tried again elsewhere in the search.
+ *
+ * A dependency with a signer pin only matches candidates whose signer DID
+ * equals the pin. Candidates from a Catalog carry a signer only if their
+ * signature verifies over the manifest.
+ */
+class Resolver {
+public:
+    /**
+     * Give up after this many candidate attempts by default.
+     */
+    static constexpr size_t DEFAULT_MAX_STEPS = 1000000;
+
+    /**
+     * A package version that can be chosen.
+     */
+    struct Candidate {
+        std::string name;
+        std::string version;                  // full semver version
+        std::string signer;                   // did:jwk:... or empty if unsigned
+        std::vector<Dependency> dependencies;
+        std::string source;                   // where it comes from, e.g. the package path
+    };
+
+    /**
+     * One chosen package.
+     */
+    struct Selection {
+        std::string name;
+        std::string version;
+        std::string signer;
+        std::string source;
+    };
+
+    /**
+     * Outcome of resolve().
+     */
+    struct Result {
+        bool success = false;
+        std::string error;                 // why no solution exists
+        std::vector<Selection> packages;   // sorted by name
+        size_t steps = 0;                  // candidate versions tried
+    };
+
+    /**
+     * Add a candidate.
+     *
+     * @return false if its version or a dependency range is invalid (see getLastError())
+     */
+    bool addCandidate(const Candidate& candidate);
+
+    /**
+     * Add every indexed package of a catalog; the source is the package path.
+     *
+     * @return Number of candidates added (entries with invalid versions are skipped)
+     */
+    size_t addCatalog(const Catalog& catalog);
+
+    /**
+     * Number of candidates added.
+     */
+    size_t candidateCount() const { return candidates_.size(); }
+
+    /**
+     * Resolve the transitive closure of requirements.
+     *
+     * @param requirements Top-level dependencies (ranges and signer pins honoured)
+     * @param maxSteps Give up after trying this many candidate versions
+     * @return The chosen packages, or the conflict that prevents a solution
+     */
+    Result resolve(const std::vector<Dependency>& requirements,
+                   size_t maxSteps = DEFAULT_MAX_STEPS) const;
+
+    /**
+     * Parse a requirement written as "name" or "name@range".
+     *
+     * @return The dependency, or nullopt if the name is empty or the range invalid
+     */
+    static std::optional<Dependency> parseRequirement(const std::string& text);
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    static constexpr size_t ANY_RANGE = static_cast<size_t>(-1);
+
+    // A dependency with its name and range resolved to ids
+    struct Requirement {
+        size_t name;
+        size_t range;          // index into ranges_, or ANY_RANGE
+        std::string rangeText; // as written, for messages
+        std::string signer;
+    };
+
+    struct Node {
+        size_t name;
+        Candidate candidate;
+        SemVersion version;
+        std::vector<Requirement> requirements;
+    };
+
+    std::vector<Node> candidates_;
+    std::vector<std::string> names_;                         // name id -> name
+    std::unordered_map<std::string, size_t> nameIds_;
+    std::vector<std::vector<size_t>> byName_;                // name id -> candidates, newest first
+    std::vector<SemverRange> ranges_;                        // compiled once
+    std::unordered_map<std::string, size_t> rangeIds_;
+
+    static thread_local std::string lastError_;
+
+    size_t internName(const std::string& name);
+    std::optional<Requirement> compile(const Dependency& dependency);
+
+    friend class ResolverSearch;
+};
+
+} // namespace lgx
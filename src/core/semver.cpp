@@ -0,0 +1,372 @@
+#include "semver.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace lgx {
+
+thread_local std::string SemverRange::lastError_;
+
+namespace {
+
+// Numeric fields are capped so MAJOR + 1 and friends cannot overflow
+constexpr size_t MAX_NUMBER_DIGITS = 18;
+
+bool parseNumber(const std::string& s, uint64_t& out) {
+    if (s.empty() || s.size() > MAX_NUMBER_DIGITS) return false;
+    if (s.size() > 1 && s[0] == '0') return false;
+    uint64_t value = 0;
+    for (char c : s) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + static_cast<uint64_t>(c - '0');
+    }
+    out = value;
+    return true;
+}
+
+bool isNumeric(const std::string& s) {
+    return !s.empty() && std::all_of(s.begin(), s.end(),
+        [](unsigned char c) { return std::isdigit(c) != 0; });
+}
+
+bool isIdentifier(const std::string& s) {
+    return !s.empty() && std::all_of(s.begin(), s.end(),
+        [](unsigned char c) { return std::isalnum(c) != 0 || c == '-'; });
+}
+
+std::vector<std::string> split(const std::string& s, char sep) {
+    std::vector<std::string> out;
+    size_t pos = 0;
+    while (true) {
+        size_t next = s.find(sep, pos);
+        out.push_back(s.substr(pos, next == std::string::npos ? std::string::npos : next - pos));
+        if (next == std::string::npos) break;
+        pos = next + 1;
+    }
+    return out;
+}
+
+// Split "core-pre+build" into its three parts
+bool splitTags(const std::string& text, std::string& core,
+               std::vector<std::string>& prerelease, std::string& build) {
+    std::string rest = text;
+    size_t plus = rest.find('+');
+    if (plus != std::string::npos) {
+        build = rest.substr(plus + 1);
+        rest.resize(plus);
+        for (const auto& id : split(build, '.')) {
+            if (!isIdentifier(id)) return false;
+        }
+    }
+    size_t dash = rest.find('-');
+    if (dash != std::string::npos) {
+        for (const auto& id : split(rest.substr(dash + 1), '.')) {
+            if (!isIdentifier(id)) return false;
+            prerelease.push_back(id);
+        }
+        rest.resize(dash);
+    }
+    core = rest;
+    return true;
+}
+
+int compareIdentifiers(const std::string& a, const std::string& b) {
+    bool aNum = isNumeric(a);
+    bool bNum = isNumeric(b);
+    if (aNum && bNum) {
+        // No leading zeros in valid input, so longer means larger
+        if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+        return a.compare(b);
+    }
+    if (aNum != bNum) return aNum ? -1 : 1;
+    return a.compare(b);
+}
+
+/**
+ * A possibly partial version as written in a range: "1", "1.2", "1.2.x",
+ * "1.2.3-rc.1", "*". Fields after the first wildcard are ignored, as in npm.
+ */
+struct Partial {
+    int fields = 0;  // leading numeric fields (0 = wildcard)
+    uint64_t parts[3] = {0, 0, 0};
+    std::vector<std::string> prerelease;
+
+    SemVersion version() const {
+        SemVersion v;
+        v.major = parts[0];
+        v.minor = parts[1];
+        v.patch = parts[2];
+        if (fields == 3) v.prerelease = prerelease;
+        return v;
+    }
+
+    // The first version past every version this partial names
+    SemVersion next() const {
+        SemVersion v;
+        if (fields == 1) {
+            v.major = parts[0] + 1;
+        } else {
+            v.major = parts[0];
+            v.minor = parts[1] + 1;
+        }
+        return v;
+    }
+};
+
+bool isWildcard(const std::string& s) {
+    return s == "*" || s == "x" || s == "X";
+}
+
+bool parsePartial(const std::string& text, Partial& out) {
+    if (text.empty() || isWildcard(text) || text == "latest") {
+        out.fields = 0;
+        return true;
+    }
+    std::string core;
+    std::string build;
+    if (!splitTags(text, core, out.prerelease, build)) return false;
+
+    auto fields = split(core, '.');
+    if (fields.size() > 3) return false;
+    bool wild = false;
+    for (size_t i = 0; i < fields.size(); ++i) {
+        if (isWildcard(fields[i])) {
+            wild = true;
+            continue;
+        }
+        if (!parseNumber(fields[i], out.parts[i])) return false;
+        if (!wild) out.fields = static_cast<int>(i) + 1;
+    }
+    // A prerelease only makes sense on a complete version
+    if (out.fields < 3) out.prerelease.clear();
+    return true;
+}
+
+SemverRange::Interval emptyInterval() {
+    SemverRange::Interval interval;
+    interval.lower = SemverRange::Bound{SemVersion{}, false};
+    interval.upper = SemverRange::Bound{SemVersion{}, false};
+    return interval;
+}
+
+// Interval of a single comparator such as "^1.2" or "<=2"
+SemverRange::Interval comparatorInterval(const std::string& op, const Partial& p) {
+    using Bound = SemverRange::Bound;
+    SemverRange::Interval interval;
+
+    if (p.fields == 0) {
+        if (op == "<" || op == ">") return emptyInterval();
+        return interval;
+    }
+
+    SemVersion v = p.version();
+    if (v.isPrerelease()) interval.prereleaseAnchors.push_back(v);
+
+    if (op.empty() || op == "=") {
+        interval.lower = Bound{v, true};
+        interval.upper = p.fields == 3 ? Bound{v, true} : Bound{p.next(), false};
+    } else if (op == "^") {
+        SemVersion upper;
+        if (p.parts[0] > 0 || p.fields == 1) {
+            upper.major = p.parts[0] + 1;
+        } else if (p.parts[1] > 0 || p.fields == 2) {
+            upper.minor = p.parts[1] + 1;
+        } else {
+            upper.patch = p.parts[2] + 1;
+        }
+        interval.lower = Bound{v, true};
+        interval.upper = Bound{upper, false};
+    } else if (op == "~") {
+        interval.lower = Bound{v, true};
+        Partial minorOnly = p;
+        minorOnly.fields = std::min(p.fields, 2);
+        interval.upper = Bound{minorOnly.next(), false};
+    } else if (op == ">") {
+        interval.lower = p.fields == 3 ? Bound{v, false} : Bound{p.next(), true};
+    } else if (op == ">=") {
+        interval.lower = Bound{v, true};
+    } else if (op == "<") {
+        interval.upper = Bound{v, false};
+    } else if (op == "<=") {
+        interval.upper = p.fields == 3 ? Bound{v, true} : Bound{p.next(), false};
+    }
+    return interval;
+}
+
+// Narrow a to the intersection of a and b
+void intersect(SemverRange::Interval& a, const SemverRange::Interval& b) {
+    if (b.lower) {
+        if (!a.lower) {
+            a.lower = b.lower;
+        } else {
+            int cmp = b.lower->version.compare(a.lower->version);
+            if (cmp > 0 || (cmp == 0 && !b.lower->inclusive)) a.lower = b.lower;
+        }
+    }
+    if (b.upper) {
+        if (!a.upper) {
+            a.upper = b.upper;
+        } else {
+            int cmp = b.upper->version.compare(a.upper->version);
+            if (cmp < 0 || (cmp == 0 && !b.upper->inclusive)) a.upper = b.upper;
+        }
+    }
+    a.prereleaseAnchors.insert(a.prereleaseAnchors.end(),
+                               b.prereleaseAnchors.begin(), b.prereleaseAnchors.end());
+}
+
+std::string trim(const std::string& s) {
+    size_t a = s.find_first_not_of(" \t");
+    if (a == std::string::npos) return "";
+    size_t b = s.find_last_not_of(" \t");
+    return s.substr(a, b - a + 1);
+}
+
+bool isOperator(const std::string& s) {
+    return s == "^" || s == "~" || s == "=" || s == ">" || s == ">=" ||
+           s == "<" || s == "<=";
+}
+
+} // namespace
+
+std::optional<SemVersion> SemVersion::parse(const std::string& text) {
+    std::string s = trim(text);
+    if (!s.empty() && (s[0] == 'v' || s[0] == 'V')) s.erase(0, 1);
+
+    SemVersion v;
+    std::string core;
+    if (!splitTags(s, core, v.prerelease, v.build)) return std::nullopt;
+    auto fields = split(core, '.');
+    if (fields.size() != 3 ||
+        !parseNumber(fields[0], v.major) ||
+        !parseNumber(fields[1], v.minor) ||
+        !parseNumber(fields[2], v.patch)) {
+        return std::nullopt;
+    }
+    return v;
+}
+
+std::string SemVersion::toString() const {
+    std::string s = std::to_string(major) + "." + std::to_string(minor) + "." +
+                    std::to_string(patch);
+    for (size_t i = 0; i < prerelease.size(); ++i) {
+        s += (i == 0 ? "-" : ".") + prerelease[i];
+    }
+    if (!build.empty()) s += "+" + build;
+    return s;
+}
+
+int SemVersion::compare(const SemVersion& other) const {
+    if (major != other.major) return major < other.major ? -1 : 1;
+    if (minor != other.minor) return minor < other.minor ? -1 : 1;
+    if (patch != other.patch) return patch < other.patch ? -1 : 1;
+
+    // A release sorts after its prereleases
+    if (prerelease.empty() || other.prerelease.empty()) {
+        if (prerelease.empty() == other.prerelease.empty()) return 0;
+        return prerelease.empty() ? 1 : -1;
+    }
+    size_t n = std::min(prerelease.size(), other.prerelease.size());
+    for (size_t i = 0; i < n; ++i) {
+        int cmp = compareIdentifiers(prerelease[i], other.prerelease[i]);
+        if (cmp != 0) return cmp < 0 ? -1 : 1;
+    }
+    if (prerelease.size() == other.prerelease.size()) return 0;
+    return prerelease.size() < other.prerelease.size() ? -1 : 1;
+}
+
+bool SemverRange::Interval::contains(const SemVersion& version) const {
+    if (lower) {
+        int cmp = version.compare(lower->version);
+        if (cmp < 0 || (cmp == 0 && !lower->inclusive)) return false;
+    }
+    if (upper) {
+        int cmp = version.compare(upper->version);
+        if (cmp > 0 || (cmp == 0 && !upper->inclusive)) return false;
+    }
+    if (version.isPrerelease()) {
+        return std::any_of(prereleaseAnchors.begin(), prereleaseAnchors.end(),
+            [&version](const SemVersion& anchor) { return anchor.sameCore(version); });
+    }
+    return true;
+}
+
+bool SemverRange::Interval::isEmpty() const {
+    if (!lower || !upper) return false;
+    int cmp = lower->version.compare(upper->version);
+    return cmp > 0 || (cmp == 0 && !(lower->inclusive && upper->inclusive));
+}
+
+SemverRange SemverRange::any() {
+    SemverRange range;
+    range.intervals_.emplace_back();
+    return range;
+}
+
+std::optional<SemverRange> SemverRange::parse(const std::string& text) {
+    SemverRange range;
+    if (trim(text).empty()) {
+        lastError_ = "Empty version range";
+        return std::nullopt;
+    }
+
+    size_t pos = 0;
+    while (pos <= text.size()) {
+        size_t next = text.find("||", pos);
+        std::string alt = trim(text.substr(pos, next == std::string::npos ? std::string::npos : next - pos));
+        pos = next == std::string::npos ? text.size() + 1 : next + 2;
+
+        if (alt.empty()) {
+            lastError_ = "Empty alternative in version range: '" + text + "'";
+            return std::nullopt;
+        }
+
+        Interval interval;
+        std::istringstream iss(alt);
+        std::string token;
+        while (iss >> token) {
+            // Operators may be separated from their version: ">= 1.2"
+            if (isOperator(token)) {
+                std::string body;
+                if (!(iss >> body)) {
+                    lastError_ = "Operator without version in range: '" + text + "'";
+                    return std::nullopt;
+                }
+                token += body;
+            }
+
+            size_t opLen = 0;
+            if (token.rfind(">=", 0) == 0 || token.rfind("<=", 0) == 0) {
+                opLen = 2;
+            } else if (!token.empty() && std::string("^~=<>").find(token[0]) != std::string::npos) {
+                opLen = 1;
+            }
+            std::string op = token.substr(0, opLen);
+            std::string body = token.substr(opLen);
+
+            Partial partial;
+            if (!parsePartial(body, partial)) {
+                lastError_ = "Invalid version '" + body + "' in range: '" + text + "'";
+                return std::nullopt;
+            }
+            intersect(interval, comparatorInterval(op, partial));
+        }
+
+        if (!interval.isEmpty()) {
+            range.intervals_.push_back(std::move(interval));
+        }
+    }
+    return range;
+}
+
+bool SemverRange::satisfies(const SemVersion& version) const {
+    return std::any_of(intervals_.begin(), intervals_.end(),
+        [&version](const Interval& interval) { return interval.contains(version); });
+}
+
+std::string SemverRange::getLastError() {
+    return lastError_;
+}
+
+} // namespace lgx
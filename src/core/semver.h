@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace lgx {
+
+/**
+ * A semantic version (MAJOR.MINOR.PATCH[-PRERELEASE][+BUILD]).
+ *
+ * Ordering follows semver.org: numeric fields first, then a version with
+ * a prerelease sorts before the same version without one. Build metadata
+ * is kept for display but never affects ordering or equality.
+ */
+struct SemVersion {
+    uint64_t major = 0;
+    uint64_t minor = 0;
+    uint64_t patch = 0;
+    std::vector<std::string> prerelease;  // dot-separated identifiers
+    std::string build;
+
+    /**
+     * Parse a full version ("1.2.3", "1.2.3-rc.1+abc"). A leading "v" is
+     * accepted. Partial versions ("1.2") are not versions, only ranges.
+     */
+    static std::optional<SemVersion> parse(const std::string& text);
+
+    std::string toString() const;
+
+    bool isPrerelease() const { return !prerelease.empty(); }
+
+    /**
+     * True when major, minor and patch are equal (prerelease ignored).
+     */
+    bool sameCore(const SemVersion& other) const {
+        return major == other.major && minor == other.minor && patch == other.patch;
+    }
+
+    /**
+     * @return negative, zero or positive as this sorts before, equal to or
+     *         after other
+     */
+    int compare(const SemVersion& other) const;
+
+    bool operator==(const SemVersion& o) const { return compare(o) == 0; }
+    bool operator!=(const SemVersion& o) const { return compare(o) != 0; }
+    bool operator<(const SemVersion& o) const { return compare(o) < 0; }
+    bool operator<=(const SemVersion& o) const { return compare(o) <= 0; }
+    bool operator>(const SemVersion& o) const { return compare(o) > 0; }
+    bool operator>=(const SemVersion& o) const { return compare(o) >= 0; }
+};
+
+/**
+ * A version range in the npm/Cargo syntax accepted for dependencies
+ * ("^1.2", "~1.2.3", ">=1 <2", "1.x || 2.0.0", "*"), compiled to a union
+ * of intervals so that matching a version is a few comparisons.
+ *
+ * As in npm, a prerelease version only matches an interval written with a
+ * prerelease on the same MAJOR.MINOR.PATCH ("^1.2.3-beta" matches
+ * 1.2.3-beta.2 but not 1.3.0-beta).
+ */
+class SemverRange {
+public:
+    /**
+     * One end of an interval.
+     */
+    struct Bound {
+        SemVersion version;
+        bool inclusive = true;
+    };
+
+    /**
+     * The versions between lower and upper; a missing bound is unbounded.
+     */
+    struct Interval {
+        std::optional<Bound> lower;
+        std::optional<Bound> upper;
+        std::vector<SemVersion> prereleaseAnchors;  // comparators written with a prerelease
+
+        bool contains(const SemVersion& version) const;
+        bool isEmpty() const;
+    };
+
+    /**
+     * The range matching every release version ("*").
+     */
+    static SemverRange any();
+
+    /**
+     * Compile a range expression.
+     *
+     * @return The range, or nullopt if the syntax is invalid (see getLastError())
+     */
+    static std::optional<SemverRange> parse(const std::string& text);
+
+    /**
+     * Check if a version lies in the range.
+     */
+    bool satisfies(const SemVersion& version) const;
+
+    /**
+     * The non-empty intervals the range is made of.
+     */
+    const std::vector<Interval>& intervals() const { return intervals_; }
+
+    /**
+     * True if no version can satisfy the range.
+     */
+    bool isEmpty() const { return intervals_.empty(); }
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    std::vector<Interval> intervals_;
+
+    static thread_local std::string lastError_;
+};
+
+} // namespace lgx
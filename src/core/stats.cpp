@@ -0,0 +1,174 @@
+#include "stats.h"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <sstream>
+
+namespace lgx {
+
+namespace {
+
+uint64_t wallNow() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t threadCpuNow() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+    }
+#endif
+    return 0;
+}
+
+std::string formatMs(uint64_t ns) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3f", static_cast<double>(ns) / 1e6);
+    return buffer;
+}
+
+} // anonymous namespace
+
+std::atomic<bool> Stats::enabled_{false};
+Stats::Counters Stats::counters_[Stats::PHASE_COUNT];
+std::atomic<uint64_t> Stats::peakBufferBytes_{0};
+
+Stats::Timer::Timer(Phase phase) : phase_(phase), active_(Stats::isEnabled()) {
+    if (active_) {
+        startWallNs_ = wallNow();
+        startCpuNs_ = threadCpuNow();
+    }
+}
+
+Stats::Timer::~Timer() {
+    if (!active_) {
+        return;
+    }
+    uint64_t cpuNow = threadCpuNow();
+    Counters& counters = counters_[static_cast<size_t>(phase_)];
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.bytesIn.fetch_add(local_.bytesIn, std::memory_order_relaxed);
+    counters.bytesOut.fetch_add(local_.bytesOut, std::memory_order_relaxed);
+    counters.entries.fetch_add(local_.entries, std::memory_order_relaxed);
+    counters.syscalls.fetch_add(local_.syscalls, std::memory_order_relaxed);
+    counters.wallNs.fetch_add(wallNow() - startWallNs_, std::memory_order_relaxed);
+    if (cpuNow >= startCpuNs_) {
+        counters.cpuNs.fetch_add(cpuNow - startCpuNs_, std::memory_order_relaxed);
+    }
+}
+
+void Stats::setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+Stats::Snapshot Stats::snapshot() {
+    Snapshot snapshot;
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        const Counters& counters = counters_[i];
+        PhaseStats& phase = snapshot.phases[i];
+        phase.calls = counters.calls.load(std::memory_order_relaxed);
+        phase.bytesIn = counters.bytesIn.load(std::memory_order_relaxed);
+        phase.bytesOut = counters.bytesOut.load(std::memory_order_relaxed);
+        phase.entries = counters.entries.load(std::memory_order_relaxed);
+        phase.syscalls = counters.syscalls.load(std::memory_order_relaxed);
+        phase.wallNs = counters.wallNs.load(std::memory_order_relaxed);
+        phase.cpuNs = counters.cpuNs.load(std::memory_order_relaxed);
+    }
+    snapshot.peakBufferBytes = peakBufferBytes_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void Stats::reset() {
+    for (auto& counters : counters_) {
+        counters.calls.store(0, std::memory_order_relaxed);
+        counters.bytesIn.store(0, std::memory_order_relaxed);
+        counters.bytesOut.store(0, std::memory_order_relaxed);
+        counters.entries.store(0, std::memory_order_relaxed);
+        counters.syscalls.store(0, std::memory_order_relaxed);
+        counters.wallNs.store(0, std::memory_order_relaxed);
+        counters.cpuNs.store(0, std::memory_order_relaxed);
+    }
+    peakBufferBytes_.store(0, std::memory_order_relaxed);
+}
+
+const char* Stats::phaseName(Phase phase) {
+    switch (phase) {
+        case Phase::FileRead:  return "file_read";
+        case Phase::Inflate:   return "inflate";
+        case Phase::TarParse:  return "tar_parse";
+        case Phase::TarWrite:  return "tar_write";
+        case Phase::Deflate:   return "deflate";
+        case Phase::FileWrite: return "file_write";
+        case Phase::Normalize: return "normalize";
+        case Phase::Hash:      return "hash";
+        case Phase::Extract:   return "extract";
+        case Phase::Count:     break;
+    }
+    return "unknown";
+}
+
+std::string Stats::toText(const Snapshot& snapshot) {
+    std::ostringstream out;
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-11s %7s %12s %12s %8s %8s %10s %10s\n",
+                  "phase", "calls", "bytes_in", "bytes_out", "entries", "syscalls",
+                  "wall_ms", "cpu_ms");
+    out << line;
+
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        const PhaseStats& phase = snapshot.phases[i];
+        if (phase.calls == 0) {
+            continue;
+        }
+        std::snprintf(line, sizeof(line), "%-11s %7llu %12llu %12llu %8llu %8llu %10s %10s\n",
+                      phaseName(static_cast<Phase>(i)),
+                      static_cast<unsigned long long>(phase.calls),
+                      static_cast<unsigned long long>(phase.bytesIn),
+                      static_cast<unsigned long long>(phase.bytesOut),
+                      static_cast<unsigned long long>(phase.entries),
+                      static_cast<unsigned long long>(phase.syscalls),
+                      formatMs(phase.wallNs).c_str(),
+                      formatMs(phase.cpuNs).c_str());
+        out << line;
+    }
+
+    out << "peak buffer: " << snapshot.peakBufferBytes << " bytes\n";
+    return out.str();
+}
+
+std::string Stats::toJson(const Snapshot& snapshot) {
+    nlohmann::ordered_json phases = nlohmann::ordered_json::object();
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        const PhaseStats& phase = snapshot.phases[i];
+        phases[phaseName(static_cast<Phase>(i))] = {
+            {"calls", phase.calls},
+            {"bytes_in", phase.bytesIn},
+            {"bytes_out", phase.bytesOut},
+            {"entries", phase.entries},
+            {"syscalls", phase.syscalls},
+            {"wall_ns", phase.wallNs},
+            {"cpu_ns", phase.cpuNs}
+        };
+    }
+
+    nlohmann::ordered_json result = {
+        {"phases", phases},
+        {"peak_buffer_bytes", snapshot.peakBufferBytes}
+    };
+    return result.dump(2);
+}
+
+void Stats::updatePeak(size_t bytes) {
+    uint64_t value = bytes;
+    uint64_t current = peakBufferBytes_.load(std::memory_order_relaxed);
+    while (value > current &&
+           !peakBufferBytes_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace lgx
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace lgx {
+
+/**
+ * Process-wide operation statistics: per-phase counters and timers for the
+ * pipeline stages (inflate, tar parse, NFC normalization, hashing, disk I/O,
+ * ...) plus the peak scratch buffer size.
+ *
+ * Collection is off by default. While disabled, every instrumentation point
+ * costs one relaxed atomic load and nothing is recorded. Counters from all
+ * threads are summed. Phases may nest (path normalization runs inside
+ * extraction), so wall times of different phases are not additive.
+ */
+class Stats {
+public:
+    /**
+     * Instrumented phases.
+     */
+    enum class Phase {
+        FileRead,   // reading a package file from disk
+        Inflate,    // gzip decompression
+        TarParse,   // tar stream -> entries
+        TarWrite,   // entries -> tar stream
+        Deflate,    // gzip compression
+        FileWrite,  // writing a package file to disk
+        Normalize,  // Unicode NFC normalization / checks
+        Hash,       // Merkle tree computation
+        Extract,    // writing variant files to disk
+        Count
+    };
+
+    static constexpr size_t PHASE_COUNT = static_cast<size_t>(Phase::Count);
+
+    /**
+     * Totals for one phase.
+     */
+    struct PhaseStats {
+        uint64_t calls = 0;
+        uint64_t bytesIn = 0;
+        uint64_t bytesOut = 0;
+        uint64_t entries = 0;
+        uint64_t syscalls = 0;   // file system calls issued (open, read, write, mkdir, chmod, ...)
+        uint64_t wallNs = 0;
+        uint64_t cpuNs = 0;      // CPU time of the calling thread (0 where unsupported)
+    };
+
+    /**
+     * Point-in-time copy of all counters.
+     */
+    struct Snapshot {
+        std::array<PhaseStats, PHASE_COUNT> phases{};
+        uint64_t peakBufferBytes = 0;
+
+        const PhaseStats& operator[](Phase phase) const {
+            return phases[static_cast<size_t>(phase)];
+        }
+    };
+
+    /**
+     * Times one phase invocation and accumulates its counters, which are
+     * added to the totals when the timer is destroyed. Does nothing if
+     * collection was disabled when the timer was created.
+     */
+    class Timer {
+    public:
+        explicit Timer(Phase phase);
+        ~Timer();
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        bool active() const { return active_; }
+
+        void addBytesIn(uint64_t count) { if (active_) local_.bytesIn += count; }
+        void addBytesOut(uint64_t count) { if (active_) local_.bytesOut += count; }
+        void addEntries(uint64_t count = 1) { if (active_) local_.entries += count; }
+        void addSyscalls(uint64_t count = 1) { if (active_) local_.syscalls += count; }
+
+    private:
+        Phase phase_;
+        bool active_;
+        PhaseStats local_;
+        uint64_t startWallNs_ = 0;
+        uint64_t startCpuNs_ = 0;
+    };
+
+    /**
+     * Turn collection on or off. Counters are kept; see reset().
+     */
+    static void setEnabled(bool enabled);
+
+    static bool isEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Record a buffer size for the peak-buffer statistic.
+     */
+    static void noteBuffer(size_t bytes) {
+        if (isEnabled()) {
+            updatePeak(bytes);
+        }
+    }
+
+    /**
+     * Copy the current counters.
+     */
+    static Snapshot snapshot();
+
+    /**
+     * Zero all counters.
+     */
+    static void reset();
+
+    /**
+     * Short lowercase name of a phase ("inflate", "tar_parse", ...).
+     */
+    static const char* phaseName(Phase phase);
+
+    /**
+     * Render a snapshot as an aligned table (phases with no calls omitted).
+     */
+    static std::string toText(const Snapshot& snapshot);
+
+    /**
+     * Render a snapshot as a JSON object.
+     */
+    static std::string toJson(const Snapshot& snapshot);
+
+private:
+    struct Counters {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> bytesIn{0};
+        std::atomic<uint64_t> bytesOut{0};
+        std::atomic<uint64_t> entries{0};
+        std::atomic<uint64_t> syscalls{0};
+        std::atomic<uint64_t> wallNs{0};
+        std::atomic<uint64_t> cpuNs{0};
+    };
+
+    static void updatePeak(size_t bytes);
+
+    static std::atomic<bool> enabled_;
+    static Counters counters_[PHASE_COUNT];
+    static std::atomic<uint64_t> peakBufferBytes_;
+};
+
+} // namespace lgx
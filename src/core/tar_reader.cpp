@@ -1,4 +1,7 @@
 #include "tar_reader.h"
+#include "progress.h"
+#include "stats.h"
+#include "trace.h"
 
 #include <cstring>
 #include <algorithm>
@@ -41,12 +44,15 @@ bool TarReader::verifyChecksum(const uint8_t* header) {
 }
 
 bool TarReader::isZeroBlock(const uint8_t* block) {
-    for (size_t i = 0; i < BLOCK_SIZE; ++i) {
-        if (block[i] != 0) {
-            return false;
-        }
+    // Word at a time: archives may legitimately carry long zero runs
+    static_assert(BLOCK_SIZE % sizeof(uint64_t) == 0, "block must be whole words");
+    uint64_t bits = 0;
+    for (size_t i = 0; i < BLOCK_SIZE; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, block + i, sizeof(word));
+        bits |= word;
     }
-    return true;
+    return bits == 0;
 }
 
 std::string TarReader::reconstructPath(const uint8_t* name, const uint8_t* prefix) {
@@ -74,15 +80,16 @@ std::string TarReader::reconstructPath(const uint8_t* name, const uint8_t* prefi
 }
 
 std::optional<TarReader::EntryInfo> TarReader::parseHeader(
-    const std::vector<uint8_t>& tarData,
+    const uint8_t* tarData,
+    size_t size,
     size_t offset
 ) {
-    if (offset + BLOCK_SIZE > tarData.size()) {
+    if (offset + BLOCK_SIZE > size) {
         lastError_ = "Incomplete header at offset " + std::to_string(offset);
         return std::nullopt;
     }
     
-    const uint8_t* header = tarData.data() + offset;
+    const uint8_t* header = tarData + offset;
     
     // Check for end-of-archive (zero block)
     if (isZeroBlock(header)) {
@@ -135,23 +142,30 @@ std::optional<TarReader::EntryInfo> TarReader::parseHeader(
 }
 
 TarReader::ReadResult TarReader::read(const std::vector<uint8_t>& tarData) {
+    return read(tarData.data(), tarData.size());
+}
+
+TarReader::ReadResult TarReader::read(const uint8_t* tarData, size_t size) {
+    Stats::Timer timer(Stats::Phase::TarParse);
+    Trace::Span span("tar.parse");
     std::vector<TarEntry> entries;
     
     size_t offset = 0;
     int zeroBlockCount = 0;
     
-    while (offset < tarData.size()) {
-        auto infoOpt = parseHeader(tarData, offset);
-        
-        if (!infoOpt) {
-            if (isZeroBlock(tarData.data() + offset)) {
-                ++zeroBlockCount;
-                offset += BLOCK_SIZE;
-                if (zeroBlockCount >= 2) {
-                    break;  // End of archive
-                }
-                continue;
+    while (offset < size) {
+        // Test for the end marker first so zero blocks are scanned only once
+        if (offset + BLOCK_SIZE <= size && isZeroBlock(tarData + offset)) {
+            ++zeroBlockCount;
+            offset += BLOCK_SIZE;
+            if (zeroBlockCount >= 2) {
+                break;  // End of archive
             }
+            continue;
+        }
+
+        auto infoOpt = parseHeader(tarData, size, offset);
+        if (!infoOpt) {
             return ReadResult::fail(lastError_);
         }
         
@@ -165,13 +179,13 @@ TarReader::ReadResult TarReader::read(const std::vector<uint8_t>& tarData) {
         
         // Read file data
         if (info.isRegularFile && info.size > 0) {
-            if (offset + info.size > tarData.size()) {
+            if (info.size > size - offset) {
                 return ReadResult::fail("Incomplete file data for " + info.path);
             }
             
             entry.data.assign(
-                tarData.begin() + offset,
-                tarData.begin() + offset + info.size
+                tarData + offset,
+                tarData + offset + info.size
             );
             
             // Move past data blocks (padded to block boundary)
@@ -180,8 +194,15 @@ TarReader::ReadResult TarReader::read(const std::vector<uint8_t>& tarData) {
         }
         
         entries.push_back(std::move(entry));
+        Progress::addEntries();
+        timer.addEntries();
+
+        if (Progress::isCancelled()) {
+            return ReadResult::fail(Progress::CANCELLED_ERROR);
+        }
     }
     
+    timer.addBytesIn(std::min(offset, size));
     return ReadResult::ok(std::move(entries));
 }
 
@@ -192,7 +213,7 @@ std::vector<TarReader::EntryInfo> TarReader::readInfo(const std::vector<uint8_t>
     int zeroBlockCount = 0;
     
     while (offset < tarData.size()) {
-        auto infoOpt = parseHeader(tarData, offset);
+        auto infoOpt = parseHeader(tarData.data(), tarData.size(), offset);
         
         if (!infoOpt) {
             if (offset < tarData.size() && isZeroBlock(tarData.data() + offset)) {
@@ -240,7 +261,7 @@ std::optional<std::vector<uint8_t>> TarReader::readFile(
     }
     
     while (offset < tarData.size()) {
-        auto infoOpt = parseHeader(tarData, offset);
+        auto infoOpt = parseHeader(tarData.data(), tarData.size(), offset);
         
         if (!infoOpt) {
             if (offset < tarData.size() && isZeroBlock(tarData.data() + offset)) {
@@ -305,7 +326,7 @@ bool TarReader::iterate(
     int zeroBlockCount = 0;
     
     while (offset < tarData.size()) {
-        auto infoOpt = parseHeader(tarData, offset);
+        auto infoOpt = parseHeader(tarData.data(), tarData.size(), offset);
         
         if (!infoOpt) {
             if (offset < tarData.size() && isZeroBlock(tarData.data() + offset)) {
@@ -346,11 +367,124 @@ bool TarReader::iterate(
         if (!callback(entry)) {
             return false;  // Callback requested stop
         }
+        Progress::addEntries();
+
+        if (Progress::isCancelled()) {
+            lastError_ = Progress::CANCELLED_ERROR;
+            return false;
+        }
     }
     
     return true;
 }
 
+bool TarReader::EndScanner::scan(const uint8_t* tarData, size_t size) {
+    while (!ended_ && !stopped_ && offset_ + BLOCK_SIZE <= size) {
+        const uint8_t* header = tarData + offset_;
+        if (isZeroBlock(header)) {
+            offset_ += BLOCK_SIZE;
+            ended_ = ++zeroBlocks_ >= 2;
+            continue;
+        }
+        if (!verifyChecksum(header)) {
+            stopped_ = true;
+            break;
+        }
+        zeroBlocks_ = 0;
+
+        // Same data skipping rule as read(): only regular files carry data
+        char typeFlag = static_cast<char>(header[156]);
+        uint64_t dataSize = readOctal(header + 124, 12);
+        offset_ += BLOCK_SIZE;
+        if ((typeFlag == '0' || typeFlag == '\0') && dataSize > 0) {
+            uint64_t dataBlocks = (dataSize + BLOCK_SIZE - 1) / BLOCK_SIZE;
+            if (dataBlocks > (SIZE_MAX - offset_) / BLOCK_SIZE) {
+                stopped_ = true;  // read() rejects this as incomplete data
+                break;
+            }
+            offset_ += static_cast<size_t>(dataBlocks * BLOCK_SIZE);
+        }
+    }
+    return ended_;
+}
+
+TarReader::StreamParser::StreamParser(Filter wantData, Callback onEntry)
+    : wantData_(std::move(wantData)), onEntry_(std::move(onEntry)) {
+    header_.reserve(BLOCK_SIZE);
+}
+
+bool TarReader::StreamParser::feed(const uint8_t* data, size_t size) {
+    while (!done_) {
+        if (skipRemaining_ > 0) {
+            size_t n = static_cast<size_t>(std::min<uint64_t>(skipRemaining_, size));
+            skipRemaining_ -= n;
+            data += n;
+            size -= n;
+            if (skipRemaining_ > 0) return true;
+            continue;
+        }
+
+        if (inData_) {
+            size_t n = static_cast<size_t>(std::min<uint64_t>(dataRemaining_, size));
+            data_.insert(data_.end(), data, data + n);
+            dataRemaining_ -= n;
+            data += n;
+            size -= n;
+            if (dataRemaining_ > 0) return true;
+
+            inData_ = false;
+            skipRemaining_ = (BLOCK_SIZE - info_.size % BLOCK_SIZE) % BLOCK_SIZE;
+            if (!onEntry_(info_, data_)) {
+                done_ = true;
+                break;
+            }
+            data_.clear();
+            continue;
+        }
+
+        if (size == 0) return true;
+
+        size_t n = std::min(BLOCK_SIZE - header_.size(), size);
+        header_.insert(header_.end(), data, data + n);
+        data += n;
+        size -= n;
+        if (header_.size() < BLOCK_SIZE) return true;
+
+        if (isZeroBlock(header_.data())) {
+            header_.clear();
+            if (++zeroBlocks_ >= 2) {
+                ended_ = true;
+                done_ = true;
+            }
+            continue;
+        }
+        zeroBlocks_ = 0;
+
+        auto infoOpt = parseHeader(header_.data(), BLOCK_SIZE, 0);
+        header_.clear();
+        if (!infoOpt) {
+            error_ = lastError_;
+            done_ = true;
+            break;
+        }
+
+        // Same data rule as read(): only regular files carry data
+        uint64_t dataSize = infoOpt->isRegularFile ? infoOpt->size : 0;
+        if (dataSize > 0 && wantData_(*infoOpt)) {
+            info_ = std::move(*infoOpt);
+            dataRemaining_ = dataSize;
+            inData_ = true;
+            continue;
+        }
+
+        skipRemaining_ = (dataSize + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+        if (!onEntry_(*infoOpt, data_)) {
+            done_ = true;
+        }
+    }
+    return false;
+}
+
 bool TarReader::isValidTar(const std::vector<uint8_t>& tarData) {
     if (tarData.size() < BLOCK_SIZE) {
         return false;
@@ -57,6 +57,11 @@ public:
      * @return ReadResult containing entries or error
      */
     static ReadResult read(const std::vector<uint8_t>& tarData);
+
+    /**
+     * Read all entries from a raw tar byte range (not copied; entry data is).
+     */
+    static ReadResult read(const uint8_t* tarData, size_t size);
     
     /**
      * Read only entry info (without file contents).
@@ -88,6 +93,86 @@ public:
         std::function<bool(const TarEntry& entry)> callback
     );
     
+    /**
+     * Finds where a tar stream ends while it is still arriving, e.g. chunk by
+     * chunk from the decompressor. Bytes past the end-of-archive marker are
+     * never read by read(), so a caller may stop buffering them: trailing
+     * padding (such as a long run of zero blocks) then costs no memory.
+     *
+     * Walks headers exactly as read() does. On a header read() would reject
+     * it stops scanning and never reports an end, so the caller keeps all
+     * data and read() reports the error.
+     */
+    class EndScanner {
+    public:
+        /**
+         * Scan the stream received so far.
+         *
+         * @param tarData All bytes received so far (the same buffer, growing)
+         * @param size Number of bytes received so far
+         * @return true once the end-of-archive marker has been passed
+         */
+        bool scan(const uint8_t* tarData, size_t size);
+
+        bool ended() const { return ended_; }
+
+    private:
+        size_t offset_ = 0;   // next block to examine
+        int zeroBlocks_ = 0;  // consecutive zero blocks seen
+        bool ended_ = false;
+        bool stopped_ = false;
+    };
+
+    /**
+     * Parses a tar stream as it arrives, chunk by chunk, without holding the
+     * archive in memory. Every entry is reported in order; only the data of
+     * entries the filter selects is buffered, everything else is skipped as
+     * it streams past. Suited to reading a few small files near the start
+     * of a large archive.
+     */
+    class StreamParser {
+    public:
+        /** Return true to receive the data of a regular file. */
+        using Filter = std::function<bool(const EntryInfo& info)>;
+
+        /**
+         * Called once per entry, after its data (empty unless selected by
+         * the filter) has arrived. Return false to stop parsing.
+         */
+        using Callback = std::function<bool(const EntryInfo& info, std::vector<uint8_t>& data)>;
+
+        StreamParser(Filter wantData, Callback onEntry);
+
+        /**
+         * Feed the next chunk of the stream.
+         *
+         * @return true while more input is wanted; false once parsing has
+         *         finished (end of archive or stopped by the callback) or
+         *         failed (see error())
+         */
+        bool feed(const uint8_t* data, size_t size);
+
+        /** True once the end-of-archive marker has been seen. */
+        bool ended() const { return ended_; }
+
+        /** Why parsing failed, or empty. */
+        const std::string& error() const { return error_; }
+
+    private:
+        Filter wantData_;
+        Callback onEntry_;
+        std::vector<uint8_t> header_;  // partial header block
+        std::vector<uint8_t> data_;    // selected entry data received so far
+        EntryInfo info_{};             // entry whose data is being received
+        uint64_t dataRemaining_ = 0;   // selected data bytes still to come
+        uint64_t skipRemaining_ = 0;   // unselected data / padding to drop
+        bool inData_ = false;
+        int zeroBlocks_ = 0;
+        bool ended_ = false;
+        bool done_ = false;
+        std::string error_;
+    };
+
     /**
      * Check if tar data appears valid (basic header check).
      */
@@ -109,7 +194,8 @@ private:
      * Parse a tar header at the given offset.
      */
     static std::optional<EntryInfo> parseHeader(
-        const std::vector<uint8_t>& tarData,
+        const uint8_t* tarData,
+        size_t size,
         size_t offset
     );
     
@@ -1,5 +1,7 @@
 #include "tar_writer.h"
 #include "path_normalizer.h"
+#include "stats.h"
+#include "trace.h"
 
 #include <algorithm>
 #include <cstring>
@@ -130,13 +132,7 @@ std::vector<uint8_t> DeterministicTarWriter::createHeader(const TarEntry& entry)
     std::memcpy(header.data(), name.c_str(), std::min(name.length(), NAME_SIZE));
 
     // Mode (100-107)
-    uint32_t mode = entry.mode & 0777;
-    if (entry.isDirectory) {
-        mode = DIR_MODE;
-    } else if (mode == 0) {
-        mode = FILE_MODE;
-    }
-    writeOctal(header.data() + 100, 8, mode);
+    writeOctal(header.data() + 100, 8, archiveMode(entry));
     
     // UID (108-115)
     writeOctal(header.data() + 108, 8, UID);
@@ -192,7 +188,39 @@ std::vector<uint8_t> DeterministicTarWriter::createHeader(const TarEntry& entry)
     return header;
 }
 
+std::string DeterministicTarWriter::archivePath(const TarEntry& entry) {
+    return normalizeTarPath(entry.path, entry.isDirectory);
+}
+
+uint32_t DeterministicTarWriter::archiveMode(const TarEntry& entry) {
+    if (entry.isDirectory) {
+        return DIR_MODE;
+    }
+    uint32_t mode = entry.mode & 0777;
+    return mode == 0 ? FILE_MODE : mode;
+}
+
+void DeterministicTarWriter::encodeEntry(const TarEntry& entry, std::vector<uint8_t>& out) {
+    auto header = createHeader(entry);
+    out.insert(out.end(), header.begin(), header.end());
+    if (!entry.isDirectory && !entry.data.empty()) {
+        out.insert(out.end(), entry.data.begin(), entry.data.end());
+        size_t padding = (BLOCK_SIZE - (entry.data.size() % BLOCK_SIZE)) % BLOCK_SIZE;
+        out.insert(out.end(), padding, 0);
+    }
+}
+
 std::vector<uint8_t> DeterministicTarWriter::finalize() {
+    std::vector<uint8_t> result;
+    VectorByteSink sink(result);
+    finalizeTo(sink);
+    return result;
+}
+
+bool DeterministicTarWriter::finalizeTo(ByteSink& sink) {
+    Stats::Timer timer(Stats::Phase::TarWrite);
+    Trace::Span span("tar.write");
+
     // Sort entries lexicographically by normalized path
     std::sort(entries_.begin(), entries_.end(), 
         [](const TarEntry& a, const TarEntry& b) {
@@ -200,28 +228,47 @@ std::vector<uint8_t> DeterministicTarWriter::finalize() {
             std::string pathB = normalizeTarPath(b.path, b.isDirectory);
             return pathA < pathB;
         });
-    
-    std::vector<uint8_t> result;
-    
+
+    // Let the sink allocate the whole archive up front
+    size_t total = BLOCK_SIZE * 2;
+    for (const auto& entry : entries_) {
+        total += BLOCK_SIZE;
+        if (!entry.isDirectory) {
+            total += (entry.data.size() + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+        }
+    }
+    sink.sizeHint(total);
+    timer.addEntries(entries_.size());
+
+    static const uint8_t zeros[BLOCK_SIZE * 2] = {};
+
     for (const auto& entry : entries_) {
         // Write header
         auto header = createHeader(entry);
-        result.insert(result.end(), header.begin(), header.end());
+        if (!sink.write(header.data(), header.size())) {
+            return false;
+        }
         
         // Write data (if file)
         if (!entry.isDirectory && !entry.data.empty()) {
-            result.insert(result.end(), entry.data.begin(), entry.data.end());
+            if (!sink.write(entry.data.data(), entry.data.size())) {
+                return false;
+            }
             
             // Pad to block boundary
             size_t padding = (BLOCK_SIZE - (entry.data.size() % BLOCK_SIZE)) % BLOCK_SIZE;
-            result.insert(result.end(), padding, 0);
+            if (padding > 0 && !sink.write(zeros, padding)) {
+                return false;
+            }
         }
     }
     
     // End of archive: two zero blocks
-    result.insert(result.end(), BLOCK_SIZE * 2, 0);
-    
-    return result;
+    if (!sink.write(zeros, sizeof(zeros))) {
+        return false;
+    }
+    timer.addBytesOut(total);
+    return true;
 }
 
 } // namespace lgx
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "byte_io.h"
+
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -73,7 +75,38 @@ public:
      * @return Complete tar archive data
      */
     std::vector<uint8_t> finalize();
+
+    /**
+     * Finalize and stream the tar archive data into a sink.
+     * Produces exactly the bytes finalize() returns.
+     *
+     * @return false if the sink rejected a write
+     */
+    bool finalizeTo(ByteSink& sink);
     
+    /**
+     * Path an entry is stored and sorted under in the archive (directories
+     * end in '/'). finalize() writes entries in ascending order of it.
+     */
+    static std::string archivePath(const TarEntry& entry);
+
+    /**
+     * Permission bits an entry is stored with (0755 for directories; a
+     * file's own mode, or 0644 if it has none).
+     */
+    static uint32_t archiveMode(const TarEntry& entry);
+
+    /**
+     * Append the bytes finalize() writes for one entry (header, data and
+     * padding) to `out`. Throws std::runtime_error if the path is too long.
+     */
+    static void encodeEntry(const TarEntry& entry, std::vector<uint8_t>& out);
+
+    /**
+     * Size of the zero blocks that end an archive.
+     */
+    static constexpr size_t END_OF_ARCHIVE_SIZE = 1024;
+
     /**
      * Clear all entries.
      */
@@ -102,7 +135,7 @@ private:
     /**
      * Write a single tar header.
      */
-    std::vector<uint8_t> createHeader(const TarEntry& entry);
+    static std::vector<uint8_t> createHeader(const TarEntry& entry);
     
     /**
      * Calculate tar checksum.
@@ -0,0 +1,174 @@
+#include "trace.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace lgx {
+
+namespace {
+
+struct Event {
+    const char* name;
+    uint64_t startUs;
+    uint64_t durationUs;
+    uint32_t threadId;
+    std::string detail;
+};
+
+// Events from all threads, appended when a span ends. Spans sit around
+// whole stages and file batches, not per-byte work, so one lock suffices.
+std::mutex g_mutex;
+std::vector<Event> g_events;
+
+uint64_t nowUs() {
+    static const auto origin = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - origin).count());
+}
+
+// Small, stable per-thread ids read better in the viewer than native ones
+uint32_t currentThreadId() {
+    static std::atomic<uint32_t> next{1};
+    thread_local uint32_t id = next.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+int processId() {
+#ifdef _WIN32
+    return _getpid();
+#else
+    return static_cast<int>(getpid());
+#endif
+}
+
+} // anonymous namespace
+
+std::atomic<bool> Trace::enabled_{false};
+thread_local std::string Trace::lastError_;
+
+#ifndef LGX_NO_TRACING
+
+Trace::Span::Span(const char* name) : name_(name), active_(Trace::isEnabled()) {
+    if (active_) {
+        startUs_ = nowUs();
+    }
+}
+
+Trace::Span::Span(const char* name, const std::string& detail)
+    : name_(name), active_(Trace::isEnabled()) {
+    if (active_) {
+        detail_ = detail;
+        startUs_ = nowUs();
+    }
+}
+
+Trace::Span::~Span() {
+    if (!active_) {
+        return;
+    }
+    uint64_t endUs = nowUs();
+    Event event{name_, startUs_, endUs - startUs_, currentThreadId(), std::move(detail_)};
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_events.push_back(std::move(event));
+}
+
+void Trace::Span::setDetail(const std::string& detail) {
+    if (active_) {
+        detail_ = detail;
+    }
+}
+
+#endif // LGX_NO_TRACING
+
+void Trace::setEnabled(bool enabled) {
+    if (enabled) {
+        nowUs();  // pin the time origin before the first span
+    }
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+size_t Trace::eventCount() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return g_events.size();
+}
+
+void Trace::clear() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_events.clear();
+}
+
+std::string Trace::toJson() {
+    int pid = processId();
+    nlohmann::json events = nlohmann::json::array();
+    std::vector<uint32_t> threads;
+
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        for (const auto& event : g_events) {
+            nlohmann::json entry = {
+                {"name", event.name},
+                {"cat", "lgx"},
+                {"ph", "X"},
+                {"ts", event.startUs},
+                {"dur", event.durationUs},
+                {"pid", pid},
+                {"tid", event.threadId}
+            };
+            if (!event.detail.empty()) {
+                entry["args"] = {{"detail", event.detail}};
+            }
+            events.push_back(std::move(entry));
+
+            if (std::find(threads.begin(), threads.end(), event.threadId) == threads.end()) {
+                threads.push_back(event.threadId);
+            }
+        }
+    }
+
+    for (uint32_t tid : threads) {
+        events.push_back({
+            {"name", "thread_name"},
+            {"ph", "M"},
+            {"pid", pid},
+            {"tid", tid},
+            {"args", {{"name", "thread " + std::to_string(tid)}}}
+        });
+    }
+
+    nlohmann::json result = {
+        {"traceEvents", std::move(events)},
+        {"displayTimeUnit", "ms"}
+    };
+    return result.dump();
+}
+
+bool Trace::writeJson(const std::filesystem::path& path) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        lastError_ = "Cannot open trace file: " + path.string();
+        return false;
+    }
+    file << toJson() << "\n";
+    if (!file) {
+        lastError_ = "Failed to write trace file: " + path.string();
+        return false;
+    }
+    return true;
+}
+
+std::string Trace::getLastError() {
+    return lastError_;
+}
+
+} // namespace lgx
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace lgx {
+
+/**
+ * Timeline tracing: scoped spans recorded per thread and written out as
+ * Chrome Trace Event JSON, which chrome://tracing and Perfetto open directly.
+ *
+ * Unlike Stats, which sums counters per phase, a trace keeps every span with
+ * its start time, duration and thread, so serialization points (one stage
+ * waiting on another, work done twice) show up on the timeline.
+ *
+ * Recording is off by default; a disabled span costs one relaxed atomic
+ * load. Configuring with -DLGX_ENABLE_TRACING=OFF removes spans entirely.
+ * Span names must be string literals (they are stored by pointer).
+ */
+class Trace {
+public:
+    /**
+     * Records the lifetime of a scope as one complete ("X") event.
+     */
+    class Span {
+    public:
+#ifdef LGX_NO_TRACING
+        explicit Span(const char*) {}
+        Span(const char*, const std::string&) {}
+        void setDetail(const std::string&) {}
+#else
+        explicit Span(const char* name);
+
+        /**
+         * @param detail Shown as the event's "detail" argument (e.g. a path)
+         */
+        Span(const char* name, const std::string& detail);
+
+        ~Span();
+
+        /**
+         * Set or replace the detail argument. Ignored when not recording.
+         */
+        void setDetail(const std::string& detail);
+
+    private:
+        const char* name_;
+        bool active_;
+        uint64_t startUs_ = 0;
+        std::string detail_;
+#endif
+
+    public:
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+    };
+
+    /**
+     * Start or stop recording. Recorded events are kept; see clear().
+     */
+    static void setEnabled(bool enabled);
+
+    static bool isEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Number of events recorded so far.
+     */
+    static size_t eventCount();
+
+    /**
+     * Drop all recorded events.
+     */
+    static void clear();
+
+    /**
+     * Render the recorded events as Chrome Trace Event JSON.
+     */
+    static std::string toJson();
+
+    /**
+     * Write toJson() to a file.
+     *
+     * @return false if the file could not be written (see getLastError())
+     */
+    static bool writeJson(const std::filesystem::path& path);
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    static std::atomic<bool> enabled_;
+    static thread_local std::string lastError_;
+};
+
+} // namespace lgx
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lgx {
+
+/**
+ * WorkerPool runs tasks on a fixed set of background threads.
+ *
+ * Tasks are executed in submission order (FIFO) by whichever worker is free.
+ * Destroying the pool finishes every queued task and joins the workers.
+ */
+class WorkerPool {
+public:
+    /**
+     * Create a pool with the given number of threads (at least one).
+     */
+    explicit WorkerPool(size_t threadCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * Queue a task. Tasks must not throw.
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * Number of worker threads.
+     */
+    size_t threadCount() const { return threads_.size(); }
+
+    /**
+     * Library-wide pool used for asynchronous jobs.
+     *
+     * Created on first use with one thread per hardware thread, clamped to
+     * [2, 8]; jobs are I/O- and inflate-heavy, so more threads rarely help.
+     */
+    static WorkerPool& shared();
+
+private:
+    void run();
+
+    std::vector<std::thread> threads_;
+    std::deque<std::function<void()>> queue_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+} // namespace lgx
@@ -1,4 +1,5 @@
 #include "keyring.h"
+#include "../core/trace.h"
 
 #include <cstdlib>
 #include <fstream>
@@ -141,6 +142,7 @@ bool Keyring::removeKey(const std::string& name) {
 }
 
 std::optional<TrustedKey> Keyring::findByDid(const std::string& did) const {
+    Trace::Span span("keyring.lookup", did);
     auto keys = listKeys();
     for (const auto& key : keys) {
         if (key.did == did) {
@@ -206,6 +208,7 @@ std::optional<TrustedKey> Keyring::findByName(const std::string& name) const {
 
 std::vector<TrustedKey> Keyring::listKeys() const {
     namespace fs = std::filesystem;
+    Trace::Span span("keyring.list");
 
     std::vector<TrustedKey> keys;
     std::error_code ec;
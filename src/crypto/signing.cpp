@@ -1,22 +1,51 @@
 #include "signing.h"
 #include "../core/tar_writer.h"
+#include "../core/progress.h"
+#include "../core/stats.h"
+#include "../core/trace.h"
+#include "../core/worker_pool.h"
 
 #include <sodium.h>
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <sstream>
 #include <iomanip>
+#include <map>
 #include <set>
+#include <thread>
 
 namespace lgx {
 namespace crypto {
 
-bool init() {
-    static bool initialized = false;
-    static bool success = false;
-    if (!initialized) {
-        success = (sodium_init() >= 0);
-        initialized = true;
+namespace {
+
+// A verification is pure CPU work of some tens of microseconds; with fewer
+// items per thread, starting the threads costs more than it saves
+constexpr size_t MIN_VERIFY_ITEMS_PER_THREAD = 16;
+constexpr size_t MAX_VERIFY_THREADS = 8;
+
+bool sameItem(const VerifyItem& a, const VerifyItem& b) {
+    return a.signature == b.signature && a.publicKey == b.publicKey &&
+           a.messageLen == b.messageLen &&
+           (a.messageLen == 0 || std::memcmp(a.message, b.message, a.messageLen) == 0);
+}
+
+std::string digestHex(const unsigned char (&hash)[crypto_hash_sha256_BYTES]) {
+    std::ostringstream oss;
+    oss << std::hex << std::setfill('0');
+    for (size_t i = 0; i < crypto_hash_sha256_BYTES; ++i) {
+        oss << std::setw(2) << static_cast<unsigned>(hash[i]);
     }
+    return oss.str();
+}
+
+} // namespace
+
+bool init() {
+    // Function-local static: initialized exactly once even when called
+    // concurrently from job worker threads
+    static const bool success = (sodium_init() >= 0);
     return success;
 }
 
@@ -46,6 +75,56 @@ bool verify(const std::vector<uint8_t>& message, const PublicKey& pk, const Sign
         pk.data()) == 0;
 }
 
+std::vector<bool> verifyBatch(const std::vector<VerifyItem>& items, size_t threads) {
+    Trace::Span span("crypto.verify_batch", std::to_string(items.size()));
+    if (items.empty()) return {};
+    if (!init()) return std::vector<bool>(items.size(), false);
+
+    // The items to check, and for every item the one whose result it takes
+    std::vector<size_t> unique;
+    std::vector<size_t> source(items.size());
+    std::map<Signature, size_t> bySignature;
+    for (size_t i = 0; i < items.size(); ++i) {
+        auto [it, inserted] = bySignature.emplace(items[i].signature, i);
+        if (!inserted && sameItem(items[it->second], items[i])) {
+            source[i] = it->second;
+            continue;
+        }
+        source[i] = i;
+        unique.push_back(i);
+    }
+
+    std::vector<uint8_t> valid(items.size(), 0);  // not vector<bool>: written concurrently
+    std::atomic<size_t> next{0};
+    auto work = [&]() {
+        for (size_t k = next++; k < unique.size(); k = next++) {
+            const VerifyItem& item = items[unique[k]];
+            valid[unique[k]] = crypto_sign_ed25519_verify_detached(
+                item.signature.data(), item.message, item.messageLen,
+                item.publicKey.data()) == 0;
+        }
+    };
+    if (threads == 0) {
+        threads = std::min(static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())),
+                           MAX_VERIFY_THREADS);
+    }
+    threads = std::min(threads, std::max<size_t>(1, unique.size() / MIN_VERIFY_ITEMS_PER_THREAD));
+    if (threads <= 1) {
+        work();
+    } else {
+        WorkerPool pool(threads);
+        for (size_t t = 0; t < threads; ++t) {
+            pool.submit(work);
+        }
+    }
+
+    std::vector<bool> results(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        results[i] = valid[source[i]] != 0;
+    }
+    return results;
+}
+
 std::string sha256Hex(const std::vector<uint8_t>& data) {
     return sha256Hex(data.data(), data.size());
 }
@@ -54,13 +133,25 @@ std::string sha256Hex(const uint8_t* data, size_t len) {
     init();
     unsigned char hash[crypto_hash_sha256_BYTES];
     crypto_hash_sha256(hash, data, len);
+    return digestHex(hash);
+}
 
-    std::ostringstream oss;
-    oss << std::hex << std::setfill('0');
-    for (size_t i = 0; i < crypto_hash_sha256_BYTES; ++i) {
-        oss << std::setw(2) << static_cast<unsigned>(hash[i]);
-    }
-    return oss.str();
+static_assert(sizeof(crypto_hash_sha256_state) <= sizeof(unsigned char[256]),
+              "Sha256::state_ too small for crypto_hash_sha256_state");
+
+Sha256::Sha256() {
+    init();
+    crypto_hash_sha256_init(reinterpret_cast<crypto_hash_sha256_state*>(state_));
+}
+
+void Sha256::update(const uint8_t* data, size_t len) {
+    crypto_hash_sha256_update(reinterpret_cast<crypto_hash_sha256_state*>(state_), data, len);
+}
+
+std::string Sha256::finalHex() {
+    unsigned char hash[crypto_hash_sha256_BYTES];
+    crypto_hash_sha256_final(reinterpret_cast<crypto_hash_sha256_state*>(state_), hash);
+    return digestHex(hash);
 }
 
 std::string base64Encode(const uint8_t* data, size_t len) {
@@ -97,24 +188,16 @@ PublicKey extractPublicKey(const SecretKey& sk) {
     return pk;
 }
 
-std::string computeLeafDirectoryHash(
-    const std::vector<TarEntry>& entries,
-    const std::string& prefix)
-{
-    // Collect non-directory entries under prefix/
-    std::string prefixSlash = prefix + "/";
-    std::vector<std::pair<std::string, const std::vector<uint8_t>*>> files;
-
-    for (const auto& entry : entries) {
-        if (entry.isDirectory) continue;
-        if (entry.path.substr(0, prefixSlash.size()) != prefixSlash) continue;
-
-        std::string relPath = entry.path.substr(prefixSlash.size());
-        if (relPath.empty()) continue;
+namespace {
 
-        files.emplace_back(relPath, &entry.data);
-    }
+/**
+ * Files of one leaf directory: path relative to the directory + contents.
+ */
+using LeafFiles = std::vector<std::pair<std::string, const std::vector<uint8_t>*>>;
 
+std::string hashLeafFiles(LeafFiles& files, const std::string& prefix,
+                          FileHashCache* cache = nullptr) {
+    Trace::Span span("merkle.leaf", prefix);
     if (files.empty()) return "";
 
     // Sort by relative path
@@ -124,7 +207,17 @@ std::string computeLeafDirectoryHash(
     // Build concatenation: path + '\0' + hex_hash + '\n'
     std::vector<uint8_t> concat;
     for (const auto& [relPath, data] : files) {
-        std::string fileHash = sha256Hex(*data);
+        if (Progress::isCancelled()) return "";
+        std::string fileHash;
+        if (cache) {
+            std::string& cached = (*cache)[prefix + "/" + relPath];
+            if (cached.empty()) {
+                cached = sha256Hex(*data);
+            }
+            fileHash = cached;
+        } else {
+            fileHash = sha256Hex(*data);
+        }
         concat.insert(concat.end(), relPath.begin(), relPath.end());
         concat.push_back('\0');
         concat.insert(concat.end(), fileHash.begin(), fileHash.end());
@@ -134,14 +227,14 @@ std::string computeLeafDirectoryHash(
     return sha256Hex(concat);
 }
 
-std::string computeParentDirectoryHash(
-    const std::map<std::string, std::string>& childHashes)
-{
-    if (childHashes.empty()) return "";
+// SHA-256 of (name + '\0' + hex_hash + '\n') for each item in name order;
+// "" if there are none. Leaf and parent directory hashes share this form.
+std::string hashNamedDigests(const std::map<std::string, std::string>& digests) {
+    if (digests.empty()) return "";
 
-    // childHashes is already sorted (std::map)
+    // Already sorted (std::map)
     std::vector<uint8_t> concat;
-    for (const auto& [name, hash] : childHashes) {
+    for (const auto& [name, hash] : digests) {
         concat.insert(concat.end(), name.begin(), name.end());
         concat.push_back('\0');
         concat.insert(concat.end(), hash.begin(), hash.end());
@@ -151,16 +244,73 @@ std::string computeParentDirectoryHash(
     return sha256Hex(concat);
 }
 
+} // anonymous namespace
+
+std::string computeLeafDirectoryHash(
+    const std::vector<TarEntry>& entries,
+    const std::string& prefix)
+{
+    // Collect non-directory entries under prefix/
+    std::string prefixSlash = prefix + "/";
+    LeafFiles files;
+
+    for (const auto& entry : entries) {
+        if (entry.isDirectory) continue;
+        if (entry.path.compare(0, prefixSlash.size(), prefixSlash) != 0) continue;
+        if (entry.path.size() == prefixSlash.size()) continue;
+
+        files.emplace_back(entry.path.substr(prefixSlash.size()), &entry.data);
+    }
+
+    return hashLeafFiles(files, prefix);
+}
+
+std::string computeParentDirectoryHash(
+    const std::map<std::string, std::string>& childHashes)
+{
+    Trace::Span span("merkle.parent");
+    return hashNamedDigests(childHashes);
+}
+
+std::string computeLeafHashFromDigests(
+    const std::map<std::string, std::string>& fileDigests)
+{
+    Trace::Span span("merkle.leaf_digests");
+    return hashNamedDigests(fileDigests);
+}
+
 std::map<std::string, std::string> computeMerkleTree(
     const std::vector<TarEntry>& entries)
 {
+    return computeMerkleTree(entries, nullptr);
+}
+
+std::map<std::string, std::string> computeMerkleTree(
+    const std::vector<TarEntry>& entries,
+    FileHashCache* cache)
+{
+    Stats::Timer timer(Stats::Phase::Hash);
+    Trace::Span span("merkle.tree");
+    if (timer.active()) {
+        for (const auto& entry : entries) {
+            if (entry.isDirectory || entry.path == "manifest.json" || entry.path == "manifest.sig") continue;
+            if (cache && cache->count(entry.path)) continue;  // not hashed again
+            timer.addEntries();
+            timer.addBytesIn(entry.data.size());
+        }
+    }
+
     std::map<std::string, std::string> result;
 
-    // Discover all top-level directories and their children
+    // Discover all top-level directories and their children, and bucket
+    // every file under its leaf directory in the same pass, so the cost
+    // stays linear however many variants an archive declares
     // Skip manifest.json and manifest.sig
     std::set<std::string> topLevelDirs;
     // For "variants", also track child directories
     std::set<std::string> variantChildren;
+    std::map<std::string, LeafFiles> topLevelFiles;   // "docs" -> files under docs/
+    std::map<std::string, LeafFiles> variantFiles;    // "linux-amd64" -> files under variants/linux-amd64/
 
     for (const auto& entry : entries) {
         if (entry.path == "manifest.json" || entry.path == "manifest.sig") continue;
@@ -175,25 +325,34 @@ std::map<std::string, std::string> computeMerkleTree(
         topDir = entry.path.substr(0, slashPos);
         topLevelDirs.insert(topDir);
 
+        if (topDir != "variants") {
+            if (!entry.isDirectory && slashPos + 1 < entry.path.size()) {
+                topLevelFiles[topDir].emplace_back(entry.path.substr(slashPos + 1), &entry.data);
+            }
+            continue;
+        }
+
         // For "variants", track child directories
-        if (topDir == "variants") {
-            size_t secondSlash = entry.path.find('/', slashPos + 1);
-            if (secondSlash != std::string::npos || entry.isDirectory) {
-                std::string variantName;
-                if (secondSlash != std::string::npos) {
-                    variantName = entry.path.substr(slashPos + 1, secondSlash - slashPos - 1);
-                } else {
-                    // Directory entry like "variants/darwin-arm64"
-                    variantName = entry.path.substr(slashPos + 1);
-                    // Remove trailing slash if present
-                    while (!variantName.empty() && variantName.back() == '/') {
-                        variantName.pop_back();
-                    }
-                }
-                if (!variantName.empty()) {
-                    variantChildren.insert(variantName);
+        size_t secondSlash = entry.path.find('/', slashPos + 1);
+        if (secondSlash != std::string::npos || entry.isDirectory) {
+            std::string variantName;
+            if (secondSlash != std::string::npos) {
+                variantName = entry.path.substr(slashPos + 1, secondSlash - slashPos - 1);
+            } else {
+                // Directory entry like "variants/darwin-arm64"
+                variantName = entry.path.substr(slashPos + 1);
+                // Remove trailing slash if present
+                while (!variantName.empty() && variantName.back() == '/') {
+                    variantName.pop_back();
                 }
             }
+            if (!variantName.empty()) {
+                variantChildren.insert(variantName);
+            }
+            if (!entry.isDirectory && secondSlash != std::string::npos &&
+                secondSlash + 1 < entry.path.size()) {
+                variantFiles[variantName].emplace_back(entry.path.substr(secondSlash + 1), &entry.data);
+            }
         }
     }
 
@@ -205,8 +364,7 @@ std::map<std::string, std::string> computeMerkleTree(
             // Handle variants separately (parent directory)
             std::map<std::string, std::string> variantHashes;
             for (const auto& variant : variantChildren) {
-                std::string prefix = "variants/" + variant;
-                std::string hash = computeLeafDirectoryHash(entries, prefix);
+                std::string hash = hashLeafFiles(variantFiles[variant], "variants/" + variant, cache);
                 if (!hash.empty()) {
                     variantHashes[variant] = hash;
                     result["variants/" + variant] = hash;
@@ -219,7 +377,7 @@ std::map<std::string, std::string> computeMerkleTree(
             }
         } else {
             // Leaf directory (docs, licenses, etc.)
-            std::string hash = computeLeafDirectoryHash(entries, topDir);
+            std::string hash = hashLeafFiles(topLevelFiles[topDir], topDir, cache);
             if (!hash.empty()) {
                 result[topDir] = hash;
                 topLevelHashes[topDir] = hash;
@@ -227,6 +385,11 @@ std::map<std::string, std::string> computeMerkleTree(
         }
     }
 
+    // A cancelled run produces partial hashes; never hand those out
+    if (Progress::isCancelled()) {
+        return {};
+    }
+
     // Compute root hash
     if (!topLevelHashes.empty()) {
         result["root"] = computeParentDirectoryHash(topLevelHashes);
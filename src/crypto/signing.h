@@ -5,6 +5,7 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace lgx {
@@ -59,6 +60,28 @@ Signature sign(const std::vector<uint8_t>& message, const SecretKey& sk);
  */
 bool verify(const std::vector<uint8_t>& message, const PublicKey& pk, const Signature& sig);
 
+/**
+ * One detached signature for verifyBatch(). The message is not copied and
+ * must outlive the call.
+ */
+struct VerifyItem {
+    const uint8_t* message = nullptr;
+    size_t messageLen = 0;
+    PublicKey publicKey{};
+    Signature signature{};
+};
+
+/**
+ * Verify many detached Ed25519 signatures.
+ *
+ * results[i] is exactly what verify() returns for items[i]: each item is
+ * checked on its own by libsodium, so a bad signature is located without a
+ * second pass and never affects the others. Items identical to an earlier
+ * one are not checked again. The rest are spread over up to `threads`
+ * threads (0 = one per CPU, at most 8).
+ */
+std::vector<bool> verifyBatch(const std::vector<VerifyItem>& items, size_t threads = 0);
+
 /**
  * Compute SHA-256 hash and return as hex string (64 chars).
  */
@@ -69,6 +92,26 @@ std::string sha256Hex(const std::vector<uint8_t>& data);
  */
 std::string sha256Hex(const uint8_t* data, size_t len);
 
+/**
+ * Incremental SHA-256 for data that arrives in pieces, e.g. a file read
+ * in chunks. The digest equals sha256Hex() over the concatenated input.
+ */
+class Sha256 {
+public:
+    Sha256();
+
+    void update(const uint8_t* data, size_t len);
+
+    /**
+     * Finish and return the digest as a hex string; the object must not
+     * be updated afterwards.
+     */
+    std::string finalHex();
+
+private:
+    alignas(16) unsigned char state_[256];  // crypto_hash_sha256_state
+};
+
 /**
  * Base64 encode raw bytes.
  */
@@ -95,6 +138,18 @@ std::string computeLeafDirectoryHash(
     const std::vector<TarEntry>& entries,
     const std::string& prefix);
 
+/**
+ * Compute a leaf directory hash from file digests instead of contents.
+ *
+ * Gives the same result as computeLeafDirectoryHash() for files with
+ * these digests, e.g. to check an extracted tree against the manifest.
+ *
+ * @param fileDigests Map of path relative to the directory -> hex SHA-256
+ * @return Hex-encoded SHA-256 hash, or empty string if there are no files
+ */
+std::string computeLeafHashFromDigests(
+    const std::map<std::string, std::string>& fileDigests);
+
 /**
  * Compute parent directory hash from sorted child directory hashes.
  *
@@ -107,6 +162,12 @@ std::string computeLeafDirectoryHash(
 std::string computeParentDirectoryHash(
     const std::map<std::string, std::string>& childHashes);
 
+/**
+ * File digests kept between computeMerkleTree() calls: archive path -> hex
+ * SHA-256 of the file. Whoever changes a file's contents must erase its path.
+ */
+using FileHashCache = std::unordered_map<std::string, std::string>;
+
 /**
  * Build a full Merkle tree over all archive content.
  *
@@ -118,12 +179,24 @@ std::string computeParentDirectoryHash(
  *   "docs" - leaf hash of docs/ files
  *   "licenses" - leaf hash of licenses/ files
  *
+ * Stops early and returns an empty map if the current operation is
+ * cancelled (see Progress).
+ *
  * @param entries All tar entries in the archive
  * @return Map of path -> hex SHA-256 hash
  */
 std::map<std::string, std::string> computeMerkleTree(
     const std::vector<TarEntry>& entries);
 
+/**
+ * Build the Merkle tree, taking file digests from `cache` where present and
+ * adding the ones computed. Only the directory hashes are recomputed for
+ * files found in the cache.
+ */
+std::map<std::string, std::string> computeMerkleTree(
+    const std::vector<TarEntry>& entries,
+    FileHashCache* cache);
+
 /**
  * Extract the public key from a secret key.
  */
@@ -5,12 +5,25 @@
  * This header provides a C API for working with LGX packages.
  * It wraps the C++ implementation with a stable C interface for
  * cross-language interoperability.
+ *
+ * Thread safety:
+ * - Read-only calls on a package handle may be made from any number of
+ *   threads at once without locking: lgx_get_* (including
+ *   lgx_get_manifest_json), lgx_has_variant, lgx_get_variants, lgx_save*,
+ *   lgx_extract, lgx_package_clone and lgx_job_start_extract.
+ * - Mutating calls (lgx_set_*, lgx_add_variant, lgx_remove_variant) and
+ *   lgx_free_package need exclusive access to that handle. They never affect
+ *   other handles, including clones.
+ * - Strings returned by getters stay valid until the handle is modified or
+ *   freed.
+ * - Error messages are stored per thread (see lgx_get_last_error()).
  */
 
 #ifndef LGX_H
 #define LGX_H
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 #ifdef __cplusplus
@@ -66,6 +79,17 @@ typedef struct {
  */
 LGX_EXPORT lgx_result_t lgx_create(const char* output_path, const char* name);
 
+/**
+ * Build a complete package from a JSON build spec (see `lgx build`).
+ * All inputs are read in parallel and the package is written once.
+ *
+ * @param spec_path Path to the build spec
+ * @param output_path Path to write the .lgx file, or NULL for the spec's
+ *                    "output" (else <name>.lgx in the current directory)
+ * @return Result indicating success or failure
+ */
+LGX_EXPORT lgx_result_t lgx_build(const char* spec_path, const char* output_path);
+
 /**
  * Load an existing LGX package from file.
  * 
@@ -74,6 +98,30 @@ LGX_EXPORT lgx_result_t lgx_create(const char* output_path, const char* name);
  */
 LGX_EXPORT lgx_package_t lgx_load(const char* path);
 
+/**
+ * Load an LGX package from memory.
+ *
+ * The buffer is read in place (no copy is made) and only during this call;
+ * the caller keeps ownership and may free it as soon as this returns.
+ *
+ * @param data Pointer to the compressed .lgx bytes
+ * @param size Number of bytes at data
+ * @return Package handle, or NULL on error (check lgx_get_last_error())
+ */
+LGX_EXPORT lgx_package_t lgx_load_from_memory(const void* data, size_t size);
+
+/**
+ * Create a new handle to the same package.
+ *
+ * The clone shares the decoded contents with pkg, so this is cheap regardless
+ * of package size. Modifying either handle afterwards copies the contents
+ * for that handle first, so the other one is unaffected.
+ *
+ * @param pkg Package handle
+ * @return New package handle (free with lgx_free_package()), or NULL on error
+ */
+LGX_EXPORT lgx_package_t lgx_package_clone(lgx_package_t pkg);
+
 /**
  * Save a package to file.
  * 
@@ -83,6 +131,40 @@ LGX_EXPORT lgx_package_t lgx_load(const char* path);
  */
 LGX_EXPORT lgx_result_t lgx_save(lgx_package_t pkg, const char* path);
 
+/**
+ * Save a package into a newly allocated buffer.
+ *
+ * @param pkg Package handle
+ * @param out_data Receives the buffer holding the .lgx bytes.
+ *        Free with lgx_free_buffer().
+ * @param out_size Receives the number of bytes in the buffer
+ * @return Result indicating success or failure
+ */
+LGX_EXPORT lgx_result_t lgx_save_to_buffer(lgx_package_t pkg, void** out_data, size_t* out_size);
+
+/**
+ * Callback receiving a chunk of output bytes.
+ *
+ * @param data Chunk of bytes (valid only for the duration of the call)
+ * @param size Number of bytes in the chunk
+ * @param user_data Opaque pointer passed through from the caller
+ * @return true to continue, false to abort the write
+ */
+typedef bool (*lgx_write_fn)(const void* data, size_t size, void* user_data);
+
+/**
+ * Save a package by streaming its bytes to a callback.
+ *
+ * Compressed output is delivered in chunks as it is produced, in order.
+ * The concatenated chunks are identical to what lgx_save() writes.
+ *
+ * @param pkg Package handle
+ * @param write Callback receiving each chunk
+ * @param user_data Opaque pointer passed to every callback invocation
+ * @return Result indicating success or failure (including callback abort)
+ */
+LGX_EXPORT lgx_result_t lgx_save_to_callback(lgx_package_t pkg, lgx_write_fn write, void* user_data);
+
 /**
  * Verify a package file.
  * 
@@ -153,7 +235,7 @@ LGX_EXPORT const char** lgx_get_variants(lgx_package_t pkg);
  * Get the package name from manifest.
  * 
  * @param pkg Package handle
- * @return Package name, owned by library (valid until package is freed)
+ * @return Package name, owned by library (valid until the handle is modified or freed)
  */
 LGX_EXPORT const char* lgx_get_name(lgx_package_t pkg);
 
@@ -161,7 +243,7 @@ LGX_EXPORT const char* lgx_get_name(lgx_package_t pkg);
  * Get the package version from manifest.
  * 
  * @param pkg Package handle
- * @return Package version, owned by library (valid until package is freed)
+ * @return Package version, owned by library (valid until the handle is modified or freed)
  */
 LGX_EXPORT const char* lgx_get_version(lgx_package_t pkg);
 
@@ -178,7 +260,7 @@ LGX_EXPORT lgx_result_t lgx_set_version(lgx_package_t pkg, const char* version);
  * Get the package description from manifest.
  * 
  * @param pkg Package handle
- * @return Package description, owned by library (valid until package is freed)
+ * @return Package description, owned by library (valid until the handle is modified or freed)
  */
 LGX_EXPORT const char* lgx_get_description(lgx_package_t pkg);
 
@@ -194,7 +276,7 @@ LGX_EXPORT void lgx_set_description(lgx_package_t pkg, const char* description);
  * Get the package icon path from manifest.
  *
  * @param pkg Package handle
- * @return Package icon path, owned by library (valid until package is freed)
+ * @return Package icon path, owned by library (valid until the handle is modified or freed)
  */
 LGX_EXPORT const char* lgx_get_icon(lgx_package_t pkg);
 
@@ -210,7 +292,7 @@ LGX_EXPORT void lgx_set_icon(lgx_package_t pkg, const char* icon);
  * Get the full manifest as a JSON string.
  *
  * @param pkg Package handle
- * @return JSON string of the manifest, owned by library (valid until package is freed)
+ * @return JSON string of the manifest, owned by library (valid until the handle is modified or freed)
  */
 LGX_EXPORT const char* lgx_get_manifest_json(lgx_package_t pkg);
 
@@ -244,6 +326,27 @@ LGX_EXPORT lgx_signature_info_t lgx_verify_signature(
  */
 LGX_EXPORT void lgx_free_signature_info(lgx_signature_info_t info);
 
+typedef struct {
+    const uint8_t* message;     /* signed bytes */
+    size_t message_len;
+    const uint8_t* public_key;  /* 32-byte Ed25519 public key */
+    const uint8_t* signature;   /* 64-byte detached signature */
+} lgx_signature_item_t;
+
+/**
+ * Verify many detached Ed25519 signatures, e.g. the manifest.sig of every
+ * package in a catalog. out_valid[i] is set to whether items[i] verifies,
+ * exactly as a separate check would report it. Identical items are
+ * checked once, and the rest are spread over the available CPUs.
+ *
+ * @param items Signatures to check
+ * @param count Number of items
+ * @param out_valid Receives one result per item
+ * @return Result indicating success or failure (invalid arguments)
+ */
+LGX_EXPORT lgx_result_t lgx_verify_signatures(
+    const lgx_signature_item_t* items, size_t count, bool* out_valid);
+
 /**
  * Sign a package with a secret key.
  *
@@ -325,8 +428,456 @@ LGX_EXPORT lgx_keyring_list_t lgx_keyring_list(const char* keyring_dir);
  */
 LGX_EXPORT void lgx_free_keyring_list(lgx_keyring_list_t list);
 
+/* Asynchronous jobs */
+
+/*
+ * Long-running operations can run on a library-owned worker pool instead of
+ * blocking the calling thread. Each lgx_job_start_* function returns a job
+ * handle immediately (or NULL on invalid arguments, see lgx_get_last_error()).
+ *
+ * Progress can be polled with lgx_job_get_progress() or delivered through
+ * the on_progress callback. lgx_job_cancel() requests cooperative
+ * cancellation; the job stops at the next chunk or entry boundary.
+ *
+ * Callbacks run on a worker thread and must not call lgx_job_wait() on
+ * their own job. on_complete may call lgx_job_free().
+ */
+
+typedef struct lgx_job_opaque* lgx_job_t;
+
+typedef enum {
+    LGX_JOB_RUNNING = 0,  /* queued or in progress */
+    LGX_JOB_SUCCEEDED,    /* finished; results can be taken */
+    LGX_JOB_FAILED,       /* finished with an error, see lgx_job_get_error() */
+    LGX_JOB_CANCELLED     /* stopped by lgx_job_cancel() */
+} lgx_job_status_t;
+
+typedef struct {
+    uint64_t bytes_processed;   /* bytes inflated (load/verify) or written (extract) */
+    uint64_t bytes_total;       /* expected bytes_processed at completion, 0 if unknown */
+    uint64_t entries_processed; /* archive entries read or files extracted */
+} lgx_job_progress_t;
+
+/**
+ * Progress callback. Invoked at most every few tens of milliseconds,
+ * plus once when the job finishes.
+ */
+typedef void (*lgx_job_progress_fn)(lgx_job_t job, lgx_job_progress_t progress, void* user_data);
+
+/**
+ * Completion callback. Invoked exactly once with the final status; results
+ * can be taken from inside the callback.
+ */
+typedef void (*lgx_job_complete_fn)(lgx_job_t job, lgx_job_status_t status, void* user_data);
+
+typedef struct {
+    lgx_job_progress_fn on_progress;  /* may be NULL */
+    lgx_job_complete_fn on_complete;  /* may be NULL */
+    void* user_data;                  /* passed to both callbacks */
+} lgx_job_callbacks_t;
+
+/**
+ * Load a package in the background (see lgx_load()).
+ * Take the result with lgx_job_take_package().
+ *
+ * @param path Path to the .lgx file
+ * @param callbacks Optional callbacks (NULL for none; copied)
+ * @return Job handle, or NULL on invalid arguments
+ */
+LGX_EXPORT lgx_job_t lgx_job_start_load(const char* path, const lgx_job_callbacks_t* callbacks);
+
+/**
+ * Verify a package file in the background (see lgx_verify()).
+ * The job succeeds once verification has run, whether or not the package
+ * is valid; take the result with lgx_job_take_verify_result().
+ *
+ * @param path Path to the .lgx file to verify
+ * @param callbacks Optional callbacks (NULL for none; copied)
+ * @return Job handle, or NULL on invalid arguments
+ */
+LGX_EXPORT lgx_job_t lgx_job_start_verify(const char* path, const lgx_job_callbacks_t* callbacks);
+
+/**
+ * Verify a package signature in the background (see lgx_verify_signature()).
+ * Take the result with lgx_job_take_signature_info().
+ *
+ * @param lgx_path Path to the .lgx package file
+ * @param keyring_dir Path to trusted keys directory (NULL for default)
+ * @param callbacks Optional callbacks (NULL for none; copied)
+ * @return Job handle, or NULL on invalid arguments
+ */
+LGX_EXPORT lgx_job_t lgx_job_start_verify_signature(
+    const char* lgx_path, const char* keyring_dir, const lgx_job_callbacks_t* callbacks);
+
+/**
+ * Extract variant contents in the background (see lgx_extract()).
+ * The job works on a snapshot of pkg taken by this call, so pkg may be
+ * modified or freed while the job runs.
+ *
+ * @param pkg Package handle
+ * @param variant Variant name (NULL to extract all variants)
+ * @param output_dir Output directory path
+ * @param callbacks Optional callbacks (NULL for none; copied)
+ * @return Job handle, or NULL on invalid arguments
+ */
+LGX_EXPORT lgx_job_t lgx_job_start_extract(
+    lgx_package_t pkg, const char* variant, const char* output_dir,
+    const lgx_job_callbacks_t* callbacks);
+
+/**
+ * Get the current status of a job (non-blocking).
+ */
+LGX_EXPORT lgx_job_status_t lgx_job_get_status(lgx_job_t job);
+
+/**
+ * Get a snapshot of the job's progress counters (non-blocking).
+ */
+LGX_EXPORT lgx_job_progress_t lgx_job_get_progress(lgx_job_t job);
+
+/**
+ * Request cancellation. Returns immediately; the job finishes with
+ * LGX_JOB_CANCELLED unless it already completed.
+ */
+LGX_EXPORT void lgx_job_cancel(lgx_job_t job);
+
+/**
+ * Block until the job has finished and its on_complete callback returned.
+ *
+ * @return Final job status
+ */
+LGX_EXPORT lgx_job_status_t lgx_job_wait(lgx_job_t job);
+
+/**
+ * Get the error message of a failed or cancelled job.
+ *
+ * @return Error message owned by the job (valid until lgx_job_free()),
+ *         or NULL if the job is still running or has no error
+ */
+LGX_EXPORT const char* lgx_job_get_error(lgx_job_t job);
+
+/**
+ * Take the package loaded by a successful lgx_job_start_load() job.
+ *
+ * @return Package handle owned by the caller (free with lgx_free_package()),
+ *         or NULL if there is none or it was already taken
+ */
+LGX_EXPORT lgx_package_t lgx_job_take_package(lgx_job_t job);
+
+/**
+ * Take the result of a successful lgx_job_start_verify() job.
+ *
+ * @param out_result Receives the result (free with lgx_free_verify_result())
+ * @return true if a result was available and has not been taken before
+ */
+LGX_EXPORT bool lgx_job_take_verify_result(lgx_job_t job, lgx_verify_result_t* out_result);
+
+/**
+ * Take the result of a successful lgx_job_start_verify_signature() job.
+ *
+ * @param out_info Receives the result (free with lgx_free_signature_info())
+ * @return true if a result was available and has not been taken before
+ */
+LGX_EXPORT bool lgx_job_take_signature_info(lgx_job_t job, lgx_signature_info_t* out_info);
+
+/**
+ * Release a job handle and any results not taken.
+ * A job that is still running is cancelled and cleans up when it stops.
+ *
+ * @param job Job handle to free (NULL is ignored)
+ */
+LGX_EXPORT void lgx_job_free(lgx_job_t job);
+
+/* Decoded-package cache */
+
+/*
+ * An opt-in, process-wide LRU cache of decoded packages used by lgx_load(),
+ * lgx_verify(), lgx_verify_signature() and load jobs. Repeated loads of an
+ * unchanged file share one decoded copy instead of inflating it again.
+ *
+ * Entries are keyed by path and validated against the file's device, inode,
+ * size and modification time, so a file that changes on disk is reloaded.
+ * Handles from a cached load are independent: modifying one copies the
+ * package first and never affects the cache or other handles.
+ */
+
+typedef struct {
+    uint64_t hits;      /* loads served from the cache */
+    uint64_t misses;    /* loads that had to decode the file */
+    uint64_t evictions; /* entries dropped to stay within the budget */
+    size_t entries;     /* packages currently cached */
+    size_t bytes;       /* approximate decoded bytes currently cached */
+    size_t budget;      /* current byte budget (0 = disabled) */
+} lgx_cache_stats_t;
+
+/**
+ * Set the cache budget in bytes of decoded package data.
+ * The cache is disabled by default; 0 disables it and drops all entries.
+ * Packages larger than the budget are never cached.
+ *
+ * @param max_bytes Byte budget
+ */
+LGX_EXPORT void lgx_cache_set_budget(size_t max_bytes);
+
+/**
+ * Get the current cache budget in bytes (0 = disabled).
+ */
+LGX_EXPORT size_t lgx_cache_get_budget(void);
+
+/**
+ * Drop all cached packages. Counters are kept.
+ */
+LGX_EXPORT void lgx_cache_clear(void);
+
+/**
+ * Get cache counters and current usage.
+ */
+LGX_EXPORT lgx_cache_stats_t lgx_cache_get_stats(void);
+
+/**
+ * Reset the hit, miss and eviction counters to zero.
+ */
+LGX_EXPORT void lgx_cache_reset_stats(void);
+
+/* Package catalog */
+
+/*
+ * An on-disk index of the .lgx files under a directory (name, version,
+ * dependencies and signer of each), so lookups do not open every package.
+ * lgx_catalog_update() re-reads only files whose device, inode, size or
+ * modification time changed, and reads just manifest.json and manifest.sig
+ * of each. Signers are recorded only if the signature verifies over the
+ * manifest; content hashes are not checked.
+ */
+
+typedef struct lgx_catalog_opaque* lgx_catalog_t;
+
+typedef struct {
+    const char* path;          /* package file */
+    const char* name;
+    const char* version;
+    const char* type;          /* NULL if unset */
+    const char* signer;        /* did:jwk:... of the verified signer, NULL if unsigned */
+    const char* root_hash;     /* Merkle root from the manifest, NULL if absent */
+    const char** dependencies; /* NULL-terminated, "name [range] [signer=did]" */
+} lgx_catalog_entry_t;
+
+typedef struct {
+    lgx_catalog_entry_t* entries;  /* ordered by name, newest version first */
+    size_t count;
+} lgx_catalog_list_t;
+
+typedef struct {
+    size_t scanned;    /* .lgx files found */
+    size_t parsed;     /* files read because they were new or changed */
+    size_t unchanged;  /* index records reused */
+    size_t removed;    /* records dropped for files that are gone */
+    size_t failed;     /* files that could not be indexed */
+} lgx_catalog_update_stats_t;
+
+/**
+ * Build or refresh the index of a directory.
+ *
+ * @param dir Directory to scan (recursively)
+ * @param index_path Index file, or NULL for <dir>/.lgx-catalog.jsonl
+ * @param rebuild true to ignore any existing index and read every file
+ * @param out_stats Receives counts (may be NULL)
+ * @return Result indicating success or failure
+ */
+LGX_EXPORT lgx_result_t lgx_catalog_update(
+    const char* dir, const char* index_path, bool rebuild,
+    lgx_catalog_update_stats_t* out_stats);
+
+/**
+ * Open an existing index for queries.
+ *
+ * @param dir Catalog directory
+ * @param index_path Index file, or NULL for <dir>/.lgx-catalog.jsonl
+ * @return Catalog handle, or NULL on error (check lgx_get_last_error())
+ */
+LGX_EXPORT lgx_catalog_t lgx_catalog_open(const char* dir, const char* index_path);
+
+/**
+ * Find packages. NULL or empty criteria match everything.
+ *
+ * @param catalog Catalog handle
+ * @param name Exact package name
+ * @param version_range Semver range, e.g. "^1.2"
+ * @param signer Signer DID
+ * @param out_list Receives the matches (free with lgx_free_catalog_list())
+ * @return Result indicating success or failure (e.g. invalid range)
+ */
+LGX_EXPORT lgx_result_t lgx_catalog_find(
+    lgx_catalog_t catalog, const char* name, const char* version_range,
+    const char* signer, lgx_catalog_list_t* out_list);
+
+/**
+ * Free a list returned by lgx_catalog_find().
+ */
+LGX_EXPORT void lgx_free_catalog_list(lgx_catalog_list_t list);
+
+/**
+ * Free a catalog handle (NULL is ignored).
+ */
+LGX_EXPORT void lgx_catalog_free(lgx_catalog_t catalog);
+
+/* Dependency resolution */
+
+/*
+ * Chooses one version of every package needed to satisfy a set of
+ * requirements, from the packages of a catalog, following their
+ * dependencies. The newest version that satisfies every range and signer
+ * pin is preferred; conflicts are resolved by backtracking.
+ */
+
+typedef struct {
+    const char* name;           /* package name */
+    const char* version_range;  /* semver range, NULL for any release */
+    const char* signer;         /* required signer DID, NULL for any */
+} lgx_requirement_t;
+
+typedef struct {
+    const char* name;
+    const char* version;
+    const char* path;    /* package file */
+    const char* signer;  /* did:jwk:... of the verified signer, NULL if unsigned */
+} lgx_resolved_package_t;
+
+typedef struct {
+    lgx_resolved_package_t* packages;  /* ordered by name */
+    size_t count;
+} lgx_resolution_t;
+
+/**
+ * Resolve requirements against a catalog. On failure the error explains
+ * the conflict (e.g. which packages require incompatible ranges).
+ *
+ * @param catalog Catalog handle
+ * @param requirements Array of requirements
+ * @param count Number of requirements
+ * @param out Receives the chosen packages (free with lgx_free_resolution())
+ * @return Result indicating success or failure
+ */
+LGX_EXPORT lgx_result_t lgx_resolve(
+    lgx_catalog_t catalog, const lgx_requirement_t* requirements, size_t count,
+    lgx_resolution_t* out);
+
+/**
+ * Free a resolution returned by lgx_resolve().
+ */
+LGX_EXPORT void lgx_free_resolution(lgx_resolution_t resolution);
+
+/* Lockfiles */
+
+/*
+ * A lockfile pins packages by name: version, Merkle root, signer DID, file
+ * size and file SHA-256, recorded after full verification. Checking a
+ * package against its entry is one streaming hash pass over the file, with
+ * no Merkle, signature or keyring work.
+ */
+
+typedef enum {
+    LGX_LOCK_MATCH = 0,   /* the file is the locked package */
+    LGX_LOCK_MISMATCH,    /* a lock entry exists but the file differs */
+    LGX_LOCK_NOT_LOCKED,  /* no entry: verify the package in full */
+    LGX_LOCK_ERROR        /* lockfile or package unreadable, see lgx_get_last_error() */
+} lgx_lock_status_t;
+
+/**
+ * Fully verify a package and add it to a lockfile (created if missing),
+ * replacing any entry with the same name.
+ *
+ * @param lockfile_path Lockfile to update
+ * @param lgx_path Package to lock
+ * @return Result indicating success or failure (e.g. verification failed)
+ */
+LGX_EXPORT lgx_result_t lgx_lock_add(const char* lockfile_path, const char* lgx_path);
+
+/**
+ * Check a package against its lock entry. On LGX_LOCK_MISMATCH the last
+ * error says what differs.
+ *
+ * @param lockfile_path Lockfile
+ * @param lgx_path Package file
+ * @return Check status
+ */
+LGX_EXPORT lgx_lock_status_t lgx_lock_check(const char* lockfile_path, const char* lgx_path);
+
+/* Operation statistics */
+
+/*
+ * Process-wide counters and timers for each processing phase, summed over
+ * all threads. Collection is off by default and costs next to nothing while
+ * off. Phases may nest (normalization runs inside extraction), so wall times
+ * of different phases are not additive.
+ */
+
+typedef struct {
+    uint64_t calls;     /* phase invocations */
+    uint64_t bytes_in;  /* bytes consumed */
+    uint64_t bytes_out; /* bytes produced */
+    uint64_t entries;   /* tar entries, files or paths processed */
+    uint64_t syscalls;  /* file system calls issued */
+    uint64_t wall_ns;   /* wall-clock time */
+    uint64_t cpu_ns;    /* CPU time of the calling threads (0 if unsupported) */
+} lgx_phase_stats_t;
+
+typedef struct {
+    lgx_phase_stats_t file_read;   /* reading .lgx files */
+    lgx_phase_stats_t inflate;     /* gzip decompression */
+    lgx_phase_stats_t tar_parse;   /* tar stream -> entries */
+    lgx_phase_stats_t tar_write;   /* entries -> tar stream */
+    lgx_phase_stats_t deflate;     /* gzip compression */
+    lgx_phase_stats_t file_write;  /* writing .lgx files */
+    lgx_phase_stats_t normalize;   /* Unicode NFC normalization and checks */
+    lgx_phase_stats_t hash;        /* Merkle tree hashing */
+    lgx_phase_stats_t extract;     /* writing variant files to disk */
+    uint64_t peak_buffer_bytes;    /* largest transient buffer allocated */
+} lgx_stats_t;
+
+/**
+ * Turn statistics collection on or off. Counters are kept when turning off.
+ *
+ * @param enabled true to collect
+ */
+LGX_EXPORT void lgx_stats_enable(bool enabled);
+
+/**
+ * Get a snapshot of all counters.
+ */
+LGX_EXPORT lgx_stats_t lgx_get_stats(void);
+
+/**
+ * Reset all counters to zero.
+ */
+LGX_EXPORT void lgx_stats_reset(void);
+
 /* Memory management */
 
+/*
+ * Allocator hooks. Strings, arrays and buffers returned by the library, and
+ * the large scratch buffers used while loading and saving packages, are
+ * allocated through these functions. Install them before using the library,
+ * or while none of the memory it returned is still live: memory must be
+ * released with the matching lgx_free_* function under the same allocator
+ * that produced it.
+ */
+
+typedef struct {
+    void* (*malloc_fn)(size_t size, void* user_data);
+    void* (*realloc_fn)(void* ptr, size_t size, void* user_data);
+    void (*free_fn)(void* ptr, void* user_data);
+    void* user_data;    /* passed to every call */
+} lgx_allocator_t;
+
+/**
+ * Install allocator hooks.
+ *
+ * @param allocator Hooks to use, or NULL to restore malloc/realloc/free
+ * @return true on success, false if any function is missing (the current
+ *         allocator is kept)
+ */
+LGX_EXPORT bool lgx_set_allocator(const lgx_allocator_t* allocator);
+
 /**
  * Free a package handle.
  * 
@@ -341,6 +892,13 @@ LGX_EXPORT void lgx_free_package(lgx_package_t pkg);
  */
 LGX_EXPORT void lgx_free_string_array(const char** array);
 
+/**
+ * Free a buffer returned by lgx_save_to_buffer().
+ *
+ * @param data Buffer to free (NULL is ignored)
+ */
+LGX_EXPORT void lgx_free_buffer(void* data);
+
 /**
  * Free a verify result structure.
  * 
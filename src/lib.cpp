@@ -7,7 +7,16 @@
 
 #include "lgx.h"
 #include "core/package.h"
+#include "core/build_spec.h"
+#include "core/catalog.h"
+#include "core/lockfile.h"
 #include "core/manifest.h"
+#include "core/memory.h"
+#include "core/package_cache.h"
+#include "core/progress.h"
+#include "core/resolver.h"
+#include "core/stats.h"
+#include "core/worker_pool.h"
 #include "crypto/signing.h"
 #include "crypto/keyring.h"
 
@@ -15,7 +24,14 @@
 #include <vector>
 #include <memory>
 #include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
 
 /* Thread-local error storage */
 thread_local std::string g_last_error;
@@ -30,9 +46,19 @@ static void clear_error() {
     g_last_error.clear();
 }
 
+/* Allocation helpers: everything handed to callers goes through the hooks
+ * installed with lgx_set_allocator() and is released by the lgx_free_* path */
+static void* lgx_alloc(size_t size) {
+    return lgx::Memory::allocate(size);
+}
+
+static void lgx_release(const void* ptr) {
+    lgx::Memory::release(const_cast<void*>(ptr));
+}
+
 /* Helper to copy std::string to C string (caller must free) */
 static char* strdup_cpp(const std::string& str) {
-    char* result = static_cast<char*>(malloc(str.length() + 1));
+    char* result = static_cast<char*>(lgx_alloc(str.length() + 1));
     if (result) {
         std::strcpy(result, str.c_str());
     }
@@ -41,7 +67,7 @@ static char* strdup_cpp(const std::string& str) {
 
 /* Helper to convert vector<string> to NULL-terminated C string array */
 static const char** vector_to_array(const std::vector<std::string>& vec) {
-    const char** result = static_cast<const char**>(malloc((vec.size() + 1) * sizeof(char*)));
+    const char** result = static_cast<const char**>(lgx_alloc((vec.size() + 1) * sizeof(char*)));
     if (!result) return nullptr;
     
     for (size_t i = 0; i < vec.size(); ++i) {
@@ -49,9 +75,9 @@ static const char** vector_to_array(const std::vector<std::string>& vec) {
         if (!result[i]) {
             // Cleanup on allocation failure
             for (size_t j = 0; j < i; ++j) {
-                free(const_cast<char*>(result[j]));
+                lgx_release(result[j]);
             }
-            free(result);
+            lgx_release(result);
             return nullptr;
         }
     }
@@ -65,16 +91,83 @@ static const char** set_to_array(const std::set<std::string>& s) {
     return vector_to_array(vec);
 }
 
-/* Package wrapper struct */
+/* ByteSink that grows a hook-allocated buffer which is handed to the caller as-is */
+class MallocByteSink : public lgx::ByteSink {
+public:
+    ~MallocByteSink() override { lgx_release(data_); }
+
+    bool write(const uint8_t* data, size_t size) override {
+        if (size > capacity_ - size_) {
+            size_t capacity = std::max(capacity_ * 2, size_ + size);
+            capacity = std::max<size_t>(capacity, 64 * 1024);
+            void* grown = lgx::Memory::reallocate(data_, capacity);
+            if (!grown) return false;
+            data_ = static_cast<uint8_t*>(grown);
+            capacity_ = capacity;
+        }
+        std::memcpy(data_ + size_, data, size);
+        size_ += size;
+        return true;
+    }
+
+    /* Transfer ownership of the buffer (never NULL) to the caller */
+    void* release(size_t* size) {
+        if (!data_) data_ = static_cast<uint8_t*>(lgx_alloc(1));
+        void* result = data_;
+        *size = size_;
+        data_ = nullptr;
+        size_ = capacity_ = 0;
+        return result;
+    }
+
+private:
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+/*
+ * Package wrapper struct.
+ *
+ * Read-only calls never write to the handle: the metadata strings are
+ * computed whenever the package is loaded or modified, so getters only read.
+ * The decoded package is shared (clones, running jobs) and treated as
+ * immutable while shared; mutating calls copy it first (copy-on-write).
+ */
 struct lgx_package_opaque {
-    std::unique_ptr<lgx::Package> pkg;
-    std::string name_cache;
-    std::string version_cache;
-    std::string description_cache;
-    std::string icon_cache;
-    std::string manifest_json_cache;
+    std::shared_ptr<lgx::Package> pkg;
+    std::string name;
+    std::string version;
+    std::string description;
+    std::string icon;
+    std::string manifest_json;
 };
 
+/* Recompute the metadata strings after the package changed */
+static void refresh_metadata(lgx_package_t pkg) {
+    const auto& manifest = pkg->pkg->getManifest();
+    pkg->name = manifest.name;
+    pkg->version = manifest.version;
+    pkg->description = manifest.description;
+    pkg->icon = manifest.icon;
+    pkg->manifest_json = manifest.toJson();
+}
+
+static lgx_package_t wrap_package(std::shared_ptr<lgx::Package> package) {
+    auto wrapper = new lgx_package_opaque();
+    wrapper->pkg = std::move(package);
+    refresh_metadata(wrapper);
+    return wrapper;
+}
+
+/* Exclusive access to the package for a mutating call, copying it if shared */
+static lgx::Package& mutable_package(lgx_package_t pkg) {
+    if (pkg->pkg.use_count() > 1) {
+        pkg->pkg = std::make_shared<lgx::Package>(*pkg->pkg);
+    }
+    return *pkg->pkg;
+}
+
 /* Package creation and loading */
 
 LGX_EXPORT lgx_result_t lgx_create(const char* output_path, const char* name) {
@@ -93,6 +186,27 @@ LGX_EXPORT lgx_result_t lgx_create(const char* output_path, const char* name) {
     return {true, nullptr};
 }
 
+LGX_EXPORT lgx_result_t lgx_build(const char* spec_path, const char* output_path) {
+    if (!spec_path) {
+        set_error("Invalid argument: spec_path cannot be NULL");
+        return {false, g_last_error.c_str()};
+    }
+
+    clear_error();
+    auto spec = lgx::BuildSpec::load(spec_path);
+    if (!spec) {
+        set_error(lgx::BuildSpec::getLastError());
+        return {false, g_last_error.c_str()};
+    }
+
+    auto result = spec->build(output_path ? std::filesystem::path(output_path) : spec->outputPath());
+    if (!result.success) {
+        set_error(result.error);
+        return {false, g_last_error.c_str()};
+    }
+    return {true, nullptr};
+}
+
 LGX_EXPORT lgx_package_t lgx_load(const char* path) {
     if (!path) {
         set_error("Invalid argument: path cannot be NULL");
@@ -100,16 +214,41 @@ LGX_EXPORT lgx_package_t lgx_load(const char* path) {
     }
     
     clear_error();
-    auto pkg_opt = lgx::Package::load(path);
+    auto package = lgx::PackageCache::shared().load(path);
     
-    if (!pkg_opt) {
+    if (!package) {
         set_error("Failed to load package: " + std::string(path));
         return nullptr;
     }
     
-    auto wrapper = new lgx_package_opaque();
-    wrapper->pkg = std::make_unique<lgx::Package>(std::move(*pkg_opt));
-    return wrapper;
+    return wrap_package(std::move(package));
+}
+
+LGX_EXPORT lgx_package_t lgx_load_from_memory(const void* data, size_t size) {
+    if (!data) {
+        set_error("Invalid argument: data cannot be NULL");
+        return nullptr;
+    }
+
+    clear_error();
+    auto pkg_opt = lgx::Package::loadFromMemory(data, size);
+
+    if (!pkg_opt) {
+        set_error("Failed to load package from memory: " + lgx::Package::getLastError());
+        return nullptr;
+    }
+
+    return wrap_package(std::make_shared<lgx::Package>(std::move(*pkg_opt)));
+}
+
+LGX_EXPORT lgx_package_t lgx_package_clone(lgx_package_t pkg) {
+    if (!pkg) {
+        set_error("Invalid argument: pkg cannot be NULL");
+        return nullptr;
+    }
+
+    clear_error();
+    return new lgx_package_opaque(*pkg);
 }
 
 LGX_EXPORT lgx_result_t lgx_save(lgx_package_t pkg, const char* path) {
@@ -128,6 +267,47 @@ LGX_EXPORT lgx_result_t lgx_save(lgx_package_t pkg, const char* path) {
     return {true, nullptr};
 }
 
+LGX_EXPORT lgx_result_t lgx_save_to_buffer(lgx_package_t pkg, void** out_data, size_t* out_size) {
+    if (!pkg || !out_data || !out_size) {
+        set_error("Invalid arguments: pkg, out_data and out_size cannot be NULL");
+        return {false, g_last_error.c_str()};
+    }
+
+    clear_error();
+    *out_data = nullptr;
+    *out_size = 0;
+
+    MallocByteSink sink;
+    auto result = pkg->pkg->save(sink);
+
+    if (!result.success) {
+        set_error(result.error);
+        return {false, g_last_error.c_str()};
+    }
+
+    *out_data = sink.release(out_size);
+    return {true, nullptr};
+}
+
+LGX_EXPORT lgx_result_t lgx_save_to_callback(lgx_package_t pkg, lgx_write_fn write, void* user_data) {
+    if (!pkg || !write) {
+        set_error("Invalid arguments: pkg and write cannot be NULL");
+        return {false, g_last_error.c_str()};
+    }
+
+    clear_error();
+    lgx::CallbackByteSink sink([write, user_data](const uint8_t* data, size_t size) {
+        return write(data, size, user_data);
+    });
+    auto result = pkg->pkg->save(sink);
+
+    if (!result.success) {
+        set_error(result.error);
+        return {false, g_last_error.c_str()};
+    }
+    return {true, nullptr};
+}
+
 LGX_EXPORT lgx_verify_result_t lgx_verify(const char* path) {
     if (!path) {
         set_error("Invalid argument: path cannot be NULL");
@@ -135,7 +315,14 @@ LGX_EXPORT lgx_verify_result_t lgx_verify(const char* path) {
     }
     
     clear_error();
-    auto result = lgx::Package::verify(path);
+    lgx::Package::VerifyResult result;
+    auto package = lgx::PackageCache::shared().load(path);
+    if (package) {
+        result = package->validatePackage();
+    } else {
+        result.valid = false;
+        result.errors.push_back(lgx::PackageCache::getLastError());
+    }
     
     lgx_verify_result_t c_result;
     c_result.valid = result.valid;
@@ -160,7 +347,8 @@ LGX_EXPORT lgx_result_t lgx_add_variant(
     
     clear_error();
     std::optional<std::string> main_opt = main_path ? std::optional<std::string>(main_path) : std::nullopt;
-    auto result = pkg->pkg->addVariant(variant, files_path, main_opt);
+    auto result = mutable_package(pkg).addVariant(variant, files_path, main_opt);
+    refresh_metadata(pkg);
     
     if (!result.success) {
         set_error(result.error);
@@ -176,7 +364,8 @@ LGX_EXPORT lgx_result_t lgx_remove_variant(lgx_package_t pkg, const char* varian
     }
     
     clear_error();
-    auto result = pkg->pkg->removeVariant(variant);
+    auto result = mutable_package(pkg).removeVariant(variant);
+    refresh_metadata(pkg);
     
     if (!result.success) {
         set_error(result.error);
@@ -237,8 +426,7 @@ LGX_EXPORT const char* lgx_get_name(lgx_package_t pkg) {
     }
     
     clear_error();
-    pkg->name_cache = pkg->pkg->getManifest().name;
-    return pkg->name_cache.c_str();
+    return pkg->name.c_str();
 }
 
 LGX_EXPORT const char* lgx_get_version(lgx_package_t pkg) {
@@ -248,8 +436,7 @@ LGX_EXPORT const char* lgx_get_version(lgx_package_t pkg) {
     }
     
     clear_error();
-    pkg->version_cache = pkg->pkg->getManifest().version;
-    return pkg->version_cache.c_str();
+    return pkg->version.c_str();
 }
 
 LGX_EXPORT lgx_result_t lgx_set_version(lgx_package_t pkg, const char* version) {
@@ -259,7 +446,8 @@ LGX_EXPORT lgx_result_t lgx_set_version(lgx_package_t pkg, const char* version)
     }
     
     clear_error();
-    pkg->pkg->getManifest().version = version;
+    mutable_package(pkg).getManifest().version = version;
+    refresh_metadata(pkg);
     return {true, nullptr};
 }
 
@@ -270,8 +458,7 @@ LGX_EXPORT const char* lgx_get_description(lgx_package_t pkg) {
     }
     
     clear_error();
-    pkg->description_cache = pkg->pkg->getManifest().description;
-    return pkg->description_cache.c_str();
+    return pkg->description.c_str();
 }
 
 LGX_EXPORT void lgx_set_description(lgx_package_t pkg, const char* description) {
@@ -281,7 +468,8 @@ LGX_EXPORT void lgx_set_description(lgx_package_t pkg, const char* description)
     }
     
     clear_error();
-    pkg->pkg->getManifest().description = description;
+    mutable_package(pkg).getManifest().description = description;
+    refresh_metadata(pkg);
 }
 
 LGX_EXPORT const char* lgx_get_icon(lgx_package_t pkg) {
@@ -291,8 +479,7 @@ LGX_EXPORT const char* lgx_get_icon(lgx_package_t pkg) {
     }
 
     clear_error();
-    pkg->icon_cache = pkg->pkg->getManifest().icon;
-    return pkg->icon_cache.c_str();
+    return pkg->icon.c_str();
 }
 
 LGX_EXPORT void lgx_set_icon(lgx_package_t pkg, const char* icon) {
@@ -302,7 +489,8 @@ LGX_EXPORT void lgx_set_icon(lgx_package_t pkg, const char* icon) {
     }
 
     clear_error();
-    pkg->pkg->getManifest().icon = icon;
+    mutable_package(pkg).getManifest().icon = icon;
+    refresh_metadata(pkg);
 }
 
 LGX_EXPORT const char* lgx_get_manifest_json(lgx_package_t pkg) {
@@ -312,8 +500,7 @@ LGX_EXPORT const char* lgx_get_manifest_json(lgx_package_t pkg) {
     }
 
     clear_error();
-    pkg->manifest_json_cache = pkg->pkg->getManifest().toJson();
-    return pkg->manifest_json_cache.c_str();
+    return pkg->manifest_json.c_str();
 }
 
 /* Signature functions */
@@ -334,14 +521,14 @@ LGX_EXPORT lgx_signature_info_t lgx_verify_signature(
         return info;
     }
 
-    auto pkg_opt = lgx::Package::load(lgx_path);
-    if (!pkg_opt) {
+    auto package = lgx::PackageCache::shared().load(lgx_path);
+    if (!package) {
         set_error("Failed to load package: " + std::string(lgx_path));
         info.error = strdup_cpp(g_last_error);
         return info;
     }
 
-    auto sigInfo = pkg_opt->verifySignature();
+    auto sigInfo = package->verifySignature();
     info.is_signed = sigInfo.is_signed;
     info.signature_valid = sigInfo.signature_valid;
     info.package_valid = sigInfo.package_valid;
@@ -372,11 +559,46 @@ LGX_EXPORT lgx_signature_info_t lgx_verify_signature(
 }
 
 LGX_EXPORT void lgx_free_signature_info(lgx_signature_info_t info) {
-    if (info.signer_did) free(const_cast<char*>(info.signer_did));
-    if (info.signer_name) free(const_cast<char*>(info.signer_name));
-    if (info.signer_url) free(const_cast<char*>(info.signer_url));
-    if (info.trusted_as) free(const_cast<char*>(info.trusted_as));
-    if (info.error) free(const_cast<char*>(info.error));
+    if (info.signer_did) lgx_release(info.signer_did);
+    if (info.signer_name) lgx_release(info.signer_name);
+    if (info.signer_url) lgx_release(info.signer_url);
+    if (info.trusted_as) lgx_release(info.trusted_as);
+    if (info.error) lgx_release(info.error);
+}
+
+LGX_EXPORT lgx_result_t lgx_verify_signatures(
+    const lgx_signature_item_t* items, size_t count, bool* out_valid) {
+    if (count > 0 && (!items || !out_valid)) {
+        set_error("Invalid arguments: items and out_valid cannot be NULL");
+        return {false, g_last_error.c_str()};
+    }
+
+    std::vector<lgx::crypto::VerifyItem> batch(count);
+    for (size_t i = 0; i < count; ++i) {
+        const lgx_signature_item_t& item = items[i];
+        if (!item.public_key || !item.signature || (!item.message && item.message_len > 0)) {
+            set_error("Invalid arguments: item " + std::to_string(i) + " has a NULL field");
+            return {false, g_last_error.c_str()};
+        }
+        batch[i].message = item.message;
+        batch[i].messageLen = item.message_len;
+        std::copy(item.public_key, item.public_key + lgx::crypto::PUBLIC_KEY_SIZE,
+                  batch[i].publicKey.begin());
+        std::copy(item.signature, item.signature + lgx::crypto::SIGNATURE_SIZE,
+                  batch[i].signature.begin());
+    }
+
+    if (count > 0 && !lgx::crypto::init()) {
+        set_error("Failed to initialize crypto library");
+        return {false, g_last_error.c_str()};
+    }
+
+    clear_error();
+    auto valid = lgx::crypto::verifyBatch(batch);
+    for (size_t i = 0; i < count; ++i) {
+        out_valid[i] = valid[i];
+    }
+    return {true, nullptr};
 }
 
 LGX_EXPORT lgx_result_t lgx_sign(
@@ -553,10 +775,11 @@ LGX_EXPORT lgx_keyring_list_t lgx_keyring_list(const char* keyring_dir) {
     }
 
     result.keys = static_cast<lgx_trusted_key_t*>(
-        calloc(keys.size(), sizeof(lgx_trusted_key_t)));
+        lgx_alloc(keys.size() * sizeof(lgx_trusted_key_t)));
     if (!result.keys) {
         return result;
     }
+    std::memset(result.keys, 0, keys.size() * sizeof(lgx_trusted_key_t));
     result.count = keys.size();
 
     for (size_t i = 0; i < keys.size(); ++i) {
@@ -576,17 +799,624 @@ LGX_EXPORT lgx_keyring_list_t lgx_keyring_list(const char* keyring_dir) {
 LGX_EXPORT void lgx_free_keyring_list(lgx_keyring_list_t list) {
     if (!list.keys) return;
     for (size_t i = 0; i < list.count; ++i) {
-        free(const_cast<char*>(list.keys[i].name));
-        free(const_cast<char*>(list.keys[i].did));
-        if (list.keys[i].display_name) free(const_cast<char*>(list.keys[i].display_name));
-        if (list.keys[i].url) free(const_cast<char*>(list.keys[i].url));
-        if (list.keys[i].added_at) free(const_cast<char*>(list.keys[i].added_at));
+        lgx_release(list.keys[i].name);
+        lgx_release(list.keys[i].did);
+        if (list.keys[i].display_name) lgx_release(list.keys[i].display_name);
+        if (list.keys[i].url) lgx_release(list.keys[i].url);
+        if (list.keys[i].added_at) lgx_release(list.keys[i].added_at);
+    }
+    lgx_release(list.keys);
+}
+
+/* Asynchronous jobs */
+
+struct lgx_job_opaque {
+    lgx::Progress::Context progress;
+    lgx_job_callbacks_t callbacks{};
+    std::chrono::steady_clock::time_point last_report{};
+
+    /* Written by the worker before results_ready is set */
+    lgx_job_status_t final_status = LGX_JOB_RUNNING;
+    std::string error;
+    std::shared_ptr<lgx::Package> package;
+    std::optional<lgx_verify_result_t> verify_result;
+    std::optional<lgx_signature_info_t> signature_info;
+
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    bool results_ready = false;               /* guarded by mutex */
+    lgx_job_status_t status = LGX_JOB_RUNNING; /* guarded by mutex */
+
+    /* One reference for the caller's handle, one for the worker */
+    std::atomic<int> refs{2};
+};
+
+static lgx_job_progress_t job_progress_snapshot(lgx_job_t job) {
+    lgx_job_progress_t progress;
+    progress.bytes_processed = job->progress.bytesProcessed.load(std::memory_order_relaxed);
+    progress.bytes_total = job->progress.bytesTotal.load(std::memory_order_relaxed);
+    progress.entries_processed = job->progress.entriesProcessed.load(std::memory_order_relaxed);
+    return progress;
+}
+
+/* Forward progress to the caller, throttled so tight loops stay cheap */
+static void report_job_progress(lgx_job_t job, bool force) {
+    auto now = std::chrono::steady_clock::now();
+    if (!force && now - job->last_report < std::chrono::milliseconds(50)) {
+        return;
+    }
+    job->last_report = now;
+    job->callbacks.on_progress(job, job_progress_snapshot(job), job->callbacks.user_data);
+}
+
+static void release_job(lgx_job_t job) {
+    if (job->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    if (job->verify_result) lgx_free_verify_result(*job->verify_result);
+    if (job->signature_info) lgx_free_signature_info(*job->signature_info);
+    delete job;
+}
+
+/* Record the outcome of a job; a failure after lgx_job_cancel() counts as cancelled */
+static void finish_job(lgx_job_t job, bool success, const std::string& error) {
+    if (success) {
+        job->final_status = LGX_JOB_SUCCEEDED;
+    } else if (job->progress.cancelled.load(std::memory_order_relaxed)) {
+        job->final_status = LGX_JOB_CANCELLED;
+        job->error = lgx::Progress::CANCELLED_ERROR;
+    } else {
+        job->final_status = LGX_JOB_FAILED;
+        job->error = error;
+    }
+}
+
+static lgx_job_t start_job(const lgx_job_callbacks_t* callbacks, std::function<void(lgx_job_t)> work) {
+    auto job = new lgx_job_opaque();
+    if (callbacks) {
+        job->callbacks = *callbacks;
+    }
+    if (job->callbacks.on_progress) {
+        job->progress.onUpdate = [job] { report_job_progress(job, false); };
+    }
+
+    lgx::WorkerPool::shared().submit([job, work = std::move(work)] {
+        if (job->progress.cancelled.load(std::memory_order_relaxed)) {
+            finish_job(job, false, "");
+        } else {
+            lgx::Progress::Scope scope(&job->progress);
+            work(job);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            job->results_ready = true;
+        }
+        if (job->callbacks.on_progress) {
+            report_job_progress(job, true);
+        }
+
+        // Hold our reference across on_complete so it may free the handle
+        if (job->callbacks.on_complete) {
+            job->callbacks.on_complete(job, job->final_status, job->callbacks.user_data);
+        }
+        {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            job->status = job->final_status;
+        }
+        job->done_cv.notify_all();
+        release_job(job);
+    });
+
+    return job;
+}
+
+LGX_EXPORT lgx_job_t lgx_job_start_load(const char* path, const lgx_job_callbacks_t* callbacks) {
+    if (!path) {
+        set_error("Invalid argument: path cannot be NULL");
+        return nullptr;
+    }
+    clear_error();
+
+    return start_job(callbacks, [path = std::string(path)](lgx_job_t job) {
+        job->package = lgx::PackageCache::shared().load(path);
+        finish_job(job, job->package != nullptr,
+                   "Failed to load package: " + lgx::PackageCache::getLastError());
+    });
+}
+
+LGX_EXPORT lgx_job_t lgx_job_start_verify(const char* path, const lgx_job_callbacks_t* callbacks) {
+    if (!path) {
+        set_error("Invalid argument: path cannot be NULL");
+        return nullptr;
+    }
+    clear_error();
+
+    return start_job(callbacks, [path = std::string(path)](lgx_job_t job) {
+        lgx_verify_result_t result = lgx_verify(path.c_str());
+        if (job->progress.cancelled.load(std::memory_order_relaxed)) {
+            lgx_free_verify_result(result);
+            finish_job(job, false, "");
+            return;
+        }
+        job->verify_result = result;
+        finish_job(job, true, "");
+    });
+}
+
+LGX_EXPORT lgx_job_t lgx_job_start_verify_signature(
+    const char* lgx_path, const char* keyring_dir, const lgx_job_callbacks_t* callbacks) {
+    if (!lgx_path) {
+        set_error("Invalid argument: lgx_path cannot be NULL");
+        return nullptr;
+    }
+    clear_error();
+
+    std::optional<std::string> keyring = keyring_dir ? std::optional<std::string>(keyring_dir) : std::nullopt;
+    return start_job(callbacks, [path = std::string(lgx_path), keyring](lgx_job_t job) {
+        lgx_signature_info_t info = lgx_verify_signature(
+            path.c_str(), keyring ? keyring->c_str() : nullptr);
+        if (job->progress.cancelled.load(std::memory_order_relaxed)) {
+            lgx_free_signature_info(info);
+            finish_job(job, false, "");
+            return;
+        }
+        job->signature_info = info;
+        finish_job(job, true, "");
+    });
+}
+
+LGX_EXPORT lgx_job_t lgx_job_start_extract(
+    lgx_package_t pkg, const char* variant, const char* output_dir,
+    const lgx_job_callbacks_t* callbacks) {
+    if (!pkg || !output_dir) {
+        set_error("Invalid arguments: pkg and output_dir cannot be NULL");
+        return nullptr;
+    }
+    clear_error();
+
+    // Share the decoded package; later mutations of pkg copy it first
+    std::shared_ptr<const lgx::Package> snapshot = pkg->pkg;
+    std::optional<std::string> variant_opt = variant ? std::optional<std::string>(variant) : std::nullopt;
+    return start_job(callbacks,
+        [snapshot, variant_opt, output = std::string(output_dir)](lgx_job_t job) {
+            auto result = variant_opt ? snapshot->extractVariant(*variant_opt, output)
+                                      : snapshot->extractAll(output);
+            finish_job(job, result.success, result.error);
+        });
+}
+
+LGX_EXPORT lgx_job_status_t lgx_job_get_status(lgx_job_t job) {
+    if (!job) {
+        set_error("Invalid argument: job cannot be NULL");
+        return LGX_JOB_FAILED;
+    }
+    std::lock_guard<std::mutex> lock(job->mutex);
+    return job->status;
+}
+
+LGX_EXPORT lgx_job_progress_t lgx_job_get_progress(lgx_job_t job) {
+    if (!job) {
+        set_error("Invalid argument: job cannot be NULL");
+        return {0, 0, 0};
+    }
+    return job_progress_snapshot(job);
+}
+
+LGX_EXPORT void lgx_job_cancel(lgx_job_t job) {
+    if (!job) return;
+    job->progress.cancelled.store(true, std::memory_order_relaxed);
+}
+
+LGX_EXPORT lgx_job_status_t lgx_job_wait(lgx_job_t job) {
+    if (!job) {
+        set_error("Invalid argument: job cannot be NULL");
+        return LGX_JOB_FAILED;
+    }
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->done_cv.wait(lock, [job] { return job->status != LGX_JOB_RUNNING; });
+    return job->status;
+}
+
+LGX_EXPORT const char* lgx_job_get_error(lgx_job_t job) {
+    if (!job) return nullptr;
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (!job->results_ready || job->error.empty()) {
+        return nullptr;
+    }
+    return job->error.c_str();
+}
+
+LGX_EXPORT lgx_package_t lgx_job_take_package(lgx_job_t job) {
+    if (!job) {
+        set_error("Invalid argument: job cannot be NULL");
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (!job->results_ready || !job->package) {
+        set_error("No package available from job");
+        return nullptr;
+    }
+    return wrap_package(std::move(job->package));
+}
+
+LGX_EXPORT bool lgx_job_take_verify_result(lgx_job_t job, lgx_verify_result_t* out_result) {
+    if (!job || !out_result) {
+        set_error("Invalid arguments: job and out_result cannot be NULL");
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (!job->results_ready || !job->verify_result) {
+        set_error("No verify result available from job");
+        return false;
+    }
+    *out_result = *job->verify_result;
+    job->verify_result.reset();
+    return true;
+}
+
+LGX_EXPORT bool lgx_job_take_signature_info(lgx_job_t job, lgx_signature_info_t* out_info) {
+    if (!job || !out_info) {
+        set_error("Invalid arguments: job and out_info cannot be NULL");
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (!job->results_ready || !job->signature_info) {
+        set_error("No signature info available from job");
+        return false;
+    }
+    *out_info = *job->signature_info;
+    job->signature_info.reset();
+    return true;
+}
+
+LGX_EXPORT void lgx_job_free(lgx_job_t job) {
+    if (!job) return;
+    lgx_job_cancel(job);
+    release_job(job);
+}
+
+/* Decoded-package cache */
+
+LGX_EXPORT void lgx_cache_set_budget(size_t max_bytes) {
+    lgx::PackageCache::shared().setBudget(max_bytes);
+}
+
+LGX_EXPORT size_t lgx_cache_get_budget(void) {
+    return lgx::PackageCache::shared().getBudget();
+}
+
+LGX_EXPORT void lgx_cache_clear(void) {
+    lgx::PackageCache::shared().clear();
+}
+
+LGX_EXPORT lgx_cache_stats_t lgx_cache_get_stats(void) {
+    auto stats = lgx::PackageCache::shared().getStats();
+    lgx_cache_stats_t c_stats;
+    c_stats.hits = stats.hits;
+    c_stats.misses = stats.misses;
+    c_stats.evictions = stats.evictions;
+    c_stats.entries = stats.entries;
+    c_stats.bytes = stats.bytes;
+    c_stats.budget = stats.budget;
+    return c_stats;
+}
+
+LGX_EXPORT void lgx_cache_reset_stats(void) {
+    lgx::PackageCache::shared().resetStats();
+}
+
+/* Package catalog */
+
+struct lgx_catalog_opaque {
+    explicit lgx_catalog_opaque(lgx::Catalog c) : catalog(std::move(c)) {}
+
+    lgx::Catalog catalog;
+    std::once_flag resolverOnce;  // the resolver index is built on first use
+    lgx::Resolver resolver;
+};
+
+LGX_EXPORT lgx_result_t lgx_catalog_update(
+    const char* dir, const char* index_path, bool rebuild,
+    lgx_catalog_update_stats_t* out_stats) {
+    if (!dir) {
+        set_error("Invalid argument: dir cannot be NULL");
+        return {false, g_last_error.c_str()};
+    }
+
+    clear_error();
+    auto result = lgx::Catalog::update(dir, index_path ? index_path : "", rebuild);
+    if (!result.success) {
+        set_error(result.error);
+        return {false, g_last_error.c_str()};
+    }
+    if (out_stats) {
+        out_stats->scanned = result.scanned;
+        out_stats->parsed = result.parsed;
+        out_stats->unchanged = result.unchanged;
+        out_stats->removed = result.removed;
+        out_stats->failed = result.failed;
+    }
+    return {true, nullptr};
+}
+
+LGX_EXPORT lgx_catalog_t lgx_catalog_open(const char* dir, const char* index_path) {
+    if (!dir) {
+        set_error("Invalid argument: dir cannot be NULL");
+        return nullptr;
+    }
+
+    clear_error();
+    auto catalog = lgx::Catalog::open(dir, index_path ? index_path : "");
+    if (!catalog) {
+        set_error(lgx::Catalog::getLastError());
+        return nullptr;
+    }
+    return new lgx_catalog_opaque(std::move(*catalog));
+}
+
+LGX_EXPORT lgx_result_t lgx_catalog_find(
+    lgx_catalog_t catalog, const char* name, const char* version_range,
+    const char* signer, lgx_catalog_list_t* out_list) {
+    if (!catalog || !out_list) {
+        set_error("Invalid arguments: catalog and out_list cannot be NULL");
+        return {false, g_last_error.c_str()};
+    }
+    *out_list = {};
+
+    clear_error();
+    lgx::Catalog::Query query;
+    query.name = name ? name : "";
+    query.versionRange = version_range ? version_range : "";
+    query.signer = signer ? signer : "";
+    auto matches = catalog->catalog.find(query);
+    if (!matches) {
+        set_error(lgx::Catalog::getLastError());
+        return {false, g_last_error.c_str()};
+    }
+    if (matches->empty()) {
+        return {true, nullptr};
+    }
+
+    out_list->entries = static_cast<lgx_catalog_entry_t*>(
+        lgx_alloc(matches->size() * sizeof(lgx_catalog_entry_t)));
+    if (!out_list->entries) {
+        set_error("Out of memory");
+        return {false, g_last_error.c_str()};
+    }
+    std::memset(out_list->entries, 0, matches->size() * sizeof(lgx_catalog_entry_t));
+    out_list->count = matches->size();
+
+    for (size_t i = 0; i < matches->size(); ++i) {
+        const auto& entry = *(*matches)[i];
+        auto& out = out_list->entries[i];
+        out.path = strdup_cpp(catalog->catalog.packagePath(entry).string());
+        out.name = strdup_cpp(entry.name);
+        out.version = strdup_cpp(entry.version);
+        out.type = entry.type.empty() ? nullptr : strdup_cpp(entry.type);
+        out.signer = entry.signer.empty() ? nullptr : strdup_cpp(entry.signer);
+        out.root_hash = entry.rootHash.empty() ? nullptr : strdup_cpp(entry.rootHash);
+        std::vector<std::string> deps;
+        for (const auto& dep : entry.dependencies) {
+            deps.push_back(dep.toString());
+        }
+        out.dependencies = vector_to_array(deps);
+    }
+    return {true, nullptr};
+}
+
+LGX_EXPORT void lgx_free_catalog_list(lgx_catalog_list_t list) {
+    if (!list.entries) return;
+    for (size_t i = 0; i < list.count; ++i) {
+        const auto& entry = list.entries[i];
+        lgx_release(entry.path);
+        lgx_release(entry.name);
+        lgx_release(entry.version);
+        if (entry.type) lgx_release(entry.type);
+        if (entry.signer) lgx_release(entry.signer);
+        if (entry.root_hash) lgx_release(entry.root_hash);
+        if (entry.dependencies) lgx_free_string_array(entry.dependencies);
+    }
+    lgx_release(list.entries);
+}
+
+LGX_EXPORT void lgx_catalog_free(lgx_catalog_t catalog) {
+    delete catalog;
+}
+
+/* Dependency resolution */
+
+LGX_EXPORT lgx_result_t lgx_resolve(
+    lgx_catalog_t catalog, const lgx_requirement_t* requirements, size_t count,
+    lgx_resolution_t* out) {
+    if (!catalog || !out || (count > 0 && !requirements)) {
+        set_error("Invalid arguments: catalog, requirements and out cannot be NULL");
+        return {false, g_last_error.c_str()};
+    }
+    *out = {};
+
+    std::vector<lgx::Dependency> deps;
+    for (size_t i = 0; i < count; ++i) {
+        if (!requirements[i].name) {
+            set_error("Invalid argument: requirement name cannot be NULL");
+            return {false, g_last_error.c_str()};
+        }
+        lgx::Dependency dep(requirements[i].name);
+        if (requirements[i].version_range) dep.version = requirements[i].version_range;
+        if (requirements[i].signer) dep.signer = requirements[i].signer;
+        deps.push_back(std::move(dep));
+    }
+
+    clear_error();
+    std::call_once(catalog->resolverOnce, [catalog] {
+        catalog->resolver.addCatalog(catalog->catalog);
+    });
+    auto result = catalog->resolver.resolve(deps);
+    if (!result.success) {
+        set_error(result.error);
+        return {false, g_last_error.c_str()};
+    }
+    if (result.packages.empty()) {
+        return {true, nullptr};
+    }
+
+    out->packages = static_cast<lgx_resolved_package_t*>(
+        lgx_alloc(result.packages.size() * sizeof(lgx_resolved_package_t)));
+    if (!out->packages) {
+        set_error("Out of memory");
+        return {false, g_last_error.c_str()};
+    }
+    out->count = result.packages.size();
+    for (size_t i = 0; i < result.packages.size(); ++i) {
+        const auto& selection = result.packages[i];
+        auto& pkg = out->packages[i];
+        pkg.name = strdup_cpp(selection.name);
+        pkg.version = strdup_cpp(selection.version);
+        pkg.path = strdup_cpp(selection.source);
+        pkg.signer = selection.signer.empty() ? nullptr : strdup_cpp(selection.signer);
+    }
+    return {true, nullptr};
+}
+
+LGX_EXPORT void lgx_free_resolution(lgx_resolution_t resolution) {
+    if (!resolution.packages) return;
+    for (size_t i = 0; i < resolution.count; ++i) {
+        const auto& pkg = resolution.packages[i];
+        lgx_release(pkg.name);
+        lgx_release(pkg.version);
+        lgx_release(pkg.path);
+        if (pkg.signer) lgx_release(pkg.signer);
+    }
+    lgx_release(resolution.packages);
+}
+
+/* Lockfiles */
+
+LGX_EXPORT lgx_result_t lgx_lock_add(const char* lockfile_path, const char* lgx_path) {
+    if (!lockfile_path || !lgx_path) {
+        set_error("Invalid arguments: lockfile_path and lgx_path cannot be NULL");
+        return {false, g_last_error.c_str()};
+    }
+    if (!lgx::crypto::init()) {
+        set_error("Failed to initialize crypto library");
+        return {false, g_last_error.c_str()};
     }
-    free(list.keys);
+
+    clear_error();
+    std::filesystem::path lockPath(lockfile_path);
+    lgx::Lockfile lock;
+    if (std::filesystem::exists(lockPath)) {
+        auto existing = lgx::Lockfile::load(lockPath);
+        if (!existing) {
+            set_error(lgx::Lockfile::getLastError());
+            return {false, g_last_error.c_str()};
+        }
+        lock = std::move(*existing);
+    }
+
+    auto entry = lgx::Lockfile::describe(lgx_path, lockPath.parent_path());
+    if (!entry) {
+        set_error(lgx::Lockfile::getLastError());
+        return {false, g_last_error.c_str()};
+    }
+    lock.set(std::move(*entry));
+    if (!lock.save(lockPath)) {
+        set_error(lgx::Lockfile::getLastError());
+        return {false, g_last_error.c_str()};
+    }
+    return {true, nullptr};
+}
+
+LGX_EXPORT lgx_lock_status_t lgx_lock_check(const char* lockfile_path, const char* lgx_path) {
+    if (!lockfile_path || !lgx_path) {
+        set_error("Invalid arguments: lockfile_path and lgx_path cannot be NULL");
+        return LGX_LOCK_ERROR;
+    }
+
+    clear_error();
+    auto lock = lgx::Lockfile::load(lockfile_path);
+    if (!lock) {
+        set_error(lgx::Lockfile::getLastError());
+        return LGX_LOCK_ERROR;
+    }
+    auto check = lock->check(lgx_path, std::filesystem::path(lockfile_path).parent_path());
+    switch (check.status) {
+        case lgx::Lockfile::Status::Match:
+            return LGX_LOCK_MATCH;
+        case lgx::Lockfile::Status::Mismatch:
+            set_error(check.entry->name + ": " + check.error);
+            return LGX_LOCK_MISMATCH;
+        case lgx::Lockfile::Status::NotLocked:
+            return LGX_LOCK_NOT_LOCKED;
+        case lgx::Lockfile::Status::Error:
+            break;
+    }
+    set_error(check.error);
+    return LGX_LOCK_ERROR;
+}
+
+/* Operation statistics */
+
+static lgx_phase_stats_t to_c_phase(const lgx::Stats::Snapshot& snapshot, lgx::Stats::Phase phase) {
+    const auto& stats = snapshot[phase];
+    lgx_phase_stats_t result;
+    result.calls = stats.calls;
+    result.bytes_in = stats.bytesIn;
+    result.bytes_out = stats.bytesOut;
+    result.entries = stats.entries;
+    result.syscalls = stats.syscalls;
+    result.wall_ns = stats.wallNs;
+    result.cpu_ns = stats.cpuNs;
+    return result;
+}
+
+LGX_EXPORT void lgx_stats_enable(bool enabled) {
+    lgx::Stats::setEnabled(enabled);
+}
+
+LGX_EXPORT lgx_stats_t lgx_get_stats(void) {
+    using Phase = lgx::Stats::Phase;
+    auto snapshot = lgx::Stats::snapshot();
+
+    lgx_stats_t result;
+    result.file_read = to_c_phase(snapshot, Phase::FileRead);
+    result.inflate = to_c_phase(snapshot, Phase::Inflate);
+    result.tar_parse = to_c_phase(snapshot, Phase::TarParse);
+    result.tar_write = to_c_phase(snapshot, Phase::TarWrite);
+    result.deflate = to_c_phase(snapshot, Phase::Deflate);
+    result.file_write = to_c_phase(snapshot, Phase::FileWrite);
+    result.normalize = to_c_phase(snapshot, Phase::Normalize);
+    result.hash = to_c_phase(snapshot, Phase::Hash);
+    result.extract = to_c_phase(snapshot, Phase::Extract);
+    result.peak_buffer_bytes = snapshot.peakBufferBytes;
+    return result;
+}
+
+LGX_EXPORT void lgx_stats_reset(void) {
+    lgx::Stats::reset();
 }
 
 /* Memory management */
 
+LGX_EXPORT bool lgx_set_allocator(const lgx_allocator_t* allocator) {
+    clear_error();
+    if (!allocator) {
+        return lgx::Memory::setHooks(nullptr);
+    }
+
+    lgx::Memory::Hooks hooks = {
+        allocator->malloc_fn,
+        allocator->realloc_fn,
+        allocator->free_fn,
+        allocator->user_data
+    };
+    if (!lgx::Memory::setHooks(&hooks)) {
+        set_error("Allocator must provide malloc_fn, realloc_fn and free_fn");
+        return false;
+    }
+    return true;
+}
+
 LGX_EXPORT void lgx_free_package(lgx_package_t pkg) {
     if (pkg) {
         delete pkg;
@@ -597,9 +1427,13 @@ LGX_EXPORT void lgx_free_string_array(const char** array) {
     if (!array) return;
     
     for (size_t i = 0; array[i] != nullptr; ++i) {
-        free(const_cast<char*>(array[i]));
+        lgx_release(array[i]);
     }
-    free(array);
+    lgx_release(array);
+}
+
+LGX_EXPORT void lgx_free_buffer(void* data) {
+    lgx_release(data);
 }
 
 LGX_EXPORT void lgx_free_verify_result(lgx_verify_result_t result) {
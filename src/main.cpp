@@ -11,6 +11,16 @@
 #include "commands/keyring_command.h"
 #include "commands/manifest_command.h"
 #include "commands/signature_command.h"
+#include "commands/serve_command.h"
+#include "commands/bench_command.h"
+#include "commands/catalog_command.h"
+#include "commands/resolve_command.h"
+#include "commands/lock_command.h"
+#include "commands/build_command.h"
+#include "commands/check_installed_command.h"
+#include "commands/stats_command.h"
+#include "core/stats.h"
+#include "core/trace.h"
 
 #include <iostream>
 #include <memory>
@@ -33,10 +43,13 @@ void printUsage(const std::map<std::string, std::unique_ptr<lgx::Command>>& comm
     
     for (const auto& [name, cmd] : commands) {
         std::cout << "  " << name;
-        // Pad to 12 characters
+        // Pad to 12 characters, keeping longer names apart from the text
         for (size_t i = name.length(); i < 12; ++i) {
             std::cout << ' ';
         }
+        if (name.length() >= 12) {
+            std::cout << ' ';
+        }
         std::cout << cmd->description() << "\n";
     }
     
@@ -44,6 +57,10 @@ void printUsage(const std::map<std::string, std::unique_ptr<lgx::Command>>& comm
               << "Options:\n"
               << "  --help, -h     Show help for a command\n"
               << "  --version, -V  Show version information\n"
+              << "  --stats[=json] Print per-phase timings and counters to stderr\n"
+              << "                 after any command\n"
+              << "  --trace <file> Write a Chrome Trace Event timeline of the command\n"
+              << "                 (open in Perfetto or chrome://tracing)\n"
               << "\n"
               << "Examples:\n"
               << "  lgx create mymodule\n"
@@ -74,11 +91,38 @@ int main(int argc, char* argv[]) {
     commands["keyring"] = std::make_unique<lgx::KeyringCommand>();
     commands["manifest"] = std::make_unique<lgx::ManifestCommand>();
     commands["signature"] = std::make_unique<lgx::SignatureCommand>();
+    commands["serve"] = std::make_unique<lgx::ServeCommand>();
+    commands["bench"] = std::make_unique<lgx::BenchCommand>();
+    commands["catalog"] = std::make_unique<lgx::CatalogCommand>();
+    commands["resolve"] = std::make_unique<lgx::ResolveCommand>();
+    commands["lock"] = std::make_unique<lgx::LockCommand>();
+    commands["build"] = std::make_unique<lgx::BuildCommand>();
+    commands["check-installed"] = std::make_unique<lgx::CheckInstalledCommand>();
+    commands["stats"] = std::make_unique<lgx::StatsCommand>();
     
-    // Parse arguments
+    // Parse arguments. --stats and --trace are accepted anywhere on the
+    // command line and by every command, so they are removed here rather
+    // than handled by each command's parser.
     std::vector<std::string> args;
+    std::string statsFormat;
+    std::string tracePath;
     for (int i = 1; i < argc; ++i) {
-        args.push_back(argv[i]);
+        std::string arg = argv[i];
+        if (arg == "--stats" || arg == "--stats=text") {
+            statsFormat = "text";
+        } else if (arg == "--stats=json") {
+            statsFormat = "json";
+        } else if (arg == "--trace") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --trace requires a file path\n";
+                return 1;
+            }
+            tracePath = argv[++i];
+        } else if (arg.rfind("--trace=", 0) == 0) {
+            tracePath = arg.substr(8);
+        } else {
+            args.push_back(arg);
+        }
     }
     
     // Handle no arguments
@@ -119,6 +163,32 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    if (!statsFormat.empty()) {
+        lgx::Stats::setEnabled(true);
+    }
+    if (!tracePath.empty()) {
+        lgx::Trace::setEnabled(true);
+    }
+
     // Execute command
-    return it->second->execute(cmdArgs);
+    int exitCode;
+    {
+        lgx::Trace::Span span("command", firstArg);
+        exitCode = it->second->execute(cmdArgs);
+    }
+
+    if (!tracePath.empty() && !lgx::Trace::writeJson(tracePath)) {
+        std::cerr << "Error: " << lgx::Trace::getLastError() << "\n";
+        if (exitCode == 0) {
+            exitCode = 1;
+        }
+    }
+
+    if (!statsFormat.empty()) {
+        auto snapshot = lgx::Stats::snapshot();
+        std::cerr << (statsFormat == "json" ? lgx::Stats::toJson(snapshot) + "\n"
+                                            : lgx::Stats::toText(snapshot));
+    }
+
+    return exitCode;
 }
@@ -0,0 +1,85 @@
+#include "client.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace lgx {
+namespace server {
+
+thread_local std::string Client::lastError_;
+
+Client::~Client() {
+#ifndef _WIN32
+    ::close(fd_);
+#endif
+}
+
+std::unique_ptr<Client> Client::connect(const std::string& socketPath) {
+#ifdef _WIN32
+    (void)socketPath;
+    lastError_ = "Unix domain sockets are not supported on Windows";
+    return nullptr;
+#else
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(addr.sun_path)) {
+        lastError_ = "Invalid socket path: " + socketPath;
+        return nullptr;
+    }
+    std::memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        lastError_ = std::string("Cannot create socket: ") + std::strerror(errno);
+        return nullptr;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        lastError_ = "Cannot connect to " + socketPath + ": " + std::strerror(errno);
+        ::close(fd);
+        return nullptr;
+    }
+    return std::unique_ptr<Client>(new Client(fd));
+#endif
+}
+
+std::unique_ptr<Client> Client::fromEnvironment() {
+    const char* socketPath = std::getenv(SOCKET_ENV);
+    if (!socketPath || !*socketPath) {
+        return nullptr;
+    }
+    return connect(socketPath);
+}
+
+std::optional<nlohmann::json> Client::request(const nlohmann::json& message) {
+    if (!channel_.writeLine(message.dump())) {
+        lastError_ = "Failed to send request to daemon";
+        return std::nullopt;
+    }
+
+    std::string line;
+    if (!channel_.readLine(line)) {
+        lastError_ = "Daemon closed the connection";
+        return std::nullopt;
+    }
+
+    auto response = nlohmann::json::parse(line, nullptr, false);
+    if (response.is_discarded() || !response.is_object()) {
+        lastError_ = "Malformed response from daemon";
+        return std::nullopt;
+    }
+    return response;
+}
+
+std::string Client::getLastError() {
+    return lastError_;
+}
+
+} // namespace server
+} // namespace lgx
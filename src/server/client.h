@@ -0,0 +1,63 @@
+#pragma once
+
+#include "protocol.h"
+
+#include <nlohmann/json.hpp>
+
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace lgx {
+namespace server {
+
+/**
+ * Client connects to a running `lgx serve` daemon and exchanges protocol
+ * messages with it (see protocol.h).
+ */
+class Client {
+public:
+    ~Client();
+
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    /**
+     * Connect to the daemon listening on `socketPath`.
+     *
+     * @return Connected client, or nullptr (see getLastError())
+     */
+    static std::unique_ptr<Client> connect(const std::string& socketPath);
+
+    /**
+     * Connect to the daemon named by $LGX_DAEMON_SOCKET.
+     *
+     * @return Connected client, or nullptr if the variable is unset or no
+     *         daemon is listening (callers then do the work locally)
+     */
+    static std::unique_ptr<Client> fromEnvironment();
+
+    /**
+     * Send a request and wait for its response.
+     *
+     * @return The response object (check its "ok" field), or nullopt if the
+     *         connection failed (see getLastError())
+     */
+    std::optional<nlohmann::json> request(const nlohmann::json& message);
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    explicit Client(int fd) : fd_(fd), channel_(fd) {}
+
+    int fd_;
+    Channel channel_;
+
+    static thread_local std::string lastError_;
+};
+
+} // namespace server
+} // namespace lgx
@@ -0,0 +1,118 @@
+#include "protocol.h"
+
+#include <cerrno>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace lgx {
+namespace server {
+
+#ifndef _WIN32
+
+bool Channel::readLine(std::string& line) {
+    size_t scanned = 0;
+    while (true) {
+        size_t newline = buffer_.find('\n', scanned);
+        if (newline != std::string::npos) {
+            line.assign(buffer_, 0, newline);
+            buffer_.erase(0, newline + 1);
+            return true;
+        }
+        if (buffer_.size() > MAX_MESSAGE_SIZE) {
+            return false;
+        }
+        scanned = buffer_.size();
+
+        char chunk[65536];
+        ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        buffer_.append(chunk, static_cast<size_t>(n));
+    }
+}
+
+bool Channel::writeLine(const std::string& line) {
+    std::string message = line + "\n";
+    const char* data = message.data();
+    size_t remaining = message.size();
+    while (remaining > 0) {
+#ifdef MSG_NOSIGNAL
+        ssize_t n = ::send(fd_, data, remaining, MSG_NOSIGNAL);
+#else
+        ssize_t n = ::send(fd_, data, remaining, 0);
+#endif
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        remaining -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+#else
+
+bool Channel::readLine(std::string&) {
+    return false;
+}
+
+bool Channel::writeLine(const std::string&) {
+    return false;
+}
+
+#endif
+
+nlohmann::json toJson(const Package::VerifyResult& result) {
+    return {
+        {"valid", result.valid},
+        {"errors", result.errors},
+        {"warnings", result.warnings}
+    };
+}
+
+Package::VerifyResult verifyResultFromJson(const nlohmann::json& json) {
+    Package::VerifyResult result;
+    result.valid = json.value("valid", false);
+    result.errors = json.value("errors", std::vector<std::string>{});
+    result.warnings = json.value("warnings", std::vector<std::string>{});
+    return result;
+}
+
+nlohmann::json toJson(const Package::SignatureInfo& info) {
+    return {
+        {"is_signed", info.is_signed},
+        {"signature_valid", info.signature_valid},
+        {"package_valid", info.package_valid},
+        {"signer_did", info.signer_did},
+        {"signer_name", info.signer_name},
+        {"signer_url", info.signer_url},
+        {"trusted_as", info.trusted_as},
+        {"error", info.error}
+    };
+}
+
+Package::SignatureInfo signatureInfoFromJson(const nlohmann::json& json) {
+    Package::SignatureInfo info{};
+    info.is_signed = json.value("is_signed", false);
+    info.signature_valid = json.value("signature_valid", false);
+    info.package_valid = json.value("package_valid", false);
+    info.signer_did = json.value("signer_did", "");
+    info.signer_name = json.value("signer_name", "");
+    info.signer_url = json.value("signer_url", "");
+    info.trusted_as = json.value("trusted_as", "");
+    info.error = json.value("error", "");
+    return info;
+}
+
+} // namespace server
+} // namespace lgx
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "core/package.h"
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+
+namespace lgx {
+namespace server {
+
+/**
+ * Wire protocol between `lgx serve` and its clients.
+ *
+ * Messages are single-line JSON objects terminated by '\n' over a Unix
+ * stream socket. A request is {"op": "<name>", ...params}; the response is
+ * {"ok": true, ...result} or {"ok": false, "error": "<message>"}. A
+ * connection may carry any number of request/response pairs in sequence.
+ *
+ * Operations:
+ *   ping      -> {version, protocol}
+ *   verify    {path, keyring_dir?} -> {structure, signature, trusted_as}
+ *   manifest  {path} -> {manifest, signature?}  (raw embedded bytes)
+ *   entries   {path} -> {entries: [{path, size, directory, mode}]}
+ *   extract   {path, output, variant?, include?, exclude?, update?}
+ *             -> {variants, variant?, unchanged?, written?, kept?, removed?}
+ *   sign      {path, key, keys_dir?, name?, url?} -> {did}
+ *   stats     -> {requests, package_cache, verify_cache_entries, keyring_cache_entries}
+ *   shutdown  -> {}
+ *
+ * Paths are interpreted by the daemon, so clients send absolute paths.
+ * Without keyring_dir / keys_dir the daemon uses the defaults of its own
+ * environment; the CLI always sends the directories it would use locally.
+ */
+constexpr int PROTOCOL_VERSION = 1;
+
+/**
+ * Environment variable naming the daemon socket the CLI forwards to.
+ */
+constexpr const char* SOCKET_ENV = "LGX_DAEMON_SOCKET";
+
+/**
+ * Upper bound on one message, so a misbehaving peer cannot exhaust memory.
+ */
+constexpr size_t MAX_MESSAGE_SIZE = 16 * 1024 * 1024;
+
+/**
+ * Buffered, newline-framed reader/writer over a connected socket.
+ * Does not own the descriptor.
+ */
+class Channel {
+public:
+    explicit Channel(int fd) : fd_(fd) {}
+
+    /**
+     * Read the next message (without its '\n').
+     *
+     * @return false on EOF, error or an oversized message
+     */
+    bool readLine(std::string& line);
+
+    /**
+     * Write a message followed by '\n'.
+     */
+    bool writeLine(const std::string& line);
+
+private:
+    int fd_;
+    std::string buffer_;
+};
+
+nlohmann::json toJson(const Package::VerifyResult& result);
+Package::VerifyResult verifyResultFromJson(const nlohmann::json& json);
+
+nlohmann::json toJson(const Package::SignatureInfo& info);
+Package::SignatureInfo signatureInfoFromJson(const nlohmann::json& json);
+
+} // namespace server
+} // namespace lgx
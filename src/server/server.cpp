@@ -0,0 +1,619 @@
+#include "server.h"
+#include "core/path_normalizer.h"
+#include "core/trace.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <map>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace lgx {
+namespace server {
+
+using json = nlohmann::json;
+
+thread_local std::string Server::lastError_;
+
+namespace {
+
+json okResponse(json result = json::object()) {
+    result["ok"] = true;
+    return result;
+}
+
+json errorResponse(const std::string& message) {
+    return {{"ok", false}, {"error", message}};
+}
+
+std::string stringParam(const json& request, const char* name) {
+    auto it = request.find(name);
+    if (it == request.end() || !it->is_string()) {
+        return "";
+    }
+    return it->get<std::string>();
+}
+
+// The strings of an array parameter; anything else counts as none
+std::vector<std::string> stringListParam(const json& request, const char* name) {
+    std::vector<std::string> result;
+    auto it = request.find(name);
+    if (it != request.end() && it->is_array()) {
+        for (const auto& item : *it) {
+            if (item.is_string()) {
+                result.push_back(item.get<std::string>());
+            }
+        }
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+Server::Server(Options options) : options_(std::move(options)) {
+    packages_.setBudget(options_.cacheBudget);
+}
+
+Server::~Server() {
+#ifndef _WIN32
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+    }
+    for (int fd : wakeFds_) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    if (ownsSocket_) {
+        ::unlink(options_.socketPath.c_str());
+    }
+#endif
+}
+
+#ifndef _WIN32
+
+bool Server::start() {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (options_.socketPath.empty() || options_.socketPath.size() >= sizeof(addr.sun_path)) {
+        lastError_ = "Socket path must be 1-" + std::to_string(sizeof(addr.sun_path) - 1) +
+                     " bytes: " + options_.socketPath;
+        return false;
+    }
+    std::memcpy(addr.sun_path, options_.socketPath.c_str(), options_.socketPath.size() + 1);
+
+    // Replace a stale socket left by a daemon that died, but never steal
+    // a live one or delete something that is not a socket
+    struct stat st;
+    if (::lstat(options_.socketPath.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            lastError_ = "Path exists and is not a socket: " + options_.socketPath;
+            return false;
+        }
+        int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        bool live = probe >= 0 &&
+                    ::connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        if (probe >= 0) {
+            ::close(probe);
+        }
+        if (live) {
+            lastError_ = "A daemon is already listening on " + options_.socketPath;
+            return false;
+        }
+        ::unlink(options_.socketPath.c_str());
+    }
+
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        lastError_ = std::string("Cannot create socket: ") + std::strerror(errno);
+        return false;
+    }
+
+    // Only the owning user may connect: requests can read and write files
+    // with the daemon's permissions
+    mode_t previousMask = ::umask(0077);
+    int bound = ::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    ::umask(previousMask);
+    if (bound != 0) {
+        lastError_ = "Cannot bind " + options_.socketPath + ": " + std::strerror(errno);
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+    ownsSocket_ = true;
+
+    if (::listen(listenFd_, SOMAXCONN) != 0) {
+        lastError_ = std::string("Cannot listen: ") + std::strerror(errno);
+        return false;
+    }
+
+    // Workers never block on it: a full pipe already means run() will wake
+    if (::pipe(wakeFds_) != 0) {
+        lastError_ = std::string("Cannot create wake-up pipe: ") + std::strerror(errno);
+        return false;
+    }
+    for (int fd : wakeFds_) {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+
+    size_t workers = options_.workers;
+    if (workers == 0) {
+        workers = std::clamp<size_t>(std::thread::hardware_concurrency(), 2, 8);
+    }
+    pool_ = std::make_unique<WorkerPool>(workers);
+    return true;
+}
+
+void Server::run() {
+    if (listenFd_ < 0 || !pool_) {
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto idleTimeout = std::chrono::seconds(options_.idleTimeout);
+    std::map<int, Connection> connections;
+    auto closeConnection = [&connections](std::map<int, Connection>::iterator it) {
+        ::close(it->first);
+        return connections.erase(it);
+    };
+
+    std::vector<pollfd> pfds;
+    while (!stopping_.load()) {
+        {
+            std::lock_guard<std::mutex> lock(doneMutex_);
+            for (auto [fd, sent] : done_) {
+                auto it = connections.find(fd);
+                it->second.busy = false;
+                it->second.lastActive = Clock::now();
+                if (!sent) {
+                    closeConnection(it);
+                }
+            }
+            done_.clear();
+        }
+
+        // Hand the next buffered request of each free connection to the
+        // pool; close connections that are finished or idle too long
+        auto now = Clock::now();
+        for (auto it = connections.begin(); it != connections.end();) {
+            Connection& conn = it->second;
+            if (conn.busy) {
+                ++it;
+                continue;
+            }
+            size_t newline = conn.buffer.find('\n');
+            if (newline != std::string::npos) {
+                std::string line = conn.buffer.substr(0, newline);
+                conn.buffer.erase(0, newline + 1);
+                conn.busy = true;
+                int fd = it->first;
+                pool_->submit([this, fd, line = std::move(line)] { serveRequest(fd, line); });
+                ++it;
+            } else if (conn.closed || conn.buffer.size() > MAX_MESSAGE_SIZE ||
+                       (options_.idleTimeout > 0 && now - conn.lastActive >= idleTimeout)) {
+                it = closeConnection(it);
+            } else {
+                ++it;
+            }
+        }
+
+        // Poll with a timeout so stop requests and idle connections are
+        // noticed; busy connections are not read until their answer is sent
+        pfds.clear();
+        pfds.push_back({listenFd_, POLLIN, 0});
+        pfds.push_back({wakeFds_[0], POLLIN, 0});
+        for (const auto& [fd, conn] : connections) {
+            if (!conn.busy && !conn.closed) {
+                pfds.push_back({fd, POLLIN, 0});
+            }
+        }
+        int ready = ::poll(pfds.data(), static_cast<nfds_t>(pfds.size()), 200);
+        if (ready <= 0) {
+            continue;
+        }
+
+        if (pfds[1].revents & POLLIN) {
+            char drain[64];
+            while (::read(wakeFds_[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+        for (size_t i = 2; i < pfds.size(); ++i) {
+            if (pfds[i].revents == 0) {
+                continue;
+            }
+            Connection& conn = connections[pfds[i].fd];
+            char chunk[65536];
+            ssize_t n = ::recv(pfds[i].fd, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                conn.closed = true;  // requests already received are still answered
+                continue;
+            }
+            conn.buffer.append(chunk, static_cast<size_t>(n));
+            conn.lastActive = Clock::now();
+        }
+        if (pfds[0].revents & POLLIN) {
+            int fd = ::accept(listenFd_, nullptr, nullptr);
+            if (fd >= 0) {
+                // A client that stops reading its responses must not hold
+                // a worker forever
+                if (options_.idleTimeout > 0) {
+                    timeval timeout{static_cast<time_t>(options_.idleTimeout), 0};
+                    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                }
+                connections[fd].lastActive = Clock::now();
+            }
+        }
+    }
+
+    // Let the requests in progress be answered, then close every connection
+    pool_.reset();
+    for (auto it = connections.begin(); it != connections.end();) {
+        it = closeConnection(it);
+    }
+}
+
+void Server::serveRequest(int fd, const std::string& line) {
+    json response;
+    try {
+        response = handle(json::parse(line));
+    } catch (const json::exception& e) {
+        response = errorResponse(std::string("Malformed request: ") + e.what());
+    }
+    bool sent = Channel(fd).writeLine(response.dump());
+
+    {
+        std::lock_guard<std::mutex> lock(doneMutex_);
+        done_.emplace_back(fd, sent);
+    }
+    char wake = 0;
+    [[maybe_unused]] ssize_t n = ::write(wakeFds_[1], &wake, 1);
+}
+
+#else
+
+bool Server::start() {
+    lastError_ = "lgx serve requires Unix domain sockets (not supported on Windows)";
+    return false;
+}
+
+void Server::run() {}
+
+void Server::serveRequest(int, const std::string&) {}
+
+#endif
+
+void Server::requestStop() {
+    stopping_.store(true);
+}
+
+json Server::handle(const json& request) {
+    ++requests_;
+    if (!request.is_object()) {
+        return errorResponse("Request must be a JSON object");
+    }
+
+    std::string op = stringParam(request, "op");
+    Trace::Span span("server.request", op);
+
+    try {
+        if (op == "ping") {
+            return okResponse({{"version", "0.1.0"}, {"protocol", PROTOCOL_VERSION}});
+        }
+        if (op == "verify") return handleVerify(request);
+        if (op == "manifest") return handleManifest(request);
+        if (op == "entries") return handleEntries(request);
+        if (op == "extract") return handleExtract(request);
+        if (op == "sign") return handleSign(request);
+        if (op == "stats") return handleStats();
+        if (op == "shutdown") {
+            requestStop();
+            return okResponse();
+        }
+    } catch (const std::exception& e) {
+        return errorResponse(std::string("Internal error: ") + e.what());
+    }
+
+    return errorResponse("Unknown operation: " + op);
+}
+
+std::shared_ptr<Package> Server::loadPackage(const std::string& path) {
+    if (path.empty()) {
+        lastError_ = "Missing package path";
+        return nullptr;
+    }
+    auto package = packages_.load(path);
+    if (!package) {
+        lastError_ = PackageCache::getLastError();
+    }
+    return package;
+}
+
+json Server::handleVerify(const json& request) {
+    std::string path = stringParam(request, "path");
+    auto package = loadPackage(path);
+    if (!package) {
+        Package::VerifyResult failed{false, {lastError_}, {}};
+        return okResponse({{"structure", toJson(failed)}});
+    }
+
+    // Results are reused for as long as the cache hands out the same decoded
+    // package, i.e. until the file changes or the package is evicted
+    Package::VerifyResult structure;
+    Package::SignatureInfo signature{};
+    bool cached = false;
+    {
+        std::lock_guard<std::mutex> lock(verifyMutex_);
+        auto it = verifyCache_.find(path);
+        if (it != verifyCache_.end() && it->second.package.lock() == package) {
+            structure = it->second.structure;
+            signature = it->second.signature;
+            cached = true;
+        }
+    }
+
+    if (!cached) {
+        structure = package->validatePackage();
+        if (structure.valid) {
+            signature = package->checkSignature();
+        }
+
+        std::lock_guard<std::mutex> lock(verifyMutex_);
+        // Drop entries whose packages are gone before adding another
+        for (auto it = verifyCache_.begin(); it != verifyCache_.end();) {
+            it = it->second.package.expired() ? verifyCache_.erase(it) : std::next(it);
+        }
+        verifyCache_[path] = VerifyEntry{package, structure, signature};
+    }
+
+    json response = {{"structure", toJson(structure)}};
+    if (!structure.valid) {
+        return okResponse(response);
+    }
+
+    std::string keyringDir = stringParam(request, "keyring_dir");
+    std::filesystem::path dir = keyringDir.empty() ? crypto::Keyring::defaultDirectory()
+                                                   : std::filesystem::path(keyringDir);
+    std::error_code ec;
+    bool keyringChecked = signature.is_signed && signature.signature_valid &&
+                          signature.package_valid && !dir.empty() &&
+                          std::filesystem::exists(dir, ec);
+    if (keyringChecked) {
+        signature.trusted_as = trustedName(dir, signature.signer_did);
+    }
+
+    response["signature"] = toJson(signature);
+    response["keyring_checked"] = keyringChecked;
+    return okResponse(response);
+}
+
+json Server::handleManifest(const json& request) {
+    auto package = loadPackage(stringParam(request, "path"));
+    if (!package) {
+        return errorResponse("Failed to load package: " + lastError_);
+    }
+
+    json response = {{"manifest", nullptr}, {"signature", nullptr}};
+    for (const auto& entry : package->getEntries()) {
+        if (entry.isDirectory) continue;
+        if (entry.path == "manifest.json") {
+            response["manifest"] = std::string(entry.data.begin(), entry.data.end());
+        } else if (entry.path == "manifest.sig") {
+            response["signature"] = std::string(entry.data.begin(), entry.data.end());
+        }
+    }
+    if (response["manifest"].is_null()) {
+        return errorResponse("Package does not contain a manifest.json entry");
+    }
+    return okResponse(response);
+}
+
+json Server::handleEntries(const json& request) {
+    auto package = loadPackage(stringParam(request, "path"));
+    if (!package) {
+        return errorResponse("Failed to load package: " + lastError_);
+    }
+
+    json entries = json::array();
+    for (const auto& entry : package->getEntries()) {
+        entries.push_back({
+            {"path", entry.path},
+            {"size", entry.data.size()},
+            {"directory", entry.isDirectory},
+            {"mode", entry.mode}
+        });
+    }
+    return okResponse({{"entries", std::move(entries)}});
+}
+
+json Server::handleExtract(const json& request) {
+    std::string output = stringParam(request, "output");
+    if (output.empty()) {
+        return errorResponse("Missing output directory");
+    }
+    auto package = loadPackage(stringParam(request, "path"));
+    if (!package) {
+        return errorResponse("Failed to load package: " + lastError_);
+    }
+
+    std::string variant = stringParam(request, "variant");
+    PathFilter filter(stringListParam(request, "include"), stringListParam(request, "exclude"));
+    bool update = request.contains("update") && request["update"].is_boolean() &&
+                  request["update"].get<bool>();
+    Package::Durability durability =
+        request.contains("durable") && request["durable"].is_boolean() && request["durable"].get<bool>()
+            ? Package::Durability::Durable : Package::Durability::Default;
+    if (update && !filter.empty()) {
+        return errorResponse("Updates cannot be filtered");
+    }
+    if (durability == Package::Durability::Durable && !filter.empty()) {
+        return errorResponse("Durable extraction cannot be filtered");
+    }
+
+    std::string variantLc = PathNormalizer::toLowercase(variant);
+    if (!variant.empty() && !package->hasVariant(variantLc)) {
+        return errorResponse("Variant not found: " + variant);
+    }
+
+    Package::UpdateCounts counts;
+    Package::Result result;
+    if (update) {
+        result = variant.empty() ? package->updateAll(output, &counts, durability)
+                                 : package->updateVariant(variantLc, output, &counts, durability);
+    } else {
+        result = variant.empty() ? package->extractAll(output, filter, durability)
+                                 : package->extractVariant(variantLc, output, filter, durability);
+    }
+    if (!result.success) {
+        return errorResponse(result.error);
+    }
+
+    json response = {{"variants", variant.empty() ? package->getVariants().size() : size_t{1}}};
+    if (!variant.empty()) {
+        response["variant"] = variantLc;
+    }
+    if (update) {
+        response["unchanged"] = result.unchanged;
+        response["written"] = counts.written;
+        response["kept"] = counts.kept;
+        response["removed"] = counts.removed;
+    }
+    return okResponse(response);
+}
+
+json Server::handleSign(const json& request) {
+    std::string path = stringParam(request, "path");
+    std::string keyName = stringParam(request, "key");
+    if (keyName.empty()) {
+        return errorResponse("Missing required option: --key <name>");
+    }
+    if (!crypto::init()) {
+        return errorResponse("Failed to initialize crypto library");
+    }
+
+    // Secret keys are read per request and never cached in the daemon
+    std::string keysDirParam = stringParam(request, "keys_dir");
+    std::filesystem::path keysDir = keysDirParam.empty() ? crypto::Keyring::defaultKeysDirectory()
+                                                         : std::filesystem::path(keysDirParam);
+    if (keysDir.empty()) {
+        return errorResponse("Cannot determine keys directory (HOME not set?)");
+    }
+    auto sk = crypto::Keyring::loadSecretKey(keysDir, keyName);
+    if (!sk) {
+        return errorResponse("Failed to load secret key '" + keyName + "': " +
+                             crypto::Keyring::getLastError());
+    }
+
+    auto cached = loadPackage(path);
+    if (!cached) {
+        return errorResponse("Failed to load package: " + path);
+    }
+    Package package = *cached;  // cached packages are shared and immutable
+
+    auto signResult = package.signPackage(*sk, stringParam(request, "name"), stringParam(request, "url"));
+    if (!signResult.success) {
+        return errorResponse("Failed to sign package: " + signResult.error);
+    }
+    auto saveResult = package.save(path);
+    if (!saveResult.success) {
+        return errorResponse("Failed to save signed package: " + saveResult.error);
+    }
+
+    return okResponse({{"did", crypto::publicKeyToDid(crypto::extractPublicKey(*sk))}});
+}
+
+json Server::handleStats() {
+    auto cache = packages_.getStats();
+    size_t verifyEntries;
+    size_t keyringEntries;
+    {
+        std::lock_guard<std::mutex> lock(verifyMutex_);
+        verifyEntries = verifyCache_.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(keyringMutex_);
+        keyringEntries = keyringCache_.size();
+    }
+
+    return okResponse({
+        {"requests", requests_.load()},
+        {"package_cache", {
+            {"hits", cache.hits},
+            {"misses", cache.misses},
+            {"evictions", cache.evictions},
+            {"entries", cache.entries},
+            {"bytes", cache.bytes},
+            {"budget", cache.budget}
+        }},
+        {"verify_cache_entries", verifyEntries},
+        {"keyring_cache_entries", keyringEntries}
+    });
+}
+
+std::string Server::trustedName(const std::filesystem::path& keyringDir, const std::string& did) {
+    std::string key = keyringDir.lexically_normal().string();
+    std::string fingerprint = keyringFingerprint(keyringDir);
+
+    std::lock_guard<std::mutex> lock(keyringMutex_);
+    auto it = keyringCache_.find(key);
+    if (it == keyringCache_.end() || it->second.fingerprint != fingerprint) {
+        KeyringEntry entry;
+        entry.fingerprint = fingerprint;
+        for (const auto& trusted : crypto::Keyring(keyringDir).listKeys()) {
+            entry.byDid.emplace(trusted.did, trusted.name);
+        }
+        it = keyringCache_.insert_or_assign(key, std::move(entry)).first;
+    }
+
+    auto found = it->second.byDid.find(did);
+    return found == it->second.byDid.end() ? "" : found->second;
+}
+
+std::string Server::keyringFingerprint(const std::filesystem::path& dir) {
+    namespace fs = std::filesystem;
+
+    // Cheap to compute (one directory scan, no parsing) and changes whenever
+    // a key file is added, removed or rewritten
+    std::vector<std::string> parts;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        std::error_code entryEc;
+        if (!entry.is_regular_file(entryEc) || entry.path().extension() != ".json") continue;
+        auto size = entry.file_size(entryEc);
+        auto mtime = entry.last_write_time(entryEc).time_since_epoch().count();
+        std::ostringstream part;
+        part << entry.path().filename().string() << ':' << size << ':' << mtime;
+        parts.push_back(part.str());
+    }
+    std::sort(parts.begin(), parts.end());
+
+    std::string fingerprint;
+    for (const auto& part : parts) {
+        fingerprint += part;
+        fingerprint += '\n';
+    }
+    return fingerprint;
+}
+
+std::string Server::getLastError() {
+    return lastError_;
+}
+
+} // namespace server
+} // namespace lgx
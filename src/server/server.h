@@ -0,0 +1,154 @@
+#pragma once
+
+#include "protocol.h"
+#include "core/package_cache.h"
+#include "core/worker_pool.h"
+#include "crypto/keyring.h"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lgx {
+namespace server {
+
+/**
+ * Server is the `lgx serve` daemon: it listens on a Unix socket and answers
+ * protocol requests (see protocol.h) on a worker pool.
+ *
+ * run() reads every connection with poll() and hands each complete request
+ * line to the pool, one task per request. A worker is never tied to a
+ * connection, so idle clients cannot starve the others. Requests on one
+ * connection are answered in order, and connections idle for longer than
+ * Options::idleTimeout are closed.
+ *
+ * It keeps warm state between requests:
+ *   - decoded packages (a PackageCache, invalidated by file identity)
+ *   - verification results per decoded package
+ *   - keyring indexes per directory (invalidated when the key files change)
+ *
+ * POSIX only; on Windows start() fails.
+ */
+class Server {
+public:
+    struct Options {
+        std::string socketPath;
+        size_t workers = 0;                             // 0 = one per hardware thread, clamped to [2, 8]
+        size_t cacheBudget = 256 * 1024 * 1024;         // decoded-package cache budget in bytes
+        size_t idleTimeout = 60;                        // seconds before an idle connection is closed (0 = never)
+    };
+
+    explicit Server(Options options);
+    ~Server();
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    /**
+     * Create and bind the socket (mode 0600). A stale socket file left by
+     * a dead daemon is replaced; a live one is an error.
+     *
+     * @return false on error (see getLastError())
+     */
+    bool start();
+
+    /**
+     * Accept connections and answer requests until a shutdown request or
+     * requestStop(). Returns after the requests in progress have been
+     * answered and every connection has been closed.
+     */
+    void run();
+
+    /**
+     * Ask run() to return. Async-signal-safe.
+     */
+    void requestStop();
+
+    /**
+     * Handle one request object and build its response. Thread-safe; used
+     * by the connection loop and directly by tests.
+     */
+    nlohmann::json handle(const nlohmann::json& request);
+
+    /**
+     * Get the last error message.
+     */
+    static std::string getLastError();
+
+private:
+    struct VerifyEntry {
+        std::weak_ptr<Package> package;
+        Package::VerifyResult structure;
+        Package::SignatureInfo signature;
+    };
+
+    struct KeyringEntry {
+        std::string fingerprint;                   // key file names, sizes, mtimes
+        std::map<std::string, std::string> byDid;  // did -> keyring name
+    };
+
+    /**
+     * A client connection, owned by the run() thread.
+     */
+    struct Connection {
+        std::string buffer;          // received bytes not yet taken as requests
+        bool busy = false;           // a worker is answering one of its requests
+        bool closed = false;         // the client stopped sending
+        std::chrono::steady_clock::time_point lastActive;
+    };
+
+    /**
+     * Answer one request on a pool worker, then report back to run().
+     */
+    void serveRequest(int fd, const std::string& line);
+
+    nlohmann::json handleVerify(const nlohmann::json& request);
+    nlohmann::json handleManifest(const nlohmann::json& request);
+    nlohmann::json handleEntries(const nlohmann::json& request);
+    nlohmann::json handleExtract(const nlohmann::json& request);
+    nlohmann::json handleSign(const nlohmann::json& request);
+    nlohmann::json handleStats();
+
+    std::shared_ptr<Package> loadPackage(const std::string& path);
+
+    /**
+     * Keyring name trusting `did` in `keyringDir`, or empty.
+     */
+    std::string trustedName(const std::filesystem::path& keyringDir, const std::string& did);
+
+    static std::string keyringFingerprint(const std::filesystem::path& dir);
+
+    Options options_;
+    int listenFd_ = -1;
+    bool ownsSocket_ = false;
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> requests_{0};
+
+    PackageCache packages_;
+    std::unique_ptr<WorkerPool> pool_;
+
+    std::mutex verifyMutex_;
+    std::map<std::string, VerifyEntry> verifyCache_;
+
+    std::mutex keyringMutex_;
+    std::map<std::string, KeyringEntry> keyringCache_;
+
+    // Connections whose request a worker has answered: fd, and whether the
+    // response was sent (run() closes the connection if not)
+    std::mutex doneMutex_;
+    std::vector<std::pair<int, bool>> done_;
+    int wakeFds_[2] = {-1, -1};  // pipe a worker writes to so run() polls again
+
+    static thread_local std::string lastError_;
+};
+
+} // namespace server
+} // namespace lgx
@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+#include "core/build_spec.h"
+#include "core/package.h"
+#include "crypto/signing.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using namespace lgx;
+namespace fs = std::filesystem;
+
+class BuildSpecTest : public ::testing::Test {
+protected:
+    fs::path tempDir;
+
+    void SetUp() override {
+        ASSERT_TRUE(crypto::init());
+        tempDir = fs::temp_directory_path() / ("lgx_build_test_" + std::to_string(rand()));
+        fs::create_directories(tempDir);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(tempDir, ec);
+    }
+
+    void writeFile(const fs::path& path, const std::string& content) {
+        fs::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    fs::path writeSpec(const std::string& json) {
+        fs::path specPath = tempDir / "build.json";
+        writeFile(specPath, json);
+        return specPath;
+    }
+
+    static std::string readFile(const fs::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // Three variants: a directory, a single file and a nested directory
+    void createInputs() {
+        writeFile(tempDir / "build/linux/mod.so", "linux library");
+        writeFile(tempDir / "build/linux/res/data.bin", std::string(4096, 'd'));
+        writeFile(tempDir / "build/darwin/mod.dylib", "darwin library");
+        writeFile(tempDir / "build/windows/bin/mod.dll", "windows library");
+    }
+};
+
+TEST_F(BuildSpecTest, MatchesCreateThenAdd) {
+    createInputs();
+
+    // The package built the old way: create, then one add per variant
+    fs::path expected = tempDir / "expected.lgx";
+    ASSERT_TRUE(Package::create(expected, "MyMod").success);
+    struct Step { const char* variant; fs::path files; std::optional<std::string> main; };
+    std::vector<Step> steps = {
+        {"Linux-AMD64", tempDir / "build/linux", "mod.so"},
+        {"darwin-arm64", tempDir / "build/darwin/mod.dylib", std::nullopt},
+        {"windows-amd64", tempDir / "build/windows", "bin/mod.dll"},
+    };
+    for (const auto& step : steps) {
+        auto pkg = Package::load(expected);
+        ASSERT_TRUE(pkg.has_value());
+        ASSERT_TRUE(pkg->addVariant(step.variant, step.files, step.main).success);
+        ASSERT_TRUE(pkg->save(expected).success);
+    }
+
+    fs::path specPath = writeSpec(R"({
+        "name": "MyMod",
+        "variants": {
+            "windows-amd64": { "files": "build/windows", "main": "bin/mod.dll" },
+            "darwin-arm64": "build/darwin/mod.dylib",
+            "Linux-AMD64": { "files": "build/linux", "main": "mod.so" }
+        },
+        "output": "out/mymod.lgx"
+    })");
+    auto spec = BuildSpec::load(specPath);
+    ASSERT_TRUE(spec.has_value()) << BuildSpec::getLastError();
+    EXPECT_EQ(spec->outputPath(), tempDir / "out/mymod.lgx");
+
+    fs::create_directories(tempDir / "out");
+    auto result = spec->build(spec->outputPath());
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(readFile(spec->outputPath()), readFile(expected));
+
+    auto built = Package::load(spec->outputPath());
+    ASSERT_TRUE(built.has_value());
+    EXPECT_TRUE(built->validatePackage().valid);
+    EXPECT_EQ(built->getManifest().getMain("linux-amd64"), std::optional<std::string>("mod.so"));
+    EXPECT_EQ(built->getManifest().getMain("darwin-arm64"), std::optional<std::string>("mod.dylib"));
+}
+
+TEST_F(BuildSpecTest, EmptySpecMatchesCreate) {
+    fs::path expected = tempDir / "expected.lgx";
+    ASSERT_TRUE(Package::create(expected, "bare").success);
+
+    auto spec = BuildSpec::parse(R"({"name": "bare"})", tempDir);
+    ASSERT_TRUE(spec.has_value()) << BuildSpec::getLastError();
+    EXPECT_EQ(spec->outputPath(), fs::path("bare.lgx"));
+    ASSERT_TRUE(spec->build(tempDir / "bare.lgx").success);
+    EXPECT_EQ(readFile(tempDir / "bare.lgx"), readFile(expected));
+}
+
+TEST_F(BuildSpecTest, MetadataDocsAndLicenses) {
+    createInputs();
+    writeFile(tempDir / "README.md", "# readme");
+    writeFile(tempDir / "manual/guide.md", "guide");
+    writeFile(tempDir / "manual/img/logo.png", "png");
+    writeFile(tempDir / "LICENSE", "MIT");
+
+    auto spec = BuildSpec::parse(R"({
+        "name": "docmod",
+        "version": "1.2.0",
+        "description": "A module",
+        "author": "Logos",
+        "type": "core",
+        "display_name": "Doc Module",
+        "dependencies": ["base", {"name": "net", "version": "^2.0"}],
+        "variants": { "linux-amd64": { "files": "build/linux", "main": "mod.so" } },
+        "docs": ["README.md", "manual"],
+        "licenses": "LICENSE"
+    })", tempDir);
+    ASSERT_TRUE(spec.has_value()) << BuildSpec::getLastError();
+    EXPECT_EQ(spec->manifest.version, "1.2.0");
+    EXPECT_EQ(spec->manifest.displayName, "Doc Module");
+    ASSERT_EQ(spec->manifest.dependencies.size(), 2u);
+    EXPECT_EQ(spec->manifest.dependencies[1].version, std::optional<std::string>("^2.0"));
+
+    fs::path out = tempDir / "docmod.lgx";
+    auto result = spec->build(out);
+    ASSERT_TRUE(result.success) << result.error;
+
+    auto pkg = Package::load(out);
+    ASSERT_TRUE(pkg.has_value());
+    EXPECT_TRUE(pkg->validatePackage().valid);
+    std::set<std::string> files;
+    for (const auto& entry : pkg->getEntries()) {
+        if (!entry.isDirectory) files.insert(entry.path);
+    }
+    EXPECT_TRUE(files.count("docs/README.md"));
+    EXPECT_TRUE(files.count("docs/guide.md"));
+    EXPECT_TRUE(files.count("docs/img/logo.png"));
+    EXPECT_TRUE(files.count("licenses/LICENSE"));
+    EXPECT_EQ(pkg->getManifest().author, "Logos");
+    EXPECT_FALSE(pkg->getManifest().hashes["docs"].empty());
+    EXPECT_FALSE(pkg->getManifest().hashes["licenses"].empty());
+}
+
+TEST_F(BuildSpecTest, RejectsInvalidSpecs) {
+    EXPECT_FALSE(BuildSpec::parse("not json", tempDir).has_value());
+    EXPECT_FALSE(BuildSpec::parse(R"({"version": "1.0.0"})", tempDir).has_value());
+    EXPECT_FALSE(BuildSpec::parse(R"({"name": "x", "varients": {}})", tempDir).has_value());
+    EXPECT_NE(BuildSpec::getLastError().find("varients"), std::string::npos);
+    EXPECT_FALSE(BuildSpec::parse(R"({"name": "x", "variants": ["a"]})", tempDir).has_value());
+    EXPECT_FALSE(BuildSpec::parse(R"({"name": "x", "variants": {"a": 1}})", tempDir).has_value());
+    EXPECT_FALSE(BuildSpec::parse(R"({"name": "x", "variants": {"A": "f", "a": "g"}})",
+                                  tempDir).has_value());
+    EXPECT_FALSE(BuildSpec::parse(R"({"name": "x", "view": "../up.qml"})", tempDir).has_value());
+    EXPECT_FALSE(BuildSpec::parse(R"({"name": "x", "dependencies": [1]})", tempDir).has_value());
+    EXPECT_FALSE(BuildSpec::load(tempDir / "missing.json").has_value());
+
+    // Valid specs whose inputs are not
+    createInputs();
+    fs::path out = tempDir / "x.lgx";
+    auto noMain = BuildSpec::parse(R"({"name": "x", "variants": {"linux": "build/linux"}})", tempDir);
+    ASSERT_TRUE(noMain.has_value());
+    EXPECT_FALSE(noMain->build(out).success);
+
+    auto missing = BuildSpec::parse(R"({"name": "x", "variants": {"linux": "nowhere"}})", tempDir);
+    ASSERT_TRUE(missing.has_value());
+    EXPECT_FALSE(missing->build(out).success);
+
+    writeFile(tempDir / "a/README.md", "a");
+    writeFile(tempDir / "b/README.md", "b");
+    auto clash = BuildSpec::parse(R"({"name": "x", "docs": ["a/README.md", "b"]})", tempDir);
+    ASSERT_TRUE(clash.has_value());
+    auto result = clash->build(out);
+    EXPECT_FALSE(result.success);
+    EXPECT_NE(result.error.find("docs/README.md"), std::string::npos);
+
+    auto qml = BuildSpec::parse(R"({"name": "x", "type": "ui_qml"})", tempDir);
+    ASSERT_TRUE(qml.has_value());
+    EXPECT_FALSE(qml->build(out).success);
+    EXPECT_FALSE(fs::exists(out));
+}
+
+TEST_F(BuildSpecTest, AddInputsFailureLeavesPackageUnchanged) {
+    createInputs();
+    fs::path pkgPath = tempDir / "pkg.lgx";
+    ASSERT_TRUE(Package::create(pkgPath, "pkg").success);
+    auto pkg = Package::load(pkgPath);
+    ASSERT_TRUE(pkg.has_value());
+    ASSERT_TRUE(pkg->addVariant("linux", tempDir / "build/linux", std::string("mod.so")).success);
+    auto before = pkg->getEntries().size();
+    auto hashes = pkg->getManifest().hashes;
+
+    Package::Inputs inputs;
+    inputs.variants.push_back({"darwin", tempDir / "build/darwin/mod.dylib", std::nullopt});
+    inputs.variants.push_back({"linux", tempDir / "build/windows", std::nullopt});  // no main
+    EXPECT_FALSE(pkg->addInputs(inputs).success);
+    EXPECT_EQ(pkg->getEntries().size(), before);
+    EXPECT_EQ(pkg->getManifest().hashes, hashes);
+    EXPECT_FALSE(pkg->hasVariant("darwin"));
+
+    // A later input replaces an earlier one of the same variant, as repeated adds would
+    inputs.variants[1].mainPath = "bin/mod.dll";
+    inputs.variants.push_back({"darwin", tempDir / "build/linux", std::string("mod.so")});
+    ASSERT_TRUE(pkg->addInputs(inputs).success);
+    EXPECT_EQ(pkg->getManifest().getMain("darwin"), std::optional<std::string>("mod.so"));
+    EXPECT_EQ(pkg->getManifest().getMain("linux"), std::optional<std::string>("bin/mod.dll"));
+    EXPECT_TRUE(pkg->validatePackage().valid);
+}
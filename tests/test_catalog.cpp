@@ -0,0 +1,305 @@
+#include <gtest/gtest.h>
+#include "core/catalog.h"
+#include "core/gzip_handler.h"
+#include "core/package.h"
+#include "core/stats.h"
+#include "crypto/signing.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace lgx;
+namespace fs = std::filesystem;
+
+class CatalogTest : public ::testing::Test {
+protected:
+    fs::path tempDir;
+    fs::path repoDir;
+
+    void SetUp() override {
+        ASSERT_TRUE(crypto::init());
+        tempDir = fs::temp_directory_path() / ("lgx_catalog_test_" + std::to_string(rand()));
+        repoDir = tempDir / "repo";
+        fs::create_directories(repoDir);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(tempDir, ec);
+    }
+
+    // Create repoDir/<file> as package `name` at `version` with a variant
+    // holding `payload` bytes, optionally signed
+    fs::path createPackage(const std::string& file, const std::string& name,
+                           const std::string& version, size_t payload = 16,
+                           const crypto::KeyPair* signer = nullptr,
+                           std::vector<Dependency> dependencies = {}) {
+        fs::path pkgPath = repoDir / file;
+        fs::create_directories(pkgPath.parent_path());
+        EXPECT_TRUE(Package::create(pkgPath, name).success);
+
+        fs::path payloadFile = tempDir / (name + "-" + version + ".bin");
+        std::ofstream(payloadFile, std::ios::binary) << std::string(payload, 'x');
+
+        auto pkg = Package::load(pkgPath);
+        EXPECT_TRUE(pkg.has_value());
+        pkg->getManifest().version = version;
+        pkg->getManifest().dependencies = std::move(dependencies);
+        EXPECT_TRUE(pkg->addVariant("linux-amd64", payloadFile).success);
+        if (signer) {
+            EXPECT_TRUE(pkg->signPackage(signer->secretKey).success);
+        }
+        EXPECT_TRUE(pkg->save(pkgPath).success);
+        return pkgPath;
+    }
+
+    // Write `parts` to `pkgPath` as one gzipped tar, each part sorted on its
+    // own, so entries can be placed out of order or repeated
+    static void writeArchive(const fs::path& pkgPath, const std::vector<std::vector<TarEntry>>& parts) {
+        std::vector<uint8_t> tar;
+        for (const auto& part : parts) {
+            DeterministicTarWriter writer;
+            for (const auto& entry : part) {
+                writer.addEntry(entry);
+            }
+            auto bytes = writer.finalize();
+            bytes.resize(bytes.size() - 1024);  // drop the end-of-archive marker
+            tar.insert(tar.end(), bytes.begin(), bytes.end());
+        }
+        tar.resize(tar.size() + 1024, 0);
+        auto gz = GzipHandler::compress(tar);
+        std::ofstream(pkgPath, std::ios::binary).write(reinterpret_cast<const char*>(gz.data()),
+                                                       static_cast<std::streamsize>(gz.size()));
+    }
+
+    static std::vector<std::string> versionsOf(const std::vector<const Catalog::Entry*>& entries) {
+        std::vector<std::string> out;
+        for (const auto* entry : entries) {
+            out.push_back(entry->name + "@" + entry->version);
+        }
+        return out;
+    }
+};
+
+TEST_F(CatalogTest, ReadMetadataMatchesFullLoad) {
+    auto kp = crypto::generateKeypair();
+    fs::path pkgPath = createPackage("a.lgx", "alpha", "1.2.3", 16, &kp, {"beta"});
+
+    auto metadata = Package::readMetadata(pkgPath);
+    ASSERT_TRUE(metadata.has_value()) << Package::getLastError();
+    auto pkg = Package::load(pkgPath);
+    ASSERT_TRUE(pkg.has_value());
+
+    EXPECT_EQ(metadata->manifest.toJson(), pkg->getManifest().toJson());
+    ASSERT_TRUE(metadata->signature.has_value());
+    EXPECT_EQ(metadata->signature->did, pkg->verifySignature().signer_did);
+    EXPECT_TRUE(Package::verifyManifestSignature(metadata->manifest, *metadata->signature).success);
+}
+
+TEST_F(CatalogTest, ReadMetadataStopsBeforeVariants) {
+    fs::path pkgPath = createPackage("big.lgx", "big", "1.0.0", 8 * 1024 * 1024);
+
+    Stats::reset();
+    Stats::setEnabled(true);
+    auto metadata = Package::readMetadata(pkgPath);
+    auto snapshot = Stats::snapshot();
+    Stats::setEnabled(false);
+
+    ASSERT_TRUE(metadata.has_value()) << Package::getLastError();
+    EXPECT_EQ(metadata->manifest.name, "big");
+    EXPECT_LT(snapshot[Stats::Phase::Inflate].bytesOut, 1024u * 1024);
+}
+
+TEST_F(CatalogTest, ReadMetadataFallsBackForOtherArchiveOrder) {
+    // variants/ ahead of manifest.json, as another tar tool might write it
+    fs::path source = createPackage("src.lgx", "odd", "2.0.0");
+    auto pkg = Package::load(source);
+    ASSERT_TRUE(pkg.has_value());
+
+    std::vector<TarEntry> head;
+    std::vector<TarEntry> tail;
+    for (const auto& entry : pkg->getEntries()) {
+        (entry.path == "manifest.json" ? tail : head).push_back(entry);
+    }
+    fs::path oddPath = repoDir / "odd.lgx";
+    writeArchive(oddPath, {head, tail});
+
+    auto metadata = Package::readMetadata(oddPath);
+    ASSERT_TRUE(metadata.has_value()) << Package::getLastError();
+    EXPECT_EQ(metadata->manifest.name, "odd");
+    EXPECT_EQ(metadata->manifest.version, "2.0.0");
+}
+
+TEST_F(CatalogTest, DuplicateManifestIsRejected) {
+    fs::path source = createPackage("src.lgx", "dup", "1.0.0");
+    auto pkg = Package::load(source);
+    ASSERT_TRUE(pkg.has_value());
+
+    Manifest other = pkg->getManifest();
+    other.name = "other";
+    TarEntry second("manifest.json", other.toJson());
+    std::vector<TarEntry> upToManifest;
+    std::vector<TarEntry> rest;
+    for (const auto& entry : pkg->getEntries()) {
+        (entry.path <= "manifest.json" ? upToManifest : rest).push_back(entry);
+    }
+
+    // Both copies ahead of the variants: every reader sees and refuses them
+    fs::path adjacent = repoDir / "adjacent.lgx";
+    writeArchive(adjacent, {upToManifest, {second}, rest});
+    EXPECT_FALSE(Package::readMetadata(adjacent).has_value());
+    EXPECT_EQ(Package::getLastError(), "Duplicate manifest.json in package");
+    EXPECT_FALSE(Package::load(adjacent).has_value());
+    EXPECT_EQ(Package::getLastError(), "Duplicate manifest.json in package");
+    EXPECT_FALSE(Package::load(adjacent, [](const std::string&, bool) { return true; }).has_value());
+    EXPECT_EQ(Package::getLastError(), "Duplicate manifest.json in package");
+
+    // A copy after the variants is past where readMetadata() stops, but the
+    // package still cannot be loaded with either manifest
+    fs::path trailing = repoDir / "trailing.lgx";
+    writeArchive(trailing, {upToManifest, rest, {second}});
+    auto metadata = Package::readMetadata(trailing);
+    ASSERT_TRUE(metadata.has_value()) << Package::getLastError();
+    EXPECT_EQ(metadata->manifest.name, "dup");
+    EXPECT_FALSE(Package::load(trailing).has_value());
+    EXPECT_EQ(Package::getLastError(), "Duplicate manifest.json in package");
+}
+
+TEST_F(CatalogTest, UpdateRereadsOnlyChangedFiles) {
+    createPackage("a.lgx", "alpha", "1.0.0");
+    createPackage("nested/b.lgx", "beta", "1.0.0");
+    fs::path c = createPackage("c.lgx", "gamma", "1.0.0");
+
+    auto first = Catalog::update(repoDir);
+    ASSERT_TRUE(first.success) << first.error;
+    EXPECT_EQ(first.scanned, 3u);
+    EXPECT_EQ(first.parsed, 3u);
+    EXPECT_TRUE(fs::exists(Catalog::defaultIndexPath(repoDir)));
+
+    auto second = Catalog::update(repoDir);
+    ASSERT_TRUE(second.success);
+    EXPECT_EQ(second.parsed, 0u);
+    EXPECT_EQ(second.unchanged, 3u);
+
+    // Rewrite one package, remove another, add a third
+    createPackage("a.lgx", "alpha", "1.1.0");
+    fs::remove(c);
+    createPackage("d.lgx", "delta", "0.1.0");
+
+    auto third = Catalog::update(repoDir);
+    ASSERT_TRUE(third.success);
+    EXPECT_EQ(third.scanned, 3u);
+    EXPECT_EQ(third.parsed, 2u);
+    EXPECT_EQ(third.unchanged, 1u);
+    EXPECT_EQ(third.removed, 1u);
+
+    auto catalog = Catalog::open(repoDir);
+    ASSERT_TRUE(catalog.has_value());
+    auto all = catalog->find({});
+    ASSERT_TRUE(all.has_value());
+    EXPECT_EQ(versionsOf(*all),
+              (std::vector<std::string>{"alpha@1.1.0", "beta@1.0.0", "delta@0.1.0"}));
+    EXPECT_EQ(catalog->entries()[2].path, "nested/b.lgx");
+
+    auto rebuilt = Catalog::update(repoDir, {}, true);
+    ASSERT_TRUE(rebuilt.success);
+    EXPECT_EQ(rebuilt.parsed, 3u);
+}
+
+TEST_F(CatalogTest, FindByNameRangeAndSigner) {
+    auto publisher = crypto::generateKeypair();
+    auto other = crypto::generateKeypair();
+    std::string publisherDid = crypto::publicKeyToDid(publisher.publicKey);
+
+    Dependency dep("core");
+    dep.version = "^1.0";
+    createPackage("mod-1.0.0.lgx", "mod", "1.0.0", 16, &publisher);
+    createPackage("mod-1.4.2.lgx", "mod", "1.4.2", 16, &publisher, {dep});
+    createPackage("mod-2.0.0.lgx", "mod", "2.0.0", 16, &other);
+    createPackage("mod-1.5.0.lgx", "mod", "1.5.0");
+    createPackage("core.lgx", "core", "1.0.0");
+    ASSERT_TRUE(Catalog::update(repoDir).success);
+
+    auto catalog = Catalog::open(repoDir);
+    ASSERT_TRUE(catalog.has_value());
+
+    auto byName = catalog->find({"MOD", "", ""});
+    ASSERT_TRUE(byName.has_value());
+    EXPECT_EQ(versionsOf(*byName),
+              (std::vector<std::string>{"mod@2.0.0", "mod@1.5.0", "mod@1.4.2", "mod@1.0.0"}));
+
+    auto inRange = catalog->find({"mod", "^1.2", ""});
+    ASSERT_TRUE(inRange.has_value());
+    EXPECT_EQ(versionsOf(*inRange), (std::vector<std::string>{"mod@1.5.0", "mod@1.4.2"}));
+
+    auto signedBy = catalog->find({"mod", "^1", publisherDid});
+    ASSERT_TRUE(signedBy.has_value());
+    ASSERT_EQ(signedBy->size(), 2u);
+    EXPECT_EQ((*signedBy)[0]->version, "1.4.2");
+    ASSERT_EQ((*signedBy)[0]->dependencies.size(), 1u);
+    EXPECT_EQ((*signedBy)[0]->dependencies[0], dep);
+    EXPECT_FALSE((*signedBy)[0]->rootHash.empty());
+    EXPECT_EQ(catalog->packagePath(*(*signedBy)[0]), repoDir / "mod-1.4.2.lgx");
+
+    auto none = catalog->find({"missing", "", ""});
+    ASSERT_TRUE(none.has_value());
+    EXPECT_TRUE(none->empty());
+
+    EXPECT_FALSE(catalog->find({"mod", "not a range", ""}).has_value());
+}
+
+TEST_F(CatalogTest, RecordsPackagesThatCannotBeIndexed) {
+    createPackage("good.lgx", "good", "1.0.0");
+    std::ofstream(repoDir / "junk.lgx") << "not a package";
+
+    // A manifest.sig that does not match the manifest
+    auto kp = crypto::generateKeypair();
+    fs::path tampered = createPackage("tampered.lgx", "tampered", "1.0.0", 16, &kp);
+    auto pkg = Package::load(tampered);
+    ASSERT_TRUE(pkg.has_value());
+    auto tar = DeterministicTarWriter();
+    for (auto entry : pkg->getEntries()) {
+        if (entry.path == "manifest.json") {
+            auto manifest = Manifest::fromJson(std::string(entry.data.begin(), entry.data.end()));
+            ASSERT_TRUE(manifest.has_value());
+            manifest->version = "9.9.9";
+            std::string json = manifest->toJson();
+            entry.data.assign(json.begin(), json.end());
+        }
+        tar.addEntry(entry);
+    }
+    auto gz = GzipHandler::compress(tar.finalize());
+    std::ofstream(tampered, std::ios::binary | std::ios::trunc)
+        .write(reinterpret_cast<const char*>(gz.data()), static_cast<std::streamsize>(gz.size()));
+
+    auto result = Catalog::update(repoDir);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(result.scanned, 3u);
+    EXPECT_EQ(result.failed, 2u);
+
+    auto catalog = Catalog::open(repoDir);
+    ASSERT_TRUE(catalog.has_value());
+    ASSERT_EQ(catalog->entries().size(), 3u);
+    auto all = catalog->find({});
+    ASSERT_TRUE(all.has_value());
+    EXPECT_EQ(versionsOf(*all), (std::vector<std::string>{"good@1.0.0"}));
+
+    // Failures are remembered: nothing is re-read while the files are unchanged
+    auto again = Catalog::update(repoDir);
+    EXPECT_EQ(again.parsed, 0u);
+    EXPECT_EQ(again.failed, 2u);
+}
+
+TEST_F(CatalogTest, CorruptIndexIsRebuilt) {
+    createPackage("a.lgx", "alpha", "1.0.0");
+    std::ofstream(Catalog::defaultIndexPath(repoDir)) << "{not json\n";
+
+    EXPECT_FALSE(Catalog::open(repoDir).has_value());
+
+    auto result = Catalog::update(repoDir);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(result.parsed, 1u);
+    EXPECT_TRUE(Catalog::open(repoDir).has_value());
+
+    EXPECT_FALSE(Catalog::update(tempDir / "missing").success);
+}
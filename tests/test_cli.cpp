@@ -4,6 +4,8 @@
 #include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <thread>
+#include <chrono>
 
 namespace fs = std::filesystem;
 
@@ -50,8 +52,9 @@ protected:
     }
     
     // Helper to run lgx command
-    int runLgx(const std::string& args, std::string* output = nullptr) {
-        std::string cmd = lgxBinary.string() + " " + args;
+    int runLgx(const std::string& args, std::string* output = nullptr,
+               const std::string& envPrefix = "") {
+        std::string cmd = envPrefix + lgxBinary.string() + " " + args;
         if (output) {
             cmd += " 2>&1";
             FILE* pipe = popen(cmd.c_str(), "r");
@@ -111,6 +114,27 @@ TEST_F(CLITest, VerifyCommand_InvalidPackage) {
     EXPECT_FALSE(output.empty());  // Should have error message
 }
 
+// Test: lgx verify <pkg> --level structure|hashes|bogus
+// Verifies the lighter levels report what they skipped and that an unknown
+// level is rejected
+// Commands: lgx create, lgx verify
+TEST_F(CLITest, VerifyCommand_Level) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    runLgx("create " + (tempDir / "test").string());
+
+    std::string output;
+    EXPECT_EQ(runLgx("verify " + pkgPath.string() + " --level structure", &output), 0);
+    EXPECT_NE(output.find("--level structure"), std::string::npos);
+
+    output.clear();
+    EXPECT_EQ(runLgx("verify " + pkgPath.string() + " --level hashes", &output), 0);
+    EXPECT_NE(output.find("Content hashes match"), std::string::npos);
+
+    output.clear();
+    EXPECT_NE(runLgx("verify " + pkgPath.string() + " --level bogus", &output), 0);
+    EXPECT_NE(output.find("bogus"), std::string::npos);
+}
+
 // Test: lgx add <pkg> --variant <v> --files <single-file> -y
 // Verifies adding a single file to a variant and that package remains valid
 // Commands: lgx create, lgx add, lgx verify
@@ -200,6 +224,86 @@ TEST_F(CLITest, AddCommand_ReplacesVariant) {
     EXPECT_EQ(exitCode, 0);
 }
 
+// Test: lgx add with the inputs the variant already holds
+// Verifies the package file is left untouched and its signature kept
+// Commands: lgx create, lgx add, lgx keygen, lgx sign, lgx verify
+TEST_F(CLITest, AddCommand_IdenticalInputsLeavePackageUntouched) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    fs::path lib = tempDir / "lib.so";
+    fs::path keysDir = tempDir / "keys";
+
+    runLgx("create " + (tempDir / "test").string());
+    std::ofstream(lib) << "payload";
+    std::string add = "add " + pkgPath.string() + " -v linux-amd64 -f " + lib.string() + " -y";
+    ASSERT_EQ(runLgx(add), 0);
+    runLgx("keygen --name testkey --output-dir " + keysDir.string());
+    ASSERT_EQ(runLgx("sign " + pkgPath.string() + " --key testkey --keys-dir " + keysDir.string()), 0);
+
+    // Backdate the file, so a rewrite would show in its mtime
+    auto stamp = fs::last_write_time(pkgPath) - std::chrono::hours(1);
+    fs::last_write_time(pkgPath, stamp);
+    auto size = fs::file_size(pkgPath);
+
+    std::string output;
+    EXPECT_EQ(runLgx(add, &output), 0);
+    EXPECT_NE(output.find("unchanged"), std::string::npos) << output;
+    EXPECT_EQ(fs::last_write_time(pkgPath), stamp);
+    EXPECT_EQ(fs::file_size(pkgPath), size);
+
+    // Nothing would be replaced, so there is nothing to confirm either
+    std::string unconfirmed = "add " + pkgPath.string() + " -v linux-amd64 -f " + lib.string();
+    output.clear();
+    EXPECT_EQ(runLgx(unconfirmed + " < /dev/null", &output), 0) << output;
+    EXPECT_EQ(output.find("will be replaced"), std::string::npos) << output;
+    EXPECT_NE(output.find("unchanged"), std::string::npos) << output;
+    EXPECT_EQ(fs::last_write_time(pkgPath), stamp);
+
+    output.clear();
+    EXPECT_EQ(runLgx("signature " + pkgPath.string(), &output), 0);
+    EXPECT_NE(output.find("\"signature\""), std::string::npos) << output;
+
+    // New content is written as before
+    std::ofstream(lib) << "payload v2";
+    output.clear();
+    EXPECT_EQ(runLgx(add, &output), 0);
+    EXPECT_NE(output.find("Replaced"), std::string::npos) << output;
+    EXPECT_NE(fs::last_write_time(pkgPath), stamp);
+}
+
+// Test: lgx add with identical inputs but a new --view
+// Verifies the manifest change drops the signature instead of leaving one
+// that no longer matches
+// Commands: lgx create, lgx add, lgx keygen, lgx sign, lgx verify, lgx signature
+TEST_F(CLITest, AddCommand_ViewChangeClearsSignature) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    fs::path lib = tempDir / "lib.so";
+    fs::path keysDir = tempDir / "keys";
+    std::string env = "XDG_CONFIG_HOME=" + (tempDir / "config").string() + " ";
+
+    runLgx("create " + (tempDir / "test").string());
+    std::ofstream(lib) << "payload";
+    std::string add = "add " + pkgPath.string() + " -v linux-amd64 -f " + lib.string() + " -y";
+    ASSERT_EQ(runLgx(add), 0);
+    runLgx("keygen --name testkey --output-dir " + keysDir.string());
+    ASSERT_EQ(runLgx("sign " + pkgPath.string() + " --key testkey --keys-dir " + keysDir.string()), 0);
+    std::string output;
+    ASSERT_EQ(runLgx("verify " + pkgPath.string(), &output, env), 0) << output;
+
+    output.clear();
+    EXPECT_EQ(runLgx(add + " --view a.qml", &output), 0) << output;
+    EXPECT_NE(output.find("Replaced"), std::string::npos) << output;
+
+    output.clear();
+    EXPECT_EQ(runLgx("verify " + pkgPath.string(), &output, env), 0) << output;
+    EXPECT_EQ(output.find("FAILED"), std::string::npos) << output;
+    output.clear();
+    EXPECT_EQ(runLgx("signature " + pkgPath.string(), &output), 0);
+    EXPECT_TRUE(output.empty()) << "the stale signature must be gone; got: " << output;
+    output.clear();
+    EXPECT_EQ(runLgx("manifest " + pkgPath.string() + " --json", &output), 0);
+    EXPECT_NE(output.find("a.qml"), std::string::npos) << output;
+}
+
 // Test: lgx remove <pkg> --variant <v> -y
 // Verifies removing a variant from a package
 // Commands: lgx create, lgx add, lgx remove, lgx verify
@@ -454,6 +558,34 @@ TEST_F(CLITest, MergeCommand_BasicMerge) {
     EXPECT_EQ(exitCode, 0);
 }
 
+// Test: lgx merge into an output that already holds the merged content
+// Verifies the output is not rewritten
+TEST_F(CLITest, MergeCommand_UnchangedOutputNotRewritten) {
+    fs::path pkg1 = tempDir / "pkg1.lgx";
+    fs::path pkg2 = tempDir / "pkg2.lgx";
+    fs::path merged = tempDir / "merged.lgx";
+
+    createSingleVariantPackage(lgxBinary.string(), pkg1, "test", "linux-amd64", "linux lib");
+    createSingleVariantPackage(lgxBinary.string(), pkg2, "test", "darwin-arm64", "darwin lib");
+    std::string merge = "merge " + pkg1.string() + " " + pkg2.string() + " -o " + merged.string() + " -y";
+    ASSERT_EQ(runLgx(merge), 0);
+
+    auto stamp = fs::last_write_time(merged) - std::chrono::hours(1);
+    fs::last_write_time(merged, stamp);
+
+    std::string output;
+    EXPECT_EQ(runLgx(merge, &output), 0);
+    EXPECT_NE(output.find("unchanged"), std::string::npos) << output;
+    EXPECT_EQ(fs::last_write_time(merged), stamp);
+
+    // A different set of variants rewrites it
+    output.clear();
+    EXPECT_EQ(runLgx("merge " + pkg1.string() + " " + pkg1.string() + " -o " + merged.string() +
+                     " -y --skip-duplicates", &output), 0);
+    EXPECT_NE(output.find("Merged"), std::string::npos) << output;
+    EXPECT_NE(fs::last_write_time(merged), stamp);
+}
+
 // Test: lgx merge with duplicate variants (should fail)
 TEST_F(CLITest, MergeCommand_DuplicateVariantsFails) {
     fs::path pkg1 = tempDir / "pkg1.lgx";
@@ -586,6 +718,501 @@ TEST_F(CLITest, MultiVariantWorkflow) {
     EXPECT_NE(output.find("valid"), std::string::npos);
 }
 
+// Test: --stats on any command
+// Verifies the text and JSON reports list the phases the command ran
+TEST_F(CLITest, StatsFlag) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    fs::path libFile = tempDir / "lib.so";
+    runLgx("create " + (tempDir / "test").string());
+    std::ofstream(libFile) << "library";
+    runLgx("add " + pkgPath.string() + " -v linux-amd64 -f " + libFile.string() + " -y");
+
+    std::string output;
+    int exitCode = runLgx("verify " + pkgPath.string() + " --stats", &output);
+    EXPECT_EQ(exitCode, 0);
+    EXPECT_NE(output.find("valid"), std::string::npos);
+    EXPECT_NE(output.find("inflate"), std::string::npos);
+    EXPECT_NE(output.find("tar_parse"), std::string::npos);
+    EXPECT_NE(output.find("peak buffer"), std::string::npos);
+
+    output.clear();
+    fs::path outDir = tempDir / "out";
+    exitCode = runLgx("extract " + pkgPath.string() + " -o " + outDir.string() +
+                      " --stats=json", &output);
+    EXPECT_EQ(exitCode, 0);
+    EXPECT_NE(output.find("\"extract\""), std::string::npos);
+    EXPECT_NE(output.find("\"peak_buffer_bytes\""), std::string::npos);
+}
+
+// Test: lgx extract --update
+// Verifies a second update of the same package writes nothing
+TEST_F(CLITest, ExtractCommand_Update) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    fs::path dist = tempDir / "dist";
+    fs::create_directories(dist);
+    std::ofstream(dist / "lib.so") << "lib";
+    std::ofstream(dist / "data.bin") << "data";
+    runLgx("create " + (tempDir / "test").string());
+    ASSERT_EQ(runLgx("add " + pkgPath.string() + " -v linux-amd64 -f " + dist.string() +
+                     " -m lib.so -y"), 0);
+
+    fs::path outDir = tempDir / "out";
+    std::string output;
+    int exitCode = runLgx("extract " + pkgPath.string() + " -o " + outDir.string() + " --update", &output);
+    EXPECT_EQ(exitCode, 0) << output;
+    EXPECT_NE(output.find("2 written, 0 unchanged, 0 removed"), std::string::npos) << output;
+    EXPECT_TRUE(fs::exists(outDir / "linux-amd64/data.bin"));
+
+    output.clear();
+    exitCode = runLgx("extract " + pkgPath.string() + " -v linux-amd64 -o " + outDir.string() +
+                      " --update", &output);
+    EXPECT_EQ(exitCode, 0) << output;
+    EXPECT_NE(output.find("already up to date"), std::string::npos) << output;
+
+    output.clear();
+    exitCode = runLgx("extract " + pkgPath.string() + " -o " + outDir.string() +
+                      " --update --include '*.so'", &output);
+    EXPECT_NE(exitCode, 0);
+}
+
+// Test: lgx check-installed
+// Verifies an extracted tree is checked against the signed manifest alone
+TEST_F(CLITest, CheckInstalledCommand) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    fs::path dist = tempDir / "dist";
+    fs::path keysDir = tempDir / "keys";
+    fs::create_directories(dist / "lib");
+    std::ofstream(dist / "lib/libfoo.so") << "lib";
+    std::ofstream(dist / "readme.txt") << "readme";
+    runLgx("create " + (tempDir / "test").string());
+    ASSERT_EQ(runLgx("add " + pkgPath.string() + " -v linux-amd64 -f " + dist.string() +
+                     " -m lib/libfoo.so -y"), 0);
+    runLgx("keygen --name testkey --output-dir " + keysDir.string());
+    ASSERT_EQ(runLgx("sign " + pkgPath.string() + " --key testkey --keys-dir " + keysDir.string()), 0);
+    fs::path manifest = tempDir / "manifest.json";
+    fs::path signature = tempDir / "manifest.sig";
+    ASSERT_EQ(runLgx("manifest " + pkgPath.string() + " --json > " + manifest.string()), 0);
+    ASSERT_EQ(runLgx("signature " + pkgPath.string() + " > " + signature.string()), 0);
+    fs::path outDir = tempDir / "out";
+    ASSERT_EQ(runLgx("extract " + pkgPath.string() + " -o " + outDir.string() + " --update"), 0);
+    fs::path installed = outDir / "linux-amd64";
+
+    std::string output;
+    int exitCode = runLgx("check-installed " + installed.string() + " --manifest " + manifest.string() +
+                          " --signature " + signature.string(), &output);
+    EXPECT_EQ(exitCode, 0) << output;
+    EXPECT_NE(output.find("Manifest signature is valid"), std::string::npos) << output;
+    EXPECT_NE(output.find("matches variant 'linux-amd64'"), std::string::npos) << output;
+
+    std::ofstream(installed / "readme.txt") << "tampered";
+    output.clear();
+    exitCode = runLgx("check-installed " + installed.string() + " --manifest " + manifest.string(), &output);
+    EXPECT_EQ(exitCode, 1) << output;
+    EXPECT_NE(output.find("does NOT match"), std::string::npos) << output;
+    EXPECT_NE(output.find("modified:   readme.txt"), std::string::npos) << output;
+
+    // A manifest edited after signing is rejected before the tree is checked
+    std::string text;
+    {
+        std::ifstream in(manifest);
+        text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    text.replace(text.find("\"0.0.1\""), 7, "\"9.9.9\"");
+    std::ofstream(manifest) << text;
+    output.clear();
+    exitCode = runLgx("check-installed " + installed.string() + " --manifest " + manifest.string() +
+                      " --signature " + signature.string(), &output);
+    EXPECT_EQ(exitCode, 1) << output;
+    EXPECT_NE(output.find("Signature verification FAILED"), std::string::npos) << output;
+}
+
+// Test: lgx stats
+// Verifies the text and JSON reports and the --top check
+TEST_F(CLITest, StatsCommand) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    fs::path dist = tempDir / "dist";
+    fs::create_directories(dist / "lib");
+    std::ofstream(dist / "lib/libfoo.so") << "lib";
+    runLgx("create " + (tempDir / "test").string());
+    ASSERT_EQ(runLgx("add " + pkgPath.string() + " -v linux-amd64 -f " + dist.string() +
+                     " -m lib/libfoo.so -y"), 0);
+
+    std::string output;
+    int exitCode = runLgx("stats " + pkgPath.string(), &output);
+    EXPECT_EQ(exitCode, 0) << output;
+    EXPECT_NE(output.find("linux-amd64"), std::string::npos) << output;
+    EXPECT_NE(output.find("variants/linux-amd64/lib/libfoo.so"), std::string::npos) << output;
+
+    output.clear();
+    exitCode = runLgx("stats " + pkgPath.string() + " --probe --json", &output);
+    EXPECT_EQ(exitCode, 0) << output;
+    EXPECT_NE(output.find("\"probed\": true"), std::string::npos) << output;
+    EXPECT_NE(output.find("\"incompressible\""), std::string::npos) << output;
+
+    EXPECT_NE(runLgx("stats " + pkgPath.string() + " --top x"), 0);
+    EXPECT_NE(runLgx("stats " + (tempDir / "missing.lgx").string()), 0);
+}
+
+// Test: lgx extract --durable
+// Verifies a durable extraction replaces the variant tree as a whole
+TEST_F(CLITest, ExtractCommand_Durable) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    fs::path dist = tempDir / "dist";
+    fs::create_directories(dist / "lib");
+    std::ofstream(dist / "lib/libfoo.so") << "lib";
+    runLgx("create " + (tempDir / "test").string());
+    ASSERT_EQ(runLgx("add " + pkgPath.string() + " -v linux-amd64 -f " + dist.string() +
+                     " -m lib/libfoo.so -y"), 0);
+
+    fs::path outDir = tempDir / "out";
+    fs::create_directories(outDir / "linux-amd64");
+    std::ofstream(outDir / "linux-amd64/stray.txt") << "stray";
+    std::string output;
+    int exitCode = runLgx("extract " + pkgPath.string() + " -o " + outDir.string() + " --durable", &output);
+    EXPECT_EQ(exitCode, 0) << output;
+    EXPECT_TRUE(fs::exists(outDir / "linux-amd64/lib/libfoo.so"));
+    EXPECT_FALSE(fs::exists(outDir / "linux-amd64/stray.txt"));
+
+    output.clear();
+    exitCode = runLgx("extract " + pkgPath.string() + " -o " + outDir.string() + " --durable --update", &output);
+    EXPECT_EQ(exitCode, 0) << output;
+    EXPECT_NE(output.find("already up to date"), std::string::npos) << output;
+
+    output.clear();
+    exitCode = runLgx("extract " + pkgPath.string() + " -o " + outDir.string() +
+                      " --durable --include 'lib/*'", &output);
+    EXPECT_NE(exitCode, 0);
+    EXPECT_NE(output.find("--durable cannot be combined"), std::string::npos) << output;
+}
+
+// Test: lgx extract --include / --exclude
+// Verifies only matching files are written, and directories only for them
+TEST_F(CLITest, ExtractCommand_Filtered) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    fs::path dist = tempDir / "dist";
+    fs::create_directories(dist / "lib");
+    fs::create_directories(dist / "docs");
+    std::ofstream(dist / "lib/libfoo.so") << "lib";
+    std::ofstream(dist / "lib/libfoo.so.debug") << "symbols";
+    std::ofstream(dist / "docs/readme.txt") << "readme";
+    runLgx("create " + (tempDir / "test").string());
+    ASSERT_EQ(runLgx("add " + pkgPath.string() + " -v linux-amd64 -f " + dist.string() +
+                     " -m lib/libfoo.so -y"), 0);
+
+    fs::path outDir = tempDir / "out";
+    std::string output;
+    int exitCode = runLgx("extract " + pkgPath.string() + " -v linux-amd64 -o " + outDir.string() +
+                          " --include 'lib,*.txt' --exclude '*.debug'", &output);
+    EXPECT_EQ(exitCode, 0) << output;
+    EXPECT_NE(output.find("2 of 3 files matched"), std::string::npos) << output;
+    EXPECT_TRUE(fs::exists(outDir / "linux-amd64/lib/libfoo.so"));
+    EXPECT_TRUE(fs::exists(outDir / "linux-amd64/docs/readme.txt"));
+    EXPECT_FALSE(fs::exists(outDir / "linux-amd64/lib/libfoo.so.debug"));
+
+    // Nothing matched: nothing written, not even the variant directory
+    output.clear();
+    fs::path emptyOut = tempDir / "empty";
+    exitCode = runLgx("extract " + pkgPath.string() + " -o " + emptyOut.string() +
+                      " --include '*.qm'", &output);
+    EXPECT_EQ(exitCode, 0) << output;
+    EXPECT_NE(output.find("0 of 3 files matched"), std::string::npos) << output;
+    EXPECT_FALSE(fs::exists(emptyOut / "linux-amd64"));
+}
+
+// Test: --trace <file> as a global option
+// Verifies a Chrome Trace Event file is written with the command's spans
+TEST_F(CLITest, TraceOption) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    fs::path tracePath = tempDir / "trace.json";
+    runLgx("create " + (tempDir / "test").string());
+
+    std::string output;
+    int exitCode = runLgx("--trace " + tracePath.string() + " verify " + pkgPath.string(), &output);
+    EXPECT_EQ(exitCode, 0);
+    EXPECT_NE(output.find("valid"), std::string::npos);
+    ASSERT_TRUE(fs::exists(tracePath));
+
+    std::ifstream file(tracePath);
+    std::stringstream content;
+    content << file.rdbuf();
+    EXPECT_NE(content.str().find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(content.str().find("\"package.verify\""), std::string::npos);
+    EXPECT_NE(content.str().find("\"merkle.tree\""), std::string::npos);
+
+    exitCode = runLgx("verify " + pkgPath.string() + " --trace", &output);
+    EXPECT_NE(exitCode, 0);
+}
+
+// Test: forwarded sign/verify use the client's default key directories,
+// not the daemon's
+TEST_F(CLITest, ServeForwardsClientKeyDirectories) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    fs::path libFile = tempDir / "lib.so";
+    fs::path socketPath = tempDir / "lgx.sock";
+    runLgx("create " + (tempDir / "test").string());
+    std::ofstream(libFile) << "library";
+    runLgx("add " + pkgPath.string() + " -v linux-amd64 -f " + libFile.string() + " -y");
+
+    std::string clientEnv = "XDG_CONFIG_HOME=" + (tempDir / "client-config").string() + " ";
+    std::string daemonEnv = "XDG_CONFIG_HOME=" + (tempDir / "daemon-config").string() + " ";
+    std::string output;
+    ASSERT_EQ(runLgx("keygen --name publisher", &output, clientEnv), 0) << output;
+    size_t didStart = output.find("did:jwk:");
+    ASSERT_NE(didStart, std::string::npos) << output;
+    std::string did = output.substr(didStart, output.find_first_of(" \n", didStart) - didStart);
+    ASSERT_EQ(runLgx("keyring add publisher " + did, nullptr, clientEnv), 0);
+
+    ASSERT_EQ(runLgx("serve --socket " + socketPath.string() + " > /dev/null 2>&1 &", nullptr,
+                     daemonEnv), 0);
+    for (int i = 0; i < 100 && !fs::exists(socketPath); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_TRUE(fs::exists(socketPath));
+    std::string forwardEnv = clientEnv + "LGX_DAEMON_SOCKET=" + socketPath.string() + " ";
+
+    output.clear();
+    EXPECT_EQ(runLgx("sign " + pkgPath.string() + " --key publisher", &output, forwardEnv), 0)
+        << output;
+
+    std::string local;
+    std::string forwarded;
+    EXPECT_EQ(runLgx("verify " + pkgPath.string(), &local, clientEnv), 0);
+    EXPECT_EQ(runLgx("verify " + pkgPath.string(), &forwarded, forwardEnv), 0);
+    EXPECT_NE(local.find("Signer is trusted: publisher"), std::string::npos) << local;
+    EXPECT_EQ(forwarded, local);
+
+    EXPECT_EQ(runLgx("serve --socket " + socketPath.string() + " --stop"), 0);
+}
+
+// Test: lgx serve + thin client mode
+// Verifies forwarded commands print the same output as local runs
+TEST_F(CLITest, ServeAndForward) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    fs::path libFile = tempDir / "lib.so";
+    fs::path socketPath = tempDir / "lgx.sock";
+    runLgx("create " + (tempDir / "test").string());
+    std::ofstream(libFile) << "library";
+    runLgx("add " + pkgPath.string() + " -v linux-amd64 -f " + libFile.string() + " -y");
+
+    std::string local;
+    ASSERT_EQ(runLgx("verify " + pkgPath.string(), &local), 0);
+
+    ASSERT_EQ(runLgx("serve --socket " + socketPath.string() + " > /dev/null 2>&1 &"), 0);
+    for (int i = 0; i < 100 && !fs::exists(socketPath); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_TRUE(fs::exists(socketPath));
+
+    std::string env = "LGX_DAEMON_SOCKET=" + socketPath.string() + " ";
+    std::string forwarded;
+    EXPECT_EQ(runLgx("verify " + pkgPath.string(), &forwarded, env), 0);
+    EXPECT_EQ(forwarded, local);
+
+    std::string manifest;
+    EXPECT_EQ(runLgx("manifest " + pkgPath.string() + " --json", &manifest, env), 0);
+    EXPECT_NE(manifest.find("\"linux-amd64\""), std::string::npos);
+
+    fs::path outDir = tempDir / "out";
+    std::string output;
+    EXPECT_EQ(runLgx("extract " + pkgPath.string() + " -o " + outDir.string(), &output, env), 0);
+    EXPECT_TRUE(fs::exists(outDir / "linux-amd64" / "lib.so"));
+
+    EXPECT_EQ(runLgx("serve --socket " + socketPath.string() + " --stop"), 0);
+    for (int i = 0; i < 100 && fs::exists(socketPath); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    EXPECT_FALSE(fs::exists(socketPath));
+
+    // With the daemon gone the CLI silently runs locally
+    forwarded.clear();
+    EXPECT_EQ(runLgx("verify " + pkgPath.string(), &forwarded, env), 0);
+    EXPECT_EQ(forwarded, local);
+}
+
+// Test: lgx bench
+// Verifies every stage is reported and the scratch extract directory is removed
+TEST_F(CLITest, BenchCommand) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    fs::path libFile = tempDir / "lib.so";
+    fs::path outDir = tempDir / "out";
+    runLgx("create " + (tempDir / "test").string());
+    std::ofstream(libFile) << "library";
+    runLgx("add " + pkgPath.string() + " -v linux-amd64 -f " + libFile.string() + " -y");
+
+    std::string output;
+    int exitCode = runLgx("bench " + pkgPath.string() + " -n 2 -o " + outDir.string(), &output);
+    EXPECT_EQ(exitCode, 0);
+    for (const char* stage : {"load", "decompress", "tar_parse", "validate", "merkle", "extract",
+                              "Peak RSS"}) {
+        EXPECT_NE(output.find(stage), std::string::npos) << stage;
+    }
+    EXPECT_EQ(output.find("verify_signature"), std::string::npos);  // unsigned
+    EXPECT_TRUE(fs::is_empty(outDir));
+
+    output.clear();
+    exitCode = runLgx("bench " + pkgPath.string() + " -n 1 -o " + outDir.string() +
+                      " --variant linux-amd64 --json", &output);
+    EXPECT_EQ(exitCode, 0);
+    EXPECT_NE(output.find("\"files_per_s\""), std::string::npos);
+    EXPECT_NE(output.find("\"peak_rss_bytes\""), std::string::npos);
+    EXPECT_NE(output.find("\"system\""), std::string::npos);
+
+    EXPECT_NE(runLgx("bench " + pkgPath.string() + " -n 0", &output), 0);
+    EXPECT_NE(runLgx("bench " + pkgPath.string() + " --variant nope", &output), 0);
+}
+
+TEST_F(CLITest, CatalogCommand) {
+    fs::path repo = tempDir / "repo";
+    fs::create_directories(repo);
+    ASSERT_TRUE(lgx::Package::create(repo / "alpha.lgx", "alpha").success);
+    ASSERT_TRUE(lgx::Package::create(repo / "beta.lgx", "beta").success);
+
+    std::string output;
+    EXPECT_EQ(runLgx("catalog query " + repo.string(), &output), 1);  // no index yet
+
+    output.clear();
+    EXPECT_EQ(runLgx("catalog build " + repo.string(), &output), 0);
+    EXPECT_NE(output.find("Indexed 2 package(s)"), std::string::npos) << output;
+    EXPECT_TRUE(fs::exists(repo / ".lgx-catalog.jsonl"));
+
+    output.clear();
+    EXPECT_EQ(runLgx("catalog update " + repo.string() + " --json", &output), 0);
+    EXPECT_NE(output.find("\"unchanged\": 2"), std::string::npos) << output;
+
+    output.clear();
+    EXPECT_EQ(runLgx("catalog query " + repo.string() + " --name alpha --version '>=0.0.1'", &output), 0);
+    EXPECT_NE(output.find("alpha 0.0.1"), std::string::npos) << output;
+    EXPECT_EQ(output.find("beta"), std::string::npos);
+
+    output.clear();
+    EXPECT_EQ(runLgx("catalog query " + repo.string() + " --json", &output), 0);
+    EXPECT_NE(output.find("\"name\": \"beta\""), std::string::npos) << output;
+
+    EXPECT_NE(runLgx("catalog query " + repo.string() + " --version '^^'", &output), 0);
+    EXPECT_NE(runLgx("catalog frobnicate " + repo.string(), &output), 0);
+}
+
+TEST_F(CLITest, ResolveCommand) {
+    fs::path repo = tempDir / "repo";
+    fs::create_directories(repo);
+    auto makePackage = [&](const std::string& name, const std::string& version,
+                           std::vector<lgx::Dependency> deps) {
+        fs::path path = repo / (name + "-" + version + ".lgx");
+        ASSERT_TRUE(lgx::Package::create(path, name).success);
+        auto pkg = lgx::Package::load(path);
+        ASSERT_TRUE(pkg.has_value());
+        pkg->getManifest().version = version;
+        pkg->getManifest().dependencies = std::move(deps);
+        ASSERT_TRUE(pkg->save(path).success);
+    };
+    lgx::Dependency net("net");
+    net.version = "^1";
+    makePackage("app", "1.0.0", {net});
+    makePackage("net", "1.2.0", {});
+    makePackage("net", "2.0.0", {});
+
+    std::string output;
+    EXPECT_NE(runLgx("resolve " + repo.string() + " app", &output), 0);  // no index yet
+    ASSERT_EQ(runLgx("catalog update " + repo.string(), &output), 0);
+
+    output.clear();
+    EXPECT_EQ(runLgx("resolve " + repo.string() + " app", &output), 0);
+    EXPECT_NE(output.find("net 1.2.0"), std::string::npos) << output;
+    EXPECT_EQ(output.find("2.0.0"), std::string::npos) << output;
+
+    output.clear();
+    EXPECT_EQ(runLgx("resolve " + repo.string() + " --from " +
+                     (repo / "app-1.0.0.lgx").string() + " --json", &output), 0);
+    EXPECT_NE(output.find("\"version\": \"1.2.0\""), std::string::npos) << output;
+
+    output.clear();
+    EXPECT_EQ(runLgx("resolve " + repo.string() + " app 'net@>=2'", &output), 1);
+    EXPECT_NE(output.find("net ^1 (required by app 1.0.0)"), std::string::npos) << output;
+    EXPECT_NE(runLgx("resolve " + repo.string(), &output), 0);
+}
+
+TEST_F(CLITest, LockAndVerifyAgainstLock) {
+    fs::path net = tempDir / "net.lgx";
+    fs::path ui = tempDir / "ui.lgx";
+    ASSERT_TRUE(lgx::Package::create(net, "net").success);
+    ASSERT_TRUE(lgx::Package::create(ui, "ui").success);
+    fs::path lockPath = tempDir / "lgx.lock";
+
+    std::string output;
+    EXPECT_EQ(runLgx("lock " + net.string() + " --lockfile " + lockPath.string(), &output), 0);
+    EXPECT_NE(output.find("Locked 1 package(s)"), std::string::npos) << output;
+    ASSERT_TRUE(fs::exists(lockPath));
+
+    output.clear();
+    EXPECT_EQ(runLgx("verify " + net.string() + " --lock " + lockPath.string(), &output), 0);
+    EXPECT_NE(output.find("matches lock entry: net 0.0.1"), std::string::npos) << output;
+
+    // Unlocked packages get the full verification
+    output.clear();
+    EXPECT_EQ(runLgx("verify " + ui.string() + " --lock " + lockPath.string(), &output), 0);
+    EXPECT_NE(output.find("running full verification"), std::string::npos) << output;
+    EXPECT_NE(output.find("Package structure is valid"), std::string::npos) << output;
+
+    // Rewrite net with another version: the lock rejects it
+    auto pkg = lgx::Package::load(net);
+    ASSERT_TRUE(pkg.has_value());
+    pkg->getManifest().version = "0.0.2";
+    ASSERT_TRUE(pkg->save(net).success);
+    output.clear();
+    EXPECT_EQ(runLgx("verify " + net.string() + " --lock " + lockPath.string(), &output), 1);
+    EXPECT_NE(output.find("does not match lock entry for 'net'"), std::string::npos) << output;
+
+    // Relocking updates the entry
+    EXPECT_EQ(runLgx("lock " + net.string() + " " + ui.string() + " --lockfile " +
+                     lockPath.string(), &output), 0);
+    EXPECT_EQ(runLgx("verify " + net.string() + " --lock " + lockPath.string(), &output), 0);
+
+    std::ofstream(tempDir / "junk.lgx") << "junk";
+    EXPECT_NE(runLgx("lock " + (tempDir / "junk.lgx").string() + " --lockfile " +
+                     lockPath.string(), &output), 0);
+}
+
+TEST_F(CLITest, BuildCommand) {
+    fs::create_directories(tempDir / "linux");
+    std::ofstream(tempDir / "linux" / "mod.so") << "linux library";
+    std::ofstream(tempDir / "mod.dylib") << "darwin library";
+    std::ofstream(tempDir / "LICENSE") << "MIT";
+
+    // create + add, the way packages were built before
+    fs::path expected = tempDir / "mymod.lgx";
+    ASSERT_EQ(runLgx("create " + (tempDir / "mymod").string()), 0);
+    ASSERT_EQ(runLgx("add " + expected.string() + " --variant linux-amd64 --files " +
+                     (tempDir / "linux").string() + " --main mod.so -y"), 0);
+    ASSERT_EQ(runLgx("add " + expected.string() + " --variant darwin-arm64 --files " +
+                     (tempDir / "mod.dylib").string() + " -y"), 0);
+
+    // lgx create names the package after its argument
+    std::ofstream(tempDir / "build.json") << "{\"name\": \"" << (tempDir / "mymod").string() << "\", "
+        "\"variants\": {\"linux-amd64\": {\"files\": \"linux\", \"main\": \"mod.so\"}, "
+        "\"darwin-arm64\": \"mod.dylib\"}, \"output\": \"built.lgx\"}";
+
+    std::string output;
+    EXPECT_EQ(runLgx("build " + (tempDir / "build.json").string(), &output), 0) << output;
+    EXPECT_NE(output.find("Built package"), std::string::npos) << output;
+
+    auto read = [](const fs::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    ASSERT_TRUE(fs::exists(tempDir / "built.lgx"));
+    EXPECT_EQ(read(tempDir / "built.lgx"), read(expected));
+
+    // --output overrides the spec
+    fs::path other = tempDir / "other.lgx";
+    EXPECT_EQ(runLgx("build " + (tempDir / "build.json").string() + " -o " + other.string()), 0);
+    EXPECT_EQ(read(other), read(expected));
+
+    std::ofstream(tempDir / "bad.json") << R"({"name": "x", "variants": {"linux": "missing"}})";
+    output.clear();
+    EXPECT_EQ(runLgx("build " + (tempDir / "bad.json").string(), &output), 1);
+    EXPECT_NE(output.find("Path does not exist"), std::string::npos) << output;
+}
+
 // ── lgx signature ────────────────────────────────────────────────────────
 //
 // Contract pinned by these tests:
@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+#include "core/package.h"
+#include "core/package_cache.h"
+#include "core/gzip_handler.h"
+#include "core/path_normalizer.h"
+#include "core/stats.h"
+#include "core/tar_reader.h"
+#include "core/tar_writer.h"
+#include "crypto/signing.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace lgx;
+
+// Complexity regression suite for untrusted .lgx input.
+//
+// Each test generates a worst-case archive and checks that every stage
+// handles it correctly and that memory grows linearly: at size N and 2N,
+// buffered and decoded bytes may grow by at most MAX_DOUBLING_RATIO. These
+// are exact counts, not timings; how run time scales on the same corpus is
+// measured by the BM_Adversarial* benchmarks (bench/bench_complexity.cpp).
+
+namespace {
+
+constexpr double MAX_DOUBLING_RATIO = 2.2;
+
+std::string errorsOf(const Package& pkg) {
+    std::string joined;
+    for (const auto& error : pkg.validatePackage().errors) {
+        joined += error + "\n";
+    }
+    return joined;
+}
+
+// Peak scratch buffer size while loading `gz`
+uint64_t peakBufferOfLoad(const std::vector<uint8_t>& gz) {
+    Stats::reset();
+    Stats::setEnabled(true);
+    auto pkg = Package::loadFromMemory(gz.data(), gz.size());
+    auto snapshot = Stats::snapshot();
+    Stats::setEnabled(false);
+    EXPECT_TRUE(pkg) << Package::getLastError();
+    return snapshot.peakBufferBytes;
+}
+
+/**
+ * Generators for the worst-case corpus. Every archive is a well-formed,
+ * correctly hashed package unless noted, so each stage runs to completion.
+ */
+struct Corpus {
+    /**
+     * Tar entries of a package with the given files (variant -> paths),
+     * including a manifest whose main and hashes match.
+     */
+    static std::vector<TarEntry> package(
+        const std::vector<std::pair<std::string, std::vector<std::string>>>& variants) {
+        std::vector<TarEntry> entries;
+        entries.emplace_back("variants", true, 0755);
+        Manifest manifest;
+        manifest.name = "adversarial";
+        manifest.version = "1.0.0";
+        for (const auto& [variant, files] : variants) {
+            entries.emplace_back("variants/" + variant, true, 0755);
+            for (const auto& file : files) {
+                entries.emplace_back("variants/" + variant + "/" + file, std::string("x"), 0644);
+            }
+            manifest.main[variant] = files.front();
+        }
+        manifest.hashes = crypto::computeMerkleTree(entries);
+        entries.emplace_back("manifest.json", manifest.toJson(), 0644);
+        return entries;
+    }
+
+    /** n variants of one file each, so n main entries. */
+    static std::vector<TarEntry> manyVariants(size_t n) {
+        std::vector<std::pair<std::string, std::vector<std::string>>> variants;
+        for (size_t i = 0; i < n; ++i) {
+            variants.push_back({"v" + std::to_string(i), {"lib.so"}});
+        }
+        return package(variants);
+    }
+
+    /** One variant holding n files. */
+    static std::vector<TarEntry> manyEntries(size_t n) {
+        std::vector<std::string> files;
+        for (size_t i = 0; i < n; ++i) {
+            files.push_back("d" + std::to_string(i % 16) + "/f" + std::to_string(i));
+        }
+        return package({{"linux-amd64", files}});
+    }
+
+    /** n files whose paths use the whole ustar name + prefix space. */
+    static std::vector<TarEntry> deepPaths(size_t n) {
+        std::vector<std::string> files;
+        for (size_t i = 0; i < n; ++i) {
+            std::string path;
+            while (path.size() < 200) {
+                path += "a/";
+            }
+            files.push_back(path + "f" + std::to_string(i));
+        }
+        return package({{"linux-amd64", files}});
+    }
+
+    static std::vector<uint8_t> tar(const std::vector<TarEntry>& entries) {
+        DeterministicTarWriter writer;
+        for (const auto& entry : entries) {
+            writer.addEntry(entry);
+        }
+        return writer.finalize();
+    }
+
+    static std::vector<uint8_t> gzip(std::vector<uint8_t> tarData, size_t zeroPadding = 0) {
+        tarData.resize(tarData.size() + zeroPadding, 0);
+        return GzipHandler::compress(tarData);
+    }
+
+    /**
+     * Raw tar of n empty files, each header followed by a single zero block
+     * (which read() tolerates), then a long zero tail.
+     */
+    static std::vector<uint8_t> zeroInterleaved(size_t n) {
+        std::vector<uint8_t> out;
+        for (size_t i = 0; i < n; ++i) {
+            DeterministicTarWriter writer;
+            writer.addFile("f" + std::to_string(i), std::string());
+            auto single = writer.finalize();
+            out.insert(out.end(), single.begin(), single.begin() + 512);  // header only
+            out.insert(out.end(), 512, 0);
+        }
+        out.insert(out.end(), 1024 * 1024, 0);
+        return out;
+    }
+};
+
+} // anonymous namespace
+
+TEST(ComplexityTest, MerkleTreeCoversEveryVariant) {
+    ASSERT_TRUE(crypto::init());
+    auto entries = Corpus::manyVariants(4000);
+    auto tree = crypto::computeMerkleTree(entries);
+    size_t variantHashes = std::count_if(tree.begin(), tree.end(), [](const auto& node) {
+        return node.first.rfind("variants/", 0) == 0;
+    });
+    EXPECT_EQ(variantHashes, 4000u);
+    EXPECT_EQ(tree.count("variants/v3999"), 1u);
+    EXPECT_EQ(tree.count("root"), 1u);
+}
+
+TEST(ComplexityTest, ValidatePackageWithManyMainEntries) {
+    std::vector<uint8_t> gz = Corpus::gzip(Corpus::tar(Corpus::manyVariants(4000)));
+    auto pkg = Package::loadFromMemory(gz.data(), gz.size());
+    ASSERT_TRUE(pkg) << Package::getLastError();
+    EXPECT_TRUE(pkg->validatePackage().valid) << errorsOf(*pkg);
+    EXPECT_EQ(pkg->getVariants().size(), 4000u);
+}
+
+TEST(ComplexityTest, DecodedSizeLinearInEntryCount) {
+    std::vector<uint8_t> gz1 = Corpus::gzip(Corpus::tar(Corpus::manyEntries(20000)));
+    std::vector<uint8_t> gz2 = Corpus::gzip(Corpus::tar(Corpus::manyEntries(40000)));
+    auto pkg1 = Package::loadFromMemory(gz1.data(), gz1.size());
+    auto pkg2 = Package::loadFromMemory(gz2.data(), gz2.size());
+    ASSERT_TRUE(pkg1 && pkg2);
+    EXPECT_EQ(pkg2->getVariants().size(), 1u);
+    EXPECT_FALSE(pkg2->hasVariant("missing"));
+
+    double m1 = static_cast<double>(PackageCache::decodedSize(*pkg1));
+    double m2 = static_cast<double>(PackageCache::decodedSize(*pkg2));
+    EXPECT_LT(m2 / m1, MAX_DOUBLING_RATIO);
+}
+
+TEST(ComplexityTest, LoadBufferLinearInEntryCount) {
+    std::vector<uint8_t> gz1 = Corpus::gzip(Corpus::tar(Corpus::manyEntries(20000)));
+    std::vector<uint8_t> gz2 = Corpus::gzip(Corpus::tar(Corpus::manyEntries(40000)));
+
+    double b1 = static_cast<double>(peakBufferOfLoad(gz1));
+    double b2 = static_cast<double>(peakBufferOfLoad(gz2));
+    ASSERT_GT(b1, 0);
+    EXPECT_LT(b2 / b1, MAX_DOUBLING_RATIO) << b1 << " -> " << b2 << " bytes";
+}
+
+TEST(ComplexityTest, DeepPaths) {
+    std::string deep;
+    for (int i = 0; i < 40000; ++i) deep += "a/";
+    EXPECT_EQ(PathNormalizer::splitPath(deep).size(), 40000u);
+    EXPECT_EQ(PathNormalizer::getRootComponent("./" + deep), "a");
+
+    // Packages made only of maximum-depth paths are accepted
+    std::vector<uint8_t> gz = Corpus::gzip(Corpus::tar(Corpus::deepPaths(6000)));
+    auto pkg = Package::loadFromMemory(gz.data(), gz.size());
+    ASSERT_TRUE(pkg) << Package::getLastError();
+    EXPECT_TRUE(pkg->validatePackage().valid) << errorsOf(*pkg);
+}
+
+TEST(ComplexityTest, ZeroBlocksBetweenHeaders) {
+    auto tarData = Corpus::zeroInterleaved(10000);
+    auto result = TarReader::read(tarData);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(result.entries.size(), 10000u);
+}
+
+TEST(ComplexityTest, ZeroPaddingDoesNotCostMemory) {
+    // A small package followed by 64 MiB of zeros compresses to ~64 KiB
+    auto tarData = Corpus::tar(Corpus::manyEntries(16));
+    auto padded = Corpus::gzip(tarData, 64 * 1024 * 1024);
+    ASSERT_LT(padded.size(), 1024u * 1024);
+
+    Stats::reset();
+    Stats::setEnabled(true);
+    auto pkg = Package::loadFromMemory(padded.data(), padded.size());
+    auto snapshot = Stats::snapshot();
+    Stats::setEnabled(false);
+
+    ASSERT_TRUE(pkg) << Package::getLastError();
+    EXPECT_TRUE(pkg->validatePackage().valid) << errorsOf(*pkg);
+    // The whole stream is still inflated (and its CRC checked)...
+    EXPECT_GE(snapshot[Stats::Phase::Inflate].bytesOut, 64u * 1024 * 1024);
+    // ...but only the archive itself is buffered: at most one extra chunk
+    EXPECT_LT(snapshot.peakBufferBytes, tarData.size() + 64 * 1024);
+}
+
+TEST(ComplexityTest, CorruptTrailerAfterPaddingStillRejected) {
+    auto padded = Corpus::gzip(Corpus::tar(Corpus::manyEntries(4)), 1024 * 1024);
+    padded[padded.size() - 6] ^= 0xff;  // CRC32 in the gzip trailer
+    EXPECT_FALSE(Package::loadFromMemory(padded.data(), padded.size()));
+}
+
+TEST(ComplexityTest, EndScannerMatchesReader) {
+    auto tarData = Corpus::tar(Corpus::manyEntries(50));
+    tarData.resize(tarData.size() + 4096, 0);
+
+    // Feed in uneven chunks, as the decompressor does
+    TarReader::EndScanner scanner;
+    size_t fed = 0;
+    while (fed < tarData.size() && !scanner.ended()) {
+        fed = std::min(tarData.size(), fed + 777);
+        scanner.scan(tarData.data(), fed);
+    }
+    ASSERT_TRUE(scanner.ended());
+
+    auto full = TarReader::read(tarData);
+    auto truncated = TarReader::read(tarData.data(), fed);
+    ASSERT_TRUE(full.success && truncated.success);
+    EXPECT_EQ(full.entries.size(), truncated.entries.size());
+
+    // A corrupt header stops the scan without reporting an end
+    tarData[0] ^= 0xff;
+    TarReader::EndScanner corrupt;
+    EXPECT_FALSE(corrupt.scan(tarData.data(), tarData.size()));
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "core/composition.h"
+#include "core/package.h"
+#include "crypto/signing.h"
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using namespace lgx;
+namespace fs = std::filesystem;
+
+class CompositionTest : public ::testing::Test {
+protected:
+    fs::path tempDir;
+    fs::path pkgPath;
+
+    void SetUp() override {
+        ASSERT_TRUE(crypto::init());
+        tempDir = fs::temp_directory_path() / ("lgx_composition_test_" + std::to_string(rand()));
+        fs::create_directories(tempDir);
+
+        // 8 KiB of noise in both variants, plus text that compresses well
+        std::mt19937 rng(7);
+        std::string noise(8192, '\0');
+        for (char& c : noise) {
+            c = static_cast<char>(rng());
+        }
+        std::string text(20000, 'a');
+        writeFile(tempDir / "linux/lib/libfoo.so", noise);
+        writeFile(tempDir / "linux/share/readme.txt", text);
+        writeFile(tempDir / "darwin/lib/deep/er/libfoo.dylib", noise);
+        writeFile(tempDir / "darwin/empty.txt", "");
+
+        pkgPath = tempDir / "pkg.lgx";
+        Package pkg = Package::skeleton("composed");
+        ASSERT_TRUE(pkg.addVariant("linux", tempDir / "linux", std::string("lib/libfoo.so")).success);
+        ASSERT_TRUE(pkg.addVariant("darwin", tempDir / "darwin", std::string("lib/deep/er/libfoo.dylib")).success);
+        ASSERT_TRUE(pkg.save(pkgPath).success);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(tempDir, ec);
+    }
+
+    void writeFile(const fs::path& path, const std::string& content) {
+        fs::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    static const Composition::Group* find(const std::vector<Composition::Group>& groups,
+                                          const std::string& name) {
+        for (const auto& group : groups) {
+            if (group.name == name) {
+                return &group;
+            }
+        }
+        return nullptr;
+    }
+};
+
+TEST_F(CompositionTest, HeaderPass) {
+    auto report = Composition::analyze(pkgPath);
+    ASSERT_TRUE(report.has_value()) << Composition::getLastError();
+
+    EXPECT_EQ(report->name, "composed");
+    EXPECT_FALSE(report->probed);
+    EXPECT_EQ(report->packageBytes, fs::file_size(pkgPath));
+
+    const auto* linuxGroup = find(report->variants, "linux");
+    const auto* darwinGroup = find(report->variants, "darwin");
+    ASSERT_NE(linuxGroup, nullptr);
+    ASSERT_NE(darwinGroup, nullptr);
+    EXPECT_EQ(linuxGroup->files, 2u);
+    EXPECT_EQ(linuxGroup->bytes, 8192u + 20000u);
+    EXPECT_EQ(darwinGroup->files, 2u);
+    EXPECT_EQ(darwinGroup->bytes, 8192u);
+    EXPECT_EQ(darwinGroup->histogram[0], 1u);   // empty.txt
+    EXPECT_EQ(darwinGroup->histogram[2], 1u);   // 1 KiB - 16 KiB
+
+    // Estimates share out the .lgx size
+    const auto* variants = find(report->roots, "variants");
+    ASSERT_NE(variants, nullptr);
+    EXPECT_EQ(variants->files, 4u);
+    EXPECT_GT(variants->compressed, 0u);
+    EXPECT_LE(report->total.compressed, report->packageBytes);
+
+    ASSERT_FALSE(report->largest.empty());
+    EXPECT_EQ(report->largest[0].path, "variants/linux/share/readme.txt");
+    EXPECT_EQ(report->deepestPath.path, "variants/darwin/lib/deep/er/libfoo.dylib");
+    EXPECT_EQ(report->deepestPath.value, 6u);
+    EXPECT_EQ(report->longestPath.path, "variants/darwin/lib/deep/er/libfoo.dylib");
+
+    // Content is needed for these
+    EXPECT_EQ(report->duplicateCount, 0u);
+    EXPECT_EQ(report->incompressibleCount, 0u);
+}
+
+TEST_F(CompositionTest, ProbeFindsDuplicatesAndIncompressibleFiles) {
+    Composition::Options options;
+    options.probe = true;
+    options.top = 1;
+    auto report = Composition::analyze(pkgPath, options);
+    ASSERT_TRUE(report.has_value()) << Composition::getLastError();
+    EXPECT_TRUE(report->probed);
+
+    // The noise is stored once per variant
+    ASSERT_EQ(report->duplicateCount, 1u);
+    EXPECT_EQ(report->duplicateBytes, 8192u);
+    ASSERT_EQ(report->duplicates.size(), 1u);
+    EXPECT_EQ(report->duplicates[0].paths.size(), 2u);
+
+    // Both copies are incompressible, only one is listed; the text is not
+    EXPECT_EQ(report->incompressibleCount, 2u);
+    EXPECT_EQ(report->incompressibleBytes, 2u * 8192u);
+    EXPECT_EQ(report->incompressible.size(), 1u);
+    EXPECT_EQ(report->largest.size(), 1u);
+    EXPECT_LT(report->largest[0].compressed, 1000u);
+
+    auto json = nlohmann::json::parse(Composition::toJson(*report));
+    EXPECT_EQ(json["files"], report->total.files);
+    EXPECT_EQ(json["duplicates"]["wasted_bytes"], 8192u);
+    EXPECT_EQ(json["histogram"].size(), Composition::HISTOGRAM_BUCKETS);
+    EXPECT_NE(Composition::toText(*report).find("Incompressible: 2 file(s)"), std::string::npos);
+}
+
+TEST_F(CompositionTest, RejectsUnreadablePackages) {
+    EXPECT_FALSE(Composition::analyze(tempDir / "missing.lgx").has_value());
+
+    fs::path bogus = tempDir / "bogus.lgx";
+    writeFile(bogus, "not a package");
+    EXPECT_FALSE(Composition::analyze(bogus).has_value());
+    EXPECT_FALSE(Composition::getLastError().empty());
+}
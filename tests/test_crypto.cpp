@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "crypto/signing.h"
 #include "crypto/manifest_sig.h"
+#include "core/tar_writer.h"
 #include "crypto/keyring.h"
 
 #include <filesystem>
@@ -193,6 +194,114 @@ TEST(CryptoTest, PublicKeyToDid_JwkKeysAlphabeticallySorted) {
     EXPECT_LT(ktyPos, xPos);
 }
 
+TEST(CryptoTest, Sha256_IncrementalMatchesOneShot) {
+    ASSERT_TRUE(init());
+
+    std::vector<uint8_t> data(100000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 31);
+    }
+
+    Sha256 hasher;
+    hasher.update(data.data(), 1);
+    hasher.update(data.data() + 1, 65535);
+    hasher.update(data.data() + 65536, data.size() - 65536);
+    EXPECT_EQ(hasher.finalHex(), sha256Hex(data));
+
+    Sha256 empty;
+    EXPECT_EQ(empty.finalHex(),
+              "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+}
+
+TEST(CryptoTest, MerkleTree_CacheMatchesUncached) {
+    ASSERT_TRUE(init());
+
+    std::vector<TarEntry> entries = {
+        TarEntry("variants/linux", true),
+        TarEntry("variants/linux/lib.so", std::string("lib")),
+        TarEntry("variants/linux/res/data.bin", std::string("data")),
+        TarEntry("docs/README.md", std::string("readme")),
+    };
+    FileHashCache cache;
+    EXPECT_EQ(computeMerkleTree(entries, &cache), computeMerkleTree(entries));
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_EQ(cache["variants/linux/lib.so"], sha256Hex(std::vector<uint8_t>{'l', 'i', 'b'}));
+
+    // A cached digest is trusted: stale entries must be erased by the caller
+    entries[1].data = {'n', 'e', 'w'};
+    EXPECT_NE(computeMerkleTree(entries, &cache), computeMerkleTree(entries));
+    cache.erase("variants/linux/lib.so");
+    EXPECT_EQ(computeMerkleTree(entries, &cache), computeMerkleTree(entries));
+}
+
+TEST(CryptoTest, VerifyBatch_MatchesIndividualVerify) {
+    ASSERT_TRUE(init());
+
+    auto alice = generateKeypair();
+    auto bob = generateKeypair();
+    std::vector<std::vector<uint8_t>> messages;
+    for (int i = 0; i < 41; ++i) {
+        std::string text = "manifest " + std::to_string(i);
+        messages.emplace_back(text.begin(), text.end());
+    }
+    auto item = [](const std::vector<uint8_t>& message, const PublicKey& pk, const Signature& sig) {
+        VerifyItem it;
+        it.message = message.data();
+        it.messageLen = message.size();
+        it.publicKey = pk;
+        it.signature = sig;
+        return it;
+    };
+
+    std::vector<VerifyItem> items;
+    for (size_t i = 0; i < 40; ++i) {
+        Signature sig = sign(messages[i], alice.secretKey);
+        switch (i % 5) {
+            case 0:
+                items.push_back(item(messages[i], alice.publicKey, sig));
+                break;
+            case 1:  // wrong key
+                items.push_back(item(messages[i], bob.publicKey, sig));
+                break;
+            case 2:  // damaged signature
+                sig[0] ^= 1;
+                items.push_back(item(messages[i], alice.publicKey, sig));
+                break;
+            case 3:  // wrong message
+                items.push_back(item(messages[i + 1], alice.publicKey, sig));
+                break;
+            case 4:  // non-canonical S
+                sig[63] |= 0xf0;
+                items.push_back(item(messages[i], alice.publicKey, sig));
+                break;
+        }
+    }
+    // Repeats of a good and a bad item, and a good signature over another message
+    items.push_back(items[0]);
+    items.push_back(items[1]);
+    items.push_back(item(messages[7], alice.publicKey, items[0].signature));
+    // Empty message, and a small-order public key
+    std::vector<uint8_t> empty;
+    items.push_back(item(empty, bob.publicKey, sign(empty, bob.secretKey)));
+    PublicKey identity{};
+    identity[0] = 1;
+    items.push_back(item(messages[0], identity, items[0].signature));
+
+    for (size_t threads : {1, 4}) {
+        auto results = verifyBatch(items, threads);
+        ASSERT_EQ(results.size(), items.size());
+        size_t valid = 0;
+        for (size_t i = 0; i < items.size(); ++i) {
+            std::vector<uint8_t> message(items[i].message, items[i].message + items[i].messageLen);
+            EXPECT_EQ(results[i], verify(message, items[i].publicKey, items[i].signature))
+                << "item " << i << ", " << threads << " threads";
+            valid += results[i];
+        }
+        EXPECT_EQ(valid, 10u);
+    }
+    EXPECT_TRUE(verifyBatch({}).empty());
+}
+
 // =============================================================================
 // ManifestSig Serialization Tests
 // =============================================================================
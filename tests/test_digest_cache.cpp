@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include "core/digest_cache.h"
+#include "core/package.h"
+#include "crypto/signing.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace lgx;
+namespace fs = std::filesystem;
+
+class DigestCacheTest : public ::testing::Test {
+protected:
+    fs::path tempDir;
+
+    void SetUp() override {
+        ASSERT_TRUE(crypto::init());
+        tempDir = fs::temp_directory_path() / ("lgx_digest_cache_test_" + std::to_string(rand()));
+        fs::create_directories(tempDir);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(tempDir, ec);
+    }
+
+    void writeFile(const fs::path& path, const std::string& content) {
+        fs::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    // A key for a file last changed long ago (2020-09-13)
+    static DigestCache::Key oldKey(uint64_t inode, uint64_t size) {
+        DigestCache::Key key;
+        key.device = 42;
+        key.inode = inode;
+        key.size = size;
+        key.mtimeNs = 1'600'000'000'000'000'000;
+        key.ctimeNs = key.mtimeNs + 1;
+        return key;
+    }
+
+    static std::string digestOf(const std::string& content) {
+        return crypto::sha256Hex(std::vector<uint8_t>(content.begin(), content.end()));
+    }
+};
+
+TEST_F(DigestCacheTest, RecordLookupAndPersist) {
+    auto key = oldKey(7, 5);
+    std::string digest = digestOf("hello");
+    {
+        DigestCache cache(tempDir / "cache");
+        EXPECT_FALSE(cache.lookup(key).has_value());
+        cache.record(key, digest);
+        EXPECT_EQ(cache.lookup(key), std::optional<std::string>(digest));
+        ASSERT_TRUE(cache.save()) << DigestCache::getLastError();
+        EXPECT_EQ(cache.counters().hits, 1u);
+        EXPECT_EQ(cache.counters().misses, 1u);
+        EXPECT_EQ(cache.counters().recorded, 1u);
+        EXPECT_EQ(cache.summary(), "1/2 hits (50.0%)");
+    }
+
+    DigestCache reopened(tempDir / "cache");
+    EXPECT_EQ(reopened.lookup(key), std::optional<std::string>(digest));
+
+    // Any differing field is a miss
+    for (auto changed : {&DigestCache::Key::size, &DigestCache::Key::inode, &DigestCache::Key::device}) {
+        auto other = key;
+        ++(other.*changed);
+        EXPECT_FALSE(reopened.lookup(other).has_value());
+    }
+    for (auto changed : {&DigestCache::Key::mtimeNs, &DigestCache::Key::ctimeNs}) {
+        auto other = key;
+        ++(other.*changed);
+        EXPECT_FALSE(reopened.lookup(other).has_value());
+    }
+}
+
+TEST_F(DigestCacheTest, RecentOrInvalidEntriesAreNotRecorded) {
+    DigestCache cache(tempDir / "cache");
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    auto recent = oldKey(1, 5);
+    recent.ctimeNs = now;  // e.g. chmod'ed or rewritten just now
+    cache.record(recent, digestOf("hello"));
+    cache.record(oldKey(2, 5), "not a digest");
+    EXPECT_EQ(cache.counters().recorded, 0u);
+    EXPECT_FALSE(cache.lookup(recent).has_value());
+    EXPECT_TRUE(cache.save());
+    EXPECT_FALSE(fs::exists(tempDir / "cache" / DigestCache::FILENAME));
+}
+
+TEST_F(DigestCacheTest, DamagedCacheFileOnlyCostsRehash) {
+    auto key = oldKey(3, 5);
+    {
+        DigestCache cache(tempDir / "cache");
+        cache.record(key, digestOf("hello"));
+        cache.record(oldKey(4, 5), digestOf("world"));
+        ASSERT_TRUE(cache.save());
+    }
+    fs::path file = tempDir / "cache" / DigestCache::FILENAME;
+    {
+        std::ofstream out(file, std::ios::app);
+        out << "garbage line\n42 5 5 1 2 " << std::string(64, 'z') << "\n";
+    }
+    DigestCache damaged(tempDir / "cache");
+    EXPECT_TRUE(damaged.lookup(key).has_value());
+    EXPECT_FALSE(damaged.lookup(oldKey(5, 5)).has_value());
+
+    writeFile(file, "not a digest cache\n");
+    DigestCache foreign(tempDir / "cache");
+    EXPECT_FALSE(foreign.lookup(key).has_value());
+}
+
+TEST_F(DigestCacheTest, ConcurrentSavesMerge) {
+    DigestCache first(tempDir / "cache");
+    DigestCache second(tempDir / "cache");
+    first.record(oldKey(1, 1), digestOf("a"));
+    second.record(oldKey(2, 1), digestOf("b"));
+    ASSERT_TRUE(first.save());
+    ASSERT_TRUE(second.save());
+
+    DigestCache merged(tempDir / "cache");
+    EXPECT_TRUE(merged.lookup(oldKey(1, 1)).has_value());
+    EXPECT_TRUE(merged.lookup(oldKey(2, 1)).has_value());
+}
+
+TEST_F(DigestCacheTest, AddInputsSkipsHashingUnchangedFiles) {
+    writeFile(tempDir / "build/mod.so", "library");
+    writeFile(tempDir / "build/res/a.txt", "aaaa");
+    writeFile(tempDir / "build/res/b.txt", "bbbb");
+    // Files changed within the racy window are never recorded
+    std::this_thread::sleep_for(std::chrono::nanoseconds(DigestCache::RACY_WINDOW_NS) +
+                                std::chrono::milliseconds(100));
+
+    auto addBuild = [&](DigestCache* cache) {
+        Package pkg;
+        pkg.getManifest().name = "cached";
+        Package::Inputs inputs;
+        inputs.variants.push_back({"linux", tempDir / "build", std::string("mod.so")});
+        inputs.digestCache = cache;
+        EXPECT_TRUE(pkg.addInputs(inputs).success);
+        return pkg.getManifest().hashes;
+    };
+
+    {
+        DigestCache cache(tempDir / "cache");
+        EXPECT_EQ(addBuild(&cache), addBuild(nullptr));
+        EXPECT_EQ(cache.counters().misses, 3u);
+        EXPECT_EQ(cache.counters().recorded, 3u);
+        ASSERT_TRUE(cache.save());
+    }
+    {
+        DigestCache cache(tempDir / "cache");
+        EXPECT_EQ(addBuild(&cache), addBuild(nullptr));
+        EXPECT_EQ(cache.counters().hits, 3u);
+        EXPECT_EQ(cache.counters().misses, 0u);
+    }
+
+    // A same-size rewrite changes mtime/ctime: that file is rehashed
+    writeFile(tempDir / "build/res/a.txt", "AAAA");
+    {
+        DigestCache cache(tempDir / "cache");
+        auto hashes = addBuild(&cache);
+        EXPECT_EQ(hashes, addBuild(nullptr));
+        EXPECT_EQ(cache.counters().hits, 2u);
+        EXPECT_EQ(cache.counters().misses, 1u);
+        EXPECT_EQ(cache.counters().recorded, 0u);  // too recent to trust
+    }
+
+    // Hits are trusted without rehashing: a cache entry is what a hit uses
+    fs::path file = tempDir / "cache" / DigestCache::FILENAME;
+    std::ifstream in(file);
+    std::stringstream text;
+    text << in.rdbuf();
+    std::string poisoned = text.str();
+    std::string modDigest = digestOf("library");
+    ASSERT_NE(poisoned.find(modDigest), std::string::npos);
+    poisoned.replace(poisoned.find(modDigest), modDigest.size(), digestOf("other"));
+    writeFile(file, poisoned);
+    DigestCache cache(tempDir / "cache");
+    EXPECT_NE(addBuild(&cache), addBuild(nullptr));
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "core/durable_io.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace lgx;
+namespace fs = std::filesystem;
+
+class DurableIoTest : public ::testing::Test {
+protected:
+    fs::path tempDir;
+
+    void SetUp() override {
+        tempDir = fs::temp_directory_path() / ("lgx_durable_io_test_" + std::to_string(rand()));
+        fs::create_directories(tempDir);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(tempDir, ec);
+    }
+
+    void writeFile(const fs::path& path, const std::string& content) {
+        fs::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    static std::string readFile(const fs::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+};
+
+TEST_F(DurableIoTest, SyncsFilesAndTrees) {
+    writeFile(tempDir / "tree/a.txt", "a");
+    writeFile(tempDir / "tree/sub/b.txt", "b");
+
+    EXPECT_TRUE(DurableIo::syncFile(tempDir / "tree/a.txt"));
+    EXPECT_TRUE(DurableIo::syncFiles({tempDir / "tree/a.txt", tempDir / "tree/sub/b.txt"}));
+    EXPECT_TRUE(DurableIo::syncFiles({}));
+    EXPECT_TRUE(DurableIo::syncDirectory(tempDir / "tree"));
+    EXPECT_TRUE(DurableIo::syncTree(tempDir / "tree"));
+
+    EXPECT_FALSE(DurableIo::syncFile(tempDir / "missing"));
+    EXPECT_FALSE(DurableIo::getLastError().empty());
+    EXPECT_FALSE(DurableIo::syncFiles({tempDir / "tree/a.txt", tempDir / "missing"}));
+    EXPECT_FALSE(DurableIo::syncTree(tempDir / "missing"));
+}
+
+TEST_F(DurableIoTest, ExchangeSwapsPaths) {
+    writeFile(tempDir / "new/file.txt", "new");
+    writeFile(tempDir / "old/file.txt", "old");
+    writeFile(tempDir / "old/only-old.txt", "x");
+
+    ASSERT_TRUE(DurableIo::exchange(tempDir / "new", tempDir / "old")) << DurableIo::getLastError();
+    EXPECT_EQ(readFile(tempDir / "old/file.txt"), "new");
+    EXPECT_FALSE(fs::exists(tempDir / "old/only-old.txt"));
+    EXPECT_EQ(readFile(tempDir / "new/file.txt"), "old");
+    EXPECT_TRUE(fs::exists(tempDir / "new/only-old.txt"));
+
+    // A directory and a file can trade places too
+    writeFile(tempDir / "plain", "plain");
+    ASSERT_TRUE(DurableIo::exchange(tempDir / "new", tempDir / "plain"));
+    EXPECT_TRUE(fs::is_directory(tempDir / "plain"));
+    EXPECT_EQ(readFile(tempDir / "new"), "plain");
+
+    EXPECT_FALSE(DurableIo::exchange(tempDir / "missing", tempDir / "old"));
+    EXPECT_EQ(readFile(tempDir / "old/file.txt"), "new");
+}
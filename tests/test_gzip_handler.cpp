@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 #include "core/gzip_handler.h"
+#include "core/progress.h"
+
+#include <algorithm>
 
 using namespace lgx;
 
@@ -184,6 +187,140 @@ TEST(GzipHandlerTest, DecompressStream) {
     EXPECT_EQ(result, original);
 }
 
+TEST(GzipHandlerTest, DecompressStream_FromReadCallback) {
+    std::vector<uint8_t> original(300 * 1024);
+    for (size_t i = 0; i < original.size(); ++i) {
+        original[i] = static_cast<uint8_t>((i * 31) % 253);
+    }
+    auto compressed = GzipHandler::compress(original);
+
+    // Hand the input over in small pieces, as a file read loop would
+    size_t offset = 0;
+    auto reader = [&](uint8_t* buffer, size_t maxSize) {
+        size_t n = std::min<size_t>({maxSize, 1000, compressed.size() - offset});
+        std::copy(compressed.begin() + offset, compressed.begin() + offset + n, buffer);
+        offset += n;
+        return n;
+    };
+
+    std::vector<uint8_t> result;
+    bool success = GzipHandler::decompressStream(reader,
+        [&result](const uint8_t* buffer, size_t size) {
+            result.insert(result.end(), buffer, buffer + size);
+            return true;
+        });
+    EXPECT_TRUE(success) << GzipHandler::getLastError();
+    EXPECT_EQ(result, original);
+
+    // Stopping early leaves the rest of the input unread
+    offset = 0;
+    size_t written = 0;
+    success = GzipHandler::decompressStream(reader,
+        [&written](const uint8_t*, size_t size) {
+            written += size;
+            return false;
+        });
+    EXPECT_FALSE(success);
+    EXPECT_GT(written, 0u);
+    EXPECT_LT(offset, compressed.size());
+
+    // Truncated input is an error, not a short result
+    offset = 0;
+    compressed.resize(compressed.size() / 2);
+    success = GzipHandler::decompressStream(reader,
+        [](const uint8_t*, size_t) { return true; });
+    EXPECT_FALSE(success);
+    EXPECT_EQ(GzipHandler::getLastError(), "Truncated gzip data");
+}
+
+TEST(GzipHandlerTest, CompressTo_MatchesCompress) {
+    std::vector<uint8_t> original(200 * 1024);
+    for (size_t i = 0; i < original.size(); ++i) {
+        original[i] = static_cast<uint8_t>((i * 131) % 251);
+    }
+
+    for (const auto& input : {original, std::vector<uint8_t>{}}) {
+        std::vector<uint8_t> streamed;
+        size_t chunks = 0;
+        bool success = GzipHandler::compressTo(input.data(), input.size(),
+            [&](const uint8_t* buffer, size_t size) {
+                streamed.insert(streamed.end(), buffer, buffer + size);
+                ++chunks;
+                return true;
+            });
+
+        EXPECT_TRUE(success);
+        EXPECT_GT(chunks, 1u);  // header, body and trailer arrive separately
+        EXPECT_EQ(streamed, GzipHandler::compress(input));
+    }
+}
+
+TEST(GzipHandlerTest, Segments_DecompressToConcatenation) {
+    std::vector<std::vector<uint8_t>> pieces = {
+        std::vector<uint8_t>(100 * 1024, 'a'),
+        {},
+        {'h', 'e', 'l', 'l', 'o'},
+        std::vector<uint8_t>(3000),
+    };
+    for (size_t i = 0; i < pieces[3].size(); ++i) {
+        pieces[3][i] = static_cast<uint8_t>((i * 131) % 251);
+    }
+
+    GzipHandler::SegmentCompressor compressor;
+    std::vector<GzipHandler::Segment> segments(pieces.size());
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        ASSERT_TRUE(compressor.compress(pieces[i].data(), pieces[i].size(), segments[i]));
+        EXPECT_EQ(segments[i].size, pieces[i].size());
+    }
+
+    // Any order and repetition of segments forms a valid stream
+    for (const auto& order : {std::vector<size_t>{0, 1, 2, 3}, std::vector<size_t>{3, 2, 2, 0}}) {
+        std::vector<const GzipHandler::Segment*> ordered;
+        std::vector<uint8_t> concatenated;
+        for (size_t i : order) {
+            ordered.push_back(&segments[i]);
+            concatenated.insert(concatenated.end(), pieces[i].begin(), pieces[i].end());
+        }
+        std::vector<uint8_t> stream;
+        ASSERT_TRUE(GzipHandler::writeSegments(ordered,
+            [&stream](const uint8_t* buffer, size_t size) {
+                stream.insert(stream.end(), buffer, buffer + size);
+                return true;
+            }));
+        ASSERT_TRUE(GzipHandler::isGzipData(stream));
+        EXPECT_EQ(GzipHandler::decompress(stream), concatenated);
+    }
+
+    std::vector<uint8_t> empty;
+    ASSERT_TRUE(GzipHandler::writeSegments({}, [&empty](const uint8_t* buffer, size_t size) {
+        empty.insert(empty.end(), buffer, buffer + size);
+        return true;
+    }));
+    auto decompressed = GzipHandler::decompressStream(empty, [](const uint8_t*, size_t) { return true; });
+    EXPECT_TRUE(decompressed);
+}
+
+TEST(GzipHandlerTest, CompressTo_CallbackAbort) {
+    std::vector<uint8_t> original(1024, 'x');
+    bool success = GzipHandler::compressTo(original.data(), original.size(),
+        [](const uint8_t*, size_t) { return false; });
+
+    EXPECT_FALSE(success);
+    EXPECT_FALSE(GzipHandler::getLastError().empty());
+}
+
+TEST(GzipHandlerTest, Decompress_RawPointer) {
+    std::vector<uint8_t> original = {'R', 'a', 'w', ' ', 'p', 't', 'r'};
+    auto compressed = GzipHandler::compress(original);
+
+    auto result = GzipHandler::decompress(compressed.data(), compressed.size());
+    EXPECT_EQ(result, original);
+
+    // A prefix of the stream is truncated data, not a valid payload
+    auto truncated = GzipHandler::decompress(compressed.data(), compressed.size() / 2);
+    EXPECT_TRUE(truncated.empty());
+}
+
 // =============================================================================
 // Decompression Bomb Protection (F-007)
 //
@@ -371,3 +508,43 @@ TEST_F(GzipDefaultCapTest, ZeroIsRejectedAndLeavesProtectionIntact) {
     ASSERT_FALSE(bomb.empty());
     EXPECT_TRUE(GzipHandler::decompress(bomb).empty());
 }
+
+// =============================================================================
+// Progress and Cancellation
+// =============================================================================
+
+TEST(GzipHandlerTest, Decompress_ReportsProgress) {
+    std::vector<uint8_t> original(100 * 1024, 'p');
+    auto compressed = GzipHandler::compress(original);
+
+    Progress::Context context;
+    {
+        Progress::Scope scope(&context);
+        auto result = GzipHandler::decompress(compressed);
+        EXPECT_EQ(result.size(), original.size());
+    }
+
+    EXPECT_EQ(context.bytesProcessed.load(), original.size());
+    EXPECT_EQ(context.bytesTotal.load(), original.size());
+}
+
+TEST(GzipHandlerTest, Decompress_Cancelled) {
+    std::vector<uint8_t> original(1024 * 1024, 'c');
+    auto compressed = GzipHandler::compress(original);
+
+    Progress::Context context;
+    context.cancelled = true;
+    {
+        Progress::Scope scope(&context);
+        EXPECT_TRUE(GzipHandler::decompress(compressed).empty());
+        EXPECT_EQ(GzipHandler::getLastError(), Progress::CANCELLED_ERROR);
+
+        bool ok = GzipHandler::decompressStream(compressed,
+            [](const uint8_t*, size_t) { return true; });
+        EXPECT_FALSE(ok);
+        EXPECT_EQ(GzipHandler::getLastError(), Progress::CANCELLED_ERROR);
+    }
+
+    // Outside the scope the same data decompresses normally
+    EXPECT_EQ(GzipHandler::decompress(compressed), original);
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include "core/file_watcher.h"
+#include "core/incremental_build.h"
+#include "core/package.h"
+#include "crypto/signing.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+using namespace lgx;
+namespace fs = std::filesystem;
+
+class IncrementalBuildTest : public ::testing::Test {
+protected:
+    fs::path tempDir;
+
+    void SetUp() override {
+        ASSERT_TRUE(crypto::init());
+        tempDir = fs::temp_directory_path() / ("lgx_incremental_test_" + std::to_string(rand()));
+        fs::create_directories(tempDir);
+        writeFile(tempDir / "build/linux/mod.so", "linux library");
+        writeFile(tempDir / "build/linux/res/data.bin", std::string(4096, 'd'));
+        writeFile(tempDir / "build/linux/res/icons/a.png", "png");
+        writeFile(tempDir / "mod.dylib", "darwin library");
+        writeFile(tempDir / "README.md", "# readme");
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(tempDir, ec);
+    }
+
+    void writeFile(const fs::path& path, const std::string& content) {
+        fs::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    Package::Inputs inputs() const {
+        Package::Inputs result;
+        result.variants.push_back({"Linux-AMD64", tempDir / "build/linux", std::string("mod.so")});
+        result.variants.push_back({"darwin-arm64", tempDir / "mod.dylib", std::nullopt});
+        result.docs.push_back(tempDir / "README.md");
+        return result;
+    }
+
+    static Package basePackage() {
+        Package pkg;
+        pkg.getManifest().name = "watched";
+        pkg.getManifest().version = "1.0.0";
+        return pkg;
+    }
+
+    // Content files by path, for comparing packages regardless of entry order
+    static std::map<std::string, std::vector<uint8_t>> files(const Package& pkg) {
+        std::map<std::string, std::vector<uint8_t>> result;
+        for (const auto& entry : pkg.getEntries()) {
+            if (!entry.isDirectory && entry.path != "manifest.json") {
+                result[entry.path] = entry.data;
+            }
+        }
+        return result;
+    }
+
+    // What the written package must match: the same inputs built from scratch
+    void expectMatchesFreshBuild(const fs::path& output) {
+        auto written = Package::load(output);
+        ASSERT_TRUE(written.has_value()) << Package::getLastError();
+        EXPECT_TRUE(written->validatePackage().valid);
+
+        Package fresh = basePackage();
+        ASSERT_TRUE(fresh.addInputs(inputs()).success);
+        EXPECT_EQ(files(*written), files(fresh));
+        EXPECT_EQ(written->getManifest().hashes, fresh.getManifest().hashes);
+        EXPECT_EQ(written->getManifest().main, fresh.getManifest().main);
+    }
+};
+
+TEST_F(IncrementalBuildTest, BuildMatchesFullBuild) {
+    fs::path output = tempDir / "out.lgx";
+    IncrementalBuild build(basePackage(), inputs(), output);
+    auto result = build.build();
+    ASSERT_TRUE(result.success) << result.error;
+    expectMatchesFreshBuild(output);
+    EXPECT_FALSE(fs::exists(output.string() + ".tmp"));
+
+    auto roots = build.watchRoots();
+    EXPECT_EQ(roots.size(), 3u);
+    EXPECT_NE(std::find(roots.begin(), roots.end(), fs::absolute(tempDir / "mod.dylib")), roots.end());
+}
+
+TEST_F(IncrementalBuildTest, UpdatesMatchFullBuild) {
+    fs::path output = tempDir / "out.lgx";
+    IncrementalBuild build(basePackage(), inputs(), output);
+    ASSERT_TRUE(build.build().success);
+
+    // Modify one file: only it and the manifest are recompressed
+    writeFile(tempDir / "build/linux/res/data.bin", std::string(5000, 'e'));
+    auto result = build.update({tempDir / "build/linux/res/data.bin"});
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(build.lastCompressed(), 2u);
+    expectMatchesFreshBuild(output);
+
+    // Add a file and a new directory with files in it
+    writeFile(tempDir / "build/linux/new.txt", "new");
+    writeFile(tempDir / "build/linux/plugins/p/x.so", "plugin");
+    result = build.update({tempDir / "build/linux/new.txt", tempDir / "build/linux/plugins",
+                           tempDir / "build/linux/plugins/p/x.so"});
+    ASSERT_TRUE(result.success) << result.error;
+    expectMatchesFreshBuild(output);
+
+    // Delete a file and a directory
+    fs::remove(tempDir / "build/linux/new.txt");
+    fs::remove_all(tempDir / "build/linux/res");
+    result = build.update({tempDir / "build/linux/new.txt", tempDir / "build/linux/res"});
+    ASSERT_TRUE(result.success) << result.error;
+    expectMatchesFreshBuild(output);
+    EXPECT_EQ(files(build.package()).count("variants/linux-amd64/res/data.bin"), 0u);
+
+    // Single-file inputs and docs
+    writeFile(tempDir / "mod.dylib", "darwin library v2");
+    writeFile(tempDir / "README.md", "# readme v2");
+    result = build.update({tempDir / "mod.dylib", tempDir / "README.md"});
+    ASSERT_TRUE(result.success) << result.error;
+    expectMatchesFreshBuild(output);
+
+    // Paths outside the inputs change nothing
+    writeFile(tempDir / "unrelated.txt", "x");
+    ASSERT_TRUE(build.update({tempDir / "unrelated.txt"}).success);
+    EXPECT_EQ(build.lastCompressed(), 0u);
+}
+
+TEST_F(IncrementalBuildTest, OutputReplacedLikeSave) {
+    // The output is a symlink to a group-readable file with a user's own
+    // "<name>.tmp" beside it
+    fs::path realPath = tempDir / "real.lgx";
+    fs::path linkPath = tempDir / "link.lgx";
+    ASSERT_TRUE(basePackage().save(realPath).success);
+    fs::permissions(realPath, fs::perms::owner_read | fs::perms::owner_write | fs::perms::group_read,
+                    fs::perm_options::replace);
+    fs::create_symlink("real.lgx", linkPath);
+    writeFile(tempDir / "real.lgx.tmp", "mine");
+    writeFile(tempDir / "link.lgx.tmp", "mine");
+
+    IncrementalBuild build(basePackage(), inputs(), linkPath, Package::Durability::Durable);
+    auto result = build.build();
+    ASSERT_TRUE(result.success) << result.error;
+    writeFile(tempDir / "mod.dylib", "darwin library v2");
+    result = build.update({tempDir / "mod.dylib"});
+    ASSERT_TRUE(result.success) << result.error;
+
+    EXPECT_TRUE(fs::is_symlink(linkPath));
+    EXPECT_EQ(fs::status(realPath).permissions(),
+              fs::perms::owner_read | fs::perms::owner_write | fs::perms::group_read);
+    expectMatchesFreshBuild(realPath);
+    std::ifstream mine(tempDir / "real.lgx.tmp");
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(mine), {}), "mine");
+    EXPECT_TRUE(fs::exists(tempDir / "link.lgx.tmp"));
+    size_t temporaries = 0;
+    for (const auto& entry : fs::directory_iterator(tempDir)) {
+        temporaries += entry.path().filename().string().rfind("real.lgx.tmp.", 0) == 0;
+    }
+    EXPECT_EQ(temporaries, 0u);
+}
+
+TEST_F(IncrementalBuildTest, OwnWritesInsideAnInputAreIgnored) {
+    fs::path output = tempDir / "build/linux/out.lgx";
+    IncrementalBuild build(basePackage(), inputs(), output);
+    ASSERT_TRUE(build.build().success);
+
+    // What a write of the output touches is not an input change
+    auto result = build.update({output, tempDir / "build/linux/out.lgx.tmp.4242"});
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(build.lastCompressed(), 0u);
+}
+
+TEST_F(IncrementalBuildTest, MissingRootFailsUntilRestored) {
+    fs::path output = tempDir / "out.lgx";
+    IncrementalBuild build(basePackage(), inputs(), output);
+    ASSERT_TRUE(build.build().success);
+
+    fs::remove(tempDir / "mod.dylib");
+    EXPECT_FALSE(build.update({tempDir / "mod.dylib"}).success);
+    EXPECT_TRUE(Package::load(output).has_value());  // last good package is kept
+
+    writeFile(tempDir / "mod.dylib", "darwin library v3");
+    auto result = build.update({tempDir / "mod.dylib"});
+    ASSERT_TRUE(result.success) << result.error;
+    expectMatchesFreshBuild(output);
+}
+
+TEST_F(IncrementalBuildTest, WatcherReportsChanges) {
+    FileWatcher watcher({tempDir / "build/linux", tempDir / "mod.dylib"});
+    ASSERT_TRUE(watcher.start()) << FileWatcher::getLastError();
+    EXPECT_TRUE(watcher.wait(0, 0).empty());
+
+    writeFile(tempDir / "build/linux/res/icons/b.png", "png");
+    writeFile(tempDir / "mod.dylib", "changed");
+    writeFile(tempDir / "README.md", "not watched");
+
+    std::vector<fs::path> changed;
+    for (int attempt = 0; attempt < 20 && changed.size() < 2; ++attempt) {
+        for (auto& path : watcher.wait(500)) {
+            changed.push_back(path);
+        }
+    }
+    auto has = [&changed](const fs::path& path) {
+        return std::find(changed.begin(), changed.end(), fs::absolute(path)) != changed.end();
+    };
+    EXPECT_TRUE(has(tempDir / "build/linux/res/icons/b.png"));
+    EXPECT_TRUE(has(tempDir / "mod.dylib"));
+    EXPECT_FALSE(has(tempDir / "README.md"));
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "core/installed_check.h"
+#include "core/package.h"
+#include "crypto/signing.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace lgx;
+namespace fs = std::filesystem;
+
+class InstalledCheckTest : public ::testing::Test {
+protected:
+    fs::path tempDir;
+    Package pkg;
+
+    void SetUp() override {
+        ASSERT_TRUE(crypto::init());
+        tempDir = fs::temp_directory_path() / ("lgx_installed_check_test_" + std::to_string(rand()));
+        fs::create_directories(tempDir);
+
+        writeFile(tempDir / "dist/lib/libfoo.so", "library");
+        writeFile(tempDir / "dist/share/a.txt", "aaaa");
+        writeFile(tempDir / "dist/share/b.txt", "bbbb");
+        pkg = Package::skeleton("checked");
+        ASSERT_TRUE(pkg.addVariant("linux-amd64", tempDir / "dist", std::string("lib/libfoo.so")).success);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(tempDir, ec);
+    }
+
+    void writeFile(const fs::path& path, const std::string& content) {
+        fs::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary) << content;
+    }
+};
+
+TEST_F(InstalledCheckTest, ExtractedTreeMatchesManifest) {
+    ASSERT_TRUE(pkg.extractVariant("linux-amd64", tempDir / "out").success);
+    fs::create_directories(tempDir / "out/linux-amd64/empty");  // not covered by the hash
+
+    // Any thread count gives the manifest's leaf hash
+    for (size_t threads : {size_t{1}, size_t{4}}) {
+        auto report = InstalledCheck::check(tempDir / "out/linux-amd64/", pkg.getManifest(),
+                                            "Linux-AMD64", threads);
+        ASSERT_TRUE(report.has_value()) << InstalledCheck::getLastError();
+        EXPECT_TRUE(report->match);
+        EXPECT_EQ(report->files, 3u);
+        EXPECT_EQ(report->bytes, 15u);
+        EXPECT_EQ(report->actualHash, pkg.getManifest().hashes.at("variants/linux-amd64"));
+    }
+
+    EXPECT_EQ(crypto::computeLeafHashFromDigests({}), "");
+    EXPECT_FALSE(InstalledCheck::check(tempDir / "out/linux-amd64", pkg.getManifest(), "web").has_value());
+    EXPECT_FALSE(InstalledCheck::check(tempDir / "missing", pkg.getManifest(), "linux-amd64").has_value());
+}
+
+TEST_F(InstalledCheckTest, ReportsTampering) {
+    fs::path root = tempDir / "out/linux-amd64";
+
+    // A plain extract records no per-file digests: only the hash differs
+    ASSERT_TRUE(pkg.extractVariant("linux-amd64", tempDir / "out").success);
+    writeFile(root / "share/a.txt", "AAAA");
+    auto report = InstalledCheck::check(root, pkg.getManifest(), "linux-amd64");
+    ASSERT_TRUE(report.has_value());
+    EXPECT_FALSE(report->match);
+    EXPECT_FALSE(report->localized);
+    EXPECT_TRUE(report->modified.empty());
+
+    // After an update, the files that differ are named
+    ASSERT_TRUE(pkg.updateVariant("linux-amd64", tempDir / "out").success);
+    EXPECT_TRUE(InstalledCheck::check(root, pkg.getManifest(), "linux-amd64")->match);
+    writeFile(root / "share/a.txt", "AAAA");
+    fs::remove(root / "share/b.txt");
+    writeFile(root / "lib/extra.so", "extra");
+    report = InstalledCheck::check(root, pkg.getManifest(), "linux-amd64");
+    ASSERT_TRUE(report.has_value());
+    EXPECT_FALSE(report->match);
+    EXPECT_TRUE(report->localized);
+    EXPECT_EQ(report->modified, std::vector<std::string>{"share/a.txt"});
+    EXPECT_EQ(report->missing, std::vector<std::string>{"share/b.txt"});
+    EXPECT_EQ(report->unexpected, std::vector<std::string>{"lib/extra.so"});
+
+    // A symlink in place of a file fails the check even if it points at
+    // the right contents
+    ASSERT_TRUE(pkg.updateVariant("linux-amd64", tempDir / "out").success);
+    writeFile(tempDir / "elsewhere.txt", "aaaa");
+    fs::remove(root / "share/a.txt");
+    fs::create_symlink(tempDir / "elsewhere.txt", root / "share/a.txt");
+    report = InstalledCheck::check(root, pkg.getManifest(), "linux-amd64");
+    ASSERT_TRUE(report.has_value());
+    EXPECT_FALSE(report->match);
+    EXPECT_EQ(report->unexpected, std::vector<std::string>{"share/a.txt"});
+    EXPECT_TRUE(report->missing.empty());
+}
@@ -2,7 +2,13 @@
 #include "lgx.h"
 #include <filesystem>
 #include <fstream>
+#include <atomic>
+#include <chrono>
 #include <cstring>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
 
 class LibraryTest : public ::testing::Test {
 protected:
@@ -79,6 +85,86 @@ TEST_F(LibraryTest, LoadPackageNullArg) {
     EXPECT_NE(error, nullptr);
 }
 
+TEST_F(LibraryTest, LoadFromMemory) {
+    auto output_path = (test_dir_ / "test.lgx").string();
+    ASSERT_TRUE(lgx_create(output_path.c_str(), "testpkg").success);
+
+    std::ifstream file(output_path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+    ASSERT_FALSE(bytes.empty());
+
+    lgx_package_t pkg = lgx_load_from_memory(bytes.data(), bytes.size());
+    ASSERT_NE(pkg, nullptr);
+    EXPECT_STREQ(lgx_get_name(pkg), "testpkg");
+    lgx_free_package(pkg);
+
+    EXPECT_EQ(lgx_load_from_memory(nullptr, 10), nullptr);
+    EXPECT_EQ(lgx_load_from_memory("garbage", 7), nullptr);
+    EXPECT_NE(strlen(lgx_get_last_error()), 0);
+}
+
+TEST_F(LibraryTest, SaveToBuffer) {
+    auto output_path = (test_dir_ / "test.lgx").string();
+    lgx_create(output_path.c_str(), "testpkg");
+    lgx_package_t pkg = lgx_load(output_path.c_str());
+    ASSERT_NE(pkg, nullptr);
+    lgx_set_version(pkg, "1.2.3");
+
+    void* data = nullptr;
+    size_t size = 0;
+    lgx_result_t result = lgx_save_to_buffer(pkg, &data, &size);
+    ASSERT_TRUE(result.success) << (result.error ? result.error : "");
+    ASSERT_NE(data, nullptr);
+    ASSERT_GT(size, 0u);
+
+    lgx_package_t reloaded = lgx_load_from_memory(data, size);
+    lgx_free_buffer(data);
+    ASSERT_NE(reloaded, nullptr);
+    EXPECT_STREQ(lgx_get_version(reloaded), "1.2.3");
+
+    lgx_free_package(reloaded);
+    lgx_free_package(pkg);
+}
+
+static bool append_chunk(const void* data, size_t size, void* user_data) {
+    auto* out = static_cast<std::vector<char>*>(user_data);
+    out->insert(out->end(), static_cast<const char*>(data), static_cast<const char*>(data) + size);
+    return true;
+}
+
+static bool reject_chunk(const void*, size_t, void*) {
+    return false;
+}
+
+TEST_F(LibraryTest, SaveToCallback) {
+    auto output_path = (test_dir_ / "test.lgx").string();
+    lgx_create(output_path.c_str(), "testpkg");
+    lgx_package_t pkg = lgx_load(output_path.c_str());
+    ASSERT_NE(pkg, nullptr);
+
+    std::vector<char> streamed;
+    lgx_result_t result = lgx_save_to_callback(pkg, append_chunk, &streamed);
+    ASSERT_TRUE(result.success) << (result.error ? result.error : "");
+
+    // Streamed bytes are identical to what lgx_save() writes
+    auto saved_path = (test_dir_ / "saved.lgx").string();
+    ASSERT_TRUE(lgx_save(pkg, saved_path.c_str()).success);
+    std::ifstream file(saved_path, std::ios::binary);
+    std::vector<char> on_disk((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+    EXPECT_EQ(streamed, on_disk);
+
+    result = lgx_save_to_callback(pkg, reject_chunk, nullptr);
+    EXPECT_FALSE(result.success);
+    EXPECT_NE(result.error, nullptr);
+
+    result = lgx_save_to_callback(pkg, nullptr, nullptr);
+    EXPECT_FALSE(result.success);
+
+    lgx_free_package(pkg);
+}
+
 TEST_F(LibraryTest, GetPackageMetadata) {
     auto output_path = (test_dir_ / "test.lgx").string();
     
@@ -418,3 +504,628 @@ TEST_F(LibraryTest, ExtractNullArgs) {
     
     lgx_free_package(pkg);
 }
+
+// =============================================================================
+// Asynchronous jobs
+// =============================================================================
+
+struct JobObserver {
+    int progress_calls = 0;
+    int complete_calls = 0;
+    lgx_job_status_t completed_status = LGX_JOB_RUNNING;
+    lgx_job_progress_t last_progress = {0, 0, 0};
+    bool cancel_on_progress = false;
+};
+
+static void observe_progress(lgx_job_t job, lgx_job_progress_t progress, void* user_data) {
+    auto* observer = static_cast<JobObserver*>(user_data);
+    ++observer->progress_calls;
+    observer->last_progress = progress;
+    if (observer->cancel_on_progress) {
+        lgx_job_cancel(job);
+    }
+}
+
+static void observe_complete(lgx_job_t, lgx_job_status_t status, void* user_data) {
+    auto* observer = static_cast<JobObserver*>(user_data);
+    ++observer->complete_calls;
+    observer->completed_status = status;
+}
+
+TEST_F(LibraryTest, JobLoad) {
+    auto output_path = (test_dir_ / "test.lgx").string();
+    ASSERT_TRUE(lgx_create(output_path.c_str(), "testpkg").success);
+
+    JobObserver observer;
+    lgx_job_callbacks_t callbacks = {observe_progress, observe_complete, &observer};
+    lgx_job_t job = lgx_job_start_load(output_path.c_str(), &callbacks);
+    ASSERT_NE(job, nullptr);
+
+    EXPECT_EQ(lgx_job_wait(job), LGX_JOB_SUCCEEDED);
+    EXPECT_EQ(lgx_job_get_status(job), LGX_JOB_SUCCEEDED);
+    EXPECT_EQ(lgx_job_get_error(job), nullptr);
+    EXPECT_EQ(observer.complete_calls, 1);
+    EXPECT_EQ(observer.completed_status, LGX_JOB_SUCCEEDED);
+    EXPECT_GE(observer.progress_calls, 1);
+    EXPECT_GT(observer.last_progress.bytes_processed, 0u);
+    EXPECT_GT(observer.last_progress.entries_processed, 0u);
+
+    lgx_package_t pkg = lgx_job_take_package(job);
+    ASSERT_NE(pkg, nullptr);
+    EXPECT_STREQ(lgx_get_name(pkg), "testpkg");
+    EXPECT_EQ(lgx_job_take_package(job), nullptr);  // already taken
+
+    lgx_free_package(pkg);
+    lgx_job_free(job);
+}
+
+TEST_F(LibraryTest, JobLoadMissingFile) {
+    auto missing_path = (test_dir_ / "missing.lgx").string();
+    lgx_job_t job = lgx_job_start_load(missing_path.c_str(), nullptr);
+    ASSERT_NE(job, nullptr);
+
+    EXPECT_EQ(lgx_job_wait(job), LGX_JOB_FAILED);
+    ASSERT_NE(lgx_job_get_error(job), nullptr);
+    EXPECT_NE(std::string(lgx_job_get_error(job)).find("Cannot open file"), std::string::npos);
+    EXPECT_EQ(lgx_job_take_package(job), nullptr);
+
+    lgx_job_free(job);
+}
+
+TEST_F(LibraryTest, JobVerify) {
+    auto output_path = (test_dir_ / "test.lgx").string();
+    ASSERT_TRUE(lgx_create(output_path.c_str(), "testpkg").success);
+
+    lgx_job_t job = lgx_job_start_verify(output_path.c_str(), nullptr);
+    ASSERT_NE(job, nullptr);
+    EXPECT_EQ(lgx_job_wait(job), LGX_JOB_SUCCEEDED);
+
+    lgx_verify_result_t result;
+    ASSERT_TRUE(lgx_job_take_verify_result(job, &result));
+    EXPECT_TRUE(result.valid);
+    lgx_free_verify_result(result);
+    EXPECT_FALSE(lgx_job_take_verify_result(job, &result));
+
+    lgx_job_free(job);
+}
+
+TEST_F(LibraryTest, JobVerifySignatureUnsigned) {
+    auto output_path = (test_dir_ / "test.lgx").string();
+    ASSERT_TRUE(lgx_create(output_path.c_str(), "testpkg").success);
+
+    lgx_job_t job = lgx_job_start_verify_signature(output_path.c_str(), nullptr, nullptr);
+    ASSERT_NE(job, nullptr);
+    EXPECT_EQ(lgx_job_wait(job), LGX_JOB_SUCCEEDED);
+
+    lgx_signature_info_t info;
+    ASSERT_TRUE(lgx_job_take_signature_info(job, &info));
+    EXPECT_FALSE(info.is_signed);
+    EXPECT_TRUE(info.package_valid);
+    lgx_free_signature_info(info);
+
+    lgx_job_free(job);
+}
+
+TEST_F(LibraryTest, VerifySignaturesBatch) {
+    auto bytes = [](const char* hex) {
+        std::vector<uint8_t> out;
+        for (size_t i = 0; hex[i] && hex[i + 1]; i += 2) {
+            out.push_back(static_cast<uint8_t>(std::stoi(std::string(hex + i, 2), nullptr, 16)));
+        }
+        return out;
+    };
+    // RFC 8032 section 7.1, tests 1 and 2
+    auto pk1 = bytes("d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a");
+    auto sig1 = bytes("e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b");
+    auto pk2 = bytes("3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c");
+    auto sig2 = bytes("92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00");
+    const uint8_t msg2[] = {0x72};
+    auto damaged = sig2;
+    damaged[10] ^= 0x40;
+
+    lgx_signature_item_t items[] = {
+        {nullptr, 0, pk1.data(), sig1.data()},
+        {msg2, 1, pk2.data(), sig2.data()},
+        {msg2, 1, pk1.data(), sig2.data()},       // wrong key
+        {msg2, 1, pk2.data(), damaged.data()},
+        {msg2, 1, pk2.data(), sig2.data()},       // repeat
+    };
+    bool valid[5];
+    auto result = lgx_verify_signatures(items, 5, valid);
+    ASSERT_TRUE(result.success);
+    EXPECT_TRUE(valid[0]);
+    EXPECT_TRUE(valid[1]);
+    EXPECT_FALSE(valid[2]);
+    EXPECT_FALSE(valid[3]);
+    EXPECT_TRUE(valid[4]);
+
+    EXPECT_TRUE(lgx_verify_signatures(nullptr, 0, nullptr).success);
+    EXPECT_FALSE(lgx_verify_signatures(nullptr, 1, valid).success);
+    items[1].public_key = nullptr;
+    EXPECT_FALSE(lgx_verify_signatures(items, 5, valid).success);
+}
+
+TEST_F(LibraryTest, JobExtract) {
+    auto output_path = (test_dir_ / "test.lgx").string();
+    auto file_path = (test_dir_ / "test.txt").string();
+    auto extract_dir = (test_dir_ / "extracted").string();
+    std::ofstream(file_path) << "test content";
+
+    lgx_create(output_path.c_str(), "testpkg");
+    lgx_package_t pkg = lgx_load(output_path.c_str());
+    ASSERT_NE(pkg, nullptr);
+    ASSERT_TRUE(lgx_add_variant(pkg, "test-variant", file_path.c_str(), "test.txt").success);
+
+    JobObserver observer;
+    lgx_job_callbacks_t callbacks = {observe_progress, observe_complete, &observer};
+    lgx_job_t job = lgx_job_start_extract(pkg, nullptr, extract_dir.c_str(), &callbacks);
+    ASSERT_NE(job, nullptr);
+
+    // The job works on a snapshot, so the handle can go away immediately
+    lgx_free_package(pkg);
+
+    EXPECT_EQ(lgx_job_wait(job), LGX_JOB_SUCCEEDED);
+    EXPECT_EQ(observer.complete_calls, 1);
+    EXPECT_EQ(lgx_job_get_progress(job).bytes_processed, strlen("test content"));
+    EXPECT_TRUE(std::filesystem::exists(std::filesystem::path(extract_dir) / "test-variant" / "test.txt"));
+
+    lgx_job_free(job);
+}
+
+TEST_F(LibraryTest, JobCancel) {
+    // Large enough to inflate in many chunks, so cancellation lands mid-stream
+    auto output_path = (test_dir_ / "test.lgx").string();
+    auto file_path = (test_dir_ / "big.bin").string();
+    {
+        std::ofstream file(file_path, std::ios::binary);
+        uint32_t state = 12345;
+        for (int i = 0; i < 4 * 1024 * 1024; ++i) {
+            state = state * 1103515245u + 12345u;
+            file.put(static_cast<char>(state >> 24));
+        }
+    }
+    lgx_create(output_path.c_str(), "testpkg");
+    lgx_package_t pkg = lgx_load(output_path.c_str());
+    ASSERT_NE(pkg, nullptr);
+    ASSERT_TRUE(lgx_add_variant(pkg, "big", file_path.c_str(), "big.bin").success);
+    ASSERT_TRUE(lgx_save(pkg, output_path.c_str()).success);
+    lgx_free_package(pkg);
+
+    JobObserver observer;
+    observer.cancel_on_progress = true;
+    lgx_job_callbacks_t callbacks = {observe_progress, observe_complete, &observer};
+    lgx_job_t job = lgx_job_start_load(output_path.c_str(), &callbacks);
+    ASSERT_NE(job, nullptr);
+
+    EXPECT_EQ(lgx_job_wait(job), LGX_JOB_CANCELLED);
+    EXPECT_EQ(observer.completed_status, LGX_JOB_CANCELLED);
+    ASSERT_NE(lgx_job_get_error(job), nullptr);
+    EXPECT_STREQ(lgx_job_get_error(job), "Operation cancelled");
+    EXPECT_LT(lgx_job_get_progress(job).bytes_processed, 4u * 1024 * 1024);
+    EXPECT_EQ(lgx_job_take_package(job), nullptr);
+
+    lgx_job_free(job);
+}
+
+static void free_on_complete(lgx_job_t job, lgx_job_status_t, void* user_data) {
+    lgx_job_free(job);
+    static_cast<std::atomic<bool>*>(user_data)->store(true);
+}
+
+TEST_F(LibraryTest, JobFreeFromCompletionCallback) {
+    auto output_path = (test_dir_ / "test.lgx").string();
+    ASSERT_TRUE(lgx_create(output_path.c_str(), "testpkg").success);
+
+    std::atomic<bool> done{false};
+    lgx_job_callbacks_t callbacks = {nullptr, free_on_complete, &done};
+    ASSERT_NE(lgx_job_start_verify(output_path.c_str(), &callbacks), nullptr);
+
+    for (int i = 0; i < 500 && !done.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_TRUE(done.load());
+}
+
+TEST_F(LibraryTest, JobNullArgs) {
+    EXPECT_EQ(lgx_job_start_load(nullptr, nullptr), nullptr);
+    EXPECT_EQ(lgx_job_start_verify(nullptr, nullptr), nullptr);
+    EXPECT_EQ(lgx_job_start_verify_signature(nullptr, nullptr, nullptr), nullptr);
+    EXPECT_EQ(lgx_job_start_extract(nullptr, nullptr, "out", nullptr), nullptr);
+    EXPECT_NE(strlen(lgx_get_last_error()), 0);
+
+    lgx_job_cancel(nullptr);
+    lgx_job_free(nullptr);
+    EXPECT_EQ(lgx_job_get_error(nullptr), nullptr);
+}
+
+// =============================================================================
+// Concurrent access (run under -DLGX_ENABLE_TSAN=ON to check for races)
+// =============================================================================
+
+TEST_F(LibraryTest, PackageClone) {
+    auto output_path = (test_dir_ / "test.lgx").string();
+    auto file_path = (test_dir_ / "test.txt").string();
+    std::ofstream(file_path) << "test content";
+
+    lgx_create(output_path.c_str(), "testpkg");
+    lgx_package_t pkg = lgx_load(output_path.c_str());
+    ASSERT_NE(pkg, nullptr);
+    lgx_set_version(pkg, "1.0.0");
+
+    lgx_package_t clone = lgx_package_clone(pkg);
+    ASSERT_NE(clone, nullptr);
+    EXPECT_STREQ(lgx_get_version(clone), "1.0.0");
+    EXPECT_STREQ(lgx_get_manifest_json(clone), lgx_get_manifest_json(pkg));
+
+    // Modifying one handle leaves the other untouched
+    lgx_set_version(clone, "2.0.0");
+    ASSERT_TRUE(lgx_add_variant(clone, "linux-amd64", file_path.c_str(), "test.txt").success);
+    EXPECT_STREQ(lgx_get_version(pkg), "1.0.0");
+    EXPECT_STREQ(lgx_get_version(clone), "2.0.0");
+    EXPECT_FALSE(lgx_has_variant(pkg, "linux-amd64"));
+    EXPECT_TRUE(lgx_has_variant(clone, "linux-amd64"));
+
+    // The clone outlives its source
+    lgx_free_package(pkg);
+    EXPECT_STREQ(lgx_get_name(clone), "testpkg");
+    lgx_free_package(clone);
+
+    EXPECT_EQ(lgx_package_clone(nullptr), nullptr);
+}
+
+TEST_F(LibraryTest, ConcurrentReadsOnSharedHandle) {
+    auto output_path = (test_dir_ / "test.lgx").string();
+    auto file_path = (test_dir_ / "test.txt").string();
+    std::ofstream(file_path) << "test content";
+
+    lgx_create(output_path.c_str(), "testpkg");
+    lgx_package_t pkg = lgx_load(output_path.c_str());
+    ASSERT_NE(pkg, nullptr);
+    lgx_set_version(pkg, "1.2.3");
+    lgx_set_description(pkg, "shared handle");
+    ASSERT_TRUE(lgx_add_variant(pkg, "linux-amd64", file_path.c_str(), "test.txt").success);
+
+    const std::string expected_json = lgx_get_manifest_json(pkg);
+    constexpr int kThreads = 8;
+    constexpr int kIterations = 50;
+    std::atomic<int> failures{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            auto extract_dir = (test_dir_ / ("extract_" + std::to_string(t))).string();
+            for (int i = 0; i < kIterations; ++i) {
+                if (std::strcmp(lgx_get_name(pkg), "testpkg") != 0) ++failures;
+                if (std::strcmp(lgx_get_version(pkg), "1.2.3") != 0) ++failures;
+                if (std::strcmp(lgx_get_description(pkg), "shared handle") != 0) ++failures;
+                if (expected_json != lgx_get_manifest_json(pkg)) ++failures;
+                if (!lgx_has_variant(pkg, "linux-amd64")) ++failures;
+
+                const char** variants = lgx_get_variants(pkg);
+                if (!variants || !variants[0]) ++failures;
+                lgx_free_string_array(variants);
+
+                // A clone shares the package; mutating it must not disturb readers
+                lgx_package_t clone = lgx_package_clone(pkg);
+                lgx_set_version(clone, "9.9.9");
+                if (std::strcmp(lgx_get_version(clone), "9.9.9") != 0) ++failures;
+                lgx_free_package(clone);
+
+                void* data = nullptr;
+                size_t size = 0;
+                if (!lgx_save_to_buffer(pkg, &data, &size).success) ++failures;
+                lgx_free_buffer(data);
+
+                if (i % 10 == 0 && !lgx_extract(pkg, "linux-amd64", extract_dir.c_str()).success) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_STREQ(lgx_get_version(pkg), "1.2.3");
+    lgx_free_package(pkg);
+}
+
+// =============================================================================
+// Decoded-package cache
+// =============================================================================
+
+TEST_F(LibraryTest, CacheHitsAndInvalidation) {
+    auto output_path = (test_dir_ / "test.lgx").string();
+    ASSERT_TRUE(lgx_create(output_path.c_str(), "testpkg").success);
+
+    lgx_cache_set_budget(64 * 1024 * 1024);
+    lgx_cache_clear();
+    lgx_cache_reset_stats();
+    EXPECT_EQ(lgx_cache_get_budget(), 64u * 1024 * 1024);
+
+    lgx_package_t first = lgx_load(output_path.c_str());
+    lgx_package_t second = lgx_load(output_path.c_str());
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+
+    lgx_cache_stats_t stats = lgx_cache_get_stats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.entries, 1u);
+    EXPECT_GT(stats.bytes, 0u);
+
+    // Modifying a cached handle must not leak into the cache or other handles
+    lgx_set_version(first, "7.7.7-modified");
+    lgx_package_t third = lgx_load(output_path.c_str());
+    ASSERT_NE(third, nullptr);
+    EXPECT_STRNE(lgx_get_version(third), "7.7.7-modified");
+    EXPECT_STRNE(lgx_get_version(second), "7.7.7-modified");
+
+    // Saving changes the file on disk, so the next load decodes it again
+    ASSERT_TRUE(lgx_save(first, output_path.c_str()).success);
+    lgx_package_t fourth = lgx_load(output_path.c_str());
+    ASSERT_NE(fourth, nullptr);
+    EXPECT_STREQ(lgx_get_version(fourth), "7.7.7-modified");
+    EXPECT_EQ(lgx_cache_get_stats().misses, 2u);
+
+    lgx_free_package(first);
+    lgx_free_package(second);
+    lgx_free_package(third);
+    lgx_free_package(fourth);
+
+    lgx_cache_set_budget(0);
+    stats = lgx_cache_get_stats();
+    EXPECT_EQ(stats.entries, 0u);
+    EXPECT_EQ(stats.budget, 0u);
+}
+
+// =============================================================================
+// Operation statistics
+// =============================================================================
+
+TEST_F(LibraryTest, OperationStats) {
+    auto output_path = (test_dir_ / "test.lgx").string();
+    ASSERT_TRUE(lgx_create(output_path.c_str(), "testpkg").success);
+
+    lgx_stats_reset();
+    lgx_package_t pkg = lgx_load(output_path.c_str());
+    ASSERT_NE(pkg, nullptr);
+    lgx_free_package(pkg);
+    EXPECT_EQ(lgx_get_stats().inflate.calls, 0u);  // disabled by default
+
+    lgx_stats_enable(true);
+    pkg = lgx_load(output_path.c_str());
+    ASSERT_NE(pkg, nullptr);
+    ASSERT_TRUE(lgx_save(pkg, output_path.c_str()).success);
+    lgx_free_package(pkg);
+    lgx_stats_enable(false);
+
+    lgx_stats_t stats = lgx_get_stats();
+    EXPECT_EQ(stats.file_read.calls, 1u);
+    EXPECT_GT(stats.file_read.bytes_in, 0u);
+    EXPECT_EQ(stats.inflate.calls, 1u);
+    EXPECT_EQ(stats.inflate.bytes_in, stats.file_read.bytes_in);
+    EXPECT_GT(stats.inflate.bytes_out, stats.inflate.bytes_in);
+    EXPECT_EQ(stats.tar_parse.calls, 1u);
+    EXPECT_EQ(stats.tar_parse.bytes_in, stats.inflate.bytes_out);
+    EXPECT_GT(stats.tar_parse.entries, 0u);
+    EXPECT_EQ(stats.tar_write.calls, 1u);
+    EXPECT_EQ(stats.deflate.calls, 1u);
+    EXPECT_GT(stats.file_write.bytes_out, 0u);
+    EXPECT_GE(stats.peak_buffer_bytes, stats.inflate.bytes_out);
+
+    lgx_stats_reset();
+    stats = lgx_get_stats();
+    EXPECT_EQ(stats.inflate.calls, 0u);
+    EXPECT_EQ(stats.peak_buffer_bytes, 0u);
+}
+
+TEST_F(LibraryTest, CatalogUpdateAndFind) {
+    auto repo = test_dir_ / "repo";
+    std::filesystem::create_directories(repo / "sub");
+    ASSERT_TRUE(lgx_create((repo / "alpha.lgx").string().c_str(), "alpha").success);
+    ASSERT_TRUE(lgx_create((repo / "sub" / "beta.lgx").string().c_str(), "beta").success);
+
+    lgx_catalog_update_stats_t stats{};
+    lgx_result_t result = lgx_catalog_update(repo.string().c_str(), nullptr, false, &stats);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(stats.scanned, 2u);
+    EXPECT_EQ(stats.parsed, 2u);
+
+    ASSERT_TRUE(lgx_catalog_update(repo.string().c_str(), nullptr, false, &stats).success);
+    EXPECT_EQ(stats.parsed, 0u);
+    EXPECT_EQ(stats.unchanged, 2u);
+
+    lgx_catalog_t catalog = lgx_catalog_open(repo.string().c_str(), nullptr);
+    ASSERT_NE(catalog, nullptr);
+
+    lgx_catalog_list_t list{};
+    ASSERT_TRUE(lgx_catalog_find(catalog, "beta", "^0.0.1", nullptr, &list).success);
+    ASSERT_EQ(list.count, 1u);
+    EXPECT_STREQ(list.entries[0].name, "beta");
+    EXPECT_STREQ(list.entries[0].version, "0.0.1");
+    EXPECT_EQ(std::filesystem::path(list.entries[0].path), repo / "sub" / "beta.lgx");
+    EXPECT_EQ(list.entries[0].signer, nullptr);
+    ASSERT_NE(list.entries[0].dependencies, nullptr);
+    EXPECT_EQ(list.entries[0].dependencies[0], nullptr);
+    lgx_free_catalog_list(list);
+
+    ASSERT_TRUE(lgx_catalog_find(catalog, nullptr, nullptr, nullptr, &list).success);
+    EXPECT_EQ(list.count, 2u);
+    lgx_free_catalog_list(list);
+
+    EXPECT_FALSE(lgx_catalog_find(catalog, nullptr, "not-a-range", nullptr, &list).success);
+    EXPECT_EQ(list.entries, nullptr);
+
+    lgx_catalog_free(catalog);
+    EXPECT_EQ(lgx_catalog_open((test_dir_ / "none").string().c_str(), nullptr), nullptr);
+    EXPECT_FALSE(lgx_catalog_update(nullptr, nullptr, false, nullptr).success);
+}
+
+TEST_F(LibraryTest, ResolveAgainstCatalog) {
+    auto repo = test_dir_ / "repo";
+    std::filesystem::create_directories(repo);
+    ASSERT_TRUE(lgx_create((repo / "app.lgx").string().c_str(), "app").success);
+    ASSERT_TRUE(lgx_create((repo / "net.lgx").string().c_str(), "net").success);
+
+    ASSERT_TRUE(lgx_catalog_update(repo.string().c_str(), nullptr, false, nullptr).success);
+    lgx_catalog_t catalog = lgx_catalog_open(repo.string().c_str(), nullptr);
+    ASSERT_NE(catalog, nullptr);
+
+    lgx_requirement_t requirements[] = {{"net", nullptr, nullptr}, {"app", "^0.0.1", nullptr}};
+    lgx_resolution_t resolution{};
+    lgx_result_t result = lgx_resolve(catalog, requirements, 2, &resolution);
+    ASSERT_TRUE(result.success) << result.error;
+    ASSERT_EQ(resolution.count, 2u);
+    EXPECT_STREQ(resolution.packages[0].name, "app");
+    EXPECT_STREQ(resolution.packages[1].name, "net");
+    EXPECT_EQ(std::filesystem::path(resolution.packages[1].path), repo / "net.lgx");
+    EXPECT_EQ(resolution.packages[1].signer, nullptr);
+    lgx_free_resolution(resolution);
+
+    lgx_requirement_t pinned = {"net", nullptr, "did:jwk:nobody"};
+    result = lgx_resolve(catalog, &pinned, 1, &resolution);
+    EXPECT_FALSE(result.success);
+    EXPECT_NE(std::string(lgx_get_last_error()).find("did:jwk:nobody"), std::string::npos);
+    EXPECT_EQ(resolution.packages, nullptr);
+
+    EXPECT_FALSE(lgx_resolve(nullptr, requirements, 1, &resolution).success);
+    lgx_catalog_free(catalog);
+}
+
+TEST_F(LibraryTest, LockAddAndCheck) {
+    auto pkgPath = (test_dir_ / "net.lgx").string();
+    auto otherPath = (test_dir_ / "ui.lgx").string();
+    auto lockPath = (test_dir_ / "lgx.lock").string();
+    ASSERT_TRUE(lgx_create(pkgPath.c_str(), "net").success);
+    ASSERT_TRUE(lgx_create(otherPath.c_str(), "ui").success);
+
+    EXPECT_EQ(lgx_lock_check(lockPath.c_str(), pkgPath.c_str()), LGX_LOCK_ERROR);  // no lockfile
+
+    lgx_result_t result = lgx_lock_add(lockPath.c_str(), pkgPath.c_str());
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(lgx_lock_check(lockPath.c_str(), pkgPath.c_str()), LGX_LOCK_MATCH);
+    EXPECT_EQ(lgx_lock_check(lockPath.c_str(), otherPath.c_str()), LGX_LOCK_NOT_LOCKED);
+
+    std::ofstream(pkgPath, std::ios::app) << "x";
+    EXPECT_EQ(lgx_lock_check(lockPath.c_str(), pkgPath.c_str()), LGX_LOCK_MISMATCH);
+    EXPECT_NE(std::string(lgx_get_last_error()).find("size"), std::string::npos);
+
+    auto junkPath = (test_dir_ / "junk.lgx").string();
+    std::ofstream(junkPath) << "not a package";
+    EXPECT_FALSE(lgx_lock_add(lockPath.c_str(), junkPath.c_str()).success);
+    EXPECT_FALSE(lgx_lock_add(nullptr, pkgPath.c_str()).success);
+}
+
+TEST_F(LibraryTest, BuildFromSpec) {
+    std::filesystem::create_directories(test_dir_ / "linux");
+    std::ofstream(test_dir_ / "linux" / "mod.so") << "library";
+    auto specPath = (test_dir_ / "build.json").string();
+    std::ofstream(specPath) << R"({"name": "specmod", "version": "2.0.0",
+        "variants": {"linux-amd64": {"files": "linux", "main": "mod.so"}}})";
+
+    auto outPath = (test_dir_ / "specmod.lgx").string();
+    lgx_result_t result = lgx_build(specPath.c_str(), outPath.c_str());
+    ASSERT_TRUE(result.success) << result.error;
+
+    lgx_package_t pkg = lgx_load(outPath.c_str());
+    ASSERT_NE(pkg, nullptr);
+    EXPECT_STREQ(lgx_get_name(pkg), "specmod");
+    EXPECT_STREQ(lgx_get_version(pkg), "2.0.0");
+    lgx_free_package(pkg);
+
+    EXPECT_FALSE(lgx_build(nullptr, outPath.c_str()).success);
+    EXPECT_FALSE(lgx_build((test_dir_ / "missing.json").string().c_str(), outPath.c_str()).success);
+}
+
+// =============================================================================
+// Allocator hooks
+// =============================================================================
+
+namespace {
+
+struct CountingAllocator {
+    std::mutex mutex;
+    std::set<void*> live;
+    size_t allocations = 0;
+};
+
+CountingAllocator g_counting;
+
+void* counting_malloc(size_t size, void* user_data) {
+    auto* counter = static_cast<CountingAllocator*>(user_data);
+    void* ptr = malloc(size);
+    std::lock_guard<std::mutex> lock(counter->mutex);
+    counter->live.insert(ptr);
+    ++counter->allocations;
+    return ptr;
+}
+
+void* counting_realloc(void* ptr, size_t size, void* user_data) {
+    auto* counter = static_cast<CountingAllocator*>(user_data);
+    void* grown = realloc(ptr, size);
+    std::lock_guard<std::mutex> lock(counter->mutex);
+    counter->live.erase(ptr);
+    counter->live.insert(grown);
+    ++counter->allocations;
+    return grown;
+}
+
+void counting_free(void* ptr, void* user_data) {
+    auto* counter = static_cast<CountingAllocator*>(user_data);
+    {
+        std::lock_guard<std::mutex> lock(counter->mutex);
+        counter->live.erase(ptr);
+    }
+    free(ptr);
+}
+
+bool is_live(void* ptr) {
+    std::lock_guard<std::mutex> lock(g_counting.mutex);
+    return g_counting.live.count(ptr) > 0;
+}
+
+} // anonymous namespace
+
+TEST_F(LibraryTest, AllocatorHooks) {
+    auto output_path = (test_dir_ / "test.lgx").string();
+    ASSERT_TRUE(lgx_create(output_path.c_str(), "testpkg").success);
+
+    lgx_allocator_t incomplete = {counting_malloc, nullptr, counting_free, &g_counting};
+    EXPECT_FALSE(lgx_set_allocator(&incomplete));
+    EXPECT_NE(lgx_get_last_error(), nullptr);
+
+    lgx_allocator_t allocator = {counting_malloc, counting_realloc, counting_free, &g_counting};
+    ASSERT_TRUE(lgx_set_allocator(&allocator));
+
+    lgx_package_t pkg = lgx_load(output_path.c_str());
+    ASSERT_NE(pkg, nullptr);
+
+    const char** variants = lgx_get_variants(pkg);
+    ASSERT_NE(variants, nullptr);
+    EXPECT_TRUE(is_live(variants));
+
+    void* data = nullptr;
+    size_t size = 0;
+    ASSERT_TRUE(lgx_save_to_buffer(pkg, &data, &size).success);
+    EXPECT_TRUE(is_live(data));
+
+    lgx_free_string_array(variants);
+    lgx_free_buffer(data);
+    EXPECT_FALSE(is_live(variants));
+    EXPECT_FALSE(is_live(data));
+    EXPECT_GT(g_counting.allocations, 0u);
+
+    lgx_free_package(pkg);
+    EXPECT_TRUE(lgx_set_allocator(nullptr));
+
+    // Buffers returned under the default allocator bypass the hooks again
+    pkg = lgx_load(output_path.c_str());
+    ASSERT_NE(pkg, nullptr);
+    size_t before = g_counting.allocations;
+    variants = lgx_get_variants(pkg);
+    lgx_free_string_array(variants);
+    EXPECT_EQ(g_counting.allocations, before);
+    lgx_free_package(pkg);
+}
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include "core/lockfile.h"
+#include "core/package.h"
+#include "core/stats.h"
+#include "crypto/signing.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace lgx;
+namespace fs = std::filesystem;
+
+class LockfileTest : public ::testing::Test {
+protected:
+    fs::path tempDir;
+
+    void SetUp() override {
+        ASSERT_TRUE(crypto::init());
+        tempDir = fs::temp_directory_path() / ("lgx_lockfile_test_" + std::to_string(rand()));
+        fs::create_directories(tempDir / "dist");
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(tempDir, ec);
+    }
+
+    fs::path createPackage(const std::string& file, const std::string& name,
+                           const std::string& version, const crypto::KeyPair* signer = nullptr) {
+        fs::path pkgPath = tempDir / "dist" / file;
+        EXPECT_TRUE(Package::create(pkgPath, name).success);
+        fs::path payload = tempDir / (name + ".bin");
+        std::ofstream(payload, std::ios::binary) << "payload of " << name << " " << version;
+
+        auto pkg = Package::load(pkgPath);
+        EXPECT_TRUE(pkg.has_value());
+        pkg->getManifest().version = version;
+        EXPECT_TRUE(pkg->addVariant("linux-amd64", payload).success);
+        if (signer) {
+            EXPECT_TRUE(pkg->signPackage(signer->secretKey).success);
+        }
+        EXPECT_TRUE(pkg->save(pkgPath).success);
+        return pkgPath;
+    }
+
+    static std::vector<uint8_t> readFile(const fs::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    static void writeFile(const fs::path& path, const std::vector<uint8_t>& data) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc)
+            .write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+};
+
+TEST_F(LockfileTest, DescribesVerifiedPackages) {
+    auto kp = crypto::generateKeypair();
+    fs::path pkgPath = createPackage("net.lgx", "net", "1.2.0", &kp);
+
+    auto entry = Lockfile::describe(pkgPath, tempDir);
+    ASSERT_TRUE(entry.has_value()) << Lockfile::getLastError();
+    EXPECT_EQ(entry->name, "net");
+    EXPECT_EQ(entry->version, "1.2.0");
+    EXPECT_EQ(entry->signer, crypto::publicKeyToDid(kp.publicKey));
+    EXPECT_EQ(entry->size, fs::file_size(pkgPath));
+    EXPECT_EQ(entry->sha256, crypto::sha256Hex(readFile(pkgPath)));
+    EXPECT_EQ(entry->rootHash, Package::load(pkgPath)->getManifest().hashes.at("root"));
+    EXPECT_EQ(entry->path, "dist/net.lgx");
+
+    // Save and reload: the lock round-trips and stays sorted by name
+    Lockfile lock;
+    auto other = Lockfile::describe(createPackage("app.lgx", "app", "0.1.0"), tempDir);
+    ASSERT_TRUE(other.has_value());
+    EXPECT_TRUE(other->signer.empty());
+    lock.set(*entry);
+    lock.set(*other);
+    fs::path lockPath = tempDir / Lockfile::DEFAULT_FILENAME;
+    ASSERT_TRUE(lock.save(lockPath)) << Lockfile::getLastError();
+
+    auto loaded = Lockfile::load(lockPath);
+    ASSERT_TRUE(loaded.has_value()) << Lockfile::getLastError();
+    ASSERT_EQ(loaded->entries().size(), 2u);
+    EXPECT_EQ(loaded->entries()[0].name, "app");
+    ASSERT_NE(loaded->find("NET"), nullptr);
+    EXPECT_EQ(loaded->find("net")->sha256, entry->sha256);
+    EXPECT_EQ(loaded->find("net")->signer, entry->signer);
+}
+
+TEST_F(LockfileTest, CheckMatchesInOneHashPass) {
+    fs::path pkgPath = createPackage("net.lgx", "net", "1.2.0");
+    Lockfile lock;
+    lock.set(*Lockfile::describe(pkgPath, tempDir));
+
+    Stats::reset();
+    Stats::setEnabled(true);
+    auto result = lock.check(pkgPath, tempDir);
+    auto snapshot = Stats::snapshot();
+    Stats::setEnabled(false);
+
+    EXPECT_EQ(result.status, Lockfile::Status::Match) << result.error;
+    ASSERT_NE(result.entry, nullptr);
+    EXPECT_EQ(result.entry->name, "net");
+    EXPECT_EQ(snapshot[Stats::Phase::Inflate].calls, 0u);
+    EXPECT_EQ(snapshot[Stats::Phase::Hash].bytesIn, fs::file_size(pkgPath));
+
+    // A copy elsewhere is matched by its name
+    fs::copy_file(pkgPath, tempDir / "copy.lgx");
+    EXPECT_EQ(lock.check(tempDir / "copy.lgx", tempDir).status, Lockfile::Status::Match);
+}
+
+TEST_F(LockfileTest, CheckRejectsAnyDifference) {
+    fs::path pkgPath = createPackage("net.lgx", "net", "1.2.0");
+    Lockfile lock;
+    lock.set(*Lockfile::describe(pkgPath, tempDir));
+    auto original = readFile(pkgPath);
+
+    // Same size, one byte flipped
+    auto flipped = original;
+    flipped[flipped.size() / 2] ^= 0x01;
+    writeFile(pkgPath, flipped);
+    auto result = lock.check(pkgPath, tempDir);
+    EXPECT_EQ(result.status, Lockfile::Status::Mismatch);
+    EXPECT_NE(result.error.find("SHA-256"), std::string::npos) << result.error;
+
+    // Truncated
+    writeFile(pkgPath, std::vector<uint8_t>(original.begin(), original.end() - 1));
+    result = lock.check(pkgPath, tempDir);
+    EXPECT_EQ(result.status, Lockfile::Status::Mismatch);
+    EXPECT_NE(result.error.find("size"), std::string::npos) << result.error;
+
+    // Another version of the package, found by name from a different path
+    fs::path newer = createPackage("net-1.3.0.lgx", "net", "1.3.0");
+    result = lock.check(newer, tempDir);
+    EXPECT_EQ(result.status, Lockfile::Status::Mismatch);
+    EXPECT_NE(result.error.find("1.3.0"), std::string::npos) << result.error;
+
+    // Not in the lock at all
+    fs::path unrelated = createPackage("ui.lgx", "ui", "1.0.0");
+    EXPECT_EQ(lock.check(unrelated, tempDir).status, Lockfile::Status::NotLocked);
+
+    fs::remove(pkgPath);
+    EXPECT_EQ(lock.check(pkgPath, tempDir).status, Lockfile::Status::Error);
+}
+
+TEST_F(LockfileTest, RefusesToLockInvalidPackages) {
+    auto kp = crypto::generateKeypair();
+    fs::path pkgPath = createPackage("net.lgx", "net", "1.2.0", &kp);
+
+    // Change the manifest after signing: the signature no longer verifies
+    auto pkg = Package::load(pkgPath);
+    ASSERT_TRUE(pkg.has_value());
+    pkg->getManifest().description = "tampered";
+    ASSERT_TRUE(pkg->save(pkgPath).success);
+    EXPECT_FALSE(Lockfile::describe(pkgPath, tempDir).has_value());
+
+    std::ofstream(tempDir / "junk.lgx") << "not a package";
+    EXPECT_FALSE(Lockfile::describe(tempDir / "junk.lgx", tempDir).has_value());
+}
+
+TEST_F(LockfileTest, LoadRejectsMalformedFiles) {
+    fs::path lockPath = tempDir / "lgx.lock";
+    EXPECT_FALSE(Lockfile::load(lockPath).has_value());
+
+    std::ofstream(lockPath) << "{not json";
+    EXPECT_FALSE(Lockfile::load(lockPath).has_value());
+
+    std::ofstream(lockPath, std::ios::trunc) << R"({"lockfileVersion": 99, "packages": []})";
+    EXPECT_FALSE(Lockfile::load(lockPath).has_value());
+
+    std::ofstream(lockPath, std::ios::trunc)
+        << R"({"lockfileVersion": 1, "packages": [{"name": "x"}]})";
+    EXPECT_FALSE(Lockfile::load(lockPath).has_value());
+
+    std::ofstream(lockPath, std::ios::trunc) << R"({"lockfileVersion": 1, "packages": []})";
+    auto empty = Lockfile::load(lockPath);
+    ASSERT_TRUE(empty.has_value());
+    EXPECT_TRUE(empty->entries().empty());
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "core/memory.h"
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace lgx;
+
+namespace {
+
+size_t g_allocations = 0;
+size_t g_releases = 0;
+
+void* countingAllocate(size_t size, void*) {
+    ++g_allocations;
+    return std::malloc(size);
+}
+
+void* countingReallocate(void* ptr, size_t size, void*) {
+    ++g_allocations;
+    return std::realloc(ptr, size);
+}
+
+void countingRelease(void* ptr, void*) {
+    ++g_releases;
+    std::free(ptr);
+}
+
+} // anonymous namespace
+
+TEST(MemoryTest, SetHooksRejectsIncompleteHooks) {
+    Memory::Hooks hooks = {countingAllocate, nullptr, countingRelease, nullptr};
+    EXPECT_FALSE(Memory::setHooks(&hooks));
+    EXPECT_NE(Memory::getHooks().allocate, countingAllocate);
+}
+
+TEST(MemoryTest, AllocationsGoThroughHooks) {
+    Memory::Hooks hooks = {countingAllocate, countingReallocate, countingRelease, nullptr};
+    ASSERT_TRUE(Memory::setHooks(&hooks));
+    g_allocations = 0;
+    g_releases = 0;
+
+    void* ptr = Memory::allocate(16);
+    ptr = Memory::reallocate(ptr, 64);
+    Memory::release(ptr);
+    Memory::release(nullptr);
+
+    EXPECT_EQ(g_allocations, 2u);
+    EXPECT_EQ(g_releases, 1u);
+    EXPECT_TRUE(Memory::setHooks(nullptr));
+}
+
+TEST(MemoryTest, ScratchBufferAppendAndWrite) {
+    ScratchBuffer buffer;
+    const uint8_t bytes[] = {1, 2, 3, 4};
+    ASSERT_TRUE(buffer.write(bytes, sizeof(bytes)));
+
+    uint8_t* tail = buffer.append(2);
+    ASSERT_NE(tail, nullptr);
+    tail[0] = 5;
+    tail[1] = 6;
+
+    ASSERT_EQ(buffer.size(), 6u);
+    EXPECT_EQ(buffer.data()[0], 1);
+    EXPECT_EQ(buffer.data()[5], 6);
+
+    buffer.clear();
+    EXPECT_EQ(buffer.size(), 0u);
+    EXPECT_GE(buffer.capacity(), 6u);
+}
+
+TEST(MemoryTest, ScratchBufferFreesWithOwningHooks) {
+    Memory::Hooks hooks = {countingAllocate, countingReallocate, countingRelease, nullptr};
+    ASSERT_TRUE(Memory::setHooks(&hooks));
+    g_releases = 0;
+    {
+        ScratchBuffer buffer;
+        ASSERT_TRUE(buffer.reserve(128));
+        // Restoring the defaults must not change who frees the storage
+        ASSERT_TRUE(Memory::setHooks(nullptr));
+    }
+    EXPECT_EQ(g_releases, 1u);
+}
+
+TEST(MemoryTest, ScratchLeaseReusesThreadBuffer) {
+    const uint8_t* first = nullptr;
+    {
+        ScratchLease lease;
+        ASSERT_NE(lease.buffer().append(4096), nullptr);
+        first = lease.buffer().data();
+    }
+    {
+        ScratchLease lease;
+        EXPECT_EQ(lease.buffer().size(), 0u);
+        EXPECT_GE(lease.buffer().capacity(), 4096u);
+        ASSERT_NE(lease.buffer().append(4096), nullptr);
+        EXPECT_EQ(lease.buffer().data(), first);
+    }
+}
+
+TEST(MemoryTest, ScratchLeasesAreExclusive) {
+    ScratchLease a;
+    ScratchLease b;
+    ScratchLease c;  // all thread buffers taken: gets a private buffer
+    EXPECT_NE(&a.buffer(), &b.buffer());
+    EXPECT_NE(&b.buffer(), &c.buffer());
+    EXPECT_NE(&a.buffer(), &c.buffer());
+}
+
+TEST(MemoryTest, ScratchLeaseDropsOversizedStorage) {
+    {
+        ScratchLease lease;
+        ASSERT_TRUE(lease.buffer().reserve(ScratchBuffer::RETAIN_LIMIT + 1));
+    }
+    ScratchLease lease;
+    EXPECT_EQ(lease.buffer().capacity(), 0u);
+}
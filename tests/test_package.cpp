@@ -6,8 +6,11 @@
 #include "crypto/signing.h"
 #include "crypto/keyring.h"
 
+#include <atomic>
 #include <filesystem>
+#include <functional>
 #include <fstream>
+#include <thread>
 
 using namespace lgx;
 namespace fs = std::filesystem;
@@ -36,6 +39,12 @@ protected:
         file << content;
     }
     
+    // Helper to read a file's contents
+    static std::string readFile(const fs::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+    
     // Helper to create a test directory with files
     void createTestDirectory(const fs::path& dir,
                             const std::map<std::string, std::string>& files) {
@@ -357,6 +366,81 @@ TEST_F(PackageTest, AddVariant_NoMerge) {
     EXPECT_EQ(*mainPath, "file2.so");
 }
 
+TEST_F(PackageTest, AddVariant_IdenticalInputsUnchanged) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    fs::path dir = tempDir / "build";
+    createTestDirectory(dir, {{"lib.so", "library"}, {"res/data.txt", "data"}});
+    fs::create_directories(dir / "empty");
+    Package::create(pkgPath, "testpkg");
+
+    auto pkg = Package::load(pkgPath);
+    ASSERT_TRUE(pkg.has_value());
+    auto result = pkg->addVariant("linux-amd64", dir, std::string("lib.so"));
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_FALSE(result.unchanged);
+    ASSERT_TRUE(pkg->signPackage(crypto::generateKeypair().secretKey).success);
+    ASSERT_TRUE(pkg->save(pkgPath).success);
+
+    // Same files and main, read back from disk: nothing to do
+    pkg = Package::load(pkgPath);
+    ASSERT_TRUE(pkg.has_value());
+    auto hashes = pkg->getManifest().hashes;
+    result = pkg->addVariant("Linux-AMD64", dir, std::string("lib.so"));
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_TRUE(result.unchanged);
+    EXPECT_TRUE(pkg->isSigned());
+    EXPECT_EQ(pkg->getManifest().hashes, hashes);
+
+    // Anything the archive would store differently is a change
+    auto changes = [&](const std::function<void()>& edit, const std::string& main = "lib.so") {
+        edit();
+        auto fresh = Package::load(pkgPath);
+        auto r = fresh->addVariant("linux-amd64", dir, main);
+        EXPECT_TRUE(r.success) << r.error;
+        return !r.unchanged && !fresh->isSigned();
+    };
+    EXPECT_TRUE(changes([] {}, "res/data.txt"));
+    EXPECT_TRUE(changes([&] {
+        fs::permissions(dir / "lib.so", fs::perms::owner_exec, fs::perm_options::add);
+    }));
+    EXPECT_TRUE(changes([&] {
+        fs::permissions(dir / "lib.so", fs::perms::owner_exec, fs::perm_options::remove);
+        fs::remove(dir / "empty");
+    }));
+    EXPECT_TRUE(changes([&] {
+        fs::create_directories(dir / "empty");
+        createTestFile(dir / "res/data.txt", "DATA");
+    }));
+    EXPECT_TRUE(changes([&] {
+        createTestFile(dir / "res/data.txt", "data");
+        createTestFile(dir / "res/new.txt", "new");
+    }));
+    fs::remove(dir / "res/new.txt");
+    EXPECT_FALSE(changes([] {}));
+}
+
+TEST_F(PackageTest, SameContentIgnoresSignatureOnly) {
+    fs::path file = tempDir / "lib.so";
+    createTestFile(file, "library");
+
+    Package a = Package::skeleton("testpkg");
+    Package b = Package::skeleton("TestPkg");
+    ASSERT_TRUE(a.addVariant("linux-amd64", file).success);
+    ASSERT_TRUE(b.addVariant("linux-amd64", file).success);
+    EXPECT_TRUE(a.sameContent(b));
+
+    // A signed copy read back from disk still matches
+    fs::path pkgPath = tempDir / "test.lgx";
+    ASSERT_TRUE(a.save(pkgPath).success);
+    auto loaded = Package::load(pkgPath);
+    ASSERT_TRUE(loaded.has_value());
+    ASSERT_TRUE(loaded->signPackage(crypto::generateKeypair().secretKey).success);
+    EXPECT_TRUE(loaded->sameContent(b));
+
+    b.getManifest().version = "2.0.0";
+    EXPECT_FALSE(loaded->sameContent(b));
+}
+
 // =============================================================================
 // Remove Variant Tests
 // =============================================================================
@@ -526,6 +610,159 @@ TEST_F(PackageTest, SaveLoad_Roundtrip) {
     EXPECT_TRUE(pkg2->hasVariant("linux-amd64"));
 }
 
+TEST_F(PackageTest, SaveToSink_MatchesSaveToFile) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    Package::create(pkgPath, "testpkg");
+
+    fs::path file = tempDir / "lib.so";
+    createTestFile(file, "binary content here");
+
+    auto pkg = Package::load(pkgPath);
+    ASSERT_TRUE(pkg.has_value());
+    ASSERT_TRUE(pkg->addVariant("linux-amd64", file).success);
+    ASSERT_TRUE(pkg->save(pkgPath).success);
+
+    std::vector<uint8_t> buffer;
+    VectorByteSink sink(buffer);
+    ASSERT_TRUE(pkg->save(sink).success);
+
+    FileByteSource onDisk(pkgPath);
+    ASSERT_TRUE(onDisk.isOpen());
+    EXPECT_EQ(buffer, std::vector<uint8_t>(onDisk.data(), onDisk.data() + onDisk.size()));
+}
+
+TEST_F(PackageTest, SaveToSink_WriteFailure) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    Package::create(pkgPath, "testpkg");
+    auto pkg = Package::load(pkgPath);
+    ASSERT_TRUE(pkg.has_value());
+
+    CallbackByteSink sink([](const uint8_t*, size_t) { return false; });
+    auto result = pkg->save(sink);
+    EXPECT_FALSE(result.success);
+    EXPECT_FALSE(result.error.empty());
+}
+
+TEST_F(PackageTest, Save_ReplacesAtomically) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    ASSERT_TRUE(Package::create(pkgPath, "testpkg").success);
+    auto pkg = Package::load(pkgPath);
+    ASSERT_TRUE(pkg.has_value());
+    pkg->getManifest().version = "2.0.0";
+
+    // No temporary file is left behind, whatever happens
+    auto leftovers = [this]() {
+        size_t count = 0;
+        for (const auto& entry : fs::recursive_directory_iterator(tempDir)) {
+            count += entry.path().filename().string().find(".tmp.") != std::string::npos;
+        }
+        return count;
+    };
+
+    // A user file named like a fixed temporary name is left alone
+    createTestFile(tempDir / "test.lgx.tmp", "user data");
+
+    for (auto durability : {Package::Durability::Default, Package::Durability::Durable}) {
+        ASSERT_TRUE(pkg->save(pkgPath, durability).success);
+        EXPECT_EQ(leftovers(), 0u);
+        auto reloaded = Package::load(pkgPath);
+        ASSERT_TRUE(reloaded.has_value());
+        EXPECT_EQ(reloaded->getManifest().version, "2.0.0");
+    }
+    EXPECT_EQ(readFile(tempDir / "test.lgx.tmp"), "user data");
+
+    // A save that cannot replace the target leaves it as it was
+    auto before = readFile(pkgPath);
+    fs::create_directories(tempDir / "dir.lgx/child");
+    EXPECT_FALSE(pkg->save(tempDir / "dir.lgx").success);
+    EXPECT_TRUE(fs::is_directory(tempDir / "dir.lgx/child"));
+    EXPECT_FALSE(pkg->save(tempDir / "missing" / "test.lgx").success);
+    EXPECT_EQ(readFile(pkgPath), before);
+    EXPECT_EQ(leftovers(), 0u);
+}
+
+TEST_F(PackageTest, Save_KeepsSymlinkAndPermissions) {
+    fs::path realPath = tempDir / "real.lgx";
+    fs::path linkPath = tempDir / "link.lgx";
+    ASSERT_TRUE(Package::create(realPath, "testpkg").success);
+    fs::permissions(realPath, fs::perms::owner_read | fs::perms::owner_write | fs::perms::group_read,
+                    fs::perm_options::replace);
+    fs::create_symlink("real.lgx", linkPath);
+
+    auto pkg = Package::load(linkPath);
+    ASSERT_TRUE(pkg.has_value());
+    pkg->getManifest().version = "2.0.0";
+    ASSERT_TRUE(pkg->save(linkPath).success);
+
+    EXPECT_TRUE(fs::is_symlink(linkPath));
+    EXPECT_EQ(fs::read_symlink(linkPath), fs::path("real.lgx"));
+    EXPECT_EQ(fs::status(realPath).permissions(),
+              fs::perms::owner_read | fs::perms::owner_write | fs::perms::group_read);
+    auto reloaded = Package::load(realPath);
+    ASSERT_TRUE(reloaded.has_value());
+    EXPECT_EQ(reloaded->getManifest().version, "2.0.0");
+
+    // Concurrent saves to one target each use their own temporary file
+    std::vector<std::thread> savers;
+    std::atomic<int> saved{0};
+    for (int i = 0; i < 4; ++i) {
+        savers.emplace_back([&] { saved += pkg->save(realPath).success; });
+    }
+    for (auto& t : savers) {
+        t.join();
+    }
+    EXPECT_EQ(saved.load(), 4);
+    EXPECT_TRUE(Package::load(realPath).has_value());
+}
+
+TEST_F(PackageTest, IsSaveOutput_MatchesTargetAndTemporaries) {
+    fs::path realPath = tempDir / "real.lgx";
+    fs::path linkPath = tempDir / "link.lgx";
+    ASSERT_TRUE(Package::create(realPath, "testpkg").success);
+    fs::create_symlink("real.lgx", linkPath);
+
+    EXPECT_TRUE(Package::isSaveOutput(linkPath, linkPath));
+    EXPECT_TRUE(Package::isSaveOutput(realPath, linkPath));
+    EXPECT_TRUE(Package::isSaveOutput(tempDir / "real.lgx.tmp.123456", linkPath));
+    EXPECT_FALSE(Package::isSaveOutput(tempDir / "link.lgx.tmp.123456", linkPath));
+    EXPECT_FALSE(Package::isSaveOutput(tempDir / "real.lgx.tmp", linkPath));
+    EXPECT_FALSE(Package::isSaveOutput(tempDir / "real.lgx.tmp.12ab", linkPath));
+    EXPECT_FALSE(Package::isSaveOutput(tempDir / "sub" / "real.lgx.tmp.1", linkPath));
+    EXPECT_FALSE(Package::isSaveOutput(tempDir / "other.lgx", linkPath));
+}
+
+TEST_F(PackageTest, LoadFromMemory_Roundtrip) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    Package::create(pkgPath, "testpkg");
+
+    fs::path file = tempDir / "lib.so";
+    createTestFile(file, "binary content here");
+
+    auto pkg = Package::load(pkgPath);
+    ASSERT_TRUE(pkg.has_value());
+    pkg->getManifest().version = "3.1.4";
+    ASSERT_TRUE(pkg->addVariant("linux-amd64", file).success);
+
+    std::vector<uint8_t> buffer;
+    VectorByteSink sink(buffer);
+    ASSERT_TRUE(pkg->save(sink).success);
+
+    auto loaded = Package::loadFromMemory(buffer.data(), buffer.size());
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->getManifest().version, "3.1.4");
+    EXPECT_TRUE(loaded->hasVariant("linux-amd64"));
+    EXPECT_TRUE(loaded->validatePackage().valid);
+}
+
+TEST_F(PackageTest, LoadFromMemory_InvalidData) {
+    std::vector<uint8_t> garbage = {'n', 'o', 't', ' ', 'g', 'z', 'i', 'p'};
+    auto pkg = Package::loadFromMemory(garbage.data(), garbage.size());
+    EXPECT_FALSE(pkg.has_value());
+    EXPECT_FALSE(Package::getLastError().empty());
+
+    EXPECT_FALSE(Package::loadFromMemory(nullptr, 16).has_value());
+}
+
 // =============================================================================
 // Multiple Operations Tests
 // =============================================================================
@@ -673,6 +910,208 @@ TEST_F(PackageTest, ExtractVariant_Directory) {
     EXPECT_TRUE(fs::exists(extractDir / "web" / "lib.js"));
 }
 
+TEST_F(PackageTest, ExtractVariant_Filtered) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    fs::path testDir = tempDir / "dist";
+    createTestDirectory(testDir, {
+        {"lib/libfoo.so", "lib"},
+        {"lib/libfoo.so.debug", "symbols"},
+        {"share/locale/de/app.qm", "de"},
+        {"share/locale/fr/app.qm", "fr"},
+        {"bin/tool", "tool"}
+    });
+    fs::create_directories(testDir / "share/empty");
+    Package pkg = Package::skeleton("testpkg");
+    ASSERT_TRUE(pkg.addVariant("linux-amd64", testDir, std::string("lib/libfoo.so")).success);
+    ASSERT_TRUE(pkg.save(pkgPath).success);
+
+    // Partial load: only the selected files are read into memory
+    std::vector<std::string> asked;
+    auto partial = Package::load(pkgPath, [&](const std::string& path, bool isDirectory) {
+        if (!isDirectory) {
+            asked.push_back(path);
+        }
+        return isDirectory || path.find("/share/") != std::string::npos;
+    });
+    ASSERT_TRUE(partial.has_value()) << Package::getLastError();
+    EXPECT_EQ(asked.size(), 5u);
+    EXPECT_EQ(partial->getManifest().name, "testpkg");
+    size_t files = 0;
+    for (const auto& entry : partial->getEntries()) {
+        if (!entry.isDirectory && entry.path != "manifest.json") {
+            ++files;
+            EXPECT_NE(entry.path.find("/share/"), std::string::npos) << entry.path;
+        }
+    }
+    EXPECT_EQ(files, 2u);
+    EXPECT_TRUE(partial->hasVariant("linux-amd64"));
+
+    PathFilter filter({"lib", "share/locale/de"}, {"*.debug"});
+    fs::path extractDir = tempDir / "extracted";
+    auto full = Package::load(pkgPath);
+    ASSERT_TRUE(full.has_value());
+    auto result = full->extractVariant("linux-amd64", extractDir, filter);
+    ASSERT_TRUE(result.success) << result.error;
+
+    fs::path root = extractDir / "linux-amd64";
+    EXPECT_TRUE(fs::exists(root / "lib/libfoo.so"));
+    EXPECT_TRUE(fs::exists(root / "share/locale/de/app.qm"));
+    EXPECT_FALSE(fs::exists(root / "lib/libfoo.so.debug"));
+    EXPECT_FALSE(fs::exists(root / "bin"));                // no parent for nothing
+    EXPECT_FALSE(fs::exists(root / "share/locale/fr"));
+    EXPECT_FALSE(fs::exists(root / "share/empty"));
+
+    // Everything else unfiltered, as before
+    result = full->extractAll(tempDir / "all");
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_TRUE(fs::exists(tempDir / "all/linux-amd64/bin/tool"));
+    EXPECT_TRUE(fs::is_directory(tempDir / "all/linux-amd64/share/empty"));
+}
+
+TEST_F(PackageTest, UpdateVariant_WritesOnlyChanges) {
+    fs::path v1 = tempDir / "v1";
+    createTestDirectory(v1, {{"a.txt", "aaaa"}, {"b.txt", "bbbb"}, {"sub/c.txt", "cccc"}});
+    Package pkg = Package::skeleton("testpkg");
+    ASSERT_TRUE(pkg.addVariant("linux-amd64", v1, std::string("a.txt")).success);
+
+    fs::path out = tempDir / "installed";
+    fs::path root = out / "linux-amd64";
+    Package::UpdateCounts counts;
+    auto result = pkg.updateVariant("linux-amd64", out, &counts);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_FALSE(result.unchanged);
+    EXPECT_EQ(counts.written, 3u);
+    EXPECT_TRUE(fs::exists(InstalledState::pathFor(out, "linux-amd64")));
+    EXPECT_FALSE(fs::exists(out / ".linux-amd64.lgx-staging"));
+
+    // Nothing changed: nothing read or written
+    counts = {};
+    result = pkg.updateVariant("linux-amd64", out, &counts);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_TRUE(result.unchanged);
+    EXPECT_EQ(counts.kept, 3u);
+    EXPECT_EQ(counts.written, 0u);
+
+    // A same-size local edit is noticed and repaired
+    createTestFile(root / "a.txt", "AAAA");
+    counts = {};
+    result = pkg.updateVariant("linux-amd64", out, &counts);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_FALSE(result.unchanged);
+    EXPECT_EQ(counts.written, 1u);
+    EXPECT_EQ(counts.kept, 2u);
+    EXPECT_EQ(readFile(root / "a.txt"), "aaaa");
+
+    // New version: b.txt changes, sub/ goes away, d.txt is new; a stray
+    // file is removed too. a.txt is left alone.
+    fs::path v2 = tempDir / "v2";
+    createTestDirectory(v2, {{"a.txt", "aaaa"}, {"b.txt", "BBBBBB"}, {"d.txt", "dddd"}});
+    ASSERT_TRUE(pkg.addVariant("linux-amd64", v2, std::string("a.txt")).success);
+    createTestFile(root / "stray.txt", "stray");
+    DigestCache::Key before;
+    ASSERT_TRUE(DigestCache::Key::of(root / "a.txt", before));
+    counts = {};
+    result = pkg.updateVariant("linux-amd64", out, &counts);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(counts.written, 2u);
+    EXPECT_EQ(counts.kept, 1u);
+    EXPECT_EQ(counts.removed, 2u);  // sub/ and stray.txt
+    DigestCache::Key after;
+    ASSERT_TRUE(DigestCache::Key::of(root / "a.txt", after));
+    EXPECT_EQ(before, after);
+    EXPECT_EQ(readFile(root / "b.txt"), "BBBBBB");
+    EXPECT_EQ(readFile(root / "d.txt"), "dddd");
+    EXPECT_FALSE(fs::exists(root / "sub"));
+    EXPECT_FALSE(fs::exists(root / "stray.txt"));
+
+    // A tree from a plain extract, without a sidecar, is compared by content
+    fs::path plain = tempDir / "plain";
+    ASSERT_TRUE(pkg.extractVariant("linux-amd64", plain).success);
+    counts = {};
+    result = pkg.updateVariant("linux-amd64", plain, &counts);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_TRUE(result.unchanged);
+    EXPECT_EQ(counts.kept, 3u);
+    EXPECT_TRUE(fs::exists(InstalledState::pathFor(plain, "linux-amd64")));
+}
+
+TEST_F(PackageTest, ExtractVariant_DurableSwapsInWholeTree) {
+    fs::path dist = tempDir / "dist";
+    createTestDirectory(dist, {{"a.txt", "aaaa"}, {"sub/b.txt", "bbbb"}});
+    Package pkg = Package::skeleton("testpkg");
+    ASSERT_TRUE(pkg.addVariant("linux-amd64", dist, std::string("a.txt")).success);
+
+    fs::path out = tempDir / "out";
+    fs::path root = out / "linux-amd64";
+    auto result = pkg.extractVariant("linux-amd64", out, PathFilter(), Package::Durability::Durable);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(readFile(root / "a.txt"), "aaaa");
+    EXPECT_EQ(readFile(root / "sub/b.txt"), "bbbb");
+
+    // An existing tree is replaced, not merged into: the stray file goes
+    createTestFile(root / "stray.txt", "stray");
+    createTestFile(root / "a.txt", "edited");
+    result = pkg.extractAll(out, PathFilter(), Package::Durability::Durable);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(readFile(root / "a.txt"), "aaaa");
+    EXPECT_FALSE(fs::exists(root / "stray.txt"));
+    EXPECT_FALSE(fs::exists(out / ".linux-amd64.lgx-staging"));
+    EXPECT_EQ(std::distance(fs::directory_iterator(out), fs::directory_iterator()), 1);
+
+    // Updates flush as well and behave as before
+    Package::UpdateCounts counts;
+    result = pkg.updateVariant("linux-amd64", out, &counts, Package::Durability::Durable);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(counts.kept, 2u);
+    createTestFile(root / "sub/b.txt", "changed");
+    counts = {};
+    result = pkg.updateVariant("linux-amd64", out, &counts, Package::Durability::Durable);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(counts.written, 1u);
+    EXPECT_EQ(readFile(root / "sub/b.txt"), "bbbb");
+}
+
+TEST_F(PackageTest, ExtractVariant_DurableFailureKeepsOldTree) {
+    fs::path pkgPath = tempDir / "evil.lgx";
+    writeCraftedPackage(pkgPath, "variants/linux-x86_64/../../pwned.txt", "owned");
+    auto pkg = Package::load(pkgPath);
+    ASSERT_TRUE(pkg.has_value()) << Package::getLastError();
+
+    fs::path out = tempDir / "out";
+    createTestFile(out / "linux-x86_64" / "keep.txt", "keep");
+    auto result = pkg->extractVariant("linux-x86_64", out, PathFilter(), Package::Durability::Durable);
+    EXPECT_FALSE(result.success);
+    EXPECT_EQ(readFile(out / "linux-x86_64" / "keep.txt"), "keep");
+    EXPECT_FALSE(fs::exists(out / ".linux-x86_64.lgx-staging"));
+    EXPECT_FALSE(fs::exists(tempDir / "pwned.txt"));
+}
+
+TEST_F(PackageTest, ExtractVariant_DurableRejectsFilter) {
+    fs::path dist = tempDir / "dist";
+    createTestDirectory(dist, {{"a.txt", "aaaa"}, {"sub/b.txt", "bbbb"}});
+    Package pkg = Package::skeleton("testpkg");
+    ASSERT_TRUE(pkg.addVariant("linux-amd64", dist, std::string("a.txt")).success);
+
+    fs::path out = tempDir / "out";
+    fs::path root = out / "linux-amd64";
+    ASSERT_TRUE(pkg.extractVariant("linux-amd64", out).success);
+    createTestFile(root / "a.txt", "edited");
+
+    // The swap would drop files a filtered extraction leaves alone, so the
+    // combination is refused and the tree stays as it was
+    auto result = pkg.extractVariant("linux-amd64", out, PathFilter({"sub/*"}, {}),
+                                     Package::Durability::Durable);
+    EXPECT_FALSE(result.success);
+    EXPECT_EQ(result.error, "Durable extraction cannot be filtered");
+    EXPECT_EQ(readFile(root / "a.txt"), "edited");
+    EXPECT_EQ(readFile(root / "sub/b.txt"), "bbbb");
+    EXPECT_FALSE(fs::exists(out / ".linux-amd64.lgx-staging"));
+
+    result = pkg.extractAll(out, PathFilter({}, {"a.txt"}), Package::Durability::Durable);
+    EXPECT_FALSE(result.success);
+    EXPECT_EQ(readFile(root / "a.txt"), "edited");
+}
+
 TEST_F(PackageTest, ExtractVariant_NonExistent) {
     fs::path pkgPath = tempDir / "test.lgx";
     Package::create(pkgPath, "testpkg");
@@ -1041,6 +1480,56 @@ TEST_F(PackageTest, Verify_UnsignedPackage_ChecksHashes) {
         (result.errors.empty() ? "none" : result.errors[0]);
 }
 
+TEST_F(PackageTest, Verify_Levels) {
+    fs::path pkgPath = tempDir / "test.lgx";
+    Package::create(pkgPath, "testpkg");
+
+    fs::path file = tempDir / "lib.so";
+    createTestFile(file, "content");
+
+    auto pkg = Package::load(pkgPath);
+    pkg->addVariant("linux-amd64", file);
+    pkg->getManifest().hashes["root"] = std::string(64, '0');
+    ASSERT_TRUE(pkg->save(pkgPath).success);
+
+    // Structure does not look at content, so a wrong hash goes unnoticed
+    auto structure = Package::verify(pkgPath, Package::VerifyLevel::Structure);
+    EXPECT_TRUE(structure.valid) << "Errors: " <<
+        (structure.errors.empty() ? "none" : structure.errors[0]);
+
+    auto hashes = Package::verify(pkgPath, Package::VerifyLevel::Hashes);
+    EXPECT_FALSE(hashes.valid);
+    EXPECT_FALSE(Package::verify(pkgPath, Package::VerifyLevel::Full).valid);
+}
+
+TEST_F(PackageTest, Verify_FullLevelChecksSignature) {
+    ASSERT_TRUE(crypto::init());
+
+    fs::path pkgPath = tempDir / "test.lgx";
+    Package::create(pkgPath, "testpkg");
+
+    fs::path file = tempDir / "lib.so";
+    createTestFile(file, "content");
+
+    auto pkg = Package::load(pkgPath);
+    pkg->addVariant("linux-amd64", file);
+    auto kp = crypto::generateKeypair();
+    pkg->signPackage(kp.secretKey, "Publisher", "https://example.com");
+    ASSERT_TRUE(pkg->save(pkgPath).success);
+
+    Package::SignatureInfo info{};
+    auto result = Package::verify(pkgPath, Package::VerifyLevel::Full, &info);
+    ASSERT_TRUE(result.valid);
+    EXPECT_TRUE(info.package_valid);
+    EXPECT_TRUE(info.is_signed);
+    EXPECT_TRUE(info.signature_valid);
+
+    // Without Full the signature is left alone
+    Package::SignatureInfo untouched{};
+    EXPECT_TRUE(Package::verify(pkgPath, Package::VerifyLevel::Hashes, &untouched).valid);
+    EXPECT_FALSE(untouched.is_signed);
+}
+
 TEST_F(PackageTest, ClearSignature_PreservesHashes) {
     fs::path pkgPath = tempDir / "test.lgx";
     Package::create(pkgPath, "testpkg");
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "core/package_cache.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace lgx;
+namespace fs = std::filesystem;
+
+class PackageCacheTest : public ::testing::Test {
+protected:
+    fs::path tempDir;
+
+    void SetUp() override {
+        tempDir = fs::temp_directory_path() / ("lgx_cache_test_" + std::to_string(rand()));
+        fs::create_directories(tempDir);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(tempDir, ec);
+    }
+
+    // Create a package with a variant holding `payload` bytes
+    fs::path createPackage(const std::string& name, size_t payload) {
+        fs::path pkgPath = tempDir / (name + ".lgx");
+        EXPECT_TRUE(Package::create(pkgPath, name).success);
+
+        fs::path file = tempDir / (name + ".bin");
+        std::ofstream(file, std::ios::binary) << std::string(payload, 'x');
+
+        auto pkg = Package::load(pkgPath);
+        EXPECT_TRUE(pkg.has_value());
+        EXPECT_TRUE(pkg->addVariant("linux-amd64", file).success);
+        EXPECT_TRUE(pkg->save(pkgPath).success);
+        return pkgPath;
+    }
+};
+
+TEST_F(PackageCacheTest, DisabledByDefault) {
+    PackageCache cache;
+    fs::path pkgPath = createPackage("testpkg", 16);
+
+    auto first = cache.load(pkgPath);
+    auto second = cache.load(pkgPath);
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_NE(first, second);
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 0u);
+    EXPECT_EQ(stats.entries, 0u);
+}
+
+TEST_F(PackageCacheTest, HitSharesDecodedPackage) {
+    PackageCache cache;
+    cache.setBudget(16 * 1024 * 1024);
+    fs::path pkgPath = createPackage("testpkg", 1024);
+
+    auto first = cache.load(pkgPath);
+    auto second = cache.load(pkgPath);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(second->getManifest().name, "testpkg");
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.entries, 1u);
+    EXPECT_EQ(stats.bytes, PackageCache::decodedSize(*first));
+}
+
+TEST_F(PackageCacheTest, ReloadsWhenFileChanges) {
+    PackageCache cache;
+    cache.setBudget(16 * 1024 * 1024);
+    fs::path pkgPath = createPackage("testpkg", 16);
+
+    auto first = cache.load(pkgPath);
+    ASSERT_NE(first, nullptr);
+
+    // Rewrite with different content (and size) under the same path
+    auto pkg = Package::load(pkgPath);
+    ASSERT_TRUE(pkg.has_value());
+    pkg->getManifest().version = "2.0.0-changed";
+    ASSERT_TRUE(pkg->save(pkgPath).success);
+
+    auto second = cache.load(pkgPath);
+    ASSERT_NE(second, nullptr);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(second->getManifest().version, "2.0.0-changed");
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.entries, 1u);
+}
+
+TEST_F(PackageCacheTest, EvictsLeastRecentlyUsed) {
+    PackageCache cache;
+    fs::path a = createPackage("pkga", 4096);
+    fs::path b = createPackage("pkgb", 4096);
+    fs::path c = createPackage("pkgc", 4096);
+
+    // Room for two packages, not three
+    auto probe = Package::load(a);
+    ASSERT_TRUE(probe.has_value());
+    cache.setBudget(PackageCache::decodedSize(*probe) * 2 + 512);
+
+    cache.load(a);
+    cache.load(b);
+    cache.load(a);  // a is now most recently used
+    cache.load(c);  // evicts b
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.entries, 2u);
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_LE(stats.bytes, stats.budget);
+
+    cache.resetStats();
+    cache.load(a);
+    cache.load(b);
+    stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+}
+
+TEST_F(PackageCacheTest, OversizedPackageNotCached) {
+    PackageCache cache;
+    cache.setBudget(1024);
+    fs::path pkgPath = createPackage("testpkg", 64 * 1024);
+
+    ASSERT_NE(cache.load(pkgPath), nullptr);
+    EXPECT_EQ(cache.getStats().entries, 0u);
+}
+
+TEST_F(PackageCacheTest, DisableDropsEntries) {
+    PackageCache cache;
+    cache.setBudget(16 * 1024 * 1024);
+    fs::path pkgPath = createPackage("testpkg", 16);
+    cache.load(pkgPath);
+    ASSERT_EQ(cache.getStats().entries, 1u);
+
+    cache.setBudget(0);
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.entries, 0u);
+    EXPECT_EQ(stats.bytes, 0u);
+}
+
+TEST_F(PackageCacheTest, MissingFile) {
+    PackageCache cache;
+    cache.setBudget(16 * 1024 * 1024);
+
+    EXPECT_EQ(cache.load(tempDir / "missing.lgx"), nullptr);
+    EXPECT_NE(PackageCache::getLastError().find("Cannot open file"), std::string::npos);
+}
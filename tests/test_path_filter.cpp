@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "core/path_filter.h"
+
+using namespace lgx;
+
+TEST(PathFilterTest, GlobSyntax) {
+    EXPECT_TRUE(PathFilter::matchGlob("*.so", "libfoo.so"));
+    EXPECT_FALSE(PathFilter::matchGlob("*.so", "lib/libfoo.so"));
+    EXPECT_TRUE(PathFilter::matchGlob("lib?.so", "lib1.so"));
+    EXPECT_FALSE(PathFilter::matchGlob("lib?.so", "lib.so"));
+    EXPECT_TRUE(PathFilter::matchGlob("[a-c]*", "banana"));
+    EXPECT_FALSE(PathFilter::matchGlob("[!a-c]*", "banana"));
+    EXPECT_TRUE(PathFilter::matchGlob("[]x]", "]"));
+    EXPECT_TRUE(PathFilter::matchGlob("a[b", "a[b"));  // unclosed: literal
+    EXPECT_TRUE(PathFilter::matchGlob("\\*", "*"));
+    EXPECT_FALSE(PathFilter::matchGlob("\\*", "x"));
+
+    EXPECT_TRUE(PathFilter::matchGlob("**/*.qm", "a/b/de.qm"));
+    EXPECT_TRUE(PathFilter::matchGlob("**/*.qm", "de.qm"));
+    EXPECT_TRUE(PathFilter::matchGlob("share/**/de/*", "share/locale/x/de/app.qm"));
+    EXPECT_TRUE(PathFilter::matchGlob("share/**/de/*", "share/de/app.qm"));
+    EXPECT_TRUE(PathFilter::matchGlob("lib/**", "lib/a/b"));
+    EXPECT_FALSE(PathFilter::matchGlob("lib/**", "lib"));
+    EXPECT_FALSE(PathFilter::matchGlob("a**b", "a/b"));  // not a whole component
+}
+
+TEST(PathFilterTest, IncludeAndExclude) {
+    PathFilter all;
+    EXPECT_TRUE(all.empty());
+    EXPECT_TRUE(all.matches("anything/at/all"));
+
+    PathFilter filter({"lib", "share/locale/de", "*.json"}, {"*.debug", "lib/plugins/"});
+    EXPECT_FALSE(filter.empty());
+
+    // A matching directory selects everything under it
+    EXPECT_TRUE(filter.matches("lib"));
+    EXPECT_TRUE(filter.matches("lib/libfoo.so"));
+    EXPECT_TRUE(filter.matches("share/locale/de/app.qm"));
+    EXPECT_FALSE(filter.matches("share/locale/fr/app.qm"));
+    EXPECT_FALSE(filter.matches("share/locale"));
+
+    // Patterns without '/' match names at any depth, anchored ones do not
+    EXPECT_TRUE(filter.matches("config.json"));
+    EXPECT_TRUE(filter.matches("etc/config.json"));
+    EXPECT_TRUE(filter.matches("sub/lib/libfoo.so"));
+    EXPECT_FALSE(filter.matches("sub/share/locale/de/app.qm"));
+
+    // Excludes win, including for whole directories
+    EXPECT_FALSE(filter.matches("lib/libfoo.so.debug"));
+    EXPECT_FALSE(filter.matches("lib/plugins/p.so"));
+    EXPECT_TRUE(filter.matches("lib/pluginsx/p.so"));
+
+    PathFilter excludeOnly({}, {"/docs", ""});
+    EXPECT_TRUE(excludeOnly.matches("lib/docs/readme"));
+    EXPECT_FALSE(excludeOnly.matches("docs/readme"));
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include "core/resolver.h"
+
+#include <map>
+
+using namespace lgx;
+
+namespace {
+
+Dependency dep(const std::string& name, const std::string& range = "",
+               const std::string& signer = "") {
+    Dependency d(name);
+    if (!range.empty()) d.version = range;
+    if (!signer.empty()) d.signer = signer;
+    return d;
+}
+
+void add(Resolver& resolver, const std::string& name, const std::string& version,
+         std::vector<Dependency> dependencies = {}, const std::string& signer = "") {
+    Resolver::Candidate candidate;
+    candidate.name = name;
+    candidate.version = version;
+    candidate.signer = signer;
+    candidate.dependencies = std::move(dependencies);
+    candidate.source = name + "-" + version + ".lgx";
+    ASSERT_TRUE(resolver.addCandidate(candidate)) << Resolver::getLastError();
+}
+
+std::map<std::string, std::string> chosen(const Resolver::Result& result) {
+    std::map<std::string, std::string> out;
+    for (const auto& selection : result.packages) {
+        out[selection.name] = selection.version;
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(ResolverTest, PicksNewestMatchingVersionsTransitively) {
+    Resolver resolver;
+    add(resolver, "app", "1.0.0", {dep("net", "^1.2"), dep("log")});
+    add(resolver, "net", "1.1.0");
+    add(resolver, "net", "1.4.0", {dep("log", "~0.3")});
+    add(resolver, "net", "1.3.0");
+    add(resolver, "net", "2.0.0");
+    add(resolver, "log", "0.3.1");
+    add(resolver, "log", "0.4.0");
+    add(resolver, "log", "0.3.5");
+    add(resolver, "unused", "1.0.0");
+
+    auto result = resolver.resolve({dep("APP")});
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(chosen(result), (std::map<std::string, std::string>{
+        {"app", "1.0.0"}, {"log", "0.3.5"}, {"net", "1.4.0"}}));
+    EXPECT_EQ(result.packages[1].source, "log-0.3.5.lgx");
+
+    auto empty = resolver.resolve({});
+    EXPECT_TRUE(empty.success);
+    EXPECT_TRUE(empty.packages.empty());
+}
+
+TEST(ResolverTest, BacktracksOnConflict) {
+    Resolver resolver;
+    add(resolver, "ui", "2.0.0", {dep("core", "^2")});
+    add(resolver, "ui", "1.0.0", {dep("core", "^1")});
+    add(resolver, "db", "1.0.0", {dep("core", "^1.1")});
+    add(resolver, "core", "2.1.0");
+    add(resolver, "core", "1.1.0");
+    add(resolver, "core", "1.0.0");
+
+    auto result = resolver.resolve({dep("ui"), dep("db")});
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(chosen(result), (std::map<std::string, std::string>{
+        {"core", "1.1.0"}, {"db", "1.0.0"}, {"ui", "1.0.0"}}));
+}
+
+TEST(ResolverTest, EnforcesSignerPins) {
+    const std::string trusted = "did:jwk:trusted";
+    Resolver resolver;
+    add(resolver, "app", "1.0.0", {dep("crypto", "^1", trusted)});
+    add(resolver, "crypto", "1.9.0", {}, "did:jwk:other");
+    add(resolver, "crypto", "1.8.0");
+    add(resolver, "crypto", "1.2.0", {}, trusted);
+
+    auto result = resolver.resolve({dep("app")});
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(chosen(result)["crypto"], "1.2.0");
+    EXPECT_EQ(result.packages[1].signer, trusted);
+
+    // A pin nobody satisfies is a conflict naming the pin
+    auto pinned = resolver.resolve({dep("crypto", "", "did:jwk:nobody")});
+    EXPECT_FALSE(pinned.success);
+    EXPECT_NE(pinned.error.find("did:jwk:nobody"), std::string::npos) << pinned.error;
+}
+
+TEST(ResolverTest, ReportsConflicts) {
+    Resolver resolver;
+    add(resolver, "app", "1.0.0", {dep("lib", "^1")});
+    add(resolver, "tool", "1.0.0", {dep("lib", "^2")});
+    add(resolver, "lib", "1.5.0");
+    add(resolver, "lib", "2.0.0");
+    add(resolver, "broken", "1.0.0", {dep("missing")});
+
+    auto conflict = resolver.resolve({dep("app"), dep("tool")});
+    ASSERT_FALSE(conflict.success);
+    EXPECT_NE(conflict.error.find("lib ^2 (required by tool 1.0.0)"), std::string::npos)
+        << conflict.error;
+
+    auto missing = resolver.resolve({dep("broken")});
+    ASSERT_FALSE(missing.success);
+    EXPECT_NE(missing.error.find("No package named 'missing' (required by broken 1.0.0)"),
+              std::string::npos) << missing.error;
+
+    EXPECT_FALSE(resolver.resolve({dep("nothing")}).success);
+    EXPECT_FALSE(resolver.resolve({dep("lib", ">=3")}).success);
+    EXPECT_FALSE(resolver.resolve({dep("lib", "not a range")}).success);
+}
+
+TEST(ResolverTest, JumpsBackOverUnrelatedChoices) {
+    // Only the choice of `a` matters, but the conflict surfaces after ten
+    // unrelated packages with five versions each were chosen
+    Resolver resolver;
+    add(resolver, "a", "2.0.0", {dep("q")});
+    add(resolver, "a", "1.0.0");
+    std::vector<Dependency> roots = {dep("a")};
+    for (int i = 0; i < 10; ++i) {
+        std::string name = "p" + std::to_string(i);
+        for (int v = 0; v < 5; ++v) {
+            add(resolver, name, "1." + std::to_string(v) + ".0");
+        }
+        roots.push_back(dep(name));
+    }
+    add(resolver, "q", "1.0.0", {dep("r", "^1"), dep("s", "^1")});
+    add(resolver, "r", "1.0.0", {dep("t", "^1")});
+    add(resolver, "s", "1.0.0", {dep("t", "^2")});
+    add(resolver, "t", "1.0.0");
+    add(resolver, "t", "2.0.0");
+
+    auto result = resolver.resolve(roots);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(chosen(result)["a"], "1.0.0");
+    EXPECT_EQ(chosen(result)["p3"], "1.4.0");
+    EXPECT_LT(result.steps, 50u);
+
+    auto limited = resolver.resolve(roots, 5);
+    EXPECT_FALSE(limited.success);
+    EXPECT_NE(limited.error.find("Gave up"), std::string::npos);
+}
+
+TEST(ResolverTest, RejectsInvalidInput) {
+    Resolver resolver;
+    Resolver::Candidate candidate;
+    candidate.name = "x";
+    candidate.version = "1.0";
+    EXPECT_FALSE(resolver.addCandidate(candidate));
+    candidate.version = "1.0.0";
+    candidate.dependencies = {dep("y", "^^1")};
+    EXPECT_FALSE(resolver.addCandidate(candidate));
+    EXPECT_EQ(resolver.candidateCount(), 0u);
+
+    auto parsed = Resolver::parseRequirement("Net@>=1.2 <2");
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->name, "net");
+    EXPECT_EQ(parsed->version.value_or(""), ">=1.2 <2");
+    EXPECT_FALSE(Resolver::parseRequirement("net").value_or(Dependency("x")).version.has_value());
+    EXPECT_FALSE(Resolver::parseRequirement("@1.0").has_value());
+    EXPECT_FALSE(Resolver::parseRequirement("net@bogus").has_value());
+}
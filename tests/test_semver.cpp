@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "core/semver.h"
+
+using namespace lgx;
+
+namespace {
+
+SemVersion v(const std::string& text) {
+    auto parsed = SemVersion::parse(text);
+    EXPECT_TRUE(parsed.has_value()) << text;
+    return parsed.value_or(SemVersion{});
+}
+
+bool matches(const std::string& range, const std::string& version) {
+    auto parsed = SemverRange::parse(range);
+    EXPECT_TRUE(parsed.has_value()) << range << ": " << SemverRange::getLastError();
+    return parsed && parsed->satisfies(v(version));
+}
+
+} // namespace
+
+TEST(SemverTest, ParsesVersions) {
+    auto version = SemVersion::parse("1.22.333-rc.1+build.5");
+    ASSERT_TRUE(version.has_value());
+    EXPECT_EQ(version->major, 1u);
+    EXPECT_EQ(version->minor, 22u);
+    EXPECT_EQ(version->patch, 333u);
+    EXPECT_EQ(version->prerelease, (std::vector<std::string>{"rc", "1"}));
+    EXPECT_EQ(version->build, "build.5");
+    EXPECT_EQ(version->toString(), "1.22.333-rc.1+build.5");
+
+    EXPECT_TRUE(SemVersion::parse("v2.0.0").has_value());
+    EXPECT_FALSE(SemVersion::parse("1.2").has_value());
+    EXPECT_FALSE(SemVersion::parse("1.02.3").has_value());
+    EXPECT_FALSE(SemVersion::parse("1.2.3-").has_value());
+    EXPECT_FALSE(SemVersion::parse("a.b.c").has_value());
+}
+
+TEST(SemverTest, OrdersBySemverRules) {
+    EXPECT_LT(v("1.2.3"), v("1.2.4"));
+    EXPECT_LT(v("1.9.0"), v("1.10.0"));
+    EXPECT_LT(v("1.0.0-alpha"), v("1.0.0"));
+    EXPECT_LT(v("1.0.0-alpha"), v("1.0.0-alpha.1"));
+    EXPECT_LT(v("1.0.0-alpha.1"), v("1.0.0-alpha.beta"));
+    EXPECT_LT(v("1.0.0-beta.2"), v("1.0.0-beta.11"));
+    EXPECT_EQ(v("1.0.0+a"), v("1.0.0+b"));
+}
+
+TEST(SemverTest, CaretAndTilde) {
+    EXPECT_TRUE(matches("^1.2.3", "1.9.0"));
+    EXPECT_FALSE(matches("^1.2.3", "2.0.0"));
+    EXPECT_FALSE(matches("^1.2.3", "1.2.2"));
+    EXPECT_TRUE(matches("^0.2.3", "0.2.9"));
+    EXPECT_FALSE(matches("^0.2.3", "0.3.0"));
+    EXPECT_FALSE(matches("^0.0.3", "0.0.4"));
+    EXPECT_TRUE(matches("^1.2", "1.2.0"));
+    EXPECT_TRUE(matches("^0", "0.9.9"));
+
+    EXPECT_TRUE(matches("~1.2.3", "1.2.9"));
+    EXPECT_FALSE(matches("~1.2.3", "1.3.0"));
+    EXPECT_TRUE(matches("~1", "1.9.0"));
+    EXPECT_FALSE(matches("~1", "2.0.0"));
+}
+
+TEST(SemverTest, ComparatorsAndPartials) {
+    EXPECT_TRUE(matches(">=1.2 <2", "1.5.0"));
+    EXPECT_FALSE(matches(">=1.2 <2", "2.0.0"));
+    EXPECT_TRUE(matches(">= 1.2", "1.2.0"));
+    EXPECT_TRUE(matches(">1.2", "1.3.0"));
+    EXPECT_FALSE(matches(">1.2", "1.2.9"));
+    EXPECT_TRUE(matches("<=1.2", "1.2.9"));
+    EXPECT_FALSE(matches("<1.2", "1.2.0"));
+    EXPECT_TRUE(matches("1.2.x", "1.2.7"));
+    EXPECT_FALSE(matches("1.2.x", "1.3.0"));
+    EXPECT_TRUE(matches("=1.2.3", "1.2.3"));
+    EXPECT_TRUE(matches("*", "42.0.0"));
+    EXPECT_TRUE(matches("1.x || >=3", "3.1.0"));
+    EXPECT_FALSE(matches("1.x || >=3", "2.0.0"));
+}
+
+TEST(SemverTest, PrereleasesNeedMatchingComparator) {
+    EXPECT_FALSE(matches("^1.2.0", "1.3.0-beta"));
+    EXPECT_FALSE(matches("*", "1.0.0-rc.1"));
+    EXPECT_TRUE(matches("^1.2.3-beta", "1.2.3-beta.2"));
+    EXPECT_TRUE(matches("^1.2.3-beta", "1.4.0"));
+    EXPECT_FALSE(matches("^1.2.3-beta", "1.4.0-beta"));
+}
+
+TEST(SemverTest, CompilesToIntervals) {
+    auto range = SemverRange::parse("^1.2 || ~3.1.4 || >5 <5");
+    ASSERT_TRUE(range.has_value());
+    ASSERT_EQ(range->intervals().size(), 2u);  // the empty third alternative is dropped
+
+    const auto& first = range->intervals()[0];
+    ASSERT_TRUE(first.lower && first.upper);
+    EXPECT_EQ(first.lower->version, v("1.2.0"));
+    EXPECT_TRUE(first.lower->inclusive);
+    EXPECT_EQ(first.upper->version, v("2.0.0"));
+    EXPECT_FALSE(first.upper->inclusive);
+
+    auto empty = SemverRange::parse(">2 <1");
+    ASSERT_TRUE(empty.has_value());
+    EXPECT_TRUE(empty->isEmpty());
+}
+
+TEST(SemverTest, RejectsInvalidRanges) {
+    EXPECT_FALSE(SemverRange::parse("").has_value());
+    EXPECT_FALSE(SemverRange::parse("^a.b").has_value());
+    EXPECT_FALSE(SemverRange::parse("1.2.3.4").has_value());
+    EXPECT_FALSE(SemverRange::parse("1.x ||").has_value());
+    EXPECT_FALSE(SemverRange::parse(">=").has_value());
+}
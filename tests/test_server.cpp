@@ -0,0 +1,281 @@
+#include <gtest/gtest.h>
+#include "server/server.h"
+#include "server/client.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace lgx;
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+class ServerTest : public ::testing::Test {
+protected:
+    fs::path tempDir;
+
+    void SetUp() override {
+        tempDir = fs::temp_directory_path() / ("lgx_server_test_" + std::to_string(rand()));
+        fs::create_directories(tempDir);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(tempDir, ec);
+    }
+
+    fs::path createPackage(const std::string& name) {
+        fs::path pkgPath = tempDir / (name + ".lgx");
+        EXPECT_TRUE(Package::create(pkgPath, name).success);
+
+        fs::path file = tempDir / (name + ".so");
+        std::ofstream(file, std::ios::binary) << "library";
+
+        auto pkg = Package::load(pkgPath);
+        EXPECT_TRUE(pkg.has_value());
+        EXPECT_TRUE(pkg->addVariant("linux-amd64", file).success);
+        EXPECT_TRUE(pkg->save(pkgPath).success);
+        return pkgPath;
+    }
+
+    server::Server::Options options() {
+        server::Server::Options opts;
+        opts.socketPath = (tempDir / "lgx.sock").string();
+        opts.workers = 2;
+        opts.cacheBudget = 16 * 1024 * 1024;
+        return opts;
+    }
+};
+
+TEST_F(ServerTest, PingAndUnknownOperation) {
+    server::Server srv(options());
+
+    auto response = srv.handle({{"op", "ping"}});
+    EXPECT_TRUE(response["ok"].get<bool>());
+    EXPECT_EQ(response["protocol"], server::PROTOCOL_VERSION);
+
+    response = srv.handle({{"op", "bogus"}});
+    EXPECT_FALSE(response["ok"].get<bool>());
+    EXPECT_NE(response["error"].get<std::string>().find("bogus"), std::string::npos);
+
+    response = srv.handle(json::array());
+    EXPECT_FALSE(response["ok"].get<bool>());
+}
+
+TEST_F(ServerTest, VerifyIsCachedUntilFileChanges) {
+    server::Server srv(options());
+    fs::path pkgPath = createPackage("testpkg");
+    json request = {{"op", "verify"}, {"path", pkgPath.string()},
+                    {"keyring_dir", (tempDir / "keyring").string()}};
+
+    auto first = srv.handle(request);
+    ASSERT_TRUE(first["ok"].get<bool>());
+    EXPECT_TRUE(first["structure"]["valid"].get<bool>());
+    EXPECT_FALSE(first["signature"]["is_signed"].get<bool>());
+
+    auto second = srv.handle(request);
+    EXPECT_EQ(second, first);
+
+    auto stats = srv.handle({{"op", "stats"}});
+    EXPECT_EQ(stats["package_cache"]["misses"], 1);
+    EXPECT_EQ(stats["package_cache"]["hits"], 1);
+    EXPECT_EQ(stats["verify_cache_entries"], 1);
+
+    // A rewritten file is decoded and verified again
+    fs::remove(pkgPath);
+    std::ofstream(pkgPath, std::ios::binary) << "not a package";
+    auto third = srv.handle(request);
+    ASSERT_TRUE(third["ok"].get<bool>());
+    EXPECT_FALSE(third["structure"]["valid"].get<bool>());
+}
+
+TEST_F(ServerTest, ManifestEntriesAndExtract) {
+    server::Server srv(options());
+    fs::path pkgPath = createPackage("testpkg");
+
+    auto manifest = srv.handle({{"op", "manifest"}, {"path", pkgPath.string()}});
+    ASSERT_TRUE(manifest["ok"].get<bool>());
+    EXPECT_NE(manifest["manifest"].get<std::string>().find("\"testpkg\""), std::string::npos);
+    EXPECT_TRUE(manifest["signature"].is_null());
+
+    auto entries = srv.handle({{"op", "entries"}, {"path", pkgPath.string()}});
+    ASSERT_TRUE(entries["ok"].get<bool>());
+    bool found = false;
+    for (const auto& entry : entries["entries"]) {
+        if (entry["path"] == "variants/linux-amd64/testpkg.so") {
+            found = true;
+            EXPECT_EQ(entry["size"], 7);
+        }
+    }
+    EXPECT_TRUE(found);
+
+    fs::path outDir = tempDir / "out";
+    auto extract = srv.handle({{"op", "extract"}, {"path", pkgPath.string()},
+                               {"output", outDir.string()}, {"variant", "LINUX-AMD64"}});
+    ASSERT_TRUE(extract["ok"].get<bool>()) << extract.dump();
+    EXPECT_TRUE(fs::exists(outDir / "linux-amd64" / "testpkg.so"));
+
+    auto missing = srv.handle({{"op", "extract"}, {"path", pkgPath.string()},
+                               {"output", outDir.string()}, {"variant", "darwin-arm64"}});
+    EXPECT_FALSE(missing["ok"].get<bool>());
+
+    auto notFound = srv.handle({{"op", "manifest"}, {"path", (tempDir / "nope.lgx").string()}});
+    EXPECT_FALSE(notFound["ok"].get<bool>());
+}
+
+#ifndef _WIN32
+
+TEST_F(ServerTest, SocketRoundTripAndShutdown) {
+    server::Server srv(options());
+    ASSERT_TRUE(srv.start()) << server::Server::getLastError();
+    std::thread loop([&srv] { srv.run(); });
+
+    // A second daemon on the same socket is refused
+    server::Server other(options());
+    EXPECT_FALSE(other.start());
+
+    fs::path pkgPath = createPackage("testpkg");
+    {
+        auto client = server::Client::connect(options().socketPath);
+        ASSERT_NE(client, nullptr) << server::Client::getLastError();
+
+        for (int i = 0; i < 3; ++i) {
+            auto response = client->request({{"op", "verify"}, {"path", pkgPath.string()}});
+            ASSERT_TRUE(response.has_value());
+            EXPECT_TRUE((*response)["structure"]["valid"].get<bool>());
+        }
+
+        auto malformed = server::Client::connect(options().socketPath);
+        ASSERT_NE(malformed, nullptr);
+        auto response = malformed->request("not an object");
+        ASSERT_TRUE(response.has_value());
+        EXPECT_FALSE((*response)["ok"].get<bool>());
+
+        response = client->request({{"op", "shutdown"}});
+        ASSERT_TRUE(response.has_value());
+        EXPECT_TRUE((*response)["ok"].get<bool>());
+    }
+
+    loop.join();
+}
+
+// A raw connection to the daemon, for clients that stay silent
+static int connectRaw(const std::string& socketPath) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+TEST_F(ServerTest, IdleConnectionsDoNotBlockOthers) {
+    auto opts = options();
+    opts.workers = 1;
+    server::Server srv(opts);
+    ASSERT_TRUE(srv.start()) << server::Server::getLastError();
+    std::thread loop([&srv] { srv.run(); });
+
+    // More silent persistent clients than workers
+    std::vector<int> idle;
+    for (int i = 0; i < 4; ++i) {
+        idle.push_back(connectRaw(opts.socketPath));
+        ASSERT_GE(idle.back(), 0);
+    }
+
+    auto client = server::Client::connect(opts.socketPath);
+    ASSERT_NE(client, nullptr);
+    for (int i = 0; i < 3; ++i) {
+        auto response = client->request({{"op", "ping"}});
+        ASSERT_TRUE(response.has_value());
+        EXPECT_TRUE((*response)["ok"].get<bool>());
+    }
+
+    // A request sent in two pieces is answered once complete
+    const std::string first = "{\"op\":", second = "\"ping\"}\n";
+    ASSERT_EQ(::send(idle[0], first.data(), first.size(), 0), static_cast<ssize_t>(first.size()));
+    ASSERT_TRUE(client->request({{"op", "ping"}}).has_value());
+    ASSERT_EQ(::send(idle[0], second.data(), second.size(), 0), static_cast<ssize_t>(second.size()));
+    char reply[256];
+    ssize_t n = ::recv(idle[0], reply, sizeof(reply), 0);
+    ASSERT_GT(n, 0);
+    EXPECT_NE(std::string(reply, static_cast<size_t>(n)).find("\"ok\":true"), std::string::npos);
+
+    // Shutdown does not wait for the silent clients
+    ASSERT_TRUE(client->request({{"op", "shutdown"}}).has_value());
+    loop.join();
+    for (int fd : idle) {
+        ::close(fd);
+    }
+}
+
+TEST_F(ServerTest, ClosesIdleConnections) {
+    auto opts = options();
+    opts.idleTimeout = 1;
+    server::Server srv(opts);
+    ASSERT_TRUE(srv.start()) << server::Server::getLastError();
+    std::thread loop([&srv] { srv.run(); });
+
+    int fd = connectRaw(opts.socketPath);
+    ASSERT_GE(fd, 0);
+    timeval limit{10, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &limit, sizeof(limit));
+    auto start = std::chrono::steady_clock::now();
+    char byte;
+    EXPECT_EQ(::recv(fd, &byte, 1, 0), 0);  // closed by the daemon, not timed out here
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    ::close(fd);
+
+    srv.requestStop();
+    loop.join();
+}
+
+TEST_F(ServerTest, ReplacesStaleSocketOnly) {
+    // A daemon that crashed leaves a bound socket file nobody listens on
+    std::string socketPath = options().socketPath;
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    ASSERT_EQ(::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    ::close(fd);
+    ASSERT_TRUE(fs::exists(socketPath));
+
+    {
+        server::Server srv(options());
+        EXPECT_TRUE(srv.start()) << server::Server::getLastError();
+    }
+    EXPECT_FALSE(fs::exists(socketPath));  // removed on shutdown
+
+    // Anything that is not a socket is left alone
+    server::Server::Options bad = options();
+    bad.socketPath = (tempDir / "regular-file").string();
+    std::ofstream(bad.socketPath) << "x";
+    server::Server refused(bad);
+    EXPECT_FALSE(refused.start());
+    EXPECT_TRUE(fs::exists(bad.socketPath));
+}
+
+TEST_F(ServerTest, ClientFromEnvironment) {
+    unsetenv(server::SOCKET_ENV);
+    EXPECT_EQ(server::Client::fromEnvironment(), nullptr);
+
+    setenv(server::SOCKET_ENV, (tempDir / "missing.sock").c_str(), 1);
+    EXPECT_EQ(server::Client::fromEnvironment(), nullptr);
+    unsetenv(server::SOCKET_ENV);
+}
+
+#endif // _WIN32
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "core/stats.h"
+#include "core/gzip_handler.h"
+#include "core/path_normalizer.h"
+
+#include <nlohmann/json.hpp>
+
+using namespace lgx;
+
+class StatsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Stats::reset();
+    }
+
+    void TearDown() override {
+        Stats::setEnabled(false);
+        Stats::reset();
+    }
+};
+
+TEST_F(StatsTest, DisabledRecordsNothing) {
+    {
+        Stats::Timer timer(Stats::Phase::Inflate);
+        EXPECT_FALSE(timer.active());
+        timer.addBytesIn(100);
+    }
+    Stats::noteBuffer(4096);
+
+    auto snapshot = Stats::snapshot();
+    EXPECT_EQ(snapshot[Stats::Phase::Inflate].calls, 0u);
+    EXPECT_EQ(snapshot[Stats::Phase::Inflate].bytesIn, 0u);
+    EXPECT_EQ(snapshot.peakBufferBytes, 0u);
+}
+
+TEST_F(StatsTest, TimerAccumulates) {
+    Stats::setEnabled(true);
+    for (int i = 0; i < 2; ++i) {
+        Stats::Timer timer(Stats::Phase::Extract);
+        timer.addBytesIn(10);
+        timer.addBytesOut(20);
+        timer.addEntries(3);
+        timer.addSyscalls(4);
+    }
+    Stats::noteBuffer(100);
+    Stats::noteBuffer(50);
+
+    auto snapshot = Stats::snapshot();
+    const auto& extract = snapshot[Stats::Phase::Extract];
+    EXPECT_EQ(extract.calls, 2u);
+    EXPECT_EQ(extract.bytesIn, 20u);
+    EXPECT_EQ(extract.bytesOut, 40u);
+    EXPECT_EQ(extract.entries, 6u);
+    EXPECT_EQ(extract.syscalls, 8u);
+    EXPECT_EQ(snapshot.peakBufferBytes, 100u);
+}
+
+TEST_F(StatsTest, GzipRoundTripIsCounted) {
+    Stats::setEnabled(true);
+    std::vector<uint8_t> data(100000, 'a');
+    auto compressed = GzipHandler::compress(data);
+    auto decompressed = GzipHandler::decompress(compressed);
+    ASSERT_EQ(decompressed, data);
+
+    auto snapshot = Stats::snapshot();
+    EXPECT_EQ(snapshot[Stats::Phase::Deflate].calls, 1u);
+    EXPECT_EQ(snapshot[Stats::Phase::Deflate].bytesIn, data.size());
+    EXPECT_EQ(snapshot[Stats::Phase::Deflate].bytesOut, compressed.size());
+    EXPECT_EQ(snapshot[Stats::Phase::Inflate].calls, 1u);
+    EXPECT_EQ(snapshot[Stats::Phase::Inflate].bytesIn, compressed.size());
+    EXPECT_EQ(snapshot[Stats::Phase::Inflate].bytesOut, data.size());
+}
+
+TEST_F(StatsTest, NormalizationIsCounted) {
+    Stats::setEnabled(true);
+    PathNormalizer::toNFC("variants/linux-amd64/lib.so");
+    PathNormalizer::isNFC("docs/readme.md");
+
+    auto snapshot = Stats::snapshot();
+    EXPECT_EQ(snapshot[Stats::Phase::Normalize].calls, 2u);
+    EXPECT_EQ(snapshot[Stats::Phase::Normalize].entries, 2u);
+}
+
+TEST_F(StatsTest, Formatting) {
+    Stats::setEnabled(true);
+    {
+        Stats::Timer timer(Stats::Phase::Hash);
+        timer.addBytesIn(1234);
+    }
+
+    auto snapshot = Stats::snapshot();
+    std::string text = Stats::toText(snapshot);
+    EXPECT_NE(text.find("hash"), std::string::npos);
+    EXPECT_NE(text.find("1234"), std::string::npos);
+    EXPECT_EQ(text.find("inflate"), std::string::npos);  // no calls: omitted
+
+    auto json = nlohmann::json::parse(Stats::toJson(snapshot));
+    EXPECT_EQ(json["phases"]["hash"]["bytes_in"], 1234);
+    EXPECT_EQ(json["phases"]["inflate"]["calls"], 0);
+    EXPECT_TRUE(json.contains("peak_buffer_bytes"));
+}
@@ -163,7 +163,7 @@ TEST(TarReaderTest, Iterate_StopEarly) {
     auto tarData = createTestTar();
     
     int count = 0;
-    TarReader::iterate(tarData, [&count](const TarEntry& entry) {
+    TarReader::iterate(tarData, [&count](const TarEntry& /*entry*/) {
         ++count;
         return count < 2;  // Stop after 2 entries
     });
@@ -171,6 +171,62 @@ TEST(TarReaderTest, Iterate_StopEarly) {
     EXPECT_EQ(count, 2);
 }
 
+TEST(TarReaderTest, StreamParser_SelectedDataOnly) {
+    DeterministicTarWriter writer;
+    writer.addFile("big.bin", std::vector<uint8_t>(100 * 1024, 'b'));
+    writer.addFile("manifest.json", "{\"name\": \"test\"}");
+    writer.addDirectory("variants");
+    auto tarData = writer.finalize();
+
+    std::vector<std::string> paths;
+    std::string manifest;
+    size_t bigData = 0;
+    TarReader::StreamParser parser(
+        [](const TarReader::EntryInfo& info) { return info.path == "manifest.json"; },
+        [&](const TarReader::EntryInfo& info, std::vector<uint8_t>& data) {
+            paths.push_back(info.path);
+            if (info.path == "manifest.json") manifest.assign(data.begin(), data.end());
+            if (info.path == "big.bin") bigData = data.size();
+            return true;
+        });
+
+    // Odd chunk sizes so headers and data straddle chunk boundaries
+    size_t offset = 0;
+    bool more = true;
+    while (more && offset < tarData.size()) {
+        size_t n = std::min<size_t>(333, tarData.size() - offset);
+        more = parser.feed(tarData.data() + offset, n);
+        offset += n;
+    }
+
+    EXPECT_FALSE(more);
+    EXPECT_TRUE(parser.ended());
+    EXPECT_TRUE(parser.error().empty());
+    EXPECT_EQ(paths, (std::vector<std::string>{"big.bin", "manifest.json", "variants/"}));
+    EXPECT_EQ(manifest, "{\"name\": \"test\"}");
+    EXPECT_EQ(bigData, 0u);
+}
+
+TEST(TarReaderTest, StreamParser_StopAndError) {
+    auto tarData = createTestTar();
+
+    int seen = 0;
+    TarReader::StreamParser stopper(
+        [](const TarReader::EntryInfo&) { return true; },
+        [&seen](const TarReader::EntryInfo&, std::vector<uint8_t>&) { return ++seen < 2; });
+    EXPECT_FALSE(stopper.feed(tarData.data(), tarData.size()));
+    EXPECT_EQ(seen, 2);
+    EXPECT_FALSE(stopper.ended());
+    EXPECT_TRUE(stopper.error().empty());
+
+    tarData[148] ^= 0x01;  // corrupt the first header's checksum
+    TarReader::StreamParser broken(
+        [](const TarReader::EntryInfo&) { return true; },
+        [](const TarReader::EntryInfo&, std::vector<uint8_t>&) { return true; });
+    EXPECT_FALSE(broken.feed(tarData.data(), tarData.size()));
+    EXPECT_FALSE(broken.error().empty());
+}
+
 // =============================================================================
 // Validity Tests
 // =============================================================================
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "core/trace.h"
+#include "core/package.h"
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <set>
+#include <thread>
+
+using namespace lgx;
+namespace fs = std::filesystem;
+
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Trace::clear();
+    }
+
+    void TearDown() override {
+        Trace::setEnabled(false);
+        Trace::clear();
+    }
+};
+
+TEST_F(TraceTest, DisabledSpansRecordNothing) {
+    {
+        Trace::Span span("idle", "detail");
+    }
+    EXPECT_EQ(Trace::eventCount(), 0u);
+}
+
+#ifndef LGX_NO_TRACING
+
+TEST_F(TraceTest, SpansBecomeCompleteEvents) {
+    Trace::setEnabled(true);
+    {
+        Trace::Span outer("outer", "some/path");
+        Trace::Span inner("inner");
+    }
+    std::thread([] { Trace::Span span("worker"); }).join();
+    Trace::setEnabled(false);
+
+    ASSERT_EQ(Trace::eventCount(), 3u);
+    auto json = nlohmann::json::parse(Trace::toJson());
+    ASSERT_TRUE(json.contains("traceEvents"));
+
+    std::set<std::string> names;
+    std::set<int> threads;
+    for (const auto& event : json["traceEvents"]) {
+        if (event["ph"] == "M") {
+            continue;
+        }
+        EXPECT_EQ(event["ph"], "X");
+        EXPECT_TRUE(event.contains("ts"));
+        EXPECT_TRUE(event.contains("dur"));
+        names.insert(event["name"].get<std::string>());
+        threads.insert(event["tid"].get<int>());
+        if (event["name"] == "outer") {
+            EXPECT_EQ(event["args"]["detail"], "some/path");
+        }
+    }
+    EXPECT_EQ(names, (std::set<std::string>{"outer", "inner", "worker"}));
+    EXPECT_EQ(threads.size(), 2u);
+}
+
+TEST_F(TraceTest, PackageLoadIsTraced) {
+    fs::path dir = fs::temp_directory_path() / ("lgx_trace_test_" + std::to_string(rand()));
+    fs::create_directories(dir);
+    fs::path pkgPath = dir / "test.lgx";
+    ASSERT_TRUE(Package::create(pkgPath, "test").success);
+
+    Trace::setEnabled(true);
+    ASSERT_TRUE(Package::load(pkgPath).has_value());
+    Trace::setEnabled(false);
+
+    auto json = nlohmann::json::parse(Trace::toJson());
+    std::set<std::string> names;
+    for (const auto& event : json["traceEvents"]) {
+        names.insert(event["name"].get<std::string>());
+    }
+    EXPECT_TRUE(names.count("package.load"));
+    EXPECT_TRUE(names.count("file.read"));
+    EXPECT_TRUE(names.count("gzip.inflate"));
+    EXPECT_TRUE(names.count("tar.parse"));
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+TEST_F(TraceTest, WriteJsonFailsForBadPath) {
+    EXPECT_FALSE(Trace::writeJson("/nonexistent-dir/trace.json"));
+    EXPECT_FALSE(Trace::getLastError().empty());
+}
+
+#endif // LGX_NO_TRACING